@@ -31,6 +31,7 @@
  */
 
 #define _POSIX_C_SOURCE 200809L
+#define _XOPEN_SOURCE 700
 #include "include/kronos.h"
 // linenoise - Line editing library for REPL (BSD License)
 // Copyright (c) 2010-2023, Salvatore Sanfilippo <antirez at gmail dot com>
@@ -42,6 +43,7 @@
 #include "src/frontend/parser.h"
 #include "src/frontend/tokenizer.h"
 #include "src/vm/vm.h"
+#include <errno.h>
 #include <getopt.h>
 #include <limits.h>
 #include <signal.h>
@@ -62,6 +64,8 @@
 static volatile sig_atomic_t g_signal_received = 0;
 static KronosVM *g_repl_vm =
     NULL; // VM instance for REPL (for cleanup on signal)
+// Call depth limit of every VM created by kronos_vm_new() (--max-call-depth)
+static size_t g_max_call_depth = CALL_DEPTH_DEFAULT;
 
 // Kronos keywords for tab completion
 static const char *kronos_keywords[] = {
@@ -86,6 +90,13 @@ static void print_usage(const char *program_name) {
   printf("  -n, --no-color      Disable colored output (future use)\n");
   printf("  -e, --execute CODE  Execute CODE as Kronos code (can be used "
          "multiple times)\n");
+  printf("  -O, --optimize N    Set the bytecode optimization level (0 "
+         "disables optimizations, 1 is the default)\n");
+  printf("      --no-inline     Compile every function call as a call "
+         "(for debugging)\n");
+  printf("      --max-call-depth N  Allow N nested function calls (default "
+         "%d)\n",
+         CALL_DEPTH_DEFAULT);
   printf("\n");
   printf("If FILE is provided, executes the specified Kronos file(s).\n");
   printf("If -e is provided, executes the code and exits (does not start "
@@ -194,6 +205,7 @@ KronosVM *kronos_vm_new(void) {
     runtime_cleanup();
     return NULL;
   }
+  vm_set_max_call_depth(vm, g_max_call_depth);
   return vm;
 }
 
@@ -680,6 +692,7 @@ static KronosValue *kronos_run_expression(KronosVM *vm, const char *source) {
   }
   ast->capacity = 1;
   ast->count = 1;
+  ast->arena = NULL;
   ast->statements = malloc(sizeof(ASTNode *));
   if (!ast->statements) {
     free(ast);
@@ -834,7 +847,11 @@ int main(int argc, char **argv) {
   static struct option long_options[] = {
       {"help", no_argument, 0, 'h'},          {"version", no_argument, 0, 'v'},
       {"debug", no_argument, 0, 'd'},         {"no-color", no_argument, 0, 'n'},
-      {"execute", required_argument, 0, 'e'}, {0, 0, 0, 0}};
+      {"execute", required_argument, 0, 'e'},
+      {"optimize", required_argument, 0, 'O'},
+      {"no-inline", no_argument, 0, 'I'},
+      {"max-call-depth", required_argument, 0, 'D'},
+      {0, 0, 0, 0}};
 
   int opt;
   int option_index = 0;
@@ -848,7 +865,7 @@ int main(int argc, char **argv) {
   size_t execute_capacity = 0;
 
   // Parse command-line options
-  while ((opt = getopt_long(argc, argv, "hvdne:", long_options,
+  while ((opt = getopt_long(argc, argv, "hvdne:O:", long_options,
                             &option_index)) != -1) {
     switch (opt) {
     case 'h':
@@ -883,6 +900,38 @@ int main(int argc, char **argv) {
       }
       execute_args[execute_count++] = optarg;
       break;
+    case 'O':
+      if (strcmp(optarg, "0") != 0 && strcmp(optarg, "1") != 0) {
+        fprintf(stderr, "Error: Invalid optimization level '%s' (expected 0 "
+                        "or 1)\n",
+                optarg);
+        if (execute_args) {
+          free(execute_args);
+        }
+        return 1;
+      }
+      compiler_set_optimization_level(optarg[0] - '0');
+      break;
+    case 'I':
+      compiler_set_inlining(false);
+      break;
+    case 'D': {
+      char *end = NULL;
+      errno = 0;
+      unsigned long long depth = strtoull(optarg, &end, 10);
+      if (errno != 0 || end == optarg || *end != '\0' || depth == 0 ||
+          optarg[0] == '-' || depth > SIZE_MAX) {
+        fprintf(stderr, "Error: Invalid call depth '%s' (expected a positive "
+                        "number)\n",
+                optarg);
+        if (execute_args) {
+          free(execute_args);
+        }
+        return 1;
+      }
+      g_max_call_depth = (size_t)depth;
+      break;
+    }
     case '?':
       // Invalid option - getopt already printed error message
       if (execute_args) {
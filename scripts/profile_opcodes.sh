@@ -0,0 +1,77 @@
+#!/bin/bash
+
+# Kronos Opcode Profiler
+# Builds a profiling interpreter (-DKRONOS_OPCODE_PROFILE=1), runs a corpus
+# of scripts and reports the most frequently executed opcode pairs and
+# triples. Used to choose which sequences get a fused superinstruction.
+#
+# Usage: ./scripts/profile_opcodes.sh [top] [script.kr...]
+#   top         Number of pairs/triples to report (default: 15)
+#   script.kr   Scripts to profile (default: examples/*.kr and
+#               tests/integration/pass/*.kr)
+
+set -e
+
+# Colors for output
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+BLUE='\033[0;34m'
+NC='\033[0m' # No Color
+
+top=15
+if [[ "$1" =~ ^[0-9]+$ ]]; then
+    top="$1"
+    shift
+fi
+
+if [ $# -gt 0 ]; then
+    scripts=("$@")
+else
+    scripts=(examples/*.kr tests/integration/pass/*.kr)
+fi
+
+workdir=$(mktemp -d)
+trap 'rm -rf "$workdir"' EXIT
+
+echo "${BLUE}Building profiling interpreter...${NC}"
+sources=$(make -s -f Makefile --eval='print-src: ; @echo $(ALL_SRC)' print-src)
+if make src/frontend/keywords_hash.c > /dev/null 2>&1 &&
+    gcc -std=c11 -O2 -Iinclude -Isrc -DKRONOS_OPCODE_PROFILE=1 \
+        -o "$workdir/kronos-profile" $sources -lm > /dev/null 2>&1; then
+    echo "${GREEN}✓${NC} Build successful"
+else
+    echo "${RED}✗${NC} Build failed"
+    exit 1
+fi
+
+set +e
+export KRONOS_OPCODE_PROFILE_OUT="$workdir/counts"
+for script in "${scripts[@]}"; do
+    "$workdir/kronos-profile" "$script" < /dev/null > /dev/null 2>&1
+done
+
+if [ ! -s "$KRONOS_OPCODE_PROFILE_OUT" ]; then
+    echo "${RED}✗${NC} No opcodes were profiled"
+    exit 1
+fi
+
+report() {
+    local kind="$1" fields="$2"
+    echo ""
+    echo "Top $top opcode ${kind}s (${#scripts[@]} scripts)"
+    awk -v kind="$kind" -v n="$fields" '
+        $1 == kind {
+            key = $2
+            for (i = 3; i <= n + 1; i++) key = key " " $i
+            count[key] += $(n + 2)
+            total += $(n + 2)
+        }
+        END {
+            for (k in count) printf "%d %.2f %s\n", count[k], 100 * count[k] / total, k
+        }' "$KRONOS_OPCODE_PROFILE_OUT" |
+        sort -rn | head -n "$top" |
+        awk '{ printf "  %12d %6.2f%%  ", $1, $2; for (i = 3; i <= NF; i++) printf "%s ", $i; printf "\n" }'
+}
+
+report pair 2
+report triple 3
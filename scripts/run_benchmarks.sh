@@ -0,0 +1,156 @@
+#!/bin/bash
+
+# Kronos Benchmark Runner
+# Builds the interpreter and times each script in tests/bench/
+#
+# Usage: ./scripts/run_benchmarks.sh [runs] [benchmark-name...]
+#   runs            Timed runs per benchmark; the best time is reported
+#                   (default: 3)
+#   benchmark-name  Run only the named benchmarks (file name without .kr,
+#                   constant_pool for the generated literal scripts, or
+#                   frontend for the generated parser scripts)
+
+set -e
+
+# Colors for output
+GREEN='\033[0;32m'
+RED='\033[0;31m'
+BLUE='\033[0;34m'
+NC='\033[0m' # No Color
+
+runs=3
+if [[ "$1" =~ ^[0-9]+$ ]]; then
+    runs="$1"
+    shift
+fi
+
+echo "════════════════════════════════════════════════════════════"
+echo "              KRONOS BENCHMARKS"
+echo "════════════════════════════════════════════════════════════"
+echo ""
+
+echo "${BLUE}Building Kronos...${NC}"
+if make > /dev/null 2>&1; then
+    echo "${GREEN}✓${NC} Build successful"
+else
+    echo "${RED}✗${NC} Build failed"
+    exit 1
+fi
+echo ""
+
+set +e
+
+# Generated benchmark: a script of N distinct literals (alternating numbers
+# and strings). Run time is dominated by compiling the constant pool, so the
+# 25k/50k/100k rows should scale linearly.
+literal_sizes=(25000 50000 100000)
+
+generate_literals() {
+    awk -v n="$1" 'BEGIN {
+        for (i = 0; i < n; i++) {
+            if (i % 2) printf "let n to %d.5\n", i
+            else printf "let s to \"row %d\"\n", i
+        }
+    }' > "$2"
+}
+
+# Generated benchmark: N copies of a block mixing nested control flow,
+# collection literals, f-strings and operators, guarded by a condition that
+# is false at run time. Nearly all of the time goes to tokenizing, parsing,
+# compiling and freeing the front-end data (about 440 bytes per block).
+frontend_sizes=(5000 10000 20000)
+
+generate_frontend() {
+    awk -v n="$1" 'BEGIN {
+        printf "let skip to call len with \"\"\n"
+        for (i = 0; i < n; i++) {
+            printf "if skip:\n"
+            printf "    let x%d to skip plus %d times 3 minus %d\n", i, i, i
+            printf "    if x%d is greater than 10 and skip is not equal to 0:\n", i
+            printf "        let items to list 1, 2.5, \"s%d\", x%d\n", i, i
+            printf "        for item in items:\n"
+            printf "            print f\"item {item} of {x%d}\"\n", i
+            printf "    else if x%d is less than 0:\n", i
+            printf "        let m to map \"k\": x%d, \"v\": skip\n", i, i
+            printf "        print m at \"k\"\n"
+            printf "    else:\n"
+            printf "        while x%d is greater than 0:\n", i
+            printf "            let x%d to x%d minus 1\n", i, i
+            printf "\n"
+        }
+    }' > "$2"
+}
+
+benchmarks=()
+generated_literals=0
+generated_frontend=0
+if [ $# -gt 0 ]; then
+    for name in "$@"; do
+        if [ "$name" = "constant_pool" ]; then
+            generated_literals=1
+        elif [ "$name" = "frontend" ]; then
+            generated_frontend=1
+        else
+            benchmarks+=("tests/bench/${name}.kr")
+        fi
+    done
+else
+    benchmarks=(tests/bench/*.kr)
+    generated_literals=1
+    generated_frontend=1
+fi
+
+if [ $generated_literals -eq 1 ] || [ $generated_frontend -eq 1 ]; then
+    generated_dir=$(mktemp -d)
+    trap 'rm -rf "$generated_dir"' EXIT
+fi
+if [ $generated_literals -eq 1 ]; then
+    for size in "${literal_sizes[@]}"; do
+        bench="$generated_dir/constant_pool_$((size / 1000))k.kr"
+        generate_literals "$size" "$bench"
+        benchmarks+=("$bench")
+    done
+fi
+if [ $generated_frontend -eq 1 ]; then
+    for size in "${frontend_sizes[@]}"; do
+        bench="$generated_dir/frontend_$((size / 1000))k.kr"
+        generate_frontend "$size" "$bench"
+        benchmarks+=("$bench")
+    done
+fi
+
+printf "%-32s %12s\n" "benchmark" "best (s)"
+printf "%-32s %12s\n" "---------" "--------"
+
+status=0
+for bench in "${benchmarks[@]}"; do
+    name=$(basename "$bench" .kr)
+    if [ ! -f "$bench" ]; then
+        printf "%-32s ${RED}%12s${NC}\n" "$name" "missing"
+        status=1
+        continue
+    fi
+
+    best=""
+    for ((run = 0; run < runs; run++)); do
+        start=$(date +%s.%N)
+        if ! ./kronos "$bench" > /dev/null 2>&1; then
+            best="failed"
+            break
+        fi
+        end=$(date +%s.%N)
+        elapsed=$(awk -v s="$start" -v e="$end" 'BEGIN { printf "%.6f", e - s }')
+        if [ -z "$best" ] || awk -v a="$elapsed" -v b="$best" 'BEGIN { exit !(a < b) }'; then
+            best="$elapsed"
+        fi
+    done
+
+    if [ "$best" = "failed" ]; then
+        printf "%-32s ${RED}%12s${NC}\n" "$name" "failed"
+        status=1
+    else
+        printf "%-32s %12.3f\n" "$name" "$best"
+    fi
+done
+
+exit $status
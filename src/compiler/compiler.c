@@ -18,16 +18,48 @@
  * - No separate opcodes for break/continue: OP_BREAK/OP_CONTINUE are reserved
  *   but never emitted. We use OP_JUMP with patched offsets instead (keeps
  *   instruction set small).
+ * - Slot-resolved locals: before a function body is compiled, its locals are
+ *   collected into a FunctionScope (parameters first). Loads/stores of those
+ *   names emit OP_LOAD_LOCAL/OP_STORE_LOCAL with a one-byte slot, and the
+ *   per-slot name/mutability/type is emitted once in OP_DEFINE_FUNC.
+ * - Type specialisation: operand types are inferred with the shared rules in
+ *   infer.c. Where both operands are provably numbers (or strings, or the
+ *   container a list) the quickened opcode is emitted directly instead of
+ *   the generic one. Variables are only typed when that is provable: the
+ *   counter of a fused range loop whose body never rebinds it. Typed opcodes
+ *   still guard their operands, so an unprovable site just starts generic
+ *   and is quickened by the VM at runtime.
+ * - Optimization (-O1, default): constant subexpressions are folded by
+ *   fold.c, constant branches and statements after a terminator are compiled
+ *   as dead code and rolled back (so they still report errors), and a final
+ *   pass threads recorded jumps that land on unconditional jumps.
+ * - SSA optimization of function bodies (-O1): ir.c builds each body's SSA
+ *   form and runs copy propagation, dead store elimination, common
+ *   subexpression elimination and loop-invariant code motion. The result is
+ *   a plan of per-node actions applied while compiling the body as usual;
+ *   values it reuses live in hidden temp slots after the body's locals.
+ * - Inlining (-O1): inside function bodies, calls to small leaf functions
+ *   that inline.c proves are the only definition of their name compile to
+ *   the function's body, with its locals renamed to hidden slots of the
+ *   caller.
+ * - Tail calls (all levels): `return call f ...` in a function body, outside
+ *   try statements, emits OP_TAIL_CALL then OP_RETURN_VAL. The VM reuses the
+ *   frame for a user function, so deep recursion does not depend on -O.
+ * - Wide operands: constant indices, global slots and jump offsets are
+ *   16-bit unless an instruction is prefixed with OP_WIDE, which makes them
+ *   32-bit. Constants widen per instruction (only those referencing an index
+ *   past 0xFFFE). Jumps widen per unit: if any jump offset or function body
+ *   position does not fit, compile() compiles the unit again with every jump
+ *   wide, so small programs keep the compact encoding.
  *
  * EDGE CASES:
  * - Forward references: Jump offsets patched after target compilation
  * - Nested loops: Loop stack tracks multiple active loops (break/continue
  *   applies to innermost loop)
- * - Jump offset overflow: INT16_MAX limit for jump offsets (would require
- *   larger bytecode, but extremely unlikely)
+ * - Jump offset overflow: recompiles the unit with 32-bit jump offsets
  * - Empty functions: Valid (emits OP_RETURN_VAL with nil if no return)
- * - Constant pool overflow: Not checked (would require SIZE_MAX check, but
- *   extremely unlikely)
+ * - Constant pool overflow: an error past 0xFFFFFFFE constants (the widest
+ *   index the bytecode can address)
  *
  * Converts Abstract Syntax Trees into bytecode instructions for the virtual
  * machine. Handles:
@@ -39,6 +71,10 @@
  */
 
 #include "compiler.h"
+#include "fold.h"
+#include "infer.h"
+#include "inline.h"
+#include "ir.h"
 #include <limits.h>
 #include <stdbool.h>
 #include <stdint.h>
@@ -56,8 +92,12 @@
 #define BYTECODE_INITIAL_CAPACITY 256
 #define CONSTANT_POOL_INITIAL_CAPACITY 8
 #define CONSTANT_POOL_DEFAULT_CAPACITY 32
+#define CONSTANT_INDEX_INITIAL_CAPACITY 64
 #define JUMP_ARRAY_INITIAL_CAPACITY 4
 
+// Upper bound on the jump chain followed when threading one jump
+#define JUMP_THREAD_MAX_HOPS 16
+
 /**
  * Tracks a pending jump instruction that needs patching
  *
@@ -87,6 +127,49 @@ typedef struct LoopInfo {
   struct LoopInfo *next;
 } LoopInfo;
 
+/**
+ * A variable whose type is proven for the code being compiled
+ *
+ * DESIGN DECISION: Stack-allocated nodes linked from the Compiler, pushed
+ * and popped around the range loop body that proves them. Nested functions
+ * start with an empty list (they see different bindings of the same names).
+ */
+typedef struct TypedVar {
+  const char *name; // Borrowed from the AST
+  ExprType type;
+  struct TypedVar *next;
+} TypedVar;
+
+/**
+ * Describes one slot-resolved local variable of a function
+ *
+ * DESIGN DECISION: Mutability and type come from the first declaration in
+ * source order and are emitted once per function (slot descriptor table in
+ * OP_DEFINE_FUNC), so frames only store values.
+ */
+typedef struct {
+  char *name;            // Variable name (owned)
+  bool is_mutable;       // Mutability of the first declaration
+  const char *type_name; // Type annotation of the first declaration (borrowed
+                         // from the AST, NULL if none)
+} LocalSlotInfo;
+
+/**
+ * Local variable scope of the function body being compiled
+ *
+ * DESIGN DECISION: Locals are collected up front (parameters first, then
+ * assignments, loop and catch variables) so OP_LOAD_LOCAL/OP_STORE_LOCAL can
+ * address them by slot. Nested functions get their own scope; names that are
+ * never assigned in the function resolve to globals via OP_LOAD_VAR.
+ */
+typedef struct FunctionScope {
+  LocalSlotInfo *slots;
+  size_t slot_count;
+  size_t slot_capacity;
+  size_t param_count; // Slots [0, param_count) are the parameters
+  struct FunctionScope *enclosing;
+} FunctionScope;
+
 /**
  * Compiler state structure
  * Tracks bytecode generation and error state
@@ -99,6 +182,35 @@ typedef struct {
   size_t to_string_const_idx; /**< Cache for "to_string" constant (SIZE_MAX if
                not created) */
   size_t loop_counter;        /**< Counter for unique iterator variable names */
+  FunctionScope *scope; /**< Innermost function scope (NULL at top level) */
+  size_t range_depth;   /**< Fused range loops enclosing the current code of
+                           the current function (or top level) */
+  size_t iter_depth;    /**< For-in loops enclosing the current code of the
+                           current function (or top level) */
+  size_t try_depth;     /**< Try statements enclosing the current code of the
+                           current function (or top level) */
+  TypedVar *typed_vars; /**< Variables with a proven type (innermost first) */
+  bool optimize;        /**< Fold constants, drop dead code, thread jumps */
+  IRPlan *plan; /**< SSA optimizer actions for the current function body
+                   (NULL if none) */
+  InlineTable *inlines; /**< Functions whose calls may be inlined (NULL if
+                           inlining is off) */
+  const InlineCandidate *inlining; /**< Function whose body is being inlined
+                                      (NULL if none) */
+  const ASTNode **inline_args; /**< Per parameter of the inlined function:
+                                  argument read in its place, or NULL */
+  size_t *jump_sites;   /**< Opcode positions of control-flow jumps, in
+                           emission order (for jump threading) */
+  size_t jump_site_count;
+  size_t jump_site_capacity;
+  bool wide_jumps;    /**< Jump operands are 32-bit (OP_WIDE on every jump) */
+  bool jump_overflow; /**< A jump did not fit a 16-bit operand: compile()
+                         compiles the unit again with wide_jumps */
+  bool quiet;         /**< Warnings were reported by an earlier compile of
+                         the same unit */
+  uint32_t *const_index; /**< Hash index over the constant pool (linear
+                            probing): pool index + 1 per slot, 0 if empty */
+  size_t const_index_capacity; /**< Slots in const_index (power of two) */
 } Compiler;
 
 static inline bool compiler_has_error(const Compiler *c) {
@@ -120,6 +232,14 @@ static void compiler_set_error(Compiler *c, const char *message) {
   }
 }
 
+/**
+ * @brief Message of the last failed compile() on this thread
+ *
+ * Owns the string handed out through compile()'s out_err, so each message
+ * is freed when the next failure replaces it instead of leaking.
+ */
+static _Thread_local char *g_compiler_last_error = NULL;
+
 /**
  * @brief Global warning callback for capturing compiler warnings
  *
@@ -145,12 +265,15 @@ void compiler_set_warning_callback(void (*callback)(const char *message)) {
  * that can be detected at compile time (e.g., division by literal zero).
  *
  * If a warning callback is set, it will be called; otherwise warnings go to
- * stderr.
+ * stderr. A unit compiled a second time (with wide jumps) stays quiet, and
+ * so does an inlined copy of a function body: the function's own definition
+ * reports its warnings once.
  *
+ * @param c Compiler state
  * @param message Warning message to display
  */
-static void compiler_warn(const char *message) {
-  if (message) {
+static void compiler_warn(const Compiler *c, const char *message) {
+  if (message && !c->quiet && !c->inlining) {
     if (g_compiler_warning_callback) {
       // Use callback (for WASM capture)
       char buf[256];
@@ -163,11 +286,37 @@ static void compiler_warn(const char *message) {
   }
 }
 
+/**
+ * @brief Global optimization level (see compiler_set_optimization_level)
+ */
+static int g_compiler_optimization_level = 1;
+
+void compiler_set_optimization_level(int level) {
+  g_compiler_optimization_level = level;
+}
+
+/**
+ * @brief Global inlining switch (see compiler_set_inlining)
+ */
+static bool g_compiler_inlining = true;
+
+void compiler_set_inlining(bool enabled) { g_compiler_inlining = enabled; }
+
+/**
+ * @brief Built-in function lookup (see compiler_set_builtin_lookup)
+ *
+ * Without it the compiler cannot rule out that a call reaches a built-in,
+ * so nothing is inlined.
+ */
+static bool (*g_compiler_builtin_lookup)(const char *name) = NULL;
+
+void compiler_set_builtin_lookup(bool (*is_builtin)(const char *name)) {
+  g_compiler_builtin_lookup = is_builtin;
+}
+
 // Forward declarations for jump offset helpers
 static size_t emit_jump_with_offset(Compiler *c, uint8_t opcode);
-static void patch_jump_offset(Compiler *c, size_t offset_pos, int16_t offset);
-static void patch_jump_offset_unsigned(Compiler *c, size_t offset_pos,
-                                       uint16_t offset);
+static void patch_jump(Compiler *c, size_t operand_pos, size_t target);
 
 // Push loop info onto stack
 static bool push_loop(Compiler *c, size_t loop_start) {
@@ -222,34 +371,10 @@ static void patch_pending_jumps(Compiler *c) {
 
     size_t target_pos =
         jump->is_break ? c->loop_stack->loop_end : c->loop_stack->loop_continue;
-    // jump_pos points to the first byte of the 16-bit offset (after OP_JUMP)
-    size_t offset = target_pos - (jump->jump_pos + 2);
-
-    if (jump->is_break) {
-      // Forward jump
-      if (offset > INT16_MAX) {
-        compiler_set_error(c, "break jump offset too large");
-        free(jump); // Free current node before early return
-        return;
-      }
-      patch_jump_offset(c, jump->jump_pos, (int16_t)offset);
-    } else {
-      // Backward jump for continue (or forward, but shouldn't happen)
-      if (target_pos < jump->jump_pos + 2) {
-        // Backward jump - calculate signed offset
-        int16_t signed_offset = (int16_t)(target_pos - (jump->jump_pos + 2));
-        patch_jump_offset(c, jump->jump_pos, signed_offset);
-      } else {
-        // Forward jump (shouldn't happen, but handle it)
-        if (offset > INT16_MAX) {
-          compiler_set_error(c, "continue jump offset too large");
-          free(jump); // Free current node before early return
-          return;
-        }
-        patch_jump_offset(c, jump->jump_pos, (int16_t)offset);
-      }
-    }
-    free(jump); // Free current node after successful patching
+    // jump_pos is the offset operand of an OP_JUMP (forward for break,
+    // backward for continue)
+    patch_jump(c, jump->jump_pos, target_pos);
+    free(jump);
   }
 }
 
@@ -270,6 +395,152 @@ static void pop_loop(Compiler *c) {
   c->loop_stack = next;
 }
 
+/**
+ * @brief Resolve a name to a local slot in the given function scope
+ *
+ * Searches from the most recent slot so that a repeated parameter name binds
+ * to the last parameter, matching the old name-based binding order.
+ *
+ * @return Slot index, or -1 if the name is not a local of this function
+ */
+static int scope_resolve(const FunctionScope *scope, const char *name) {
+  if (!scope || !name) {
+    return -1;
+  }
+  for (size_t i = scope->slot_count; i > 0; i--) {
+    if (strcmp(scope->slots[i - 1].name, name) == 0) {
+      return (int)(i - 1);
+    }
+  }
+  return -1;
+}
+
+/**
+ * @brief Append a slot to a function scope (no duplicate check)
+ */
+static bool scope_add_slot(Compiler *c, FunctionScope *scope, const char *name,
+                           bool is_mutable, const char *type_name) {
+  if (scope->slot_count >= LOCAL_SLOTS_MAX) {
+    char error_buf[128];
+    snprintf(error_buf, sizeof(error_buf),
+             "Too many local variables in function (limit %d)",
+             LOCAL_SLOTS_MAX);
+    compiler_set_error(c, error_buf);
+    return false;
+  }
+  if (scope->slot_count >= scope->slot_capacity) {
+    size_t new_capacity =
+        scope->slot_capacity == 0 ? 8 : scope->slot_capacity * 2;
+    LocalSlotInfo *new_slots =
+        realloc(scope->slots, sizeof(LocalSlotInfo) * new_capacity);
+    if (!new_slots) {
+      compiler_set_error(c, "Failed to allocate local slot table");
+      return false;
+    }
+    scope->slots = new_slots;
+    scope->slot_capacity = new_capacity;
+  }
+  size_t name_len = strlen(name);
+  char *name_copy = malloc(name_len + 1);
+  if (!name_copy) {
+    compiler_set_error(c, "Failed to allocate local variable name");
+    return false;
+  }
+  memcpy(name_copy, name, name_len + 1);
+  scope->slots[scope->slot_count].name = name_copy;
+  scope->slots[scope->slot_count].is_mutable = is_mutable;
+  scope->slots[scope->slot_count].type_name = type_name;
+  scope->slot_count++;
+  return true;
+}
+
+/**
+ * @brief Declare a local in a function scope (first declaration wins)
+ */
+static bool scope_declare(Compiler *c, FunctionScope *scope, const char *name,
+                          bool is_mutable, const char *type_name) {
+  if (scope_resolve(scope, name) >= 0) {
+    return true;
+  }
+  return scope_add_slot(c, scope, name, is_mutable, type_name);
+}
+
+/**
+ * @brief Collect the locals declared by a block of statements
+ *
+ * Walks nested control flow in the same order compile_statement() does, but
+ * does not descend into nested function definitions (they have their own
+ * scope).
+ */
+static void scope_collect_locals(Compiler *c, FunctionScope *scope,
+                                 ASTNode **block, size_t block_size) {
+  for (size_t i = 0; i < block_size && !compiler_has_error(c); i++) {
+    const ASTNode *node = block[i];
+    if (!node) {
+      continue;
+    }
+    switch (node->type) {
+    case AST_ASSIGN:
+      scope_declare(c, scope, node->as.assign.name, node->as.assign.is_mutable,
+                    node->as.assign.type_name);
+      break;
+    case AST_IF:
+      scope_collect_locals(c, scope, node->as.if_stmt.block,
+                           node->as.if_stmt.block_size);
+      for (size_t j = 0; j < node->as.if_stmt.else_if_count; j++) {
+        scope_collect_locals(c, scope, node->as.if_stmt.else_if_blocks[j],
+                             node->as.if_stmt.else_if_block_sizes[j]);
+      }
+      scope_collect_locals(c, scope, node->as.if_stmt.else_block,
+                           node->as.if_stmt.else_block_size);
+      break;
+    case AST_FOR:
+      scope_declare(c, scope, node->as.for_stmt.var, true, NULL);
+      if (node->as.for_stmt.value_var) {
+        scope_declare(c, scope, node->as.for_stmt.value_var, true, NULL);
+      }
+      scope_collect_locals(c, scope, node->as.for_stmt.block,
+                           node->as.for_stmt.block_size);
+      break;
+    case AST_WHILE:
+      scope_collect_locals(c, scope, node->as.while_stmt.block,
+                           node->as.while_stmt.block_size);
+      break;
+    case AST_TRY:
+      scope_collect_locals(c, scope, node->as.try_stmt.try_block,
+                           node->as.try_stmt.try_block_size);
+      for (size_t j = 0; j < node->as.try_stmt.catch_block_count; j++) {
+        if (node->as.try_stmt.catch_blocks[j].catch_var) {
+          scope_declare(c, scope, node->as.try_stmt.catch_blocks[j].catch_var,
+                        true, NULL);
+        }
+        scope_collect_locals(c, scope,
+                             node->as.try_stmt.catch_blocks[j].catch_block,
+                             node->as.try_stmt.catch_blocks[j].catch_block_size);
+      }
+      if (node->as.try_stmt.finally_block) {
+        scope_collect_locals(c, scope, node->as.try_stmt.finally_block,
+                             node->as.try_stmt.finally_block_size);
+      }
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+// Free a function scope and its slot names
+static void scope_free(FunctionScope *scope) {
+  if (!scope) {
+    return;
+  }
+  for (size_t i = 0; i < scope->slot_count; i++) {
+    free(scope->slots[i].name);
+  }
+  free(scope->slots);
+  free(scope);
+}
+
 /**
  * @brief Emit a single byte to the bytecode
  *
@@ -326,7 +597,8 @@ static void emit_byte(Compiler *c, uint8_t byte) {
 /**
  * @brief Emit a 16-bit value in big-endian format
  *
- * Used for constant indices, variable indices, and jump offsets.
+ * Used for counts; constant indices, global slots and jump offsets go
+ * through emit_operand().
  *
  * @param c Compiler state
  * @param value 16-bit value to emit
@@ -337,50 +609,316 @@ static void emit_uint16(Compiler *c, uint16_t value) {
 }
 
 /**
- * @brief Emit a jump instruction with placeholder for 16-bit signed offset
+ * @brief Whether an instruction referencing constant @p idx must be wide
+ *
+ * NO_CONSTANT_NARROW itself marks an absent constant, so it is not a valid
+ * narrow index.
+ */
+static inline bool constant_is_wide(size_t idx) {
+  return idx >= NO_CONSTANT_NARROW;
+}
+
+/**
+ * @brief Emit an opcode, prefixed with OP_WIDE if its operands are wide
+ */
+static void emit_opcode(Compiler *c, uint8_t opcode, bool wide) {
+  if (wide) {
+    emit_byte(c, OP_WIDE);
+  }
+  emit_byte(c, opcode);
+}
+
+/**
+ * @brief Emit a constant index, global slot or jump offset operand
+ *
+ * Big-endian; 32-bit in an instruction prefixed with OP_WIDE, else 16-bit.
+ */
+static void emit_operand(Compiler *c, uint32_t value, bool wide) {
+  if (wide) {
+    emit_uint16(c, (uint16_t)(value >> 16));
+  }
+  emit_uint16(c, (uint16_t)(value & 0xFFFF));
+}
+
+/**
+ * @brief Emit an absent optional constant operand
+ */
+static void emit_no_constant(Compiler *c, bool wide) {
+  emit_operand(c, wide ? NO_CONSTANT_WIDE : NO_CONSTANT_NARROW, wide);
+}
+
+/**
+ * @brief Emit an instruction whose only operand is constant @p idx
+ */
+static void emit_constant_op(Compiler *c, uint8_t opcode, size_t idx) {
+  bool wide = constant_is_wide(idx);
+  emit_opcode(c, opcode, wide);
+  emit_operand(c, (uint32_t)idx, wide);
+}
+
+/**
+ * @brief Remember a control-flow jump at @p opcode_pos for jump threading
+ *
+ * Only jumps recorded here are retargeted or threaded through; the jump in
+ * the OP_DEFINE_FUNC header is not recorded, its operand is the body length.
+ */
+static void record_jump_site(Compiler *c, size_t opcode_pos) {
+  if (!c->optimize || compiler_has_error(c)) {
+    return;
+  }
+  if (c->jump_site_count >= c->jump_site_capacity) {
+    size_t new_capacity = c->jump_site_capacity == 0
+                              ? JUMP_ARRAY_INITIAL_CAPACITY
+                              : c->jump_site_capacity * 2;
+    size_t *new_sites = realloc(c->jump_sites, sizeof(size_t) * new_capacity);
+    if (!new_sites) {
+      compiler_set_error(c, "Failed to allocate jump sites array");
+      return;
+    }
+    c->jump_sites = new_sites;
+    c->jump_site_capacity = new_capacity;
+  }
+  c->jump_sites[c->jump_site_count++] = opcode_pos;
+}
+
+/**
+ * @brief Emit a jump opcode, prefixed with OP_WIDE when the unit is
+ * compiled with wide jumps
+ *
+ * @param record Record the jump for jump threading (JUMP, JUMP_IF_FALSE
+ *               and CMP_JUMP_IF_FALSE only)
+ */
+static void emit_jump_opcode(Compiler *c, uint8_t opcode, bool record) {
+  if (record) {
+    record_jump_site(c, c->bytecode->count);
+  }
+  emit_opcode(c, opcode, c->wide_jumps);
+}
+
+/**
+ * @brief Emit a placeholder jump offset operand
+ *
+ * @return Position of the operand (for patch_jump/patch_forward_jump)
+ */
+static size_t emit_jump_operand(Compiler *c) {
+  size_t operand_pos = c->bytecode->count;
+  emit_operand(c, 0, c->wide_jumps);
+  return operand_pos;
+}
+
+/**
+ * @brief Emit a jump instruction with a placeholder offset
  *
  * @param c Compiler state
  * @param opcode OP_JUMP or OP_JUMP_IF_FALSE
- * @return Position of the offset bytes (for later patching)
+ * @return Position of the offset operand (for later patching)
  */
 static size_t emit_jump_with_offset(Compiler *c, uint8_t opcode) {
-  emit_byte(c, opcode);
-  size_t offset_pos = c->bytecode->count;
-  emit_byte(c, 0); // Placeholder high byte
-  emit_byte(c, 0); // Placeholder low byte
-  return offset_pos;
+  emit_jump_opcode(c, opcode, true);
+  return emit_jump_operand(c);
+}
+
+/**
+ * @brief Whether a jump offset fits its operand
+ */
+static bool jump_offset_fits(int64_t offset, bool wide, bool is_signed) {
+  int64_t min = is_signed ? (wide ? INT32_MIN : INT16_MIN) : 0;
+  int64_t max = is_signed ? (wide ? INT32_MAX : INT16_MAX)
+                          : (wide ? (int64_t)UINT32_MAX : UINT16_MAX);
+  return offset >= min && offset <= max;
 }
 
 /**
- * @brief Patch a 16-bit signed jump offset at the given position
+ * @brief Point the jump operand at @p operand_pos to @p target
  *
- * @param c Compiler state
- * @param offset_pos Position where offset bytes start
- * @param offset Signed 16-bit offset to write
+ * Offsets are relative to the end of the operand. OP_JUMP and the loop back
+ * edges read them signed, every other jump only goes forward and reads them
+ * unsigned. An offset that does not fit a 16-bit operand sets
+ * jump_overflow, and compile() compiles the unit again with wide jumps.
+ *
+ * @param wide The operand is 32-bit
+ * @param is_signed The operand is read as a signed offset
+ */
+static void patch_jump_operand(Compiler *c, size_t operand_pos, size_t target,
+                               bool wide, bool is_signed) {
+  if (compiler_has_error(c)) {
+    return;
+  }
+  int64_t offset = (int64_t)target - (int64_t)(operand_pos + (wide ? 4 : 2));
+  if (!jump_offset_fits(offset, wide, is_signed)) {
+    if (wide || (!is_signed && offset < 0)) {
+      compiler_set_error(c, "Jump offset out of range");
+    } else {
+      c->jump_overflow = true;
+    }
+    return;
+  }
+  // Two's complement, truncated to the operand width
+  uint32_t value = (uint32_t)offset;
+  uint8_t *code = c->bytecode->code + operand_pos;
+  if (wide) {
+    *code++ = (uint8_t)((value >> 24) & 0xFF);
+    *code++ = (uint8_t)((value >> 16) & 0xFF);
+  }
+  code[0] = (uint8_t)((value >> 8) & 0xFF);
+  code[1] = (uint8_t)(value & 0xFF);
+}
+
+/**
+ * @brief Patch a signed jump offset (OP_JUMP, loop back edges)
  */
-static void patch_jump_offset(Compiler *c, size_t offset_pos, int16_t offset) {
-  c->bytecode->code[offset_pos] = (uint8_t)((offset >> 8) & 0xFF);
-  c->bytecode->code[offset_pos + 1] = (uint8_t)(offset & 0xFF);
+static void patch_jump(Compiler *c, size_t operand_pos, size_t target) {
+  patch_jump_operand(c, operand_pos, target, c->wide_jumps, true);
 }
 
 /**
- * @brief Patch a 16-bit unsigned jump offset at the given position
+ * @brief Patch a forward-only jump offset (conditional branches, loop
+ * exits, exception handlers)
+ */
+static void patch_forward_jump(Compiler *c, size_t operand_pos,
+                               size_t target) {
+  patch_jump_operand(c, operand_pos, target, c->wide_jumps, false);
+}
+
+/**
+ * @brief Hash of a constant's type and exact content
  *
- * @param c Compiler state
- * @param offset_pos Position where offset bytes start
- * @param offset Unsigned 16-bit offset to write
+ * Strings reuse their cached FNV-1a hash; numbers hash their bit pattern.
+ */
+static uint32_t constant_hash(const KronosValue *value) {
+  uint64_t bits;
+  double num;
+  switch (value_type(value)) {
+  case VAL_NUMBER:
+    num = value_as_number(value);
+    memcpy(&bits, &num, sizeof(bits));
+    break;
+  case VAL_STRING:
+    bits = value->as.string.hash;
+    break;
+  case VAL_BOOL:
+    bits = value->as.boolean;
+    break;
+  case VAL_NIL:
+    bits = 0;
+    break;
+  default:
+    bits = (uint64_t)(uintptr_t)value;
+    break;
+  }
+  // splitmix64 finalizer: spreads number bits into the low (probed) bits
+  bits += (uint64_t)value_type(value) * 0x9E3779B97F4A7C15ULL;
+  bits = (bits ^ (bits >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  bits = (bits ^ (bits >> 27)) * 0x94D049BB133111EBULL;
+  return (uint32_t)(bits ^ (bits >> 31));
+}
+
+/**
+ * @brief Whether two constants have the same type and exact content
+ *
+ * Stricter than value_equals(), which compares numbers with an epsilon:
+ * 1e-10 and 2e-10 are different literals and must stay different constants.
+ */
+static bool constant_same(const KronosValue *a, const KronosValue *b) {
+  if (value_type(a) != value_type(b)) {
+    return false;
+  }
+  switch (value_type(a)) {
+  case VAL_NUMBER: {
+    double x = value_as_number(a);
+    double y = value_as_number(b);
+    return memcmp(&x, &y, sizeof(double)) == 0;
+  }
+  case VAL_STRING:
+    return a->as.string.length == b->as.string.length &&
+           memcmp(a->as.string.data, b->as.string.data,
+                  a->as.string.length) == 0;
+  case VAL_BOOL:
+    return a->as.boolean == b->as.boolean;
+  case VAL_NIL:
+    return true;
+  default:
+    return a == b;
+  }
+}
+
+/**
+ * @brief Slot of @p value in the constant index: the slot holding an equal
+ * constant, or the empty slot where it belongs
+ */
+static size_t constant_index_slot(const Compiler *c,
+                                  const KronosValue *value) {
+  size_t mask = c->const_index_capacity - 1;
+  size_t slot = constant_hash(value) & mask;
+  while (c->const_index[slot] != 0 &&
+         !constant_same(c->bytecode->constants[c->const_index[slot] - 1],
+                        value)) {
+    slot = (slot + 1) & mask;
+  }
+  return slot;
+}
+
+/**
+ * @brief Make room in the constant index for one more constant
+ *
+ * Keeps the load factor at or below 1/2 so probe sequences stay short.
+ */
+static bool constant_index_reserve(Compiler *c) {
+  size_t needed = (c->bytecode->const_count + 1) * 2;
+  if (needed <= c->const_index_capacity) {
+    return true;
+  }
+  size_t new_capacity = c->const_index_capacity == 0
+                            ? CONSTANT_INDEX_INITIAL_CAPACITY
+                            : c->const_index_capacity * 2;
+  uint32_t *new_index = calloc(new_capacity, sizeof(uint32_t));
+  if (!new_index) {
+    return false;
+  }
+  free(c->const_index);
+  c->const_index = new_index;
+  c->const_index_capacity = new_capacity;
+  for (size_t i = 0; i < c->bytecode->const_count; i++) {
+    size_t slot = constant_index_slot(c, c->bytecode->constants[i]);
+    c->const_index[slot] = (uint32_t)(i + 1);
+  }
+  return true;
+}
+
+/**
+ * @brief Remove constant @p idx from the constant index
+ *
+ * Backward-shift deletion: entries after the freed slot move back into it
+ * unless they already sit at or after their home slot, so every probe
+ * sequence stays unbroken without tombstones.
  */
-static void patch_jump_offset_unsigned(Compiler *c, size_t offset_pos,
-                                       uint16_t offset) {
-  c->bytecode->code[offset_pos] = (uint8_t)((offset >> 8) & 0xFF);
-  c->bytecode->code[offset_pos + 1] = (uint8_t)(offset & 0xFF);
+static void constant_index_remove(Compiler *c, size_t idx) {
+  size_t mask = c->const_index_capacity - 1;
+  size_t slot = constant_index_slot(c, c->bytecode->constants[idx]);
+  if (c->const_index[slot] != idx + 1) {
+    return; // Not indexed (an equal constant precedes it)
+  }
+  c->const_index[slot] = 0;
+  for (size_t next = (slot + 1) & mask; c->const_index[next] != 0;
+       next = (next + 1) & mask) {
+    const KronosValue *moved =
+        c->bytecode->constants[c->const_index[next] - 1];
+    size_t home = constant_hash(moved) & mask;
+    // Move the entry back unless its home lies cyclically in (slot, next]
+    if (((next - home) & mask) >= ((next - slot) & mask)) {
+      c->const_index[slot] = c->const_index[next];
+      c->const_index[next] = 0;
+      slot = next;
+    }
+  }
 }
 
 /**
  * @brief Add a constant to the constant pool
  *
- * Constants are deduplicated - if the same value already exists,
- * returns its index. Otherwise adds a new entry.
+ * Constants are deduplicated through a hash index keyed by type and exact
+ * content - if the same value already exists, returns its index. Otherwise
+ * adds a new entry.
  *
  * @param c Compiler state
  * @param value Value to add (ownership ALWAYS transferred - value is released
@@ -400,6 +938,12 @@ static size_t add_constant(Compiler *c, KronosValue *value) {
     return SIZE_MAX;
   }
 
+  if (c->bytecode->const_count >= NO_CONSTANT_WIDE) {
+    compiler_set_error(c, "Too many constants (limit 4294967294)");
+    value_release(value);
+    return SIZE_MAX;
+  }
+
   if (c->bytecode->const_count >= c->bytecode->const_capacity) {
     // Determine new capacity (minimum CONSTANT_POOL_INITIAL_CAPACITY if
     // starting from 0)
@@ -447,13 +991,17 @@ static size_t add_constant(Compiler *c, KronosValue *value) {
   }
 
   // Check if this constant already exists (deduplication)
-  for (size_t i = 0; i < c->bytecode->const_count; i++) {
-    if (value_equals(c->bytecode->constants[i], value)) {
-      // Found existing constant - return its index
-      // Release the duplicate value since add_constant always takes ownership
-      value_release(value);
-      return i;
-    }
+  if (!constant_index_reserve(c)) {
+    compiler_set_error(c, "Failed to allocate memory for constant index");
+    value_release(value);
+    return SIZE_MAX;
+  }
+  size_t slot = constant_index_slot(c, value);
+  if (c->const_index[slot] != 0) {
+    // Found existing constant - return its index
+    // Release the duplicate value since add_constant always takes ownership
+    value_release(value);
+    return c->const_index[slot] - 1;
   }
 
   // Not found - add new constant
@@ -461,6 +1009,7 @@ static size_t add_constant(Compiler *c, KronosValue *value) {
   size_t idx = c->bytecode->const_count;
   c->bytecode->constants[idx] = value;
   c->bytecode->const_count++;
+  c->const_index[slot] = (uint32_t)(idx + 1);
 
   return idx;
 }
@@ -505,114 +1054,59 @@ static void emit_constant(Compiler *c, KronosValue *value) {
     return;
   }
 
-  if (idx > UINT16_MAX) {
-    compiler_set_error(c, "Too many constants (limit 65535)");
-    // Value was already released by add_constant
-    return;
-  }
-
-  emit_byte(c, OP_LOAD_CONST);
+  emit_constant_op(c, OP_LOAD_CONST, idx);
+  // Success - add_constant already handled ownership
+}
 
-  // Check for errors immediately
-  if (compiler_has_error(c)) {
-    return;
+/**
+ * @brief Add @p value to the constant pool and emit @p opcode referencing it
+ *
+ * @param value Constant (ownership transferred, as with add_constant())
+ * @return true on success, false if the constant could not be added
+ */
+static bool emit_constant_instruction(Compiler *c, uint8_t opcode,
+                                      KronosValue *value) {
+  size_t idx = add_constant(c, value);
+  if (idx == SIZE_MAX) {
+    return false;
   }
+  emit_constant_op(c, opcode, idx);
+  return !compiler_has_error(c);
+}
 
-  emit_uint16(c, (uint16_t)idx);
-
-  // Check for errors immediately
-  if (compiler_has_error(c)) {
-    return;
+/**
+ * @brief Emit a store to a compiler-managed (mutable, untyped) variable
+ *
+ * Stores to a local slot when @p slot is non-negative, otherwise to the
+ * named variable at constant index @p name_idx (loop and catch variables).
+ */
+static void emit_store_variable(Compiler *c, int slot, size_t name_idx) {
+  if (slot >= 0) {
+    emit_byte(c, OP_STORE_LOCAL);
+    emit_byte(c, (uint8_t)slot);
+  } else {
+    emit_constant_op(c, OP_STORE_VAR, name_idx);
+    emit_byte(c, 1); // mutable
+    emit_byte(c, 0); // no type annotation
   }
-
-  // Success - add_constant already handled ownership
 }
 
 /**
- * @brief Add a constant to the pool and emit its index as uint16
+ * @brief Get or create the "to_string" constant
  *
- * Helper function to reduce duplication. Handles the common pattern of:
- * - Creating a value
- * - Adding it to constant pool
- * - Checking for errors
- * - Emitting the index as uint16
- * - Releasing the value reference
+ * Caches the constant index to avoid recreating it multiple times.
  *
  * @param c Compiler state
- * @param value Value to add (ownership transferred, will be released)
- * @return true on success, false on error (error set in compiler)
+ * @return Index of "to_string" constant, or SIZE_MAX on error
  */
-static bool emit_constant_index(Compiler *c, KronosValue *value) {
+static size_t get_to_string_constant(Compiler *c) {
   if (!c) {
-    if (value) {
-      value_release(value);
-    }
-    return false;
+    return SIZE_MAX;
   }
 
-  // Check for errors BEFORE doing any work
-  if (compiler_has_error(c)) {
-    if (value) {
-      value_release(value);
-    }
-    return false;
-  }
-
-  // Validate value is not NULL
-  if (!value) {
-    compiler_set_error(c, "Cannot add NULL constant to pool");
-    return false;
-  }
-
-  size_t idx = add_constant(c, value);
-  // add_constant() always takes ownership (releases if duplicate, takes
-  // ownership if new)
-
-  // Check for errors immediately after add_constant
-  if (compiler_has_error(c)) {
-    // add_constant already released the value on error
-    return false;
-  }
-
-  if (idx == SIZE_MAX) {
-    compiler_set_error(c, "Failed to add constant to pool");
-    // Value was already released by add_constant
-    return false;
-  }
-
-  if (idx > UINT16_MAX) {
-    compiler_set_error(c, "Too many constants (limit 65535)");
-    // Value was already released by add_constant
-    return false;
-  }
-
-  emit_uint16(c, (uint16_t)idx);
-
-  // Check for errors after emitting
-  if (compiler_has_error(c)) {
-    return false;
-  }
-
-  // Success - add_constant already handled ownership
-  return true;
-}
-
-/**
- * @brief Get or create the "to_string" constant
- *
- * Caches the constant index to avoid recreating it multiple times.
- *
- * @param c Compiler state
- * @return Index of "to_string" constant, or SIZE_MAX on error
- */
-static size_t get_to_string_constant(Compiler *c) {
-  if (!c) {
-    return SIZE_MAX;
-
-    // Return cached value if already created
-  }
-  if (c->to_string_const_idx != SIZE_MAX) {
-    return c->to_string_const_idx;
+  // Return cached value if already created
+  if (c->to_string_const_idx != SIZE_MAX) {
+    return c->to_string_const_idx;
   }
 
   // Create and cache it
@@ -626,10 +1120,7 @@ static size_t get_to_string_constant(Compiler *c) {
   // add_constant() always takes ownership (releases if duplicate, retains if
   // new)
 
-  if (idx == SIZE_MAX || idx > UINT16_MAX) {
-    if (idx > UINT16_MAX) {
-      compiler_set_error(c, "Too many constants");
-    }
+  if (idx == SIZE_MAX) {
     return SIZE_MAX;
   }
 
@@ -640,6 +1131,7 @@ static size_t get_to_string_constant(Compiler *c) {
 
 // Forward declarations for expression compilation helpers
 static void compile_expression(Compiler *c, const ASTNode *node);
+static void compile_expression_node(Compiler *c, const ASTNode *node);
 static void compile_number_expression(Compiler *c, const ASTNode *node);
 static void compile_string_expression(Compiler *c, const ASTNode *node);
 static void compile_bool_expression(Compiler *c, const ASTNode *node);
@@ -656,6 +1148,12 @@ static void compile_fstring_expression(Compiler *c, const ASTNode *node);
 
 // Forward declarations for statement compilation helpers
 static void compile_statement(Compiler *c, const ASTNode *node);
+static void compile_block(Compiler *c, ASTNode *const *block,
+                          size_t block_size);
+static void compile_dead_block(Compiler *c, ASTNode *const *block,
+                               size_t block_size);
+static bool block_terminates(const Compiler *c, ASTNode *const *block,
+                             size_t block_size);
 static void compile_assign_statement(Compiler *c, const ASTNode *node);
 static void compile_assign_index_statement(Compiler *c, const ASTNode *node);
 static void compile_delete_statement(Compiler *c, const ASTNode *node);
@@ -672,6 +1170,86 @@ static void compile_for_statement(Compiler *c, const ASTNode *node);
 static void compile_function_statement(Compiler *c, const ASTNode *node);
 static void compile_try_statement(Compiler *c, const ASTNode *node);
 
+/**
+ * @brief Argument read in place of parameter @p name of the function being
+ * inlined, or NULL if the parameter has hidden storage
+ */
+static const ASTNode *inline_argument(const Compiler *c, const char *name) {
+  if (!c->inline_args) {
+    return NULL;
+  }
+  const ASTNode *function = c->inlining->function;
+  for (size_t i = 0; i < function->as.function.param_count; i++) {
+    if (strcmp(function->as.function.params[i], name) == 0) {
+      return c->inline_args[i];
+    }
+  }
+  return NULL;
+}
+
+// InferVarFn: types proven by the enclosing range loops
+static ExprType compiler_var_type(const char *name, void *ctx) {
+  const Compiler *c = ctx;
+  if (c->inlining) {
+    // Of an inlined body's variables, only parameters read in place of
+    // their arguments have the arguments' types
+    const ASTNode *argument = inline_argument(c, name);
+    if (!argument) {
+      return TYPE_UNKNOWN;
+    }
+    if (argument->type != AST_VAR) {
+      return infer_expr_type(argument, NULL, NULL);
+    }
+    name = argument->as.var_name;
+  }
+  for (const TypedVar *var = c->typed_vars; var; var = var->next) {
+    if (strcmp(var->name, name) == 0) {
+      return var->type;
+    }
+  }
+  return TYPE_UNKNOWN;
+}
+
+/**
+ * @brief Typed (quickened) opcode for a binary operator
+ *
+ * @return OP_ADD_NUM..OP_LTE_NUM when both operands are provably numbers,
+ * OP_CONCAT_STR for `plus` on two provable strings, or 0 when the generic
+ * opcode must be emitted
+ */
+static uint8_t typed_binop_opcode(Compiler *c, BinOp op, const ASTNode *left,
+                                  const ASTNode *right) {
+  ExprType left_type = infer_expr_type(left, compiler_var_type, c);
+  if (left_type != TYPE_NUMBER && left_type != TYPE_STRING) {
+    return 0;
+  }
+  ExprType right_type = infer_expr_type(right, compiler_var_type, c);
+  if (left_type != right_type) {
+    return 0;
+  }
+  if (left_type == TYPE_STRING) {
+    return op == BINOP_ADD ? OP_CONCAT_STR : 0;
+  }
+  switch (op) {
+  case BINOP_ADD:
+    return OP_ADD_NUM;
+  case BINOP_SUB:
+    return OP_SUB_NUM;
+  case BINOP_MUL:
+    return OP_MUL_NUM;
+  case BINOP_GT:
+    return OP_GT_NUM;
+  case BINOP_LT:
+    return OP_LT_NUM;
+  case BINOP_GTE:
+    return OP_GTE_NUM;
+  case BINOP_LTE:
+    return OP_LTE_NUM;
+  default:
+    return 0;
+  }
+}
+
 /**
  * @brief Compile a number literal expression
  */
@@ -710,16 +1288,53 @@ static void compile_nil_expression(Compiler *c, const ASTNode *node) {
   emit_constant(c, val);
 }
 
+/**
+ * @brief Resolve a variable of the code being compiled
+ *
+ * Inside an inlined function body, the callee's locals map to their hidden
+ * slots and every other name is a global.
+ *
+ * @param name In: the name as written; out: the name to load or store
+ * @return Local slot, or -1 for a named variable
+ */
+static int resolve_variable(const Compiler *c, const char **name) {
+  if (c->inlining) {
+    const char *hidden = inline_hidden_name(c->inlining, *name);
+    if (!hidden) {
+      return -1;
+    }
+    *name = hidden;
+  }
+  return scope_resolve(c->scope, *name);
+}
+
 /**
  * @brief Compile a variable reference expression
  */
 static void compile_var_expression(Compiler *c, const ASTNode *node) {
-  KronosValue *name =
-      value_new_string(node->as.var_name, strlen(node->as.var_name));
-  emit_byte(c, OP_LOAD_VAR);
-  if (!emit_constant_index(c, name)) {
+  // A parameter of an inlined function may read its argument in place
+  const ASTNode *argument = inline_argument(c, node->as.var_name);
+  if (argument && argument->type == AST_VAR) {
+    emit_byte(c, OP_LOAD_LOCAL);
+    emit_byte(c, (uint8_t)scope_resolve(c->scope, argument->as.var_name));
+    return;
+  }
+  if (argument) {
+    compile_expression_node(c, argument); // A literal
     return;
   }
+
+  // Function locals are addressed by slot; anything else is a global
+  const char *var_name = node->as.var_name;
+  int slot = resolve_variable(c, &var_name);
+  if (slot >= 0) {
+    emit_byte(c, OP_LOAD_LOCAL);
+    emit_byte(c, (uint8_t)slot);
+    return;
+  }
+
+  KronosValue *name = value_new_string(var_name, strlen(var_name));
+  emit_constant_instruction(c, OP_LOAD_VAR, name);
 }
 
 /**
@@ -779,11 +1394,10 @@ static void compile_range_expression(Compiler *c, const ASTNode *node) {
     KronosValue *one = value_new_number(1.0);
     size_t step_idx = add_constant(c, one);
     // add_constant() always takes ownership
-    if (step_idx == SIZE_MAX || step_idx > UINT16_MAX) {
+    if (step_idx == SIZE_MAX) {
       return;
     }
-    emit_byte(c, OP_LOAD_CONST);
-    emit_uint16(c, (uint16_t)step_idx);
+    emit_constant_op(c, OP_LOAD_CONST, step_idx);
     if (compiler_has_error(c)) {
       return;
     }
@@ -846,7 +1460,9 @@ static void compile_index_expression(Compiler *c, const ASTNode *node) {
   if (compiler_has_error(c)) {
     return;
   }
-  emit_byte(c, OP_LIST_GET);
+  bool is_list = infer_expr_type(node->as.index.list_expr, compiler_var_type,
+                                 c) == TYPE_LIST;
+  emit_byte(c, is_list ? OP_INDEX_LIST : OP_LIST_GET);
 }
 
 /**
@@ -874,11 +1490,10 @@ static void compile_slice_expression(Compiler *c, const ASTNode *node) {
     KronosValue *end_marker = value_new_number(-1);
     size_t end_idx = add_constant(c, end_marker);
     // add_constant() always takes ownership
-    if (end_idx == SIZE_MAX || end_idx > UINT16_MAX) {
+    if (end_idx == SIZE_MAX) {
       return;
     }
-    emit_byte(c, OP_LOAD_CONST);
-    emit_uint16(c, (uint16_t)end_idx);
+    emit_constant_op(c, OP_LOAD_CONST, end_idx);
     if (compiler_has_error(c)) {
       return;
     }
@@ -935,14 +1550,7 @@ static void compile_fstring_expression(Compiler *c, const ASTNode *node) {
     if (to_string_idx == SIZE_MAX) {
       return;
     }
-    emit_byte(c, OP_CALL_FUNC);
-    if (compiler_has_error(c)) {
-      return;
-    }
-    emit_uint16(c, (uint16_t)to_string_idx);
-    if (compiler_has_error(c)) {
-      return;
-    }
+    emit_constant_op(c, OP_CALL_FUNC, to_string_idx);
     emit_byte(c, 1); // 1 argument
     if (compiler_has_error(c)) {
       return;
@@ -976,8 +1584,7 @@ static void compile_fstring_expression(Compiler *c, const ASTNode *node) {
       if (to_string_idx == SIZE_MAX) {
         return;
       }
-      emit_byte(c, OP_CALL_FUNC);
-      emit_uint16(c, (uint16_t)to_string_idx);
+      emit_constant_op(c, OP_CALL_FUNC, to_string_idx);
       emit_byte(c, 1); // 1 argument
       if (compiler_has_error(c)) {
         return;
@@ -992,10 +1599,153 @@ static void compile_fstring_expression(Compiler *c, const ASTNode *node) {
 }
 
 /**
- * @brief Compile a function call expression
+ * @brief Function a call may be inlined to, or NULL
+ *
+ * Only calls inside a function body are inlined (at top level the hidden
+ * storage would be globals, which cost as much as the call). The callee
+ * must be defined (compiled) before the call, take as many arguments as
+ * the call passes, and only read globals that are not locals of @p scope:
+ * OP_LOAD_VAR looks a name up in the current frame first.
  */
-static void compile_call_expression(Compiler *c, const ASTNode *node) {
-  // Compile function call as expression
+static InlineCandidate *inline_callee(const Compiler *c,
+                                      const FunctionScope *scope,
+                                      const ASTNode *call) {
+  if (!scope) {
+    return NULL;
+  }
+  InlineCandidate *callee = inline_table_find(c->inlines, call->as.call.name);
+  if (!callee || !callee->defined ||
+      call->as.call.arg_count != callee->function->as.function.param_count) {
+    return NULL;
+  }
+  for (size_t i = 0; i < callee->global_count; i++) {
+    if (scope_resolve(scope, callee->globals[i]) >= 0) {
+      return NULL;
+    }
+  }
+  return callee;
+}
+
+/**
+ * @brief Function @p call is inlined to, or NULL if it compiles to a call
+ *
+ * The callee's hidden slots must have been reserved before the slot table
+ * was emitted (see reserve_inline_slots()).
+ */
+static const InlineCandidate *inlined_callee(const Compiler *c,
+                                             const ASTNode *call) {
+  const InlineCandidate *callee = inline_callee(c, c->scope, call);
+  for (size_t i = 0; callee && i < callee->local_count; i++) {
+    if (scope_resolve(c->scope, callee->hidden[i]) < 0) {
+      return NULL;
+    }
+  }
+  return callee;
+}
+
+/**
+ * @brief Whether an argument can be read in place of its parameter
+ *
+ * Its value must be the same at every read and reading it must not fail:
+ * a literal, a parameter of the caller or the proven counter of an
+ * enclosing range loop (the inlined body only writes hidden slots). An
+ * argument the optimizer plan rewrites (e.g. to a copy whose store it
+ * dropped) is compiled as planned instead.
+ */
+static bool is_substitutable_argument(Compiler *c, const ASTNode *arg) {
+  if (ir_plan_lookup(c->plan, arg)) {
+    return false;
+  }
+  switch (arg->type) {
+  case AST_NUMBER:
+  case AST_STRING:
+  case AST_BOOL:
+  case AST_NULL:
+    return true;
+  case AST_VAR: {
+    int slot = scope_resolve(c->scope, arg->as.var_name);
+    return slot >= 0 && ((size_t)slot < c->scope->param_count ||
+                         compiler_var_type(arg->as.var_name, c) !=
+                             TYPE_UNKNOWN);
+  }
+  default:
+    return false;
+  }
+}
+
+/**
+ * @brief Compile a call as the body of the function it calls
+ *
+ * Layout:
+ *   args  STORE_LOCAL param_n ... STORE_LOCAL param_1  <statements>
+ *   <return value>
+ *
+ * Leaves the return value (nil without a return statement) on the stack,
+ * like OP_CALL_FUNC. Parameters the body never assigns read substitutable
+ * arguments in place instead of being stored. The body is compiled without
+ * the caller's optimizer plan, which describes the caller's variables.
+ * Hidden slots keep their last values until the caller returns.
+ */
+static void compile_inline_call(Compiler *c, const ASTNode *node,
+                                const InlineCandidate *callee) {
+  const ASTNode *function = callee->function;
+  size_t param_count = function->as.function.param_count;
+  const ASTNode **args = calloc(param_count + 1, sizeof(ASTNode *));
+  if (!args) {
+    compiler_set_error(c, "Failed to allocate inlined call arguments");
+    return;
+  }
+  for (size_t i = 0; i < param_count; i++) {
+    const ASTNode *arg = node->as.call.args[i];
+    if (is_substitutable_argument(c, arg) &&
+        !infer_block_assigns(function->as.function.block,
+                             function->as.function.block_size,
+                             function->as.function.params[i])) {
+      args[i] = arg;
+      continue;
+    }
+    compile_expression(c, arg);
+    if (compiler_has_error(c)) {
+      free(args);
+      return;
+    }
+  }
+  for (size_t i = param_count; i > 0; i--) {
+    if (!args[i - 1]) {
+      emit_byte(c, OP_STORE_LOCAL);
+      emit_byte(c, (uint8_t)scope_resolve(c->scope, callee->hidden[i - 1]));
+    }
+  }
+
+  ASTNode *const *block = function->as.function.block;
+  size_t block_size = function->as.function.block_size;
+  const ASTNode *result = NULL;
+  if (block_size > 0 && block[block_size - 1]->type == AST_RETURN) {
+    result = block[--block_size]->as.return_stmt.value;
+  }
+
+  IRPlan *plan = c->plan;
+  c->inlining = callee;
+  c->inline_args = args;
+  c->plan = NULL;
+  for (size_t i = 0; i < block_size && !compiler_has_error(c); i++) {
+    compile_statement(c, block[i]);
+  }
+  if (result) {
+    compile_expression(c, result);
+  } else {
+    emit_constant(c, value_new_nil());
+  }
+  c->inlining = NULL;
+  c->inline_args = NULL;
+  c->plan = plan;
+  free(args);
+}
+
+/**
+ * @brief Compile a call as OP_CALL_FUNC or OP_TAIL_CALL
+ */
+static void compile_call(Compiler *c, const ASTNode *node, OpCode opcode) {
   // Push arguments onto stack (in order)
   for (size_t i = 0; i < node->as.call.arg_count; i++) {
     compile_expression(c, node->as.call.args[i]);
@@ -1007,8 +1757,7 @@ static void compile_call_expression(Compiler *c, const ASTNode *node) {
   // Emit call instruction
   KronosValue *func_name =
       value_new_string(node->as.call.name, strlen(node->as.call.name));
-  emit_byte(c, OP_CALL_FUNC);
-  if (!emit_constant_index(c, func_name)) {
+  if (!emit_constant_instruction(c, opcode, func_name)) {
     return;
   }
   // Validate argument count limit (uint8_t max is 255)
@@ -1022,6 +1771,18 @@ static void compile_call_expression(Compiler *c, const ASTNode *node) {
   }
 }
 
+/**
+ * @brief Compile a function call expression
+ */
+static void compile_call_expression(Compiler *c, const ASTNode *node) {
+  const InlineCandidate *callee = inlined_callee(c, node);
+  if (callee) {
+    compile_inline_call(c, node, callee);
+    return;
+  }
+  compile_call(c, node, OP_CALL_FUNC);
+}
+
 /**
  * @brief Compile a binary operator expression
  */
@@ -1073,7 +1834,7 @@ static void compile_binop_expression(Compiler *c, const ASTNode *node) {
       snprintf(warn_buf, sizeof(warn_buf),
                "%s by zero detected - this will always fail at runtime",
                op_name);
-      compiler_warn(warn_buf);
+      compiler_warn(c, warn_buf);
     }
   }
 
@@ -1088,6 +1849,13 @@ static void compile_binop_expression(Compiler *c, const ASTNode *node) {
   }
 
   // Emit operator (arithmetic, comparison, or logical)
+  uint8_t typed_op = typed_binop_opcode(c, node->as.binop.op,
+                                        node->as.binop.left,
+                                        node->as.binop.right);
+  if (typed_op) {
+    emit_byte(c, typed_op);
+    return;
+  }
   switch (node->as.binop.op) {
   case BINOP_ADD:
     emit_byte(c, OP_ADD);
@@ -1144,7 +1912,9 @@ static void compile_binop_expression(Compiler *c, const ASTNode *node) {
  * @brief Compile an expression AST node to bytecode
  *
  * Recursively compiles expressions, emitting instructions that leave
- * the result on the VM stack.
+ * the result on the VM stack. Inside a function body, the SSA optimizer's
+ * plan may replace the expression by a load of a temp or of another local
+ * holding the same value, or keep a copy of its value in a temp.
  *
  * @param c Compiler state
  * @param node Expression AST node to compile (not modified)
@@ -1154,6 +1924,38 @@ static void compile_expression(Compiler *c, const ASTNode *node) {
     return;
   }
 
+  const IRAction *action = ir_plan_lookup(c->plan, node);
+  if (!action) {
+    compile_expression_node(c, node);
+    return;
+  }
+  switch (action->kind) {
+  case IR_ACTION_LOAD_TEMP:
+  case IR_ACTION_LOAD_LOCAL:
+    emit_byte(c, OP_LOAD_LOCAL);
+    emit_byte(c, (uint8_t)action->slot);
+    break;
+  case IR_ACTION_SAVE_TEMP:
+    compile_expression_node(c, node);
+    emit_byte(c, OP_STORE_LOCAL);
+    emit_byte(c, (uint8_t)action->slot);
+    emit_byte(c, OP_LOAD_LOCAL);
+    emit_byte(c, (uint8_t)action->slot);
+    break;
+  default:
+    compile_expression_node(c, node);
+    break;
+  }
+}
+
+/**
+ * @brief Compile an expression as written (no optimizer plan lookup)
+ */
+static void compile_expression_node(Compiler *c, const ASTNode *node) {
+  if (!node || compiler_has_error(c)) {
+    return;
+  }
+
   switch (node->type) {
   case AST_NUMBER:
     compile_number_expression(c, node);
@@ -1180,6 +1982,13 @@ static void compile_expression(Compiler *c, const ASTNode *node) {
     break;
 
   case AST_BINOP:
+    if (c->optimize) {
+      KronosValue *folded = fold_constant(node);
+      if (folded) {
+        emit_constant(c, folded);
+        break;
+      }
+    }
     compile_binop_expression(c, node);
     break;
 
@@ -1214,72 +2023,217 @@ static void compile_expression(Compiler *c, const ASTNode *node) {
 }
 
 /**
- * @brief Compile an assignment statement
+ * @brief Map a comparison operator to its opcode
+ *
+ * @return Comparison opcode, or 0 if @p op is not a comparison
  */
-static void compile_assign_statement(Compiler *c, const ASTNode *node) {
-  // Compile value expression
-  compile_expression(c, node->as.assign.value);
-  if (compiler_has_error(c)) {
-    return;
+static uint8_t comparison_opcode(BinOp op) {
+  switch (op) {
+  case BINOP_EQ:
+    return OP_EQ;
+  case BINOP_NEQ:
+    return OP_NEQ;
+  case BINOP_GT:
+    return OP_GT;
+  case BINOP_LT:
+    return OP_LT;
+  case BINOP_GTE:
+    return OP_GTE;
+  case BINOP_LTE:
+    return OP_LTE;
+  default:
+    return 0;
   }
+}
 
-  // Store in variable
-  KronosValue *name =
-      value_new_string(node->as.assign.name, strlen(node->as.assign.name));
-  emit_byte(c, OP_STORE_VAR);
-  if (!emit_constant_index(c, name)) {
-    return;
-  }
-  if (compiler_has_error(c)) {
-    return;
-  }
+/**
+ * @brief Compile a branch condition followed by its jump-if-false
+ *
+ * A comparison condition is fused into OP_CMP_JUMP_IF_FALSE (the boolean is
+ * never materialized), or OP_CMP_JUMP_IF_FALSE_NUM for an ordered comparison
+ * of provable numbers; anything else compiles to the expression and
+ * OP_JUMP_IF_FALSE. Both encodings end in the 16-bit offset, so callers
+ * patch the returned position the same way.
+ *
+ * @return Position of the offset bytes (for later patching)
+ */
+static size_t compile_condition_jump(Compiler *c, const ASTNode *condition) {
+  uint8_t cmp_op = 0;
+  if (condition && condition->type == AST_BINOP && condition->as.binop.right) {
+    cmp_op = comparison_opcode(condition->as.binop.op);
+  }
+  if (cmp_op == 0) {
+    compile_expression(c, condition);
+    return emit_jump_with_offset(c, OP_JUMP_IF_FALSE);
+  }
+
+  bool is_number = typed_binop_opcode(c, condition->as.binop.op,
+                                      condition->as.binop.left,
+                                      condition->as.binop.right) != 0;
+  compile_expression(c, condition->as.binop.left);
+  compile_expression(c, condition->as.binop.right);
+  emit_jump_opcode(
+      c, is_number ? OP_CMP_JUMP_IF_FALSE_NUM : OP_CMP_JUMP_IF_FALSE, true);
+  emit_byte(c, cmp_op);
+  return emit_jump_operand(c);
+}
+
+/**
+ * @brief Whether an assignment is `name to name + <number literal>`
+ *
+ * Such assignments compile to a single increment superinstruction.
+ */
+static bool is_constant_increment(const ASTNode *node) {
+  const ASTNode *value = node->as.assign.value;
+  return value && value->type == AST_BINOP &&
+         value->as.binop.op == BINOP_ADD && value->as.binop.left &&
+         value->as.binop.left->type == AST_VAR &&
+         strcmp(value->as.binop.left->as.var_name, node->as.assign.name) ==
+             0 &&
+         value->as.binop.right && value->as.binop.right->type == AST_NUMBER;
+}
+
+/**
+ * @brief Add the declared type name of an assignment, if any, as a constant
+ *
+ * @param type_idx Set to the constant index, or SIZE_MAX if untyped
+ * @return false on error
+ */
+static bool add_store_type(Compiler *c, const ASTNode *node,
+                           size_t *type_idx) {
+  *type_idx = SIZE_MAX;
+  if (!node->as.assign.type_name) {
+    return true;
+  }
+  KronosValue *type_val = value_new_string(node->as.assign.type_name,
+                                           strlen(node->as.assign.type_name));
+  *type_idx = add_constant(c, type_val);
+  return *type_idx != SIZE_MAX;
+}
 
+/**
+ * @brief Emit the mutability and type operands of a named store
+ *
+ * Shared by OP_STORE_VAR and OP_INC_VAR_CONST:
+ * [is_mutable:1][has_type:1][type_idx:2/4 if has_type]
+ *
+ * @param type_idx From add_store_type()
+ * @param wide The instruction is prefixed with OP_WIDE
+ */
+static void emit_store_declaration(Compiler *c, const ASTNode *node,
+                                   size_t type_idx, bool wide) {
   // Emit mutability flag (1 byte: 1 for mutable, 0 for immutable)
   emit_byte(c, node->as.assign.is_mutable ? 1 : 0);
-  if (compiler_has_error(c)) {
-    return;
-  }
-
-  // Emit type name if specified
-  if (node->as.assign.type_name) {
+  if (type_idx != SIZE_MAX) {
     emit_byte(c, 1);
-    KronosValue *type_val = value_new_string(node->as.assign.type_name,
-                                             strlen(node->as.assign.type_name));
-    if (!emit_constant_index(c, type_val)) {
-      return;
-    }
+    emit_operand(c, (uint32_t)type_idx, wide);
   } else {
     emit_byte(c, 0); // no type specified
   }
-  if (compiler_has_error(c)) {
-    return;
-  }
 }
 
 /**
- * @brief Compile an indexed assignment statement
+ * @brief Compile `name to name + <number literal>` as one instruction
+ *
+ * Emits OP_INC_LOCAL_CONST for function locals and OP_INC_VAR_CONST
+ * (followed by the STORE_VAR declaration operands) for globals.
  */
-static void compile_assign_index_statement(Compiler *c, const ASTNode *node) {
-  // Compile target (variable)
-  compile_expression(c, node->as.assign_index.target);
-  if (compiler_has_error(c)) {
+static void compile_increment_statement(Compiler *c, const ASTNode *node,
+                                        int slot, const char *var_name) {
+  double step = node->as.assign.value->as.binop.right->as.number;
+  size_t step_idx = add_constant(c, value_new_number(step));
+  if (step_idx == SIZE_MAX) {
     return;
   }
-
-  // Compile index expression
-  compile_expression(c, node->as.assign_index.index);
-  if (compiler_has_error(c)) {
+  if (slot >= 0) {
+    bool wide = constant_is_wide(step_idx);
+    emit_opcode(c, OP_INC_LOCAL_CONST, wide);
+    emit_byte(c, (uint8_t)slot);
+    emit_operand(c, (uint32_t)step_idx, wide);
     return;
   }
 
-  // Compile value expression
-  compile_expression(c, node->as.assign_index.value);
-  if (compiler_has_error(c)) {
+  size_t name_idx =
+      add_constant(c, value_new_string(var_name, strlen(var_name)));
+  size_t type_idx;
+  if (name_idx == SIZE_MAX || !add_store_type(c, node, &type_idx)) {
     return;
   }
+  bool wide = constant_is_wide(name_idx) || constant_is_wide(step_idx) ||
+              (type_idx != SIZE_MAX && constant_is_wide(type_idx));
+  emit_opcode(c, OP_INC_VAR_CONST, wide);
+  emit_operand(c, (uint32_t)name_idx, wide);
+  emit_operand(c, (uint32_t)step_idx, wide);
+  emit_store_declaration(c, node, type_idx, wide);
+}
 
-  // Emit OP_LIST_SET instruction
-  emit_byte(c, OP_LIST_SET);
+/**
+ * @brief Compile an assignment statement
+ */
+static void compile_assign_statement(Compiler *c, const ASTNode *node) {
+  // Inside a function the variable lives in a frame slot; its mutability and
+  // type are part of the function's slot descriptor table
+  const char *var_name = node->as.assign.name;
+  int slot = resolve_variable(c, &var_name);
+  const IRAction *action = ir_plan_lookup(c->plan, node);
+  if (action && action->kind == IR_ACTION_DROP_STORE) {
+    return; // Dead store of a value that cannot fail
+  }
+  if (is_constant_increment(node)) {
+    compile_increment_statement(c, node, slot, var_name);
+    return;
+  }
+
+  // Compile value expression
+  compile_expression(c, node->as.assign.value);
+  if (compiler_has_error(c)) {
+    return;
+  }
+
+  if (slot >= 0) {
+    emit_byte(c, OP_STORE_LOCAL);
+    emit_byte(c, (uint8_t)slot);
+    return;
+  }
+
+  // Store in variable
+  size_t name_idx =
+      add_constant(c, value_new_string(var_name, strlen(var_name)));
+  size_t type_idx;
+  if (name_idx == SIZE_MAX || !add_store_type(c, node, &type_idx)) {
+    return;
+  }
+  bool wide = constant_is_wide(name_idx) ||
+              (type_idx != SIZE_MAX && constant_is_wide(type_idx));
+  emit_opcode(c, OP_STORE_VAR, wide);
+  emit_operand(c, (uint32_t)name_idx, wide);
+  emit_store_declaration(c, node, type_idx, wide);
+}
+
+/**
+ * @brief Compile an indexed assignment statement
+ */
+static void compile_assign_index_statement(Compiler *c, const ASTNode *node) {
+  // Compile target (variable)
+  compile_expression(c, node->as.assign_index.target);
+  if (compiler_has_error(c)) {
+    return;
+  }
+
+  // Compile index expression
+  compile_expression(c, node->as.assign_index.index);
+  if (compiler_has_error(c)) {
+    return;
+  }
+
+  // Compile value expression
+  compile_expression(c, node->as.assign_index.value);
+  if (compiler_has_error(c)) {
+    return;
+  }
+
+  // Emit OP_LIST_SET instruction
+  emit_byte(c, OP_LIST_SET);
   if (compiler_has_error(c)) {
     return;
   }
@@ -1325,12 +2279,30 @@ static void compile_print_statement(Compiler *c, const ASTNode *node) {
   }
 }
 
+/**
+ * @brief Whether a returned value is a call that may reuse the frame
+ *
+ * Only inside a function body and outside try statements (a handler must
+ * still find this call's frame when the callee raises). Inlined calls and
+ * calls the SSA plan rewrites are compiled as usual.
+ */
+static bool is_tail_call(Compiler *c, const ASTNode *value) {
+  return value && value->type == AST_CALL && c->scope && c->try_depth == 0 &&
+         !inlined_callee(c, value) && !ir_plan_lookup(c->plan, value);
+}
+
 /**
  * @brief Compile a return statement
  */
 static void compile_return_statement(Compiler *c, const ASTNode *node) {
-  // Compile return value
-  compile_expression(c, node->as.return_stmt.value);
+  // Compile return value; `return call f ...` tail calls f, which then
+  // returns straight to this function's caller
+  const ASTNode *value = node->as.return_stmt.value;
+  if (is_tail_call(c, value)) {
+    compile_call(c, value, OP_TAIL_CALL);
+  } else {
+    compile_expression(c, value);
+  }
   if (compiler_has_error(c)) {
     return;
   }
@@ -1384,19 +2356,14 @@ static void compile_raise_statement(Compiler *c, const ASTNode *node) {
     return;
   }
 
-  // Emit OP_THROW with error type constant
-  emit_byte(c, OP_THROW);
-
-  // Error type constant (or 0xFFFF for generic Error)
+  // Emit OP_THROW with error type constant (absent for generic Error)
   if (node->as.raise_stmt.error_type) {
     KronosValue *error_type_val = value_new_string(
         node->as.raise_stmt.error_type, strlen(node->as.raise_stmt.error_type));
-    if (!emit_constant_index(c, error_type_val)) {
-      return;
-    }
+    emit_constant_instruction(c, OP_THROW, error_type_val);
   } else {
-    // Generic Error type
-    emit_uint16(c, 0xFFFF);
+    emit_byte(c, OP_THROW);
+    emit_no_constant(c, false);
   }
 }
 
@@ -1404,6 +2371,14 @@ static void compile_raise_statement(Compiler *c, const ASTNode *node) {
  * @brief Compile a function call statement (discards return value)
  */
 static void compile_call_statement(Compiler *c, const ASTNode *node) {
+  const InlineCandidate *callee = inlined_callee(c, node);
+  if (callee) {
+    // Never a built-in, so the value is discarded
+    compile_inline_call(c, node, callee);
+    emit_byte(c, OP_POP);
+    return;
+  }
+
   // Push arguments onto stack
   for (size_t i = 0; i < node->as.call.arg_count; i++) {
     compile_expression(c, node->as.call.args[i]);
@@ -1415,11 +2390,7 @@ static void compile_call_statement(Compiler *c, const ASTNode *node) {
   // Push function name
   KronosValue *func_name =
       value_new_string(node->as.call.name, strlen(node->as.call.name));
-  emit_byte(c, OP_CALL_FUNC);
-  if (!emit_constant_index(c, func_name)) {
-    return;
-  }
-  if (compiler_has_error(c)) {
+  if (!emit_constant_instruction(c, OP_CALL_FUNC, func_name)) {
     return;
   }
   // Validate argument count limit (uint8_t max is 255)
@@ -1456,16 +2427,14 @@ static void compile_call_statement(Compiler *c, const ASTNode *node) {
 static void compile_import_statement(Compiler *c, const ASTNode *node) {
   // Emit OP_IMPORT instruction with module name and file path as constant
   // indices
-  emit_byte(c, OP_IMPORT);
-
-  // Add module name to constant pool and emit index
   KronosValue *module_name_val = value_new_string(
       node->as.import.module_name, strlen(node->as.import.module_name));
   if (!module_name_val) {
     compiler_set_error(c, "Failed to create module name constant");
     return;
   }
-  if (!emit_constant_index(c, module_name_val)) {
+  size_t module_idx = add_constant(c, module_name_val);
+  if (module_idx == SIZE_MAX) {
     compiler_set_error(c, "Failed to add module name constant");
     return;
   }
@@ -1487,36 +2456,35 @@ static void compile_import_statement(Compiler *c, const ASTNode *node) {
       return;
     }
   }
-  if (!emit_constant_index(c, file_path_val)) {
+  size_t path_idx = add_constant(c, file_path_val);
+  if (path_idx == SIZE_MAX) {
     compiler_set_error(c, "Failed to add file path constant");
     return;
   }
+
+  bool wide = constant_is_wide(module_idx) || constant_is_wide(path_idx);
+  emit_opcode(c, OP_IMPORT, wide);
+  emit_operand(c, (uint32_t)module_idx, wide);
+  emit_operand(c, (uint32_t)path_idx, wide);
 }
 
 /**
- * @brief Compile an if statement (with else-if chains and else)
+ * @brief Compile an if/else-if/else chain as written
  */
-static void compile_if_statement(Compiler *c, const ASTNode *node) {
-  // Compile condition
-  compile_expression(c, node->as.if_stmt.condition);
+static void compile_if_chain(Compiler *c, const ASTNode *node) {
+  // Compile condition and its jump if false (placeholder for jump offset)
+  size_t jump_offset_pos =
+      compile_condition_jump(c, node->as.if_stmt.condition);
   if (compiler_has_error(c)) {
     return;
   }
 
-  // Emit jump if false (placeholder for jump offset)
-  size_t jump_offset_pos = emit_jump_with_offset(c, OP_JUMP_IF_FALSE);
+  // Compile if block
+  compile_block(c, node->as.if_stmt.block, node->as.if_stmt.block_size);
   if (compiler_has_error(c)) {
     return;
   }
 
-  // Compile if block
-  for (size_t i = 0; i < node->as.if_stmt.block_size; i++) {
-    compile_statement(c, node->as.if_stmt.block[i]);
-    if (compiler_has_error(c)) {
-      return;
-    }
-  }
-
   // Collect all jump positions that need to be patched to point to next
   // condition/else/end
   size_t *jump_positions = NULL;
@@ -1548,8 +2516,12 @@ static void compile_if_statement(Compiler *c, const ASTNode *node) {
   // For simple if statements, we don't need a skip jump
   bool has_else_or_else_if = (node->as.if_stmt.else_if_count > 0 ||
                               node->as.if_stmt.else_block_size > 0);
+  // When optimizing, a block that never falls through needs no skip jump
+  bool if_block_falls_through =
+      !c->optimize || !block_terminates(c, node->as.if_stmt.block,
+                                        node->as.if_stmt.block_size);
 
-  if (has_else_or_else_if) {
+  if (has_else_or_else_if && if_block_falls_through) {
     // Emit skip jump at end of if block (will be patched at the end)
     size_t if_skip_jump_pos = emit_jump_with_offset(c, OP_JUMP);
     if (compiler_has_error(c)) {
@@ -1576,70 +2548,62 @@ static void compile_if_statement(Compiler *c, const ASTNode *node) {
     // Patch previous jumps to point to this else-if condition
     size_t else_if_start = c->bytecode->count;
     for (size_t j = 0; j < jump_count; j++) {
-      size_t pos = jump_positions[j];
-      int16_t offset = (int16_t)(else_if_start - (pos + 2));
-      if (offset < INT16_MIN || offset > INT16_MAX) {
-        compiler_set_error(c, "Jump offset too large in if statement");
-        free(jump_positions);
-        free(skip_jumps);
-        return;
-      }
-      patch_jump_offset(c, pos, offset);
+      patch_forward_jump(c, jump_positions[j], else_if_start);
     }
     // Clear jump positions - we'll add new ones for this else-if
     jump_count = 0;
 
-    // Compile else-if condition
-    compile_expression(c, node->as.if_stmt.else_if_conditions[i]);
+    // Compile else-if condition and its jump if false
+    size_t else_if_jump_if_false_pos =
+        compile_condition_jump(c, node->as.if_stmt.else_if_conditions[i]);
     if (compiler_has_error(c)) {
       free(jump_positions);
       free(skip_jumps);
       return;
     }
 
-    // Emit jump if false
-    size_t else_if_jump_if_false_pos =
-        emit_jump_with_offset(c, OP_JUMP_IF_FALSE);
+    // Compile else-if block
+    compile_block(c, node->as.if_stmt.else_if_blocks[i],
+                  node->as.if_stmt.else_if_block_sizes[i]);
     if (compiler_has_error(c)) {
       free(jump_positions);
       free(skip_jumps);
       return;
     }
 
-    // Compile else-if block
-    for (size_t j = 0; j < node->as.if_stmt.else_if_block_sizes[i]; j++) {
-      compile_statement(c, node->as.if_stmt.else_if_blocks[i][j]);
+    // Emit skip jump AFTER the else-if block body (to skip to end when this
+    // branch executes). When optimizing, it is left out if the block never
+    // falls through or no else-if/else follows.
+    bool has_later_branch = i + 1 < node->as.if_stmt.else_if_count ||
+                            node->as.if_stmt.else_block_size > 0;
+    if (!c->optimize ||
+        (has_later_branch &&
+         !block_terminates(c, node->as.if_stmt.else_if_blocks[i],
+                           node->as.if_stmt.else_if_block_sizes[i]))) {
+      size_t else_if_skip_jump_pos = emit_jump_with_offset(c, OP_JUMP);
       if (compiler_has_error(c)) {
         free(jump_positions);
         free(skip_jumps);
         return;
       }
-    }
-
-    // Emit skip jump AFTER the else-if block body (to skip to end when this
-    // branch executes)
-    size_t else_if_skip_jump_pos = emit_jump_with_offset(c, OP_JUMP);
-    if (compiler_has_error(c)) {
-      free(jump_positions);
-      free(skip_jumps);
-      return;
-    }
 
-    // Add skip jump to list (will be patched at the end)
-    if (skip_count >= skip_capacity) {
-      size_t new_capacity =
-          skip_capacity == 0 ? JUMP_ARRAY_INITIAL_CAPACITY : skip_capacity * 2;
-      size_t *new_skips = realloc(skip_jumps, sizeof(size_t) * new_capacity);
-      if (!new_skips) {
-        compiler_set_error(c, "Failed to allocate skip jumps array");
-        free(jump_positions);
-        free(skip_jumps);
-        return;
+      // Add skip jump to list (will be patched at the end)
+      if (skip_count >= skip_capacity) {
+        size_t new_capacity = skip_capacity == 0 ? JUMP_ARRAY_INITIAL_CAPACITY
+                                                 : skip_capacity * 2;
+        size_t *new_skips =
+            realloc(skip_jumps, sizeof(size_t) * new_capacity);
+        if (!new_skips) {
+          compiler_set_error(c, "Failed to allocate skip jumps array");
+          free(jump_positions);
+          free(skip_jumps);
+          return;
+        }
+        skip_jumps = new_skips;
+        skip_capacity = new_capacity;
       }
-      skip_jumps = new_skips;
-      skip_capacity = new_capacity;
+      skip_jumps[skip_count++] = else_if_skip_jump_pos;
     }
-    skip_jumps[skip_count++] = else_if_skip_jump_pos;
 
     // Add jump-if-false to list (should point to next else-if/else/end)
     if (jump_count + 1 > jump_capacity) {
@@ -1668,55 +2632,30 @@ static void compile_if_statement(Compiler *c, const ASTNode *node) {
     // block
     size_t else_start = c->bytecode->count;
     for (size_t j = 0; j < jump_count; j++) {
-      size_t pos = jump_positions[j];
-      int16_t offset = (int16_t)(else_start - (pos + 2));
-      if (offset < INT16_MIN || offset > INT16_MAX) {
-        compiler_set_error(c, "Jump offset too large in if statement");
-        free(jump_positions);
-        free(skip_jumps);
-        return;
-      }
-      patch_jump_offset(c, pos, offset);
+      patch_forward_jump(c, jump_positions[j], else_start);
     }
     jump_count = 0;
 
     // Compile else block
-    for (size_t i = 0; i < node->as.if_stmt.else_block_size; i++) {
-      compile_statement(c, node->as.if_stmt.else_block[i]);
-      if (compiler_has_error(c)) {
-        free(jump_positions);
-        free(skip_jumps);
-        return;
-      }
+    compile_block(c, node->as.if_stmt.else_block,
+                  node->as.if_stmt.else_block_size);
+    if (compiler_has_error(c)) {
+      free(jump_positions);
+      free(skip_jumps);
+      return;
     }
   }
 
   // Patch all skip jumps to point to end
   size_t end_pos = c->bytecode->count;
   for (size_t j = 0; j < skip_count; j++) {
-    size_t pos = skip_jumps[j];
-    int16_t offset = (int16_t)(end_pos - (pos + 2));
-    if (offset < INT16_MIN || offset > INT16_MAX) {
-      compiler_set_error(c, "Jump offset too large in if statement");
-      free(jump_positions);
-      free(skip_jumps);
-      return;
-    }
-    patch_jump_offset(c, pos, offset);
+    patch_jump(c, skip_jumps[j], end_pos);
   }
 
   // If no else block, also patch jump-if-false jumps to end
   if (node->as.if_stmt.else_block_size == 0) {
     for (size_t j = 0; j < jump_count; j++) {
-      size_t pos = jump_positions[j];
-      int16_t offset = (int16_t)(end_pos - (pos + 2));
-      if (offset < INT16_MIN || offset > INT16_MAX) {
-        compiler_set_error(c, "Jump offset too large in if statement");
-        free(jump_positions);
-        free(skip_jumps);
-        return;
-      }
-      patch_jump_offset(c, pos, offset);
+      patch_forward_jump(c, jump_positions[j], end_pos);
     }
   }
 
@@ -1725,441 +2664,329 @@ static void compile_if_statement(Compiler *c, const ASTNode *node) {
 }
 
 /**
- * @brief Compile a for loop statement (range or list iteration)
+ * @brief Fold a branch condition to its truthiness
+ *
+ * @return 1 if always true, 0 if always false, -1 if not a constant (or
+ * not optimizing)
  */
-static void compile_for_statement(Compiler *c, const ASTNode *node) {
-  KronosValue *var_name =
-      value_new_string(node->as.for_stmt.var, strlen(node->as.for_stmt.var));
-  // Get variable index once - it's used multiple times in the loop
-  size_t var_idx = add_constant(c, var_name);
-  // add_constant() always takes ownership
-  if (var_idx == SIZE_MAX) {
-    return;
+static int constant_condition(const Compiler *c, const ASTNode *condition) {
+  if (!c->optimize) {
+    return -1;
   }
-  if (var_idx > UINT16_MAX) {
-    compiler_set_error(c, "Too many constants (limit 65535)");
-    return;
+  KronosValue *value = fold_constant(condition);
+  if (!value) {
+    return -1;
   }
+  int truthy = value_is_truthy(value) ? 1 : 0;
+  value_release(value);
+  return truthy;
+}
 
-  if (node->as.for_stmt.is_range) {
-    // Range iteration: for i in range start to end [by step]
-    // Initialize loop variable
-    compile_expression(c, node->as.for_stmt.iterable);
-    if (compiler_has_error(c)) {
-      return;
-    }
-    emit_byte(c, OP_STORE_VAR);
-    emit_uint16(c, (uint16_t)var_idx);
-    emit_byte(c, 1); // for loop variables default mutable
-    emit_byte(c, 0); // no type annotation
-    if (compiler_has_error(c)) {
-      return;
-    }
-
-    // Loop start
-    size_t loop_start = c->bytecode->count;
+/**
+ * @brief Compile an if statement (with else-if chains and else)
+ *
+ * When optimizing, branches with a constant false condition are dropped, and
+ * a constant true condition turns its block into the final else (the
+ * branches after it are dropped). Dropped blocks are still compiled as dead
+ * code; the remaining chain is compiled from a pruned copy of the node.
+ */
+static void compile_if_statement(Compiler *c, const ASTNode *node) {
+  size_t branch_count = 1 + node->as.if_stmt.else_if_count;
+  bool has_constant = false;
+  for (size_t i = 0; i < branch_count && !has_constant; i++) {
+    const ASTNode *condition =
+        i == 0 ? node->as.if_stmt.condition
+               : node->as.if_stmt.else_if_conditions[i - 1];
+    has_constant = constant_condition(c, condition) >= 0;
+  }
+  if (!has_constant) {
+    compile_if_chain(c, node);
+    return;
+  }
 
-    // Load loop variable and end value
-    emit_byte(c, OP_LOAD_VAR);
-    emit_uint16(c, (uint16_t)var_idx);
-    if (compiler_has_error(c)) {
-      return;
-    }
-    compile_expression(c, node->as.for_stmt.end);
-    if (compiler_has_error(c)) {
-      return;
-    }
+  ASTNode **conditions = malloc(sizeof(ASTNode *) * branch_count);
+  ASTNode ***blocks = malloc(sizeof(ASTNode **) * branch_count);
+  size_t *block_sizes = malloc(sizeof(size_t) * branch_count);
+  if (!conditions || !blocks || !block_sizes) {
+    free(conditions);
+    free(blocks);
+    free(block_sizes);
+    compiler_set_error(c, "Failed to allocate if statement branches");
+    return;
+  }
 
-    // Determine step value (default to 1 if not specified)
-    // If step is NULL, we'll use 1
-    bool has_step = (node->as.for_stmt.step != NULL);
+  size_t live_count = 0;
+  ASTNode **else_block = node->as.if_stmt.else_block;
+  size_t else_block_size = node->as.if_stmt.else_block_size;
+  bool always_taken = false; // A constant true branch ends the chain
+  for (size_t i = 0; i < branch_count && !compiler_has_error(c); i++) {
+    ASTNode *condition = i == 0 ? node->as.if_stmt.condition
+                                : node->as.if_stmt.else_if_conditions[i - 1];
+    ASTNode **block = i == 0 ? node->as.if_stmt.block
+                             : node->as.if_stmt.else_if_blocks[i - 1];
+    size_t block_size = i == 0 ? node->as.if_stmt.block_size
+                               : node->as.if_stmt.else_if_block_sizes[i - 1];
+    if (always_taken) {
+      compile_dead_block(c, block, block_size);
+      continue;
+    }
+    int truth = constant_condition(c, condition);
+    if (truth < 0) {
+      conditions[live_count] = condition;
+      blocks[live_count] = block;
+      block_sizes[live_count] = block_size;
+      live_count++;
+    } else if (truth == 0) {
+      compile_dead_block(c, block, block_size);
+    } else {
+      always_taken = true;
+      else_block = block;
+      else_block_size = block_size;
+    }
+  }
+  if (always_taken) {
+    compile_dead_block(c, node->as.if_stmt.else_block,
+                       node->as.if_stmt.else_block_size);
+  }
+
+  if (!compiler_has_error(c) && live_count == 0) {
+    compile_block(c, else_block, else_block_size);
+  } else if (!compiler_has_error(c)) {
+    ASTNode pruned = *node;
+    pruned.as.if_stmt.condition = conditions[0];
+    pruned.as.if_stmt.block = blocks[0];
+    pruned.as.if_stmt.block_size = block_sizes[0];
+    pruned.as.if_stmt.else_if_conditions = conditions + 1;
+    pruned.as.if_stmt.else_if_blocks = blocks + 1;
+    pruned.as.if_stmt.else_if_block_sizes = block_sizes + 1;
+    pruned.as.if_stmt.else_if_count = live_count - 1;
+    pruned.as.if_stmt.else_block = else_block;
+    pruned.as.if_stmt.else_block_size = else_block_size;
+    compile_if_chain(c, &pruned);
+  }
+
+  free(conditions);
+  free(blocks);
+  free(block_sizes);
+}
 
-    // For comparison, we need to check direction based on step
-    // If step > 0: check var <= end
-    // If step < 0: check var >= end
-    bool use_gte = false; // Default to LTE for positive steps
-    bool step_is_constant = false;
+/**
+ * @brief Evaluate the loop-invariant expressions the optimizer moved ahead
+ * of @p loop into their temps
+ */
+static void compile_hoisted_expressions(Compiler *c, const ASTNode *loop) {
+  const IRAction *action = ir_plan_lookup(c->plan, loop);
+  if (!action || action->kind != IR_ACTION_HOIST) {
+    return;
+  }
+  for (size_t i = 0; i < action->hoisted_count && !compiler_has_error(c);
+       i++) {
+    compile_expression_node(c, action->hoisted[i].node);
+    emit_byte(c, OP_STORE_LOCAL);
+    emit_byte(c, (uint8_t)action->hoisted[i].slot);
+  }
+}
 
-    if (has_step && node->as.for_stmt.step->type == AST_NUMBER) {
-      // Step is a constant - check if it's negative at compile time
-      step_is_constant = true;
-      if (node->as.for_stmt.step->as.number < 0.0) {
-        use_gte = true; // Use >= for negative steps
-      }
-    }
+/**
+ * @brief Compile a numeric range loop to OP_FOR_RANGE_PREP/OP_FOR_RANGE_NEXT
+ *
+ * Layout:
+ *   start end step  FOR_RANGE_PREP depth, exit
+ *   body:           STORE var, <block>
+ *   continue:       FOR_RANGE_NEXT depth, body
+ *   exit:           STORE var
+ *   break:          ...
+ *
+ * Every range loop compiles this way, at any nesting depth. The counter,
+ * bound and step live unboxed in the frame's range loop slot for this
+ * nesting depth; bound and step are evaluated once. Both PREP and
+ * NEXT push the counter, so the variable ends up holding the first value
+ * past the bound (or the start of an empty range), as with the generic
+ * lowering. Assigning to the loop variable in the body does not change the
+ * number of iterations. PREP fails unless start, bound and step are numbers,
+ * so a body that never rebinds the variable sees it as a proven number.
+ */
+static void compile_fused_range_loop(Compiler *c, const ASTNode *node,
+                                     int var_slot, size_t var_idx) {
+  if (c->range_depth >= RANGE_LOOP_DEPTH_MAX) {
+    char error_buf[128];
+    snprintf(error_buf, sizeof(error_buf),
+             "Range loops nested too deeply (limit %d)", RANGE_LOOP_DEPTH_MAX);
+    compiler_set_error(c, error_buf);
+    return;
+  }
+  compile_expression(c, node->as.for_stmt.iterable);
+  if (compiler_has_error(c)) {
+    return;
+  }
+  compile_expression(c, node->as.for_stmt.end);
+  if (compiler_has_error(c)) {
+    return;
+  }
+  if (node->as.for_stmt.step) {
+    compile_expression(c, node->as.for_stmt.step);
+  } else {
+    emit_constant(c, value_new_number(1));
+  }
+  if (compiler_has_error(c)) {
+    return;
+  }
 
-    // For non-constant steps, check step sign at runtime
-    if (has_step && !step_is_constant) {
-      // Evaluate step expression to check its sign
-      compile_expression(c, node->as.for_stmt.step);
-      if (compiler_has_error(c)) {
-        return;
-      }
+  uint8_t depth = (uint8_t)c->range_depth;
+  emit_jump_opcode(c, OP_FOR_RANGE_PREP, false);
+  emit_byte(c, depth);
+  // Patched once the exit store is placed
+  size_t exit_jump_pos = emit_jump_operand(c);
+  if (compiler_has_error(c)) {
+    return;
+  }
 
-      // Compare step to 0: step < 0
-      // Stack before: [var, end, step]
-      KronosValue *zero = value_new_number(0);
-      emit_constant(c, zero);
-      if (compiler_has_error(c)) {
-        return;
-      }
-      // Stack: [var, end, step, 0]
-      emit_byte(c, OP_LT); // Compares step < 0, pops step and 0, pushes bool
-      // Stack: [var, end, (step < 0)]
-      if (compiler_has_error(c)) {
-        return;
-      }
+  size_t body_start = c->bytecode->count;
+  emit_store_variable(c, var_slot, var_idx); // mutable, untyped
+  if (compiler_has_error(c) || !push_loop(c, body_start)) {
+    return;
+  }
 
-      // Logic: if step < 0 is TRUE, use OP_GTE; if FALSE (step >= 0), use
-      // OP_LTE OP_JUMP_IF_FALSE jumps if the value is false, so:
-      // - If step < 0 is FALSE (step >= 0): jump to LTE path
-      // - If step < 0 is TRUE (step < 0): continue to GTE path
-      size_t jump_to_lte_pos = emit_jump_with_offset(c, OP_JUMP_IF_FALSE);
-      if (compiler_has_error(c)) {
-        return;
-      }
+  TypedVar counter = {node->as.for_stmt.var, TYPE_NUMBER, c->typed_vars};
+  bool typed = !infer_block_assigns(node->as.for_stmt.block,
+                                    node->as.for_stmt.block_size,
+                                    node->as.for_stmt.var);
+  if (typed) {
+    c->typed_vars = &counter;
+  }
+  c->range_depth++;
+  compile_block(c, node->as.for_stmt.block, node->as.for_stmt.block_size);
+  c->range_depth--;
+  c->typed_vars = counter.next;
+  if (compiler_has_error(c)) {
+    pop_loop(c);
+    return;
+  }
 
-      // Step < 0 path: use OP_GTE
-      // Stack: [var, end] (OP_JUMP_IF_FALSE popped the boolean)
-      emit_byte(c, OP_GTE);
-      if (compiler_has_error(c)) {
-        return;
-      }
-      // Stack: [var >= end]
-      size_t jump_after_comparison_pos = emit_jump_with_offset(c, OP_JUMP);
-      if (compiler_has_error(c)) {
-        return;
-      }
+  c->loop_stack->loop_continue = c->bytecode->count;
+  emit_jump_opcode(c, OP_FOR_RANGE_NEXT, false);
+  emit_byte(c, depth);
+  size_t back_jump_pos = emit_jump_operand(c);
+  patch_jump(c, back_jump_pos, body_start);
+  patch_forward_jump(c, exit_jump_pos, c->bytecode->count);
+  emit_store_variable(c, var_slot, var_idx);
+  if (compiler_has_error(c)) {
+    pop_loop(c);
+    return;
+  }
 
-      // Patch jump to LTE path
-      size_t lte_path_start = c->bytecode->count;
-      int16_t lte_offset = (int16_t)(lte_path_start - (jump_to_lte_pos + 2));
-      if (lte_offset < INT16_MIN || lte_offset > INT16_MAX) {
-        compiler_set_error(c, "Jump offset too large in for loop step check");
-        return;
-      }
-      patch_jump_offset(c, jump_to_lte_pos, lte_offset);
+  c->loop_stack->loop_end = c->bytecode->count;
+  patch_pending_jumps(c);
+  pop_loop(c);
+}
 
-      // Step >= 0 path: use OP_LTE
-      // Stack: [var, end] (OP_JUMP_IF_FALSE popped the boolean)
-      emit_byte(c, OP_LTE);
-      if (compiler_has_error(c)) {
-        return;
-      }
-      // Stack: [var <= end]
-
-      // Patch jump after comparison
-      size_t after_comparison = c->bytecode->count;
-      int16_t after_offset =
-          (int16_t)(after_comparison - (jump_after_comparison_pos + 2));
-      if (after_offset < INT16_MIN || after_offset > INT16_MAX) {
-        compiler_set_error(c, "Jump offset too large in for loop comparison");
-        return;
-      }
-      patch_jump_offset(c, jump_after_comparison_pos, after_offset);
-    } else {
-      // Constant step or no step: use compile-time decision
-      if (use_gte) {
-        emit_byte(c, OP_GTE);
-      } else {
-        emit_byte(c, OP_LTE);
-      }
-    }
-    if (compiler_has_error(c)) {
+/**
+ * @brief Compile a for-in loop to OP_ITER_PREP/OP_ITER_NEXT/OP_ITER_CLOSE
+ *
+ * Layout:
+ *   iterable        ITER_PREP depth, pairs, exit
+ *   body:           [STORE value_var] STORE var, <block>
+ *   continue:       ITER_NEXT depth, body
+ *   exit, break:    ITER_CLOSE depth
+ *
+ * The iterator (container + cursor) lives in the frame's iterator slot for
+ * this nesting depth, so nothing is kept on the value stack across the body.
+ * PREP and NEXT push the next item (key then value for map pairs) only when
+ * they branch into the body; ITER_CLOSE drops the container.
+ */
+static void compile_iterator_loop(Compiler *c, const ASTNode *node,
+                                  int var_slot, size_t var_idx) {
+  if (c->iter_depth >= ITER_LOOP_DEPTH_MAX) {
+    char error_buf[128];
+    snprintf(error_buf, sizeof(error_buf),
+             "For loops nested too deeply (limit %d)", ITER_LOOP_DEPTH_MAX);
+    compiler_set_error(c, error_buf);
+    return;
+  }
+  const char *value_var = node->as.for_stmt.value_var;
+  size_t value_idx = 0;
+  int value_slot = -1;
+  if (value_var) {
+    value_idx = add_constant(c, value_new_string(value_var, strlen(value_var)));
+    if (value_idx == SIZE_MAX) {
       return;
     }
+    value_slot = scope_resolve(c->scope, value_var);
+  }
 
-    // Jump if false (exit loop)
-    size_t exit_jump_pos = emit_jump_with_offset(c, OP_JUMP_IF_FALSE);
-    if (compiler_has_error(c)) {
-      return;
-    }
+  compile_expression(c, node->as.for_stmt.iterable);
+  if (compiler_has_error(c)) {
+    return;
+  }
+  uint8_t depth = (uint8_t)c->iter_depth;
+  emit_jump_opcode(c, OP_ITER_PREP, false);
+  emit_byte(c, depth);
+  emit_byte(c, value_var ? 1 : 0);
+  size_t exit_jump_pos = emit_jump_operand(c); // Patched at ITER_CLOSE
+  if (compiler_has_error(c)) {
+    return;
+  }
 
-    // Push loop info for break/continue
-    if (!push_loop(c, loop_start)) {
-      return;
-    }
-
-    // Compile loop body
-    for (size_t i = 0; i < node->as.for_stmt.block_size; i++) {
-      compile_statement(c, node->as.for_stmt.block[i]);
-      if (compiler_has_error(c)) {
-        pop_loop(c);
-        return;
-      }
-    }
-
-    // Set continue target to here (increment part) for continue statements
-    if (c->loop_stack) {
-      c->loop_stack->loop_continue = c->bytecode->count;
-    }
-
-    // Increment loop variable by step
-    emit_byte(c, OP_LOAD_VAR);
-    emit_uint16(c, (uint16_t)var_idx);
-    if (compiler_has_error(c)) {
-      pop_loop(c);
-      return;
-    }
-
-    if (has_step) {
-      // Use the specified step value
-      compile_expression(c, node->as.for_stmt.step);
-      if (compiler_has_error(c)) {
-        pop_loop(c);
-        return;
-      }
-    } else {
-      // Default step is 1
-      KronosValue *one = value_new_number(1);
-      emit_constant(c, one);
-      if (compiler_has_error(c)) {
-        pop_loop(c);
-        return;
-      }
-    }
-
-    emit_byte(c, OP_ADD);
-    emit_byte(c, OP_STORE_VAR);
-    emit_uint16(c, (uint16_t)var_idx);
-    emit_byte(c, 1);
-    emit_byte(c, 0);
-    if (compiler_has_error(c)) {
-      pop_loop(c);
-      return;
-    }
-
-    // Jump back to loop start
-    size_t jump_back_pos = emit_jump_with_offset(c, OP_JUMP);
-    if (compiler_has_error(c)) {
-      pop_loop(c);
-      return;
-    }
-    int16_t back_offset = (int16_t)(loop_start - (jump_back_pos + 2));
-    if (back_offset < INT16_MIN || back_offset > INT16_MAX) {
-      compiler_set_error(c, "Loop jump offset too large");
-      pop_loop(c);
-      return;
-    }
-    patch_jump_offset(c, jump_back_pos, back_offset);
-
-    // Patch exit jump and update loop end
-    size_t exit_target = c->bytecode->count;
-    int16_t exit_offset = (int16_t)(exit_target - (exit_jump_pos + 2));
-    if (exit_offset < 0 || exit_offset > INT16_MAX) {
-      compiler_set_error(c, "Loop exit jump offset too large");
-      pop_loop(c);
-      return;
-    }
-    patch_jump_offset_unsigned(c, exit_jump_pos, (uint16_t)exit_offset);
-    if (c->loop_stack) {
-      c->loop_stack->loop_end = exit_target;
-      // Patch all pending break/continue jumps
-      patch_pending_jumps(c);
-    }
+  size_t body_start = c->bytecode->count;
+  if (value_var) {
+    emit_store_variable(c, value_slot, value_idx); // value is on top
+  }
+  emit_store_variable(c, var_slot, var_idx);
+  if (compiler_has_error(c) || !push_loop(c, body_start)) {
+    return;
+  }
 
-    // Pop loop info
+  c->iter_depth++;
+  compile_block(c, node->as.for_stmt.block, node->as.for_stmt.block_size);
+  c->iter_depth--;
+  if (compiler_has_error(c)) {
     pop_loop(c);
-  } else {
-    // List iteration: for item in list_expr
-    // Compile list expression
-    compile_expression(c, node->as.for_stmt.iterable);
-    if (compiler_has_error(c)) {
-      return;
-    }
-
-    // Start iteration - pushes [list, index=0] onto stack
-    emit_byte(c, OP_LIST_ITER);
-    if (compiler_has_error(c)) {
-      return;
-    }
-
-    // Store iterator state in hidden variables to preserve across loop body
-    // Create hidden variable names for iterator state
-    // Use loop_counter to ensure uniqueness even for nested loops with same
-    // var name
-    char iter_list_name[64];
-    char iter_index_name[64];
-    snprintf(iter_list_name, sizeof(iter_list_name), "__iter_list_%zu_%zu",
-             var_idx, c->loop_counter);
-    snprintf(iter_index_name, sizeof(iter_index_name), "__iter_index_%zu_%zu",
-             var_idx, c->loop_counter);
-
-    // Stack after OP_LIST_ITER: [list, index] with index on top
-    // Store index first (pops index)
-    KronosValue *iter_index_name_val =
-        value_new_string(iter_index_name, strlen(iter_index_name));
-    size_t iter_index_name_idx = add_constant(c, iter_index_name_val);
-    // add_constant() always takes ownership
-    if (iter_index_name_idx == SIZE_MAX || iter_index_name_idx > UINT16_MAX) {
-      return;
-    }
-    emit_byte(c, OP_STORE_VAR);
-    emit_uint16(c, (uint16_t)iter_index_name_idx);
-    emit_byte(c, 1); // mutable
-    emit_byte(c, 0); // no type annotation
-    if (compiler_has_error(c)) {
-      return;
-    }
-
-    // Now store list (pops list)
-    KronosValue *iter_list_name_val =
-        value_new_string(iter_list_name, strlen(iter_list_name));
-    size_t iter_list_name_idx = add_constant(c, iter_list_name_val);
-    // add_constant() always takes ownership
-    if (iter_list_name_idx == SIZE_MAX || iter_list_name_idx > UINT16_MAX) {
-      return;
-    }
-    emit_byte(c, OP_STORE_VAR);
-    emit_uint16(c, (uint16_t)iter_list_name_idx);
-    emit_byte(c, 1); // mutable
-    emit_byte(c, 0); // no type annotation
-    if (compiler_has_error(c)) {
-      return;
-    }
-
-    // Loop start
-    size_t loop_start = c->bytecode->count;
-
-    // Restore iterator state from variables
-    emit_byte(c, OP_LOAD_VAR);
-    emit_uint16(c, (uint16_t)iter_list_name_idx);
-    if (compiler_has_error(c)) {
-      return;
-    }
-    emit_byte(c, OP_LOAD_VAR);
-    emit_uint16(c, (uint16_t)iter_index_name_idx);
-    if (compiler_has_error(c)) {
-      return;
-    }
-    // Stack: [list, index]
-
-    // Get next item
-    emit_byte(c, OP_LIST_NEXT);
-    if (compiler_has_error(c)) {
-      return;
-    }
-
-    // Stack after OP_LIST_NEXT: [list, index+1, item, has_more]
-    // Check has_more flag (it's on top of stack)
-    // Note: OP_JUMP_IF_FALSE pops the condition, so we don't need OP_POP
-    size_t exit_jump_pos = emit_jump_with_offset(c, OP_JUMP_IF_FALSE);
-    if (compiler_has_error(c)) {
-      return;
-    }
-
-    // Push loop info for break/continue
-    if (!push_loop(c, loop_start)) {
-      return;
-    }
-
-    // Stack now: [list, index+1, item] (OP_JUMP_IF_FALSE already popped
-    // has_more) Store item in loop variable (pops item)
-    emit_byte(c, OP_STORE_VAR);
-    emit_uint16(c, (uint16_t)var_idx);
-    emit_byte(c, 1); // mutable
-    emit_byte(c, 0); // no type annotation
-    if (compiler_has_error(c)) {
-      pop_loop(c);
-      return;
-    }
-
-    // Stack now: [list, index+1] - save iterator state for next iteration
-    // Stack is [list, index+1] with index+1 on top
-    // Store updated index first (pops index+1)
-    emit_byte(c, OP_STORE_VAR);
-    emit_uint16(c, (uint16_t)iter_index_name_idx);
-    emit_byte(c, 1); // mutable
-    emit_byte(c, 0); // no type annotation
-    if (compiler_has_error(c)) {
-      pop_loop(c);
-      return;
-    }
-
-    // Store list (pops list)
-    emit_byte(c, OP_STORE_VAR);
-    emit_uint16(c, (uint16_t)iter_list_name_idx);
-    emit_byte(c, 1); // mutable
-    emit_byte(c, 0); // no type annotation
-    if (compiler_has_error(c)) {
-      pop_loop(c);
-      return;
-    }
-
-    // Stack is now empty - loop body can do whatever it wants
-
-    // Compile loop body
-    for (size_t i = 0; i < node->as.for_stmt.block_size; i++) {
-      compile_statement(c, node->as.for_stmt.block[i]);
-      if (compiler_has_error(c)) {
-        pop_loop(c);
-        return;
-      }
-    }
-
-    // Jump back to loop start
-    size_t jump_back_pos = emit_jump_with_offset(c, OP_JUMP);
-    if (compiler_has_error(c)) {
-      pop_loop(c);
-      return;
-    }
-    int16_t back_offset = (int16_t)(loop_start - (jump_back_pos + 2));
-    if (back_offset < INT16_MIN || back_offset > INT16_MAX) {
-      compiler_set_error(c, "Loop jump offset too large");
-      pop_loop(c);
-      return;
-    }
-    patch_jump_offset(c, jump_back_pos, back_offset);
+    return;
+  }
 
-    // Patch exit jump and update loop end
-    size_t exit_target = c->bytecode->count;
-    int16_t exit_offset = (int16_t)(exit_target - (exit_jump_pos + 2));
-    if (exit_offset < 0 || exit_offset > INT16_MAX) {
-      compiler_set_error(c, "Loop exit jump offset too large");
-      pop_loop(c);
-      return;
-    }
-    patch_jump_offset_unsigned(c, exit_jump_pos, (uint16_t)exit_offset);
-    if (c->loop_stack) {
-      c->loop_stack->loop_end = exit_target;
-      // Patch all pending break/continue jumps
-      patch_pending_jumps(c);
-    }
+  c->loop_stack->loop_continue = c->bytecode->count;
+  emit_jump_opcode(c, OP_ITER_NEXT, false);
+  emit_byte(c, depth);
+  size_t back_jump_pos = emit_jump_operand(c);
+  patch_jump(c, back_jump_pos, body_start);
 
-    // Pop loop info
+  size_t exit_target = c->bytecode->count;
+  patch_forward_jump(c, exit_jump_pos, exit_target);
+  emit_byte(c, OP_ITER_CLOSE);
+  emit_byte(c, depth);
+  if (compiler_has_error(c)) {
     pop_loop(c);
+    return;
+  }
 
-    // Clean up: pop index and list from stack
-    // Stack at exit: [list, index] (OP_JUMP_IF_FALSE already popped has_more)
-    emit_byte(c, OP_POP); // pop index
-    emit_byte(c, OP_POP); // pop list
+  c->loop_stack->loop_end = exit_target;
+  patch_pending_jumps(c);
+  pop_loop(c);
+}
 
-    // Reset hidden iterator variables to null to release references
-    KronosValue *nil_val = value_new_nil();
-    emit_constant(c, nil_val);
-    if (compiler_has_error(c)) {
-      return;
-    }
-    emit_byte(c, OP_STORE_VAR);
-    emit_uint16(c, (uint16_t)iter_list_name_idx);
-    emit_byte(c, 1); // mutable
-    emit_byte(c, 0); // no type annotation
-    if (compiler_has_error(c)) {
-      return;
-    }
+/**
+ * @brief Compile a for loop statement (range or list iteration)
+ */
+static void compile_for_statement(Compiler *c, const ASTNode *node) {
+  KronosValue *var_name =
+      value_new_string(node->as.for_stmt.var, strlen(node->as.for_stmt.var));
+  // Get variable index once - it's used multiple times in the loop
+  size_t var_idx = add_constant(c, var_name);
+  // add_constant() always takes ownership
+  if (var_idx == SIZE_MAX) {
+    return;
+  }
+  // Inside a function the loop variable is a slot-resolved local
+  int var_slot = scope_resolve(c->scope, node->as.for_stmt.var);
+  compile_hoisted_expressions(c, node);
+  if (compiler_has_error(c)) {
+    return;
+  }
 
-    nil_val = value_new_nil();
-    emit_constant(c, nil_val);
-    if (compiler_has_error(c)) {
-      return;
-    }
-    emit_byte(c, OP_STORE_VAR);
-    emit_uint16(c, (uint16_t)iter_index_name_idx);
-    emit_byte(c, 1); // mutable
-    emit_byte(c, 0); // no type annotation
-    if (compiler_has_error(c)) {
-      return;
-    }
+  if (node->as.for_stmt.is_range) {
+    compile_fused_range_loop(c, node, var_slot, var_idx);
+  } else {
+    compile_iterator_loop(c, node, var_slot, var_idx);
   }
 }
 
@@ -2167,17 +2994,31 @@ static void compile_for_statement(Compiler *c, const ASTNode *node) {
  * @brief Compile a while loop statement
  */
 static void compile_while_statement(Compiler *c, const ASTNode *node) {
+  compile_hoisted_expressions(c, node);
+  if (compiler_has_error(c)) {
+    return;
+  }
+
   // Loop start position (for break/continue jumps)
   size_t loop_start = c->bytecode->count;
 
-  // Compile condition
-  compile_expression(c, node->as.while_stmt.condition);
-  if (compiler_has_error(c)) {
+  // A constant condition either never enters the loop (the body is dead
+  // code) or never exits it except through break
+  int truth = constant_condition(c, node->as.while_stmt.condition);
+  if (truth == 0) {
+    if (push_loop(c, loop_start)) {
+      compile_dead_block(c, node->as.while_stmt.block,
+                         node->as.while_stmt.block_size);
+      pop_loop(c);
+    }
     return;
   }
 
-  // Jump if false (exit loop)
-  size_t exit_jump_pos = emit_jump_with_offset(c, OP_JUMP_IF_FALSE);
+  // Compile condition and its jump if false (exit loop)
+  size_t exit_jump_pos = 0;
+  if (truth < 0) {
+    exit_jump_pos = compile_condition_jump(c, node->as.while_stmt.condition);
+  }
   if (compiler_has_error(c)) {
     return;
   }
@@ -2188,12 +3029,10 @@ static void compile_while_statement(Compiler *c, const ASTNode *node) {
   }
 
   // Compile loop body
-  for (size_t i = 0; i < node->as.while_stmt.block_size; i++) {
-    compile_statement(c, node->as.while_stmt.block[i]);
-    if (compiler_has_error(c)) {
-      pop_loop(c);
-      return;
-    }
+  compile_block(c, node->as.while_stmt.block, node->as.while_stmt.block_size);
+  if (compiler_has_error(c)) {
+    pop_loop(c);
+    return;
   }
 
   // Jump back to loop start
@@ -2202,23 +3041,13 @@ static void compile_while_statement(Compiler *c, const ASTNode *node) {
     pop_loop(c);
     return;
   }
-  int16_t back_offset = (int16_t)(loop_start - (jump_back_pos + 2));
-  if (back_offset < INT16_MIN || back_offset > INT16_MAX) {
-    compiler_set_error(c, "Loop jump offset too large");
-    pop_loop(c);
-    return;
-  }
-  patch_jump_offset(c, jump_back_pos, back_offset);
+  patch_jump(c, jump_back_pos, loop_start);
 
   // Patch exit jump and update loop end
   size_t exit_target = c->bytecode->count;
-  int16_t exit_offset = (int16_t)(exit_target - (exit_jump_pos + 2));
-  if (exit_offset < 0 || exit_offset > INT16_MAX) {
-    compiler_set_error(c, "Loop exit jump offset too large");
-    pop_loop(c);
-    return;
+  if (truth < 0) {
+    patch_forward_jump(c, exit_jump_pos, exit_target);
   }
-  patch_jump_offset_unsigned(c, exit_jump_pos, (uint16_t)exit_offset);
   if (c->loop_stack) {
     c->loop_stack->loop_end = exit_target;
     // Patch all pending break/continue jumps
@@ -2230,221 +3059,321 @@ static void compile_while_statement(Compiler *c, const ASTNode *node) {
 }
 
 /**
- * @brief Compile a function definition statement
+ * @brief Run the SSA optimizer on a function body
+ *
+ * @return Plan for compiling the body, or NULL if it compiles as written
  */
-static void compile_function_statement(Compiler *c, const ASTNode *node) {
-  // Store function name
-  KronosValue *func_name =
-      value_new_string(node->as.function.name, strlen(node->as.function.name));
-  emit_byte(c, OP_DEFINE_FUNC);
-  if (!emit_constant_index(c, func_name)) {
+static IRPlan *optimize_function_body(const FunctionScope *scope,
+                                      const ASTNode *node) {
+  IRLocal *locals = malloc(sizeof(IRLocal) * (scope->slot_count + 1));
+  if (!locals) {
+    return NULL; // Optional: compile without it
+  }
+  for (size_t i = 0; i < scope->slot_count; i++) {
+    locals[i].name = scope->slots[i].name;
+    locals[i].removable =
+        scope->slots[i].is_mutable && !scope->slots[i].type_name;
+  }
+  IRPlan *plan = ir_optimize_function(node, locals, scope->slot_count,
+                                      LOCAL_SLOTS_MAX - scope->slot_count);
+  free(locals);
+  return plan;
+}
+
+typedef struct {
+  Compiler *c;
+  FunctionScope *scope;
+} InlineSlotReservation;
+
+/**
+ * @brief Reserve hidden slots for the locals of a function a call inlines
+ *
+ * Skipped (the call stays a call) if they would not fit in the frame.
+ */
+static void reserve_inline_slots(const ASTNode *call, void *ctx) {
+  InlineSlotReservation *reservation = ctx;
+  Compiler *c = reservation->c;
+  FunctionScope *scope = reservation->scope;
+  const InlineCandidate *callee = inline_callee(c, scope, call);
+  if (!callee || callee->local_count == 0 ||
+      scope_resolve(scope, callee->hidden[0]) >= 0 ||
+      scope->slot_count + callee->local_count > LOCAL_SLOTS_MAX) {
     return;
   }
-  if (compiler_has_error(c)) {
-    return;
+  for (size_t i = 0; i < callee->local_count; i++) {
+    if (!scope_add_slot(c, scope, callee->hidden[i], true, NULL)) {
+      return;
+    }
   }
+}
+
+/**
+ * @brief Compile a function definition statement
+ */
+static void compile_function_statement(Compiler *c, const ASTNode *node) {
   // Validate parameter count limit (uint8_t max is 255)
   if (node->as.function.param_count > 255) {
     compiler_set_error(c, "Function parameter count exceeds limit (255)");
     return;
   }
-  emit_byte(c, (uint8_t)node->as.function.param_count);
-  if (compiler_has_error(c)) {
+
+  // Resolve locals to frame slots: parameters occupy slots
+  // [0, param_count), followed by every other local declared in the body
+  FunctionScope *scope = calloc(1, sizeof(FunctionScope));
+  if (!scope) {
+    compiler_set_error(c, "Failed to allocate function scope");
     return;
   }
-
-  // Store parameter names as constants
   for (size_t i = 0; i < node->as.function.param_count; i++) {
-    KronosValue *param_name = value_new_string(
-        node->as.function.params[i], strlen(node->as.function.params[i]));
-    if (!emit_constant_index(c, param_name)) {
+    if (!scope_add_slot(c, scope, node->as.function.params[i], true, NULL)) {
+      scope_free(scope);
       return;
     }
-    if (compiler_has_error(c)) {
+  }
+  scope->param_count = node->as.function.param_count;
+  scope_collect_locals(c, scope, node->as.function.block,
+                       node->as.function.block_size);
+  if (c->inlines) {
+    InlineSlotReservation reservation = {c, scope};
+    inline_for_each_call(node->as.function.block,
+                         node->as.function.block_size, reserve_inline_slots,
+                         &reservation);
+  }
+  if (compiler_has_error(c)) {
+    scope_free(scope);
+    return;
+  }
+
+  // Optimize the body in SSA form; the values it reuses get temp slots
+  IRPlan *plan = c->optimize ? optimize_function_body(scope, node) : NULL;
+  for (size_t i = 0; i < ir_plan_temp_count(plan); i++) {
+    char temp_name[32];
+    snprintf(temp_name, sizeof(temp_name), "(t%zu)", i);
+    if (!scope_add_slot(c, scope, temp_name, true, NULL)) {
+      ir_plan_free(plan);
+      scope_free(scope);
       return;
     }
   }
 
-  // Store function body start position
-  size_t body_start = c->bytecode->count + 2; // +2 for jump instruction
-  emit_byte(c, (uint8_t)(body_start >> 8));   // High byte
-  emit_byte(c, (uint8_t)(body_start & 0xFF)); // Low byte
-  if (compiler_has_error(c)) {
+  // Add the header constants first: the instruction is wide if any of them
+  // (or the jump over the body) needs a 32-bit operand. Order: function
+  // name, parameter names, then per local its name and type (SIZE_MAX if
+  // untyped).
+  size_t param_count = node->as.function.param_count;
+  size_t local_count = scope->slot_count - param_count;
+  size_t constant_count = 1 + param_count + 2 * local_count;
+  size_t *constants = malloc(sizeof(size_t) * constant_count);
+  if (!constants) {
+    compiler_set_error(c, "Failed to allocate function header");
+    ir_plan_free(plan);
+    scope_free(scope);
     return;
   }
-
-  // Emit jump over function body
-  size_t skip_body_pos = emit_jump_with_offset(c, OP_JUMP);
+  size_t n = 0;
+  constants[n++] = add_constant(
+      c, value_new_string(node->as.function.name,
+                          strlen(node->as.function.name)));
+  for (size_t i = 0; i < param_count; i++) {
+    const char *param = node->as.function.params[i];
+    constants[n++] = add_constant(c, value_new_string(param, strlen(param)));
+  }
+  for (size_t i = param_count; i < scope->slot_count; i++) {
+    const LocalSlotInfo *info = &scope->slots[i];
+    constants[n++] =
+        add_constant(c, value_new_string(info->name, strlen(info->name)));
+    constants[n++] =
+        info->type_name
+            ? add_constant(c, value_new_string(info->type_name,
+                                               strlen(info->type_name)))
+            : SIZE_MAX;
+  }
+  bool wide = c->wide_jumps;
+  for (size_t i = 0; i < constant_count; i++) {
+    if (constants[i] != SIZE_MAX && constant_is_wide(constants[i])) {
+      wide = true;
+    }
+  }
   if (compiler_has_error(c)) {
+    free(constants);
+    ir_plan_free(plan);
+    scope_free(scope);
     return;
   }
 
-  // Compile function body
-  for (size_t i = 0; i < node->as.function.block_size; i++) {
-    compile_statement(c, node->as.function.block[i]);
-    if (compiler_has_error(c)) {
-      return;
+  // [OP_DEFINE_FUNC][name_idx][param_count:1][param_idx * N]
+  // [local_count:2] then per local [name_idx][is_mutable:1][type_idx]
+  // (type_idx absent means no type annotation)
+  n = 0;
+  emit_opcode(c, OP_DEFINE_FUNC, wide);
+  emit_operand(c, (uint32_t)constants[n++], wide);
+  emit_byte(c, (uint8_t)param_count);
+  for (size_t i = 0; i < param_count; i++) {
+    emit_operand(c, (uint32_t)constants[n++], wide);
+  }
+  emit_uint16(c, (uint16_t)local_count);
+  for (size_t i = param_count; i < scope->slot_count; i++) {
+    emit_operand(c, (uint32_t)constants[n++], wide);
+    emit_byte(c, scope->slots[i].is_mutable ? 1 : 0);
+    size_t type_idx = constants[n++];
+    if (type_idx != SIZE_MAX) {
+      emit_operand(c, (uint32_t)type_idx, wide);
+    } else {
+      emit_no_constant(c, wide);
     }
   }
+  free(constants);
 
-  // Implicit return nil if no explicit return
-  KronosValue *nil_val = value_new_nil();
-  emit_constant(c, nil_val);
+  // [body_start][OP_JUMP][skip]: body_start is the position of the jump
+  // over the body (not a jump site: never threaded)
+  size_t body_start = c->bytecode->count + (wide ? 4 : 2);
+  if (!wide && body_start > UINT16_MAX) {
+    c->jump_overflow = true;
+  }
+  emit_operand(c, (uint32_t)body_start, wide);
+  emit_byte(c, OP_JUMP);
+  size_t skip_body_pos = c->bytecode->count;
+  emit_operand(c, 0, wide); // Placeholder offset
   if (compiler_has_error(c)) {
+    ir_plan_free(plan);
+    scope_free(scope);
     return;
   }
-  emit_byte(c, OP_RETURN_VAL);
+
+  // Compile function body with its scope active (and its own frame's range
+  // loop slots; enclosing loop counters are not its variables)
+  scope->enclosing = c->scope;
+  c->scope = scope;
+  size_t enclosing_range_depth = c->range_depth;
+  size_t enclosing_iter_depth = c->iter_depth;
+  size_t enclosing_try_depth = c->try_depth;
+  TypedVar *enclosing_typed_vars = c->typed_vars;
+  IRPlan *enclosing_plan = c->plan;
+  c->range_depth = 0;
+  c->iter_depth = 0;
+  c->try_depth = 0;
+  c->typed_vars = NULL;
+  c->plan = plan;
+  compile_block(c, node->as.function.block, node->as.function.block_size);
+  bool falls_through =
+      !c->optimize || !block_terminates(c, node->as.function.block,
+                                        node->as.function.block_size);
+  c->range_depth = enclosing_range_depth;
+  c->iter_depth = enclosing_iter_depth;
+  c->try_depth = enclosing_try_depth;
+  c->typed_vars = enclosing_typed_vars;
+  c->plan = enclosing_plan;
+  c->scope = scope->enclosing;
+  ir_plan_free(plan);
+  scope_free(scope);
   if (compiler_has_error(c)) {
     return;
   }
 
+  // Implicit return nil if the body can fall off its end
+  if (falls_through) {
+    KronosValue *nil_val = value_new_nil();
+    emit_constant(c, nil_val);
+    if (compiler_has_error(c)) {
+      return;
+    }
+    emit_byte(c, OP_RETURN_VAL);
+    if (compiler_has_error(c)) {
+      return;
+    }
+  }
+
   // Patch jump over body
-  if (compiler_has_error(c)) {
-    return;
+  patch_jump_operand(c, skip_body_pos, c->bytecode->count, wide, false);
+
+  // Calls compiled from here on reach this definition
+  InlineCandidate *candidate =
+      inline_table_find(c->inlines, node->as.function.name);
+  if (candidate && candidate->function == node) {
+    candidate->defined = true;
   }
-  size_t func_end = c->bytecode->count;
-  int16_t skip_offset = (int16_t)(func_end - (skip_body_pos + 2));
-  if (skip_offset < 0 || skip_offset > INT16_MAX) {
-    compiler_set_error(c, "Function body jump offset too large");
-    return;
+}
+
+/**
+ * @brief Compile one catch clause: OP_CATCH, the catch variable store and
+ * the handler block
+ *
+ * OP_CATCH [error_type_idx][catch_var_idx], either absent (catch all, no
+ * variable)
+ */
+static void compile_catch_clause(Compiler *c, const ASTNode *node,
+                                 size_t index) {
+  const char *error_type = node->as.try_stmt.catch_blocks[index].error_type;
+  const char *catch_var = node->as.try_stmt.catch_blocks[index].catch_var;
+  size_t type_idx = SIZE_MAX;
+  if (error_type) {
+    type_idx =
+        add_constant(c, value_new_string(error_type, strlen(error_type)));
+    if (type_idx == SIZE_MAX) {
+      return;
+    }
+  }
+  size_t var_idx = SIZE_MAX;
+  if (catch_var) {
+    var_idx = add_constant(c, value_new_string(catch_var, strlen(catch_var)));
+    if (var_idx == SIZE_MAX) {
+      return;
+    }
+  }
+
+  bool wide = (type_idx != SIZE_MAX && constant_is_wide(type_idx)) ||
+              (var_idx != SIZE_MAX && constant_is_wide(var_idx));
+  emit_opcode(c, OP_CATCH, wide);
+  if (type_idx != SIZE_MAX) {
+    emit_operand(c, (uint32_t)type_idx, wide);
+  } else {
+    emit_no_constant(c, wide);
   }
-  patch_jump_offset_unsigned(c, skip_body_pos, (uint16_t)skip_offset);
+  if (var_idx != SIZE_MAX) {
+    emit_operand(c, (uint32_t)var_idx, wide);
+    emit_store_variable(c, scope_resolve(c->scope, catch_var), var_idx);
+  } else {
+    emit_no_constant(c, wide);
+  }
+
+  compile_block(c, node->as.try_stmt.catch_blocks[index].catch_block,
+                node->as.try_stmt.catch_blocks[index].catch_block_size);
 }
 
 /**
  * @brief Compile a try-catch-finally statement
  */
 static void compile_try_statement(Compiler *c, const ASTNode *node) {
-  // Emit OP_TRY_ENTER to mark start of try block
-  emit_byte(c, OP_TRY_ENTER);
-  size_t try_start_pos = c->bytecode->count;
-  emit_byte(c,
-            0); // Placeholder for exception handler offset (will be patched)
-  emit_byte(c, 0);
-
-  // Compile try block
-  for (size_t i = 0; i < node->as.try_stmt.try_block_size; i++) {
-    compile_statement(c, node->as.try_stmt.try_block[i]);
-    if (compiler_has_error(c)) {
-      return;
-    }
+  // Emit OP_TRY_ENTER to mark start of try block; the exception handler
+  // offset is patched once the handler is placed
+  emit_jump_opcode(c, OP_TRY_ENTER, false);
+  size_t try_start_pos = emit_jump_operand(c);
+
+  // Compile try block
+  compile_block(c, node->as.try_stmt.try_block,
+                node->as.try_stmt.try_block_size);
+  if (compiler_has_error(c)) {
+    return;
   }
 
   // Emit OP_TRY_EXIT to mark normal completion
-  emit_byte(c, OP_TRY_EXIT);
-  size_t finally_jump_pos = c->bytecode->count;
-  emit_byte(c, 0); // Placeholder for finally jump offset
-  emit_byte(c, 0);
+  emit_jump_opcode(c, OP_TRY_EXIT, false);
+  size_t finally_jump_pos = emit_jump_operand(c); // Placeholder
 
-  // Calculate exception handler position (catch or finally)
-  size_t exception_handler_pos = c->bytecode->count;
-
-  // Patch try_start_pos with exception handler offset
-  size_t handler_offset = exception_handler_pos - (try_start_pos + 2);
-  if (handler_offset > UINT16_MAX) {
-    compiler_set_error(c, "Exception handler too far away");
-    return;
-  }
-  c->bytecode->code[try_start_pos] = (uint8_t)((handler_offset >> 8) & 0xFF);
-  c->bytecode->code[try_start_pos + 1] = (uint8_t)(handler_offset & 0xFF);
+  // Patch try_start_pos with the exception handler (catch or finally)
+  patch_forward_jump(c, try_start_pos, c->bytecode->count);
 
   // If catch blocks exist, emit catch handlers
   if (node->as.try_stmt.catch_block_count > 0) {
-    // Emit OP_CATCH for first catch block
-    emit_byte(c, OP_CATCH);
-
-    // Store error type (NULL means catch all) and catch variable name as
-    // constants
-    const char *error_type = node->as.try_stmt.catch_blocks[0].error_type;
-    const char *catch_var = node->as.try_stmt.catch_blocks[0].catch_var;
-
-    // Error type constant (NULL if catch all)
-    if (error_type) {
-      KronosValue *error_type_val =
-          value_new_string(error_type, strlen(error_type));
-      if (!emit_constant_index(c, error_type_val)) {
-        return;
-      }
-    } else {
-      // Catch all - use 0xFFFF as marker
-      emit_uint16(c, 0xFFFF);
-    }
-
-    // Catch variable name constant - OP_CATCH will push error onto stack
-    // Then we emit OP_STORE_VAR to create the catch variable
-    if (catch_var) {
-      KronosValue *catch_var_val =
-          value_new_string(catch_var, strlen(catch_var));
-      size_t catch_var_idx = add_constant(c, catch_var_val);
-      // add_constant() always takes ownership
-      if (catch_var_idx == SIZE_MAX || catch_var_idx > UINT16_MAX) {
-        return;
-      }
-      emit_uint16(c, (uint16_t)catch_var_idx);
-
-      // After OP_CATCH pushes error onto stack, store it as variable
-      emit_byte(c, OP_STORE_VAR);
-      emit_uint16(c, (uint16_t)catch_var_idx);
-      emit_byte(c, 1); // is_mutable = true
-      emit_byte(c, 0); // No type annotation
-    } else {
-      emit_uint16(c, 0xFFFF); // No variable
-    }
-
-    // Compile first catch block
-    for (size_t i = 0; i < node->as.try_stmt.catch_blocks[0].catch_block_size;
-         i++) {
-      compile_statement(c, node->as.try_stmt.catch_blocks[0].catch_block[i]);
+    // Emit an OP_CATCH per catch block; it pushes the error onto the stack,
+    // then a store (OP_STORE_VAR, or OP_STORE_LOCAL inside a function)
+    // creates the catch variable
+    for (size_t cb = 0; cb < node->as.try_stmt.catch_block_count; cb++) {
+      compile_catch_clause(c, node, cb);
       if (compiler_has_error(c)) {
         return;
       }
     }
-
-    // Compile additional catch blocks (if any)
-    for (size_t cb = 1; cb < node->as.try_stmt.catch_block_count; cb++) {
-      emit_byte(c, OP_CATCH);
-
-      error_type = node->as.try_stmt.catch_blocks[cb].error_type;
-      catch_var = node->as.try_stmt.catch_blocks[cb].catch_var;
-
-      if (error_type) {
-        KronosValue *error_type_val =
-            value_new_string(error_type, strlen(error_type));
-        if (!emit_constant_index(c, error_type_val)) {
-          return;
-        }
-      } else {
-        emit_uint16(c, 0xFFFF);
-      }
-
-      if (catch_var) {
-        KronosValue *catch_var_val =
-            value_new_string(catch_var, strlen(catch_var));
-        size_t catch_var_idx = add_constant(c, catch_var_val);
-        // add_constant() always takes ownership
-        if (catch_var_idx == SIZE_MAX || catch_var_idx > UINT16_MAX) {
-          return;
-        }
-        emit_uint16(c, (uint16_t)catch_var_idx);
-
-        // After OP_CATCH pushes error onto stack, store it as variable
-        emit_byte(c, OP_STORE_VAR);
-        emit_uint16(c, (uint16_t)catch_var_idx);
-        emit_byte(c, 1); // is_mutable = true
-        emit_byte(c, 0); // No type annotation
-      } else {
-        emit_uint16(c, 0xFFFF);
-      }
-
-      // Compile catch block
-      for (size_t i = 0;
-           i < node->as.try_stmt.catch_blocks[cb].catch_block_size; i++) {
-        compile_statement(c, node->as.try_stmt.catch_blocks[cb].catch_block[i]);
-        if (compiler_has_error(c)) {
-          return;
-        }
-      }
-    }
   }
 
   // If finally exists, emit finally handler
@@ -2452,33 +3381,19 @@ static void compile_try_statement(Compiler *c, const ASTNode *node) {
     size_t finally_start_pos = c->bytecode->count;
 
     // Patch OP_TRY_EXIT to jump to finally
-    size_t finally_offset = finally_start_pos - (finally_jump_pos + 2);
-    if (finally_offset > UINT16_MAX) {
-      compiler_set_error(c, "Finally block too far away");
-      return;
-    }
-    c->bytecode->code[finally_jump_pos] =
-        (uint8_t)((finally_offset >> 8) & 0xFF);
-    c->bytecode->code[finally_jump_pos + 1] = (uint8_t)(finally_offset & 0xFF);
+    patch_forward_jump(c, finally_jump_pos, finally_start_pos);
 
     emit_byte(c, OP_FINALLY);
 
     // Compile finally block
-    for (size_t i = 0; i < node->as.try_stmt.finally_block_size; i++) {
-      compile_statement(c, node->as.try_stmt.finally_block[i]);
-      if (compiler_has_error(c)) {
-        return;
-      }
+    compile_block(c, node->as.try_stmt.finally_block,
+                  node->as.try_stmt.finally_block_size);
+    if (compiler_has_error(c)) {
+      return;
     }
   } else {
     // No finally, patch OP_TRY_EXIT to jump past exception handler
-    size_t skip_offset = c->bytecode->count - (finally_jump_pos + 2);
-    if (skip_offset > UINT16_MAX) {
-      compiler_set_error(c, "Try block too large");
-      return;
-    }
-    c->bytecode->code[finally_jump_pos] = (uint8_t)((skip_offset >> 8) & 0xFF);
-    c->bytecode->code[finally_jump_pos + 1] = (uint8_t)(skip_offset & 0xFF);
+    patch_forward_jump(c, finally_jump_pos, c->bytecode->count);
   }
 }
 
@@ -2510,7 +3425,9 @@ static void compile_statement(Compiler *c, const ASTNode *node) {
     break;
 
   case AST_TRY:
+    c->try_depth++;
     compile_try_statement(c, node);
+    c->try_depth--;
     break;
 
   case AST_PRINT:
@@ -2581,26 +3498,202 @@ static void compile_statement(Compiler *c, const ASTNode *node) {
 }
 
 /**
- * @brief Compile an AST to bytecode
+ * @brief Whether control never continues past @p node
  *
- * Main entry point for compilation. Processes all statements in the AST
- * and generates executable bytecode. Emits a HALT instruction at the end.
+ * A top-level `return` does not stop the program, so it only terminates
+ * code inside a function body.
+ */
+static bool statement_terminates(const Compiler *c, const ASTNode *node) {
+  if (!node) {
+    return false;
+  }
+  switch (node->type) {
+  case AST_BREAK:
+  case AST_CONTINUE:
+  case AST_RAISE:
+    return true;
+  case AST_RETURN:
+    return c->scope != NULL;
+  default:
+    return false;
+  }
+}
+
+/**
+ * @brief Whether a block always ends in a terminating statement
+ */
+static bool block_terminates(const Compiler *c, ASTNode *const *block,
+                             size_t block_size) {
+  for (size_t i = 0; i < block_size; i++) {
+    if (statement_terminates(c, block[i])) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Compile a statement block
  *
- * @param ast Abstract Syntax Tree to compile
- * @param out_err Optional pointer to receive error message
- * @return Generated bytecode, or NULL on error
+ * When optimizing, statements after a terminating statement are
+ * unreachable and compiled as dead code (checked, then discarded).
  */
-Bytecode *compile(AST *ast, const char **out_err) {
-  if (out_err) {
-    *out_err = NULL;
+static void compile_block(Compiler *c, ASTNode *const *block,
+                          size_t block_size) {
+  for (size_t i = 0; i < block_size && !compiler_has_error(c); i++) {
+    compile_statement(c, block[i]);
+    if (c->optimize && i + 1 < block_size &&
+        statement_terminates(c, block[i])) {
+      compile_dead_block(c, block + i + 1, block_size - i - 1);
+      return;
+    }
   }
-  if (!ast) {
-    if (out_err) {
-      *out_err = "Invalid AST (NULL)";
+}
+
+/**
+ * @brief Compile an unreachable block and discard its output
+ *
+ * The block is compiled normally so it reports the same errors (e.g. a
+ * `break` outside of a loop) as at -O0, then the emitted code, constants,
+ * jump sites and break/continue jumps it added are rolled back.
+ */
+static void compile_dead_block(Compiler *c, ASTNode *const *block,
+                               size_t block_size) {
+  size_t code_mark = c->bytecode->count;
+  size_t const_mark = c->bytecode->const_count;
+  size_t site_mark = c->jump_site_count;
+  BreakContinueJump *pending_mark =
+      c->loop_stack ? c->loop_stack->pending_jumps : NULL;
+
+  compile_block(c, block, block_size);
+  if (compiler_has_error(c)) {
+    return;
+  }
+
+  // Nested loops have been popped again, so only the enclosing loop can
+  // hold new pending jumps (pushed at the head of its list)
+  while (c->loop_stack && c->loop_stack->pending_jumps != pending_mark) {
+    BreakContinueJump *jump = c->loop_stack->pending_jumps;
+    c->loop_stack->pending_jumps = jump->next;
+    free(jump);
+  }
+  // Newest first, so each removal sees the index as it was after the add
+  for (size_t i = c->bytecode->const_count; i-- > const_mark;) {
+    constant_index_remove(c, i);
+    value_release(c->bytecode->constants[i]);
+    c->bytecode->constants[i] = NULL;
+  }
+  c->bytecode->const_count = const_mark;
+  if (c->to_string_const_idx != SIZE_MAX &&
+      c->to_string_const_idx >= const_mark) {
+    c->to_string_const_idx = SIZE_MAX;
+  }
+  c->jump_site_count = site_mark;
+  c->bytecode->count = code_mark;
+}
+
+/**
+ * @brief Decode the jump at @p pos (a recorded jump site)
+ *
+ * @param operand_pos Set to the position of its offset operand
+ * @param wide Set if it is prefixed with OP_WIDE
+ * @return Its target
+ */
+static size_t jump_site_target(const uint8_t *code, size_t pos,
+                               size_t *operand_pos, bool *wide) {
+  *wide = code[pos] == OP_WIDE;
+  uint8_t opcode = code[pos + *wide];
+  // OP_CMP_JUMP_IF_FALSE(_NUM) has a [cmp:1] operand before the offset
+  size_t operand = pos + *wide + (opcode == OP_JUMP || opcode ==
+                                  OP_JUMP_IF_FALSE ? 1 : 2);
+  size_t width = *wide ? 4 : 2;
+  uint32_t value = 0;
+  for (size_t i = 0; i < width; i++) {
+    value = (value << 8) | code[operand + i];
+  }
+  *operand_pos = operand;
+  if (opcode != OP_JUMP) {
+    return operand + width + value;
+  }
+  int64_t offset = *wide ? (int32_t)value : (int16_t)value;
+  return (size_t)((int64_t)(operand + width) + offset);
+}
+
+/**
+ * @brief Opcode of the jump at @p pos, past any OP_WIDE prefix
+ */
+static uint8_t jump_site_opcode(const uint8_t *code, size_t pos) {
+  return code[pos] == OP_WIDE ? code[pos + 1] : code[pos];
+}
+
+/**
+ * @brief Whether @p pos is a recorded jump site (sites are sorted)
+ */
+static bool is_jump_site(const Compiler *c, size_t pos) {
+  size_t lo = 0;
+  size_t hi = c->jump_site_count;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (c->jump_sites[mid] < pos) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo < c->jump_site_count && c->jump_sites[lo] == pos;
+}
+
+/**
+ * @brief Retarget jumps that land on an unconditional jump
+ *
+ * A jump to an OP_JUMP is rewritten to that jump's own target (following
+ * chains up to a small bound), e.g. an else-if skip jump that lands on the
+ * back edge of the enclosing loop goes straight to the loop head. Offsets
+ * keep their encoding: conditional jumps stay forward-only, and a jump
+ * whose new offset would not fit is left alone.
+ */
+static void thread_jumps(Compiler *c) {
+  uint8_t *code = c->bytecode->code;
+  for (size_t i = 0; i < c->jump_site_count; i++) {
+    size_t site = c->jump_sites[i];
+    size_t operand_pos;
+    bool wide;
+    size_t target = jump_site_target(code, site, &operand_pos, &wide);
+    size_t hops = 0;
+    while (hops < JUMP_THREAD_MAX_HOPS && target != site &&
+           is_jump_site(c, target) &&
+           jump_site_opcode(code, target) == OP_JUMP) {
+      size_t next_operand;
+      bool next_wide;
+      size_t next = jump_site_target(code, target, &next_operand, &next_wide);
+      if (next == target) {
+        break;
+      }
+      target = next;
+      hops++;
+    }
+    if (hops == 0) {
+      continue;
+    }
+
+    bool is_signed = jump_site_opcode(code, site) == OP_JUMP;
+    int64_t offset =
+        (int64_t)target - (int64_t)(operand_pos + (wide ? 4 : 2));
+    if (jump_offset_fits(offset, wide, is_signed)) {
+      patch_jump_operand(c, operand_pos, target, wide, is_signed);
     }
-    return NULL;
   }
+}
 
+/**
+ * @brief Compile an AST to bytecode with 16-bit or 32-bit jump operands
+ *
+ * @param wide_jumps Prefix every jump with OP_WIDE
+ * @param jump_overflow Set (and NULL returned) if a narrow jump did not fit
+ * @return Generated bytecode, or NULL on error or overflow
+ */
+static Bytecode *compile_unit(AST *ast, bool wide_jumps, bool *jump_overflow,
+                              const char **out_err) {
   Compiler *c = calloc(1, sizeof(Compiler));
   if (!c) {
     if (out_err) {
@@ -2610,6 +3703,9 @@ Bytecode *compile(AST *ast, const char **out_err) {
   }
   c->to_string_const_idx = SIZE_MAX;
   c->loop_counter = 0;
+  c->optimize = g_compiler_optimization_level >= 1;
+  c->wide_jumps = wide_jumps;
+  c->quiet = wide_jumps;
   c->bytecode = malloc(sizeof(Bytecode));
   if (!c->bytecode) {
     free(c);
@@ -2634,6 +3730,11 @@ Bytecode *compile(AST *ast, const char **out_err) {
 
   c->bytecode->const_capacity = CONSTANT_POOL_DEFAULT_CAPACITY;
   c->bytecode->const_count = 0;
+  c->bytecode->global_owner = 0;
+  c->bytecode->global_names = NULL;
+  c->bytecode->global_name_capacity = 0;
+  c->bytecode->verified = false;
+  c->bytecode->call_cache = NULL;
   c->bytecode->constants =
       calloc(c->bytecode->const_capacity, sizeof(KronosValue *));
   if (!c->bytecode->constants) {
@@ -2646,19 +3747,32 @@ Bytecode *compile(AST *ast, const char **out_err) {
     return NULL;
   }
 
-  // Compile all statements
-  for (size_t i = 0; i < ast->count && !compiler_has_error(c); i++) {
-    compile_statement(c, ast->statements[i]);
+  if (c->optimize && g_compiler_inlining) {
+    c->inlines = inline_table_build(ast, g_compiler_builtin_lookup);
   }
 
+  // Compile all statements
+  compile_block(c, ast->statements, ast->count);
+  inline_table_free(c->inlines);
+
   // Emit halt instruction if no errors occurred
   if (!compiler_has_error(c)) {
     emit_byte(c, OP_HALT);
   }
+  *jump_overflow = c->jump_overflow && !compiler_has_error(c);
+  if (!compiler_has_error(c) && !c->jump_overflow && c->optimize) {
+    thread_jumps(c);
+  }
+  free(c->jump_sites);
+  free(c->const_index);
 
-  if (compiler_has_error(c)) {
-    if (out_err) {
-      *out_err = c->error_message ? c->error_message : "Compilation failed";
+  if (compiler_has_error(c) || *jump_overflow) {
+    if (!*jump_overflow) {
+      free(g_compiler_last_error);
+      g_compiler_last_error = c->error_message;
+      if (out_err) {
+        *out_err = c->error_message ? c->error_message : "Compilation failed";
+      }
     }
     bytecode_free(c->bytecode);
     // Free loop stack if any
@@ -2676,6 +3790,42 @@ Bytecode *compile(AST *ast, const char **out_err) {
   return result;
 }
 
+/**
+ * @brief Compile an AST to bytecode
+ *
+ * Main entry point for compilation. Processes all statements in the AST
+ * and generates executable bytecode. Emits a HALT instruction at the end.
+ * Jumps are 16-bit unless one of them does not fit; the unit is then
+ * compiled again with every jump prefixed by OP_WIDE.
+ *
+ * @param ast Abstract Syntax Tree to compile
+ * @param out_err Optional pointer to receive error message
+ * @return Generated bytecode, or NULL on error
+ */
+Bytecode *compile(AST *ast, const char **out_err) {
+  if (out_err) {
+    *out_err = NULL;
+  }
+  if (!ast) {
+    if (out_err) {
+      *out_err = "Invalid AST (NULL)";
+    }
+    return NULL;
+  }
+
+  bool jump_overflow = false;
+  Bytecode *result = compile_unit(ast, false, &jump_overflow, out_err);
+  if (jump_overflow) {
+    result = compile_unit(ast, true, &jump_overflow, out_err);
+  }
+  if (!result) {
+    return NULL;
+  }
+  // Malformed output stays unverified and runs on the VM's checked path
+  bytecode_verify(result, NULL);
+  return result;
+}
+
 /**
  * @brief Free bytecode and its constant pool
  *
@@ -2704,9 +3854,112 @@ void bytecode_free(Bytecode *bytecode) {
 
   free(bytecode->constants);
   free(bytecode->code);
+  free(bytecode->call_cache);
+  free(bytecode->global_names);
   free(bytecode);
 }
 
+// Opcode names for disassembly and opcode profiles
+static const char *const opcode_names[OPCODE_COUNT] = {
+    [OP_LOAD_CONST] = "LOAD_CONST",
+    [OP_LOAD_VAR] = "LOAD_VAR",
+    [OP_STORE_VAR] = "STORE_VAR",
+    [OP_LOAD_LOCAL] = "LOAD_LOCAL",
+    [OP_STORE_LOCAL] = "STORE_LOCAL",
+    [OP_LOAD_GLOBAL] = "LOAD_GLOBAL",
+    [OP_STORE_GLOBAL] = "STORE_GLOBAL",
+    [OP_PRINT] = "PRINT",
+    [OP_ADD] = "ADD",
+    [OP_SUB] = "SUB",
+    [OP_MUL] = "MUL",
+    [OP_DIV] = "DIV",
+    [OP_MOD] = "MOD",
+    [OP_NEG] = "NEG",
+    [OP_EQ] = "EQ",
+    [OP_NEQ] = "NEQ",
+    [OP_GT] = "GT",
+    [OP_LT] = "LT",
+    [OP_GTE] = "GTE",
+    [OP_LTE] = "LTE",
+    [OP_AND] = "AND",
+    [OP_OR] = "OR",
+    [OP_NOT] = "NOT",
+    [OP_JUMP] = "JUMP",
+    [OP_JUMP_IF_FALSE] = "JUMP_IF_FALSE",
+    [OP_BREAK] = "BREAK",
+    [OP_CONTINUE] = "CONTINUE",
+    [OP_DEFINE_FUNC] = "DEFINE_FUNC",
+    [OP_CALL_FUNC] = "CALL_FUNC",
+    [OP_TAIL_CALL] = "TAIL_CALL",
+    [OP_RETURN_VAL] = "RETURN_VAL",
+    [OP_POP] = "POP",
+    [OP_LIST_NEW] = "LIST_NEW",
+    [OP_LIST_GET] = "LIST_GET",
+    [OP_LIST_SET] = "LIST_SET",
+    [OP_LIST_APPEND] = "LIST_APPEND",
+    [OP_LIST_LEN] = "LIST_LEN",
+    [OP_LIST_SLICE] = "LIST_SLICE",
+    [OP_ITER_PREP] = "ITER_PREP",
+    [OP_ITER_NEXT] = "ITER_NEXT",
+    [OP_ITER_CLOSE] = "ITER_CLOSE",
+    [OP_RANGE_NEW] = "RANGE_NEW",
+    [OP_MAP_NEW] = "MAP_NEW",
+    [OP_MAP_SET] = "MAP_SET",
+    [OP_MAP_GET] = "MAP_GET",
+    [OP_DELETE] = "DELETE",
+    [OP_TRY_ENTER] = "TRY_ENTER",
+    [OP_TRY_EXIT] = "TRY_EXIT",
+    [OP_CATCH] = "CATCH",
+    [OP_FINALLY] = "FINALLY",
+    [OP_THROW] = "THROW",
+    [OP_RETHROW] = "RETHROW",
+    [OP_IMPORT] = "IMPORT",
+    [OP_FOR_RANGE_PREP] = "FOR_RANGE_PREP",
+    [OP_FOR_RANGE_NEXT] = "FOR_RANGE_NEXT",
+    [OP_CMP_JUMP_IF_FALSE] = "CMP_JUMP_IF_FALSE",
+    [OP_INC_LOCAL_CONST] = "INC_LOCAL_CONST",
+    [OP_INC_VAR_CONST] = "INC_VAR_CONST",
+    [OP_INC_GLOBAL_CONST] = "INC_GLOBAL_CONST",
+    [OP_ADD_NUM] = "ADD_NUM",
+    [OP_SUB_NUM] = "SUB_NUM",
+    [OP_MUL_NUM] = "MUL_NUM",
+    [OP_GT_NUM] = "GT_NUM",
+    [OP_LT_NUM] = "LT_NUM",
+    [OP_GTE_NUM] = "GTE_NUM",
+    [OP_LTE_NUM] = "LTE_NUM",
+    [OP_CMP_JUMP_IF_FALSE_NUM] = "CMP_JUMP_IF_FALSE_NUM",
+    [OP_INDEX_LIST] = "INDEX_LIST",
+    [OP_CONCAT_STR] = "CONCAT_STR",
+    [OP_WIDE] = "WIDE",
+    [OP_HALT] = "HALT",
+};
+
+const char *opcode_name(uint8_t opcode) {
+  if (opcode >= OPCODE_COUNT || !opcode_names[opcode]) {
+    return "UNKNOWN";
+  }
+  return opcode_names[opcode];
+}
+
+/**
+ * @brief Read a 16-bit (or, after OP_WIDE, 32-bit) big-endian operand
+ */
+static uint32_t disasm_operand(const uint8_t *code, size_t pos, bool wide) {
+  if (wide) {
+    return (uint32_t)code[pos] << 24 | (uint32_t)code[pos + 1] << 16 |
+           (uint32_t)code[pos + 2] << 8 | code[pos + 3];
+  }
+  return (uint32_t)(code[pos] << 8 | code[pos + 1]);
+}
+
+/**
+ * @brief Read a signed jump offset operand
+ */
+static int32_t disasm_offset(const uint8_t *code, size_t pos, bool wide) {
+  uint32_t value = disasm_operand(code, pos, wide);
+  return wide ? (int32_t)value : (int16_t)value;
+}
+
 /**
  * @brief Print bytecode in human-readable format
  *
@@ -2734,58 +3987,86 @@ void bytecode_print(Bytecode *bytecode) {
   while (offset < bytecode->count) {
     printf("%04zu  ", offset);
     uint8_t instruction = bytecode->code[offset];
+    // After an OP_WIDE prefix, offset is that of the prefixed opcode
+    bool wide = instruction == OP_WIDE && offset + 1 < bytecode->count;
+    if (wide) {
+      printf("WIDE ");
+      instruction = bytecode->code[++offset];
+    }
+    size_t w = wide ? 4 : 2; // Constant, global slot and jump operand width
 
     switch (instruction) {
-    case OP_LOAD_CONST: {
-      if (offset + 2 >= bytecode->count) {
-        printf("LOAD_CONST <invalid: out of bounds>\n");
-        offset = bytecode->count;
-        break;
-      }
-      uint16_t idx = (uint16_t)(bytecode->code[offset + 1] << 8 |
-                                bytecode->code[offset + 2]);
-      printf("LOAD_CONST %u\n", idx);
-      offset += 3;
-      break;
-    }
+    case OP_LOAD_CONST:
     case OP_LOAD_VAR: {
-      if (offset + 2 >= bytecode->count) {
-        printf("LOAD_VAR <invalid: out of bounds>\n");
+      if (offset + w >= bytecode->count) {
+        printf("%s <invalid: out of bounds>\n", opcode_name(instruction));
         offset = bytecode->count;
         break;
       }
-      uint16_t idx = (uint16_t)(bytecode->code[offset + 1] << 8 |
-                                bytecode->code[offset + 2]);
-      printf("LOAD_VAR %u\n", idx);
-      offset += 3;
+      printf("%s %u\n", opcode_name(instruction),
+             disasm_operand(bytecode->code, offset + 1, wide));
+      offset += 1 + w;
       break;
     }
     case OP_STORE_VAR: {
-      if (offset + 4 >= bytecode->count) {
+      if (offset + w + 2 >= bytecode->count) {
         printf("STORE_VAR <invalid: out of bounds>\n");
         offset = bytecode->count;
         break;
       }
-      uint16_t idx = (uint16_t)(bytecode->code[offset + 1] << 8 |
-                                bytecode->code[offset + 2]);
-      uint8_t is_mutable = bytecode->code[offset + 3];
-      uint8_t has_type = bytecode->code[offset + 4];
+      uint32_t idx = disasm_operand(bytecode->code, offset + 1, wide);
+      uint8_t is_mutable = bytecode->code[offset + 1 + w];
+      uint8_t has_type = bytecode->code[offset + 2 + w];
       printf("STORE_VAR name=%u mutable=%u", idx, is_mutable);
-      offset += 5;
+      offset += 3 + w;
       if (has_type) {
-        if (offset + 1 >= bytecode->count) {
+        if (offset + w > bytecode->count) {
           printf(" <invalid: type index out of bounds>\n");
           offset = bytecode->count;
           break;
         }
-        uint16_t type_idx = (uint16_t)(bytecode->code[offset] << 8 |
-                                       bytecode->code[offset + 1]);
-        printf(" type=%u", type_idx);
-        offset += 2;
+        printf(" type=%u", disasm_operand(bytecode->code, offset, wide));
+        offset += w;
       }
       printf("\n");
       break;
     }
+    case OP_LOAD_LOCAL:
+    case OP_STORE_LOCAL: {
+      const char *op_name =
+          instruction == OP_LOAD_LOCAL ? "LOAD_LOCAL" : "STORE_LOCAL";
+      if (offset + 1 >= bytecode->count) {
+        printf("%s <invalid: out of bounds>\n", op_name);
+        offset = bytecode->count;
+        break;
+      }
+      printf("%s slot=%u\n", op_name, bytecode->code[offset + 1]);
+      offset += 2;
+      break;
+    }
+    case OP_LOAD_GLOBAL: {
+      if (offset + w >= bytecode->count) {
+        printf("LOAD_GLOBAL <invalid: out of bounds>\n");
+        offset = bytecode->count;
+        break;
+      }
+      printf("LOAD_GLOBAL slot=%u\n",
+             disasm_operand(bytecode->code, offset + 1, wide));
+      offset += 1 + w;
+      break;
+    }
+    case OP_STORE_GLOBAL: {
+      if (offset + w + 2 >= bytecode->count) {
+        printf("STORE_GLOBAL <invalid: out of bounds>\n");
+        offset = bytecode->count;
+        break;
+      }
+      uint32_t slot = disasm_operand(bytecode->code, offset + 1, wide);
+      uint8_t has_type = bytecode->code[offset + 2 + w];
+      printf("STORE_GLOBAL slot=%u\n", slot);
+      offset += 3 + w + (has_type ? w : 0);
+      break;
+    }
     case OP_PRINT:
       printf("PRINT\n");
       offset++;
@@ -2838,6 +4119,18 @@ void bytecode_print(Bytecode *bytecode) {
       printf("LTE\n");
       offset++;
       break;
+    case OP_ADD_NUM:
+    case OP_SUB_NUM:
+    case OP_MUL_NUM:
+    case OP_GT_NUM:
+    case OP_LT_NUM:
+    case OP_GTE_NUM:
+    case OP_LTE_NUM:
+    case OP_INDEX_LIST:
+    case OP_CONCAT_STR:
+      printf("%s\n", opcode_name(instruction));
+      offset++;
+      break;
     case OP_AND:
       printf("AND\n");
       offset++;
@@ -2851,39 +4144,48 @@ void bytecode_print(Bytecode *bytecode) {
       offset++;
       break;
     case OP_JUMP: {
-      if (offset + 2 >= bytecode->count) {
+      if (offset + w >= bytecode->count) {
         printf("JUMP <invalid: out of bounds>\n");
         offset = bytecode->count;
         break;
       }
-      int16_t jump_offset = (int16_t)((bytecode->code[offset + 1] << 8) |
-                                      bytecode->code[offset + 2]);
-      printf("JUMP %d\n", jump_offset);
-      offset += 3;
+      printf("JUMP %d\n",
+             disasm_offset(bytecode->code, offset + 1, wide));
+      offset += 1 + w;
       break;
     }
     case OP_JUMP_IF_FALSE: {
-      if (offset + 2 >= bytecode->count) {
+      if (offset + w >= bytecode->count) {
         printf("JUMP_IF_FALSE <invalid: out of bounds>\n");
         offset = bytecode->count;
         break;
       }
-      uint16_t jump_offset = (uint16_t)((bytecode->code[offset + 1] << 8) |
-                                        bytecode->code[offset + 2]);
-      printf("JUMP_IF_FALSE %u\n", jump_offset);
-      offset += 3;
+      printf("JUMP_IF_FALSE %u\n",
+             disasm_operand(bytecode->code, offset + 1, wide));
+      offset += 1 + w;
       break;
     }
     case OP_DEFINE_FUNC: {
-      if (offset + 3 >= bytecode->count) {
+      if (offset + w + 1 >= bytecode->count) {
         printf("DEFINE_FUNC <invalid: out of bounds>\n");
         offset = bytecode->count;
         break;
       }
-      uint16_t name_idx = (uint16_t)(bytecode->code[offset + 1] << 8 |
-                                     bytecode->code[offset + 2]);
-      uint8_t param_count = bytecode->code[offset + 3];
-      size_t skip = 4 + (size_t)param_count * 2 + 2 + 2;
+      uint32_t name_idx = disasm_operand(bytecode->code, offset + 1, wide);
+      uint8_t param_count = bytecode->code[offset + 1 + w];
+      size_t table_pos = offset + 2 + w + (size_t)param_count * w;
+      if (table_pos + 1 >= bytecode->count) {
+        printf("DEFINE_FUNC %u (param_count=%u) <invalid: parameters out of "
+               "bounds>\n",
+               name_idx, param_count);
+        offset = bytecode->count;
+        break;
+      }
+      uint16_t local_count = (uint16_t)(bytecode->code[table_pos] << 8 |
+                                        bytecode->code[table_pos + 1]);
+      // Locals, body_start, then the embedded OP_JUMP and its offset
+      size_t skip = table_pos + 2 + (size_t)local_count * (2 * w + 1) + w +
+                    1 + w - offset;
       if (offset + skip > bytecode->count) {
         printf("DEFINE_FUNC %u (param_count=%u) <invalid: parameters out of "
                "bounds>\n",
@@ -2891,21 +4193,23 @@ void bytecode_print(Bytecode *bytecode) {
         offset = bytecode->count;
         break;
       }
-      printf("DEFINE_FUNC %u (param_count=%u)\n", name_idx, param_count);
+      printf("DEFINE_FUNC %u (param_count=%u, local_count=%u)\n", name_idx,
+             param_count, local_count);
       offset += skip;
       break;
     }
-    case OP_CALL_FUNC: {
-      if (offset + 3 >= bytecode->count) {
-        printf("CALL_FUNC <invalid: out of bounds>\n");
+    case OP_CALL_FUNC:
+    case OP_TAIL_CALL: {
+      const char *name = opcode_name(instruction);
+      if (offset + w + 1 >= bytecode->count) {
+        printf("%s <invalid: out of bounds>\n", name);
         offset = bytecode->count;
         break;
       }
-      uint16_t name_idx = (uint16_t)(bytecode->code[offset + 1] << 8 |
-                                     bytecode->code[offset + 2]);
-      uint8_t arg_count = bytecode->code[offset + 3];
-      printf("CALL_FUNC %u (arg_count=%u)\n", name_idx, arg_count);
-      offset += 4;
+      uint32_t name_idx = disasm_operand(bytecode->code, offset + 1, wide);
+      uint8_t arg_count = bytecode->code[offset + 1 + w];
+      printf("%s %u (arg_count=%u)\n", name, name_idx, arg_count);
+      offset += 2 + w;
       break;
     }
     case OP_RETURN_VAL:
@@ -2955,14 +4259,39 @@ void bytecode_print(Bytecode *bytecode) {
       offset++;
       break;
 
-    case OP_LIST_ITER:
-      printf("LIST_ITER\n");
-      offset++;
+    case OP_ITER_PREP: {
+      if (offset + w + 2 >= bytecode->count) {
+        printf("ITER_PREP <invalid: out of bounds>\n");
+        offset = bytecode->count;
+        break;
+      }
+      printf("ITER_PREP depth=%u pairs=%u exit=%u\n",
+             bytecode->code[offset + 1], bytecode->code[offset + 2],
+             disasm_operand(bytecode->code, offset + 3, wide));
+      offset += 3 + w;
       break;
+    }
 
-    case OP_LIST_NEXT:
-      printf("LIST_NEXT\n");
-      offset++;
+    case OP_ITER_NEXT: {
+      if (offset + w + 1 >= bytecode->count) {
+        printf("ITER_NEXT <invalid: out of bounds>\n");
+        offset = bytecode->count;
+        break;
+      }
+      printf("ITER_NEXT depth=%u back=%d\n", bytecode->code[offset + 1],
+             disasm_offset(bytecode->code, offset + 2, wide));
+      offset += 2 + w;
+      break;
+    }
+
+    case OP_ITER_CLOSE:
+      if (offset + 1 >= bytecode->count) {
+        printf("ITER_CLOSE <invalid: out of bounds>\n");
+        offset = bytecode->count;
+        break;
+      }
+      printf("ITER_CLOSE depth=%u\n", bytecode->code[offset + 1]);
+      offset += 2;
       break;
 
     case OP_RANGE_NEW:
@@ -2998,45 +4327,31 @@ void bytecode_print(Bytecode *bytecode) {
       offset++;
       break;
 
-    case OP_TRY_ENTER: {
-      if (offset + 2 >= bytecode->count) {
-        printf("TRY_ENTER <invalid: out of bounds>\n");
-        offset = bytecode->count;
-        break;
-      }
-      uint16_t handler_offset = (uint16_t)(bytecode->code[offset + 1] << 8 |
-                                           bytecode->code[offset + 2]);
-      printf("TRY_ENTER handler_offset=%u\n", handler_offset);
-      offset += 3;
-      break;
-    }
-
+    case OP_TRY_ENTER:
     case OP_TRY_EXIT: {
-      if (offset + 2 >= bytecode->count) {
-        printf("TRY_EXIT <invalid: out of bounds>\n");
+      bool is_enter = instruction == OP_TRY_ENTER;
+      if (offset + w >= bytecode->count) {
+        printf("%s <invalid: out of bounds>\n", opcode_name(instruction));
         offset = bytecode->count;
         break;
       }
-      uint16_t finally_offset = (uint16_t)(bytecode->code[offset + 1] << 8 |
-                                           bytecode->code[offset + 2]);
-      printf("TRY_EXIT finally_offset=%u\n", finally_offset);
-      offset += 3;
+      printf("%s %s=%u\n", opcode_name(instruction),
+             is_enter ? "handler_offset" : "finally_offset",
+             disasm_operand(bytecode->code, offset + 1, wide));
+      offset += 1 + w;
       break;
     }
 
     case OP_CATCH: {
-      if (offset + 4 >= bytecode->count) {
+      if (offset + 2 * w >= bytecode->count) {
         printf("CATCH <invalid: out of bounds>\n");
         offset = bytecode->count;
         break;
       }
-      uint16_t error_type_idx = (uint16_t)(bytecode->code[offset + 1] << 8 |
-                                           bytecode->code[offset + 2]);
-      uint16_t catch_var_idx = (uint16_t)(bytecode->code[offset + 3] << 8 |
-                                          bytecode->code[offset + 4]);
-      printf("CATCH error_type=%u catch_var=%u\n", error_type_idx,
-             catch_var_idx);
-      offset += 5;
+      printf("CATCH error_type=%u catch_var=%u\n",
+             disasm_operand(bytecode->code, offset + 1, wide),
+             disasm_operand(bytecode->code, offset + 1 + w, wide));
+      offset += 1 + 2 * w;
       break;
     }
 
@@ -3046,30 +4361,89 @@ void bytecode_print(Bytecode *bytecode) {
       break;
 
     case OP_THROW: {
-      if (offset + 2 >= bytecode->count) {
+      if (offset + w >= bytecode->count) {
         printf("THROW <invalid: out of bounds>\n");
         offset = bytecode->count;
         break;
       }
-      uint16_t error_type_idx = (uint16_t)(bytecode->code[offset + 1] << 8 |
-                                           bytecode->code[offset + 2]);
-      printf("THROW error_type=%u\n", error_type_idx);
-      offset += 3;
+      printf("THROW error_type=%u\n",
+             disasm_operand(bytecode->code, offset + 1, wide));
+      offset += 1 + w;
       break;
     }
 
     case OP_IMPORT: {
-      if (offset + 4 >= bytecode->count) {
+      if (offset + 2 * w >= bytecode->count) {
         printf("IMPORT <invalid: out of bounds>\n");
         offset = bytecode->count;
         break;
       }
-      uint16_t module_name_idx = (uint16_t)(bytecode->code[offset + 1] << 8 |
-                                            bytecode->code[offset + 2]);
-      uint16_t file_path_idx = (uint16_t)(bytecode->code[offset + 3] << 8 |
-                                          bytecode->code[offset + 4]);
-      printf("IMPORT module=%u file_path=%u\n", module_name_idx, file_path_idx);
-      offset += 5;
+      printf("IMPORT module=%u file_path=%u\n",
+             disasm_operand(bytecode->code, offset + 1, wide),
+             disasm_operand(bytecode->code, offset + 1 + w, wide));
+      offset += 1 + 2 * w;
+      break;
+    }
+
+    case OP_FOR_RANGE_PREP:
+    case OP_FOR_RANGE_NEXT: {
+      bool is_prep = instruction == OP_FOR_RANGE_PREP;
+      if (offset + w + 1 >= bytecode->count) {
+        printf("%s <invalid: out of bounds>\n",
+               is_prep ? "FOR_RANGE_PREP" : "FOR_RANGE_NEXT");
+        offset = bytecode->count;
+        break;
+      }
+      uint8_t depth = bytecode->code[offset + 1];
+      if (is_prep) {
+        printf("FOR_RANGE_PREP depth=%u exit=%u\n", depth,
+               disasm_operand(bytecode->code, offset + 2, wide));
+      } else {
+        printf("FOR_RANGE_NEXT depth=%u back=%d\n", depth,
+               disasm_offset(bytecode->code, offset + 2, wide));
+      }
+      offset += 2 + w;
+      break;
+    }
+
+    case OP_CMP_JUMP_IF_FALSE:
+    case OP_CMP_JUMP_IF_FALSE_NUM: {
+      if (offset + w + 1 >= bytecode->count) {
+        printf("%s <invalid: out of bounds>\n", opcode_name(instruction));
+        offset = bytecode->count;
+        break;
+      }
+      printf("%s %s %u\n", opcode_name(instruction),
+             opcode_name(bytecode->code[offset + 1]),
+             disasm_operand(bytecode->code, offset + 2, wide));
+      offset += 2 + w;
+      break;
+    }
+    case OP_INC_LOCAL_CONST: {
+      if (offset + w + 1 >= bytecode->count) {
+        printf("INC_LOCAL_CONST <invalid: out of bounds>\n");
+        offset = bytecode->count;
+        break;
+      }
+      printf("INC_LOCAL_CONST slot=%u step=%u\n", bytecode->code[offset + 1],
+             disasm_operand(bytecode->code, offset + 2, wide));
+      offset += 2 + w;
+      break;
+    }
+    case OP_INC_VAR_CONST:
+    case OP_INC_GLOBAL_CONST: {
+      bool by_name = instruction == OP_INC_VAR_CONST;
+      if (offset + 2 * w + 2 >= bytecode->count) {
+        printf("%s <invalid: out of bounds>\n", opcode_name(instruction));
+        offset = bytecode->count;
+        break;
+      }
+      uint32_t idx = disasm_operand(bytecode->code, offset + 1, wide);
+      uint32_t step_idx = disasm_operand(bytecode->code, offset + 1 + w, wide);
+      uint8_t has_type = bytecode->code[offset + 2 + 2 * w];
+      printf("%s %s=%u step=%u\n", opcode_name(instruction),
+             by_name ? "name" : "slot", idx, step_idx);
+      offset += 3 + 2 * w + (has_type ? w : 0);
       break;
     }
 
@@ -9,6 +9,10 @@ typedef enum {
   OP_LOAD_CONST,    // Load constant from pool
   OP_LOAD_VAR,      // Load variable
   OP_STORE_VAR,     // Store variable
+  OP_LOAD_LOCAL,    // Load function local from frame slot (arg: slot)
+  OP_STORE_LOCAL,   // Store function local into frame slot (arg: slot)
+  OP_LOAD_GLOBAL,   // Load global by VM slot index (rewritten from LOAD_VAR)
+  OP_STORE_GLOBAL,  // Store global by VM slot index (rewritten from STORE_VAR)
   OP_PRINT,         // Print top of stack
   OP_ADD,           // Binary add
   OP_SUB,           // Binary subtract
@@ -41,8 +45,10 @@ typedef enum {
   OP_LIST_APPEND,   // Append element (list, value -> list)
   OP_LIST_LEN,      // Get list/string length (list/string -> length)
   OP_LIST_SLICE,    // Slice list/string (container, start, end -> slice)
-  OP_LIST_ITER,     // Start list iteration (list -> iterator)
-  OP_LIST_NEXT,     // Get next item from iterator (iterator -> item, has_more)
+  OP_ITER_PREP,     // Start for-in loop (iterable -> first item; args: depth,
+                    // pairs, exit offset)
+  OP_ITER_NEXT,     // Advance for-in loop (-> item; args: depth, back offset)
+  OP_ITER_CLOSE,    // End for-in loop, dropping its container (arg: depth)
   OP_RANGE_NEW,     // Create new range (start, end, step -> range)
   OP_MAP_NEW,       // Create new map (arg: entry count)
   OP_MAP_SET,       // Set key-value pair (map, key, value -> map)
@@ -55,9 +61,62 @@ typedef enum {
   OP_THROW,         // Throw exception (error_message -> exception)
   OP_RETHROW,       // Rethrow current exception
   OP_IMPORT,        // Import module (module_name, file_path constants)
+  OP_FOR_RANGE_PREP, // Start range loop (start, end, step -> counter; args:
+                     // depth, exit offset)
+  OP_FOR_RANGE_NEXT, // Step range loop (-> counter; args: depth, back offset)
+  // Superinstructions: fused forms of the hottest opcode sequences (see
+  // scripts/profile_opcodes.sh); each behaves exactly like its expansion
+  OP_CMP_JUMP_IF_FALSE, // <cmp> JUMP_IF_FALSE (a, b -> ; args: comparison
+                        // opcode, offset)
+  OP_INC_LOCAL_CONST,   // LOAD_LOCAL s, LOAD_CONST k, ADD, STORE_LOCAL s
+                        // (args: slot, constant)
+  OP_INC_VAR_CONST,     // LOAD_VAR x, LOAD_CONST k, ADD, STORE_VAR x (args:
+                        // name, constant, STORE_VAR operands)
+  OP_INC_GLOBAL_CONST,  // OP_INC_VAR_CONST by global slot (rewritten from
+                        // INC_VAR_CONST)
+  // Quickened forms: emitted by the compiler where the operand types are
+  // provable, or written over the generic opcode by the VM after it sees
+  // such operands; a failed operand guard rewrites the generic opcode back
+  OP_ADD_NUM,              // OP_ADD on numbers
+  OP_SUB_NUM,              // OP_SUB on numbers
+  OP_MUL_NUM,              // OP_MUL on numbers
+  OP_GT_NUM,               // OP_GT on numbers
+  OP_LT_NUM,               // OP_LT on numbers
+  OP_GTE_NUM,              // OP_GTE on numbers
+  OP_LTE_NUM,              // OP_LTE on numbers
+  OP_CMP_JUMP_IF_FALSE_NUM, // OP_CMP_JUMP_IF_FALSE with an ordered
+                            // comparison on numbers
+  OP_INDEX_LIST,            // OP_LIST_GET on a list and a number index
+  OP_CONCAT_STR,            // OP_ADD on two strings
+  // Tail call: OP_CALL_FUNC that reuses the caller's frame when the callee
+  // is a user function (always followed by OP_RETURN_VAL)
+  OP_TAIL_CALL,
+  // Prefix: the next instruction's constant index, global slot and jump
+  // offset operands are 32-bit instead of 16-bit (emitted only where a
+  // value does not fit)
+  OP_WIDE,
   OP_HALT,          // End program
 } OpCode;
 
+// Number of opcodes (OP_HALT stays last)
+#define OPCODE_COUNT (OP_HALT + 1)
+
+// Optional constant operands (catch-all type, untyped local, ...) mark
+// "absent" with all bits set, so a narrow constant index stops below 0xFFFF
+#define NO_CONSTANT_NARROW 0xFFFFu
+#define NO_CONSTANT_WIDE 0xFFFFFFFFu
+
+// Function locals are addressed by a one-byte slot operand
+#define LOCAL_SLOTS_MAX 256
+
+// Range loops keep their counter, bound and step unboxed in a per-frame slot
+// indexed by nesting depth (a one-byte operand), so they nest this deep
+#define RANGE_LOOP_DEPTH_MAX 256
+
+// For-in loops keep a native iterator (container + cursor) in one of this
+// many per-frame slots, indexed by nesting depth
+#define ITER_LOOP_DEPTH_MAX 16
+
 // Bytecode representation
 typedef struct {
   uint8_t *code;
@@ -68,6 +127,24 @@ typedef struct {
   KronosValue **constants;
   size_t const_count;
   size_t const_capacity;
+
+  // Id (KronosVM.id) of the VM whose global slot indices have been patched
+  // into this code by OP_LOAD_GLOBAL/OP_STORE_GLOBAL rewriting (0 until the
+  // first rewrite). global_names maps each patched slot back to its name
+  // constant index, so any other VM running the code looks the global up
+  // by name instead
+  uint64_t global_owner;
+  uint32_t *global_names;
+  size_t global_name_capacity;
+
+  // Set by bytecode_verify() once every opcode, operand, jump target and
+  // constant index has been checked; the VM then decodes operands unchecked
+  bool verified;
+
+  // OP_CALL_FUNC inline cache side table, allocated by the VM on the first
+  // call executed from this code and indexed by call-site offset (freed
+  // with the bytecode)
+  struct CallSiteCache *call_cache;
 } Bytecode;
 
 /**
@@ -82,9 +159,10 @@ typedef struct {
  *   or internal compiler errors such as buffer growth failures).
  * - Never calls exit() or terminates the process; all errors are returned
  *   to the caller for graceful handling.
- * - When @p out_err is non-NULL, it is set to a static, human-readable
- *   error string on failure; the pointer remains valid for the lifetime
- *   of the process and must not be freed. On success, *out_err is set to NULL.
+ * - When @p out_err is non-NULL, it is set to a human-readable error string
+ *   on failure; the pointer remains valid until the next failed compile()
+ *   on the same thread and must not be freed. On success, *out_err is set
+ *   to NULL.
  *
  * @param ast Abstract syntax tree to compile (may be NULL).
  * @param out_err Optional location to store an error message on failure
@@ -122,6 +200,35 @@ void bytecode_free(Bytecode *bytecode);
  */
 void bytecode_print(Bytecode *bytecode);
 
+/**
+ * @brief Name of an opcode without its OP_ prefix (e.g. "LOAD_CONST").
+ *
+ * @param opcode Opcode byte
+ * @return Static string; "UNKNOWN" for bytes that are not opcodes.
+ */
+const char *opcode_name(uint8_t opcode);
+
+/**
+ * @brief Verify bytecode structure before execution.
+ *
+ * Walks every instruction once and checks that each opcode is valid, each
+ * operand fits inside the code buffer, each constant index refers to a
+ * non-NULL constant, and each jump/exception-handler target lands on an
+ * instruction boundary of the same code range (function bodies are checked
+ * as self-contained ranges). On success sets @p bytecode->verified so the VM
+ * can skip per-read bounds checks; on failure clears it and the VM keeps its
+ * defensive operand decoding.
+ *
+ * compile() runs this automatically; call it again for bytecode built or
+ * modified by other means.
+ *
+ * @param bytecode Bytecode to verify (may be NULL, which fails).
+ * @param out_err Optional location for a static description of the first
+ * problem found (set to NULL on success). Ignored when NULL.
+ * @return true if the bytecode is well-formed.
+ */
+bool bytecode_verify(Bytecode *bytecode, const char **out_err);
+
 /**
  * @brief Set a callback for compiler warnings.
  *
@@ -153,4 +260,50 @@ void bytecode_print(Bytecode *bytecode);
  */
 void compiler_set_warning_callback(void (*callback)(const char *message));
 
+/**
+ * @brief Set the optimization level used by subsequent compile() calls.
+ *
+ * - 0: emit bytecode exactly as the statements are written.
+ * - 1 (default): fold constant expressions, drop unreachable code and
+ *   constant branches, and thread jumps that land on unconditional jumps.
+ *
+ * Optimizations never change program output or which errors are reported
+ * (code in a dropped branch is still checked, then discarded).
+ *
+ * Thread-safety:
+ * - NOT thread-safe. Must not be called concurrently with compile(); the
+ *   level is a process-wide setting like the warning callback.
+ *
+ * @param level Optimization level (values above 1 behave like 1, negative
+ *              values like 0)
+ */
+void compiler_set_optimization_level(int level);
+
+/**
+ * @brief Enable or disable inlining (on by default, only at level 1).
+ *
+ * Calls made inside function bodies to a small function that calls
+ * nothing, defined once per compiled unit by a top-level statement, compile
+ * to the function's body. Disabling it keeps every call a real call (useful
+ * when debugging).
+ *
+ * Thread-safety: same as compiler_set_optimization_level().
+ *
+ * @param enabled Whether subsequent compile() calls inline
+ */
+void compiler_set_inlining(bool enabled);
+
+/**
+ * @brief Tell the compiler which function names are built-ins.
+ *
+ * The VM calls a built-in in preference to a user function of the same
+ * name, so such a user function is never inlined. Until a lookup is set,
+ * no call is inlined. vm_new() installs the VM's own table.
+ *
+ * Thread-safety: same as compiler_set_optimization_level().
+ *
+ * @param is_builtin Returns true for built-in names (NULL to clear)
+ */
+void compiler_set_builtin_lookup(bool (*is_builtin)(const char *name));
+
 #endif // KRONOS_COMPILER_H
@@ -0,0 +1,113 @@
+/**
+ * @file fold.c
+ * @brief Compile-time constant folding for Kronos expressions
+ *
+ * DESIGN DECISIONS:
+ * - Folds on the AST while compiling (the AST stays unmodified): a foldable
+ *   subtree is emitted as a single OP_LOAD_CONST.
+ * - Same results as the VM or no result: operations that would fail at
+ *   runtime keep failing at runtime, so folding never changes which errors
+ *   a program reports or when.
+ * - Number-to-string conversion is left to the VM (its formatting lives
+ *   there), so only string + string concatenation folds.
+ */
+
+#include "fold.h"
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+// A folded number with an exact constant form (-0 and NaN would not
+// survive constant pool deduplication)
+static KronosValue *fold_number(double value) {
+  if (isnan(value) || (value == 0.0 && signbit(value))) {
+    return NULL;
+  }
+  return value_new_number(value);
+}
+
+static KronosValue *fold_binary(BinOp op, KronosValue *a, KronosValue *b) {
+  bool numbers = value_is_number(a) && value_is_number(b);
+  double x = numbers ? value_as_number(a) : 0.0;
+  double y = numbers ? value_as_number(b) : 0.0;
+
+  switch (op) {
+  case BINOP_ADD:
+    if (numbers) {
+      return fold_number(x + y);
+    }
+    if (value_type(a) == VAL_STRING && value_type(b) == VAL_STRING) {
+      return value_new_string_concat(a->as.string.data, a->as.string.length,
+                                     b->as.string.data, b->as.string.length);
+    }
+    return NULL;
+  case BINOP_SUB:
+    return numbers ? fold_number(x - y) : NULL;
+  case BINOP_MUL:
+    return numbers ? fold_number(x * y) : NULL;
+  case BINOP_DIV:
+    return numbers && y != 0 ? fold_number(x / y) : NULL;
+  case BINOP_MOD:
+    return numbers && y != 0 ? fold_number(fmod(x, y)) : NULL;
+  case BINOP_EQ:
+    return value_new_bool(value_equals(a, b));
+  case BINOP_NEQ:
+    return value_new_bool(!value_equals(a, b));
+  case BINOP_GT:
+    return numbers ? value_new_bool(x > y) : NULL;
+  case BINOP_LT:
+    return numbers ? value_new_bool(x < y) : NULL;
+  case BINOP_GTE:
+    return numbers ? value_new_bool(x >= y) : NULL;
+  case BINOP_LTE:
+    return numbers ? value_new_bool(x <= y) : NULL;
+  case BINOP_AND:
+    // Both operands are always evaluated; constants have no side effects
+    return value_new_bool(value_is_truthy(a) && value_is_truthy(b));
+  case BINOP_OR:
+    return value_new_bool(value_is_truthy(a) || value_is_truthy(b));
+  default:
+    return NULL;
+  }
+}
+
+KronosValue *fold_constant(const ASTNode *node) {
+  if (!node) {
+    return NULL;
+  }
+
+  switch (node->type) {
+  case AST_NUMBER:
+    return value_new_number(node->as.number);
+  case AST_STRING:
+    return value_new_string(node->as.string.value, node->as.string.length);
+  case AST_BOOL:
+    return value_new_bool(node->as.boolean);
+  case AST_NULL:
+    return value_new_nil();
+  case AST_BINOP:
+    break;
+  default:
+    return NULL;
+  }
+
+  KronosValue *left = fold_constant(node->as.binop.left);
+  if (!left) {
+    return NULL;
+  }
+
+  KronosValue *result = NULL;
+  if (node->as.binop.op == BINOP_NOT) {
+    result = value_new_bool(!value_is_truthy(left));
+  } else if (node->as.binop.op == BINOP_NEG) {
+    result = value_is_number(left) ? fold_number(-value_as_number(left)) : NULL;
+  } else {
+    KronosValue *right = fold_constant(node->as.binop.right);
+    if (right) {
+      result = fold_binary(node->as.binop.op, left, right);
+      value_release(right);
+    }
+  }
+  value_release(left);
+  return result;
+}
@@ -0,0 +1,21 @@
+#ifndef KRONOS_FOLD_H
+#define KRONOS_FOLD_H
+
+#include "../core/runtime.h"
+#include "../frontend/parser.h"
+
+/**
+ * @brief Evaluate a constant expression at compile time
+ *
+ * Folds literals combined with arithmetic, comparison, logical and string
+ * `plus` operators, with exactly the VM's semantics. Anything whose result
+ * depends on runtime state, would raise an error (type mismatch, division
+ * by zero) or has no exact constant form (-0, NaN) is left alone.
+ *
+ * @param node Expression to evaluate (may be NULL)
+ * @return New reference to the value, or NULL if @p node is not a foldable
+ * constant
+ */
+KronosValue *fold_constant(const ASTNode *node);
+
+#endif // KRONOS_FOLD_H
@@ -0,0 +1,178 @@
+/**
+ * @file infer.c
+ * @brief Static expression type inference shared by the compiler and LSP
+ *
+ * DESIGN DECISIONS:
+ * - Sound rules only: a known result type must hold for every successful
+ *   evaluation, because the compiler uses it to pick typed opcodes. Where
+ *   the VM's result depends on runtime values (list elements, map values,
+ *   call results) the answer is TYPE_UNKNOWN.
+ * - Variables are resolved by a caller-supplied callback. The compiler only
+ *   knows the types of variables it can prove (range loop counters), the LSP
+ *   also trusts annotations and first assignments for its diagnostics.
+ */
+
+#include "infer.h"
+#include <string.h>
+
+ExprType infer_type_from_name(const char *type_name) {
+  if (!type_name) {
+    return TYPE_UNKNOWN;
+  }
+  if (strcmp(type_name, "number") == 0)
+    return TYPE_NUMBER;
+  if (strcmp(type_name, "string") == 0)
+    return TYPE_STRING;
+  if (strcmp(type_name, "list") == 0)
+    return TYPE_LIST;
+  if (strcmp(type_name, "map") == 0)
+    return TYPE_MAP;
+  if (strcmp(type_name, "bool") == 0)
+    return TYPE_BOOL;
+  return TYPE_UNKNOWN;
+}
+
+ExprType infer_expr_type(const ASTNode *node, InferVarFn lookup, void *ctx) {
+  if (!node)
+    return TYPE_UNKNOWN;
+
+  switch (node->type) {
+  case AST_NUMBER:
+    return TYPE_NUMBER;
+  case AST_STRING:
+  case AST_FSTRING:
+    return TYPE_STRING;
+  case AST_BOOL:
+    return TYPE_BOOL;
+  case AST_NULL:
+    return TYPE_NULL;
+  case AST_LIST:
+    return TYPE_LIST;
+  case AST_MAP:
+    return TYPE_MAP;
+  case AST_RANGE:
+    return TYPE_RANGE;
+  case AST_VAR:
+    return lookup ? lookup(node->as.var_name, ctx) : TYPE_UNKNOWN;
+  case AST_BINOP:
+    switch (node->as.binop.op) {
+    case BINOP_ADD: {
+      // Two numbers add; any other pair concatenates string forms
+      ExprType left = infer_expr_type(node->as.binop.left, lookup, ctx);
+      ExprType right = infer_expr_type(node->as.binop.right, lookup, ctx);
+      if (left == TYPE_NUMBER && right == TYPE_NUMBER)
+        return TYPE_NUMBER;
+      if ((left != TYPE_UNKNOWN && left != TYPE_NUMBER) ||
+          (right != TYPE_UNKNOWN && right != TYPE_NUMBER))
+        return TYPE_STRING;
+      return TYPE_UNKNOWN;
+    }
+    case BINOP_SUB:
+    case BINOP_MUL:
+    case BINOP_DIV:
+    case BINOP_MOD:
+    case BINOP_NEG:
+      // Fail at runtime unless every operand is a number
+      return TYPE_NUMBER;
+    case BINOP_EQ:
+    case BINOP_NEQ:
+    case BINOP_GT:
+    case BINOP_LT:
+    case BINOP_GTE:
+    case BINOP_LTE:
+    case BINOP_AND:
+    case BINOP_OR:
+    case BINOP_NOT:
+      return TYPE_BOOL;
+    default:
+      return TYPE_UNKNOWN;
+    }
+  case AST_INDEX:
+    // Strings index to one-character strings and ranges to numbers; list
+    // elements and map values can be anything
+    switch (infer_expr_type(node->as.index.list_expr, lookup, ctx)) {
+    case TYPE_STRING:
+      return TYPE_STRING;
+    case TYPE_RANGE:
+      return TYPE_NUMBER;
+    default:
+      return TYPE_UNKNOWN;
+    }
+  case AST_SLICE: {
+    // Slicing keeps the container type
+    ExprType container = infer_expr_type(node->as.slice.list_expr, lookup, ctx);
+    if (container == TYPE_LIST || container == TYPE_STRING ||
+        container == TYPE_RANGE)
+      return container;
+    return TYPE_UNKNOWN;
+  }
+  default:
+    return TYPE_UNKNOWN;
+  }
+}
+
+bool infer_block_assigns(ASTNode *const *block, size_t block_size,
+                         const char *name) {
+  for (size_t i = 0; i < block_size; i++) {
+    const ASTNode *node = block[i];
+    if (!node) {
+      continue;
+    }
+    switch (node->type) {
+    case AST_ASSIGN:
+      if (strcmp(node->as.assign.name, name) == 0)
+        return true;
+      break;
+    case AST_IF:
+      if (infer_block_assigns(node->as.if_stmt.block,
+                              node->as.if_stmt.block_size, name))
+        return true;
+      for (size_t j = 0; j < node->as.if_stmt.else_if_count; j++) {
+        if (infer_block_assigns(node->as.if_stmt.else_if_blocks[j],
+                                node->as.if_stmt.else_if_block_sizes[j], name))
+          return true;
+      }
+      if (infer_block_assigns(node->as.if_stmt.else_block,
+                              node->as.if_stmt.else_block_size, name))
+        return true;
+      break;
+    case AST_FOR:
+      if (strcmp(node->as.for_stmt.var, name) == 0 ||
+          (node->as.for_stmt.value_var &&
+           strcmp(node->as.for_stmt.value_var, name) == 0))
+        return true;
+      if (infer_block_assigns(node->as.for_stmt.block,
+                              node->as.for_stmt.block_size, name))
+        return true;
+      break;
+    case AST_WHILE:
+      if (infer_block_assigns(node->as.while_stmt.block,
+                              node->as.while_stmt.block_size, name))
+        return true;
+      break;
+    case AST_TRY:
+      if (infer_block_assigns(node->as.try_stmt.try_block,
+                              node->as.try_stmt.try_block_size, name))
+        return true;
+      for (size_t j = 0; j < node->as.try_stmt.catch_block_count; j++) {
+        const char *catch_var = node->as.try_stmt.catch_blocks[j].catch_var;
+        if (catch_var && strcmp(catch_var, name) == 0)
+          return true;
+        if (infer_block_assigns(
+                node->as.try_stmt.catch_blocks[j].catch_block,
+                node->as.try_stmt.catch_blocks[j].catch_block_size, name))
+          return true;
+      }
+      if (infer_block_assigns(node->as.try_stmt.finally_block,
+                              node->as.try_stmt.finally_block_size, name))
+        return true;
+      break;
+    case AST_IMPORT:
+      // Imports bind module and function names
+      return true;
+    default:
+      break;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,73 @@
+#ifndef KRONOS_INFER_H
+#define KRONOS_INFER_H
+
+#include "../frontend/parser.h"
+#include <stdbool.h>
+
+/**
+ * Static type of an expression
+ *
+ * A known type is a guarantee about the value an expression produces when it
+ * evaluates without error; TYPE_UNKNOWN means nothing is known.
+ */
+typedef enum {
+  TYPE_UNKNOWN,
+  TYPE_NUMBER,
+  TYPE_STRING,
+  TYPE_LIST,
+  TYPE_MAP,
+  TYPE_RANGE,
+  TYPE_BOOL,
+  TYPE_NULL
+} ExprType;
+
+/**
+ * @brief Resolves the type of a variable reference
+ *
+ * @param name Variable name
+ * @param ctx Caller context passed through infer_expr_type()
+ * @return Type the variable is known to hold, or TYPE_UNKNOWN
+ */
+typedef ExprType (*InferVarFn)(const char *name, void *ctx);
+
+/**
+ * @brief Infer the type of an expression
+ *
+ * Follows the VM's operator semantics: `plus` is a number only when both
+ * operands are numbers and a string as soon as either operand is known not
+ * to be one; the other arithmetic operators always produce numbers;
+ * comparisons and logical operators produce booleans. Variables are resolved
+ * through @p lookup, so the result is only as strong as what the caller
+ * knows about them.
+ *
+ * @param node Expression to type (may be NULL)
+ * @param lookup Variable resolver (NULL treats every variable as unknown)
+ * @param ctx Context passed to @p lookup
+ * @return Inferred type, TYPE_UNKNOWN when it cannot be determined
+ */
+ExprType infer_expr_type(const ASTNode *node, InferVarFn lookup, void *ctx);
+
+/**
+ * @brief Map a type annotation (`as number`, ...) to its ExprType
+ *
+ * @param type_name Annotation name (may be NULL)
+ * @return Matching type, or TYPE_UNKNOWN for NULL/unrecognized names
+ */
+ExprType infer_type_from_name(const char *type_name);
+
+/**
+ * @brief Whether a block may assign @p name
+ *
+ * Looks for assignments, loop variables and catch variables named @p name
+ * in the block and its nested control flow; nested function definitions are
+ * skipped (their names belong to another scope).
+ *
+ * @param block Statements to scan
+ * @param block_size Number of statements
+ * @param name Variable name
+ * @return true if any statement in the block binds @p name
+ */
+bool infer_block_assigns(ASTNode *const *block, size_t block_size,
+                         const char *name);
+
+#endif // KRONOS_INFER_H
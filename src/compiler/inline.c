@@ -0,0 +1,561 @@
+/**
+ * @file inline.c
+ * @brief Finds the small functions whose calls the compiler may inline
+ *
+ * DESIGN DECISIONS:
+ * - Proven unique, not guarded: the VM refuses to redefine a function, so a
+ *   function defined once per unit by a top-level statement is the callee of
+ *   every call compiled after that statement. Inlined code needs no runtime
+ *   check, and a conflicting definition from another unit (a second file or
+ *   REPL line on the same VM) fails before any inlined call runs.
+ * - Leaf functions only: a body that calls nothing cannot recurse, and
+ *   inlining never has to nest. A straight-line body (no branches, loops or
+ *   early returns) splices into any expression.
+ * - Renamed, not rebound: each local gets a hidden slot named
+ *   `(function.local)` in the caller. The body only reads locals it has
+ *   already assigned, so a stale value from an earlier call is never seen,
+ *   and every other name it reads is a global.
+ */
+
+#include "inline.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Largest body inlined, in AST nodes (statements plus expression nodes)
+#define INLINE_BODY_NODES_MAX 32
+
+struct InlineTable {
+  InlineCandidate *candidates; // Sorted by function name
+  size_t count;
+};
+
+typedef struct {
+  const char **items;
+  size_t count;
+  size_t capacity;
+} NameList;
+
+static bool name_list_contains(const NameList *list, const char *name) {
+  for (size_t i = 0; i < list->count; i++) {
+    if (strcmp(list->items[i], name) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool name_list_add(NameList *list, const char *name) {
+  if (list->count == list->capacity) {
+    size_t new_capacity = list->capacity == 0 ? 8 : list->capacity * 2;
+    const char **items = realloc(list->items, sizeof(char *) * new_capacity);
+    if (!items) {
+      return false;
+    }
+    list->items = items;
+    list->capacity = new_capacity;
+  }
+  list->items[list->count++] = name;
+  return true;
+}
+
+// A function definition found anywhere in the unit
+typedef struct {
+  const ASTNode *node;
+  bool top_level;
+} Definition;
+
+typedef struct {
+  Definition *items;
+  size_t count;
+  size_t capacity;
+  bool failed;
+} DefinitionList;
+
+static void collect_definitions(DefinitionList *list, ASTNode *const *block,
+                                size_t block_size, bool top_level);
+
+static void add_definition(DefinitionList *list, const ASTNode *node,
+                           bool top_level) {
+  if (list->count == list->capacity) {
+    size_t new_capacity = list->capacity == 0 ? 16 : list->capacity * 2;
+    Definition *items = realloc(list->items, sizeof(Definition) * new_capacity);
+    if (!items) {
+      list->failed = true;
+      return;
+    }
+    list->items = items;
+    list->capacity = new_capacity;
+  }
+  list->items[list->count++] = (Definition){node, top_level};
+}
+
+static void collect_definitions(DefinitionList *list, ASTNode *const *block,
+                                size_t block_size, bool top_level) {
+  for (size_t i = 0; i < block_size && !list->failed; i++) {
+    const ASTNode *node = block[i];
+    if (!node) {
+      continue;
+    }
+    switch (node->type) {
+    case AST_FUNCTION:
+      add_definition(list, node, top_level);
+      collect_definitions(list, node->as.function.block,
+                          node->as.function.block_size, false);
+      break;
+    case AST_IF:
+      collect_definitions(list, node->as.if_stmt.block,
+                          node->as.if_stmt.block_size, false);
+      for (size_t j = 0; j < node->as.if_stmt.else_if_count; j++) {
+        collect_definitions(list, node->as.if_stmt.else_if_blocks[j],
+                            node->as.if_stmt.else_if_block_sizes[j], false);
+      }
+      collect_definitions(list, node->as.if_stmt.else_block,
+                          node->as.if_stmt.else_block_size, false);
+      break;
+    case AST_FOR:
+      collect_definitions(list, node->as.for_stmt.block,
+                          node->as.for_stmt.block_size, false);
+      break;
+    case AST_WHILE:
+      collect_definitions(list, node->as.while_stmt.block,
+                          node->as.while_stmt.block_size, false);
+      break;
+    case AST_TRY:
+      collect_definitions(list, node->as.try_stmt.try_block,
+                          node->as.try_stmt.try_block_size, false);
+      for (size_t j = 0; j < node->as.try_stmt.catch_block_count; j++) {
+        collect_definitions(list, node->as.try_stmt.catch_blocks[j].catch_block,
+                            node->as.try_stmt.catch_blocks[j].catch_block_size,
+                            false);
+      }
+      collect_definitions(list, node->as.try_stmt.finally_block,
+                          node->as.try_stmt.finally_block_size, false);
+      break;
+    default:
+      break;
+    }
+  }
+}
+
+static int compare_definitions(const void *a, const void *b) {
+  const Definition *da = a;
+  const Definition *db = b;
+  return strcmp(da->node->as.function.name, db->node->as.function.name);
+}
+
+// Analysis of one function body
+typedef struct {
+  NameList targets; // Every assigned name
+  NameList locals;  // Parameters, then names assigned so far
+  NameList globals;
+  size_t nodes;
+} BodyInfo;
+
+// Check an expression the inlined body evaluates; counts its nodes
+static bool check_expression(BodyInfo *info, const ASTNode *node) {
+  if (!node) {
+    return true;
+  }
+  if (++info->nodes > INLINE_BODY_NODES_MAX) {
+    return false;
+  }
+
+  switch (node->type) {
+  case AST_NUMBER:
+  case AST_STRING:
+  case AST_BOOL:
+  case AST_NULL:
+    return true;
+  case AST_VAR: {
+    const char *name = node->as.var_name;
+    if (name_list_contains(&info->locals, name)) {
+      return true;
+    }
+    if (name_list_contains(&info->targets, name)) {
+      return false; // Local read before its first assignment
+    }
+    return name_list_contains(&info->globals, name) ||
+           name_list_add(&info->globals, name);
+  }
+  case AST_BINOP:
+    return check_expression(info, node->as.binop.left) &&
+           check_expression(info, node->as.binop.right);
+  case AST_LIST:
+    for (size_t i = 0; i < node->as.list.element_count; i++) {
+      if (!check_expression(info, node->as.list.elements[i])) {
+        return false;
+      }
+    }
+    return true;
+  case AST_RANGE:
+    return check_expression(info, node->as.range.start) &&
+           check_expression(info, node->as.range.end) &&
+           check_expression(info, node->as.range.step);
+  case AST_MAP:
+    for (size_t i = 0; i < node->as.map.entry_count; i++) {
+      if (!check_expression(info, node->as.map.keys[i]) ||
+          !check_expression(info, node->as.map.values[i])) {
+        return false;
+      }
+    }
+    return true;
+  case AST_INDEX:
+    return check_expression(info, node->as.index.list_expr) &&
+           check_expression(info, node->as.index.index);
+  case AST_SLICE:
+    return check_expression(info, node->as.slice.list_expr) &&
+           check_expression(info, node->as.slice.start) &&
+           check_expression(info, node->as.slice.end);
+  case AST_FSTRING:
+    for (size_t i = 0; i < node->as.fstring.part_count; i++) {
+      if (!check_expression(info, node->as.fstring.parts[i])) {
+        return false;
+      }
+    }
+    return true;
+  default:
+    return false; // Calls, and anything not plain data
+  }
+}
+
+static bool is_parameter(const ASTNode *function, const char *name) {
+  for (size_t i = 0; i < function->as.function.param_count; i++) {
+    if (strcmp(function->as.function.params[i], name) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Every assignment stores into an untyped local, and one declared with
+// `set` is assigned once (a call never reassigns it)
+static bool check_assignments(const ASTNode *function, BodyInfo *info) {
+  ASTNode *const *block = function->as.function.block;
+  size_t block_size = function->as.function.block_size;
+  for (size_t i = 0; i < block_size; i++) {
+    const ASTNode *node = block[i];
+    if (!node || node->type != AST_ASSIGN) {
+      continue;
+    }
+    const char *name = node->as.assign.name;
+    if (node->as.assign.type_name) {
+      return false;
+    }
+    if (is_parameter(function, name) ||
+        name_list_contains(&info->targets, name)) {
+      continue;
+    }
+    if (!node->as.assign.is_mutable) {
+      for (size_t j = i + 1; j < block_size; j++) {
+        if (block[j] && block[j]->type == AST_ASSIGN &&
+            strcmp(block[j]->as.assign.name, name) == 0) {
+          return false;
+        }
+      }
+    }
+    if (!name_list_add(&info->targets, name)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool check_body(const ASTNode *function, BodyInfo *info) {
+  for (size_t i = 0; i < function->as.function.param_count; i++) {
+    const char *param = function->as.function.params[i];
+    if (name_list_contains(&info->locals, param) ||
+        !name_list_add(&info->locals, param)) {
+      return false;
+    }
+  }
+  if (!check_assignments(function, info)) {
+    return false;
+  }
+
+  size_t block_size = function->as.function.block_size;
+  for (size_t i = 0; i < block_size; i++) {
+    const ASTNode *node = function->as.function.block[i];
+    if (!node || ++info->nodes > INLINE_BODY_NODES_MAX) {
+      return false;
+    }
+    switch (node->type) {
+    case AST_ASSIGN:
+      if (!check_expression(info, node->as.assign.value)) {
+        return false;
+      }
+      if (!name_list_contains(&info->locals, node->as.assign.name) &&
+          !name_list_add(&info->locals, node->as.assign.name)) {
+        return false;
+      }
+      break;
+    case AST_PRINT:
+      if (!check_expression(info, node->as.print.value)) {
+        return false;
+      }
+      break;
+    case AST_RETURN:
+      if (i + 1 != block_size || !node->as.return_stmt.value ||
+          !check_expression(info, node->as.return_stmt.value)) {
+        return false;
+      }
+      break;
+    default:
+      return false;
+    }
+  }
+  return true;
+}
+
+// Hidden storage name: "(function.local)"
+static char *hidden_name(const char *function, const char *local) {
+  size_t length = strlen(function) + strlen(local) + 4;
+  char *name = malloc(length);
+  if (name) {
+    snprintf(name, length, "(%s.%s)", function, local);
+  }
+  return name;
+}
+
+static void candidate_free(InlineCandidate *candidate) {
+  for (size_t i = 0; candidate->hidden && i < candidate->local_count; i++) {
+    free(candidate->hidden[i]);
+  }
+  free(candidate->hidden);
+  free(candidate->locals);
+  free(candidate->globals);
+}
+
+// Analyze @p function into @p out; false if it is not inlinable
+static bool make_candidate(const ASTNode *function,
+                           bool (*is_builtin)(const char *name),
+                           InlineCandidate *out) {
+  const char *name = function->as.function.name;
+  if (!name || strchr(name, '.') || is_builtin(name) ||
+      function->as.function.param_count > 255) {
+    return false;
+  }
+
+  BodyInfo info = {0};
+  bool ok = check_body(function, &info);
+  free(info.targets.items);
+  *out = (InlineCandidate){.function = function,
+                           .locals = info.locals.items,
+                           .local_count = info.locals.count,
+                           .globals = info.globals.items,
+                           .global_count = info.globals.count};
+  if (ok) {
+    out->hidden = calloc(out->local_count + 1, sizeof(char *));
+    ok = out->hidden != NULL;
+    for (size_t i = 0; ok && i < out->local_count; i++) {
+      out->hidden[i] = hidden_name(name, out->locals[i]);
+      ok = out->hidden[i] != NULL;
+    }
+  }
+  if (!ok) {
+    candidate_free(out);
+  }
+  return ok;
+}
+
+InlineTable *inline_table_build(const AST *ast,
+                                bool (*is_builtin)(const char *name)) {
+  if (!ast || !is_builtin) {
+    return NULL;
+  }
+  InlineTable *table = calloc(1, sizeof(InlineTable));
+  if (!table) {
+    return NULL;
+  }
+
+  DefinitionList definitions = {0};
+  collect_definitions(&definitions, ast->statements, ast->count, true);
+  if (definitions.failed) {
+    free(definitions.items);
+    return table;
+  }
+  if (definitions.count > 0) {
+    qsort(definitions.items, definitions.count, sizeof(Definition),
+          compare_definitions);
+    table->candidates = malloc(sizeof(InlineCandidate) * definitions.count);
+  }
+
+  // Sorted order keeps candidates sorted; a name defined twice is skipped
+  for (size_t i = 0; table->candidates && i < definitions.count;) {
+    size_t end = i + 1;
+    while (end < definitions.count &&
+           compare_definitions(&definitions.items[i],
+                               &definitions.items[end]) == 0) {
+      end++;
+    }
+    if (end == i + 1 && definitions.items[i].top_level &&
+        make_candidate(definitions.items[i].node, is_builtin,
+                       &table->candidates[table->count])) {
+      table->count++;
+    }
+    i = end;
+  }
+  free(definitions.items);
+  return table;
+}
+
+static int compare_candidate_name(const void *key, const void *element) {
+  const InlineCandidate *candidate = element;
+  return strcmp((const char *)key, candidate->function->as.function.name);
+}
+
+InlineCandidate *inline_table_find(InlineTable *table, const char *name) {
+  if (!table || table->count == 0 || !name) {
+    return NULL;
+  }
+  return bsearch(name, table->candidates, table->count,
+                 sizeof(InlineCandidate), compare_candidate_name);
+}
+
+const char *inline_hidden_name(const InlineCandidate *candidate,
+                               const char *name) {
+  for (size_t i = 0; i < candidate->local_count; i++) {
+    if (strcmp(candidate->locals[i], name) == 0) {
+      return candidate->hidden[i];
+    }
+  }
+  return NULL;
+}
+
+static void visit_expression(const ASTNode *node,
+                             void (*visit)(const ASTNode *call, void *ctx),
+                             void *ctx) {
+  if (!node) {
+    return;
+  }
+  switch (node->type) {
+  case AST_CALL:
+    visit(node, ctx);
+    for (size_t i = 0; i < node->as.call.arg_count; i++) {
+      visit_expression(node->as.call.args[i], visit, ctx);
+    }
+    break;
+  case AST_BINOP:
+    visit_expression(node->as.binop.left, visit, ctx);
+    visit_expression(node->as.binop.right, visit, ctx);
+    break;
+  case AST_LIST:
+    for (size_t i = 0; i < node->as.list.element_count; i++) {
+      visit_expression(node->as.list.elements[i], visit, ctx);
+    }
+    break;
+  case AST_RANGE:
+    visit_expression(node->as.range.start, visit, ctx);
+    visit_expression(node->as.range.end, visit, ctx);
+    visit_expression(node->as.range.step, visit, ctx);
+    break;
+  case AST_MAP:
+    for (size_t i = 0; i < node->as.map.entry_count; i++) {
+      visit_expression(node->as.map.keys[i], visit, ctx);
+      visit_expression(node->as.map.values[i], visit, ctx);
+    }
+    break;
+  case AST_INDEX:
+    visit_expression(node->as.index.list_expr, visit, ctx);
+    visit_expression(node->as.index.index, visit, ctx);
+    break;
+  case AST_SLICE:
+    visit_expression(node->as.slice.list_expr, visit, ctx);
+    visit_expression(node->as.slice.start, visit, ctx);
+    visit_expression(node->as.slice.end, visit, ctx);
+    break;
+  case AST_FSTRING:
+    for (size_t i = 0; i < node->as.fstring.part_count; i++) {
+      visit_expression(node->as.fstring.parts[i], visit, ctx);
+    }
+    break;
+  default:
+    break;
+  }
+}
+
+void inline_for_each_call(ASTNode *const *block, size_t block_size,
+                          void (*visit)(const ASTNode *call, void *ctx),
+                          void *ctx) {
+  for (size_t i = 0; i < block_size; i++) {
+    const ASTNode *node = block[i];
+    if (!node) {
+      continue;
+    }
+    switch (node->type) {
+    case AST_ASSIGN:
+      visit_expression(node->as.assign.value, visit, ctx);
+      break;
+    case AST_PRINT:
+      visit_expression(node->as.print.value, visit, ctx);
+      break;
+    case AST_CALL:
+      visit_expression(node, visit, ctx);
+      break;
+    case AST_RETURN:
+      visit_expression(node->as.return_stmt.value, visit, ctx);
+      break;
+    case AST_RAISE:
+      visit_expression(node->as.raise_stmt.message, visit, ctx);
+      break;
+    case AST_ASSIGN_INDEX:
+      visit_expression(node->as.assign_index.target, visit, ctx);
+      visit_expression(node->as.assign_index.index, visit, ctx);
+      visit_expression(node->as.assign_index.value, visit, ctx);
+      break;
+    case AST_DELETE:
+      visit_expression(node->as.delete_stmt.target, visit, ctx);
+      visit_expression(node->as.delete_stmt.key, visit, ctx);
+      break;
+    case AST_IF:
+      visit_expression(node->as.if_stmt.condition, visit, ctx);
+      inline_for_each_call(node->as.if_stmt.block, node->as.if_stmt.block_size,
+                           visit, ctx);
+      for (size_t j = 0; j < node->as.if_stmt.else_if_count; j++) {
+        visit_expression(node->as.if_stmt.else_if_conditions[j], visit, ctx);
+        inline_for_each_call(node->as.if_stmt.else_if_blocks[j],
+                             node->as.if_stmt.else_if_block_sizes[j], visit,
+                             ctx);
+      }
+      inline_for_each_call(node->as.if_stmt.else_block,
+                           node->as.if_stmt.else_block_size, visit, ctx);
+      break;
+    case AST_FOR:
+      visit_expression(node->as.for_stmt.iterable, visit, ctx);
+      visit_expression(node->as.for_stmt.end, visit, ctx);
+      visit_expression(node->as.for_stmt.step, visit, ctx);
+      inline_for_each_call(node->as.for_stmt.block,
+                           node->as.for_stmt.block_size, visit, ctx);
+      break;
+    case AST_WHILE:
+      visit_expression(node->as.while_stmt.condition, visit, ctx);
+      inline_for_each_call(node->as.while_stmt.block,
+                           node->as.while_stmt.block_size, visit, ctx);
+      break;
+    case AST_TRY:
+      inline_for_each_call(node->as.try_stmt.try_block,
+                           node->as.try_stmt.try_block_size, visit, ctx);
+      for (size_t j = 0; j < node->as.try_stmt.catch_block_count; j++) {
+        inline_for_each_call(node->as.try_stmt.catch_blocks[j].catch_block,
+                             node->as.try_stmt.catch_blocks[j].catch_block_size,
+                             visit, ctx);
+      }
+      inline_for_each_call(node->as.try_stmt.finally_block,
+                           node->as.try_stmt.finally_block_size, visit, ctx);
+      break;
+    default:
+      break; // Nested functions are compiled with their own scope
+    }
+  }
+}
+
+void inline_table_free(InlineTable *table) {
+  if (!table) {
+    return;
+  }
+  for (size_t i = 0; i < table->count; i++) {
+    candidate_free(&table->candidates[i]);
+  }
+  free(table->candidates);
+  free(table);
+}
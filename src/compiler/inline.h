@@ -0,0 +1,67 @@
+#ifndef KRONOS_INLINE_H
+#define KRONOS_INLINE_H
+
+#include "../frontend/parser.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * A function whose calls may be replaced by its body
+ *
+ * Locals are renamed to hidden slots of the caller named `(name.local)`.
+ */
+typedef struct {
+  const ASTNode *function; // AST_FUNCTION, a top-level statement
+  const char **locals;     // Parameters first, then assigned names (borrowed)
+  char **hidden;           // Hidden storage name of each local (owned)
+  size_t local_count;
+  const char **globals; // Other names the body reads (borrowed)
+  size_t global_count;
+  bool defined; // Set by the compiler once the definition is compiled
+} InlineCandidate;
+
+/** The inlinable functions of one compilation unit */
+typedef struct InlineTable InlineTable;
+
+/**
+ * @brief Find the functions of a unit that are safe to inline
+ *
+ * A candidate is defined exactly once in the unit, by a top-level
+ * statement, so every call compiled after that statement (and every call
+ * in a function defined after it) reaches that definition: the VM refuses
+ * to redefine a function, so a second definition from another unit fails
+ * before such a call can run. Its body is small and straight-line
+ * (assignments to untyped locals and prints, then an optional return) and
+ * calls nothing, so it is not recursive.
+ *
+ * @param ast Compilation unit
+ * @param is_builtin Names the VM resolves to a built-in before any user
+ *                   function (those are never candidates)
+ * @return Table (possibly empty), or NULL if out of memory
+ */
+InlineTable *inline_table_build(const AST *ast,
+                                bool (*is_builtin)(const char *name));
+
+/**
+ * @brief Candidate named @p name, or NULL
+ */
+InlineCandidate *inline_table_find(InlineTable *table, const char *name);
+
+/**
+ * @brief Hidden storage name of @p name if it is a local of @p candidate,
+ * otherwise NULL (the name is a global)
+ */
+const char *inline_hidden_name(const InlineCandidate *candidate,
+                               const char *name);
+
+/**
+ * @brief Visit every call in a block, including calls nested in
+ * expressions, but not those in nested function definitions
+ */
+void inline_for_each_call(ASTNode *const *block, size_t block_size,
+                          void (*visit)(const ASTNode *call, void *ctx),
+                          void *ctx);
+
+void inline_table_free(InlineTable *table);
+
+#endif // KRONOS_INLINE_H
@@ -0,0 +1,1978 @@
+/**
+ * @file ir.c
+ * @brief SSA intermediate representation of function bodies and the
+ * optimization passes that run on it
+ *
+ * DESIGN DECISIONS:
+ * - Function bodies only: locals are private to their frame (there are no
+ *   closures), so nothing but the function itself changes them, while any
+ *   call may change a global. Top-level code works on globals and keeps the
+ *   AST-level optimizations only.
+ * - Built straight from the AST with on-the-fly SSA construction (Braun et
+ *   al., "Simple and Efficient Construction of SSA Form"): a block is sealed
+ *   once all its predecessors are known, and trivial phis are removed. The
+ *   builder follows the compiler's -O1 code shape exactly (folded constants,
+ *   pruned branches, statements after a terminator, fused loop lowering),
+ *   so every value in the IR is evaluated where the bytecode evaluates it.
+ * - Lowered through the compiler's own emitters: the passes leave
+ *   per-AST-node actions (reuse a temp, skip a store, evaluate ahead of a
+ *   loop) rather than new code, so fused loops, typed opcodes and
+ *   superinstructions keep applying. Values reused across statements live
+ *   in hidden temp slots after the function's locals.
+ * - Conservative about what may change or fail: a local read before its
+ *   first assignment falls back to the global of that name, containers are
+ *   mutable, and most operators raise on bad operand types. Only values
+ *   that provably cannot change are reused, and only evaluations that
+ *   provably cannot fail are moved or removed.
+ */
+
+#include "ir.h"
+#include "compiler.h"
+#include "fold.h"
+#include "infer.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Larger bodies are compiled without the IR (bounds memory for the per-block
+// variable tables and recursion depth of variable lookups)
+#define IR_BLOCK_LIMIT 2048
+
+// Bodies with more values are compiled without the IR too (bounds the
+// compile time the passes add at -O1 on huge generated functions)
+#define IR_VALUE_LIMIT (32 * 1024)
+
+typedef struct IRBlock IRBlock;
+typedef struct IRValue IRValue;
+typedef struct IRLoop IRLoop;
+
+typedef enum {
+  IR_PARAM,  // Argument passed in
+  IR_UNDEF,  // Local not assigned yet (a read falls back to the global)
+  IR_CONST,  // Literal or folded constant expression
+  IR_LOOP,   // Value a loop binds to its variable (item or counter)
+  IR_PHI,    // Merge of a local's values where control flow joins
+  IR_READ,   // Read of a local (operand: the value it sees)
+  IR_OP,     // Operator (AST_BINOP), operands: its evaluated children
+  IR_EFFECT, // Anything else evaluated in place (calls, containers,
+             // indexing, global reads) and statements consuming values
+  IR_STORE,  // Assignment to a local (operand: the stored value)
+} IRKind;
+
+struct IRValue {
+  IRKind kind;
+  size_t id;             // Position in IRFunction.values
+  BinOp op;              // IR_OP
+  IRBlock *block;
+  size_t index;          // Position in its block (evaluation order)
+  const ASTNode *node;   // Expression, assignment or loop it comes from
+  int slot;              // Local (PARAM, UNDEF, LOOP, PHI, READ, STORE)
+  IRValue **operands;
+  size_t operand_count;
+  size_t operand_capacity;
+  IRValue *parent;       // Expression or statement consuming this value
+  IRValue *forward;      // Replacement of a removed trivial phi
+  KronosValue *constant; // IR_CONST (owned)
+  bool pinned;           // Compiled in a fused form: cannot be replaced
+  size_t size;           // Values in its expression tree
+  // Type inference
+  bool known; // Reached by inference (phis start unknown)
+  ExprType type;
+  bool defined; // Never the unassigned-local fallback
+  // Pass results
+  IRValue *copy; // IR_READ: value it sees through copy propagation
+  int copy_slot; // Local holding that value (-1 if none)
+  bool live;
+  bool dropped;  // Dead store that is not emitted
+  bool dead;     // Inside a dropped store (never evaluated)
+  size_t vn;     // Value number
+  IRValue *next_equal; // Next value with the same number
+  IRValue *leader;     // Dominating equal value reused here
+  bool applied;        // The reuse is emitted
+  bool suppressed;     // Not evaluated: an enclosing expression is reused
+  size_t saving;       // Leader: instructions its reuses save
+  IRLoop *hoist;       // Loop this value is evaluated ahead of
+  bool needs_temp;
+  size_t temp;
+};
+
+struct IRBlock {
+  size_t id; // Position in reverse postorder (assigned when started)
+  bool started;
+  bool sealed;
+  IRBlock **preds;
+  size_t pred_count;
+  size_t pred_capacity;
+  IRValue **values;
+  size_t value_count;
+  size_t value_capacity;
+  IRValue **incomplete; // Phis waiting for the block to be sealed
+  size_t incomplete_count;
+  size_t incomplete_capacity;
+  IRValue **defs; // Current value of each local at the end of the block
+  IRBlock *idom;
+  IRLoop *loop; // Innermost loop containing the block
+};
+
+struct IRLoop {
+  const ASTNode *node;
+  IRLoop *parent;
+  size_t first; // Ids of the first and last block of the loop
+  size_t last;
+  IRValue **hoisted;
+  size_t hoisted_count;
+  size_t hoisted_capacity;
+};
+
+struct IRFunction {
+  const IRLocal *locals;
+  size_t local_count;
+  IRBlock **blocks; // All blocks, in creation order
+  size_t block_count;
+  size_t block_capacity;
+  IRBlock **order; // Started blocks, in reverse postorder
+  size_t order_count;
+  size_t order_capacity;
+  IRValue **values; // All values, in creation order
+  size_t value_count;
+  size_t value_capacity;
+  IRLoop **loops; // Outer loops before inner ones
+  size_t loop_count;
+  size_t loop_capacity;
+  IRStats stats;
+  bool failed;
+};
+
+struct IRPlan {
+  const ASTNode **keys; // Open addressing on the node pointer
+  IRAction *actions;
+  size_t capacity;
+  IRHoist *hoists;
+  size_t temp_count;
+  IRStats stats;
+};
+
+// Grow *items (of item_size bytes) to hold at least count + 1 entries
+static bool ir_reserve(IRFunction *fn, void **items, size_t *capacity,
+                       size_t count, size_t item_size) {
+  if (fn->failed) {
+    return false;
+  }
+  if (count < *capacity) {
+    return true;
+  }
+  size_t new_capacity = *capacity == 0 ? 4 : *capacity * 2;
+  void *grown = realloc(*items, item_size * new_capacity);
+  if (!grown) {
+    fn->failed = true;
+    return false;
+  }
+  *items = grown;
+  *capacity = new_capacity;
+  return true;
+}
+
+// ---------------------------------------------------------------------------
+// Values and blocks
+// ---------------------------------------------------------------------------
+
+static IRValue *value_new(IRFunction *fn, IRKind kind, const ASTNode *node,
+                          int slot) {
+  if (fn->value_count >= IR_VALUE_LIMIT) {
+    fn->failed = true;
+    return NULL;
+  }
+  if (!ir_reserve(fn, (void **)&fn->values, &fn->value_capacity,
+                  fn->value_count, sizeof(IRValue *))) {
+    return NULL;
+  }
+  IRValue *value = calloc(1, sizeof(IRValue));
+  if (!value) {
+    fn->failed = true;
+    return NULL;
+  }
+  value->id = fn->value_count;
+  value->kind = kind;
+  value->node = node;
+  value->slot = slot;
+  value->copy_slot = -1;
+  value->size = 1;
+  fn->values[fn->value_count++] = value;
+  return value;
+}
+
+static void value_add_operand(IRFunction *fn, IRValue *value,
+                              IRValue *operand) {
+  if (!value || !operand ||
+      !ir_reserve(fn, (void **)&value->operands, &value->operand_capacity,
+                  value->operand_count, sizeof(IRValue *))) {
+    return;
+  }
+  value->operands[value->operand_count++] = operand;
+}
+
+// Add an operand evaluated as part of @p value's expression tree
+static void value_add_child(IRFunction *fn, IRValue *value, IRValue *child) {
+  if (!value || !child) {
+    return;
+  }
+  value_add_operand(fn, value, child);
+  child->parent = value;
+  value->size += child->size;
+}
+
+// Follow removed trivial phis to the value that replaced them
+static IRValue *resolve(IRValue *value) {
+  while (value && value->forward) {
+    value = value->forward;
+  }
+  return value;
+}
+
+// The value a read loads, after copy propagation
+static IRValue *read_source(const IRValue *read) {
+  return read->copy ? read->copy : resolve(read->operands[0]);
+}
+
+static IRBlock *block_new(IRFunction *fn) {
+  if (fn->block_count >= IR_BLOCK_LIMIT) {
+    fn->failed = true;
+    return NULL;
+  }
+  if (!ir_reserve(fn, (void **)&fn->blocks, &fn->block_capacity,
+                  fn->block_count, sizeof(IRBlock *))) {
+    return NULL;
+  }
+  IRBlock *block = calloc(1, sizeof(IRBlock));
+  IRValue **defs = calloc(fn->local_count ? fn->local_count : 1,
+                          sizeof(IRValue *));
+  if (!block || !defs) {
+    free(block);
+    free(defs);
+    fn->failed = true;
+    return NULL;
+  }
+  block->defs = defs;
+  fn->blocks[fn->block_count++] = block;
+  return block;
+}
+
+static void block_add_pred(IRFunction *fn, IRBlock *block, IRBlock *pred) {
+  if (!block || !pred ||
+      !ir_reserve(fn, (void **)&block->preds, &block->pred_capacity,
+                  block->pred_count, sizeof(IRBlock *))) {
+    return;
+  }
+  block->preds[block->pred_count++] = pred;
+}
+
+static void block_append(IRFunction *fn, IRBlock *block, IRValue *value) {
+  if (!block || !value ||
+      !ir_reserve(fn, (void **)&block->values, &block->value_capacity,
+                  block->value_count, sizeof(IRValue *))) {
+    return;
+  }
+  value->block = block;
+  value->index = block->value_count;
+  block->values[block->value_count++] = value;
+}
+
+static bool loop_contains(const IRLoop *loop, const IRBlock *block) {
+  return block->started && block->id >= loop->first &&
+         block->id <= loop->last;
+}
+
+// ---------------------------------------------------------------------------
+// SSA construction
+// ---------------------------------------------------------------------------
+
+static IRValue *read_variable(IRFunction *fn, IRBlock *block, int slot);
+
+// Replace a phi whose operands are all one value (or itself) by that value
+static IRValue *phi_remove_trivial(IRValue *phi) {
+  IRValue *same = NULL;
+  for (size_t i = 0; i < phi->operand_count; i++) {
+    IRValue *operand = resolve(phi->operands[i]);
+    if (operand == same || operand == phi) {
+      continue;
+    }
+    if (same) {
+      return phi;
+    }
+    same = operand;
+  }
+  if (!same) {
+    return phi; // Only reachable through itself
+  }
+  phi->forward = same;
+  return same;
+}
+
+static IRValue *phi_add_operands(IRFunction *fn, IRValue *phi) {
+  for (size_t i = 0; i < phi->block->pred_count; i++) {
+    value_add_operand(fn, phi,
+                      read_variable(fn, phi->block->preds[i], phi->slot));
+  }
+  return phi_remove_trivial(phi);
+}
+
+static IRValue *phi_new(IRFunction *fn, IRBlock *block, int slot) {
+  IRValue *phi = value_new(fn, IR_PHI, NULL, slot);
+  if (phi) {
+    phi->block = block;
+  }
+  return phi;
+}
+
+static IRValue *read_variable(IRFunction *fn, IRBlock *block, int slot) {
+  IRValue *value = resolve(block->defs[slot]);
+  if (value || fn->failed) {
+    return value;
+  }
+  if (!block->sealed) {
+    // Predecessors still to come: the operands are added on sealing
+    value = phi_new(fn, block, slot);
+    if (value &&
+        ir_reserve(fn, (void **)&block->incomplete,
+                   &block->incomplete_capacity, block->incomplete_count,
+                   sizeof(IRValue *))) {
+      block->incomplete[block->incomplete_count++] = value;
+    }
+  } else if (block->pred_count == 1) {
+    value = read_variable(fn, block->preds[0], slot);
+  } else {
+    // Break cycles through loops with the phi before reading operands
+    IRValue *phi = phi_new(fn, block, slot);
+    if (!phi) {
+      return NULL;
+    }
+    block->defs[slot] = phi;
+    value = phi_add_operands(fn, phi);
+  }
+  block->defs[slot] = value;
+  return value;
+}
+
+static void block_seal(IRFunction *fn, IRBlock *block) {
+  if (!block || block->sealed) {
+    return;
+  }
+  block->sealed = true;
+  for (size_t i = 0; i < block->incomplete_count; i++) {
+    phi_add_operands(fn, block->incomplete[i]);
+  }
+  free(block->incomplete);
+  block->incomplete = NULL;
+  block->incomplete_count = 0;
+  block->incomplete_capacity = 0;
+}
+
+// Remove phis that became trivial after their users were built
+static void remove_trivial_phis(IRFunction *fn) {
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t i = 0; i < fn->value_count; i++) {
+      IRValue *value = fn->values[i];
+      if (value->kind == IR_PHI && !value->forward &&
+          phi_remove_trivial(value) != value) {
+        changed = true;
+      }
+    }
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Building from the AST
+// ---------------------------------------------------------------------------
+
+typedef struct IRTargets {
+  IRBlock *break_block;
+  IRBlock *continue_block;
+  struct IRTargets *next;
+} IRTargets;
+
+typedef struct {
+  IRFunction *fn;
+  IRBlock *current; // NULL after a terminator (unreachable)
+  IRTargets *targets;
+  IRLoop *loop;
+  size_t range_depth;
+  size_t iter_depth;
+} IRBuilder;
+
+static void block_start(IRBuilder *b, IRBlock *block) {
+  IRFunction *fn = b->fn;
+  b->current = block;
+  if (!block || !ir_reserve(fn, (void **)&fn->order, &fn->order_capacity,
+                            fn->order_count, sizeof(IRBlock *))) {
+    b->current = NULL;
+    return;
+  }
+  block->started = true;
+  block->id = fn->order_count;
+  block->loop = b->loop;
+  fn->order[fn->order_count++] = block;
+}
+
+static int local_slot(const IRFunction *fn, const char *name) {
+  for (size_t i = fn->local_count; i > 0; i--) {
+    if (strcmp(fn->locals[i - 1].name, name) == 0) {
+      return (int)(i - 1);
+    }
+  }
+  return -1;
+}
+
+// Append a new value to the current block and make it the local's value
+static IRValue *define_local(IRBuilder *b, IRKind kind, const ASTNode *node,
+                             int slot) {
+  IRValue *value = value_new(b->fn, kind, node, slot);
+  block_append(b->fn, b->current, value);
+  if (value && b->current) {
+    b->current->defs[slot] = value;
+  }
+  return value;
+}
+
+// Truthiness of a constant condition: 1, 0, or -1 if not constant
+static int constant_truth(const ASTNode *condition) {
+  KronosValue *value = fold_constant(condition);
+  if (!value) {
+    return -1;
+  }
+  int truthy = value_is_truthy(value) ? 1 : 0;
+  value_release(value);
+  return truthy;
+}
+
+static bool is_comparison(BinOp op) {
+  return op == BINOP_EQ || op == BINOP_NEQ || op == BINOP_GT ||
+         op == BINOP_LT || op == BINOP_GTE || op == BINOP_LTE;
+}
+
+static IRValue *build_expression(IRBuilder *b, const ASTNode *node);
+
+static IRValue *build_constant(IRBuilder *b, const ASTNode *node,
+                               KronosValue *constant) {
+  if (!constant) {
+    b->fn->failed = true;
+    return NULL;
+  }
+  IRValue *value = value_new(b->fn, IR_CONST, node, -1);
+  if (!value) {
+    value_release(constant);
+    return NULL;
+  }
+  value->constant = constant;
+  block_append(b->fn, b->current, value);
+  return value;
+}
+
+static IRValue *build_read(IRBuilder *b, const ASTNode *node, int slot) {
+  IRFunction *fn = b->fn;
+  IRValue *read = value_new(fn, IR_READ, node, slot);
+  IRValue *seen = read_variable(fn, b->current, slot);
+  value_add_operand(fn, read, seen);
+  block_append(fn, b->current, read);
+  if (!read || !seen) {
+    return read;
+  }
+
+  // After `b to a`, note what `a` holds here; ir_propagate_copies()
+  // redirects the read if that is still the value that was copied
+  if (seen->kind == IR_STORE && seen->operand_count == 1 &&
+      seen->operands[0]->kind == IR_READ && !seen->operands[0]->pinned &&
+      seen->operands[0]->slot != slot) {
+    read->copy_slot = seen->operands[0]->slot;
+    read->copy = read_variable(fn, b->current, read->copy_slot);
+  }
+  return read;
+}
+
+// An evaluation whose result depends on more than its operands' values
+static IRValue *effect_new(IRBuilder *b, const ASTNode *node) {
+  return value_new(b->fn, IR_EFFECT, node, -1);
+}
+
+static void effect_add(IRBuilder *b, IRValue *effect, const ASTNode *child) {
+  value_add_child(b->fn, effect, build_expression(b, child));
+}
+
+static IRValue *effect_end(IRBuilder *b, IRValue *effect) {
+  block_append(b->fn, b->current, effect);
+  return effect;
+}
+
+/**
+ * @brief Build an expression, in the compiler's evaluation order
+ */
+static IRValue *build_expression(IRBuilder *b, const ASTNode *node) {
+  IRFunction *fn = b->fn;
+  if (!node || fn->failed) {
+    return NULL;
+  }
+
+  switch (node->type) {
+  case AST_NUMBER:
+  case AST_STRING:
+  case AST_BOOL:
+  case AST_NULL:
+    return build_constant(b, node, fold_constant(node));
+
+  case AST_BINOP: {
+    KronosValue *folded = fold_constant(node);
+    if (folded) {
+      return build_constant(b, node, folded);
+    }
+    IRValue *value = value_new(fn, IR_OP, node, -1);
+    if (!value) {
+      return NULL;
+    }
+    value->op = node->as.binop.op;
+    value_add_child(fn, value, build_expression(b, node->as.binop.left));
+    if (value->op != BINOP_NOT && value->op != BINOP_NEG) {
+      value_add_child(fn, value, build_expression(b, node->as.binop.right));
+    }
+    block_append(fn, b->current, value);
+    return value;
+  }
+
+  case AST_VAR: {
+    int slot = local_slot(fn, node->as.var_name);
+    if (slot >= 0) {
+      return build_read(b, node, slot);
+    }
+    return effect_end(b, effect_new(b, node)); // Global: any call changes it
+  }
+
+  case AST_FSTRING: {
+    IRValue *effect = effect_new(b, node);
+    for (size_t i = 0; i < node->as.fstring.part_count; i++) {
+      effect_add(b, effect, node->as.fstring.parts[i]);
+    }
+    return effect_end(b, effect);
+  }
+
+  case AST_LIST: {
+    IRValue *effect = effect_new(b, node);
+    for (size_t i = 0; i < node->as.list.element_count; i++) {
+      effect_add(b, effect, node->as.list.elements[i]);
+    }
+    return effect_end(b, effect);
+  }
+
+  case AST_MAP: {
+    IRValue *effect = effect_new(b, node);
+    for (size_t i = 0; i < node->as.map.entry_count; i++) {
+      effect_add(b, effect, node->as.map.keys[i]);
+      effect_add(b, effect, node->as.map.values[i]);
+    }
+    return effect_end(b, effect);
+  }
+
+  case AST_RANGE: {
+    IRValue *effect = effect_new(b, node);
+    effect_add(b, effect, node->as.range.start);
+    effect_add(b, effect, node->as.range.end);
+    effect_add(b, effect, node->as.range.step);
+    return effect_end(b, effect);
+  }
+
+  case AST_INDEX: {
+    IRValue *effect = effect_new(b, node);
+    effect_add(b, effect, node->as.index.list_expr);
+    effect_add(b, effect, node->as.index.index);
+    return effect_end(b, effect);
+  }
+
+  case AST_SLICE: {
+    IRValue *effect = effect_new(b, node);
+    effect_add(b, effect, node->as.slice.list_expr);
+    effect_add(b, effect, node->as.slice.start);
+    effect_add(b, effect, node->as.slice.end);
+    return effect_end(b, effect);
+  }
+
+  case AST_CALL: {
+    IRValue *effect = effect_new(b, node);
+    for (size_t i = 0; i < node->as.call.arg_count; i++) {
+      effect_add(b, effect, node->as.call.args[i]);
+    }
+    return effect_end(b, effect);
+  }
+
+  default:
+    fn->failed = true;
+    return NULL;
+  }
+}
+
+// A statement consuming the value of @p expr
+static void build_sink(IRBuilder *b, const ASTNode *stmt,
+                       const ASTNode *expr) {
+  IRValue *effect = effect_new(b, stmt);
+  effect_add(b, effect, expr);
+  effect_end(b, effect);
+}
+
+// A branch condition; a comparison is fused into the jump
+static void build_condition(IRBuilder *b, const ASTNode *stmt,
+                            const ASTNode *condition) {
+  IRValue *effect = effect_new(b, stmt);
+  IRValue *value = build_expression(b, condition);
+  if (value && value->kind == IR_OP && condition->as.binop.right &&
+      is_comparison(condition->as.binop.op)) {
+    value->pinned = true;
+  }
+  value_add_child(b->fn, effect, value);
+  effect_end(b, effect);
+}
+
+static void build_block(IRBuilder *b, ASTNode *const *block,
+                        size_t block_size);
+
+static void build_assign(IRBuilder *b, const ASTNode *node) {
+  IRFunction *fn = b->fn;
+  int slot = local_slot(fn, node->as.assign.name);
+  if (slot < 0) {
+    build_sink(b, node, node->as.assign.value);
+    return;
+  }
+
+  const ASTNode *value_node = node->as.assign.value;
+  IRValue *value;
+  if (value_node && value_node->type == AST_BINOP &&
+      value_node->as.binop.op == BINOP_ADD && value_node->as.binop.left &&
+      value_node->as.binop.left->type == AST_VAR &&
+      strcmp(value_node->as.binop.left->as.var_name, node->as.assign.name) ==
+          0 &&
+      value_node->as.binop.right &&
+      value_node->as.binop.right->type == AST_NUMBER) {
+    // `x to x + k` compiles to an increment superinstruction: its operands
+    // are never compiled on their own
+    value = value_new(fn, IR_OP, value_node, -1);
+    if (!value) {
+      return;
+    }
+    value->op = BINOP_ADD;
+    value->pinned = true;
+    IRValue *read = build_read(b, value_node->as.binop.left, slot);
+    if (read) {
+      read->pinned = true;
+      read->copy = NULL;
+      read->copy_slot = -1;
+    }
+    value_add_child(fn, value, read);
+    value_add_child(fn, value,
+                    build_expression(b, value_node->as.binop.right));
+    block_append(fn, b->current, value);
+  } else {
+    value = build_expression(b, value_node);
+  }
+
+  IRValue *store = value_new(fn, IR_STORE, node, slot);
+  value_add_child(fn, store, value);
+  block_append(fn, b->current, store);
+  if (store && b->current) {
+    b->current->defs[slot] = store;
+  }
+}
+
+static void build_if(IRBuilder *b, const ASTNode *node) {
+  IRFunction *fn = b->fn;
+  IRBlock *join = block_new(fn);
+  ASTNode **else_block = node->as.if_stmt.else_block;
+  size_t else_block_size = node->as.if_stmt.else_block_size;
+
+  // Constant conditions are pruned like compile_if_statement() does
+  size_t branch_count = 1 + node->as.if_stmt.else_if_count;
+  for (size_t i = 0; i < branch_count && b->current && !fn->failed; i++) {
+    const ASTNode *condition =
+        i == 0 ? node->as.if_stmt.condition
+               : node->as.if_stmt.else_if_conditions[i - 1];
+    ASTNode **block = i == 0 ? node->as.if_stmt.block
+                             : node->as.if_stmt.else_if_blocks[i - 1];
+    size_t block_size = i == 0 ? node->as.if_stmt.block_size
+                               : node->as.if_stmt.else_if_block_sizes[i - 1];
+    int truth = constant_truth(condition);
+    if (truth == 0) {
+      continue;
+    }
+    if (truth == 1) {
+      else_block = block;
+      else_block_size = block_size;
+      break;
+    }
+
+    build_condition(b, node, condition);
+    IRBlock *taken = block_new(fn);
+    IRBlock *next = block_new(fn);
+    block_add_pred(fn, taken, b->current);
+    block_add_pred(fn, next, b->current);
+    block_seal(fn, taken);
+    block_seal(fn, next);
+    block_start(b, taken);
+    build_block(b, block, block_size);
+    if (b->current) {
+      block_add_pred(fn, join, b->current);
+    }
+    block_start(b, next);
+  }
+
+  if (b->current) {
+    build_block(b, else_block, else_block_size);
+  }
+  if (b->current) {
+    block_add_pred(fn, join, b->current);
+  }
+  block_seal(fn, join);
+  if (join && join->pred_count > 0) {
+    block_start(b, join);
+  } else {
+    b->current = NULL;
+  }
+}
+
+static IRLoop *loop_new(IRBuilder *b, const ASTNode *node) {
+  IRFunction *fn = b->fn;
+  if (!ir_reserve(fn, (void **)&fn->loops, &fn->loop_capacity,
+                  fn->loop_count, sizeof(IRLoop *))) {
+    return NULL;
+  }
+  IRLoop *loop = calloc(1, sizeof(IRLoop));
+  if (!loop) {
+    fn->failed = true;
+    return NULL;
+  }
+  loop->node = node;
+  loop->parent = b->loop;
+  fn->loops[fn->loop_count++] = loop;
+  return loop;
+}
+
+static void build_while(IRBuilder *b, const ASTNode *node) {
+  IRFunction *fn = b->fn;
+  int truth = constant_truth(node->as.while_stmt.condition);
+  if (truth == 0) {
+    return; // The body is dead code
+  }
+
+  IRLoop *loop = loop_new(b, node);
+  IRBlock *header = block_new(fn);
+  IRBlock *exit = block_new(fn);
+  if (!loop || !header || !exit) {
+    return;
+  }
+  block_add_pred(fn, header, b->current);
+  IRTargets targets = {exit, header, b->targets};
+  b->targets = &targets;
+  b->loop = loop;
+
+  block_start(b, header);
+  loop->first = header->id;
+  if (truth < 0) {
+    build_condition(b, node, node->as.while_stmt.condition);
+    IRBlock *body = block_new(fn);
+    block_add_pred(fn, body, b->current);
+    block_add_pred(fn, exit, b->current);
+    block_seal(fn, body);
+    block_start(b, body);
+  }
+  build_block(b, node->as.while_stmt.block, node->as.while_stmt.block_size);
+  if (b->current) {
+    block_add_pred(fn, header, b->current);
+  }
+  block_seal(fn, header);
+  loop->last = fn->order_count - 1;
+
+  b->loop = loop->parent;
+  b->targets = targets.next;
+  block_seal(fn, exit);
+  if (exit->pred_count > 0) {
+    block_start(b, exit);
+  } else {
+    b->current = NULL;
+  }
+}
+
+/**
+ * @brief Build a fused range loop or an iterator loop
+ *
+ * The variable is bound afresh on every entry to the body; a range loop
+ * also stores the counter once more on exit (skipped by break).
+ */
+static void build_for(IRBuilder *b, const ASTNode *node) {
+  IRFunction *fn = b->fn;
+  bool is_range = node->as.for_stmt.is_range;
+  int slot = local_slot(fn, node->as.for_stmt.var);
+  int value_slot = node->as.for_stmt.value_var
+                       ? local_slot(fn, node->as.for_stmt.value_var)
+                       : -1;
+  if (slot < 0 || (node->as.for_stmt.value_var && value_slot < 0) ||
+      (is_range && b->range_depth >= RANGE_LOOP_DEPTH_MAX) ||
+      (!is_range && b->iter_depth >= ITER_LOOP_DEPTH_MAX)) {
+    fn->failed = true; // Loop nested too deeply or a compile error
+    return;
+  }
+
+  IRValue *operands = effect_new(b, node);
+  effect_add(b, operands, node->as.for_stmt.iterable);
+  if (is_range) {
+    effect_add(b, operands, node->as.for_stmt.end);
+    effect_add(b, operands, node->as.for_stmt.step);
+  }
+  effect_end(b, operands);
+
+  IRLoop *loop = loop_new(b, node);
+  IRBlock *pre = b->current;
+  IRBlock *body = block_new(fn);
+  IRBlock *latch = block_new(fn);
+  IRBlock *exit = block_new(fn);
+  IRBlock *after = is_range ? block_new(fn) : exit;
+  if (!loop || !body || !latch || !exit || !after) {
+    return;
+  }
+  block_add_pred(fn, body, pre);
+  block_add_pred(fn, exit, pre);
+  IRTargets targets = {after, latch, b->targets};
+  b->targets = &targets;
+  b->loop = loop;
+
+  block_start(b, body);
+  loop->first = body->id;
+  if (value_slot >= 0) {
+    define_local(b, IR_LOOP, node, value_slot);
+  }
+  define_local(b, IR_LOOP, node, slot);
+  if (is_range) {
+    b->range_depth++;
+  } else {
+    b->iter_depth++;
+  }
+  build_block(b, node->as.for_stmt.block, node->as.for_stmt.block_size);
+  if (is_range) {
+    b->range_depth--;
+  } else {
+    b->iter_depth--;
+  }
+  if (b->current) {
+    block_add_pred(fn, latch, b->current);
+  }
+  block_seal(fn, latch);
+  if (latch->pred_count > 0) {
+    block_start(b, latch);
+    block_add_pred(fn, body, latch);
+    block_add_pred(fn, exit, latch);
+  }
+  block_seal(fn, body);
+  loop->last = fn->order_count - 1;
+
+  b->loop = loop->parent;
+  b->targets = targets.next;
+  block_seal(fn, exit);
+  block_start(b, exit);
+  if (is_range) {
+    define_local(b, IR_LOOP, node, slot);
+    block_add_pred(fn, after, b->current);
+    block_seal(fn, after);
+    block_start(b, after);
+  }
+}
+
+static void build_jump(IRBuilder *b, bool is_break) {
+  if (!b->targets) {
+    b->fn->failed = true; // Compile error
+    return;
+  }
+  block_add_pred(b->fn,
+                 is_break ? b->targets->break_block
+                          : b->targets->continue_block,
+                 b->current);
+  b->current = NULL;
+}
+
+static void build_statement(IRBuilder *b, const ASTNode *node) {
+  if (!node) {
+    return;
+  }
+
+  switch (node->type) {
+  case AST_ASSIGN:
+    build_assign(b, node);
+    break;
+
+  case AST_PRINT:
+    build_sink(b, node, node->as.print.value);
+    break;
+
+  case AST_RETURN:
+    build_sink(b, node, node->as.return_stmt.value);
+    b->current = NULL;
+    break;
+
+  case AST_RAISE:
+    build_sink(b, node, node->as.raise_stmt.message);
+    b->current = NULL;
+    break;
+
+  case AST_CALL:
+    effect_end(b, build_expression(b, node));
+    break;
+
+  case AST_ASSIGN_INDEX: {
+    IRValue *effect = effect_new(b, node);
+    effect_add(b, effect, node->as.assign_index.target);
+    effect_add(b, effect, node->as.assign_index.index);
+    effect_add(b, effect, node->as.assign_index.value);
+    effect_end(b, effect);
+    break;
+  }
+
+  case AST_DELETE: {
+    IRValue *effect = effect_new(b, node);
+    effect_add(b, effect, node->as.delete_stmt.target);
+    effect_add(b, effect, node->as.delete_stmt.key);
+    effect_end(b, effect);
+    break;
+  }
+
+  case AST_IF:
+    build_if(b, node);
+    break;
+
+  case AST_WHILE:
+    build_while(b, node);
+    break;
+
+  case AST_FOR:
+    build_for(b, node);
+    break;
+
+  case AST_BREAK:
+    build_jump(b, true);
+    break;
+
+  case AST_CONTINUE:
+    build_jump(b, false);
+    break;
+
+  case AST_FUNCTION:
+    // Defines a global function; the body has its own frame
+    break;
+
+  case AST_NUMBER:
+  case AST_STRING:
+  case AST_FSTRING:
+  case AST_BOOL:
+  case AST_NULL:
+  case AST_VAR:
+  case AST_BINOP:
+  case AST_LIST:
+  case AST_RANGE:
+  case AST_MAP:
+  case AST_INDEX:
+  case AST_SLICE:
+    build_sink(b, NULL, node);
+    break;
+
+  default:
+    // try (exception edges), import (binds names)
+    b->fn->failed = true;
+    break;
+  }
+}
+
+static bool statement_terminates(const ASTNode *node) {
+  return node && (node->type == AST_BREAK || node->type == AST_CONTINUE ||
+                  node->type == AST_RAISE || node->type == AST_RETURN);
+}
+
+static void build_block(IRBuilder *b, ASTNode *const *block,
+                        size_t block_size) {
+  for (size_t i = 0; i < block_size && b->current && !b->fn->failed; i++) {
+    build_statement(b, block[i]);
+    if (statement_terminates(block[i])) {
+      return; // The rest is compiled as dead code
+    }
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Analyses
+// ---------------------------------------------------------------------------
+
+static IRBlock *dominator_intersect(IRBlock *a, IRBlock *b) {
+  while (a != b) {
+    while (a->id > b->id) {
+      a = a->idom;
+    }
+    while (b->id > a->id) {
+      b = b->idom;
+    }
+  }
+  return a;
+}
+
+// Cooper, Harvey and Kennedy, "A Simple, Fast Dominance Algorithm"
+static void compute_dominators(IRFunction *fn) {
+  IRBlock *entry = fn->order[0];
+  entry->idom = entry;
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (size_t i = 1; i < fn->order_count; i++) {
+      IRBlock *block = fn->order[i];
+      IRBlock *idom = NULL;
+      for (size_t j = 0; j < block->pred_count; j++) {
+        IRBlock *pred = block->preds[j];
+        if (!pred->idom) {
+          continue;
+        }
+        idom = idom ? dominator_intersect(pred, idom) : pred;
+      }
+      if (idom != block->idom) {
+        block->idom = idom;
+        changed = true;
+      }
+    }
+  }
+}
+
+static bool block_dominates(const IRBlock *a, const IRBlock *b) {
+  while (b->id > a->id) {
+    b = b->idom;
+  }
+  return a == b;
+}
+
+static bool value_dominates(const IRValue *a, const IRValue *b) {
+  if (a->block == b->block) {
+    return a->index < b->index;
+  }
+  return block_dominates(a->block, b->block);
+}
+
+static ExprType constant_type(const KronosValue *constant) {
+  switch (value_type(constant)) {
+  case VAL_NUMBER:
+    return TYPE_NUMBER;
+  case VAL_STRING:
+    return TYPE_STRING;
+  case VAL_BOOL:
+    return TYPE_BOOL;
+  case VAL_NIL:
+    return TYPE_NULL;
+  default:
+    return TYPE_UNKNOWN;
+  }
+}
+
+// Types that cannot change after the value is created
+static bool is_immutable_type(ExprType type) {
+  return type == TYPE_NUMBER || type == TYPE_STRING || type == TYPE_BOOL ||
+         type == TYPE_NULL;
+}
+
+// Transfer function of type inference (same rules as infer.c)
+static void infer_value(const IRValue *value, bool *known, ExprType *type,
+                        bool *defined) {
+  *known = true;
+  *type = TYPE_UNKNOWN;
+  *defined = true;
+  switch (value->kind) {
+  case IR_PARAM:
+    break;
+  case IR_UNDEF:
+    *defined = false;
+    break;
+  case IR_CONST:
+    *type = constant_type(value->constant);
+    break;
+  case IR_LOOP:
+    *type = value->node->as.for_stmt.is_range ? TYPE_NUMBER : TYPE_UNKNOWN;
+    break;
+  case IR_READ:
+  case IR_STORE: {
+    const IRValue *source = resolve(value->operands[0]);
+    *known = source->known;
+    *type = source->type;
+    *defined = value->kind == IR_STORE || source->defined;
+    break;
+  }
+  case IR_PHI: {
+    *known = false;
+    for (size_t i = 0; i < value->operand_count; i++) {
+      const IRValue *operand = resolve(value->operands[i]);
+      if (!operand->known) {
+        continue; // Optimistic: not reached yet
+      }
+      *type = !*known || operand->type == *type ? operand->type
+                                                 : TYPE_UNKNOWN;
+      *known = true;
+      *defined = *defined && operand->defined;
+    }
+    break;
+  }
+  case IR_OP: {
+    for (size_t i = 0; i < value->operand_count; i++) {
+      if (!resolve(value->operands[i])->known) {
+        *known = false;
+        return;
+      }
+    }
+    switch (value->op) {
+    case BINOP_ADD: {
+      ExprType left = resolve(value->operands[0])->type;
+      ExprType right = resolve(value->operands[1])->type;
+      if (left == TYPE_NUMBER && right == TYPE_NUMBER) {
+        *type = TYPE_NUMBER;
+      } else if ((left != TYPE_UNKNOWN && left != TYPE_NUMBER) ||
+                 (right != TYPE_UNKNOWN && right != TYPE_NUMBER)) {
+        *type = TYPE_STRING;
+      }
+      break;
+    }
+    case BINOP_SUB:
+    case BINOP_MUL:
+    case BINOP_DIV:
+    case BINOP_MOD:
+    case BINOP_NEG:
+      *type = TYPE_NUMBER;
+      break;
+    default:
+      *type = TYPE_BOOL;
+      break;
+    }
+    break;
+  }
+  case IR_EFFECT:
+    // Variables are not looked up: a global can change on any call
+    *type = value->node ? infer_expr_type(value->node, NULL, NULL)
+                        : TYPE_UNKNOWN;
+    break;
+  }
+}
+
+// FIFO of values to (re)visit; each value is queued at most once at a time
+typedef struct {
+  IRValue **items;
+  bool *queued; // By value id
+  size_t capacity;
+  size_t head;
+  size_t count;
+} IRWorklist;
+
+static void worklist_push(IRWorklist *list, IRValue *value) {
+  if (value->forward || list->queued[value->id]) {
+    return;
+  }
+  list->queued[value->id] = true;
+  list->items[(list->head + list->count++) % list->capacity] = value;
+}
+
+static IRValue *worklist_pop(IRWorklist *list) {
+  IRValue *value = list->items[list->head];
+  list->head = (list->head + 1) % list->capacity;
+  list->count--;
+  list->queued[value->id] = false;
+  return value;
+}
+
+// Record the inferred facts of @p value; returns whether any changed
+static bool infer_update(IRValue *value) {
+  bool known;
+  ExprType type;
+  bool defined;
+  infer_value(value, &known, &type, &defined);
+  if (!known) {
+    return false;
+  }
+  if (!value->known) {
+    value->known = true;
+    value->type = type;
+    value->defined = defined;
+    return true;
+  }
+  bool changed = false;
+  if (value->type != type && value->type != TYPE_UNKNOWN) {
+    value->type = TYPE_UNKNOWN;
+    changed = true;
+  }
+  if (value->defined && !defined) {
+    value->defined = false;
+    changed = true;
+  }
+  return changed;
+}
+
+/**
+ * @brief Infer value types and definedness to a fixed point
+ *
+ * Phis start optimistic (unknown, defined) and only ever move towards
+ * TYPE_UNKNOWN and undefined, so loops converge. Values are visited from a
+ * worklist seeded in reverse postorder, and a value whose facts change
+ * requeues its users, so each value is revisited a bounded number of times.
+ *
+ * @return false on allocation failure
+ */
+static bool infer_types(IRFunction *fn) {
+  size_t count = fn->value_count;
+  size_t slots = count ? count : 1;
+
+  // Users of each value: users[first_user[id] .. first_user[id + 1])
+  size_t *first_user = calloc(count + 1, sizeof(size_t));
+  IRWorklist list = {malloc(slots * sizeof(IRValue *)),
+                     calloc(slots, sizeof(bool)), slots, 0, 0};
+  IRValue **users = NULL;
+  size_t use_count = 0;
+  if (first_user && list.items && list.queued) {
+    for (size_t i = 0; i < count; i++) {
+      IRValue *value = fn->values[i];
+      for (size_t j = 0; !value->forward && j < value->operand_count; j++) {
+        first_user[resolve(value->operands[j])->id]++;
+        use_count++;
+      }
+    }
+    users = malloc((use_count ? use_count : 1) * sizeof(IRValue *));
+  }
+  if (!users) {
+    free(first_user);
+    free(list.items);
+    free(list.queued);
+    return false;
+  }
+  for (size_t i = 1; i < count; i++) {
+    first_user[i] += first_user[i - 1];
+  }
+  first_user[count] = use_count;
+  for (size_t i = 0; i < count; i++) {
+    IRValue *value = fn->values[i];
+    for (size_t j = 0; !value->forward && j < value->operand_count; j++) {
+      users[--first_user[resolve(value->operands[j])->id]] = value;
+    }
+  }
+
+  // Evaluation order first (operands before their users), then the phis
+  // and anything outside the started blocks
+  for (size_t i = 0; i < fn->order_count; i++) {
+    IRBlock *block = fn->order[i];
+    for (size_t j = 0; j < block->value_count; j++) {
+      worklist_push(&list, block->values[j]);
+    }
+  }
+  for (size_t i = 0; i < count; i++) {
+    worklist_push(&list, fn->values[i]);
+  }
+  while (list.count > 0) {
+    IRValue *value = worklist_pop(&list);
+    if (!infer_update(value)) {
+      continue;
+    }
+    for (size_t i = first_user[value->id]; i < first_user[value->id + 1];
+         i++) {
+      worklist_push(&list, users[i]);
+    }
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    IRValue *value = fn->values[i];
+    if (!value->known) {
+      value->known = true;
+      value->type = TYPE_UNKNOWN;
+      value->defined = false;
+    }
+  }
+  free(first_user);
+  free(users);
+  free(list.items);
+  free(list.queued);
+  return true;
+}
+
+/**
+ * @brief Whether an operator's value depends only on its operands' values
+ *
+ * Arithmetic and ordered comparisons only succeed on numbers. `plus`,
+ * equality and the logical operators also accept containers, whose
+ * contents (and so the result) can change.
+ */
+static bool op_is_pure(const IRValue *value) {
+  if (value->kind != IR_OP || value->pinned || value->dead) {
+    return false;
+  }
+  switch (value->op) {
+  case BINOP_SUB:
+  case BINOP_MUL:
+  case BINOP_DIV:
+  case BINOP_MOD:
+  case BINOP_NEG:
+  case BINOP_GT:
+  case BINOP_LT:
+  case BINOP_GTE:
+  case BINOP_LTE:
+    return true;
+  default:
+    for (size_t i = 0; i < value->operand_count; i++) {
+      if (!is_immutable_type(value->operands[i]->type)) {
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
+static bool is_nonzero_number(const IRValue *value) {
+  return value->kind == IR_CONST && value_is_number(value->constant) &&
+         value_as_number(value->constant) != 0;
+}
+
+// Whether evaluating the operator itself can raise an error
+static bool op_never_fails(const IRValue *value) {
+  for (size_t i = 0; i < value->operand_count; i++) {
+    if (!value->operands[i]->defined) {
+      return false;
+    }
+  }
+  const IRValue *left = value->operands[0];
+  const IRValue *right = value->operand_count > 1 ? value->operands[1] : NULL;
+  switch (value->op) {
+  case BINOP_SUB:
+  case BINOP_MUL:
+  case BINOP_GT:
+  case BINOP_LT:
+  case BINOP_GTE:
+  case BINOP_LTE:
+    return left->type == TYPE_NUMBER && right->type == TYPE_NUMBER;
+  case BINOP_NEG:
+    return left->type == TYPE_NUMBER;
+  case BINOP_DIV:
+  case BINOP_MOD:
+    return left->type == TYPE_NUMBER && is_nonzero_number(right);
+  default:
+    return true; // plus, equality and logic accept any values
+  }
+}
+
+// Whether skipping an evaluation cannot be observed
+static bool value_droppable(const IRValue *value) {
+  switch (value->kind) {
+  case IR_CONST:
+    return true;
+  case IR_READ:
+    return !value->pinned && read_source(value)->defined;
+  case IR_OP:
+    if (value->pinned || !op_never_fails(value)) {
+      return false;
+    }
+    for (size_t i = 0; i < value->operand_count; i++) {
+      if (!value_droppable(value->operands[i])) {
+        return false;
+      }
+    }
+    return true;
+  default:
+    return false;
+  }
+}
+
+static void mark_dead(IRValue *value) {
+  value->dead = true;
+  for (size_t i = 0; i < value->operand_count; i++) {
+    if (value->operands[i]->parent == value) {
+      mark_dead(value->operands[i]);
+    }
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Passes
+// ---------------------------------------------------------------------------
+
+void ir_propagate_copies(IRFunction *fn) {
+  if (!fn) {
+    return;
+  }
+  for (size_t i = 0; i < fn->value_count; i++) {
+    IRValue *read = fn->values[i];
+    if (read->kind != IR_READ || read->copy_slot < 0) {
+      continue;
+    }
+    // The store `b to a` and what its read of `a` saw
+    IRValue *store = resolve(read->operands[0]);
+    IRValue *copied = resolve(store->operands[0]->operands[0]);
+    IRValue *current = resolve(read->copy);
+    if (current == copied && copied->defined) {
+      read->copy = current;
+      fn->stats.copies++;
+    } else {
+      read->copy = NULL;
+      read->copy_slot = -1;
+    }
+  }
+}
+
+void ir_eliminate_dead_stores(IRFunction *fn) {
+  if (!fn) {
+    return;
+  }
+  IRValue **worklist = malloc(sizeof(IRValue *) * (fn->value_count + 1));
+  if (!worklist) {
+    fn->failed = true;
+    return;
+  }
+  size_t count = 0;
+
+  // Roots: side effects, and stores that may fail or are not removable
+  for (size_t i = 0; i < fn->value_count; i++) {
+    IRValue *value = fn->values[i];
+    bool root = value->kind == IR_EFFECT ||
+                (value->kind == IR_STORE &&
+                 (!fn->locals[value->slot].removable ||
+                  !value_droppable(value->operands[0])));
+    if (root && !value->forward) {
+      value->live = true;
+      worklist[count++] = value;
+    }
+  }
+
+  while (count > 0) {
+    IRValue *value = worklist[--count];
+    for (size_t i = 0; i < value->operand_count; i++) {
+      IRValue *operand = resolve(value->operands[i]);
+      if (value->kind == IR_READ) {
+        operand = read_source(value);
+      }
+      if (!operand->live) {
+        operand->live = true;
+        worklist[count++] = operand;
+      }
+    }
+  }
+  free(worklist);
+
+  for (size_t i = 0; i < fn->value_count; i++) {
+    IRValue *value = fn->values[i];
+    if (value->kind == IR_STORE && !value->live) {
+      value->dropped = true;
+      mark_dead(value);
+      fn->stats.dropped++;
+    }
+  }
+}
+
+// Key of a pure operator for value numbering
+typedef struct {
+  BinOp op;
+  size_t left;
+  size_t right;
+  size_t vn;
+} OpKey;
+
+static size_t op_key_hash(BinOp op, size_t left, size_t right) {
+  size_t hash = (size_t)op * 31u + left;
+  return hash * 1000003u + right;
+}
+
+static bool is_commutative(BinOp op) {
+  // `plus` concatenates strings, so it is not
+  return op == BINOP_MUL || op == BINOP_EQ || op == BINOP_NEQ ||
+         op == BINOP_AND || op == BINOP_OR;
+}
+
+/**
+ * @brief Number values so that equal numbers mean equal values
+ *
+ * Reads of a defined value, stores and copies share the number of what
+ * they hold; equal constants share one; pure operators on equal operands
+ * share one. Everything else (phis, calls, reads that may fall back to a
+ * global) gets a number of its own.
+ */
+static bool number_values(IRFunction *fn, size_t *count) {
+  size_t next = 1;
+  for (size_t i = 0; i < fn->value_count; i++) {
+    fn->values[i]->vn = next++;
+  }
+
+  size_t capacity = 16;
+  while (capacity < fn->value_count * 2) {
+    capacity *= 2;
+  }
+  OpKey *keys = calloc(capacity, sizeof(OpKey));
+  IRValue **constants = malloc(sizeof(IRValue *) * (fn->value_count + 1));
+  if (!keys || !constants) {
+    free(keys);
+    free(constants);
+    fn->failed = true;
+    return false;
+  }
+  size_t constant_count = 0;
+
+  for (size_t b = 0; b < fn->order_count; b++) {
+    IRBlock *block = fn->order[b];
+    for (size_t i = 0; i < block->value_count; i++) {
+      IRValue *value = block->values[i];
+      if (value->dead) {
+        continue;
+      }
+      switch (value->kind) {
+      case IR_READ: {
+        IRValue *source = read_source(value);
+        if (source->defined) {
+          value->vn = source->vn;
+        }
+        break;
+      }
+      case IR_STORE:
+        value->vn = value->operands[0]->vn;
+        break;
+      case IR_CONST: {
+        size_t j = 0;
+        for (; j < constant_count; j++) {
+          KronosValue *other = constants[j]->constant;
+          if (value_type(other) == value_type(value->constant) &&
+              value_equals(other, value->constant)) {
+            value->vn = constants[j]->vn;
+            break;
+          }
+        }
+        if (j == constant_count) {
+          constants[constant_count++] = value;
+        }
+        break;
+      }
+      case IR_OP: {
+        if (!op_is_pure(value)) {
+          break;
+        }
+        size_t left = value->operands[0]->vn;
+        size_t right =
+            value->operand_count > 1 ? value->operands[1]->vn : 0;
+        if (is_commutative(value->op) && right < left) {
+          size_t swap = left;
+          left = right;
+          right = swap;
+        }
+        size_t slot = op_key_hash(value->op, left, right) & (capacity - 1);
+        while (keys[slot].vn != 0 &&
+               (keys[slot].op != value->op || keys[slot].left != left ||
+                keys[slot].right != right)) {
+          slot = (slot + 1) & (capacity - 1);
+        }
+        if (keys[slot].vn == 0) {
+          keys[slot].op = value->op;
+          keys[slot].left = left;
+          keys[slot].right = right;
+          keys[slot].vn = value->vn;
+        } else {
+          value->vn = keys[slot].vn;
+        }
+        break;
+      }
+      default:
+        break;
+      }
+    }
+  }
+  free(keys);
+  free(constants);
+  *count = next;
+  return true;
+}
+
+// Mark expressions inside reused ones as not evaluated (parents come after
+// their children in a block, so walk backwards)
+static void mark_suppressed(IRFunction *fn) {
+  for (size_t b = 0; b < fn->order_count; b++) {
+    IRBlock *block = fn->order[b];
+    for (size_t i = block->value_count; i > 0; i--) {
+      IRValue *value = block->values[i - 1];
+      IRValue *parent = value->parent;
+      value->suppressed =
+          parent && (parent->suppressed || parent->applied);
+    }
+  }
+}
+
+void ir_eliminate_common_subexpressions(IRFunction *fn) {
+  size_t vn_count = 0;
+  if (!fn || fn->failed || !number_values(fn, &vn_count)) {
+    return;
+  }
+  IRValue **first = calloc(vn_count, sizeof(IRValue *));
+  if (!first) {
+    fn->failed = true;
+    return;
+  }
+
+  // Each pure operator reuses the first equal value dominating it
+  for (size_t b = 0; b < fn->order_count; b++) {
+    IRBlock *block = fn->order[b];
+    for (size_t i = 0; i < block->value_count; i++) {
+      IRValue *value = block->values[i];
+      if (!op_is_pure(value)) {
+        continue;
+      }
+      IRValue **link = &first[value->vn];
+      while (*link && !value_dominates(*link, value)) {
+        link = &(*link)->next_equal;
+      }
+      if (*link) {
+        value->leader = *link;
+      } else {
+        *link = value;
+      }
+    }
+  }
+  free(first);
+
+  // Reuse the outermost repeated expressions; a leader is only kept in a
+  // temp (store + load) when its reuses save more than that costs
+  for (size_t b = 0; b < fn->order_count; b++) {
+    IRBlock *block = fn->order[b];
+    for (size_t i = block->value_count; i > 0; i--) {
+      IRValue *value = block->values[i - 1];
+      IRValue *parent = value->parent;
+      value->suppressed = parent && (parent->suppressed || parent->applied);
+      if (value->leader && !value->suppressed) {
+        value->applied = true;
+        value->leader->saving += value->size - 1;
+      }
+    }
+  }
+  for (size_t i = 0; i < fn->value_count; i++) {
+    IRValue *value = fn->values[i];
+    if (!value->applied) {
+      continue;
+    }
+    if (value->leader->saving <= 2) {
+      value->applied = false;
+    } else {
+      value->leader->needs_temp = true;
+      fn->stats.reused++;
+    }
+  }
+  mark_suppressed(fn);
+}
+
+// Whether @p value can be evaluated ahead of @p loop with the same result
+// and without raising an error
+static bool invariant_in(const IRValue *value, const IRLoop *loop) {
+  switch (value->kind) {
+  case IR_CONST:
+    return true;
+  case IR_READ: {
+    const IRValue *source = read_source(value);
+    return !value->pinned && source->defined &&
+           !loop_contains(loop, source->block);
+  }
+  case IR_OP:
+    if (!op_is_pure(value) || !op_never_fails(value)) {
+      return false;
+    }
+    if (value->applied && loop_contains(loop, value->leader->block)) {
+      return false; // Reuses a temp only set inside the loop
+    }
+    for (size_t i = 0; i < value->operand_count; i++) {
+      if (!invariant_in(value->operands[i], loop)) {
+        return false;
+      }
+    }
+    return true;
+  default:
+    return false;
+  }
+}
+
+// Outermost loop @p value can be evaluated ahead of (NULL if none)
+static IRLoop *hoist_target(const IRValue *value) {
+  IRLoop *target = NULL;
+  for (IRLoop *loop = value->block->loop; loop; loop = loop->parent) {
+    if (!invariant_in(value, loop)) {
+      break;
+    }
+    target = loop;
+  }
+  return target;
+}
+
+void ir_hoist_loop_invariants(IRFunction *fn) {
+  if (!fn || fn->failed) {
+    return;
+  }
+  for (size_t b = 0; b < fn->order_count; b++) {
+    IRBlock *block = fn->order[b];
+    if (!block->loop) {
+      continue;
+    }
+    for (size_t i = 0; i < block->value_count; i++) {
+      IRValue *value = block->values[i];
+      if (value->kind != IR_OP || value->dead || value->suppressed ||
+          value->applied) {
+        continue;
+      }
+      IRLoop *target = hoist_target(value);
+      if (!target) {
+        continue;
+      }
+      // Moved along with an enclosing expression going to the same loop
+      IRValue *parent = value->parent;
+      if (parent && parent->kind == IR_OP && hoist_target(parent) == target) {
+        continue;
+      }
+      if (!ir_reserve(fn, (void **)&target->hoisted,
+                      &target->hoisted_capacity, target->hoisted_count,
+                      sizeof(IRValue *))) {
+        return;
+      }
+      target->hoisted[target->hoisted_count++] = value;
+      value->hoist = target;
+      value->needs_temp = true;
+      fn->stats.hoisted++;
+    }
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Lowering
+// ---------------------------------------------------------------------------
+
+static IRAction *plan_insert(IRPlan *plan, const ASTNode *node) {
+  size_t slot = ((uintptr_t)node >> 4) & (plan->capacity - 1);
+  while (plan->keys[slot] && plan->keys[slot] != node) {
+    slot = (slot + 1) & (plan->capacity - 1);
+  }
+  plan->keys[slot] = node;
+  return &plan->actions[slot];
+}
+
+IRPlan *ir_lower(IRFunction *fn, size_t temp_limit) {
+  if (!fn || fn->failed) {
+    return NULL;
+  }
+
+  // Temps for kept leaders and hoisted values, while slots last
+  size_t temp_count = 0;
+  for (size_t i = 0; i < fn->value_count; i++) {
+    IRValue *value = fn->values[i];
+    if (!value->needs_temp) {
+      continue;
+    }
+    if (temp_count < temp_limit) {
+      value->temp = temp_count++;
+      continue;
+    }
+    value->needs_temp = false;
+    if (value->hoist) {
+      value->hoist = NULL;
+      fn->stats.hoisted--;
+    }
+  }
+
+  size_t action_count = 0;
+  size_t hoist_count = 0;
+  for (size_t i = 0; i < fn->value_count; i++) {
+    IRValue *value = fn->values[i];
+    if (value->applied && !value->leader->needs_temp) {
+      value->applied = false;
+      fn->stats.reused--;
+    }
+    if (value->hoist) {
+      hoist_count++;
+    }
+    if (value->applied || value->needs_temp || value->dropped ||
+        (value->copy && !value->dead)) {
+      action_count++;
+    }
+  }
+  for (size_t i = 0; i < fn->loop_count; i++) {
+    action_count += fn->loops[i]->hoisted_count > 0 ? 1 : 0;
+  }
+  if (action_count == 0) {
+    return NULL;
+  }
+
+  IRPlan *plan = calloc(1, sizeof(IRPlan));
+  if (!plan) {
+    return NULL;
+  }
+  plan->capacity = 16;
+  while (plan->capacity < action_count * 2) {
+    plan->capacity *= 2;
+  }
+  plan->keys = calloc(plan->capacity, sizeof(ASTNode *));
+  plan->actions = calloc(plan->capacity, sizeof(IRAction));
+  plan->hoists = calloc(hoist_count + 1, sizeof(IRHoist));
+  if (!plan->keys || !plan->actions || !plan->hoists) {
+    ir_plan_free(plan);
+    return NULL;
+  }
+  plan->temp_count = temp_count;
+  plan->stats = fn->stats;
+
+  size_t temp_base = fn->local_count;
+  for (size_t i = 0; i < fn->value_count; i++) {
+    IRValue *value = fn->values[i];
+    IRAction *action = NULL;
+    if (value->applied) {
+      action = plan_insert(plan, value->node);
+      action->kind = IR_ACTION_LOAD_TEMP;
+      action->slot = temp_base + value->leader->temp;
+    } else if (value->needs_temp) {
+      action = plan_insert(plan, value->node);
+      action->kind =
+          value->hoist ? IR_ACTION_LOAD_TEMP : IR_ACTION_SAVE_TEMP;
+      action->slot = temp_base + value->temp;
+    } else if (value->dropped) {
+      action = plan_insert(plan, value->node);
+      action->kind = IR_ACTION_DROP_STORE;
+    } else if (value->copy && !value->dead) {
+      action = plan_insert(plan, value->node);
+      action->kind = IR_ACTION_LOAD_LOCAL;
+      action->slot = (size_t)value->copy_slot;
+    }
+  }
+
+  IRHoist *next = plan->hoists;
+  for (size_t i = 0; i < fn->loop_count; i++) {
+    IRLoop *loop = fn->loops[i];
+    IRHoist *start = next;
+    for (size_t j = 0; j < loop->hoisted_count; j++) {
+      IRValue *value = loop->hoisted[j];
+      if (value->hoist == loop) {
+        next->node = value->node;
+        next->slot = temp_base + value->temp;
+        next++;
+      }
+    }
+    if (next > start) {
+      IRAction *action = plan_insert(plan, loop->node);
+      action->kind = IR_ACTION_HOIST;
+      action->hoisted = start;
+      action->hoisted_count = (size_t)(next - start);
+    }
+  }
+  plan->stats = fn->stats;
+  return plan;
+}
+
+// ---------------------------------------------------------------------------
+// Entry points
+// ---------------------------------------------------------------------------
+
+IRFunction *ir_build_function(const ASTNode *function, const IRLocal *locals,
+                              size_t local_count) {
+  if (!function || function->type != AST_FUNCTION ||
+      local_count < function->as.function.param_count) {
+    return NULL;
+  }
+  IRFunction *fn = calloc(1, sizeof(IRFunction));
+  if (!fn) {
+    return NULL;
+  }
+  fn->locals = locals;
+  fn->local_count = local_count;
+
+  // Entry: parameters hold arguments, other locals fall back to globals
+  IRBuilder builder = {fn, NULL, NULL, NULL, 0, 0};
+  IRBlock *entry = block_new(fn);
+  if (entry) {
+    entry->sealed = true;
+    block_start(&builder, entry);
+  }
+  for (size_t i = 0; i < local_count && builder.current; i++) {
+    define_local(&builder,
+                 i < function->as.function.param_count ? IR_PARAM : IR_UNDEF,
+                 NULL, (int)i);
+  }
+
+  build_block(&builder, function->as.function.block,
+              function->as.function.block_size);
+  if (fn->failed) {
+    ir_function_free(fn);
+    return NULL;
+  }
+  remove_trivial_phis(fn);
+  compute_dominators(fn);
+  if (!infer_types(fn)) {
+    ir_function_free(fn);
+    return NULL;
+  }
+  return fn;
+}
+
+void ir_function_free(IRFunction *fn) {
+  if (!fn) {
+    return;
+  }
+  for (size_t i = 0; i < fn->value_count; i++) {
+    IRValue *value = fn->values[i];
+    value_release(value->constant);
+    free(value->operands);
+    free(value);
+  }
+  for (size_t i = 0; i < fn->block_count; i++) {
+    IRBlock *block = fn->blocks[i];
+    free(block->preds);
+    free(block->values);
+    free(block->incomplete);
+    free(block->defs);
+    free(block);
+  }
+  for (size_t i = 0; i < fn->loop_count; i++) {
+    free(fn->loops[i]->hoisted);
+    free(fn->loops[i]);
+  }
+  free(fn->values);
+  free(fn->blocks);
+  free(fn->order);
+  free(fn->loops);
+  free(fn);
+}
+
+IRPlan *ir_optimize_function(const ASTNode *function, const IRLocal *locals,
+                             size_t local_count, size_t temp_limit) {
+  IRFunction *fn = ir_build_function(function, locals, local_count);
+  if (!fn) {
+    return NULL;
+  }
+  ir_propagate_copies(fn);
+  ir_eliminate_dead_stores(fn);
+  ir_eliminate_common_subexpressions(fn);
+  ir_hoist_loop_invariants(fn);
+  IRPlan *plan = ir_lower(fn, temp_limit);
+  ir_function_free(fn);
+  return plan;
+}
+
+const IRAction *ir_plan_lookup(const IRPlan *plan, const ASTNode *node) {
+  if (!plan || !node) {
+    return NULL;
+  }
+  size_t slot = ((uintptr_t)node >> 4) & (plan->capacity - 1);
+  while (plan->keys[slot]) {
+    if (plan->keys[slot] == node) {
+      return &plan->actions[slot];
+    }
+    slot = (slot + 1) & (plan->capacity - 1);
+  }
+  return NULL;
+}
+
+size_t ir_plan_temp_count(const IRPlan *plan) {
+  return plan ? plan->temp_count : 0;
+}
+
+const IRStats *ir_plan_stats(const IRPlan *plan) {
+  return plan ? &plan->stats : NULL;
+}
+
+void ir_plan_free(IRPlan *plan) {
+  if (!plan) {
+    return;
+  }
+  free(plan->keys);
+  free(plan->actions);
+  free(plan->hoists);
+  free(plan);
+}
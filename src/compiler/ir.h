@@ -0,0 +1,132 @@
+#ifndef KRONOS_IR_H
+#define KRONOS_IR_H
+
+#include "../frontend/parser.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * A local variable of the function being optimized, by slot
+ *
+ * Parameters come first, in the order of the function's slot table.
+ */
+typedef struct {
+  const char *name; // Borrowed
+  bool removable;   // Stores can be dropped: mutable and untyped, so a
+                    // store never fails
+} IRLocal;
+
+/**
+ * SSA form of one function body (basic blocks, SSA values, loops)
+ *
+ * Built by ir_build_function(), rewritten in place by the passes below and
+ * lowered to an IRPlan by ir_lower().
+ */
+typedef struct IRFunction IRFunction;
+
+/** What the compiler does differently at one AST node */
+typedef enum {
+  IR_ACTION_LOAD_TEMP,  // Expression: load its temp instead of evaluating
+  IR_ACTION_SAVE_TEMP,  // Expression: evaluate, keep a copy in its temp
+  IR_ACTION_LOAD_LOCAL, // Variable read: load another local (same value)
+  IR_ACTION_DROP_STORE, // Assignment: emit nothing
+  IR_ACTION_HOIST,      // Loop: evaluate expressions into temps first
+} IRActionKind;
+
+/** An expression evaluated into a temp ahead of a loop */
+typedef struct {
+  const ASTNode *node;
+  size_t slot;
+} IRHoist;
+
+typedef struct {
+  IRActionKind kind;
+  size_t slot;            // Temp or local slot (LOAD/SAVE_TEMP, LOAD_LOCAL)
+  const IRHoist *hoisted; // IR_ACTION_HOIST, in evaluation order
+  size_t hoisted_count;
+} IRAction;
+
+/** What the passes achieved, for tests and tuning */
+typedef struct {
+  size_t copies;  // Variable reads redirected to the original local
+  size_t dropped; // Dead stores removed
+  size_t reused;  // Expressions replaced by an earlier equal value
+  size_t hoisted; // Loop-invariant expressions moved ahead of their loop
+} IRStats;
+
+/**
+ * Lowering of an optimized IRFunction: per-AST-node actions for the
+ * compiler, plus the number of temp slots they use
+ *
+ * Temps are extra locals numbered from the function's local count.
+ */
+typedef struct IRPlan IRPlan;
+
+/**
+ * @brief Build the SSA form of a function body
+ *
+ * Mirrors the compiler's code shape at -O1 (folded constants, pruned
+ * branches, loop lowering). Bodies the IR does not model (try, import,
+ * range loops nested past RANGE_LOOP_DEPTH_MAX) are rejected.
+ *
+ * @param function AST_FUNCTION node
+ * @param locals Slot table of the function (parameters first)
+ * @param local_count Number of entries in @p locals
+ * @return SSA form, or NULL if the body is not modelled (or out of memory)
+ */
+IRFunction *ir_build_function(const ASTNode *function, const IRLocal *locals,
+                              size_t local_count);
+
+/**
+ * @brief Copy propagation: a read of `b` after `b to a` loads `a` while `a`
+ * still holds that value
+ */
+void ir_propagate_copies(IRFunction *fn);
+
+/**
+ * @brief Dead store elimination: drop stores no read can observe when the
+ * stored value cannot fail or have side effects
+ */
+void ir_eliminate_dead_stores(IRFunction *fn);
+
+/**
+ * @brief Common subexpression elimination by value numbering: an expression
+ * dominated by an equal one reuses its value
+ */
+void ir_eliminate_common_subexpressions(IRFunction *fn);
+
+/**
+ * @brief Loop-invariant code motion: evaluate invariant expressions that
+ * cannot fail once, ahead of the outermost loop they are invariant in
+ */
+void ir_hoist_loop_invariants(IRFunction *fn);
+
+/**
+ * @brief Lower an optimized IRFunction to compiler actions
+ *
+ * @param fn Optimized SSA form
+ * @param temp_limit Most temp slots the plan may use
+ * @return Plan, or NULL if nothing changes (or out of memory)
+ */
+IRPlan *ir_lower(IRFunction *fn, size_t temp_limit);
+
+void ir_function_free(IRFunction *fn);
+
+/**
+ * @brief Build, optimize and lower a function body in one go
+ *
+ * @return Plan, or NULL if the body is not modelled or nothing changes
+ */
+IRPlan *ir_optimize_function(const ASTNode *function, const IRLocal *locals,
+                             size_t local_count, size_t temp_limit);
+
+/**
+ * @brief Action for @p node, or NULL if it compiles as usual
+ */
+const IRAction *ir_plan_lookup(const IRPlan *plan, const ASTNode *node);
+
+size_t ir_plan_temp_count(const IRPlan *plan);
+const IRStats *ir_plan_stats(const IRPlan *plan);
+void ir_plan_free(IRPlan *plan);
+
+#endif // KRONOS_IR_H
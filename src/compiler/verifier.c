@@ -0,0 +1,477 @@
+/**
+ * @file verifier.c
+ * @brief Load-time bytecode verifier for Kronos
+ *
+ * DESIGN DECISIONS:
+ * - One linear pass per code range: every instruction is decoded once, its
+ *   operand bytes must fit inside the range, and the instruction start is
+ *   recorded in a per-range bitmap. A second pass checks that every control
+ *   transfer (JUMP, JUMP_IF_FALSE, CMP_JUMP_IF_FALSE, TRY_ENTER, TRY_EXIT and
+ *   the range and iterator loop opcodes) lands on a recorded instruction
+ *   start of the same range.
+ * - Function bodies are separate ranges: OP_DEFINE_FUNC copies its body into
+ *   the function's own Bytecode, so the body is verified as a self-contained
+ *   range (jumps may not leave it) and the enclosing range resumes after it.
+ * - Constant operands must index a non-NULL constant; NO_CONSTANT_NARROW
+ *   (NO_CONSTANT_WIDE in a wide instruction) is accepted where the VM treats
+ *   it as "absent" (THROW/CATCH types, catch variable, untyped local slot).
+ * - OP_WIDE is decoded as part of the instruction it prefixes: the
+ *   instruction starts at the prefix (jumps must land there) and its
+ *   constant, global slot and jump operands are 32-bit. A prefix before an
+ *   opcode without such operands is rejected.
+ * - Verification is all-or-nothing: a failing program keeps verified=false
+ *   and runs on the VM's defensive (bounds-checked) operand path, so the
+ *   verifier never changes observable behaviour, only which path is taken.
+ *
+ * What is NOT verified: stack depth, operand types and local slot numbers
+ * are still checked by the VM at runtime (they depend on the frame).
+ */
+
+#include "compiler.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+typedef struct {
+  const Bytecode *bytecode;
+  const char *error;
+} Verifier;
+
+static bool verify_fail(Verifier *v, const char *message) {
+  if (!v->error) {
+    v->error = message;
+  }
+  return false;
+}
+
+static uint16_t operand_u16(const Verifier *v, size_t pos) {
+  return (uint16_t)(v->bytecode->code[pos] << 8 | v->bytecode->code[pos + 1]);
+}
+
+/**
+ * @brief Read a constant, global slot or jump operand: 32-bit in a wide
+ * instruction, else 16-bit
+ */
+static uint32_t operand_at(const Verifier *v, size_t pos, bool wide) {
+  if (!wide) {
+    return operand_u16(v, pos);
+  }
+  return (uint32_t)operand_u16(v, pos) << 16 | operand_u16(v, pos + 2);
+}
+
+static bool check_constant(Verifier *v, uint32_t idx, bool wide,
+                           bool allow_absent) {
+  if (allow_absent && idx == (wide ? NO_CONSTANT_WIDE : NO_CONSTANT_NARROW)) {
+    return true;
+  }
+  if (idx >= v->bytecode->const_count || !v->bytecode->constants[idx]) {
+    return verify_fail(v, "Constant index out of range");
+  }
+  return true;
+}
+
+/**
+ * @brief Compute the byte length of the instruction at @p pos
+ *
+ * Validates operand widths and constant indices. For OP_DEFINE_FUNC the
+ * length covers the header only and @p body_len receives the inline body
+ * size that follows it. The length of a wide instruction includes its
+ * OP_WIDE prefix.
+ *
+ * @return Instruction length, or 0 if the instruction is malformed
+ */
+static size_t decode_instruction(Verifier *v, size_t pos, size_t end,
+                                 size_t *body_len) {
+  const uint8_t *code = v->bytecode->code;
+  bool wide = code[pos] == OP_WIDE;
+  size_t p = pos + 1;
+  *body_len = 0;
+  if (wide && p == end) {
+    verify_fail(v, "Truncated instruction operand");
+    return 0;
+  }
+  uint8_t op = wide ? code[p++] : code[pos];
+  // Width of constant, global slot and jump offset operands
+  size_t w = wide ? 4 : 2;
+
+#define NEED(n)                                                                \
+  do {                                                                         \
+    if ((n) > end - p) {                                                       \
+      verify_fail(v, "Truncated instruction operand");                         \
+      return 0;                                                                \
+    }                                                                          \
+  } while (0)
+#define CONSTANT(pos_, allow_absent_)                                          \
+  do {                                                                         \
+    if (!check_constant(v, operand_at(v, (pos_), wide), wide,                  \
+                        (allow_absent_))) {                                    \
+      return 0;                                                                \
+    }                                                                          \
+  } while (0)
+#define LENGTH(n) ((p - pos) + (n))
+
+  switch (op) {
+  case OP_LOAD_CONST:
+  case OP_LOAD_VAR:
+    NEED(w);
+    CONSTANT(p, false);
+    return LENGTH(w);
+  case OP_STORE_VAR:
+  case OP_STORE_GLOBAL: {
+    // [slot-or-name][is_mutable:1][has_type:1][type_idx if has_type]
+    NEED(w + 2);
+    if (op == OP_STORE_VAR) {
+      CONSTANT(p, false);
+    }
+    if (code[p + w + 1] == 0) {
+      return LENGTH(w + 2);
+    }
+    p += w + 2;
+    NEED(w);
+    CONSTANT(p, false);
+    return LENGTH(w);
+  }
+  case OP_INC_VAR_CONST:
+  case OP_INC_GLOBAL_CONST: {
+    // [slot-or-name][step][is_mutable:1][has_type:1][type_idx if has_type]
+    NEED(2 * w + 2);
+    if (op == OP_INC_VAR_CONST) {
+      CONSTANT(p, false);
+    }
+    CONSTANT(p + w, false);
+    if (code[p + 2 * w + 1] == 0) {
+      return LENGTH(2 * w + 2);
+    }
+    p += 2 * w + 2;
+    NEED(w);
+    CONSTANT(p, false);
+    return LENGTH(w);
+  }
+  case OP_INC_LOCAL_CONST:
+    // [slot:1][step]
+    NEED(1 + w);
+    CONSTANT(p + 1, false);
+    return LENGTH(1 + w);
+  case OP_CMP_JUMP_IF_FALSE:
+  case OP_CMP_JUMP_IF_FALSE_NUM:
+    // [comparison:1][offset]
+    NEED(1 + w);
+    if (code[p] < (op == OP_CMP_JUMP_IF_FALSE ? OP_EQ : OP_GT) ||
+        code[p] > OP_LTE) {
+      verify_fail(v, "Invalid comparison operand");
+      return 0;
+    }
+    return LENGTH(1 + w);
+  case OP_LOAD_GLOBAL:
+  case OP_JUMP:
+  case OP_JUMP_IF_FALSE:
+  case OP_TRY_ENTER:
+  case OP_TRY_EXIT:
+    NEED(w);
+    return LENGTH(w);
+  case OP_THROW:
+    NEED(w);
+    CONSTANT(p, true);
+    return LENGTH(w);
+  case OP_CATCH:
+    NEED(2 * w);
+    CONSTANT(p, true);
+    CONSTANT(p + w, true);
+    return LENGTH(2 * w);
+  case OP_IMPORT:
+    NEED(2 * w);
+    CONSTANT(p, false);
+    CONSTANT(p + w, false);
+    return LENGTH(2 * w);
+  case OP_CALL_FUNC:
+    NEED(w + 1);
+    CONSTANT(p, false);
+    return LENGTH(w + 1);
+  case OP_TAIL_CALL:
+    // Calls that cannot reuse the frame return through the next instruction
+    NEED(w + 2);
+    CONSTANT(p, false);
+    if (code[p + w + 1] != OP_RETURN_VAL) {
+      verify_fail(v, "Tail call not followed by return");
+      return 0;
+    }
+    return LENGTH(w + 1);
+  case OP_FOR_RANGE_PREP:
+  case OP_FOR_RANGE_NEXT:
+    // [depth:1][offset]; any depth byte is below RANGE_LOOP_DEPTH_MAX
+    NEED(1 + w);
+    return LENGTH(1 + w);
+  case OP_ITER_PREP:
+    // [depth:1][pairs:1][offset]
+    NEED(2 + w);
+    if (code[p] >= ITER_LOOP_DEPTH_MAX) {
+      verify_fail(v, "Iterator depth out of range");
+      return 0;
+    }
+    return LENGTH(2 + w);
+  case OP_ITER_NEXT:
+    // [depth:1][offset]
+    NEED(1 + w);
+    if (code[p] >= ITER_LOOP_DEPTH_MAX) {
+      verify_fail(v, "Iterator depth out of range");
+      return 0;
+    }
+    return LENGTH(1 + w);
+  case OP_DEFINE_FUNC: {
+    // [name][param_count:1][params * P][local_count:2]
+    // [locals: (name, is_mutable:1, type) * L][body_start]
+    // [OP_JUMP][body_len] followed by the inline body
+    NEED(w + 1);
+    CONSTANT(p, false);
+    uint8_t param_count = code[p + w];
+    p += w + 1;
+    for (size_t i = 0; i < param_count; i++, p += w) {
+      NEED(w);
+      CONSTANT(p, false);
+    }
+    NEED(2);
+    uint16_t local_count = operand_u16(v, p);
+    p += 2;
+    for (size_t i = 0; i < local_count; i++, p += 2 * w + 1) {
+      NEED(2 * w + 1);
+      CONSTANT(p, false);
+      CONSTANT(p + w + 1, true);
+    }
+    NEED(2 * w + 1);
+    if (code[p + w] != OP_JUMP) {
+      verify_fail(v, "Function definition missing body skip jump");
+      return 0;
+    }
+    size_t skip = operand_at(v, p + w + 1, wide);
+    p += 2 * w + 1;
+    if (skip > end - p) {
+      verify_fail(v, "Function body extends past end of code");
+      return 0;
+    }
+    *body_len = skip;
+    return p - pos;
+  }
+  default:
+    break;
+  }
+
+  if (wide) {
+    verify_fail(v, "OP_WIDE before an opcode without wide operands");
+    return 0;
+  }
+  switch (op) {
+  case OP_LOAD_LOCAL:
+  case OP_STORE_LOCAL:
+    NEED(1);
+    return 2;
+  case OP_ITER_CLOSE:
+    // [depth:1]
+    NEED(1);
+    if (code[p] >= ITER_LOOP_DEPTH_MAX) {
+      verify_fail(v, "Iterator depth out of range");
+      return 0;
+    }
+    return 2;
+  case OP_LIST_NEW:
+  case OP_MAP_NEW:
+    NEED(2);
+    return 3;
+  case OP_PRINT:
+  case OP_ADD:
+  case OP_SUB:
+  case OP_MUL:
+  case OP_DIV:
+  case OP_MOD:
+  case OP_NEG:
+  case OP_EQ:
+  case OP_NEQ:
+  case OP_GT:
+  case OP_LT:
+  case OP_GTE:
+  case OP_LTE:
+  // Quickened forms (emitted for provable operand types or written by the
+  // VM)
+  case OP_ADD_NUM:
+  case OP_SUB_NUM:
+  case OP_MUL_NUM:
+  case OP_GT_NUM:
+  case OP_LT_NUM:
+  case OP_GTE_NUM:
+  case OP_LTE_NUM:
+  case OP_INDEX_LIST:
+  case OP_CONCAT_STR:
+  case OP_AND:
+  case OP_OR:
+  case OP_NOT:
+  case OP_RETURN_VAL:
+  case OP_POP:
+  case OP_LIST_GET:
+  case OP_LIST_SET:
+  case OP_LIST_APPEND:
+  case OP_LIST_LEN:
+  case OP_LIST_SLICE:
+  case OP_RANGE_NEW:
+  case OP_MAP_SET:
+  case OP_DELETE:
+  case OP_FINALLY:
+  case OP_HALT:
+    return 1;
+  default:
+    // Reserved (BREAK, CONTINUE, MAP_GET, RETHROW) or unknown opcodes
+    verify_fail(v, "Invalid or reserved opcode");
+    return 0;
+  }
+
+#undef NEED
+#undef CONSTANT
+#undef LENGTH
+}
+
+/**
+ * @brief Check a control transfer target against the range's instruction
+ * starts (@p starts is indexed relative to @p start)
+ */
+static bool check_target(Verifier *v, const uint8_t *starts, size_t start,
+                         size_t end, size_t target) {
+  if (target < start || target >= end || !starts[target - start]) {
+    return verify_fail(v, "Jump target is not an instruction boundary");
+  }
+  return true;
+}
+
+static bool verify_range(Verifier *v, size_t start, size_t end) {
+  if (start == end) {
+    return true;
+  }
+  uint8_t *starts = calloc(end - start, 1);
+  if (!starts) {
+    return verify_fail(v, "Failed to allocate verifier state");
+  }
+
+  // Pass 1: decode, mark instruction starts, recurse into function bodies
+  size_t pos = start;
+  while (pos < end) {
+    size_t body_len;
+    size_t len = decode_instruction(v, pos, end, &body_len);
+    if (len == 0) {
+      free(starts);
+      return false;
+    }
+    starts[pos - start] = 1;
+    pos += len;
+    if (body_len > 0) {
+      if (!verify_range(v, pos, pos + body_len)) {
+        free(starts);
+        return false;
+      }
+      pos += body_len;
+    }
+  }
+
+  // Pass 2: every control transfer lands on an instruction of this range
+  bool ok = true;
+  for (pos = start; ok && pos < end; pos++) {
+    if (!starts[pos - start]) {
+      continue;
+    }
+    const uint8_t *code = v->bytecode->code;
+    bool wide = code[pos] == OP_WIDE;
+    size_t op_pos = pos + wide;
+    size_t w = wide ? 4 : 2;
+    // Offset operand position, relative to the opcode; offsets count from
+    // the end of the operand
+    size_t operand;
+    bool backward = false;   // Signed, always negative (loop back edges)
+    bool may_be_none = false; // TRY_EXIT: 0 means no jump
+    switch (code[op_pos]) {
+    case OP_JUMP: {
+      size_t after = op_pos + 1 + w;
+      uint32_t raw = operand_at(v, op_pos + 1, wide);
+      int64_t offset = wide ? (int32_t)raw : (int16_t)raw;
+      if (offset < 0 && (size_t)(-offset) > after) {
+        ok = verify_fail(v, "Jump target is not an instruction boundary");
+        continue;
+      }
+      ok = check_target(v, starts, start, end,
+                        (size_t)((int64_t)after + offset));
+      continue;
+    }
+    case OP_JUMP_IF_FALSE:
+    case OP_TRY_ENTER:
+      operand = 1;
+      break;
+    case OP_TRY_EXIT:
+      operand = 1;
+      may_be_none = true;
+      break;
+    case OP_FOR_RANGE_PREP:
+    case OP_CMP_JUMP_IF_FALSE:
+    case OP_CMP_JUMP_IF_FALSE_NUM:
+      operand = 2;
+      break;
+    case OP_ITER_PREP:
+      operand = 3;
+      break;
+    case OP_FOR_RANGE_NEXT:
+    case OP_ITER_NEXT:
+      operand = 2;
+      backward = true;
+      break;
+    default:
+      continue;
+    }
+
+    size_t after = op_pos + operand + w;
+    uint32_t raw = operand_at(v, op_pos + operand, wide);
+    if (backward) {
+      // Always a backward jump into the loop body
+      int64_t offset = wide ? (int32_t)raw : (int16_t)raw;
+      if (offset >= 0 || (size_t)(-offset) > after) {
+        ok = verify_fail(v, "Jump target is not an instruction boundary");
+        continue;
+      }
+      ok = check_target(v, starts, start, end,
+                        (size_t)((int64_t)after + offset));
+    } else if (raw > 0 || !may_be_none) {
+      ok = check_target(v, starts, start, end, after + raw);
+    }
+  }
+
+  free(starts);
+  return ok;
+}
+
+bool bytecode_verify(Bytecode *bytecode, const char **out_err) {
+  if (out_err) {
+    *out_err = NULL;
+  }
+  if (!bytecode) {
+    if (out_err) {
+      *out_err = "Bytecode is NULL";
+    }
+    return false;
+  }
+  bytecode->verified = false;
+  if (!bytecode->code && bytecode->count > 0) {
+    if (out_err) {
+      *out_err = "Bytecode has no code buffer";
+    }
+    return false;
+  }
+  if (bytecode->const_count > 0 && !bytecode->constants) {
+    if (out_err) {
+      *out_err = "Bytecode has no constant pool";
+    }
+    return false;
+  }
+
+  Verifier v = {.bytecode = bytecode, .error = NULL};
+  if (!verify_range(&v, 0, bytecode->count)) {
+    if (out_err) {
+      *out_err = v.error;
+    }
+    return false;
+  }
+  bytecode->verified = true;
+  return true;
+}
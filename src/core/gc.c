@@ -3,13 +3,16 @@
  * @brief Garbage collection and memory tracking
  *
  * Provides reference-counting based garbage collection for Kronos values.
- * Tracks all allocated objects and provides statistics. Thread-safe using
- * mutexes for concurrent access.
+ * Every heap object carries an intrusive header linking it into the object
+ * list of the allocating thread's heap; each heap keeps its own counters, so
+ * tracking is lock-free and gc_stats() sums the heaps. Leak-check builds
+ * (-DKRONOS_GC_LEAK_CHECK=1) also record every object in a global table.
  */
 
 #include "gc.h"
 #include <assert.h>
 #include <pthread.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -23,8 +26,140 @@ typedef struct {
   bool is_tombstone;
 } MapEntry;
 
+// Leak-check mode (build with -DKRONOS_GC_LEAK_CHECK=1). Every tracked object
+// is also recorded in a global pointer hash set guarded by gc_mutex, so an
+// untrack of a pointer that was never tracked (or already untracked) is
+// reported instead of trusting its header, and gc_cleanup() reports how many
+// objects were still tracked. Costs a lock and a hash insert per allocation:
+// it is a debugging aid, not for release builds.
+#ifndef KRONOS_GC_LEAK_CHECK
+#define KRONOS_GC_LEAK_CHECK 0
+#endif
+
 /**
- * Initial capacity for the object tracking array
+ * Intrusive tracking header in front of every heap object
+ *
+ * DESIGN DECISION: Allocated in the same block as the KronosValue (see
+ * gc_alloc_object()), so tracking is a list insertion with no allocation and
+ * untracking an O(1) unlink from the heap recorded in the header. Numbers,
+ * booleans and nil have no header; they are never tracked. The header stays
+ * 32 bytes (see the 80-byte slab class below), so the charged size is 32
+ * bits wide and saturates; tracking and untracking use the same stored
+ * value, so the counters still balance.
+ */
+typedef struct GCHeader {
+  struct GCHeader *prev; /**< Previous object in the heap (NULL: untracked) */
+  struct GCHeader *next; /**< Next object in the heap */
+  struct GCHeap *heap;   /**< Heap the object is linked into (if tracked) */
+  uint32_t bytes;        /**< Bytes charged to the heap by gc_track() */
+  uint16_t inline_bytes; /**< Payload allocated behind the value */
+  bool marked;           /**< Reachability mark used by gc_collect_cycles() */
+} GCHeader;
+
+_Static_assert(sizeof(GCHeader) == 32, "GCHeader must stay 32 bytes");
+
+_Static_assert(sizeof(GCHeader) % _Alignof(KronosValue) == 0,
+               "GCHeader must keep the value behind it aligned");
+
+/**
+ * Slab geometry
+ *
+ * WHY: Every KronosValue (64 bytes with its header), short string and small
+ * list or map array used to be a separate malloc. Carving them from large
+ * chunks and recycling them through per-thread free lists keeps temporaries
+ * out of the system allocator.
+ *
+ * DESIGN DECISION: Power-of-two classes from 16 to 256 bytes cover the
+ * fixed-size structs and the common small buffers, plus an 80-byte class
+ * that exactly fits a value, its header and an inline string of up to
+ * KRONOS_INLINE_STRING_MAX bytes; anything larger goes to malloc. Chunks are
+ * 16 KiB, so a thread touching every class reserves only 96 KiB up front.
+ * Blocks are 16-byte aligned (chunk payload starts at GC_SLAB_ALIGN and
+ * every class size is a multiple of it).
+ */
+#define GC_SLAB_MAX_BLOCK 256
+#define GC_SLAB_CHUNK_SIZE (16 * 1024)
+#define GC_SLAB_ALIGN 16
+
+/** Block size of each size class */
+static const size_t gc_slab_block_sizes[GC_SLAB_CLASS_COUNT] = {
+    16, 32, 64, 80, 128, 256};
+
+#if !KRONOS_GC_LEAK_CHECK
+/** Size class of a request, indexed by its size rounded up to 16 bytes */
+static const uint8_t gc_slab_class_by_16[GC_SLAB_MAX_BLOCK / 16 + 1] = {
+    0, 0, 1, 2, 2, 3, 4, 4, 4, 5, 5, 5, 5, 5, 5, 5, 5};
+#endif
+
+_Static_assert(sizeof(GCHeader) + sizeof(KronosValue) +
+                   KRONOS_INLINE_STRING_MAX + 1 == 80,
+               "an inline string must fill the 80-byte class exactly");
+
+/** Free block (the link lives in the block itself) */
+typedef struct GCSlabBlock {
+  struct GCSlabBlock *next;
+} GCSlabBlock;
+
+/** A chunk carved into blocks; the header occupies the first GC_SLAB_ALIGN */
+typedef struct GCSlabChunk {
+  struct GCSlabChunk *next; /**< Registry link (protected by gc_mutex) */
+} GCSlabChunk;
+
+_Static_assert(sizeof(GCSlabChunk) <= GC_SLAB_ALIGN,
+               "chunk header must fit before the first block");
+
+/** One size class of a thread's slabs */
+typedef struct {
+  GCSlabBlock *free_list;      /**< Recycled blocks (LIFO) */
+  char *bump;                  /**< Next uncarved block of the current chunk */
+  char *bump_end;              /**< End of the current chunk */
+  atomic_size_t blocks_in_use; /**< Allocated minus freed on this thread */
+  atomic_size_t blocks_carved; /**< Blocks carved from chunks */
+} GCSlabClass;
+
+/**
+ * Allocation heap of one thread
+ *
+ * DESIGN DECISION: value_new_* take no VM handle, so objects are charged to
+ * the heap of the calling thread; a VM runs on one thread, so all of its
+ * objects land in one heap. Only the owning thread links, unlinks and
+ * counts, so none of it needs a lock: a value must be released on the
+ * thread that created it while that thread is alive (see gc_untrack()). The
+ * counters are atomics written with relaxed load/store pairs (plain moves,
+ * not locked read-modify-writes) so gc_stats() can read them from any thread.
+ */
+typedef struct GCHeap {
+  GCHeader objects;              /**< Sentinel of the circular object list */
+  atomic_size_t object_count;    /**< Number of tracked objects */
+  atomic_size_t allocated_bytes; /**< Sum of the objects' charged bytes */
+  GCSlabClass slabs[GC_SLAB_CLASS_COUNT]; /**< Slab free lists */
+  struct GCHeap *next;           /**< Registry link (protected by gc_mutex) */
+  bool registered;               /**< Linked into the registry */
+} GCHeap;
+
+/** Heap of the calling thread (registered on first use) */
+static _Thread_local GCHeap gc_thread_heap;
+
+/** Registered heaps of live threads (protected by gc_mutex) */
+static GCHeap *gc_heaps = NULL;
+
+/** Objects of exited threads (protected by gc_mutex, list set up lazily) */
+static GCHeap gc_orphans;
+
+/** Every slab chunk of every thread (protected by gc_mutex) */
+static GCSlabChunk *gc_slab_chunks = NULL;
+static size_t gc_slab_chunk_count = 0;
+
+/** Mutex for the heap and chunk registries and the leak-check table */
+static pthread_mutex_t gc_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/** Thread-specific key whose destructor retires a thread's heap */
+static pthread_key_t gc_heap_key;
+static pthread_once_t gc_heap_key_once = PTHREAD_ONCE_INIT;
+
+#if KRONOS_GC_LEAK_CHECK
+/**
+ * Initial capacity of the leak-check table
  *
  * Chosen to balance memory usage for small programs while minimizing
  * reallocations. The array grows automatically as needed (doubles when full),
@@ -51,26 +186,19 @@ typedef struct {
 } GCHashEntry;
 
 /**
- * Garbage collector state
- * Tracks all allocated KronosValue objects for leak detection and statistics
+ * Leak-check table
+ * Records every tracked KronosValue object across all heaps
  * Uses a hash set for O(1) track/untrack operations
  */
 typedef struct {
-  GCHashEntry *entries;   /**< Hash table entries (open addressing) */
-  size_t count;           /**< Number of currently tracked objects */
-  size_t capacity;        /**< Capacity of the hash table */
-  size_t allocated_bytes; /**< Total bytes allocated (approximate) */
+  GCHashEntry *entries; /**< Hash table entries (open addressing) */
+  size_t count;         /**< Number of currently tracked objects */
+  size_t capacity;      /**< Capacity of the hash table */
 } GCState;
 
-/** Global GC state (protected by gc_mutex) */
+/** Global leak-check table (protected by gc_mutex) */
 static GCState gc_state = {0};
 
-/** Mutex for thread-safe GC operations */
-static pthread_mutex_t gc_mutex;
-
-/** Track whether mutex has been initialized */
-static bool gc_mutex_initialized = false;
-
 /**
  * @brief Report allocation failure
  *
@@ -126,7 +254,8 @@ static size_t gc_find_slot_locked(KronosValue *object, bool insert) {
   while (true) {
     GCHashEntry *entry = &gc_state.entries[idx];
 
-    if (entry->object == NULL) {
+    // Tombstones also have a NULL object but must not end the probe chain
+    if (entry->object == NULL && !entry->is_tombstone) {
       // Empty slot found
       if (insert) {
         // Return first tombstone if found, otherwise this empty slot
@@ -268,400 +397,630 @@ static void gc_shrink_if_needed_locked(void) {
 }
 
 /**
- * @brief Initialize the garbage collector
- *
- * DESIGN DECISION: Idempotent - cleans up previous state before reinitializing
- * (finalizes objects with refcount == 1). Allows reinitialization without
- * explicit cleanup.
+ * @brief Record a newly tracked object in the leak-check table
  *
- * EDGE CASES: Mutex init fatal if fails, allocation failure aborts, only
- * finalizes refcount == 1 objects, not thread-safe (call from main thread).
- *
- * THREAD-SAFETY: This function must be called from the main thread before any
- * other threads start calling gc_track(). The mutex is kept locked during
- * cleanup to prevent race conditions where another thread could call gc_track()
- * and corrupt the hash table state during reinitialization.
+ * EDGE CASES: Allocation failure leaves the object out of the table (it is
+ * still tracked by its heap) and reports the failure.
  */
-void gc_init(void) {
-  // Initialize mutex if not already initialized
-  if (!gc_mutex_initialized) {
-    if (pthread_mutex_init(&gc_mutex, NULL) != 0) {
-      fprintf(stderr, "Fatal: Failed to initialize GC mutex\n");
-      abort();
-    }
-    gc_mutex_initialized = true;
-  }
-
+static void gc_leak_table_insert(KronosValue *val) {
   pthread_mutex_lock(&gc_mutex);
-  // Free any previously allocated memory if gc_init is called multiple times
-  if (gc_state.entries && gc_state.count > 0) {
-    // Save entries and capacity before clearing state
-    GCHashEntry *entries = gc_state.entries;
-    size_t capacity = gc_state.capacity;
-    gc_state.entries = NULL;
-    gc_state.count = 0;
-    gc_state.capacity = 0;
-    gc_state.allocated_bytes = 0;
-
-    // Finalize all tracked objects (similar to gc_cleanup)
-    // Only finalize objects with refcount == 1 (only GC tracking reference)
-    // NOTE: We keep the mutex locked during finalization to prevent race
-    // conditions. Another thread calling gc_track() during this window could
-    // allocate a new hash table while we're still iterating over the old one.
-    // We manually finalize objects (inline value_finalize logic) to avoid
-    // deadlock since value_finalize() -> gc_untrack() would try to lock the
-    // mutex again. Since gc_state.entries is NULL, untracking is not needed.
-    for (size_t i = 0; i < capacity; i++) {
-      if (entries[i].object && !entries[i].is_tombstone) {
-        KronosValue *obj = entries[i].object;
-        if (obj->refcount == 1) {
-          // Manually finalize without calling value_finalize() to avoid
-          // deadlock (value_finalize() -> gc_untrack() would try to lock mutex)
-          // Free type-specific data
-          switch (obj->type) {
-          case VAL_STRING:
-            free(obj->as.string.data);
-            break;
-          case VAL_FUNCTION:
-            free(obj->as.function.bytecode);
-            break;
-          case VAL_LIST:
-            free(obj->as.list.items);
-            break;
-          case VAL_MAP:
-            free(obj->as.map.entries);
-            break;
-          case VAL_CHANNEL:
-            // Channels are currently managed externally
-            break;
-          case VAL_RANGE:
-            // Ranges don't own other values
-            break;
-          default:
-            break;
-          }
-          free(obj);
-        }
-      }
+  if (gc_ensure_capacity_locked()) {
+    size_t idx = gc_find_slot_locked(val, true);
+    if (idx != SIZE_MAX) {
+      gc_state.entries[idx].object = val;
+      gc_state.entries[idx].is_tombstone = false;
+      gc_state.count++;
     }
-    free(entries);
-  } else if (gc_state.entries) {
-    // Hash table exists but is empty, just free it
-    free(gc_state.entries);
-    // Note: No need to set gc_state.entries = NULL here since memset follows
   }
+  pthread_mutex_unlock(&gc_mutex);
+}
 
-  memset(&gc_state, 0, sizeof(GCState));
-  if (!gc_ensure_capacity_locked()) {
-    // Allocation failed during init - this is fatal
-    fprintf(stderr, "Fatal: Failed to initialize GC tracking table\n");
+/**
+ * @brief Remove an object from the leak-check table
+ *
+ * @return false if @p val was not recorded (never tracked, already
+ * untracked, or dropped by gc_cleanup())
+ */
+static bool gc_leak_table_remove(KronosValue *val) {
+  pthread_mutex_lock(&gc_mutex);
+  size_t idx = gc_find_slot_locked(val, false);
+  if (idx == SIZE_MAX) {
     pthread_mutex_unlock(&gc_mutex);
-    abort(); // Init failure is fatal
+    return false;
   }
+  gc_state.entries[idx].object = NULL;
+  gc_state.entries[idx].is_tombstone = true;
+  gc_state.count--;
+  gc_shrink_if_needed_locked();
   pthread_mutex_unlock(&gc_mutex);
+  return true;
+}
+#endif // KRONOS_GC_LEAK_CHECK
+
+/** Header in front of a heap object */
+static inline GCHeader *gc_header(KronosValue *val) {
+  return (GCHeader *)val - 1;
+}
+
+/** Heap object behind a header */
+static inline KronosValue *gc_header_value(GCHeader *header) {
+  return (KronosValue *)(header + 1);
 }
 
 /**
- * @brief Cleanup the garbage collector
+ * @brief Whether a value was allocated by gc_alloc_object()
  *
- * DESIGN DECISION: Uses manual finalization (not value_finalize()) to avoid
- * deadlock and race conditions. Finalize doesn't recursively release children
- * (prevents double-free). Only finalizes refcount == 1 objects (external refs
- * cleaned up naturally).
+ * Immediate numbers and the static true, false and nil cells (see
+ * runtime.c) have no header.
+ */
+static inline bool gc_has_header(const KronosValue *val) {
+  return !value_is_immediate(val) && value_type(val) != VAL_BOOL &&
+         value_type(val) != VAL_NIL;
+}
+
+/**
+ * @brief Adjust a heap counter from its owning thread
  *
- * EDGE CASES: Destroys mutex, idempotent after first call, not thread-safe
- * (call from main thread).
+ * A relaxed load/store pair rather than atomic_fetch_add: the owner is the
+ * only writer, so no locked instruction is needed, while readers on other
+ * threads still see whole values.
+ */
+static inline void gc_counter_add(atomic_size_t *counter, size_t delta) {
+  atomic_store_explicit(
+      counter, atomic_load_explicit(counter, memory_order_relaxed) + delta,
+      memory_order_relaxed);
+}
+
+static inline void gc_counter_sub(atomic_size_t *counter, size_t delta) {
+  atomic_store_explicit(
+      counter, atomic_load_explicit(counter, memory_order_relaxed) - delta,
+      memory_order_relaxed);
+}
+
+/** Make a heap's object list empty and zero its counters */
+static void gc_heap_reset(GCHeap *heap) {
+  heap->objects.prev = &heap->objects;
+  heap->objects.next = &heap->objects;
+  atomic_store_explicit(&heap->object_count, 0, memory_order_relaxed);
+  atomic_store_explicit(&heap->allocated_bytes, 0, memory_order_relaxed);
+}
+
+/** Forget a heap's free lists and current chunks and zero its counters */
+static void gc_slab_reset(GCHeap *heap) {
+  for (size_t i = 0; i < GC_SLAB_CLASS_COUNT; i++) {
+    GCSlabClass *slab = &heap->slabs[i];
+    slab->free_list = NULL;
+    slab->bump = NULL;
+    slab->bump_end = NULL;
+    atomic_store_explicit(&slab->blocks_in_use, 0, memory_order_relaxed);
+    atomic_store_explicit(&slab->blocks_carved, 0, memory_order_relaxed);
+  }
+}
+
+/**
+ * @brief Retire the heap of an exiting thread
  *
- * THREAD-SAFETY: This function must be called from the main thread. The mutex
- * is kept locked during cleanup to prevent race conditions where another thread
- * could call gc_track() and corrupt the hash table state during shutdown.
+ * Thread-specific data destructor. Objects still alive move to the orphan
+ * heap so they stay accounted (and are released by gc_cleanup()), and the
+ * heap leaves the registry before its thread-local storage goes away.
  */
-void gc_cleanup(void) {
+static void gc_heap_retire(void *arg) {
+  GCHeap *heap = arg;
+
   pthread_mutex_lock(&gc_mutex);
-  GCHashEntry *entries = gc_state.entries;
-  size_t capacity = gc_state.capacity;
-  gc_state.entries = NULL;
-  gc_state.count = 0;
-  gc_state.capacity = 0;
-  gc_state.allocated_bytes = 0;
-
-  if (!entries) {
-    pthread_mutex_unlock(&gc_mutex);
-    // Destroy the mutex to prevent resource leak
-    if (gc_mutex_initialized) {
-      pthread_mutex_destroy(&gc_mutex);
-      gc_mutex_initialized = false;
-    }
-    return;
+  if (!gc_orphans.objects.next)
+    gc_heap_reset(&gc_orphans);
+
+  GCHeader *first = heap->objects.next;
+  if (first != &heap->objects) {
+    for (GCHeader *header = first; header != &heap->objects;
+         header = header->next)
+      header->heap = &gc_orphans;
+    GCHeader *last = heap->objects.prev;
+    GCHeader *tail = gc_orphans.objects.prev;
+    tail->next = first;
+    first->prev = tail;
+    last->next = &gc_orphans.objects;
+    gc_orphans.objects.prev = last;
+    gc_counter_add(&gc_orphans.object_count,
+                   atomic_load_explicit(&heap->object_count,
+                                        memory_order_relaxed));
+    gc_counter_add(&gc_orphans.allocated_bytes,
+                   atomic_load_explicit(&heap->allocated_bytes,
+                                        memory_order_relaxed));
+  }
+  gc_heap_reset(heap);
+
+  // Free blocks stay stranded in the heap's chunks (reclaimed when the
+  // chunks are released); the counters move so the totals stay right
+  for (size_t i = 0; i < GC_SLAB_CLASS_COUNT; i++) {
+    gc_counter_add(&gc_orphans.slabs[i].blocks_in_use,
+                   atomic_load_explicit(&heap->slabs[i].blocks_in_use,
+                                        memory_order_relaxed));
+    gc_counter_add(&gc_orphans.slabs[i].blocks_carved,
+                   atomic_load_explicit(&heap->slabs[i].blocks_carved,
+                                        memory_order_relaxed));
   }
+  gc_slab_reset(heap);
 
-  // Finalize all objects without releasing children to avoid use-after-free.
-  // Children will be finalized separately when we encounter them in the hash
-  // table. Only finalize objects with refcount == 1 (only GC tracking
-  // reference). Objects with refcount > 1 have external references and should
-  // not be freed.
-  // NOTE: We keep the mutex locked during finalization to prevent race
-  // conditions. Another thread calling gc_track() during this window could
-  // allocate a new hash table while we're still iterating over the old one.
-  // We manually finalize objects (inline value_finalize logic) to avoid
-  // deadlock since value_finalize() -> gc_untrack() would try to lock the
-  // mutex again. Since gc_state.entries is NULL, untracking is not needed.
-  for (size_t i = 0; i < capacity; i++) {
-    if (entries[i].object && !entries[i].is_tombstone) {
-      KronosValue *obj = entries[i].object;
-      if (obj->refcount == 1) {
-        // Only GC tracking reference, safe to finalize
-        // Objects with refcount > 1 have external references and will be
-        // cleaned up naturally when their refcount reaches 0
-        // Manually finalize without calling value_finalize() to avoid
-        // deadlock (value_finalize() -> gc_untrack() would try to lock mutex)
-        // Free type-specific data
-        switch (obj->type) {
-        case VAL_STRING:
-          free(obj->as.string.data);
-          break;
-        case VAL_FUNCTION:
-          free(obj->as.function.bytecode);
-          break;
-        case VAL_LIST:
-          free(obj->as.list.items);
-          break;
-        case VAL_MAP:
-          free(obj->as.map.entries);
-          break;
-        case VAL_CHANNEL:
-          // Channels are currently managed externally
-          break;
-        case VAL_RANGE:
-          // Ranges don't own other values
-          break;
-        default:
-          break;
-        }
-        free(obj);
-      }
+  for (GCHeap **link = &gc_heaps; *link; link = &(*link)->next) {
+    if (*link == heap) {
+      *link = heap->next;
+      break;
     }
   }
-  free(entries);
-
+  heap->next = NULL;
+  heap->registered = false;
   pthread_mutex_unlock(&gc_mutex);
+}
 
-  // Destroy the mutex to prevent resource leak
-  if (gc_mutex_initialized) {
-    pthread_mutex_destroy(&gc_mutex);
-    gc_mutex_initialized = false;
+static void gc_heap_key_create(void) {
+  if (pthread_key_create(&gc_heap_key, gc_heap_retire) != 0) {
+    fprintf(stderr, "Fatal: Failed to create GC heap key\n");
+    abort();
   }
 }
 
 /**
- * @brief Track a newly allocated object
+ * @brief Heap of the calling thread
  *
- * Adds the object to the tracking array for leak detection and statistics.
- * Prevents duplicate tracking of the same object.
- *
- * @param val Object to track (safe to pass NULL)
+ * EDGE CASES: The first call on a thread links its heap into the registry
+ * (the only locked step) and arms the thread-exit destructor.
  */
-void gc_track(KronosValue *val) {
-  if (!val)
-    return;
+static GCHeap *gc_current_heap(void) {
+  GCHeap *heap = &gc_thread_heap;
+  if (heap->registered)
+    return heap;
+
+  pthread_once(&gc_heap_key_once, gc_heap_key_create);
+  pthread_setspecific(gc_heap_key, heap);
 
   pthread_mutex_lock(&gc_mutex);
+  gc_heap_reset(heap);
+  heap->next = gc_heaps;
+  gc_heaps = heap;
+  heap->registered = true;
+  pthread_mutex_unlock(&gc_mutex);
+  return heap;
+}
 
-  // Check if object is already tracked using hash set (O(1) lookup)
-  size_t idx = gc_find_slot_locked(val, false);
-  if (idx != SIZE_MAX) {
-    // Already tracked, skip
-#ifdef DEBUG
-    // In debug builds, this indicates a bug (double-tracking)
-    fprintf(stderr, "Warning: gc_track() called on already-tracked object %p\n",
-            (void *)val);
-#endif
+#if !KRONOS_GC_LEAK_CHECK
+/**
+ * @brief Carve a block from the current chunk, starting a new one if needed
+ *
+ * EDGE CASES: The tail of a chunk too small for the block is abandoned (less
+ * than one block). Chunk allocation is the only locked step, to register the
+ * chunk.
+ */
+static GCSlabBlock *gc_slab_carve(GCSlabClass *slab, size_t block_size) {
+  if ((size_t)(slab->bump_end - slab->bump) < block_size) {
+    GCSlabChunk *chunk = malloc(GC_SLAB_CHUNK_SIZE);
+    if (!chunk)
+      return NULL;
+
+    pthread_mutex_lock(&gc_mutex);
+    chunk->next = gc_slab_chunks;
+    gc_slab_chunks = chunk;
+    gc_slab_chunk_count++;
     pthread_mutex_unlock(&gc_mutex);
-    return;
+
+    slab->bump = (char *)chunk + GC_SLAB_ALIGN;
+    slab->bump_end = (char *)chunk + GC_SLAB_CHUNK_SIZE;
   }
 
-  // Object not found, ensure capacity and add it
-  if (!gc_ensure_capacity_locked()) {
-    // Allocation failed - log error and return early (don't abort)
-    fprintf(stderr,
-            "Warning: gc_track() failed to allocate memory for object %p\n",
-            (void *)val);
-    pthread_mutex_unlock(&gc_mutex);
+  GCSlabBlock *block = (GCSlabBlock *)slab->bump;
+  slab->bump += block_size;
+  gc_counter_add(&slab->blocks_carved, 1);
+  return block;
+}
+#endif
+
+void *gc_alloc(size_t size) {
+#if KRONOS_GC_LEAK_CHECK
+  return malloc(size);
+#else
+  if (size > GC_SLAB_MAX_BLOCK)
+    return malloc(size);
+
+  size_t class_index = gc_slab_class_by_16[(size + 15) / 16];
+  GCSlabClass *slab = &gc_current_heap()->slabs[class_index];
+  GCSlabBlock *block = slab->free_list;
+  if (block) {
+    slab->free_list = block->next;
+  } else {
+    block = gc_slab_carve(slab, gc_slab_block_sizes[class_index]);
+    if (!block)
+      return NULL;
+  }
+  gc_counter_add(&slab->blocks_in_use, 1);
+  return block;
+#endif
+}
+
+void gc_free(void *ptr, size_t size) {
+  if (!ptr)
+    return;
+#if KRONOS_GC_LEAK_CHECK
+  (void)size;
+  free(ptr);
+#else
+  if (size > GC_SLAB_MAX_BLOCK) {
+    free(ptr);
     return;
   }
-  idx = gc_find_slot_locked(val, true);
-  if (idx == SIZE_MAX) {
-    // Should not happen if capacity was ensured, but handle gracefully
-    fprintf(stderr, "Warning: gc_track() failed to find slot for object %p\n",
-            (void *)val);
-    pthread_mutex_unlock(&gc_mutex);
+
+  GCSlabClass *slab =
+      &gc_current_heap()->slabs[gc_slab_class_by_16[(size + 15) / 16]];
+  GCSlabBlock *block = ptr;
+  block->next = slab->free_list;
+  slab->free_list = block;
+  gc_counter_sub(&slab->blocks_in_use, 1);
+#endif
+}
+
+void *gc_realloc(void *ptr, size_t old_size, size_t new_size) {
+  if (!ptr)
+    return gc_alloc(new_size);
+#if KRONOS_GC_LEAK_CHECK
+  (void)old_size;
+  return realloc(ptr, new_size);
+#else
+  if (old_size > GC_SLAB_MAX_BLOCK && new_size > GC_SLAB_MAX_BLOCK)
+    return realloc(ptr, new_size);
+  if (old_size <= GC_SLAB_MAX_BLOCK && new_size <= GC_SLAB_MAX_BLOCK &&
+      gc_slab_class_by_16[(old_size + 15) / 16] ==
+          gc_slab_class_by_16[(new_size + 15) / 16])
+    return ptr;
+
+  void *resized = gc_alloc(new_size);
+  if (!resized)
+    return NULL;
+  memcpy(resized, ptr, old_size < new_size ? old_size : new_size);
+  gc_free(ptr, old_size);
+  return resized;
+#endif
+}
+
+/** Blocks in use over every heap (wrapping per-heap counts sum correctly) */
+static size_t gc_slab_in_use_locked(void) {
+  size_t in_use = 0;
+  for (GCHeap *heap = gc_heaps; heap; heap = heap->next) {
+    for (size_t i = 0; i < GC_SLAB_CLASS_COUNT; i++)
+      in_use += atomic_load_explicit(&heap->slabs[i].blocks_in_use,
+                                     memory_order_relaxed);
+  }
+  for (size_t i = 0; i < GC_SLAB_CLASS_COUNT; i++)
+    in_use += atomic_load_explicit(&gc_orphans.slabs[i].blocks_in_use,
+                                   memory_order_relaxed);
+  return in_use;
+}
+
+/**
+ * @brief Return every slab chunk to the system once no block is in use
+ *
+ * EDGE CASES: Does nothing while any block is live (a value that outlived
+ * gc_cleanup() still points into its chunk). Caller holds gc_mutex and no
+ * other thread allocates.
+ */
+static void gc_slab_release_locked(void) {
+  if (gc_slab_in_use_locked() != 0)
     return;
+
+  while (gc_slab_chunks) {
+    GCSlabChunk *next = gc_slab_chunks->next;
+    free(gc_slab_chunks);
+    gc_slab_chunks = next;
   }
+  gc_slab_chunk_count = 0;
+  for (GCHeap *heap = gc_heaps; heap; heap = heap->next)
+    gc_slab_reset(heap);
+  gc_slab_reset(&gc_orphans);
+}
 
-  gc_state.entries[idx].object = val;
-  gc_state.entries[idx].is_tombstone = false;
-  gc_state.count++;
-  gc_state.allocated_bytes += sizeof(KronosValue);
+/**
+ * @brief Bytes charged for an object: value, header and owned buffers
+ *
+ * Measured once when the object is tracked; gc_untrack() subtracts the same
+ * amount, so later growth of a list or map cannot skew the counters.
+ */
+static size_t gc_object_bytes(const KronosValue *val) {
+  size_t bytes = sizeof(GCHeader) + sizeof(KronosValue);
 
-  // Add size of type-specific data
-  switch (val->type) {
+  switch (value_type(val)) {
   case VAL_STRING:
-    gc_state.allocated_bytes += val->as.string.length + 1;
+    bytes += val->as.string.length + 1;
     break;
   case VAL_LIST:
-    // Track list item array: capacity * sizeof(KronosValue*)
-    if (val->as.list.capacity > 0) {
-      gc_state.allocated_bytes += val->as.list.capacity * sizeof(KronosValue *);
-    }
+    bytes += val->as.list.capacity * sizeof(KronosValue *);
     break;
-  case VAL_MAP: {
-    // Track map entries array: capacity * sizeof(MapEntry)
-    // MapEntry contains: KronosValue* key, KronosValue* value, bool
-    // is_tombstone Size is approximately: capacity * (sizeof(KronosValue*) * 2
-    // + sizeof(bool)) Using sizeof(void*) * 2 + sizeof(bool) for portability
-    if (val->as.map.capacity > 0) {
-      gc_state.allocated_bytes +=
-          val->as.map.capacity * (sizeof(void *) * 2 + sizeof(bool));
-    }
+  case VAL_MAP:
+    bytes += val->as.map.capacity * sizeof(MapEntry);
+    break;
+  case VAL_FUNCTION:
+    if (val->as.function.bytecode)
+      bytes += val->as.function.length;
+    break;
+  default:
     break;
   }
+  return bytes;
+}
+
+/** Unlink a tracked object from @p heap and uncharge it */
+static void gc_heap_unlink(GCHeap *heap, GCHeader *header) {
+  header->prev->next = header->next;
+  header->next->prev = header->prev;
+  header->prev = NULL;
+  header->next = NULL;
+  gc_counter_sub(&heap->object_count, 1);
+  gc_counter_sub(&heap->allocated_bytes, header->bytes);
+}
+
+/**
+ * @brief Free an object and the buffers it owns, without releasing children
+ *
+ * Used where value_release() cannot run: at cleanup, children are freed when
+ * the walk reaches them, and the cycle collector frees whole cycles.
+ */
+static void gc_finalize_object(KronosValue *obj) {
+  switch (value_type(obj)) {
+  case VAL_STRING:
+    if (!value_string_is_inline(obj))
+      gc_free(obj->as.string.data, obj->as.string.length + 1);
+    break;
   case VAL_FUNCTION:
-    // Track function bytecode buffer
-    if (val->as.function.bytecode && val->as.function.length > 0) {
-      gc_state.allocated_bytes += val->as.function.length;
-    }
+    free(obj->as.function.bytecode);
+    break;
+  case VAL_LIST:
+    gc_free(obj->as.list.items, obj->as.list.capacity * sizeof(KronosValue *));
+    break;
+  case VAL_MAP:
+    gc_free(obj->as.map.entries, obj->as.map.capacity * sizeof(MapEntry));
+    break;
+  case VAL_CHANNEL:
+    // Channels are currently managed externally
+    break;
+  case VAL_RANGE:
+    // Ranges don't own other values
     break;
   default:
     break;
   }
+  gc_free_object(obj);
+}
+
+/**
+ * @brief Stop tracking every object of a heap
+ *
+ * DESIGN DECISION: Only objects with refcount == 1 (the last reference) are
+ * freed; objects with refcount > 1 have external references and are cleaned
+ * up naturally when their refcount reaches 0 (their untrack is then a no-op).
+ * Finalizing does not release children, so a child is never freed twice.
+ *
+ * EDGE CASES: Caller holds gc_mutex and no other thread uses the heap.
+ */
+static void gc_heap_release_locked(GCHeap *heap) {
+  GCHeader *header = heap->objects.next;
+  while (header != &heap->objects) {
+    GCHeader *next = header->next;
+    KronosValue *obj = gc_header_value(header);
+    header->prev = NULL;
+    header->next = NULL;
+    if (obj->refcount == 1)
+      gc_finalize_object(obj);
+    header = next;
+  }
+  gc_heap_reset(heap);
+}
+
+/**
+ * @brief Release every heap, including the orphans of exited threads, then
+ * the slab chunks if nothing uses them any more
+ *
+ * EDGE CASES: The calling thread's heap must already be registered: freed
+ * blocks go to its slabs, and registering here would take gc_mutex again.
+ */
+static void gc_release_all_locked(void) {
+  for (GCHeap *heap = gc_heaps; heap; heap = heap->next)
+    gc_heap_release_locked(heap);
+  if (gc_orphans.objects.next)
+    gc_heap_release_locked(&gc_orphans);
+  gc_slab_release_locked();
+}
+
+/**
+ * @brief Initialize the garbage collector
+ *
+ * DESIGN DECISION: Idempotent - releases previously tracked objects (frees
+ * those with refcount == 1) before starting over, so reinitializing without
+ * an explicit cleanup does not leak.
+ *
+ * EDGE CASES: Leak-check table allocation failure aborts, not thread-safe
+ * (call from main thread).
+ */
+void gc_init(void) {
+  gc_current_heap();
+  pthread_mutex_lock(&gc_mutex);
+  gc_release_all_locked();
+
+#if KRONOS_GC_LEAK_CHECK
+  free(gc_state.entries);
+  memset(&gc_state, 0, sizeof(GCState));
+  if (!gc_ensure_capacity_locked()) {
+    // Allocation failed during init - this is fatal
+    fprintf(stderr, "Fatal: Failed to initialize GC tracking table\n");
+    pthread_mutex_unlock(&gc_mutex);
+    abort(); // Init failure is fatal
+  }
+#endif
+  pthread_mutex_unlock(&gc_mutex);
+}
+
+/**
+ * @brief Cleanup the garbage collector
+ *
+ * DESIGN DECISION: Finalizes objects directly (not via value_release()) so a
+ * child is never released through a parent that was already freed. Heaps
+ * stay registered, so values created afterwards are tracked again.
+ *
+ * EDGE CASES: Idempotent, not thread-safe (call from main thread). Leak-check
+ * builds report the objects still tracked.
+ */
+void gc_cleanup(void) {
+  gc_current_heap();
+  pthread_mutex_lock(&gc_mutex);
+
+#if KRONOS_GC_LEAK_CHECK
+  if (gc_state.count > 0) {
+    fprintf(stderr, "GC leak check: %zu objects still tracked at cleanup\n",
+            gc_state.count);
+  }
+  free(gc_state.entries);
+  memset(&gc_state, 0, sizeof(GCState));
+#endif
+
+  gc_release_all_locked();
   pthread_mutex_unlock(&gc_mutex);
 }
 
+KronosValue *gc_alloc_object(void) { return gc_alloc_object_inline(0); }
+
+KronosValue *gc_alloc_object_inline(size_t inline_bytes) {
+  if (inline_bytes > UINT16_MAX)
+    return NULL;
+  GCHeader *header =
+      gc_alloc(sizeof(GCHeader) + sizeof(KronosValue) + inline_bytes);
+  if (!header)
+    return NULL;
+
+  header->prev = NULL;
+  header->next = NULL;
+  header->heap = NULL;
+  header->bytes = 0;
+  header->inline_bytes = (uint16_t)inline_bytes;
+  header->marked = false;
+  // Cell pointers must never look like immediate numbers
+  assert(!value_is_immediate(gc_header_value(header)));
+  return gc_header_value(header);
+}
+
+void gc_free_object(KronosValue *val) {
+  if (val) {
+    GCHeader *header = gc_header(val);
+    gc_free(header,
+            sizeof(GCHeader) + sizeof(KronosValue) + header->inline_bytes);
+  }
+}
+
+/**
+ * @brief Track a newly allocated object
+ *
+ * Links the object into the calling thread's heap and charges its size.
+ * Prevents duplicate tracking of the same object.
+ *
+ * @param val Object to track (safe to pass NULL)
+ */
+void gc_track(KronosValue *val) {
+  if (!val || !gc_has_header(val))
+    return;
+
+  GCHeader *header = gc_header(val);
+  if (header->prev) {
+    // Already tracked, skip
+#if KRONOS_GC_LEAK_CHECK
+    fprintf(stderr, "Warning: gc_track() called on already-tracked object %p\n",
+            (void *)val);
+#endif
+    return;
+  }
+
+  GCHeap *heap = gc_current_heap();
+  size_t bytes = gc_object_bytes(val);
+  header->heap = heap;
+  header->bytes = bytes > UINT32_MAX ? UINT32_MAX : (uint32_t)bytes;
+  header->marked = false;
+  header->prev = &heap->objects;
+  header->next = heap->objects.next;
+  heap->objects.next->prev = header;
+  heap->objects.next = header;
+  gc_counter_add(&heap->object_count, 1);
+  gc_counter_add(&heap->allocated_bytes, header->bytes);
+
+#if KRONOS_GC_LEAK_CHECK
+  gc_leak_table_insert(val);
+#endif
+}
+
 /**
  * @brief Remove an object from tracking
  *
- * Called when an object is being freed. Removes it from the tracking array
- * and updates statistics.
+ * Called when an object is being freed. Unlinks it from the heap that
+ * tracked it and subtracts the bytes charged when it was tracked.
+ *
+ * EDGE CASES: Objects of exited threads sit in the shared orphan heap and
+ * are unlinked under gc_mutex. A live thread links and unlinks its own heap
+ * without a lock, so releasing its objects on another thread is not
+ * supported (asserted; builds without asserts still unlink from the right
+ * heap, under the lock).
  *
  * @param val Object to untrack (safe to pass NULL)
  */
 void gc_untrack(KronosValue *val) {
-  if (!val)
+  if (!val || !gc_has_header(val))
     return;
 
-  pthread_mutex_lock(&gc_mutex);
-
-  // Find object in hash set (O(1) average case)
-  size_t idx = gc_find_slot_locked(val, false);
-  if (idx == SIZE_MAX) {
-#ifdef DEBUG
-    // Assert: object should be tracked (catch use-after-free or double-untrack)
+#if KRONOS_GC_LEAK_CHECK
+  // Check the table before trusting the header of a possibly freed object
+  if (!gc_leak_table_remove(val)) {
     fprintf(stderr,
             "Warning: gc_untrack() called on untracked object %p (possible "
             "use-after-free or double-untrack)\n",
             (void *)val);
-#endif
-    pthread_mutex_unlock(&gc_mutex);
     return;
   }
+#endif
 
-  // Subtract from allocated bytes
-  gc_state.allocated_bytes -= sizeof(KronosValue);
-
-  // Subtract size of type-specific data
-  switch (val->type) {
-  case VAL_STRING:
-    gc_state.allocated_bytes -= val->as.string.length + 1;
-    break;
-  case VAL_LIST:
-    // Subtract list item array size
-    if (val->as.list.capacity > 0) {
-      gc_state.allocated_bytes -= val->as.list.capacity * sizeof(KronosValue *);
-    }
-    break;
-  case VAL_MAP: {
-    // Subtract map entries array size
-    if (val->as.map.capacity > 0) {
-      gc_state.allocated_bytes -=
-          val->as.map.capacity * (sizeof(void *) * 2 + sizeof(bool));
-    }
-    break;
-  }
-  case VAL_FUNCTION:
-    // Subtract function bytecode buffer size
-    if (val->as.function.bytecode && val->as.function.length > 0) {
-      gc_state.allocated_bytes -= val->as.function.length;
-    }
-    break;
-  default:
-    break;
+  GCHeader *header = gc_header(val);
+  if (!header->prev)
+    return;
+  if (header->heap == &gc_thread_heap) {
+    gc_heap_unlink(header->heap, header);
+    return;
   }
 
-  // Remove from hash set by marking as tombstone (O(1))
-  gc_state.entries[idx].object = NULL;
-  gc_state.entries[idx].is_tombstone = true;
-  gc_state.count--;
-
-  // Shrink hash table if significantly underutilized
-  gc_shrink_if_needed_locked();
-
+  pthread_mutex_lock(&gc_mutex);
+  assert(header->heap == &gc_orphans &&
+         "object released on a thread other than the one that created it");
+  if (header->prev)
+    gc_heap_unlink(header->heap, header);
   pthread_mutex_unlock(&gc_mutex);
 }
 
 /**
  * @brief Mark all objects reachable from a given object
  *
- * Helper function for mark-and-sweep. Recursively marks all objects
+ * Helper function for mark-and-sweep. Recursively marks all tracked objects
  * reachable from the given object.
  *
  * @param val Object to start marking from
- * @param marked Hash table mapping object pointers to marked status
- * @param capacity Capacity of the hash table
- * @param entries Hash table entries
  */
-static void gc_mark_reachable(KronosValue *val, bool *marked, size_t capacity,
-                              GCHashEntry *entries) {
-  if (!val)
+static void gc_mark_reachable(KronosValue *val) {
+  if (!val || !gc_has_header(val))
     return;
 
-  // Find index of this object in the hash table
-  size_t hash = gc_hash_pointer(val);
-  size_t start_idx = hash % capacity;
-  size_t idx = start_idx;
-
-  // Linear probing to find the object
-  while (true) {
-    if (entries[idx].object == val && !entries[idx].is_tombstone) {
-      // Found the object
-      break;
-    }
-    if (entries[idx].object == NULL) {
-      // Not tracked
-      return;
-    }
-    idx = (idx + 1) % capacity;
-    if (idx == start_idx) {
-      // Wrapped around, not found
-      return;
-    }
-  }
-
-  // If already marked, return
-  if (marked[idx])
+  GCHeader *header = gc_header(val);
+  // Untracked objects are not collected, and marked ones were visited
+  if (!header->prev || header->marked)
     return;
-
-  // Mark this object
-  marked[idx] = true;
+  header->marked = true;
 
   // Recursively mark reachable objects based on type
-  switch (val->type) {
+  switch (value_type(val)) {
   case VAL_LIST:
     // Mark all items in the list
     if (val->as.list.items) {
       for (size_t i = 0; i < val->as.list.count; i++) {
-        if (val->as.list.items[i]) {
-          gc_mark_reachable(val->as.list.items[i], marked, capacity, entries);
-        }
+        gc_mark_reachable(val->as.list.items[i]);
       }
     }
     break;
@@ -671,11 +1030,9 @@ static void gc_mark_reachable(KronosValue *val, bool *marked, size_t capacity,
     if (map_entries) {
       for (size_t i = 0; i < val->as.map.capacity; i++) {
         if (map_entries[i].key && !map_entries[i].is_tombstone) {
-          gc_mark_reachable(map_entries[i].key, marked, capacity, entries);
-        }
-        if (map_entries[i].value) {
-          gc_mark_reachable(map_entries[i].value, marked, capacity, entries);
+          gc_mark_reachable(map_entries[i].key);
         }
+        gc_mark_reachable(map_entries[i].value);
       }
     }
     break;
@@ -695,170 +1052,57 @@ static void gc_mark_reachable(KronosValue *val, bool *marked, size_t capacity,
  * roots are marked. Unmarked objects with refcount > 0 are part of cycles
  * and are freed.
  *
- * THREAD-SAFETY: This function is thread-safe. Objects to finalize are
- * collected into a list while holding the mutex, then finalized after
- * releasing it. This prevents race conditions where other threads could
- * modify the hash table during iteration.
+ * THREAD-SAFETY: Scans the calling thread's heap only, which no other thread
+ * modifies, so it takes no lock.
  */
 void gc_collect_cycles(void) {
-  pthread_mutex_lock(&gc_mutex);
-
-  if (gc_state.count == 0 || gc_state.capacity == 0) {
-    pthread_mutex_unlock(&gc_mutex);
-    return;
-  }
-
-  // Allocate array to track which objects are marked (indexed by hash table
-  // slot)
-  bool *marked = calloc(gc_state.capacity, sizeof(bool));
-  if (!marked) {
-    pthread_mutex_unlock(&gc_mutex);
-    return; // Can't allocate, skip cycle collection
-  }
+  GCHeap *heap = gc_current_heap();
+  GCHeader *sentinel = &heap->objects;
 
   // Mark phase: Mark all objects reachable from roots (objects with refcount >
   // 1)
-  for (size_t i = 0; i < gc_state.capacity; i++) {
-    if (gc_state.entries[i].object && !gc_state.entries[i].is_tombstone) {
-      KronosValue *obj = gc_state.entries[i].object;
-      if (obj->refcount > 1) {
-        // This object has external references, mark it and all reachable
-        // objects
-        gc_mark_reachable(obj, marked, gc_state.capacity, gc_state.entries);
-      }
-    }
-  }
-
-  // Sweep phase: Free unmarked objects (they're part of cycles)
-  // Collect objects to finalize while holding the lock to avoid race conditions
-  // where other threads could modify the hash table during iteration
-  size_t to_finalize_count = 0;
-  size_t to_finalize_capacity = 16;
-  KronosValue **to_finalize =
-      malloc(to_finalize_capacity * sizeof(KronosValue *));
-  if (!to_finalize) {
-    // If we can't allocate, skip finalization but still clean up marked array
-    free(marked);
-    pthread_mutex_unlock(&gc_mutex);
-    return;
-  }
-
-  // Iterate through hash table and collect objects to finalize
-  for (size_t i = 0; i < gc_state.capacity; i++) {
-    if (gc_state.entries[i].object && !gc_state.entries[i].is_tombstone) {
-      KronosValue *obj = gc_state.entries[i].object;
-      if (!marked[i] && obj->refcount > 0) {
-        // Unmarked object with refcount > 0 is part of a cycle
-        // Decrement refcount and collect for finalization if it reaches 0
-        // Note: We can't use value_release() here because it would try to
-        // untrack, which modifies the hash table we're iterating. Instead, we
-        // manually decrement refcount and collect for finalization.
-        obj->refcount--;
-        if (obj->refcount == 0) {
-          // Grow array if needed
-          if (to_finalize_count >= to_finalize_capacity) {
-            size_t new_capacity = to_finalize_capacity * 2;
-            KronosValue **new_array =
-                realloc(to_finalize, new_capacity * sizeof(KronosValue *));
-            if (!new_array) {
-              // If realloc fails, finalize what we have so far
-              free(to_finalize);
-              to_finalize = NULL;
-              to_finalize_count = 0;
-              break;
-            }
-            to_finalize = new_array;
-            to_finalize_capacity = new_capacity;
-          }
-
-          // Remove from hash table by marking as tombstone
-          gc_state.entries[i].object = NULL;
-          gc_state.entries[i].is_tombstone = true;
-          gc_state.count--;
-
-          // Update allocated bytes
-          gc_state.allocated_bytes -= sizeof(KronosValue);
-          switch (obj->type) {
-          case VAL_STRING:
-            gc_state.allocated_bytes -= obj->as.string.length + 1;
-            break;
-          case VAL_LIST:
-            if (obj->as.list.capacity > 0) {
-              gc_state.allocated_bytes -=
-                  obj->as.list.capacity * sizeof(KronosValue *);
-            }
-            break;
-          case VAL_MAP:
-            if (obj->as.map.capacity > 0) {
-              gc_state.allocated_bytes -=
-                  obj->as.map.capacity * (sizeof(void *) * 2 + sizeof(bool));
-            }
-            break;
-          case VAL_FUNCTION:
-            if (obj->as.function.bytecode && obj->as.function.length > 0) {
-              gc_state.allocated_bytes -= obj->as.function.length;
-            }
-            break;
-          default:
-            break;
-          }
-
-          // Add to finalization list
-          to_finalize[to_finalize_count++] = obj;
-        }
-      }
-    }
+  for (GCHeader *header = sentinel->next; header != sentinel;
+       header = header->next) {
+    KronosValue *obj = gc_header_value(header);
+    if (obj->refcount > 1)
+      gc_mark_reachable(obj);
   }
 
-  free(marked);
-  pthread_mutex_unlock(&gc_mutex);
-
-  // Now finalize all collected objects (mutex is unlocked)
-  // We manually finalize to avoid redundant gc_untrack() call since we've
-  // already removed the objects from tracking and updated stats
-  for (size_t i = 0; i < to_finalize_count; i++) {
-    KronosValue *obj = to_finalize[i];
-    // Free type-specific data
-    switch (obj->type) {
-    case VAL_STRING:
-      free(obj->as.string.data);
-      break;
-    case VAL_FUNCTION:
-      free(obj->as.function.bytecode);
-      break;
-    case VAL_LIST:
-      free(obj->as.list.items);
-      break;
-    case VAL_MAP:
-      free(obj->as.map.entries);
-      break;
-    case VAL_CHANNEL:
-      // Channels are currently managed externally
-      break;
-    case VAL_RANGE:
-      // Ranges don't own other values
-      break;
-    default:
-      break;
+  // Sweep phase: Free unmarked objects (they're part of cycles) and clear the
+  // marks of the survivors. Freeing an object does not touch the others, so
+  // the walk can continue from the saved successor.
+  GCHeader *header = sentinel->next;
+  while (header != sentinel) {
+    GCHeader *next = header->next;
+    KronosValue *obj = gc_header_value(header);
+    if (header->marked) {
+      header->marked = false;
+    } else if (obj->refcount > 0 && --obj->refcount == 0) {
+      // Not value_release(): that would release children that may already
+      // have been finalized by this sweep
+      gc_heap_unlink(heap, header);
+#if KRONOS_GC_LEAK_CHECK
+      gc_leak_table_remove(obj);
+#endif
+      gc_finalize_object(obj);
     }
-    free(obj);
+    header = next;
   }
-  free(to_finalize);
 }
 
 /**
  * @brief Get total allocated memory in bytes
  *
- * Returns an approximate count of memory allocated for KronosValue objects.
- * Includes the value structures and string data.
+ * Returns an approximate count of memory allocated for KronosValue objects,
+ * summed over every heap. Includes the value structures, their headers and
+ * the buffers they owned when tracked.
  *
  * @return Total allocated bytes
  */
 size_t gc_get_allocated_bytes(void) {
-  pthread_mutex_lock(&gc_mutex);
-  size_t bytes = gc_state.allocated_bytes;
-  pthread_mutex_unlock(&gc_mutex);
-  return bytes;
+  GCStats stats;
+  gc_stats(&stats);
+  return stats.allocated_bytes;
 }
 
 /**
@@ -869,17 +1113,36 @@ size_t gc_get_allocated_bytes(void) {
  * @return Number of tracked objects
  */
 size_t gc_get_object_count(void) {
-  pthread_mutex_lock(&gc_mutex);
-  size_t count = gc_state.count;
-  pthread_mutex_unlock(&gc_mutex);
-  return count;
+  GCStats stats;
+  gc_stats(&stats);
+  return stats.object_count;
+}
+
+/** Add one heap's counters to @p stats */
+static void gc_stats_add_heap(GCStats *stats, GCHeap *heap) {
+  stats->object_count +=
+      atomic_load_explicit(&heap->object_count, memory_order_relaxed);
+  stats->allocated_bytes +=
+      atomic_load_explicit(&heap->allocated_bytes, memory_order_relaxed);
+  stats->heap_count++;
+
+  for (size_t i = 0; i < GC_SLAB_CLASS_COUNT; i++) {
+    size_t in_use = atomic_load_explicit(&heap->slabs[i].blocks_in_use,
+                                         memory_order_relaxed);
+    size_t carved = atomic_load_explicit(&heap->slabs[i].blocks_carved,
+                                         memory_order_relaxed);
+    // Blocks freed on another thread make per-heap differences wrap; the
+    // sums over all heaps come out right
+    stats->slab_classes[i].blocks_in_use += in_use;
+    stats->slab_classes[i].blocks_free += carved - in_use;
+  }
 }
 
 /**
  * @brief Get detailed GC statistics
  *
- * Returns comprehensive statistics about the garbage collector state.
- * Useful for debugging memory issues and monitoring memory usage.
+ * Sums the counters of every registered heap and of the orphan heap. Only
+ * the registry walk is locked; the heaps keep counting meanwhile.
  *
  * @param stats Pointer to GCStats structure to fill (must not be NULL)
  */
@@ -887,13 +1150,22 @@ void gc_stats(GCStats *stats) {
   if (!stats)
     return;
 
+  memset(stats, 0, sizeof(GCStats));
   pthread_mutex_lock(&gc_mutex);
-  stats->object_count = gc_state.count;
-  stats->allocated_bytes = gc_state.allocated_bytes;
+  for (GCHeap *heap = gc_heaps; heap; heap = heap->next)
+    gc_stats_add_heap(stats, heap);
+  if (gc_orphans.objects.next)
+    gc_stats_add_heap(stats, &gc_orphans);
+  for (size_t i = 0; i < GC_SLAB_CLASS_COUNT; i++)
+    stats->slab_classes[i].block_size = gc_slab_block_sizes[i];
+  stats->slab_reserved_bytes = gc_slab_chunk_count * GC_SLAB_CHUNK_SIZE;
+
+#if KRONOS_GC_LEAK_CHECK
   stats->array_capacity = gc_state.capacity;
   stats->array_utilization =
       gc_state.capacity > 0
           ? (size_t)((gc_state.count * 100) / gc_state.capacity)
           : 0;
+#endif
   pthread_mutex_unlock(&gc_mutex);
 }
@@ -10,91 +10,175 @@
  * @file gc.h
  * @brief Garbage collector API for Kronos
  *
+ * Every heap object (anything but a number, boolean or nil) is allocated with
+ * gc_alloc_object(), which places an intrusive GCHeader in front of the
+ * value. Tracking links that header into the object list of the calling
+ * thread's heap and bumps the heap's own counters, so it takes no lock and
+ * allocates nothing. gc_stats() sums the counters of every heap.
+ *
+ * Small blocks (object storage, string buffers and small list
+ * and map arrays) come from gc_alloc(), a slab allocator with per-thread
+ * free lists for a few size classes, so short-lived temporaries are
+ * recycled without going back to malloc.
+ *
+ * Builds with -DKRONOS_GC_LEAK_CHECK=1 additionally record every tracked
+ * object in a global mutex-protected table, which catches double and stray
+ * untracks and reports objects still tracked at gc_cleanup(). They also
+ * bypass the slabs, so sanitizers and valgrind see every block.
+ *
  * Thread-Safety Guarantees:
  * =========================
  *
- * All GC functions are NOT thread-safe by default and require external
- * synchronization. The internal mutex (`gc_mutex`) protects the GC state
- * structure, but callers must ensure:
- *
  * 1. **Initialization/Shutdown**: `gc_init()` and `gc_cleanup()` must be called
- *    from a single thread (typically the main thread) during program
- *    initialization/shutdown. These functions are NOT safe to call
- *    concurrently.
+ *    from a single thread (typically the main thread) while no other thread
+ *    is allocating or releasing values.
  *
- * 2. **Tracking Operations**: `gc_track()` and `gc_untrack()` use internal
- *    mutexes for thread-safety. Multiple threads can safely call these
- *    functions concurrently. However, the caller must ensure that the
- *    KronosValue being tracked/untracked is not being modified concurrently.
+ * 2. **Tracking Operations**: `gc_track()` and `gc_untrack()` only touch the
+ *    calling thread's heap and need no synchronization. An object belongs to
+ *    the heap of the thread that tracked it and must be untracked (released)
+ *    on that thread while it runs. A VM runs on a single thread, so this
+ *    holds for every value it creates. Objects still alive when their thread
+ *    exits move to a shared orphan heap; they stay accounted until released
+ *    (on any thread, under the GC mutex) or until gc_cleanup().
  *
  * 3. **Statistics**: `gc_get_allocated_bytes()`, `gc_get_object_count()`, and
- *    `gc_stats()` use internal mutexes and are safe to call from multiple
- *    threads concurrently.
- *
- * 4. **Cycle Collection**: `gc_collect_cycles()` uses internal mutexes but
- *    should typically be called from a single thread to avoid contention.
+ *    `gc_stats()` may be called from any thread. The per-heap counters are
+ *    read atomically, so the totals are consistent per heap but may be
+ *    momentarily stale while other threads allocate.
  *
- * Best Practices:
- * - Call `gc_init()` once at program startup from the main thread
- * - Call `gc_cleanup()` once at program shutdown from the main thread
- * - All other functions can be called from any thread, but ensure KronosValue
- *   objects are not modified concurrently while being tracked/untracked
+ * 4. **Cycle Collection**: `gc_collect_cycles()` scans the calling thread's
+ *    heap only.
  */
 
 /**
  * @brief Initialize the garbage collector.
  *
- * Must be called once before any GC operations.
+ * Must be called once before any GC operations. Calling it again releases
+ * the objects tracked so far, like gc_cleanup().
  *
- * Thread-safety: NOT thread-safe. This function MUST be called from the main
- * thread before any other threads start calling gc_track(). The mutex is kept
- * locked during cleanup to prevent race conditions where another thread could
- * call gc_track() and corrupt the hash table state during reinitialization.
+ * Thread-safety: NOT thread-safe. Call it from the main thread while no
+ * other thread is allocating values.
  */
 void gc_init(void);
 
 /**
  * @brief Clean up and release all GC resources.
  *
- * Should be called once at program shutdown.
+ * Should be called once at program shutdown. Objects whose only remaining
+ * reference is their tracking (refcount 1) are freed; the others stay alive
+ * but are no longer tracked.
  *
- * Thread-safety: NOT thread-safe. This function MUST be called from the main
- * thread. The mutex is kept locked during cleanup to prevent race conditions
- * where another thread could call gc_track() and corrupt the hash table state
- * during shutdown.
+ * Thread-safety: NOT thread-safe. Call it from the main thread while no
+ * other thread is allocating values.
+ *
+ * @note Slab chunks are returned to the system only once no slab block is in
+ * use any more (otherwise they are kept for reuse).
  */
 void gc_cleanup(void);
 
+/**
+ * @brief Allocate a block from the calling thread's slabs.
+ *
+ * Sizes up to the largest size class are served from a per-thread free list
+ * (or carved from a slab chunk); larger ones go to malloc. Blocks are
+ * aligned for any KronosValue member and are not zeroed.
+ *
+ * @param size Block size in bytes
+ * @return New block, or NULL on allocation failure
+ * @note Thread-safety: lock-free except when a new chunk is needed.
+ */
+void *gc_alloc(size_t size);
+
+/**
+ * @brief Resize a block returned by gc_alloc().
+ *
+ * Keeps the block when both sizes fall in the same size class; otherwise
+ * copies min(@p old_size, @p new_size) bytes into a new block.
+ *
+ * @param ptr Block to resize (NULL behaves like gc_alloc())
+ * @param old_size Size @p ptr was allocated or last resized with
+ * @param new_size Requested size
+ * @return Resized block, or NULL on allocation failure (@p ptr unchanged)
+ */
+void *gc_realloc(void *ptr, size_t old_size, size_t new_size);
+
+/**
+ * @brief Return a block to the calling thread's slabs.
+ *
+ * @param ptr Block to free (may be NULL, in which case this is a no-op)
+ * @param size Size the block was allocated or last resized with (selects
+ *             its size class)
+ * @note A block may be freed on another thread than the one that allocated
+ * it; it then joins that thread's free list.
+ */
+void gc_free(void *ptr, size_t size);
+
+/**
+ * @brief Allocate storage for a heap object.
+ *
+ * Returns an uninitialized KronosValue preceded by its (untracked) GCHeader.
+ * Every value other than a number, boolean or nil must come from here, since
+ * gc_track() and gc_untrack() find the header in front of the value.
+ *
+ * @return New storage, or NULL on allocation failure
+ */
+KronosValue *gc_alloc_object(void);
+
+/**
+ * @brief Allocate storage for a heap object with an inline payload.
+ *
+ * Like gc_alloc_object(), with @p inline_bytes more bytes directly behind
+ * the value (starting at val + 1) in the same block, for data the value
+ * owns and that never grows, such as the bytes of a short string.
+ *
+ * @param inline_bytes Payload size in bytes (at most UINT16_MAX)
+ * @return New storage, or NULL on allocation failure
+ */
+KronosValue *gc_alloc_object_inline(size_t inline_bytes);
+
+/**
+ * @brief Free storage returned by gc_alloc_object() or
+ * gc_alloc_object_inline().
+ *
+ * Frees the value, its header and its inline payload only (not other data
+ * it owns). The value must not be tracked.
+ *
+ * @param val Value to free (may be NULL, in which case this is a no-op).
+ */
+void gc_free_object(KronosValue *val);
+
 /**
  * @brief Register a heap-allocated value for cycle detection tracking.
  *
  * What to track:
- * - ALL heap-allocated KronosValue objects (numbers, strings, booleans, etc.)
- * - Both container types and atomic values
+ * - Heap-owning KronosValue objects (strings, lists, maps, ranges, etc.)
+ *   allocated with gc_alloc_object()
+ * - Numbers (immediates, see value_is_number()) and the immortal true,
+ *   false and nil cells have no header and are ignored: they cannot form
+ *   cycles
  * - Objects are tracked for memory statistics and cycle detection
  *
  * When to call:
  * - Immediately after allocating a new KronosValue (via value_new_*)
  * - Before the object is used or referenced anywhere
- * - Must be called exactly once per object lifetime
  *
  * Behavior:
- * - NOT idempotent: each call increments allocation statistics and must be
- *   paired with a matching gc_untrack() to keep memory accounting correct.
+ * - Charges the object's current size (value, header and owned buffers) to
+ *   the calling thread's heap; gc_untrack() subtracts the same amount.
+ * - Idempotent: tracking an already tracked object is a no-op.
  * - NULL-safe: Passing NULL is a no-op and does not affect statistics.
- * - Adds object to cycle detection tracking list
+ * - Links the object into the heap's object list
  *
  * Example usage:
- *   KronosValue *val = malloc(sizeof(KronosValue));
- *   val->type = VAL_NUMBER;
- *   val->as.number = 42.0;
+ *   KronosValue *val = gc_alloc_object();
+ *   val->type = VAL_RANGE;
  *   val->refcount = 1;
  *   gc_track(val);  // Track immediately after initialization
  *
  * @param val Value to track (may be NULL, in which case this is a no-op).
  * @note Does not modify refcount - tracking is separate from reference
  * counting.
- * @note Thread-safety: NOT thread-safe. Requires external synchronization.
+ * @note Thread-safety: lock-free; only touches the calling thread's heap.
  */
 void gc_track(KronosValue *val);
 
@@ -105,25 +189,24 @@ void gc_track(KronosValue *val);
  * - Only during object destruction (when refcount reaches 0)
  * - Called by value_release() before freeing the object
  * - Must be called before the object is freed to keep statistics accurate
- * - Safe to call on untracked objects (no-op if not found)
+ * - Safe to call on untracked objects, numbers, booleans and nil (no-op)
  * - NULL-safe: Passing NULL is a no-op
- * - Balanced with gc_track(): exactly one gc_untrack() per successful
- *   gc_track(); extra calls after removal are ignored.
- * - Updates memory statistics (subtracts allocated bytes)
- * - Removes object from cycle detection tracking list
+ * - Balanced with gc_track(): extra calls after removal are ignored.
+ * - Subtracts the bytes charged by gc_track()
+ * - Unlinks the object from the heap's object list
  *
  * Example usage:
  *   void value_release(KronosValue *val) {
  *       if (--val->refcount == 0) {
  *           gc_untrack(val);  // Untrack before freeing
  *           // ... free val->as.* data ...
- *           free(val);
+ *           gc_free_object(val);
  *       }
  *   }
  *
  * @param val Value to untrack (may be NULL, in which case this is a no-op).
  * @note Must be called before freeing the value to keep stats accurate.
- * @note Thread-safety: NOT thread-safe. Requires external synchronization.
+ * @note Thread-safety: lock-free; must run on the thread that tracked @p val.
  */
 void gc_untrack(KronosValue *val);
 
@@ -136,9 +219,7 @@ void gc_untrack(KronosValue *val);
  *
  * @note Currently not fully implemented - reference counting handles most
  * cases.
- * @note Thread-safety: Thread-safe. Uses internal mutexes and collects
- * objects to finalize while holding the lock, then finalizes them after
- * releasing to prevent race conditions.
+ * @note Thread-safety: scans and frees the calling thread's heap only.
  */
 void gc_collect_cycles(void);
 
@@ -147,16 +228,16 @@ void gc_collect_cycles(void);
  *
  * @return Total bytes of memory used by all tracked KronosValue objects.
  * @note Includes object headers and any associated data (e.g., string
- * contents).
- * @note Thread-safety: NOT thread-safe. Requires external synchronization.
+ * contents), summed over every heap.
+ * @note Thread-safety: safe to call from any thread.
  */
 size_t gc_get_allocated_bytes(void);
 
 /**
  * @brief Get count of currently tracked objects.
  *
- * @return Number of live KronosValue objects being tracked.
- * @note Thread-safety: NOT thread-safe. Requires external synchronization.
+ * @return Number of live KronosValue objects being tracked (all heaps).
+ * @note Thread-safety: safe to call from any thread.
  */
 size_t gc_get_object_count(void);
 
@@ -166,12 +247,28 @@ size_t gc_get_object_count(void);
  * Contains detailed memory and tracking statistics for debugging and
  * monitoring.
  */
+/** Number of slab size classes (16, 32, 64, 80, 128 and 256-byte blocks) */
+#define GC_SLAB_CLASS_COUNT 6
+
+/**
+ * @brief Occupancy of one slab size class, summed over every heap
+ */
+typedef struct {
+  size_t block_size;    /**< Block size of the class in bytes */
+  size_t blocks_in_use; /**< Blocks handed out and not yet freed */
+  size_t blocks_free;   /**< Carved blocks waiting on free lists */
+} GCSlabStats;
+
 typedef struct {
   size_t object_count;    /**< Number of currently tracked objects */
   size_t allocated_bytes; /**< Total bytes allocated by tracked objects */
-  size_t array_capacity;  /**< Current capacity of the tracking array */
+  size_t heap_count;      /**< Heaps summed (live threads, plus orphans) */
+  size_t array_capacity;  /**< Leak-check table capacity (0 unless built
+                               with KRONOS_GC_LEAK_CHECK) */
   size_t
       array_utilization; /**< Percentage utilization (count/capacity * 100) */
+  size_t slab_reserved_bytes; /**< Bytes of slab chunks held from malloc */
+  GCSlabStats slab_classes[GC_SLAB_CLASS_COUNT]; /**< Per-class occupancy */
 } GCStats;
 
 /**
@@ -181,7 +278,7 @@ typedef struct {
  * Useful for debugging memory issues and monitoring memory usage.
  *
  * @param stats Pointer to GCStats structure to fill (must not be NULL)
- * @note Thread-safety: NOT thread-safe. Requires external synchronization.
+ * @note Thread-safety: safe to call from any thread.
  */
 void gc_stats(GCStats *stats);
 
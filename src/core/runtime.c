@@ -67,6 +67,27 @@ static pthread_mutex_t intern_mutex = PTHREAD_MUTEX_INITIALIZER;
 /** Condition variable for waiting on initialization completion */
 static pthread_cond_t init_cond = PTHREAD_COND_INITIALIZER;
 
+/**
+ * Immortal values
+ *
+ * WHY: true, false and nil come out of every comparison, loop step and
+ * implicit return. Sharing one preallocated cell per value removes those
+ * allocations (numbers need no cell at all, see value_is_number()).
+ *
+ * DESIGN DECISION: The cells are statically initialized with
+ * KRONOS_REFCOUNT_IMMORTAL; value_retain()/value_release() return before
+ * touching them, so they are never written after startup (safe to share
+ * across threads without locking) and never tracked or freed.
+ */
+#define IMMORTAL_VALUE(value_type, field, v)                                   \
+  {.type = (value_type),                                                       \
+   .refcount = KRONOS_REFCOUNT_IMMORTAL,                                       \
+   .as.field = (v)}
+
+static KronosValue immortal_true = IMMORTAL_VALUE(VAL_BOOL, boolean, true);
+static KronosValue immortal_false = IMMORTAL_VALUE(VAL_BOOL, boolean, false);
+static KronosValue immortal_nil = IMMORTAL_VALUE(VAL_NIL, boolean, false);
+
 /** Reference counter for runtime initialization (allows multiple VMs to share
  * runtime) */
 static size_t runtime_refcount = 0;
@@ -177,8 +198,14 @@ void runtime_cleanup(void) {
       // reference
       if (intern_table[i]->refcount > 1) {
         active_refs++;
+        value_release(intern_table[i]); // Release intern table's reference
+      } else {
+        // Untracked (see string_intern()), so free it without gc_untrack()
+        if (!value_string_is_inline(intern_table[i]))
+          gc_free(intern_table[i]->as.string.data,
+                  intern_table[i]->as.string.length + 1);
+        gc_free_object(intern_table[i]);
       }
-      value_release(intern_table[i]); // Release intern table's reference
       intern_table[i] = NULL;
     }
   }
@@ -195,34 +222,81 @@ void runtime_cleanup(void) {
   gc_cleanup();
 }
 
+#if !KRONOS_IMMEDIATE_NUMBERS
 /**
- * @brief Create a new number value
+ * @brief Create a new boxed number value
  *
- * Allocates a KronosValue representing a floating-point number.
- * The value is tracked by the garbage collector and uses reference counting.
- *
- * EDGE CASES:
- * - NaN: Stored as-is; comparisons use epsilon (NaN != NaN as expected)
- * - Infinity: Stored as-is; +/-INF handled correctly in comparisons
- * - Subnormal numbers: Preserved (no normalization)
- * - Zero: Both +0.0 and -0.0 are stored (IEEE 754 distinguishes them, but
- *   our equality comparison treats them as equal via epsilon)
+ * Only targets whose value word cannot hold a double box numbers; see
+ * value_is_number() in runtime.h.
  *
  * @param num The numeric value (can be NaN, INF, or any valid double)
  * @return New value, or NULL on allocation failure
  */
 KronosValue *value_new_number(double num) {
-  KronosValue *val = malloc(sizeof(KronosValue));
+  KronosValue *val = gc_alloc_object();
   if (!val)
     return NULL;
 
   val->type = VAL_NUMBER;
   val->refcount = 1;
   val->as.number = num;
-
   gc_track(val);
   return val;
 }
+#endif
+
+/**
+ * @brief Allocate an untracked string value with room for @p len bytes
+ *
+ * DESIGN DECISION: Most strings (map keys, short fields, single characters
+ * from indexing) are short. Those of up to KRONOS_INLINE_STRING_MAX bytes
+ * are stored inline, behind the value in its own block, so creating one is a
+ * single allocation and the bytes sit next to length and hash. Longer ones
+ * get a separate buffer. as.string.data points at the bytes either way.
+ *
+ * @param len Length of the string (not including null terminator)
+ * @return Value with data, length, type and refcount set (bytes, terminator
+ *         and hash still to fill), or NULL on allocation failure
+ */
+static KronosValue *string_value_alloc(size_t len) {
+  KronosValue *val;
+  if (len <= KRONOS_INLINE_STRING_MAX) {
+    val = gc_alloc_object_inline(len + 1);
+    if (!val)
+      return NULL;
+    val->as.string.data = (char *)(val + 1);
+  } else {
+    val = gc_alloc_object();
+    if (!val)
+      return NULL;
+    val->as.string.data = gc_alloc(len + 1);
+    if (!val->as.string.data) {
+      gc_free_object(val);
+      return NULL;
+    }
+  }
+
+  val->type = VAL_STRING;
+  val->refcount = 1;
+  val->as.string.length = len;
+  return val;
+}
+
+/**
+ * @brief Create a string value holding a copy of @p str, without tracking it
+ *
+ * @return Value with refcount 1, or NULL on allocation failure
+ */
+static KronosValue *string_value_new_untracked(const char *str, size_t len) {
+  KronosValue *val = string_value_alloc(len);
+  if (!val)
+    return NULL;
+
+  memcpy(val->as.string.data, str, len);
+  val->as.string.data[len] = '\0';
+  val->as.string.hash = hash_string(val->as.string.data, len);
+  return val;
+}
 
 /**
  * @brief Create a new string value
@@ -235,22 +309,37 @@ KronosValue *value_new_number(double num) {
  * @return New value, or NULL on allocation failure
  */
 KronosValue *value_new_string(const char *str, size_t len) {
-  KronosValue *val = malloc(sizeof(KronosValue));
-  if (!val)
+  KronosValue *val = string_value_new_untracked(str, len);
+  gc_track(val);
+  return val;
+}
+
+/**
+ * @brief Create a new string value holding @p a followed by @p b
+ *
+ * Builds the result directly in the new value's buffer (no temporary
+ * copy), for string concatenation.
+ *
+ * @param a First part (may contain null bytes)
+ * @param a_len Length of the first part
+ * @param b Second part (may contain null bytes)
+ * @param b_len Length of the second part
+ * @return New value, or NULL on allocation failure or length overflow
+ */
+KronosValue *value_new_string_concat(const char *a, size_t a_len,
+                                     const char *b, size_t b_len) {
+  if (a_len > SIZE_MAX - 1 - b_len)
     return NULL;
+  size_t len = a_len + b_len;
 
-  val->type = VAL_STRING;
-  val->refcount = 1;
-  val->as.string.data = malloc(len + 1);
-  if (!val->as.string.data) {
-    free(val);
+  KronosValue *val = string_value_alloc(len);
+  if (!val)
     return NULL;
-  }
 
-  memcpy(val->as.string.data, str, len);
+  memcpy(val->as.string.data, a, a_len);
+  memcpy(val->as.string.data + a_len, b, b_len);
   val->as.string.data[len] = '\0';
-  val->as.string.length = len;
-  val->as.string.hash = hash_string(str, len);
+  val->as.string.hash = hash_string(val->as.string.data, len);
 
   gc_track(val);
   return val;
@@ -263,16 +352,7 @@ KronosValue *value_new_string(const char *str, size_t len) {
  * @return New value, or NULL on allocation failure
  */
 KronosValue *value_new_bool(bool val) {
-  KronosValue *v = malloc(sizeof(KronosValue));
-  if (!v)
-    return NULL;
-
-  v->type = VAL_BOOL;
-  v->refcount = 1;
-  v->as.boolean = val;
-
-  gc_track(v);
-  return v;
+  return val ? &immortal_true : &immortal_false;
 }
 
 /**
@@ -283,17 +363,7 @@ KronosValue *value_new_bool(bool val) {
  *
  * @return New nil value, or NULL on allocation failure
  */
-KronosValue *value_new_nil(void) {
-  KronosValue *val = malloc(sizeof(KronosValue));
-  if (!val)
-    return NULL;
-
-  val->type = VAL_NIL;
-  val->refcount = 1;
-
-  gc_track(val);
-  return val;
-}
+KronosValue *value_new_nil(void) { return &immortal_nil; }
 
 /**
  * @brief Create a new function value
@@ -310,13 +380,13 @@ KronosValue *value_new_function(uint8_t *bytecode, size_t length, int arity) {
   if (!bytecode || length == 0)
     return NULL;
 
-  KronosValue *val = malloc(sizeof(KronosValue));
+  KronosValue *val = gc_alloc_object();
   if (!val)
     return NULL;
 
   uint8_t *buffer = malloc(length);
   if (!buffer) {
-    free(val);
+    gc_free_object(val);
     return NULL;
   }
   memcpy(buffer, bytecode, length);
@@ -343,15 +413,18 @@ KronosValue *value_new_function(uint8_t *bytecode, size_t length, int arity) {
 KronosValue *value_new_list(size_t initial_capacity) {
   size_t capacity = initial_capacity == 0 ? 4 : initial_capacity;
 
-  KronosValue *val = malloc(sizeof(KronosValue));
+  KronosValue *val = gc_alloc_object();
   if (!val)
     return NULL;
 
-  KronosValue **items = calloc(capacity, sizeof(KronosValue *));
+  KronosValue **items = capacity <= SIZE_MAX / sizeof(KronosValue *)
+                            ? gc_alloc(capacity * sizeof(KronosValue *))
+                            : NULL;
   if (!items) {
-    free(val);
+    gc_free_object(val);
     return NULL;
   }
+  memset(items, 0, capacity * sizeof(KronosValue *));
 
   val->type = VAL_LIST;
   val->refcount = 1;
@@ -376,7 +449,7 @@ KronosValue *value_new_channel(Channel *channel) {
   if (!channel)
     return NULL;
 
-  KronosValue *val = malloc(sizeof(KronosValue));
+  KronosValue *val = gc_alloc_object();
   if (!val)
     return NULL;
 
@@ -420,7 +493,7 @@ KronosValue *value_new_channel(Channel *channel) {
  * @return New range value, or NULL on allocation failure
  */
 KronosValue *value_new_range(double start, double end, double step) {
-  KronosValue *val = malloc(sizeof(KronosValue));
+  KronosValue *val = gc_alloc_object();
   if (!val)
     return NULL;
 
@@ -459,7 +532,7 @@ static uint32_t hash_value(KronosValue *key) {
   if (!key)
     return 0;
 
-  switch (key->type) {
+  switch (value_type(key)) {
   case VAL_STRING:
     return key->as.string.hash;
   case VAL_NUMBER: {
@@ -468,7 +541,7 @@ static uint32_t hash_value(KronosValue *key) {
       double d;
       uint64_t u;
     } converter;
-    converter.d = key->as.number;
+    converter.d = value_as_number(key);
     return (uint32_t)(converter.u ^ (converter.u >> 32));
   }
   case VAL_BOOL:
@@ -546,16 +619,19 @@ static uint32_t hash_value(KronosValue *key) {
 KronosValue *value_new_map(size_t initial_capacity) {
   size_t capacity = initial_capacity == 0 ? 8 : initial_capacity;
 
-  KronosValue *val = malloc(sizeof(KronosValue));
+  KronosValue *val = gc_alloc_object();
   if (!val)
     return NULL;
 
-  MapEntry *entries = calloc(capacity, sizeof(MapEntry));
+  MapEntry *entries = capacity <= SIZE_MAX / sizeof(MapEntry)
+                          ? gc_alloc(capacity * sizeof(MapEntry))
+                          : NULL;
 
   if (!entries) {
-    free(val);
+    gc_free_object(val);
     return NULL;
   }
+  memset(entries, 0, capacity * sizeof(MapEntry));
 
   val->type = VAL_MAP;
   val->refcount = 1;
@@ -570,19 +646,23 @@ KronosValue *value_new_map(size_t initial_capacity) {
 /**
  * @brief Increment the reference count of a value
  *
- * DESIGN DECISION: Saturating arithmetic prevents overflow (saturates at
- * UINT32_MAX with warning). Safer than freeing prematurely. Overflow extremely
+ * DESIGN DECISION: Saturating arithmetic prevents overflow (saturates just
+ * below KRONOS_REFCOUNT_IMMORTAL with warning). Safer than freeing prematurely. Overflow extremely
  * unlikely in practice.
  *
- * EDGE CASES: NULL is no-op, overflow saturates with warning, not thread-safe.
+ * EDGE CASES: NULL, numbers and immortal values are no-ops, overflow
+ * saturates with warning, not thread-safe.
  *
  * @param val Value to retain (safe to pass NULL)
  */
 void value_retain(KronosValue *val) {
-  if (val) {
+  if (val && !value_is_immediate(val) &&
+      val->refcount != KRONOS_REFCOUNT_IMMORTAL) {
     // Use saturating arithmetic: if already at max, leave it there
-    // This prevents overflow while avoiding abrupt termination
-    if (val->refcount < UINT32_MAX) {
+    // This prevents overflow while avoiding abrupt termination (the maximum
+    // stays below KRONOS_REFCOUNT_IMMORTAL so a counted value never turns
+    // immortal)
+    if (val->refcount < KRONOS_REFCOUNT_IMMORTAL - 1) {
       val->refcount++;
     } else {
       // Refcount already at maximum - value is effectively permanently retained
@@ -590,7 +670,7 @@ void value_retain(KronosValue *val) {
       fprintf(stderr,
               "Warning: KronosValue refcount at maximum (%u), "
               "saturating to prevent overflow\n",
-              UINT32_MAX);
+              KRONOS_REFCOUNT_IMMORTAL - 1);
     }
   }
 }
@@ -638,15 +718,17 @@ static bool release_stack_push(KronosValue ***stack, size_t *count,
  * @param val Value to finalize (safe to pass NULL)
  */
 void value_finalize(KronosValue *val) {
-  if (!val)
+  if (!val || value_is_immediate(val) ||
+      val->refcount == KRONOS_REFCOUNT_IMMORTAL)
     return;
 
   gc_untrack(val);
 
   // Free any owned memory, but don't release children
-  switch (val->type) {
+  switch (value_type(val)) {
   case VAL_STRING:
-    free(val->as.string.data);
+    if (!value_string_is_inline(val))
+      gc_free(val->as.string.data, val->as.string.length + 1);
     break;
   case VAL_FUNCTION:
     free(val->as.function.bytecode);
@@ -654,12 +736,12 @@ void value_finalize(KronosValue *val) {
   case VAL_LIST:
     // Free the items array, but don't release the child values
     // (they will be freed separately by gc_cleanup)
-    free(val->as.list.items);
+    gc_free(val->as.list.items, val->as.list.capacity * sizeof(KronosValue *));
     break;
   case VAL_MAP: {
     // Free the entries array, but don't release keys/values
     // (they will be freed separately by gc_cleanup)
-    free(val->as.map.entries);
+    gc_free(val->as.map.entries, val->as.map.capacity * sizeof(MapEntry));
     break;
   }
   case VAL_CHANNEL:
@@ -672,7 +754,7 @@ void value_finalize(KronosValue *val) {
     break;
   }
 
-  free(val);
+  gc_free_object(val);
 }
 
 /**
@@ -682,13 +764,15 @@ void value_finalize(KronosValue *val) {
  * deeply nested structures. Falls back to recursion if stack growth fails
  * (prevents memory leak, may overflow stack).
  *
- * EDGE CASES: NULL is no-op, underflow logged (double-free bug), circular refs
- * require GC cycle detection (see gc_collect_cycles()).
+ * EDGE CASES: NULL, numbers and immortal values are no-ops, underflow logged
+ * (double-free bug), circular refs require GC cycle detection (see
+ * gc_collect_cycles()).
  *
  * @param val Value to release (safe to pass NULL)
  */
 void value_release(KronosValue *val) {
-  if (!val)
+  if (!val || value_is_immediate(val) ||
+      val->refcount == KRONOS_REFCOUNT_IMMORTAL)
     return;
 
   if (val->refcount == 0) {
@@ -696,6 +780,12 @@ void value_release(KronosValue *val) {
     return;
   }
 
+  // Fast path: a shared value needs no release stack
+  if (val->refcount > 1) {
+    val->refcount--;
+    return;
+  }
+
   KronosValue **stack = NULL;
   size_t stack_count = 0;
   size_t stack_capacity = 0;
@@ -703,7 +793,7 @@ void value_release(KronosValue *val) {
 
   while (stack_count > 0) {
     KronosValue *current = stack[--stack_count];
-    if (!current)
+    if (!current || current->refcount == KRONOS_REFCOUNT_IMMORTAL)
       continue;
 
     if (current->refcount == 0) {
@@ -718,9 +808,10 @@ void value_release(KronosValue *val) {
     gc_untrack(current);
 
     // Free any owned memory
-    switch (current->type) {
+    switch (value_type(current)) {
     case VAL_STRING:
-      free(current->as.string.data);
+      if (!value_string_is_inline(current))
+        gc_free(current->as.string.data, current->as.string.length + 1);
       break;
     case VAL_FUNCTION:
       free(current->as.function.bytecode);
@@ -728,7 +819,7 @@ void value_release(KronosValue *val) {
     case VAL_LIST:
       for (size_t i = 0; i < current->as.list.count; i++) {
         KronosValue *child = current->as.list.items[i];
-        if (child) {
+        if (child && !value_is_immediate(child)) {
           if (!release_stack_push(&stack, &stack_count, &stack_capacity,
                                   child)) {
             // Stack push failed - release directly (recursive fallback)
@@ -736,18 +827,20 @@ void value_release(KronosValue *val) {
           }
         }
       }
-      free(current->as.list.items);
+      gc_free(current->as.list.items,
+              current->as.list.capacity * sizeof(KronosValue *));
       break;
     case VAL_MAP: {
       MapEntry *entries = (MapEntry *)current->as.map.entries;
       for (size_t i = 0; i < current->as.map.capacity; i++) {
         if (entries[i].key && !entries[i].is_tombstone) {
-          if (!release_stack_push(&stack, &stack_count, &stack_capacity,
+          if (!value_is_immediate(entries[i].key) &&
+              !release_stack_push(&stack, &stack_count, &stack_capacity,
                                   entries[i].key)) {
             // Stack push failed - release directly (recursive fallback)
             value_release(entries[i].key);
           }
-          if (entries[i].value) {
+          if (entries[i].value && !value_is_immediate(entries[i].value)) {
             if (!release_stack_push(&stack, &stack_count, &stack_capacity,
                                     entries[i].value)) {
               // Stack push failed - release directly (recursive fallback)
@@ -756,7 +849,7 @@ void value_release(KronosValue *val) {
           }
         }
       }
-      free(entries);
+      gc_free(entries, current->as.map.capacity * sizeof(MapEntry));
       break;
     }
     case VAL_CHANNEL:
@@ -769,7 +862,7 @@ void value_release(KronosValue *val) {
       break;
     }
 
-    free(current);
+    gc_free_object(current);
   }
 
   free(stack);
@@ -792,14 +885,14 @@ static void value_fprint_recursive(FILE *out, KronosValue *val, int depth) {
     return;
   }
 
-  switch (val->type) {
+  switch (value_type(val)) {
   case VAL_NUMBER: {
     double intpart;
-    double frac = modf(val->as.number, &intpart);
+    double frac = modf(value_as_number(val), &intpart);
     if (frac == 0.0) {
-      fprintf(out, "%.0f", val->as.number);
+      fprintf(out, "%.0f", value_as_number(val));
     } else {
-      fprintf(out, "%g", val->as.number);
+      fprintf(out, "%g", value_as_number(val));
     }
     break;
   }
@@ -933,13 +1026,13 @@ bool value_is_truthy(KronosValue *val) {
   if (!val)
     return false;
 
-  switch (val->type) {
+  switch (value_type(val)) {
   case VAL_NIL:
     return false;
   case VAL_BOOL:
     return val->as.boolean;
   case VAL_NUMBER:
-    return val->as.number != 0.0;
+    return value_as_number(val) != 0.0;
   case VAL_STRING:
     return val->as.string.length > 0;
   default:
@@ -967,11 +1060,16 @@ static bool value_equals_recursive(KronosValue *a, KronosValue *b, int depth,
                                    KronosValue ***visited_b,
                                    size_t *visited_count,
                                    size_t *visited_capacity) {
+  // Numbers compare by value before identity: every NaN is the same word
+  if (value_is_number(a))
+    return value_is_number(b) &&
+           fabs(value_as_number(a) - value_as_number(b)) <
+               VALUE_COMPARE_EPSILON;
   if (a == b)
     return true;
   if (!a || !b)
     return false;
-  if (a->type != b->type)
+  if (value_type(a) != value_type(b))
     return false;
 
   // Check depth limit
@@ -1008,9 +1106,7 @@ static bool value_equals_recursive(KronosValue *a, KronosValue *b, int depth,
     (*visited_count)++;
   }
 
-  switch (a->type) {
-  case VAL_NUMBER:
-    return fabs(a->as.number - b->as.number) < VALUE_COMPARE_EPSILON;
+  switch (value_type(a)) {
   case VAL_STRING:
     return a->as.string.length == b->as.string.length &&
            memcmp(a->as.string.data, b->as.string.data, a->as.string.length) ==
@@ -1114,7 +1210,7 @@ bool value_equals(KronosValue *a, KronosValue *b) {
  */
 static bool map_find_entry(KronosValue *map, KronosValue *key,
                            size_t *out_index) {
-  if (map->type != VAL_MAP || !key)
+  if (value_type(map) != VAL_MAP || !key)
     return false;
 
   uint32_t hash = hash_value(key);
@@ -1170,10 +1266,13 @@ static int map_grow(KronosValue *map) {
   size_t new_capacity = old_capacity * 2;
 
   MapEntry *old_entries = (MapEntry *)map->as.map.entries;
-  MapEntry *new_entries = calloc(new_capacity, sizeof(MapEntry));
+  MapEntry *new_entries = new_capacity <= SIZE_MAX / sizeof(MapEntry)
+                              ? gc_alloc(new_capacity * sizeof(MapEntry))
+                              : NULL;
 
   if (!new_entries)
     return -1;
+  memset(new_entries, 0, new_capacity * sizeof(MapEntry));
 
   // Rehash all entries
   for (size_t i = 0; i < old_capacity; i++) {
@@ -1194,7 +1293,7 @@ static int map_grow(KronosValue *map) {
     }
   }
 
-  free(old_entries);
+  gc_free(old_entries, old_capacity * sizeof(MapEntry));
   map->as.map.entries = (void *)new_entries;
   map->as.map.capacity = new_capacity;
   return 0;
@@ -1214,7 +1313,7 @@ static int map_grow(KronosValue *map) {
  * @return Value if found, NULL otherwise (caller must retain if keeping)
  */
 KronosValue *map_get(KronosValue *map, KronosValue *key) {
-  if (map->type != VAL_MAP || !key)
+  if (value_type(map) != VAL_MAP || !key)
     return NULL;
 
   size_t index;
@@ -1241,7 +1340,7 @@ KronosValue *map_get(KronosValue *map, KronosValue *key) {
  * @return 0 on success, -1 on failure (allocation error or invalid input)
  */
 int map_set(KronosValue *map, KronosValue *key, KronosValue *value) {
-  if (map->type != VAL_MAP || !key)
+  if (value_type(map) != VAL_MAP || !key)
     return -1;
 
   // WHY: Grow if load factor > 0.75 to maintain good performance
@@ -1293,7 +1392,7 @@ int map_set(KronosValue *map, KronosValue *key, KronosValue *value) {
  * @return true if key was found and deleted, false otherwise
  */
 bool map_delete(KronosValue *map, KronosValue *key) {
-  if (map->type != VAL_MAP || !key)
+  if (value_type(map) != VAL_MAP || !key)
     return false;
 
   size_t index;
@@ -1325,6 +1424,10 @@ bool map_delete(KronosValue *map, KronosValue *key) {
  * DESIGN DECISION: Fixed-size hash table (1024) with linear probing, shared
  * across VMs. Falls back to non-interned string if table full.
  *
+ * DESIGN DECISION: Interned strings are not tracked by the GC. The table is
+ * shared by every thread and outlives gc_init()/gc_cleanup() calls, so its
+ * strings belong to no thread's heap; runtime_cleanup() frees them.
+ *
  * EDGE CASES: Collisions via linear probing, table full falls back, thread-safe
  * via intern_mutex, NULL treated as empty, caller must retain if keeping beyond
  * runtime_cleanup().
@@ -1346,18 +1449,18 @@ KronosValue *string_intern(const char *str, size_t len) {
 
     if (entry == NULL) {
       // Not found, create new interned string
-      KronosValue *val = value_new_string(str, len);
+      KronosValue *val = string_value_new_untracked(str, len);
       if (val) {
         intern_table[probe] = val;
-        value_retain(val); // Extra ref for intern table (refcount now 2)
-        // Release one ref before returning so caller gets refcount 1
-        value_release(val);
+        // The table keeps its own reference (released by runtime_cleanup())
+        // and the caller gets the one it must release (refcount now 2)
+        value_retain(val);
       }
       pthread_mutex_unlock(&intern_mutex);
       return val;
     }
 
-    if (entry->type == VAL_STRING && entry->as.string.hash == hash &&
+    if (value_type(entry) == VAL_STRING && entry->as.string.hash == hash &&
         entry->as.string.length == len &&
         memcmp(entry->as.string.data, str, len) == 0) {
       // Found existing interned string
@@ -1404,37 +1507,37 @@ bool value_is_type(KronosValue *val, const char *type_name) {
   switch (first) {
   case 'b':
     if (len == 7 && strcmp(type_name, "boolean") == 0)
-      return val->type == VAL_BOOL;
+      return value_type(val) == VAL_BOOL;
     break;
   case 'c':
     if (len == 7 && strcmp(type_name, "channel") == 0)
-      return val->type == VAL_CHANNEL;
+      return value_type(val) == VAL_CHANNEL;
     break;
   case 'f':
     if (len == 8 && strcmp(type_name, "function") == 0)
-      return val->type == VAL_FUNCTION;
+      return value_type(val) == VAL_FUNCTION;
     break;
   case 'l':
     if (len == 4 && strcmp(type_name, "list") == 0)
-      return val->type == VAL_LIST;
+      return value_type(val) == VAL_LIST;
     break;
   case 'm':
     if (len == 3 && strcmp(type_name, "map") == 0)
-      return val->type == VAL_MAP;
+      return value_type(val) == VAL_MAP;
     break;
   case 'n':
     if (len == 6 && strcmp(type_name, "number") == 0)
-      return val->type == VAL_NUMBER;
+      return value_is_number(val);
     else if (len == 4 && strcmp(type_name, "null") == 0)
-      return val->type == VAL_NIL;
+      return value_type(val) == VAL_NIL;
     break;
   case 'r':
     if (len == 5 && strcmp(type_name, "range") == 0)
-      return val->type == VAL_RANGE;
+      return value_type(val) == VAL_RANGE;
     break;
   case 's':
     if (len == 6 && strcmp(type_name, "string") == 0)
-      return val->type == VAL_STRING;
+      return value_type(val) == VAL_STRING;
     break;
   }
 
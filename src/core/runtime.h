@@ -5,6 +5,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
 typedef struct Channel Channel;
 
@@ -21,16 +22,28 @@ typedef enum {
   VAL_MAP,
 } ValueType;
 
-// Reference-counted value
+// Refcount carried by immortal values (never counted, tracked or freed)
+#define KRONOS_REFCOUNT_IMMORTAL UINT32_MAX
+
+// Strings of at most this many bytes are stored inline, in the same block as
+// their value (see value_string_is_inline())
+#define KRONOS_INLINE_STRING_MAX 15
+
+// Reference-counted value (on 64-bit targets numbers are immediates instead,
+// see value_is_number())
 typedef struct KronosValue {
   ValueType type;
   uint32_t refcount;
   union {
-    double number;
+#if !KRONOS_IMMEDIATE_NUMBERS
+    double number; // Boxed numbers only (see value_is_number())
+#endif
     struct {
-      char *data;
-      size_t length;
-      uint32_t hash;
+      char *data;    // Nul-terminated bytes (inline or a separate buffer)
+      size_t length; // Length, not counting the terminator
+      uint32_t hash; // FNV-1a of the bytes, computed at creation
+      // An inline string's bytes follow the value directly, so length, hash
+      // and data are adjacent: a map key comparison reads one span
     } string;
     bool boolean;
     struct {
@@ -62,8 +75,99 @@ typedef struct KronosValue {
   } as;
 } KronosValue;
 
+// Immediate numbers
+//
+// On 64-bit targets a number is not stored in a cell: its KronosValue * is
+// the double's bits plus KRONOS_NUMBER_OFFSET, with every NaN canonicalized
+// first. Encoded words then have a non-zero top 16 bits (from 0x0002 for
+// +0.0 up to 0xFFF2 for -infinity), while cell pointers, like all user-space
+// pointers on those targets, have a zero top 16 bits (gc_alloc_object()
+// checks this). So numbers live in the value word itself on the VM stack, in
+// locals, globals, constants and list slots: creating one allocates nothing,
+// and retain/release ignore it. A 32-bit word cannot hold a double, so
+// 32-bit targets (the wasm32 build) box numbers in ordinary heap cells.
+//
+// Either way, never dereference a value before knowing it is not a number;
+// read it through value_type() and value_as_number().
+#ifndef KRONOS_IMMEDIATE_NUMBERS
+#if UINTPTR_MAX == UINT64_MAX
+#define KRONOS_IMMEDIATE_NUMBERS 1
+#else
+#define KRONOS_IMMEDIATE_NUMBERS 0
+#endif
+#endif
+
+#if KRONOS_IMMEDIATE_NUMBERS
+// Offset added to a number's bits to form its value word
+#define KRONOS_NUMBER_OFFSET ((uint64_t)1 << 49)
+
+// Bits of the quiet NaN every NaN is stored as
+#define KRONOS_CANONICAL_NAN UINT64_C(0x7FF8000000000000)
+
+_Static_assert(sizeof(void *) == 8 && sizeof(double) == 8,
+               "immediate numbers need 64-bit value words");
+
+// Whether a value is encoded in its word, with no cell behind it
+static inline bool value_is_immediate(const KronosValue *val) {
+  return ((uintptr_t)val >> 48) != 0;
+}
+
+static inline bool value_is_number(const KronosValue *val) {
+  return value_is_immediate(val);
+}
+
+static inline double value_as_number(const KronosValue *val) {
+  uint64_t bits = (uint64_t)(uintptr_t)val - KRONOS_NUMBER_OFFSET;
+  double num;
+  memcpy(&num, &bits, sizeof(num));
+  return num;
+}
+
+// Never fails; NaN is stored canonicalized, -0.0 and subnormals as-is
+static inline KronosValue *value_new_number(double num) {
+  uint64_t bits;
+  if (num != num) {
+    bits = KRONOS_CANONICAL_NAN;
+  } else {
+    memcpy(&bits, &num, sizeof(bits));
+  }
+  return (KronosValue *)(uintptr_t)(bits + KRONOS_NUMBER_OFFSET);
+}
+#else
+static inline bool value_is_immediate(const KronosValue *val) {
+  (void)val;
+  return false;
+}
+
+static inline bool value_is_number(const KronosValue *val) {
+  return val && val->type == VAL_NUMBER;
+}
+
+static inline double value_as_number(const KronosValue *val) {
+  return val->as.number;
+}
+
+KronosValue *value_new_number(double num);
+#endif
+
+// Type of any non-NULL value, number or cell
+static inline ValueType value_type(const KronosValue *val) {
+  return value_is_immediate(val) ? VAL_NUMBER : val->type;
+}
+
+// Whether a string value's bytes live inline, directly behind the value
+//
+// Strings no longer than KRONOS_INLINE_STRING_MAX bytes are allocated with
+// their value in one block, and as.string.data points just past the value;
+// longer ones own a separate buffer. Readers need not care: data, length and
+// hash mean the same for both.
+static inline bool value_string_is_inline(const KronosValue *val) {
+  return val->as.string.data == (const char *)(val + 1);
+}
+
 // Factory/ownership rules:
-// - Each factory returns a new KronosValue with refcount 1 owned by caller.
+// - Each factory returns a new KronosValue with refcount 1 owned by caller
+//   (numbers, booleans and nil have no count; releasing them is harmless).
 // - Callers must eventually release the value via value_release().
 // - value_new_string copies the provided bytes (treats NULL as "") and owns the
 //   resulting buffer; callers may free their original buffer immediately.
@@ -73,9 +177,16 @@ typedef struct KronosValue {
 // - value_new_list accepts initial_capacity == 0 and picks a default size.
 // - value_new_channel adopts ownership of the Channel* (callers must not free
 //   it after passing it in) and returns NULL on invalid inputs.
+// - value_new_number (above) encodes the number in the value word itself
+//   where KRONOS_IMMEDIATE_NUMBERS is set: no cell, no GC tracking, and
+//   retain/release are no-ops. Elsewhere it returns a boxed number cell.
+// - true, false and nil are immortal: value_new_bool/value_new_nil hand out
+//   shared static cells whose refcount is KRONOS_REFCOUNT_IMMORTAL. Retain
+//   and release are no-ops on them, so they must never be mutated in place.
 // Value creation functions
-KronosValue *value_new_number(double num);
 KronosValue *value_new_string(const char *str, size_t len);
+KronosValue *value_new_string_concat(const char *a, size_t a_len,
+                                     const char *b, size_t b_len);
 KronosValue *value_new_bool(bool val);
 KronosValue *value_new_nil(void);
 KronosValue *value_new_function(uint8_t *bytecode, size_t length, int arity);
@@ -0,0 +1,204 @@
+/**
+ * @file arena.c
+ * @brief Bump allocator for front-end data with a single owner
+ *
+ * DESIGN DECISIONS:
+ * - Chunk growth: The first chunk is small (most REPL lines and f-string
+ *   expressions need well under a page) and each new chunk doubles, up to
+ *   ARENA_MAX_CHUNK_SIZE, so a large script costs a handful of mallocs.
+ * - Large requests: A request bigger than a quarter of the next chunk gets a
+ *   chunk of its own, linked behind the current one, so it neither wastes
+ *   the rest of the current chunk nor forces a new one.
+ * - In-place growth: The arena remembers its most recent bump allocation;
+ *   arena_realloc() of that block just moves the bump pointer. Arrays being
+ *   appended to (AST child arrays) are usually the latest allocation, so
+ *   doubling them rarely copies.
+ *
+ * EDGE CASES:
+ * - Zero-size requests return a non-NULL pointer that must not be written
+ * - Size overflow in arena_calloc() and in chunk sizing returns NULL
+ */
+
+#include "arena.h"
+#include <stdalign.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/** Size of the first chunk (bytes, including its header) */
+#define ARENA_MIN_CHUNK_SIZE (4 * 1024)
+
+/** Chunks stop doubling at this size (bytes, including the header) */
+#define ARENA_MAX_CHUNK_SIZE (64 * 1024)
+
+/** Alignment of arena_alloc() blocks */
+#define ARENA_ALIGN alignof(max_align_t)
+
+typedef struct ArenaChunk {
+  struct ArenaChunk *next; /**< Next (older) chunk */
+  alignas(max_align_t) unsigned char data[];
+} ArenaChunk;
+
+struct Arena {
+  ArenaChunk *chunks;       /**< Chunk list, current chunk first */
+  unsigned char *cursor;    /**< Next free byte of the current chunk */
+  unsigned char *end;       /**< End of the current chunk */
+  unsigned char *last;      /**< Most recent bump allocation (or NULL) */
+  size_t next_chunk_size;   /**< Size of the next bump chunk */
+  size_t bytes_used;        /**< Bytes handed out, including padding */
+};
+
+Arena *arena_new(void) {
+  Arena *arena = calloc(1, sizeof(Arena));
+  if (!arena) {
+    return NULL;
+  }
+  arena->next_chunk_size = ARENA_MIN_CHUNK_SIZE;
+  return arena;
+}
+
+/**
+ * @brief Allocate a chunk with room for @p data_size bytes
+ */
+static ArenaChunk *arena_chunk_new(size_t data_size) {
+  if (data_size > SIZE_MAX - sizeof(ArenaChunk)) {
+    return NULL;
+  }
+  return malloc(sizeof(ArenaChunk) + data_size);
+}
+
+/**
+ * @brief Give a large request a chunk of its own
+ *
+ * The chunk goes behind the current one, so bump allocation continues where
+ * it was.
+ */
+static void *arena_alloc_dedicated(Arena *arena, size_t size) {
+  ArenaChunk *chunk = arena_chunk_new(size);
+  if (!chunk) {
+    return NULL;
+  }
+  if (arena->chunks) {
+    chunk->next = arena->chunks->next;
+    arena->chunks->next = chunk;
+  } else {
+    chunk->next = NULL;
+    arena->chunks = chunk;
+  }
+  arena->bytes_used += size;
+  return chunk->data;
+}
+
+/**
+ * @brief Allocate @p size bytes aligned to @p align (a power of two)
+ */
+static void *arena_bump(Arena *arena, size_t size, size_t align) {
+  if (arena->cursor) {
+    uintptr_t at = ((uintptr_t)arena->cursor + (align - 1)) & ~(align - 1);
+    unsigned char *block = (unsigned char *)at;
+    if (block <= arena->end && size <= (size_t)(arena->end - block)) {
+      arena->bytes_used += (size_t)(block - arena->cursor) + size;
+      arena->cursor = block + size;
+      arena->last = block;
+      return block;
+    }
+  }
+
+  size_t chunk_size = arena->next_chunk_size;
+  if (size > (chunk_size - sizeof(ArenaChunk)) / 4) {
+    return arena_alloc_dedicated(arena, size);
+  }
+
+  ArenaChunk *chunk = arena_chunk_new(chunk_size - sizeof(ArenaChunk));
+  if (!chunk) {
+    return NULL;
+  }
+  chunk->next = arena->chunks;
+  arena->chunks = chunk;
+  arena->cursor = chunk->data;
+  arena->end = (unsigned char *)chunk + chunk_size;
+  if (chunk_size < ARENA_MAX_CHUNK_SIZE) {
+    arena->next_chunk_size = chunk_size * 2;
+  }
+
+  // Chunk data is maximally aligned, so the block starts at the cursor
+  arena->bytes_used += size;
+  arena->last = arena->cursor;
+  arena->cursor += size;
+  return arena->last;
+}
+
+void *arena_alloc(Arena *arena, size_t size) {
+  return arena_bump(arena, size, ARENA_ALIGN);
+}
+
+char *arena_alloc_chars(Arena *arena, size_t size) {
+  return arena_bump(arena, size, 1);
+}
+
+void *arena_calloc(Arena *arena, size_t count, size_t size) {
+  if (size != 0 && count > SIZE_MAX / size) {
+    return NULL;
+  }
+  void *block = arena_bump(arena, count * size, ARENA_ALIGN);
+  if (block) {
+    memset(block, 0, count * size);
+  }
+  return block;
+}
+
+void *arena_realloc(Arena *arena, void *ptr, size_t old_size,
+                    size_t new_size) {
+  if (!ptr) {
+    return arena_alloc(arena, new_size);
+  }
+  if (new_size <= old_size) {
+    return ptr;
+  }
+
+  // Most recent bump allocation: extend it in place if the chunk has room
+  unsigned char *block = ptr;
+  if (block == arena->last && new_size <= (size_t)(arena->end - block)) {
+    arena->bytes_used += new_size - old_size;
+    arena->cursor = block + new_size;
+    return ptr;
+  }
+
+  void *moved = arena_alloc(arena, new_size);
+  if (!moved) {
+    return NULL;
+  }
+  memcpy(moved, ptr, old_size);
+  return moved;
+}
+
+char *arena_strndup(Arena *arena, const char *str, size_t length) {
+  if (length == SIZE_MAX) {
+    return NULL;
+  }
+  char *copy = arena_alloc_chars(arena, length + 1);
+  if (!copy) {
+    return NULL;
+  }
+  memcpy(copy, str, length);
+  copy[length] = '\0';
+  return copy;
+}
+
+size_t arena_bytes_used(const Arena *arena) {
+  return arena ? arena->bytes_used : 0;
+}
+
+void arena_free(Arena *arena) {
+  if (!arena) {
+    return;
+  }
+  ArenaChunk *chunk = arena->chunks;
+  while (chunk) {
+    ArenaChunk *next = chunk->next;
+    free(chunk);
+    chunk = next;
+  }
+  free(arena);
+}
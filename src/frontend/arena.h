@@ -0,0 +1,97 @@
+#ifndef KRONOS_ARENA_H
+#define KRONOS_ARENA_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file arena.h
+ * @brief Bump allocator for front-end data with a single owner
+ *
+ * An arena hands out memory from a chain of chunks by bumping a pointer and
+ * releases everything at once in arena_free(). Decoded string literals and
+ * AST nodes live exactly as long as the TokenArray or AST that owns them, so
+ * the tokenizer and parser allocate from an arena instead of calling malloc()
+ * per string, node and child array, and freeing them costs one free() per chunk instead
+ * of a walk over every token or node.
+ *
+ * Individual allocations cannot be freed. arena_realloc() grows the most
+ * recent allocation in place when it can and copies otherwise, leaving the
+ * old block unused until the arena is freed.
+ *
+ * An arena is not thread-safe; it belongs to the thread that fills it.
+ */
+
+typedef struct Arena Arena;
+
+/**
+ * @brief Create an empty arena
+ *
+ * The first chunk is allocated on first use.
+ *
+ * @return New arena, or NULL on allocation failure
+ */
+Arena *arena_new(void);
+
+/**
+ * @brief Allocate @p size uninitialized bytes, aligned for any object type
+ *
+ * @return Pointer into the arena, or NULL on allocation failure
+ */
+void *arena_alloc(Arena *arena, size_t size);
+
+/**
+ * @brief Allocate @p size uninitialized bytes with no alignment padding
+ *
+ * For character data, which packs tightly between aligned blocks.
+ *
+ * @return Pointer into the arena, or NULL on allocation failure
+ */
+char *arena_alloc_chars(Arena *arena, size_t size);
+
+/**
+ * @brief Allocate a zeroed array of @p count elements of @p size bytes
+ *
+ * @return Pointer into the arena, or NULL on overflow or allocation failure
+ */
+void *arena_calloc(Arena *arena, size_t count, size_t size);
+
+/**
+ * @brief Grow an allocation from @p old_size to @p new_size bytes
+ *
+ * Like realloc(): @p ptr may be NULL, and the first @p old_size bytes are
+ * preserved. Never shrinks.
+ *
+ * @return Pointer into the arena, or NULL on allocation failure (@p ptr is
+ *         still valid)
+ */
+void *arena_realloc(Arena *arena, void *ptr, size_t old_size,
+                    size_t new_size);
+
+/**
+ * @brief Copy @p length bytes of @p str into the arena and terminate them
+ *
+ * @return Nul-terminated copy, or NULL on allocation failure
+ */
+char *arena_strndup(Arena *arena, const char *str, size_t length);
+
+/**
+ * @brief Bytes handed out so far (including alignment padding)
+ */
+size_t arena_bytes_used(const Arena *arena);
+
+/**
+ * @brief Free the arena and every allocation made from it
+ *
+ * @param arena Arena to free (may be NULL)
+ */
+void arena_free(Arena *arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // KRONOS_ARENA_H
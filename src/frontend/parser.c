@@ -60,6 +60,47 @@
  */
 #define INITIAL_ARRAY_CAPACITY 4
 
+/**
+ * Arena of the AST that parse() is building on this thread
+ *
+ * DESIGN DECISION: Every node, child array and name of an AST comes from one
+ * arena owned by the AST, so building it costs a pointer bump per allocation
+ * and ast_free() releases it without walking the tree. A thread-local rather
+ * than a Parser field because node constructors and array helpers take no
+ * Parser, and because f-string expressions are parsed by a nested parser
+ * whose nodes must land in the same arena.
+ *
+ * EDGE CASES: Outside parse() it is NULL and the helpers below fall back to
+ * malloc()/free(), so parse_expression_only() still returns a tree that
+ * ast_node_free() releases node by node. Inside parse(), error paths that
+ * free partial nodes do nothing; the arena reclaims them with the AST.
+ */
+static _Thread_local Arena *ast_arena = NULL;
+
+static void *ast_alloc(size_t size) {
+  return ast_arena ? arena_alloc(ast_arena, size) : malloc(size);
+}
+
+static void *ast_calloc(size_t count, size_t size) {
+  return ast_arena ? arena_calloc(ast_arena, count, size) : calloc(count, size);
+}
+
+static void *ast_realloc(void *ptr, size_t old_size, size_t new_size) {
+  return ast_arena ? arena_realloc(ast_arena, ptr, old_size, new_size)
+                   : realloc(ptr, new_size);
+}
+
+static char *ast_strndup(const char *str, size_t length) {
+  return ast_arena ? arena_strndup(ast_arena, str, length)
+                   : strndup(str, length);
+}
+
+static void ast_dealloc(void *ptr) {
+  if (!ast_arena) {
+    free(ptr);
+  }
+}
+
 /**
  * @brief Generic function to grow a pointer array
  *
@@ -82,7 +123,8 @@ static bool grow_array(void **arr, size_t count, size_t *capacity,
   }
 
   size_t new_capacity = *capacity * 2;
-  void *new_arr = realloc(*arr, element_size * new_capacity);
+  void *new_arr =
+      ast_realloc(*arr, element_size * *capacity, element_size * new_capacity);
   if (!new_arr) {
     return false;
   }
@@ -526,7 +568,7 @@ static bool fstring_add_part(ASTNode ***parts, size_t *part_count,
 
 // Create AST node helpers
 static ASTNode *ast_node_new(ASTNodeType type) {
-  ASTNode *node = calloc(1, sizeof(ASTNode));
+  ASTNode *node = ast_calloc(1, sizeof(ASTNode));
   if (!node) {
     return NULL;
   }
@@ -568,9 +610,9 @@ static ASTNode *fstring_create_string_part(const char *content, size_t start,
     return NULL;
   }
 
-  str_node->as.string.value = malloc(str_len + 1);
+  str_node->as.string.value = ast_alloc(str_len + 1);
   if (!str_node->as.string.value) {
-    free(str_node);
+    ast_dealloc(str_node);
     return NULL;
   }
   memcpy(str_node->as.string.value, content + start, str_len);
@@ -589,21 +631,12 @@ static ASTNode *fstring_create_string_part(const char *content, size_t start,
 // works correctly and is acceptable for most use cases.
 static ASTNode *fstring_parse_expression(const char *content, size_t expr_start,
                                          size_t expr_end) {
-  // Extract expression string
-  size_t expr_len = expr_end - expr_start;
-  char *expr_str = malloc(expr_len + 1);
-  if (!expr_str) {
-    return NULL;
-  }
-
-  memcpy(expr_str, content + expr_start, expr_len);
-  expr_str[expr_len] = '\0';
-
-  // Tokenize and parse the expression
+  // Tokenize and parse the expression in place: the tokenizer takes a
+  // length-delimited buffer, so the substring needs no terminated copy
   // TODO: Optimize by parsing inline without re-tokenization (requires
   //       source position tracking in tokens)
-  TokenArray *expr_tokens = tokenize(expr_str, NULL);
-  free(expr_str);
+  TokenArray *expr_tokens =
+      tokenize_buffer(content + expr_start, expr_end - expr_start, NULL, 8);
   if (!expr_tokens) {
     return NULL;
   }
@@ -697,7 +730,7 @@ static void fstring_cleanup_parts(ASTNode **parts, size_t part_count) {
   for (size_t i = 0; i < part_count; i++) {
     ast_node_free(parts[i]);
   }
-  free(parts);
+  ast_dealloc(parts);
 }
 
 /**
@@ -770,31 +803,43 @@ static ASTNode *parse_value(Parser *p) {
     }
     ast_node_set_position(node, tok);
 
-    // Use strtod() with proper error checking instead of atof()
-    errno = 0; // Clear errno before conversion
-    char *endptr;
-    double value = strtod(tok->text, &endptr);
-
-    // Check for conversion errors
-    if (errno == ERANGE) {
-      // Overflow or underflow occurred
-      if (value == HUGE_VAL || value == -HUGE_VAL) {
-        char msg[256];
-        snprintf(msg, sizeof(msg), "Number overflow: %s", tok->text);
-        parser_set_error(p, msg);
-        free(node);
+    // Token text is a slice of the source, so strtod() needs a terminated
+    // copy; number literals almost always fit the stack buffer
+    char num_buf[64];
+    char *num_text = num_buf;
+    if (tok->length >= sizeof(num_buf)) {
+      num_text = malloc(tok->length + 1);
+      if (!num_text) {
+        parser_set_error(p, "Failed to allocate memory for number literal");
+        ast_dealloc(node);
         return NULL;
       }
-      // Underflow (value is 0.0 or very small) - acceptable, continue
     }
+    memcpy(num_text, tok->text, tok->length);
+    num_text[tok->length] = '\0';
 
+    // Use strtod() with proper error checking instead of atof()
+    errno = 0; // Clear errno before conversion
+    char *endptr;
+    double value = strtod(num_text, &endptr);
+    bool overflow =
+        errno == ERANGE && (value == HUGE_VAL || value == -HUGE_VAL);
     // Check if the entire string was consumed
     // endptr should point to the null terminator if conversion succeeded
-    if (endptr == tok->text || *endptr != '\0') {
+    bool malformed = endptr == num_text || *endptr != '\0';
+    if (num_text != num_buf) {
+      free(num_text);
+    }
+
+    // Check for conversion errors
+    // Underflow (value is 0.0 or very small) is acceptable
+    if (overflow || malformed) {
       char msg[256];
-      snprintf(msg, sizeof(msg), "Invalid number format: %s", tok->text);
+      snprintf(msg, sizeof(msg), "%s: %.*s",
+               overflow ? "Number overflow" : "Invalid number format",
+               (int)tok->length, tok->text);
       parser_set_error(p, msg);
-      free(node);
+      ast_dealloc(node);
       return NULL;
     }
 
@@ -843,10 +888,10 @@ static ASTNode *parse_value(Parser *p) {
     }
     ast_node_set_position(node, tok);
     size_t len = tok->length;
-    node->as.string.value = malloc(len + 1);
+    node->as.string.value = ast_alloc(len + 1);
     if (!node->as.string.value) {
       fprintf(stderr, "Memory allocation failed for string value\n");
-      free(node);
+      ast_dealloc(node);
       return NULL;
     }
     strncpy(node->as.string.value, tok->text, len);
@@ -866,10 +911,10 @@ static ASTNode *parse_value(Parser *p) {
       return NULL;
     }
     ast_node_set_position(node, tok);
-    char *var_name = strdup(tok->text);
+    char *var_name = ast_strndup(tok->text, tok->length);
     if (!var_name) {
       fprintf(stderr, "Memory allocation failed for variable name\n");
-      free(node);
+      ast_dealloc(node);
       return NULL;
     }
     node->as.var_name = var_name;
@@ -1052,7 +1097,7 @@ static void list_cleanup_elements(ASTNode **elements, size_t element_count) {
       ast_node_free(elements[i]);
     }
   }
-  free(elements);
+  ast_dealloc(elements);
 }
 
 /**
@@ -1083,7 +1128,7 @@ static ASTNode *parse_list_literal(Parser *p) {
   size_t element_count = 0;
   size_t element_capacity = INITIAL_ARRAY_CAPACITY;
 
-  elements = malloc(sizeof(ASTNode *) * element_capacity);
+  elements = ast_alloc(sizeof(ASTNode *) * element_capacity);
   if (!elements) {
     fprintf(stderr, "Failed to allocate memory for list elements\n");
     return NULL;
@@ -1227,9 +1272,9 @@ static ASTNode *map_parse_key(Parser *p) {
     if (!key) {
       return NULL;
     }
-    key->as.string.value = strdup(key_tok->text);
+    key->as.string.value = ast_strndup(key_tok->text, key_tok->length);
     if (!key->as.string.value) {
-      free(key);
+      ast_dealloc(key);
       return NULL;
     }
     key->as.string.length = key_tok->length;
@@ -1252,17 +1297,18 @@ static ASTNode *map_parse_key(Parser *p) {
  */
 static bool map_grow_entries(ASTNode ***keys, ASTNode ***values,
                              size_t *capacity) {
-  // Grow both arrays - if second fails, first is already grown, so we can't
-  // easily rollback. This is acceptable since we check both before using.
-  bool keys_ok =
-      grow_array((void **)keys, *capacity, capacity, sizeof(ASTNode *));
-  bool values_ok =
-      grow_array((void **)values, *capacity, capacity, sizeof(ASTNode *));
-  if (!keys_ok || !values_ok) {
-    // If one succeeded and the other failed, we have a problem
-    // In practice, this is very rare and indicates severe memory pressure
+  // Each array grows from the old capacity; sharing one counter would leave
+  // the second array at its old size. If the second grow fails, the first
+  // array is merely larger than needed, so the old capacity stays valid.
+  size_t keys_capacity = *capacity;
+  size_t values_capacity = *capacity;
+  if (!grow_array((void **)keys, *capacity, &keys_capacity,
+                  sizeof(ASTNode *)) ||
+      !grow_array((void **)values, *capacity, &values_capacity,
+                  sizeof(ASTNode *))) {
     return false;
   }
+  *capacity = keys_capacity;
   return true;
 }
 
@@ -1288,8 +1334,8 @@ static void map_cleanup_entries(ASTNode **keys, ASTNode **values,
       ast_node_free(values[i]);
     }
   }
-  free(keys);
-  free(values);
+  ast_dealloc(keys);
+  ast_dealloc(values);
 }
 
 /**
@@ -1313,8 +1359,8 @@ static ASTNode *parse_map_literal(Parser *p) {
   size_t entry_count = 0;
   size_t entry_capacity = INITIAL_ARRAY_CAPACITY;
 
-  keys = malloc(sizeof(ASTNode *) * entry_capacity);
-  values = malloc(sizeof(ASTNode *) * entry_capacity);
+  keys = ast_alloc(sizeof(ASTNode *) * entry_capacity);
+  values = ast_alloc(sizeof(ASTNode *) * entry_capacity);
   if (!keys || !values) {
     map_cleanup_entries(keys, values, entry_count);
     fprintf(stderr, "Failed to allocate memory for map entries\n");
@@ -1435,7 +1481,7 @@ static ASTNode *parse_fstring(Parser *p) {
   // Allocate parts array (alternating: string, expr, string, expr, ...)
   size_t part_capacity = INITIAL_ARRAY_CAPACITY;
   size_t part_count = 0;
-  ASTNode **parts = malloc(sizeof(ASTNode *) * part_capacity);
+  ASTNode **parts = ast_alloc(sizeof(ASTNode *) * part_capacity);
   if (!parts) {
     fprintf(stderr, "Failed to allocate memory for f-string parts\n");
     return NULL;
@@ -1488,13 +1534,13 @@ static ASTNode *parse_fstring(Parser *p) {
   if (part_count == 0) {
     ASTNode *empty_str = ast_node_new_checked(AST_STRING);
     if (!empty_str) {
-      free(parts);
+      ast_dealloc(parts);
       return NULL;
     }
-    empty_str->as.string.value = malloc(1);
+    empty_str->as.string.value = ast_alloc(1);
     if (!empty_str->as.string.value) {
-      free(parts);
-      free(empty_str);
+      ast_dealloc(parts);
+      ast_dealloc(empty_str);
       return NULL;
     }
     empty_str->as.string.value[0] = '\0';
@@ -1937,15 +1983,15 @@ static ASTNode *assignment_parse_index(Parser *p, int indent, Token *name) {
   if (!target) {
     ast_node_free(index);
     ast_node_free(value);
-    free(node);
+    ast_dealloc(node);
     return NULL;
   }
-  target->as.var_name = strdup(name->text);
+  target->as.var_name = ast_strndup(name->text, name->length);
   if (!target->as.var_name) {
     ast_node_free(index);
     ast_node_free(value);
-    free(target);
-    free(node);
+    ast_dealloc(target);
+    ast_dealloc(node);
     return NULL;
   }
   node->as.assign_index.target = target;
@@ -1987,7 +2033,7 @@ static ASTNode *assignment_parse_regular(Parser *p, int indent, Token *name,
       ast_node_free(value);
       return NULL;
     }
-    type_name = strdup(type_tok->text);
+    type_name = ast_strndup(type_tok->text, type_tok->length);
     if (!type_name) {
       fprintf(stderr,
               "Memory allocation failed for assignment type annotation\n");
@@ -1998,23 +2044,23 @@ static ASTNode *assignment_parse_regular(Parser *p, int indent, Token *name,
 
   if (!consume(p, TOK_NEWLINE)) {
     ast_node_free(value);
-    free(type_name);
+    ast_dealloc(type_name);
     return NULL;
   }
 
   ASTNode *node = ast_node_new_checked(AST_ASSIGN);
   if (!node) {
     ast_node_free(value);
-    free(type_name);
+    ast_dealloc(type_name);
     return NULL;
   }
   ast_node_set_position(node, start_tok);
   node->indent = indent;
-  node->as.assign.name = strdup(name->text);
+  node->as.assign.name = ast_strndup(name->text, name->length);
   if (!node->as.assign.name) {
     ast_node_free(value);
-    free(type_name);
-    free(node);
+    ast_dealloc(type_name);
+    ast_dealloc(node);
     return NULL;
   }
   node->as.assign.value = value;
@@ -2122,14 +2168,14 @@ static ASTNode *parse_delete(Parser *p, int indent) {
   ASTNode *target = ast_node_new_checked(AST_VAR);
   if (!target) {
     ast_node_free(key);
-    free(node);
+    ast_dealloc(node);
     return NULL;
   }
-  target->as.var_name = strdup(name->text);
+  target->as.var_name = ast_strndup(name->text, name->length);
   if (!target->as.var_name) {
     ast_node_free(key);
-    free(target);
-    free(node);
+    ast_dealloc(target);
+    ast_dealloc(node);
     return NULL;
   }
   node->as.delete_stmt.target = target;
@@ -2166,13 +2212,13 @@ static ASTNode *parse_raise(Parser *p, int indent) {
     if (after && (after->type == TOK_STRING || after->type == TOK_FSTRING)) {
       // Syntax: raise ErrorType "message"
       consume(p, TOK_NAME);
-      error_type = strdup(next->text);
+      error_type = ast_strndup(next->text, next->length);
       if (!error_type) {
         return NULL;
       }
       message = parse_expression(p);
       if (!message) {
-        free(error_type);
+        ast_dealloc(error_type);
         return NULL;
       }
     } else {
@@ -2194,14 +2240,14 @@ static ASTNode *parse_raise(Parser *p, int indent) {
   }
 
   if (!consume(p, TOK_NEWLINE)) {
-    free(error_type);
+    ast_dealloc(error_type);
     ast_node_free(message);
     return NULL;
   }
 
   ASTNode *node = ast_node_new_checked(AST_RAISE);
   if (!node) {
-    free(error_type);
+    ast_dealloc(error_type);
     ast_node_free(message);
     return NULL;
   }
@@ -2243,7 +2289,7 @@ static bool try_parse_catch_block(Parser *p, int indent, ASTNode *try_node,
     Token *after_name = peek(p, 0);
     if (after_name && after_name->type == TOK_AS) {
       // Syntax: catch ErrorType as var:
-      error_type = strdup(name_tok->text);
+      error_type = ast_strndup(name_tok->text, name_tok->length);
       if (!error_type) {
         return false;
       }
@@ -2252,17 +2298,17 @@ static bool try_parse_catch_block(Parser *p, int indent, ASTNode *try_node,
       // Parse catch variable name
       Token *var_tok = consume(p, TOK_NAME);
       if (!var_tok) {
-        free(error_type);
+        ast_dealloc(error_type);
         return false;
       }
-      catch_var = strdup(var_tok->text);
+      catch_var = ast_strndup(var_tok->text, var_tok->length);
       if (!catch_var) {
-        free(error_type);
+        ast_dealloc(error_type);
         return false;
       }
     } else {
       // Syntax: catch var: (catch all errors)
-      catch_var = strdup(name_tok->text);
+      catch_var = ast_strndup(name_tok->text, name_tok->length);
       if (!catch_var) {
         return false;
       }
@@ -2270,22 +2316,22 @@ static bool try_parse_catch_block(Parser *p, int indent, ASTNode *try_node,
   }
 
   if (!consume(p, TOK_COLON)) {
-    free(error_type);
-    free(catch_var);
+    ast_dealloc(error_type);
+    ast_dealloc(catch_var);
     return false;
   }
 
   if (!consume(p, TOK_NEWLINE)) {
-    free(error_type);
-    free(catch_var);
+    ast_dealloc(error_type);
+    ast_dealloc(catch_var);
     return false;
   }
 
   size_t catch_block_size = 0;
   ASTNode **catch_block = parse_block(p, indent, &catch_block_size);
   if (!catch_block) {
-    free(error_type);
-    free(catch_var);
+    ast_dealloc(error_type);
+    ast_dealloc(catch_var);
     return false;
   }
 
@@ -2293,12 +2339,12 @@ static bool try_parse_catch_block(Parser *p, int indent, ASTNode *try_node,
   if (!grow_array((void **)&try_node->as.try_stmt.catch_blocks,
                   try_node->as.try_stmt.catch_block_count, catch_capacity,
                   sizeof(try_node->as.try_stmt.catch_blocks[0]))) {
-    free(error_type);
-    free(catch_var);
+    ast_dealloc(error_type);
+    ast_dealloc(catch_var);
     for (size_t i = 0; i < catch_block_size; i++) {
       ast_node_free(catch_block[i]);
     }
-    free(catch_block);
+    ast_dealloc(catch_block);
     return false;
   }
 
@@ -2385,7 +2431,7 @@ static ASTNode *parse_try(Parser *p, int indent) {
     for (size_t i = 0; i < try_block_size; i++) {
       ast_node_free(try_block[i]);
     }
-    free(try_block);
+    ast_dealloc(try_block);
     return NULL;
   }
   ast_node_set_position(node, start_tok);
@@ -2399,7 +2445,7 @@ static ASTNode *parse_try(Parser *p, int indent) {
 
   size_t catch_capacity = INITIAL_ARRAY_CAPACITY;
   node->as.try_stmt.catch_blocks =
-      malloc(sizeof(node->as.try_stmt.catch_blocks[0]) * catch_capacity);
+      ast_alloc(sizeof(node->as.try_stmt.catch_blocks[0]) * catch_capacity);
   if (!node->as.try_stmt.catch_blocks) {
     ast_node_free(node);
     return NULL;
@@ -2504,7 +2550,7 @@ static ASTNode **parse_block(Parser *p, int parent_indent, size_t *block_size) {
   size_t capacity =
       INITIAL_ARRAY_CAPACITY * 2; // Larger initial capacity for blocks
   size_t count = 0;
-  ASTNode **block = malloc(sizeof(ASTNode *) * capacity);
+  ASTNode **block = ast_alloc(sizeof(ASTNode *) * capacity);
   if (!block) {
     fprintf(stderr, "Parser failed to allocate block statements\n");
     decrement_recursion_depth(p);
@@ -2566,7 +2612,7 @@ static ASTNode **parse_block(Parser *p, int parent_indent, size_t *block_size) {
       for (size_t i = 0; i < count; i++) {
         ast_node_free(block[i]);
       }
-      free(block);
+      ast_dealloc(block);
       if (block_size) {
         *block_size = 0;
       }
@@ -2579,7 +2625,7 @@ static ASTNode **parse_block(Parser *p, int parent_indent, size_t *block_size) {
       for (size_t i = 0; i < count; i++) {
         ast_node_free(block[i]);
       }
-      free(block);
+      ast_dealloc(block);
       if (block_size) {
         *block_size = 0;
       }
@@ -2635,20 +2681,25 @@ static bool if_parse_else_if(Parser *p, int indent, ASTNode *if_node) {
   }
 
   // Grow arrays
-  size_t new_count = if_node->as.if_stmt.else_if_count + 1;
-  ASTNode **new_conditions = realloc(if_node->as.if_stmt.else_if_conditions,
-                                     sizeof(ASTNode *) * new_count);
-  ASTNode ***new_blocks = realloc(if_node->as.if_stmt.else_if_blocks,
-                                  sizeof(ASTNode **) * new_count);
-  size_t *new_block_sizes = realloc(if_node->as.if_stmt.else_if_block_sizes,
-                                    sizeof(size_t) * new_count);
+  size_t old_count = if_node->as.if_stmt.else_if_count;
+  size_t new_count = old_count + 1;
+  ASTNode **new_conditions =
+      ast_realloc(if_node->as.if_stmt.else_if_conditions,
+                  sizeof(ASTNode *) * old_count, sizeof(ASTNode *) * new_count);
+  ASTNode ***new_blocks =
+      ast_realloc(if_node->as.if_stmt.else_if_blocks,
+                  sizeof(ASTNode **) * old_count,
+                  sizeof(ASTNode **) * new_count);
+  size_t *new_block_sizes =
+      ast_realloc(if_node->as.if_stmt.else_if_block_sizes,
+                  sizeof(size_t) * old_count, sizeof(size_t) * new_count);
 
   if (!new_conditions || !new_blocks || !new_block_sizes) {
     ast_node_free(else_if_condition);
     for (size_t i = 0; i < else_if_block_size; i++) {
       ast_node_free(else_if_block[i]);
     }
-    free(else_if_block);
+    ast_dealloc(else_if_block);
     return false;
   }
 
@@ -2743,7 +2794,7 @@ static ASTNode *parse_if(Parser *p, int indent) {
     for (size_t i = 0; i < block_size; i++) {
       ast_node_free(block[i]);
     }
-    free(block);
+    ast_dealloc(block);
     return NULL;
   }
   ast_node_set_position(node, start_tok);
@@ -2879,15 +2930,16 @@ static void for_cleanup_resources(ASTNode *iterable, ASTNode *end,
     for (size_t i = 0; i < block_size; i++) {
       ast_node_free(block[i]);
     }
-    free(block);
+    ast_dealloc(block);
   }
 }
 
 /**
  * @brief Parse a for statement
  *
- * Parses: for var in iterable: ... or for var in range start to end [by step]:
- * ... Handles both list iteration and range iteration.
+ * Parses: for var in iterable: ..., for key, value in map: ... or
+ * for var in range start to end [by step]: ... Handles both list iteration
+ * and range iteration.
  *
  * @param p Parser state
  * @param indent Indentation level of this statement
@@ -2904,6 +2956,16 @@ static ASTNode *parse_for(Parser *p, int indent) {
     return NULL;
   }
 
+  // Optional second variable: for key, value in map
+  Token *value_var = NULL;
+  if (peek(p, 0) && peek(p, 0)->type == TOK_COMMA) {
+    consume_any(p); // consume comma
+    value_var = consume(p, TOK_NAME);
+    if (!value_var) {
+      return NULL;
+    }
+  }
+
   if (!consume(p, TOK_IN)) {
     return NULL;
   }
@@ -2912,6 +2974,10 @@ static ASTNode *parse_for(Parser *p, int indent) {
   if (!next) {
     return NULL;
   }
+  if (value_var && next->type == TOK_RANGE) {
+    parser_set_error(p, "Range loops take a single loop variable");
+    return NULL;
+  }
 
   ASTNode *iterable = NULL;
   ASTNode *end = NULL;
@@ -2957,12 +3023,22 @@ static ASTNode *parse_for(Parser *p, int indent) {
   }
   ast_node_set_position(node, start_tok);
   node->indent = indent;
-  node->as.for_stmt.var = strdup(var->text);
+  node->as.for_stmt.var = ast_strndup(var->text, var->length);
   if (!node->as.for_stmt.var) {
     for_cleanup_resources(iterable, end, step, block, block_size);
-    free(node);
+    ast_dealloc(node);
     return NULL;
   }
+  if (value_var) {
+    node->as.for_stmt.value_var =
+        ast_strndup(value_var->text, value_var->length);
+    if (!node->as.for_stmt.value_var) {
+      for_cleanup_resources(iterable, end, step, block, block_size);
+      ast_dealloc(node->as.for_stmt.var);
+      ast_dealloc(node);
+      return NULL;
+    }
+  }
   node->as.for_stmt.iterable = iterable;
   node->as.for_stmt.is_range = is_range;
   node->as.for_stmt.end = end;
@@ -3018,7 +3094,7 @@ static ASTNode *parse_while(Parser *p, int indent) {
     for (size_t i = 0; i < block_size; i++) {
       ast_node_free(block[i]);
     }
-    free(block);
+    ast_dealloc(block);
     return NULL;
   }
   ast_node_set_position(node, start_tok);
@@ -3057,7 +3133,7 @@ static bool function_parse_parameters(Parser *p, char ***params,
 
   *param_capacity = INITIAL_ARRAY_CAPACITY;
   *param_count = 0;
-  *params = malloc(sizeof(char *) * *param_capacity);
+  *params = ast_alloc(sizeof(char *) * *param_capacity);
   if (!*params) {
     fprintf(stderr, "parse_function: failed to allocate params array\n");
     return false;
@@ -3065,13 +3141,13 @@ static bool function_parse_parameters(Parser *p, char ***params,
 
   Token *param = consume(p, TOK_NAME);
   if (!param) {
-    free(*params);
+    ast_dealloc(*params);
     *params = NULL;
     return false;
   }
-  char *param_name = strdup(param->text);
+  char *param_name = ast_strndup(param->text, param->length);
   if (!param_name) {
-    free(*params);
+    ast_dealloc(*params);
     *params = NULL;
     return false;
   }
@@ -3093,7 +3169,7 @@ static bool function_parse_parameters(Parser *p, char ***params,
       *params = NULL;
       return false;
     }
-    char *param_name_loop = strdup(param->text);
+    char *param_name_loop = ast_strndup(param->text, param->length);
     if (!param_name_loop) {
       function_cleanup_parameters(*params, *param_count);
       *params = NULL;
@@ -3118,9 +3194,9 @@ static void function_cleanup_parameters(char **params, size_t param_count) {
     return;
   }
   for (size_t i = 0; i < param_count; i++) {
-    free(params[i]);
+    ast_dealloc(params[i]);
   }
-  free(params);
+  ast_dealloc(params);
 }
 
 /**
@@ -3177,26 +3253,26 @@ static ASTNode *parse_function(Parser *p, int indent) {
       for (size_t i = 0; i < block_size; i++) {
         ast_node_free(block[i]);
       }
-      free(block);
+      ast_dealloc(block);
     }
     return NULL;
   }
   ast_node_set_position(node, start_tok);
   node->indent = indent;
-  node->as.function.name = strdup(name->text);
+  node->as.function.name = ast_strndup(name->text, name->length);
   if (!node->as.function.name) {
     // Free params
     for (size_t i = 0; i < param_count; i++)
-      free(params[i]);
-    free(params);
+      ast_dealloc(params[i]);
+    ast_dealloc(params);
     // Free block and its statements
     if (block) {
       for (size_t i = 0; i < block_size; i++) {
         ast_node_free(block[i]);
       }
-      free(block);
+      ast_dealloc(block);
     }
-    free(node);
+    ast_dealloc(node);
     return NULL;
   }
   node->as.function.params = params;
@@ -3233,7 +3309,7 @@ static bool call_parse_arguments(Parser *p, ASTNode ***args, size_t *arg_count,
 
   *arg_capacity = INITIAL_ARRAY_CAPACITY;
   *arg_count = 0;
-  *args = malloc(sizeof(ASTNode *) * *arg_capacity);
+  *args = ast_alloc(sizeof(ASTNode *) * *arg_capacity);
   if (!*args) {
     fprintf(stderr, "parse_call: failed to allocate argument array\n");
     return false;
@@ -3241,7 +3317,7 @@ static bool call_parse_arguments(Parser *p, ASTNode ***args, size_t *arg_count,
 
   ASTNode *arg = parse_expression(p);
   if (!arg) {
-    free(*args);
+    ast_dealloc(*args);
     *args = NULL;
     return false;
   }
@@ -3284,7 +3360,7 @@ static void call_cleanup_arguments(ASTNode **args, size_t arg_count) {
   for (size_t i = 0; i < arg_count; i++) {
     ast_node_free(args[i]);
   }
-  free(args);
+  ast_dealloc(args);
 }
 
 /**
@@ -3332,13 +3408,13 @@ static ASTNode *parse_call(Parser *p, int indent) {
   }
   ast_node_set_position(node, start_tok);
   node->indent = indent;
-  node->as.call.name = strdup(name->text);
+  node->as.call.name = ast_strndup(name->text, name->length);
   if (!node->as.call.name) {
     // Free args
     for (size_t i = 0; i < arg_count; i++)
       ast_node_free(args[i]);
-    free(args);
-    free(node);
+    ast_dealloc(args);
+    ast_dealloc(node);
     return NULL;
   }
   node->as.call.args = args;
@@ -3418,35 +3494,36 @@ static ASTNode *parse_import(Parser *p, int indent) {
     if (!module_tok) {
       return NULL;
     }
-    module_name = strdup(module_tok->text);
+    module_name = ast_strndup(module_tok->text, module_tok->length);
     if (!module_name) {
       return NULL;
     }
 
     if (!consume(p, TOK_IMPORT)) {
-      free(module_name);
+      ast_dealloc(module_name);
       return NULL;
     }
 
     // Parse function names to import
     size_t capacity = INITIAL_ARRAY_CAPACITY;
-    imported_names = malloc(sizeof(char *) * capacity);
+    imported_names = ast_alloc(sizeof(char *) * capacity);
     if (!imported_names) {
-      free(module_name);
+      ast_dealloc(module_name);
       return NULL;
     }
 
     // Parse first function name
     Token *func_tok = consume(p, TOK_NAME);
     if (!func_tok) {
-      free(module_name);
-      free(imported_names);
+      ast_dealloc(module_name);
+      ast_dealloc(imported_names);
       return NULL;
     }
-    imported_names[imported_count++] = strdup(func_tok->text);
+    imported_names[imported_count++] =
+        ast_strndup(func_tok->text, func_tok->length);
     if (!imported_names[imported_count - 1]) {
-      free(module_name);
-      free(imported_names);
+      ast_dealloc(module_name);
+      ast_dealloc(imported_names);
       return NULL;
     }
 
@@ -3458,10 +3535,10 @@ static ASTNode *parse_import(Parser *p, int indent) {
                       sizeof(char *))) {
         // Cleanup
         for (size_t i = 0; i < imported_count; i++) {
-          free(imported_names[i]);
+          ast_dealloc(imported_names[i]);
         }
-        free(module_name);
-        free(imported_names);
+        ast_dealloc(module_name);
+        ast_dealloc(imported_names);
         return NULL;
       }
 
@@ -3469,20 +3546,21 @@ static ASTNode *parse_import(Parser *p, int indent) {
       if (!func_tok) {
         // Cleanup
         for (size_t i = 0; i < imported_count; i++) {
-          free(imported_names[i]);
+          ast_dealloc(imported_names[i]);
         }
-        free(module_name);
-        free(imported_names);
+        ast_dealloc(module_name);
+        ast_dealloc(imported_names);
         return NULL;
       }
-      imported_names[imported_count++] = strdup(func_tok->text);
+      imported_names[imported_count++] =
+          ast_strndup(func_tok->text, func_tok->length);
       if (!imported_names[imported_count - 1]) {
         // Cleanup
         for (size_t i = 0; i < imported_count - 1; i++) {
-          free(imported_names[i]);
+          ast_dealloc(imported_names[i]);
         }
-        free(module_name);
-        free(imported_names);
+        ast_dealloc(module_name);
+        ast_dealloc(imported_names);
         return NULL;
       }
     }
@@ -3494,7 +3572,7 @@ static ASTNode *parse_import(Parser *p, int indent) {
     if (!module_tok) {
       return NULL;
     }
-    module_name = strdup(module_tok->text);
+    module_name = ast_strndup(module_tok->text, module_tok->length);
     if (!module_name) {
       return NULL;
     }
@@ -3507,38 +3585,38 @@ static ASTNode *parse_import(Parser *p, int indent) {
       // Expect string literal for file path
       Token *file_tok = consume(p, TOK_STRING);
       if (!file_tok) {
-        free(module_name);
+        ast_dealloc(module_name);
         return NULL;
       }
-      file_path = strdup(file_tok->text);
+      file_path = ast_strndup(file_tok->text, file_tok->length);
       if (!file_path) {
-        free(module_name);
+        ast_dealloc(module_name);
         return NULL;
       }
     }
   }
 
   if (!consume(p, TOK_NEWLINE)) {
-    free(module_name);
-    free(file_path);
+    ast_dealloc(module_name);
+    ast_dealloc(file_path);
     if (imported_names) {
       for (size_t i = 0; i < imported_count; i++) {
-        free(imported_names[i]);
+        ast_dealloc(imported_names[i]);
       }
-      free(imported_names);
+      ast_dealloc(imported_names);
     }
     return NULL;
   }
 
   ASTNode *node = ast_node_new_checked(AST_IMPORT);
   if (!node) {
-    free(module_name);
-    free(file_path);
+    ast_dealloc(module_name);
+    ast_dealloc(file_path);
     if (imported_names) {
       for (size_t i = 0; i < imported_count; i++) {
-        free(imported_names[i]);
+        ast_dealloc(imported_names[i]);
       }
-      free(imported_names);
+      ast_dealloc(imported_names);
     }
     return NULL;
   }
@@ -3695,16 +3773,27 @@ AST *parse(TokenArray *tokens, ParseError **out_err) {
     return NULL;
   }
 
-  AST *ast = malloc(sizeof(AST));
+  Arena *arena = arena_new();
+  AST *ast = arena ? arena_alloc(arena, sizeof(AST)) : NULL;
   if (!ast) {
+    arena_free(arena);
+    parser_free(p);
     return NULL;
   }
+  ast->arena = arena;
+
+  // Everything below allocates from the AST's arena (see ast_arena). Save
+  // the previous arena in case parse() is re-entered on this thread.
+  Arena *outer_arena = ast_arena;
+  ast_arena = arena;
 
   ast->capacity = INITIAL_ARRAY_CAPACITY * 4; // Larger initial capacity for AST
   ast->count = 0;
-  ast->statements = malloc(sizeof(ASTNode *) * ast->capacity);
+  ast->statements = ast_alloc(sizeof(ASTNode *) * ast->capacity);
   if (!ast->statements) {
-    free(ast);
+    ast_arena = outer_arena;
+    arena_free(arena);
+    parser_free(p);
     return NULL;
   }
 
@@ -3723,15 +3812,11 @@ AST *parse(TokenArray *tokens, ParseError **out_err) {
     if (stmt) {
       if (!grow_array((void **)&ast->statements, ast->count, &ast->capacity,
                       sizeof(ASTNode *))) {
-        // Realloc failed - free the statement and report error
-        ast_node_free(stmt);
+        // Realloc failed - report error and free the AST with its arena
         parser_set_error(p, "Failed to grow AST statements array");
-        // Free existing AST and return NULL
-        for (size_t i = 0; i < ast->count; i++) {
-          ast_node_free(ast->statements[i]);
-        }
-        free(ast->statements);
-        free(ast);
+        ast_arena = outer_arena;
+        arena_free(arena);
+        parser_free(p);
         return NULL;
       }
       ast->statements[ast->count++] = stmt;
@@ -3766,6 +3851,7 @@ AST *parse(TokenArray *tokens, ParseError **out_err) {
   // If errors occurred, the error has been set in out_err (if provided)
   // The AST is returned but may be partial - callers should check out_err
   // to determine if the AST contains all statements or if some failed to parse
+  ast_arena = outer_arena;
   parser_free(p);
   return ast;
 }
@@ -3837,12 +3923,15 @@ ASTNode *parse_expression_only(TokenArray *tokens, ParseError **out_err) {
  * @brief Free an AST node and all its children
  *
  * Recursively frees all memory associated with the node, including
- * strings, arrays, and child nodes.
+ * strings, arrays, and child nodes. Only for trees built outside an arena
+ * (parse_expression_only()); nodes of an AST from parse() are released by
+ * ast_free().
  *
  * @param node Node to free (safe to pass NULL)
  */
 void ast_node_free(ASTNode *node) {
-  if (!node) {
+  // Nodes of the AST being parsed belong to its arena (see ast_arena)
+  if (!node || ast_arena) {
     return;
   }
 
@@ -3901,6 +3990,7 @@ void ast_node_free(ASTNode *node) {
     break;
   case AST_FOR:
     free(node->as.for_stmt.var);
+    free(node->as.for_stmt.value_var);
     ast_node_free(node->as.for_stmt.iterable);
     if (node->as.for_stmt.end) {
       ast_node_free(node->as.for_stmt.end);
@@ -4037,6 +4127,10 @@ void ast_node_free(ASTNode *node) {
 /**
  * @brief Free an AST and all its statements
  *
+ * An AST from parse() lives entirely in its arena, including the AST
+ * structure itself, so freeing the arena frees the tree without visiting
+ * it. An AST assembled by hand (arena NULL) is freed node by node.
+ *
  * @param ast AST to free (safe to pass NULL)
  */
 void ast_free(AST *ast) {
@@ -4044,6 +4138,11 @@ void ast_free(AST *ast) {
     return;
   }
 
+  if (ast->arena) {
+    arena_free(ast->arena);
+    return;
+  }
+
   for (size_t i = 0; i < ast->count; i++) {
     ast_node_free(ast->statements[i]);
   }
@@ -117,6 +117,8 @@ struct ASTNode {
 
     struct {
       char *var;
+      char *value_var;   // Second name of `for key, value in map` (NULL if
+                         // absent)
       ASTNode *iterable; // For range: contains range expression, for list: list
                          // expression
       bool is_range;     // true for range iteration, false for list iteration
@@ -237,6 +239,7 @@ typedef struct {
   ASTNode **statements;
   size_t count;
   size_t capacity;
+  Arena *arena; // Owns the nodes and the AST itself (NULL if built by hand)
 } AST;
 
 // Error information for parsing failures
@@ -266,7 +269,15 @@ ASTNode *parse_expression_only(TokenArray *tokens, ParseError **out_err);
 // Free a ParseError structure
 // @param err ParseError to free (may be NULL, in which case this is a no-op)
 void parse_error_free(ParseError *err);
+
+// Free an AST and all its nodes
+// An AST from parse() is freed with its arena in one step; one assembled by
+// hand (arena NULL) is freed node by node.
 void ast_free(AST *ast);
+
+// Free a node and its children that were not allocated from an arena (e.g.
+// from parse_expression_only()). Nodes of an AST from parse() must not be
+// freed individually; they are released by ast_free().
 void ast_node_free(ASTNode *node);
 
 // Debug
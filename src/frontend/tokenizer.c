@@ -236,7 +236,10 @@ static TokenArray *token_array_new(TokenizeError **out_err) {
   arr->capacity = TOKEN_ARRAY_INITIAL_CAPACITY;
   arr->count = 0;
   arr->tokens = malloc(sizeof(Token) * arr->capacity);
-  if (!arr->tokens) {
+  arr->arena = arena_new();
+  if (!arr->tokens || !arr->arena) {
+    free(arr->tokens);
+    arena_free(arr->arena);
     free(arr);
     tokenizer_report_error(out_err, "Failed to allocate TokenArray buffer", 0,
                            0);
@@ -252,11 +255,11 @@ static bool process_escape_sequence(char escaped_char, char *out_char);
 /**
  * @brief Add a token to the array
  *
- * Automatically grows the array if needed. On failure, frees the token's
- * text if it was allocated.
+ * Automatically grows the array if needed. The token's text must be
+ * allocated from the array's arena or be a static constant.
  *
  * @param arr Token array to add to (modified)
- * @param token Token to add (text will be owned by array, passed by value)
+ * @param token Token to add (passed by value)
  * @param out_err Optional pointer to receive error information
  * @param line_number Line number for error reporting (1-based)
  * @param column Column number for error reporting (1-based)
@@ -275,9 +278,6 @@ static bool token_array_add(TokenArray *arr, const Token token,
       tokenizer_report_error(out_err,
                              "Failed to allocate memory for token array growth",
                              line_number, column);
-      // Free the token's text (we have a local copy, so this is safe)
-      if (token.text)
-        free((void *)token.text);
       return false;
     }
     arr->tokens = new_tokens;
@@ -359,6 +359,42 @@ static bool process_escape_sequence(char escaped_char, char *out_char) {
   }
 }
 
+/**
+ * @brief Text of a string literal token
+ *
+ * DESIGN DECISION: A literal without escape sequences is its own text, so
+ * the token is a slice of the source. Only literals with escapes are decoded,
+ * into the arena, and @p raw_len shrinks by one byte per escape.
+ *
+ * @param arr Token array whose arena receives decoded text
+ * @param raw Literal content between the quotes, as written in the source
+ * @param raw_len Length of @p raw in bytes
+ * @param escape_count Number of escape sequences in @p raw
+ * @return Token text of raw_len - escape_count bytes, or NULL on allocation
+ *         failure
+ */
+static const char *string_token_text(TokenArray *arr, const char *raw,
+                                     size_t raw_len, size_t escape_count) {
+  if (escape_count == 0) {
+    return raw;
+  }
+  char *text_buf = arena_alloc_chars(arr->arena, raw_len - escape_count);
+  if (!text_buf) {
+    return NULL;
+  }
+  size_t dest_pos = 0;
+  size_t pos = 0;
+  while (pos < raw_len) {
+    if (raw[pos] == '\\' && pos + 1 < raw_len) {
+      process_escape_sequence(raw[pos + 1], &text_buf[dest_pos++]);
+      pos += 2;
+    } else {
+      text_buf[dest_pos++] = raw[pos++];
+    }
+  }
+  return text_buf;
+}
+
 /**
  * @brief Tokenize a single line of source code
  *
@@ -370,23 +406,32 @@ static bool process_escape_sequence(char escaped_char, char *out_char) {
  * - Operators and punctuation
  * - Indentation tokens
  *
+ * Token texts are slices of the source; only string literals containing
+ * escape sequences are decoded into the array's arena. A triple-quoted
+ * string may end on a later line: tokenizing then continues after its
+ * closing quotes, and *line_end and *line_number_io move to that line.
+ *
  * @param arr Token array to append tokens to
- * @param line The line to tokenize (should not include leading whitespace)
+ * @param source Complete source buffer (not necessarily nul-terminated)
+ * @param source_len Length of source in bytes
+ * @param content_start Offset of the line's first non-whitespace byte
+ * @param line_end Offset of the line's end (newline or source_len); updated
+ *                 when a multi-line string continues past it
  * @param indent Indentation level in spaces (already calculated)
- * @param line_number 1-based line number for this line
- * @param full_source Complete source code (for multi-line string support)
- * @param source_pos Current position in full_source (updated when reading
- * multi-line strings)
- * @param source_len Total length of full_source
+ * @param line_number_io 1-based line number of this line; updated like
+ *                       line_end
  * @param out_err Optional pointer to receive error information
  * @return true on success, false on error (e.g., unterminated string)
  */
-static bool tokenize_line(TokenArray *arr, const char *line, int indent,
-                          size_t line_number, const char *full_source,
-                          size_t *source_pos, size_t source_len,
+static bool tokenize_line(TokenArray *arr, const char *source,
+                          size_t source_len, size_t content_start,
+                          size_t *line_end, int indent, size_t *line_number_io,
                           TokenizeError **out_err) {
-  size_t len = strlen(line);
+  const char *line = source + content_start;
+  size_t len = *line_end - content_start;
   size_t col = 0;
+  size_t col_base = (size_t)indent; // Column of line[0], minus 1
+  size_t line_number = *line_number_io;
 
   // Skip leading whitespace to check if line is effectively empty
   size_t first_non_whitespace = 0;
@@ -400,10 +445,11 @@ static bool tokenize_line(TokenArray *arr, const char *line, int indent,
   bool is_effectively_empty = (first_non_whitespace >= len);
   bool is_comment_only =
       (first_non_whitespace < len && line[first_non_whitespace] == '#');
+  bool has_content = len > 0 && !is_effectively_empty && !is_comment_only;
 
   // Add indent token if line is not empty and not comment-only
   // Column is 1-based, so indent token starts at column 1
-  if (len > 0 && !is_effectively_empty && !is_comment_only) {
+  if (has_content) {
     Token tok = {TOK_INDENT, NULL, 0, indent, line_number, 1};
     if (!token_array_add(arr, tok, out_err, line_number, 1))
       return false;
@@ -452,20 +498,10 @@ static bool tokenize_line(TokenArray *arr, const char *line, int indent,
         }
       }
       // Column is 1-based: indent (spaces) + position in line + 1
-      size_t token_col = indent + start + 1;
-      Token tok = {TOK_NUMBER, NULL, col - start, 0, line_number, token_col};
-      char *text_buf = malloc(tok.length + 1);
-      if (!text_buf) {
-        tokenizer_report_error(out_err,
-                               "Failed to allocate memory for number literal",
-                               line_number, token_col);
-        return false;
-      }
-      memcpy(text_buf, line + start, tok.length);
-      text_buf[tok.length] = '\0';
-      tok.text = text_buf;
+      size_t token_col = col_base + start + 1;
+      Token tok = {TOK_NUMBER, line + start, col - start, 0, line_number,
+                   token_col};
       if (!token_array_add(arr, tok, out_err, line_number, token_col)) {
-        free(text_buf);
         return false;
       }
       continue;
@@ -499,17 +535,15 @@ static bool tokenize_line(TokenArray *arr, const char *line, int indent,
       size_t quote_count = is_triple_quote ? 3 : 1;
 
       if (is_triple_quote) {
-        // Multi-line string: read from full source across line boundaries
-        // Calculate absolute position in full source
-        size_t abs_pos = *source_pos + col;
-        size_t start_pos = abs_pos + quote_count; // After opening quotes
+        // Multi-line string: read from the source across line boundaries
+        size_t start_pos = (size_t)(line - source) + col + quote_count;
         size_t pos = start_pos;
         bool closed = false;
         size_t escape_count = 0;
 
         // Read forward until we find closing triple quotes
         while (pos + 2 < source_len) {
-          if (full_source[pos] == '\\') {
+          if (source[pos] == '\\') {
             // Handle escape sequences
             if (pos + 1 < source_len) {
               escape_count++;
@@ -518,9 +552,9 @@ static bool tokenize_line(TokenArray *arr, const char *line, int indent,
             } else {
               break;
             }
-          } else if (full_source[pos] == quote_char &&
-                     full_source[pos + 1] == quote_char &&
-                     full_source[pos + 2] == quote_char) {
+          } else if (source[pos] == quote_char &&
+                     source[pos + 1] == quote_char &&
+                     source[pos + 2] == quote_char) {
             closed = true;
             break;
           }
@@ -528,62 +562,56 @@ static bool tokenize_line(TokenArray *arr, const char *line, int indent,
         }
 
         if (!closed) {
-          size_t token_col = indent + col + 1;
+          size_t token_col = col_base + col + 1;
           tokenizer_report_error(out_err,
                                  "Unterminated multi-line string literal",
                                  line_number, token_col);
           return false;
         }
 
-        // Calculate content length (from start_pos to pos, excluding closing
-        // quotes)
+        // Content runs from start_pos to pos, excluding closing quotes
         size_t content_len = pos - start_pos;
-        size_t actual_len = content_len - escape_count; // Escapes become 1 char
-
-        size_t token_col = indent + (is_fstring ? col - 1 : col) + 1;
+        size_t token_col = col_base + (is_fstring ? col - 1 : col) + 1;
         Token tok = {is_fstring ? TOK_FSTRING : TOK_STRING,
                      NULL,
-                     actual_len,
+                     content_len - escape_count, // Escapes become 1 char
                      0,
                      line_number,
                      token_col};
-        char *text_buf = malloc(actual_len + 1);
-        if (!text_buf) {
+        tok.text = string_token_text(arr, source + start_pos, content_len,
+                                     escape_count);
+        if (!tok.text) {
           tokenizer_report_error(out_err,
                                  "Failed to allocate memory for string literal",
                                  line_number, token_col);
           return false;
         }
-
-        // Copy content and process escape sequences
-        size_t dest_pos = 0;
-        pos = start_pos;
-        while (pos < start_pos + content_len) {
-          if (full_source[pos] == '\\' && pos + 1 < start_pos + content_len) {
-            char converted_char;
-            process_escape_sequence(full_source[pos + 1], &converted_char);
-            text_buf[dest_pos++] = converted_char;
-            pos += 2;
-          } else {
-            text_buf[dest_pos++] = full_source[pos++];
-          }
-        }
-        text_buf[actual_len] = '\0';
-        tok.text = text_buf;
         if (!token_array_add(arr, tok, out_err, line_number, token_col)) {
-          free(text_buf);
           return false;
         }
 
-        // Update source_pos to point after closing triple quotes
-        *source_pos = pos + quote_count;
-        // Return false to signal caller to skip to the new position
-        // (The caller will need to handle this)
-        return true;
+        // Continue on the line holding the closing quotes, right after them
+        size_t resume = pos + quote_count;
+        size_t closing_line_start = (size_t)(line - source);
+        for (size_t i = start_pos; i < pos; i++) {
+          if (source[i] == '\n') {
+            line_number++;
+            closing_line_start = i + 1;
+          }
+        }
+        if (closing_line_start != (size_t)(line - source)) {
+          const char *nl = memchr(source + resume, '\n', source_len - resume);
+          *line_end = nl ? (size_t)(nl - source) : source_len;
+          col_base = 0;
+          line = source + closing_line_start;
+          len = *line_end - closing_line_start;
+        }
+        col = resume - (size_t)(line - source);
+        continue;
       } else {
         // Single-line string: original logic
-        size_t content_start = col + quote_count;
-        size_t cursor = content_start;
+        size_t text_start = col + quote_count;
+        size_t cursor = text_start;
         bool closed = false;
         size_t escape_count = 0;
 
@@ -606,48 +634,31 @@ static bool tokenize_line(TokenArray *arr, const char *line, int indent,
         }
 
         if (!closed) {
-          size_t token_col = indent + col + 1;
+          size_t token_col = col_base + col + 1;
           tokenizer_report_error(out_err, "Unterminated string literal",
                                  line_number, token_col);
           return false;
         }
 
-        size_t source_len = cursor - content_start;
-        size_t actual_len = source_len - escape_count;
+        size_t raw_len = cursor - text_start;
 
         size_t token_start_col = is_fstring ? col - 1 : col;
-        size_t token_col = indent + token_start_col + 1;
+        size_t token_col = col_base + token_start_col + 1;
         Token tok = {is_fstring ? TOK_FSTRING : TOK_STRING,
                      NULL,
-                     actual_len,
+                     raw_len - escape_count,
                      0,
                      line_number,
                      token_col};
-        char *text_buf = malloc(actual_len + 1);
-        if (!text_buf) {
+        tok.text = string_token_text(arr, line + text_start, raw_len,
+                                     escape_count);
+        if (!tok.text) {
           tokenizer_report_error(out_err,
                                  "Failed to allocate memory for string literal",
                                  line_number, token_col);
           return false;
         }
-
-        // Copy content and process escape sequences
-        size_t dest_pos = 0;
-        cursor = content_start;
-        while (cursor < content_start + source_len) {
-          if (line[cursor] == '\\' && cursor + 1 < content_start + source_len) {
-            char converted_char;
-            process_escape_sequence(line[cursor + 1], &converted_char);
-            text_buf[dest_pos++] = converted_char;
-            cursor += 2;
-          } else {
-            text_buf[dest_pos++] = line[cursor++];
-          }
-        }
-        text_buf[actual_len] = '\0';
-        tok.text = text_buf;
         if (!token_array_add(arr, tok, out_err, line_number, token_col)) {
-          free(text_buf);
           return false;
         }
         col = cursor + quote_count; // Skip closing quote(s)
@@ -689,20 +700,9 @@ static bool tokenize_line(TokenArray *arr, const char *line, int indent,
       }
       size_t word_len = col - start;
       TokenType type = match_keyword(line + start, word_len);
-      size_t token_col = indent + start + 1;
-      Token tok = {type, NULL, word_len, 0, line_number, token_col};
-      char *text_buf = malloc(tok.length + 1);
-      if (!text_buf) {
-        tokenizer_report_error(out_err,
-                               "Failed to allocate memory for identifier token",
-                               line_number, token_col);
-        return false;
-      }
-      strncpy(text_buf, line + start, tok.length);
-      text_buf[tok.length] = '\0';
-      tok.text = text_buf;
+      size_t token_col = col_base + start + 1;
+      Token tok = {type, line + start, word_len, 0, line_number, token_col};
       if (!token_array_add(arr, tok, out_err, line_number, token_col)) {
-        free(text_buf);
         return false;
       }
       continue;
@@ -711,7 +711,7 @@ static bool tokenize_line(TokenArray *arr, const char *line, int indent,
     // Tokenize single-character punctuation
     // Colon is used for if/for/while statement headers
     if (line[col] == ':') {
-      size_t token_col = indent + col + 1;
+      size_t token_col = col_base + col + 1;
       Token tok = {TOK_COLON, TOKEN_TEXT_COLON, 1, 0, line_number, token_col};
       if (!token_array_add(arr, tok, out_err, line_number, token_col)) {
         return false;
@@ -721,7 +721,7 @@ static bool tokenize_line(TokenArray *arr, const char *line, int indent,
     }
 
     if (line[col] == ',') {
-      size_t token_col = indent + col + 1;
+      size_t token_col = col_base + col + 1;
       Token tok = {TOK_COMMA, TOKEN_TEXT_COMMA, 1, 0, line_number, token_col};
       if (!token_array_add(arr, tok, out_err, line_number, token_col)) {
         return false;
@@ -733,7 +733,7 @@ static bool tokenize_line(TokenArray *arr, const char *line, int indent,
     // Handle '-' as operator token when not part of a number
     // (for unary negation support)
     if (line[col] == '-') {
-      size_t token_col = indent + col + 1;
+      size_t token_col = col_base + col + 1;
       Token tok = {TOK_MINUS, TOKEN_TEXT_MINUS, 5, 0, line_number, token_col};
       if (!token_array_add(arr, tok, out_err, line_number, token_col)) {
         return false;
@@ -744,7 +744,7 @@ static bool tokenize_line(TokenArray *arr, const char *line, int indent,
 
     // Handle parentheses for expression grouping
     if (line[col] == '(') {
-      size_t token_col = indent + col + 1;
+      size_t token_col = col_base + col + 1;
       Token tok = {TOK_LPAREN, TOKEN_TEXT_LPAREN, 1, 0, line_number, token_col};
       if (!token_array_add(arr, tok, out_err, line_number, token_col)) {
         return false;
@@ -754,7 +754,7 @@ static bool tokenize_line(TokenArray *arr, const char *line, int indent,
     }
 
     if (line[col] == ')') {
-      size_t token_col = indent + col + 1;
+      size_t token_col = col_base + col + 1;
       Token tok = {TOK_RPAREN, TOKEN_TEXT_RPAREN, 1, 0, line_number, token_col};
       if (!token_array_add(arr, tok, out_err, line_number, token_col)) {
         return false;
@@ -764,7 +764,7 @@ static bool tokenize_line(TokenArray *arr, const char *line, int indent,
     }
 
     // Unknown character - report error
-    size_t token_col = indent + col + 1;
+    size_t token_col = col_base + col + 1;
     tokenizer_report_error(out_err, "Unknown character encountered",
                            line_number, token_col);
     return false;
@@ -773,14 +773,15 @@ static bool tokenize_line(TokenArray *arr, const char *line, int indent,
   // Add newline token to mark end of line (if line had content)
   // Empty lines and comment-only lines don't get newline tokens to avoid
   // clutter
-  if (len > 0 && !is_effectively_empty && !is_comment_only) {
+  if (has_content) {
     // Newline is at the end of the line
-    size_t token_col = indent + len + 1;
+    size_t token_col = col_base + len + 1;
     Token tok = {TOK_NEWLINE, TOKEN_TEXT_NEWLINE, 1, 0, line_number, token_col};
     if (!token_array_add(arr, tok, out_err, line_number, token_col)) {
       return false;
     }
   }
+  *line_number_io = line_number;
   return true;
 }
 
@@ -832,9 +833,7 @@ static void tokenizer_report_error(TokenizeError **out_err, const char *message,
 /**
  * @brief Tokenize Kronos source code with configurable tab width
  *
- * Main entry point for lexical analysis. Splits source into lines, calculates
- * indentation, and tokenizes each line. Handles mixed indentation errors
- * (spaces and tabs in the same block).
+ * Convenience wrapper around tokenize_buffer() for nul-terminated source.
  *
  * @param source Complete source code to tokenize (must not be NULL)
  * @param out_err Optional pointer to receive error information
@@ -844,6 +843,35 @@ static void tokenizer_report_error(TokenizeError **out_err, const char *message,
  */
 TokenArray *tokenize_with_tab_width(const char *source, TokenizeError **out_err,
                                     int tab_width) {
+  if (!source) {
+    if (out_err)
+      *out_err = NULL;
+    tokenizer_report_error(out_err, "Source code must not be NULL", 0, 0);
+    return NULL;
+  }
+  return tokenize_buffer(source, strlen(source), out_err, tab_width);
+}
+
+/**
+ * @brief Tokenize a length-delimited source buffer
+ *
+ * Main entry point for lexical analysis. Splits source into lines, calculates
+ * indentation, and tokenizes each line. Handles mixed indentation errors
+ * (spaces and tabs in the same block).
+ *
+ * DESIGN DECISION: Lines are tokenized in place, without copying them, and
+ * no byte at or past source + length is read, so the buffer needs no
+ * trailing nul (an mmap'd file can be tokenized directly).
+ *
+ * @param source Source code (must not be NULL unless length is 0)
+ * @param length Length of source in bytes
+ * @param out_err Optional pointer to receive error information
+ * @param tab_width Tab width in spaces (default: 8). Must be > 0.
+ *                  If 0 is passed, defaults to 8.
+ * @return Token array on success, NULL on error
+ */
+TokenArray *tokenize_buffer(const char *source, size_t length,
+                            TokenizeError **out_err, int tab_width) {
   // Use default tab width if invalid value provided
   if (tab_width <= 0) {
     tab_width = 8;
@@ -853,7 +881,7 @@ TokenArray *tokenize_with_tab_width(const char *source, TokenizeError **out_err,
     *out_err = NULL;
 
   // Validate input
-  if (!source) {
+  if (!source && length > 0) {
     tokenizer_report_error(out_err, "Source code must not be NULL", 0, 0);
     return NULL;
   }
@@ -863,23 +891,17 @@ TokenArray *tokenize_with_tab_width(const char *source, TokenizeError **out_err,
     return NULL;
   }
 
-  size_t source_len = strlen(source);
   // Process source line by line
-  const char *line_start = source;
-  const char *line_end;
+  size_t pos = 0;
   size_t line_number = 1;
-  size_t source_pos =
-      0; // Track absolute position in source for multi-line strings
-
-  while (*line_start && source_pos < source_len) {
-    // Find the end of the current line (newline or end of string)
-    line_end = line_start;
-    while (*line_end && *line_end != '\n') {
-      line_end++;
-    }
+
+  while (pos < length) {
+    // Find the end of the current line (newline or end of buffer)
+    const char *nl = memchr(source + pos, '\n', length - pos);
+    size_t line_end = nl ? (size_t)(nl - source) : length;
 
     // Calculate line length
-    size_t line_len = line_end - line_start;
+    size_t line_len = line_end - pos;
 
     // Calculate indentation level
     // Tabs are treated as TOKENIZER_TAB_WIDTH spaces
@@ -890,7 +912,7 @@ TokenArray *tokenize_with_tab_width(const char *source, TokenizeError **out_err,
     bool saw_tab = false;
     size_t i = 0;
     for (; i < line_len; i++) {
-      char c = line_start[i];
+      char c = source[pos + i];
       if (c == ' ') {
         saw_space = true;
         indent++;
@@ -915,73 +937,26 @@ TokenArray *tokenize_with_tab_width(const char *source, TokenizeError **out_err,
       }
     }
 
-    // Extract line content (after leading whitespace)
-    const char *content_start = line_start + i;
-    size_t content_len = line_len - i;
-
-    if (content_len > 0) {
-      char *line = malloc(content_len + 1);
-      if (!line) {
-        tokenizer_report_error(out_err,
-                               "Failed to allocate memory while tokenizing",
-                               line_number, 1);
-        token_array_free(arr);
-        return NULL;
-      }
-      strncpy(line, content_start, content_len);
-      line[content_len] = '\0';
-
-      size_t old_source_pos = source_pos;
-      if (!tokenize_line(arr, line, indent, line_number, source, &source_pos,
-                         source_len, out_err)) {
+    // Tokenize the line content (after leading whitespace). A multi-line
+    // string moves line_end and line_number to the line it closes on.
+    if (i < line_len) {
+      if (!tokenize_line(arr, source, length, pos + i, &line_end, indent,
+                         &line_number, out_err)) {
         if (out_err && !*out_err) {
           tokenizer_report_error(
               out_err, "Failed to allocate memory while tokenizing line",
               line_number, 1);
-        } else if (!out_err) {
-          // out_err is NULL, cannot report error - this is a memory allocation
-          // failure that cannot be communicated to caller
-          // Free resources and return NULL
-          token_array_free(arr);
-          free(line);
-          return NULL;
         }
-        free(line);
         token_array_free(arr);
         return NULL;
       }
-      free(line);
-
-      // If source_pos advanced beyond current line, skip to that position
-      // (multi-line string consumed multiple lines)
-      if (source_pos > old_source_pos + line_len) {
-        // Find the line that source_pos points to
-        line_start = source + source_pos;
-        // Find the start of the current line
-        while (line_start > source && line_start[-1] != '\n') {
-          line_start--;
-        }
-        // Count lines to update line_number
-        const char *p = source;
-        line_number = 1;
-        while (p < line_start) {
-          if (*p == '\n') {
-            line_number++;
-          }
-          p++;
-        }
-        continue; // Process the new line
-      }
     }
 
     // Move to next line
-    source_pos = line_end - source;
-    if (*line_end == '\n') {
-      source_pos++; // Skip newline
+    pos = line_end;
+    if (pos < length) {
+      pos++; // Skip newline
     }
-    line_start = line_end;
-    if (*line_start == '\n')
-      line_start++;
     line_number++;
   }
 
@@ -1041,8 +1016,9 @@ void token_free(Token *token) {
 /**
  * @brief Free a token array and all its tokens
  *
- * Releases all token text strings and the array structure itself.
- * Uses token_free() internally to ensure consistent behavior.
+ * Releases the decoded token texts at once by freeing the array's arena,
+ * then the array structure itself. Texts sliced from the source belong to
+ * the caller's buffer.
  *
  * @param array Token array to free (safe to pass NULL)
  */
@@ -1050,14 +1026,30 @@ void token_array_free(TokenArray *array) {
   if (!array)
     return;
 
-  // Free each token's text using token_free() for consistency
-  for (size_t i = 0; i < array->count; i++) {
-    token_free(&array->tokens[i]);
-  }
+  arena_free(array->arena);
   free(array->tokens);
   free(array);
 }
 
+/**
+ * @brief Check whether a token's text equals a nul-terminated string
+ *
+ * Token texts are not nul-terminated (see Token.text), so strcmp() cannot
+ * compare them.
+ *
+ * @param token Token to check (safe to pass NULL)
+ * @param text Expected text (must not be NULL)
+ * @return true if the token has exactly the bytes of @p text
+ */
+bool token_text_equals(const Token *token, const char *text) {
+  if (!token || !token->text) {
+    return false;
+  }
+  size_t text_len = strlen(text);
+  return token->length == text_len &&
+         memcmp(token->text, text, text_len) == 0;
+}
+
 /**
  * @brief Print a token for debugging
  *
@@ -1084,7 +1076,7 @@ void token_print(Token *token) {
   if (token->type == TOK_INDENT) {
     printf(" (indent=%d)", token->indent_level);
   } else if (token->text) {
-    printf(" '%s'", token->text);
+    printf(" '%.*s'", (int)token->length, token->text);
   }
   printf("\n");
 }
@@ -1,6 +1,8 @@
 #ifndef KRONOS_TOKENIZER_H
 #define KRONOS_TOKENIZER_H
 
+#include "arena.h"
+#include <stdbool.h>
 #include <stddef.h>
 
 #ifdef __cplusplus
@@ -72,22 +74,21 @@ typedef enum {
 typedef struct {
   TokenType type;
   const char *
-      text; // Token text string (nul-terminated).
+      text; // Token text: `length` bytes, NOT nul-terminated. Compare it
+            // with token_text_equals() and copy it with strndup().
             //
             // OWNERSHIP RULES:
-            // - If Token is part of a TokenArray: TokenArray owns the text.
-            //   Use token_array_free() to free the entire array and all tokens.
-            // - If Token is extracted/copied from a TokenArray: Caller owns the
-            // text.
-            //   Use token_free() or free((char *)text) to free it.
+            // - If Token is part of a TokenArray: the text is a slice of the
+            //   tokenized source, except for string literals with escape
+            //   sequences, whose decoded text lives in the array's arena. It
+            //   is valid while both the source and the array are; copy it to
+            //   outlive either.
+            // - If Token is created manually with malloc()'d text: Caller
+            //   owns the text. Use token_free() to free it.
             // - Static constants (colon, comma, minus, newline): Never freed.
             //   These are static strings that don't require freeing.
             //
-            // Allocated via malloc()/strdup() during tokenization for dynamic
-            // tokens. For static tokens (TOK_COLON, TOK_COMMA, TOK_MINUS,
-            // TOK_NEWLINE), points to static string constants that must not be
-            // freed. The pointer becomes invalid after freeing (for
-            // heap-allocated text).
+            // The pointer becomes invalid once its owner is freed.
   size_t length;
   int indent_level; // For INDENT tokens
   size_t line;   // 1-based line number where this token starts (0 if unknown)
@@ -98,6 +99,7 @@ typedef struct {
   Token *tokens;
   size_t count;
   size_t capacity;
+  Arena *arena; // Holds decoded string literal texts (see arena.h)
 } TokenArray;
 
 // Error information for tokenization failures
@@ -122,6 +124,19 @@ typedef struct {
 TokenArray *tokenize_with_tab_width(const char *source, TokenizeError **out_err,
                                     int tab_width);
 
+// Tokenize a length-delimited source buffer
+// @param source Source code to tokenize (may be NULL only if length is 0).
+//               Need not be nul-terminated: no byte at or past
+//               source + length is read, so an mmap'd file works as is.
+// @param length Length of source in bytes.
+// @param out_err, tab_width As for tokenize_with_tab_width().
+// @return As for tokenize_with_tab_width().
+//
+// OWNERSHIP: Token texts point into source, so source must stay valid and
+//            unchanged until token_array_free() (see Token.text).
+TokenArray *tokenize_buffer(const char *source, size_t length,
+                            TokenizeError **out_err, int tab_width);
+
 // Tokenize source code (default tab width of 8)
 // Wrapper around tokenize_with_tab_width() for backward compatibility.
 // @param source Source code to tokenize (must not be NULL).
@@ -134,9 +149,8 @@ TokenArray *tokenize_with_tab_width(const char *source, TokenizeError **out_err,
 //         error details.
 //
 // OWNERSHIP: Caller owns the returned TokenArray and must free it with
-//            token_array_free(). The TokenArray owns all Token.text strings.
-//            If you extract Tokens from the array, you own those tokens and
-//            must free them with token_free().
+//            token_array_free(). Token texts are slices of source (see
+//            Token.text), so source must outlive the array.
 //
 // Also free any TokenizeError with tokenize_error_free().
 TokenArray *tokenize(const char *source, TokenizeError **out_err);
@@ -148,32 +162,30 @@ void tokenize_error_free(TokenizeError *err);
 
 // Free a single Token's resources (frees the text string)
 //
-// OWNERSHIP: Use this when you own a Token that is NOT part of a TokenArray.
-// Examples:
-//   - Token extracted/copied from a TokenArray (caller now owns it)
-//   - Token created manually outside of tokenization
+// OWNERSHIP: Use this for a Token created manually outside of tokenization
+// whose text was allocated with malloc()/strdup().
 //
-// DO NOT use this for Tokens that are still part of a TokenArray.
-// Instead, use token_array_free() to free the entire array.
+// DO NOT use this for Tokens of a TokenArray, or copies of them: their text
+// lives in the array's arena. Use token_array_free() to free the array.
 //
 // SAFETY: This function safely handles static string constants (colon, comma,
 //         minus, newline) and will not attempt to free them.
-// Note: token_array_free() uses this function internally for consistency.
 void token_free(Token *token);
 
 // Free a TokenArray and all its Tokens
 //
 // OWNERSHIP: Frees the TokenArray structure and all Token.text strings it
-// contains. After calling this, the TokenArray pointer and all Token pointers
-// within it become invalid and must not be used.
+// contains by freeing its arena, without visiting the tokens. After calling
+// this, the TokenArray pointer and all Token pointers within it become
+// invalid and must not be used.
 //
-// SAFETY: Automatically handles static string constants (colon, comma, minus,
-//         newline) and will not attempt to free them.
-//
-// If you need to extract Tokens from the array before freeing, copy them first
-// (they will own their text), then free the array.
+// If you need Tokens to outlive the array, copy them and their text first,
+// then free the array.
 void token_array_free(TokenArray *array);
 
+// Check whether a token's text is exactly @p text (nul-terminated)
+bool token_text_equals(const Token *token, const char *text);
+
 // Debug
 void token_print(Token *token);
 
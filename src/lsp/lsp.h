@@ -6,6 +6,7 @@
 #ifndef LSP_H
 #define LSP_H
 
+#include "../compiler/infer.h"
 #include "../frontend/parser.h"
 #include <stdbool.h>
 #include <stddef.h>
@@ -75,20 +76,6 @@ typedef struct {
   ImportedModule *imported_modules; /**< Linked list of imported modules */
 } DocumentState;
 
-/**
- * Type inference for expressions
- */
-typedef enum {
-  TYPE_UNKNOWN,
-  TYPE_NUMBER,
-  TYPE_STRING,
-  TYPE_LIST,
-  TYPE_MAP,
-  TYPE_RANGE,
-  TYPE_BOOL,
-  TYPE_NULL
-} ExprType;
-
 // Forward declarations
 // Global document state - NOTE: Currently only supports single document
 // TODO: Implement multi-document support using hash table keyed by URI
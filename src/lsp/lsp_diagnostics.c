@@ -34,106 +34,38 @@ typedef struct {
   size_t first_statement_index;
 } SeenVar;
 
-ExprType infer_type_with_ast(ASTNode *node, Symbol *symbols, AST *ast) {
-  if (!node)
-    return TYPE_UNKNOWN;
-
-  switch (node->type) {
-  case AST_NUMBER:
-    return TYPE_NUMBER;
-  case AST_STRING:
-  case AST_FSTRING:
-    return TYPE_STRING;
-  case AST_BOOL:
-    return TYPE_BOOL;
-  case AST_NULL:
-    return TYPE_NULL;
-  case AST_LIST:
-    return TYPE_LIST;
-  case AST_MAP:
-    return TYPE_MAP;
-  case AST_VAR: {
-    Symbol *sym = find_symbol(node->as.var_name);
-    if (sym && sym->type_name) {
-      if (strcmp(sym->type_name, "number") == 0)
-        return TYPE_NUMBER;
-      if (strcmp(sym->type_name, "string") == 0)
-        return TYPE_STRING;
-      if (strcmp(sym->type_name, "list") == 0)
-        return TYPE_LIST;
-      if (strcmp(sym->type_name, "map") == 0)
-        return TYPE_MAP;
-      if (strcmp(sym->type_name, "bool") == 0)
-        return TYPE_BOOL;
-    }
-    // If no explicit type annotation, try to infer from assigned value
-    if (ast) {
-      ASTNode *assign_node = find_variable_assignment(ast, node->as.var_name);
-      if (assign_node && assign_node->as.assign.value) {
-        // Recursively infer type from the assigned value
-        return infer_type_with_ast(assign_node->as.assign.value, symbols, ast);
-      }
-    }
-    return TYPE_UNKNOWN;
+// Variable context for infer_type_with_ast()
+typedef struct {
+  AST *ast;
+  size_t depth; // Guards self-referencing first assignments (x to x plus 1)
+} InferContext;
+
+static ExprType infer_variable_type(const char *name, void *ctx) {
+  InferContext *infer = ctx;
+  Symbol *sym = find_symbol(name);
+  if (sym && sym->type_name) {
+    ExprType annotated = infer_type_from_name(sym->type_name);
+    if (annotated != TYPE_UNKNOWN)
+      return annotated;
   }
-  case AST_BINOP:
-    // Plus can return number (addition) or string (concatenation)
-    if (node->as.binop.op == BINOP_ADD) {
-      ExprType left_type =
-          infer_type_with_ast(node->as.binop.left, symbols, ast);
-      ExprType right_type =
-          infer_type_with_ast(node->as.binop.right, symbols, ast);
-      // If either operand is a string, result is string (concatenation)
-      // This handles: string + string, string + number, number + string
-      if (left_type == TYPE_STRING || right_type == TYPE_STRING) {
-        return TYPE_STRING;
-      }
-      // Otherwise, result is number (addition)
-      return TYPE_NUMBER;
+  // If no explicit type annotation, try to infer from assigned value
+  if (infer->ast && infer->depth < MAX_AST_DEPTH) {
+    ASTNode *assign_node = find_variable_assignment(infer->ast, name);
+    if (assign_node && assign_node->as.assign.value) {
+      infer->depth++;
+      ExprType type =
+          infer_expr_type(assign_node->as.assign.value, infer_variable_type, ctx);
+      infer->depth--;
+      return type;
     }
-    // Other arithmetic operations return numbers
-    if (node->as.binop.op == BINOP_SUB || node->as.binop.op == BINOP_MUL ||
-        node->as.binop.op == BINOP_DIV || node->as.binop.op == BINOP_MOD) {
-      return TYPE_NUMBER;
-    }
-    // Unary operators
-    if (node->as.binop.op == BINOP_NOT || node->as.binop.op == BINOP_NEG) {
-      // Unary NOT returns bool, unary NEG returns number
-      if (node->as.binop.op == BINOP_NOT) {
-        return TYPE_BOOL;
-      } else {
-        return TYPE_NUMBER;
-      }
-    }
-    // Comparisons return bool
-    if (node->as.binop.op == BINOP_EQ || node->as.binop.op == BINOP_NEQ ||
-        node->as.binop.op == BINOP_GT || node->as.binop.op == BINOP_LT ||
-        node->as.binop.op == BINOP_GTE || node->as.binop.op == BINOP_LTE) {
-      return TYPE_BOOL;
-    }
-    return TYPE_UNKNOWN;
-  case AST_INDEX: {
-    // List/string/map indexing - for maps, return TYPE_UNKNOWN (value type)
-    // For lists/strings, return the element type
-    ExprType container_type =
-        infer_type_with_ast(node->as.index.list_expr, symbols, ast);
-    if (container_type == TYPE_MAP) {
-      // Map indexing returns the value type, which we can't infer statically
-      return TYPE_UNKNOWN;
-    }
-    return container_type;
-  }
-  case AST_RANGE:
-    return TYPE_RANGE;
-  case AST_SLICE: {
-    // Slicing returns the same type as the container
-    ExprType container_type =
-        infer_type_with_ast(node->as.slice.list_expr, symbols, ast);
-    return container_type;
-  }
-  default:
-    return TYPE_UNKNOWN;
   }
+  return TYPE_UNKNOWN;
+}
+
+ExprType infer_type_with_ast(ASTNode *node, Symbol *symbols, AST *ast) {
+  (void)symbols; // Variables resolve through find_symbol()
+  InferContext ctx = {ast, 0};
+  return infer_expr_type(node, infer_variable_type, &ctx);
 }
 
 void check_function_calls(AST *ast, const char *text, Symbol *symbols,
@@ -364,7 +296,7 @@ void check_function_calls(AST *ast, const char *text, Symbol *symbols,
       // Check if block
       if (node->as.if_stmt.block) {
         AST temp_ast = {node->as.if_stmt.block, node->as.if_stmt.block_size,
-                        node->as.if_stmt.block_size};
+                        node->as.if_stmt.block_size, NULL};
         check_function_calls(&temp_ast, text, symbols, diagnostics, pos,
                              remaining, has_diagnostics, capacity);
       }
@@ -373,7 +305,7 @@ void check_function_calls(AST *ast, const char *text, Symbol *symbols,
         if (node->as.if_stmt.else_if_blocks[j]) {
           AST temp_ast = {node->as.if_stmt.else_if_blocks[j],
                           node->as.if_stmt.else_if_block_sizes[j],
-                          node->as.if_stmt.else_if_block_sizes[j]};
+                          node->as.if_stmt.else_if_block_sizes[j], NULL};
           check_function_calls(&temp_ast, text, symbols, diagnostics, pos,
                                remaining, has_diagnostics, capacity);
         }
@@ -382,7 +314,7 @@ void check_function_calls(AST *ast, const char *text, Symbol *symbols,
       if (node->as.if_stmt.else_block) {
         AST temp_ast = {node->as.if_stmt.else_block,
                         node->as.if_stmt.else_block_size,
-                        node->as.if_stmt.else_block_size};
+                        node->as.if_stmt.else_block_size, NULL};
         check_function_calls(&temp_ast, text, symbols, diagnostics, pos,
                              remaining, has_diagnostics, capacity);
       }
@@ -397,14 +329,14 @@ void check_function_calls(AST *ast, const char *text, Symbol *symbols,
         block_size = node->as.while_stmt.block_size;
       }
       if (block) {
-        AST temp_ast = {block, block_size, block_size};
+        AST temp_ast = {block, block_size, block_size, NULL};
         check_function_calls(&temp_ast, text, symbols, diagnostics, pos,
                              remaining, has_diagnostics, capacity);
       }
     } else if (node->type == AST_FUNCTION) {
       if (node->as.function.block) {
         AST temp_ast = {node->as.function.block, node->as.function.block_size,
-                        node->as.function.block_size};
+                        node->as.function.block_size, NULL};
         check_function_calls(&temp_ast, text, symbols, diagnostics, pos,
                              remaining, has_diagnostics, capacity);
       }
@@ -1289,9 +1221,11 @@ void check_undefined_variables(AST *ast, const char *text, Symbol *symbols,
 
     // Check expressions in for loops
     if (node->type == AST_FOR) {
-      // Mark loop variable as written (assigned by the loop)
-      if (node->as.for_stmt.var) {
-        Symbol *loop_sym = find_symbol(node->as.for_stmt.var);
+      // Mark loop variables as written (assigned by the loop)
+      const char *loop_vars[] = {node->as.for_stmt.var,
+                                 node->as.for_stmt.value_var};
+      for (size_t j = 0; j < 2; j++) {
+        Symbol *loop_sym = loop_vars[j] ? find_symbol(loop_vars[j]) : NULL;
         if (loop_sym && loop_sym->type == SYMBOL_VARIABLE) {
           loop_sym->written = true;
         }
@@ -1372,7 +1306,7 @@ void check_undefined_variables(AST *ast, const char *text, Symbol *symbols,
       if (node->as.try_stmt.try_block) {
         AST try_ast = {node->as.try_stmt.try_block,
                        node->as.try_stmt.try_block_size,
-                       node->as.try_stmt.try_block_size};
+                       node->as.try_stmt.try_block_size, NULL};
         check_undefined_variables(&try_ast, text, symbols, diagnostics, pos,
                                   remaining, has_diagnostics, capacity);
       }
@@ -1381,7 +1315,8 @@ void check_undefined_variables(AST *ast, const char *text, Symbol *symbols,
         if (node->as.try_stmt.catch_blocks[j].catch_block) {
           AST catch_ast = {node->as.try_stmt.catch_blocks[j].catch_block,
                            node->as.try_stmt.catch_blocks[j].catch_block_size,
-                           node->as.try_stmt.catch_blocks[j].catch_block_size};
+                           node->as.try_stmt.catch_blocks[j].catch_block_size,
+                           NULL};
           check_undefined_variables(&catch_ast, text, symbols, diagnostics, pos,
                                     remaining, has_diagnostics, capacity);
         }
@@ -1390,7 +1325,7 @@ void check_undefined_variables(AST *ast, const char *text, Symbol *symbols,
       if (node->as.try_stmt.finally_block) {
         AST finally_ast = {node->as.try_stmt.finally_block,
                            node->as.try_stmt.finally_block_size,
-                           node->as.try_stmt.finally_block_size};
+                           node->as.try_stmt.finally_block_size, NULL};
         check_undefined_variables(&finally_ast, text, symbols, diagnostics, pos,
                                   remaining, has_diagnostics, capacity);
       }
@@ -1836,7 +1771,7 @@ void check_undefined_variables(AST *ast, const char *text, Symbol *symbols,
     if (node->type == AST_IF) {
       if (node->as.if_stmt.block) {
         AST temp_ast = {node->as.if_stmt.block, node->as.if_stmt.block_size,
-                        node->as.if_stmt.block_size};
+                        node->as.if_stmt.block_size, NULL};
         check_undefined_variables(&temp_ast, text, symbols, diagnostics, pos,
                                   remaining, has_diagnostics, capacity);
       }
@@ -1844,7 +1779,7 @@ void check_undefined_variables(AST *ast, const char *text, Symbol *symbols,
         if (node->as.if_stmt.else_if_blocks[j]) {
           AST temp_ast = {node->as.if_stmt.else_if_blocks[j],
                           node->as.if_stmt.else_if_block_sizes[j],
-                          node->as.if_stmt.else_if_block_sizes[j]};
+                          node->as.if_stmt.else_if_block_sizes[j], NULL};
           check_undefined_variables(&temp_ast, text, symbols, diagnostics, pos,
                                     remaining, has_diagnostics, capacity);
         }
@@ -1852,7 +1787,7 @@ void check_undefined_variables(AST *ast, const char *text, Symbol *symbols,
       if (node->as.if_stmt.else_block) {
         AST temp_ast = {node->as.if_stmt.else_block,
                         node->as.if_stmt.else_block_size,
-                        node->as.if_stmt.else_block_size};
+                        node->as.if_stmt.else_block_size, NULL};
         check_undefined_variables(&temp_ast, text, symbols, diagnostics, pos,
                                   remaining, has_diagnostics, capacity);
       }
@@ -1867,14 +1802,14 @@ void check_undefined_variables(AST *ast, const char *text, Symbol *symbols,
         block_size = node->as.while_stmt.block_size;
       }
       if (block) {
-        AST temp_ast = {block, block_size, block_size};
+        AST temp_ast = {block, block_size, block_size, NULL};
         check_undefined_variables(&temp_ast, text, symbols, diagnostics, pos,
                                   remaining, has_diagnostics, capacity);
       }
     } else if (node->type == AST_FUNCTION) {
       if (node->as.function.block) {
         AST temp_ast = {node->as.function.block, node->as.function.block_size,
-                        node->as.function.block_size};
+                        node->as.function.block_size, NULL};
         check_undefined_variables(&temp_ast, text, symbols, diagnostics, pos,
                                   remaining, has_diagnostics, capacity);
       }
@@ -180,13 +180,16 @@ Symbol *load_module_exports(const char *file_path) {
 
   // Tokenize and parse
   TokenArray *tokens = tokenize(source, NULL);
-  free(source);
 
-  if (!tokens)
+  if (!tokens) {
+    free(source);
     return NULL;
+  }
 
+  // Token texts are slices of source, so it must outlive parsing
   AST *ast = parse(tokens, NULL);
   token_array_free(tokens);
+  free(source);
 
   if (!ast || ast->count == 0) {
     if (ast)
@@ -635,12 +638,17 @@ void process_statements_for_symbols(ASTNode **statements, size_t count,
       break;
     }
     case AST_FOR: {
-      // Add loop variable to symbol table
-      if (node->as.for_stmt.var) {
+      // Add loop variable(s) to symbol table (key and value for maps)
+      const char *loop_vars[] = {node->as.for_stmt.var,
+                                 node->as.for_stmt.value_var};
+      for (size_t j = 0; j < 2; j++) {
+        if (!loop_vars[j]) {
+          continue;
+        }
         sym = malloc(sizeof(Symbol));
         if (!sym)
           break;
-        sym->name = strdup(node->as.for_stmt.var);
+        sym->name = strdup(loop_vars[j]);
         sym->type = SYMBOL_VARIABLE;
         sym->is_mutable =
             false; // Loop variables are immutable (assigned by loop)
@@ -1367,7 +1375,7 @@ bool is_loop_variable(Symbol *sym, AST *ast) {
     // Check nested FOR statements in the loop body
     if (node->as.for_stmt.block) {
       AST temp_ast = {node->as.for_stmt.block, node->as.for_stmt.block_size,
-                      node->as.for_stmt.block_size};
+                      node->as.for_stmt.block_size, NULL};
       if (is_loop_variable(sym, &temp_ast))
         return true;
     }
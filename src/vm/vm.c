@@ -5,8 +5,10 @@
  * DESIGN DECISIONS:
  * - Stack-based: Simpler than register-based, easier to implement, good for
  *   interpreted languages. Trade-off is more instructions for complex operations.
- * - Fixed-size stacks: STACK_MAX, CALL_STACK_MAX, etc. prevent unbounded growth
- *   but limit program complexity. Overflow is detected and reported as errors.
+ * - Growable stacks: the value stack and the call stack start small and
+ *   double on demand, so a VM (and each module VM) is cheap to create. Call
+ *   depth is bounded by max_call_depth (vm_set_max_call_depth()), and each
+ *   frame's slot array is sized by its function's slot count.
  * - Hash tables for variables: O(1) lookup for globals/locals/functions using
  *   linear probing. Faster than linear search for large programs.
  * - Module isolation: Each module has its own VM instance for namespace
@@ -16,7 +18,8 @@
  *
  * EDGE CASES:
  * - Stack overflow: Detected and reported as runtime error
- * - Call stack overflow: Detected before creating new frame
+ * - Call stack overflow: Detected before creating new frame (growing a
+ *   stack moves it, so code that grows one rebases the pointers into it)
  * - Variable lookup: Locals checked first, then globals (lexical scoping)
  * - Module imports: Circular imports detected via loading_modules stack
  * - Exception handling: Handlers stored on stack, properly unwound on errors
@@ -36,6 +39,7 @@
 #define _POSIX_C_SOURCE 200809L
 #include "vm.h"
 #include "../compiler/compiler.h"
+#include "../core/gc.h"
 #include "../frontend/parser.h"
 #include "../frontend/tokenizer.h"
 #include <ctype.h>
@@ -44,6 +48,7 @@
 #include <math.h>
 #include <regex.h>
 #include <stdarg.h>
+#include <stdatomic.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -63,6 +68,42 @@
 #include <windows.h>
 #endif
 
+// Interpreter dispatch strategy. GCC and Clang support labels-as-values,
+// letting vm_execute jump straight from one opcode body to the next; other
+// compilers (or builds with -DKRONOS_NO_COMPUTED_GOTO) use the portable
+// handler table.
+#if defined(__GNUC__) && !defined(KRONOS_NO_COMPUTED_GOTO)
+#define KRONOS_COMPUTED_GOTO 1
+#else
+#define KRONOS_COMPUTED_GOTO 0
+#endif
+
+// Branch hint for error checks on the interpreter fast path
+#if defined(__GNUC__)
+#define VM_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#else
+#define VM_UNLIKELY(x) (x)
+#endif
+
+// Opcode bodies shared by the narrow handler and the OP_WIDE handler are
+// inlined into both, so the narrow path keeps its 16-bit operand reads
+#if defined(__GNUC__)
+#define VM_ALWAYS_INLINE inline __attribute__((always_inline))
+#define VM_NOINLINE __attribute__((noinline))
+#else
+#define VM_ALWAYS_INLINE inline
+#define VM_NOINLINE
+#endif
+
+// GCC merges the identical dispatch sequences at the end of each opcode body
+// back into one shared indirect jump ("cross-jumping"), which defeats
+// threaded dispatch; keep them separate in vm_execute
+#if KRONOS_COMPUTED_GOTO && defined(__GNUC__) && !defined(__clang__)
+#define VM_THREADED_DISPATCH __attribute__((optimize("no-crossjumping")))
+#else
+#define VM_THREADED_DISPATCH
+#endif
+
 /**
  * @brief Portable fopen() implementation with UTF-8 support
  *
@@ -214,49 +255,183 @@ static int sort_compare_values(const void *a, const void *b) {
 
   // Determine comparison type from values (all items are same type per
   // validation)
-  if (val_a->type == VAL_NUMBER) {
-    double diff = val_a->as.number - val_b->as.number;
+  if (value_is_number(val_a)) {
+    double diff = value_as_number(val_a) - value_as_number(val_b);
     return (diff > 0) - (diff < 0);
-  } else if (val_a->type == VAL_STRING) {
+  } else if (value_type(val_a) == VAL_STRING) {
     return strcmp(val_a->as.string.data, val_b->as.string.data);
   }
   // Should not reach here if validation is correct
   return 0;
 }
 
+/**
+ * @brief Drop the containers of all live for-in iterators in @p iterators
+ *
+ * Loops left by an exception keep their iterator until the slot is reused or
+ * the frame (or VM) goes away.
+ */
+static void release_iterators(IteratorState *iterators, uint32_t *live) {
+  for (size_t depth = 0; *live != 0; depth++) {
+    if (*live & (UINT32_C(1) << depth)) {
+      value_release(iterators[depth].container);
+      iterators[depth].container = NULL;
+      *live &= ~(UINT32_C(1) << depth);
+    }
+  }
+}
+
 /**
  * @brief Clean up a call frame's local variables
  *
- * Frees all names, releases all values, and frees all type names
- * in the given call frame, then resets the local_count to 0.
+ * Releases all assigned slot values (and the containers of any for-in loops
+ * still running) in the given call frame, then resets the slot_count to 0.
+ * Names and types belong to the function's slot descriptors and are not
+ * touched.
  *
  * @param frame Call frame to clean up (must not be NULL)
  */
 static void cleanup_call_frame_locals(CallFrame *frame) {
-  for (size_t i = 0; i < frame->local_count; i++) {
-    if (frame->locals[i].name) {
-      free(frame->locals[i].name);
-      frame->locals[i].name = NULL;
-    }
-    if (frame->locals[i].value) {
-      value_release(frame->locals[i].value);
-      frame->locals[i].value = NULL;
-    }
-    if (frame->locals[i].type_name) {
-      free(frame->locals[i].type_name);
-      frame->locals[i].type_name = NULL;
+  for (size_t i = 0; i < frame->slot_count; i++) {
+    if (frame->slots[i]) {
+      value_release(frame->slots[i]);
+      frame->slots[i] = NULL;
     }
   }
-  frame->local_count = 0;
+  frame->slot_count = 0;
+  if (frame->live_iterators) {
+    release_iterators(frame->iterators, &frame->live_iterators);
+  }
+}
+
+/**
+ * @brief Prepare a fresh call frame's slots for a function
+ *
+ * Frames that are not on the call stack always have every slot NULL (slot
+ * arrays are zeroed as they grow and cleanup_call_frame_locals() clears
+ * what it releases), so entering a frame only records how many slots it
+ * uses. The slot array stays with the call stack entry: it is only grown
+ * when a function needs more slots than any earlier call at this depth.
+ * Parameters are bound by the caller.
+ *
+ * @param frame Call frame to initialize (must not be NULL)
+ * @param func Function being called (must not be NULL)
+ * @return false if the slot array could not be grown
+ */
+static bool init_call_frame_locals(CallFrame *frame, const Function *func) {
+  size_t slot_count = func->slot_count > func->param_count ? func->slot_count
+                                                           : func->param_count;
+  if (slot_count > frame->slot_capacity) {
+    KronosValue **slots =
+        realloc(frame->slots, slot_count * sizeof(KronosValue *));
+    if (!slots) {
+      return false;
+    }
+    memset(slots + frame->slot_capacity, 0,
+           (slot_count - frame->slot_capacity) * sizeof(KronosValue *));
+    frame->slots = slots;
+    frame->slot_capacity = slot_count;
+  }
+  frame->slot_count = slot_count;
+  return true;
+}
+
+/**
+ * @brief Free the slot and loop state arrays of a call stack entry
+ *
+ * The entry must not be active (its values already released).
+ */
+static void free_call_frame_storage(CallFrame *frame) {
+  free(frame->slots);
+  free(frame->range_loops);
+  free(frame->iterators);
+}
+
+/**
+ * @brief Double the call stack's capacity (at most max_call_depth frames)
+ *
+ * Moves the call stack and rebases current_frame; no other pointer to a
+ * frame may be held across a call that can grow it.
+ *
+ * @return false if out of memory
+ */
+static bool grow_call_stack(KronosVM *vm) {
+  size_t capacity = vm->call_stack_capacity ? vm->call_stack_capacity * 2
+                                            : CALL_STACK_INITIAL_CAPACITY;
+  if (capacity > vm->max_call_depth) {
+    capacity = vm->max_call_depth;
+  }
+  if (capacity <= vm->call_stack_capacity) {
+    return false;
+  }
+  size_t current =
+      vm->current_frame ? (size_t)(vm->current_frame - vm->call_stack) : 0;
+  CallFrame *frames = realloc(vm->call_stack, capacity * sizeof(CallFrame));
+  if (!frames) {
+    return false;
+  }
+  memset(frames + vm->call_stack_capacity, 0,
+         (capacity - vm->call_stack_capacity) * sizeof(CallFrame));
+  if (vm->current_frame) {
+    vm->current_frame = frames + current;
+  }
+  vm->call_stack = frames;
+  vm->call_stack_capacity = capacity;
+  return true;
+}
+
+/**
+ * @brief Double the value stack's capacity
+ *
+ * Moves the stack and rebases stack_top and every frame's frame_start.
+ * Handlers only hold pointers into the stack between pops, never across a
+ * push.
+ *
+ * @return false if out of memory
+ */
+static bool grow_stack(KronosVM *vm) {
+  size_t capacity =
+      vm->stack_capacity ? vm->stack_capacity * 2 : STACK_INITIAL_CAPACITY;
+  KronosValue **stack = malloc(capacity * sizeof(KronosValue *));
+  if (!stack) {
+    return false;
+  }
+  size_t size = (size_t)(vm->stack_top - vm->stack);
+  if (size > 0) {
+    memcpy(stack, vm->stack, size * sizeof(KronosValue *));
+  }
+  for (size_t i = 0; i < vm->call_stack_size; i++) {
+    CallFrame *frame = &vm->call_stack[i];
+    frame->frame_start = stack + (frame->frame_start - vm->stack);
+  }
+  free(vm->stack);
+  vm->stack = stack;
+  vm->stack_top = stack + size;
+  vm->stack_capacity = capacity;
+  return true;
+}
 
-  // Initialize local variable hash table to all NULL
-  for (size_t i = 0; i < LOCALS_MAX; i++) {
-    frame->local_hash[i] = NULL;
+/**
+ * @brief Check that one more frame fits on the call stack, growing it
+ *
+ * @return 0 if call_stack[call_stack_size] may be used, or an error set on
+ *         @p error_vm (the VM the failing call was made from)
+ */
+static int reserve_call_frame(KronosVM *vm, KronosVM *error_vm) {
+  if (vm->call_stack_size >= vm->max_call_depth) {
+    return vm_error(error_vm, KRONOS_ERR_RUNTIME,
+                    "Maximum call depth exceeded");
   }
+  if (vm->call_stack_size == vm->call_stack_capacity && !grow_call_stack(vm)) {
+    return vm_error(error_vm, KRONOS_ERR_INTERNAL,
+                    "Failed to grow the call stack");
+  }
+  return 0;
 }
 
-// Forward declaration for vm_execute (needed by call_module_function)
-int vm_execute(KronosVM *vm, Bytecode *bytecode);
+// Forward declarations (needed by call_module_function)
+static int vm_run(KronosVM *vm, Bytecode *bytecode);
+static int push(KronosVM *vm, KronosValue *value);
 
 /**
  * @brief Call a function in an external module
@@ -280,56 +455,54 @@ static int call_module_function(KronosVM *caller_vm, Module *mod,
                                 Function *mod_func, KronosValue **args,
                                 uint8_t arg_count) {
   KronosVM *module_vm = mod->module_vm;
+  // Each call into a module runs its VM recursively on the C stack
+  KronosVM *root_vm = caller_vm->root_vm_ref ? caller_vm->root_vm_ref
+                                             : caller_vm;
 
   // Check call stack depth
-  if (module_vm->call_stack_size >= CALL_STACK_MAX) {
+  int status = root_vm->module_call_depth >= MODULE_CALL_DEPTH_MAX
+                   ? vm_error(caller_vm, KRONOS_ERR_RUNTIME,
+                              "Maximum call depth exceeded in module")
+                   : reserve_call_frame(module_vm, caller_vm);
+  CallFrame *mod_frame = NULL;
+  if (status == 0) {
+    mod_frame = &module_vm->call_stack[module_vm->call_stack_size];
+    if (!init_call_frame_locals(mod_frame, mod_func)) {
+      status = vm_error(caller_vm, KRONOS_ERR_INTERNAL,
+                        "Failed to allocate function locals");
+    }
+  }
+  if (status != 0) {
     for (size_t i = 0; i < arg_count; i++) {
       value_release(args[i]);
     }
-    return vm_error(caller_vm, KRONOS_ERR_RUNTIME,
-                    "Maximum call depth exceeded in module");
+    return status;
   }
 
   // Create call frame in module VM
-  CallFrame *mod_frame = &module_vm->call_stack[module_vm->call_stack_size++];
+  size_t frame_index = module_vm->call_stack_size++;
   mod_frame->function = mod_func;
   mod_frame->return_ip = NULL;
   mod_frame->return_bytecode = NULL;
   mod_frame->frame_start = module_vm->stack_top;
-  mod_frame->local_count = 0;
-  // Initialize local variable hash table to all NULL
-  for (size_t i = 0; i < LOCALS_MAX; i++) {
-    mod_frame->local_hash[i] = NULL;
-  }
 
   // Set current_frame BEFORE setting locals
   module_vm->current_frame = mod_frame;
 
-  // Set parameters as local variables
+  // Bind parameters to their slots (the frame takes over our references)
   for (size_t i = 0; i < mod_func->param_count; i++) {
-    int status = vm_set_local(module_vm, mod_frame, mod_func->params[i],
-                              args[i], true, NULL);
-    value_release(args[i]); // Local now owns it
-
-    if (status != 0) {
-      // Release remaining arguments
-      for (size_t j = i + 1; j < mod_func->param_count; j++) {
-        value_release(args[j]);
-      }
-      // Clean up the frame
-      cleanup_call_frame_locals(mod_frame);
-      module_vm->call_stack_size--;
-      module_vm->current_frame = NULL;
-      return status;
-    }
+    mod_frame->slots[i] = args[i];
   }
 
   // Save module VM's execution state
   uint8_t *saved_mod_ip = module_vm->ip;
   Bytecode *saved_mod_bytecode = module_vm->bytecode;
 
-  // Execute function body
-  int exec_result = vm_execute(module_vm, &mod_func->bytecode);
+  // Execute function body (its calls may move the module's call stack)
+  root_vm->module_call_depth++;
+  int exec_result = vm_run(module_vm, &mod_func->bytecode);
+  root_vm->module_call_depth--;
+  mod_frame = &module_vm->call_stack[frame_index];
 
   if (exec_result < 0) {
     // Copy error to caller VM
@@ -373,15 +546,9 @@ static int call_module_function(KronosVM *caller_vm, Module *mod,
   module_vm->bytecode = saved_mod_bytecode;
 
   // Push return value to caller VM
-  if (caller_vm->stack_top >= caller_vm->stack + STACK_MAX) {
-    value_release(return_val);
-    return vm_error(caller_vm, KRONOS_ERR_RUNTIME, "Stack overflow");
-  }
-  *caller_vm->stack_top++ = return_val;
-  value_retain(return_val);
+  status = push(caller_vm, return_val);
   value_release(return_val);
-
-  return 0;
+  return status;
 }
 
 /**
@@ -559,7 +726,20 @@ static bool handle_exception_if_any(KronosVM *vm) {
 }
 
 // Forward declaration
-static size_t hash_global_name(const char *str);
+static int global_append(KronosVM *vm, const char *name, KronosValue *value,
+                         bool is_mutable, const char *type_name,
+                         size_t *out_index);
+
+// Source of call-site cache epochs and VM ids. Shared by all VMs so that a
+// Bytecode run by several VMs never sees another VM's entry as valid (0 is
+// never handed out, which keeps zeroed cache entries empty)
+static atomic_uint_least64_t call_epoch_counter = 1;
+
+static uint64_t next_call_epoch(void) {
+  return (uint64_t)atomic_fetch_add(&call_epoch_counter, 1);
+}
+
+static bool is_builtin_name(const char *name);
 
 /**
  * @brief Create a new virtual machine instance
@@ -570,12 +750,20 @@ static size_t hash_global_name(const char *str);
  * @return New VM instance, or NULL on allocation failure
  */
 KronosVM *vm_new(void) {
-  KronosVM *vm = malloc(sizeof(KronosVM));
+  KronosVM *vm = calloc(1, sizeof(KronosVM));
   if (!vm) {
     return NULL;
   }
 
-  vm->stack_top = vm->stack;
+  // The call stack is allocated by the first call
+  if (!grow_stack(vm)) {
+    free(vm);
+    return NULL;
+  }
+  vm->call_stack = NULL;
+  vm->call_stack_capacity = 0;
+  vm->max_call_depth = CALL_DEPTH_DEFAULT;
+  vm->module_call_depth = 0;
   vm->global_count = 0;
   vm->function_count = 0;
   vm->module_count = 0;
@@ -598,10 +786,20 @@ KronosVM *vm_new(void) {
     vm->function_hash[i] = NULL;
   }
 
-  // Initialize global variable hash table to all NULL
-  for (size_t i = 0; i < GLOBALS_MAX; i++) {
-    vm->global_hash[i] = NULL;
-  }
+  // Globals vector and name index are allocated on first insertion
+  vm->globals = NULL;
+  vm->global_capacity = 0;
+  vm->global_hash = NULL;
+  vm->global_hash_capacity = 0;
+
+  vm->id = next_call_epoch();
+  vm->call_epoch = next_call_epoch();
+  // The compiler must not inline a user function a built-in shadows
+  compiler_set_builtin_lookup(is_builtin_name);
+  vm->call_cache_hits = 0;
+  vm->call_cache_misses = 0;
+  vm->quickened = 0;
+  vm->dequickened = 0;
 
   // Initialize Pi constant - immutable
   // Note: double precision provides ~15-17 decimal digits of precision
@@ -612,52 +810,33 @@ KronosVM *vm_new(void) {
   KronosValue *pi_value = value_new_number(3.14159265358979323846);
 #endif
   if (!pi_value) {
-    free(vm);
+    vm_free(vm);
     return NULL;
   }
 
-  // Manually add Pi as immutable global
-  if (vm->global_count < GLOBALS_MAX) {
-    // Allocate into temporary pointers first
-    char *name_copy = strdup("Pi");
-    if (!name_copy) {
-      value_release(pi_value);
-      free(vm);
-      return NULL;
-    }
-
-    char *type_copy = strdup("number");
-    if (!type_copy) {
-      free(name_copy);
-      value_release(pi_value);
-      free(vm);
-      return NULL;
-    }
-
-    // Only assign to vm->globals after both allocations succeed
-    vm->globals[vm->global_count].name = name_copy;
-    vm->globals[vm->global_count].value = pi_value;
-    vm->globals[vm->global_count].is_mutable = false; // Immutable!
-    vm->globals[vm->global_count].type_name = type_copy;
-    // No value_retain needed - globals array owns the single reference
-
-    // Add to hash table for O(1) lookup (same as vm_set_global)
-    size_t hash_index = hash_global_name("Pi");
-    for (size_t i = 0; i < GLOBALS_MAX; i++) {
-      size_t idx = (hash_index + i) % GLOBALS_MAX;
-      if (!vm->global_hash[idx]) {
-        // Found empty slot
-        vm->global_hash[idx] = &vm->globals[vm->global_count];
-        break;
-      }
-    }
-
-    vm->global_count++;
+  // Add Pi as immutable global (slot 0)
+  if (global_append(vm, "Pi", pi_value, false, "number", NULL) != 0) {
+    value_release(pi_value);
+    vm_free(vm);
+    return NULL;
   }
+  value_release(pi_value); // globals vector holds its own reference
 
   return vm;
 }
 
+/**
+ * @brief Free the VM's private copy of top-level code (see vm_execute())
+ *
+ * The constant pool is shared with the caller's bytecode and not released.
+ */
+static void free_run_code(KronosVM *vm) {
+  free(vm->run_code.code);
+  free(vm->run_code.call_cache);
+  free(vm->run_code.global_names);
+  memset(&vm->run_code, 0, sizeof(vm->run_code));
+}
+
 /**
  * @brief Free a VM instance and all its resources
  *
@@ -677,22 +856,24 @@ void vm_free(KronosVM *vm) {
     value_release(*vm->stack_top);
   }
 
+  free(vm->stack);
+
   // Release call frames
   for (size_t i = 0; i < vm->call_stack_size; i++) {
-    CallFrame *frame = &vm->call_stack[i];
-    for (size_t j = 0; j < frame->local_count; j++) {
-      free(frame->locals[j].name);
-      value_release(frame->locals[j].value);
-      free(frame->locals[j].type_name);
-    }
+    cleanup_call_frame_locals(&vm->call_stack[i]);
   }
+  for (size_t i = 0; i < vm->call_stack_capacity; i++) {
+    free_call_frame_storage(&vm->call_stack[i]);
+  }
+  free(vm->call_stack);
+  free(vm->range_loops);
+  free_run_code(vm);
+  release_iterators(vm->iterators, &vm->live_iterators);
 
   // Release global variables
-  for (size_t i = 0; i < vm->global_count; i++) {
-    free(vm->globals[i].name);
-    value_release(vm->globals[i].value);
-    free(vm->globals[i].type_name);
-  }
+  vm_clear_globals(vm);
+  free(vm->globals);
+  free(vm->global_hash);
 
   // Release functions
   for (size_t i = 0; i < vm->function_count; i++) {
@@ -755,12 +936,20 @@ void function_free(Function *func) {
   }
   free(func->params);
 
+  for (size_t i = 0; i < func->slot_count; i++) {
+    free(func->slots[i].name);
+    free(func->slots[i].type_name);
+  }
+  free(func->slots);
+
   // Free bytecode structure
   free(func->bytecode.code);
   for (size_t i = 0; i < func->bytecode.const_count; i++) {
     value_release(func->bytecode.constants[i]);
   }
   free(func->bytecode.constants);
+  free(func->bytecode.call_cache);
+  free(func->bytecode.global_names);
 
   free(func);
 }
@@ -788,7 +977,7 @@ static size_t hash_function_name(const char *str) {
  * Simple djb2 hash algorithm for string hashing.
  *
  * @param str String to hash
- * @return Hash value (modulo GLOBALS_MAX)
+ * @return Unreduced hash value (callers mask by the table capacity)
  */
 static size_t hash_global_name(const char *str) {
   unsigned long hash = 5381;
@@ -796,24 +985,7 @@ static size_t hash_global_name(const char *str) {
   while ((c = *str++)) {
     hash = ((hash << 5) + hash) + c; // hash * 33 + c
   }
-  return hash % GLOBALS_MAX;
-}
-
-/**
- * @brief Hash function for variable names (locals)
- *
- * Simple djb2 hash algorithm for string hashing.
- *
- * @param str String to hash
- * @return Hash value (modulo LOCALS_MAX)
- */
-static size_t hash_local_name(const char *str) {
-  unsigned long hash = 5381;
-  int c;
-  while ((c = *str++)) {
-    hash = ((hash << 5) + hash) + c; // hash * 33 + c
-  }
-  return hash % LOCALS_MAX;
+  return (size_t)hash;
 }
 
 // Define a function
@@ -842,6 +1014,7 @@ int vm_define_function(KronosVM *vm, Function *func) {
       if (!vm->function_hash[idx]) {
         // Found empty slot
         vm->function_hash[idx] = func;
+        vm_invalidate_call_caches(vm);
         return 0;
       }
       // Check if function already exists (shouldn't happen, but be safe)
@@ -861,6 +1034,50 @@ int vm_define_function(KronosVM *vm, Function *func) {
   return 0;
 }
 
+int vm_set_max_call_depth(KronosVM *vm, size_t depth) {
+  if (!vm || depth == 0 || depth < vm->call_stack_size) {
+    return vm_error(vm, KRONOS_ERR_INVALID_ARGUMENT,
+                    "Call depth limit must be at least 1 and cover the "
+                    "frames in use");
+  }
+  vm->max_call_depth = depth;
+  for (size_t i = 0; i < vm->module_count; i++) {
+    if (vm->modules[i] && vm->modules[i]->module_vm) {
+      vm_set_max_call_depth(vm->modules[i]->module_vm, depth);
+    }
+  }
+  return 0;
+}
+
+void vm_invalidate_call_caches(KronosVM *vm) {
+  if (!vm) {
+    return;
+  }
+  vm->call_epoch = next_call_epoch();
+}
+
+void vm_call_cache_stats(const KronosVM *vm, VMCallCacheStats *stats) {
+  if (!vm || !stats) {
+    return;
+  }
+  stats->hits = vm->call_cache_hits;
+  stats->misses = vm->call_cache_misses;
+  uint64_t total = stats->hits + stats->misses;
+  stats->hit_rate = total > 0 ? (size_t)(stats->hits * 100 / total) : 0;
+}
+
+void vm_quicken_stats(const KronosVM *vm, VMQuickenStats *stats) {
+  if (!vm || !stats) {
+    return;
+  }
+  stats->quickened = vm->quickened;
+  stats->dequickened = vm->dequickened;
+  uint64_t stable =
+      vm->quickened > vm->dequickened ? vm->quickened - vm->dequickened : 0;
+  stats->stable_rate =
+      vm->quickened > 0 ? (size_t)(stable * 100 / vm->quickened) : 0;
+}
+
 // Get a function by name using hash table for O(1) lookup
 Function *vm_get_function(KronosVM *vm, const char *name) {
   if (!vm || !name) {
@@ -1113,6 +1330,7 @@ static int vm_load_module(KronosVM *vm, const char *module_name,
 
   // Set the module VM's root VM reference for circular import detection
   module_vm->root_vm_ref = root_vm;
+  module_vm->max_call_depth = root_vm->max_call_depth;
 
   // Set the module VM's current file path for relative imports
   module_vm->current_file_path = strdup(resolved_path);
@@ -1129,9 +1347,9 @@ static int vm_load_module(KronosVM *vm, const char *module_name,
 
   // Tokenize, parse, compile, and execute the module
   TokenArray *tokens = tokenize(source, NULL);
-  free(source);
 
   if (!tokens) {
+    free(source);
     vm_free(module_vm);
     free(resolved_path);
     // Remove from root VM's loading stack
@@ -1141,8 +1359,10 @@ static int vm_load_module(KronosVM *vm, const char *module_name,
     return vm_error(vm, KRONOS_ERR_TOKENIZE, "Failed to tokenize module");
   }
 
+  // Token texts are slices of source, so it must outlive parsing
   AST *ast = parse(tokens, NULL);
   token_array_free(tokens);
+  free(source);
 
   if (!ast) {
     vm_free(module_vm);
@@ -1257,7 +1477,8 @@ static int vm_load_module(KronosVM *vm, const char *module_name,
  * @return 0 on success, negative error code on failure
  */
 static int push(KronosVM *vm, KronosValue *value) {
-  if (vm->stack_top >= vm->stack + STACK_MAX) {
+  if (VM_UNLIKELY(vm->stack_top == vm->stack + vm->stack_capacity) &&
+      !grow_stack(vm)) {
     return vm_errorf(vm, KRONOS_ERR_RUNTIME,
                      "Stack overflow (too many nested operations or calls)");
   }
@@ -1391,54 +1612,99 @@ static KronosValue *peek(KronosVM *vm, int distance) {
 }
 
 /**
- * @brief Set or create a global variable
- *
- * Creates a new global variable or updates an existing mutable one.
- * Enforces immutability and type checking if type_name was specified.
+ * @brief Find a global's slot index by name
  *
  * @param vm VM instance
  * @param name Variable name
- * @param value Value to assign (will be retained by VM)
- * @param is_mutable Whether the variable can be reassigned
- * @param type_name Optional type annotation (e.g., "number", "string")
- * @return 0 on success, negative error code on failure
+ * @return Slot index into vm->globals, or SIZE_MAX if not defined
  */
-int vm_set_global(KronosVM *vm, const char *name, KronosValue *value,
-                  bool is_mutable, const char *type_name) {
-  if (!vm || !name || !value) {
-    return vm_error(vm, KRONOS_ERR_INVALID_ARGUMENT,
-                    "vm_set_global requires non-null inputs");
+static size_t global_find(const KronosVM *vm, const char *name) {
+  if (vm->global_hash_capacity == 0) {
+    return SIZE_MAX;
   }
 
-  // Check if variable already exists
-  for (size_t i = 0; i < vm->global_count; i++) {
-    if (strcmp(vm->globals[i].name, name) == 0) {
-      // Check if it's immutable
-      if (!vm->globals[i].is_mutable) {
-        return vm_errorf(vm, KRONOS_ERR_RUNTIME,
-                         "Cannot reassign immutable variable '%s'", name);
-      }
+  // The index is kept at most half full, so probing always reaches an
+  // empty entry
+  size_t mask = vm->global_hash_capacity - 1;
+  size_t idx = hash_global_name(name) & mask;
+  while (vm->global_hash[idx] != 0) {
+    size_t slot = vm->global_hash[idx] - 1;
+    if (strcmp(vm->globals[slot].name, name) == 0) {
+      return slot;
+    }
+    idx = (idx + 1) & mask;
+  }
+  return SIZE_MAX;
+}
 
-      // Check type if specified
-      if (vm->globals[i].type_name != NULL &&
-          !value_is_type(value, vm->globals[i].type_name)) {
-        return vm_errorf(vm, KRONOS_ERR_RUNTIME,
-                         "Type mismatch for variable '%s': expected '%s'", name,
-                         vm->globals[i].type_name);
-      }
+// Record slot in the name index (caller guarantees a free entry exists)
+static void global_hash_insert(KronosVM *vm, size_t slot) {
+  size_t mask = vm->global_hash_capacity - 1;
+  size_t idx = hash_global_name(vm->globals[slot].name) & mask;
+  while (vm->global_hash[idx] != 0) {
+    idx = (idx + 1) & mask;
+  }
+  vm->global_hash[idx] = slot + 1;
+}
 
-      value_release(vm->globals[i].value);
-      vm->globals[i].value = value;
-      value_retain(value);
-      return 0;
+/**
+ * @brief Ensure room for one more global
+ *
+ * Grows the globals vector geometrically and rebuilds the name index when it
+ * would exceed half load. Existing slot indices are preserved.
+ *
+ * @return 0 on success, negative error code on allocation failure
+ */
+static int global_reserve(KronosVM *vm) {
+  if (vm->global_count >= vm->global_capacity) {
+    size_t new_capacity = vm->global_capacity ? vm->global_capacity * 2
+                                              : GLOBALS_INITIAL_CAPACITY;
+    struct GlobalVar *grown =
+        realloc(vm->globals, new_capacity * sizeof(struct GlobalVar));
+    if (!grown) {
+      return vm_error(vm, KRONOS_ERR_INTERNAL,
+                      "Failed to grow global variable table");
     }
+    vm->globals = grown;
+    vm->global_capacity = new_capacity;
   }
 
-  // Add new global
-  if (vm->global_count >= GLOBALS_MAX) {
-    return vm_errorf(vm, KRONOS_ERR_RUNTIME,
-                     "Maximum number of global variables exceeded (%d allowed)",
-                     GLOBALS_MAX);
+  if ((vm->global_count + 1) * 2 > vm->global_hash_capacity) {
+    size_t new_capacity = vm->global_hash_capacity
+                              ? vm->global_hash_capacity * 2
+                              : GLOBALS_INITIAL_CAPACITY * 2;
+    size_t *table = calloc(new_capacity, sizeof(size_t));
+    if (!table) {
+      return vm_error(vm, KRONOS_ERR_INTERNAL,
+                      "Failed to grow global variable index");
+    }
+    free(vm->global_hash);
+    vm->global_hash = table;
+    vm->global_hash_capacity = new_capacity;
+    for (size_t i = 0; i < vm->global_count; i++) {
+      global_hash_insert(vm, i);
+    }
+  }
+  return 0;
+}
+
+/**
+ * @brief Append a new global variable
+ *
+ * @param vm VM instance
+ * @param name Variable name (copied)
+ * @param value Value to store (retained on success)
+ * @param is_mutable Whether the variable can be reassigned
+ * @param type_name Optional type annotation (copied), or NULL
+ * @param out_index Optional location for the new slot index
+ * @return 0 on success, negative error code on failure
+ */
+static int global_append(KronosVM *vm, const char *name, KronosValue *value,
+                         bool is_mutable, const char *type_name,
+                         size_t *out_index) {
+  int status = global_reserve(vm);
+  if (status != 0) {
+    return status;
   }
 
   // Allocate into temporary pointers first, check each for NULL
@@ -1459,183 +1725,178 @@ int vm_set_global(KronosVM *vm, const char *name, KronosValue *value,
     }
   }
 
-  // Call value_retain before modifying vm->globals
   value_retain(value);
 
   // Only assign to vm->globals after all allocations succeed
-  vm->globals[vm->global_count].name = name_copy;
-  vm->globals[vm->global_count].value = value;
-  vm->globals[vm->global_count].is_mutable = is_mutable;
-  vm->globals[vm->global_count].type_name = type_copy;
+  size_t slot = vm->global_count;
+  vm->globals[slot].name = name_copy;
+  vm->globals[slot].value = value;
+  vm->globals[slot].is_mutable = is_mutable;
+  vm->globals[slot].type_name = type_copy;
+  global_hash_insert(vm, slot);
+  vm->global_count++;
 
-  // Add to hash table for O(1) lookup
-  size_t hash_index = hash_global_name(name);
-  for (size_t i = 0; i < GLOBALS_MAX; i++) {
-    size_t idx = (hash_index + i) % GLOBALS_MAX;
-    if (!vm->global_hash[idx]) {
-      // Found empty slot
-      vm->global_hash[idx] = &vm->globals[vm->global_count];
-      break;
-    }
+  if (out_index) {
+    *out_index = slot;
   }
+  return 0;
+}
 
-  // Only increment global_count after everything succeeds
-  vm->global_count++;
+/**
+ * @brief Reassign an existing global by slot index
+ *
+ * Enforces the immutability and type annotation recorded when the global
+ * was first defined.
+ *
+ * @return 0 on success, negative error code on failure
+ */
+static int global_assign(KronosVM *vm, size_t slot, KronosValue *value) {
+  struct GlobalVar *global = &vm->globals[slot];
+
+  if (!global->is_mutable) {
+    return vm_errorf(vm, KRONOS_ERR_RUNTIME,
+                     "Cannot reassign immutable variable '%s'", global->name);
+  }
+
+  if (global->type_name != NULL && !value_is_type(value, global->type_name)) {
+    return vm_errorf(vm, KRONOS_ERR_RUNTIME,
+                     "Type mismatch for variable '%s': expected '%s'",
+                     global->name, global->type_name);
+  }
+
+  value_retain(value);
+  value_release(global->value);
+  global->value = value;
   return 0;
 }
 
+/**
+ * @brief Set or create a global variable
+ *
+ * Creates a new global variable or updates an existing mutable one.
+ * Enforces immutability and type checking if type_name was specified.
+ *
+ * @param vm VM instance
+ * @param name Variable name
+ * @param value Value to assign (will be retained by VM)
+ * @param is_mutable Whether the variable can be reassigned
+ * @param type_name Optional type annotation (e.g., "number", "string")
+ * @return 0 on success, negative error code on failure
+ */
+int vm_set_global(KronosVM *vm, const char *name, KronosValue *value,
+                  bool is_mutable, const char *type_name) {
+  if (!vm || !name || !value) {
+    return vm_error(vm, KRONOS_ERR_INVALID_ARGUMENT,
+                    "vm_set_global requires non-null inputs");
+  }
+
+  size_t slot = global_find(vm, name);
+  if (slot != SIZE_MAX) {
+    return global_assign(vm, slot, value);
+  }
+  return global_append(vm, name, value, is_mutable, type_name, NULL);
+}
+
 KronosValue *vm_get_global(KronosVM *vm, const char *name) {
   if (!vm || !name) {
     return NULL;
   }
 
-  // Use hash table for O(1) lookup
-  size_t index = hash_global_name(name);
-  for (size_t i = 0; i < GLOBALS_MAX; i++) {
-    size_t idx = (index + i) % GLOBALS_MAX;
-    struct GlobalVar *global = vm->global_hash[idx];
+  size_t slot = global_find(vm, name);
+  return slot != SIZE_MAX ? vm->globals[slot].value : NULL;
+}
 
-    // Empty slot means variable not found
-    if (!global) {
-      return NULL;
-    }
+void vm_clear_globals(KronosVM *vm) {
+  if (!vm) {
+    return;
+  }
 
-    // Check if this is the variable we're looking for
-    if (global->name && strcmp(global->name, name) == 0) {
-      return global->value;
-    }
+  for (size_t i = 0; i < vm->global_count; i++) {
+    free(vm->globals[i].name);
+    value_release(vm->globals[i].value);
+    free(vm->globals[i].type_name);
   }
+  vm->global_count = 0;
 
-  // Hash table full (shouldn't happen if GLOBALS_MAX is respected)
-  return NULL;
+  if (vm->global_hash) {
+    memset(vm->global_hash, 0, vm->global_hash_capacity * sizeof(size_t));
+  }
 }
 
-// Set local variable in current frame
-int vm_set_local(KronosVM *vm, CallFrame *frame, const char *name,
-                 KronosValue *value, bool is_mutable, const char *type_name) {
-  if (!vm || !frame || !name || !value)
-    return vm_error(vm, KRONOS_ERR_INVALID_ARGUMENT,
-                    "vm_set_local requires non-null inputs");
+/**
+ * @brief Name of a local slot for diagnostics
+ *
+ * Falls back to the parameter list for functions built without a slot
+ * descriptor table.
+ */
+static const char *local_slot_name(const Function *func, size_t slot) {
+  if (slot < func->slot_count && func->slots[slot].name) {
+    return func->slots[slot].name;
+  }
+  if (slot < func->param_count) {
+    return func->params[slot];
+  }
+  return "<unknown>";
+}
 
-  // Check if variable already exists using hash table
-  size_t index = hash_local_name(name);
-  for (size_t i = 0; i < LOCALS_MAX; i++) {
-    size_t idx = (index + i) % LOCALS_MAX;
-    struct LocalVar *local = frame->local_hash[idx];
+// Set local variable slot in a call frame
+int vm_set_local(KronosVM *vm, CallFrame *frame, size_t slot,
+                 KronosValue *value) {
+  if (!vm || !frame || !frame->function || !value)
+    return vm_error(vm, KRONOS_ERR_INVALID_ARGUMENT,
+                    "vm_set_local requires non-null inputs");
 
-    if (!local) {
-      // Empty slot - variable doesn't exist, will add new one below
-      break;
-    }
+  if (slot >= frame->slot_count) {
+    return vm_errorf(vm, KRONOS_ERR_INTERNAL,
+                     "Local slot out of range: %zu (function has %zu)", slot,
+                     frame->slot_count);
+  }
 
-    if (local->name && strcmp(local->name, name) == 0) {
-      // Found existing variable
-      // Check if it's immutable
-      if (!local->is_mutable) {
+  KronosValue *current = frame->slots[slot];
+  if (current) {
+    // Reassignment: enforce the declaration's constraints
+    const Function *func = frame->function;
+    if (slot < func->slot_count) {
+      const LocalSlot *desc = &func->slots[slot];
+      if (!desc->is_mutable) {
         return vm_errorf(vm, KRONOS_ERR_RUNTIME,
-                         "Cannot reassign immutable local variable '%s'", name);
+                         "Cannot reassign immutable local variable '%s'",
+                         desc->name);
       }
-
-      // Check type if specified
-      if (local->type_name != NULL && !value_is_type(value, local->type_name)) {
+      if (desc->type_name != NULL && !value_is_type(value, desc->type_name)) {
         return vm_errorf(vm, KRONOS_ERR_RUNTIME,
                          "Type mismatch for local variable '%s': expected '%s'",
-                         name, local->type_name);
+                         desc->name, desc->type_name);
       }
-
-      value_release(local->value);
-      local->value = value;
-      value_retain(value);
-      return 0;
-    }
-  }
-
-  // Add new local variable
-  if (frame->local_count >= LOCALS_MAX) {
-    return vm_errorf(vm, KRONOS_ERR_RUNTIME,
-                     "Maximum number of local variables exceeded (%d allowed)",
-                     LOCALS_MAX);
-  }
-
-  // Allocate into temporary pointers first, check each for NULL
-  char *name_copy = strdup(name);
-  if (!name_copy) {
-    // Allocation failure: return error without modifying frame state
-    // Note: Do NOT release value here - caller still owns it
-    return vm_error(vm, KRONOS_ERR_INTERNAL,
-                    "Failed to allocate memory for local name");
-  }
-
-  char *type_copy = NULL;
-  if (type_name) {
-    type_copy = strdup(type_name);
-    if (!type_copy) {
-      // Allocation failure: free already-allocated name_copy and return error
-      // Note: Do NOT release value here - caller still owns it
-      free(name_copy);
-      return vm_error(vm, KRONOS_ERR_INTERNAL,
-                      "Failed to allocate memory for local type");
-    }
-  }
-
-  // Only assign to frame->locals[...] after all allocations succeed
-  frame->locals[frame->local_count].name = name_copy;
-  frame->locals[frame->local_count].value = value;
-  frame->locals[frame->local_count].is_mutable = is_mutable;
-  frame->locals[frame->local_count].type_name = type_copy;
-
-  // Add to hash table for O(1) lookup
-  size_t hash_index = hash_local_name(name);
-  for (size_t i = 0; i < LOCALS_MAX; i++) {
-    size_t idx = (hash_index + i) % LOCALS_MAX;
-    if (!frame->local_hash[idx]) {
-      // Found empty slot
-      frame->local_hash[idx] = &frame->locals[frame->local_count];
-      break;
     }
+    value_release(current);
   }
 
-  // Only call value_retain after all allocations and assignments succeed
   value_retain(value);
-  // Only increment frame->local_count after everything succeeds
-  frame->local_count++;
+  frame->slots[slot] = value;
   return 0;
 }
 
-// Get local variable from current frame using hash table for O(1) lookup
-KronosValue *vm_get_local(CallFrame *frame, const char *name) {
-  if (!frame || !name) {
+// Get local variable slot from a call frame
+KronosValue *vm_get_local(CallFrame *frame, size_t slot) {
+  if (!frame || slot >= frame->slot_count) {
     return NULL;
   }
-
-  // Use hash table for O(1) lookup
-  size_t index = hash_local_name(name);
-  for (size_t i = 0; i < LOCALS_MAX; i++) {
-    size_t idx = (index + i) % LOCALS_MAX;
-    struct LocalVar *local = frame->local_hash[idx];
-
-    // Empty slot means variable not found
-    if (!local) {
-      return NULL;
-    }
-
-    // Check if this is the variable we're looking for
-    if (local->name && strcmp(local->name, name) == 0) {
-      return local->value;
-    }
-  }
-
-  // Hash table full (shouldn't happen if LOCALS_MAX is respected)
-  return NULL;
+  return frame->slots[slot];
 }
 
 // Get variable (try local first, then global)
 KronosValue *vm_get_variable(KronosVM *vm, const char *name) {
-  // Try local variables if in function
-  if (vm->current_frame) {
-    KronosValue *local = vm_get_local(vm->current_frame, name);
-    if (local)
-      return local;
+  // Try local variables if in function (name lookup via slot descriptors;
+  // compiled code addresses locals by slot and never takes this path)
+  if (vm->current_frame && vm->current_frame->function) {
+    CallFrame *frame = vm->current_frame;
+    for (size_t i = frame->slot_count; i > 0; i--) {
+      if (frame->slots[i - 1] &&
+          strcmp(local_slot_name(frame->function, i - 1), name) == 0) {
+        return frame->slots[i - 1];
+      }
+    }
   }
 
   // Try global variables
@@ -1647,8 +1908,13 @@ KronosValue *vm_get_variable(KronosVM *vm, const char *name) {
   return NULL;
 }
 
-// Read byte from bytecode
-static uint8_t read_byte(KronosVM *vm) {
+// Operand decoding. Bytecode that passed bytecode_verify() has every operand
+// inside the code buffer and every constant index inside the pool, so reads
+// are plain loads; unverified bytecode takes the bounds-checked path, which
+// reports malformed code through vm->last_error_message.
+
+// Read byte from bytecode (checked)
+static uint8_t read_byte_checked(KronosVM *vm) {
   // Compute current offset and compare against bytecode count
   size_t offset = vm->ip - vm->bytecode->code;
   if (offset >= vm->bytecode->count) {
@@ -1664,14 +1930,14 @@ static uint8_t read_byte(KronosVM *vm) {
   return *vm->ip++;
 }
 
-// Read 16-bit value (big-endian)
-static uint16_t read_uint16(KronosVM *vm) {
-  uint16_t high = read_byte(vm);
+// Read 16-bit value (big-endian, checked)
+static uint16_t read_uint16_checked(KronosVM *vm) {
+  uint16_t high = read_byte_checked(vm);
   // Check for error after first read_byte
   if (vm->last_error_message) {
     return 0; // Return 0 on error (caller should check error state)
   }
-  uint16_t low = read_byte(vm);
+  uint16_t low = read_byte_checked(vm);
   // Check for error after second read_byte
   if (vm->last_error_message) {
     return 0; // Return 0 on error (caller should check error state)
@@ -1679,26 +1945,70 @@ static uint16_t read_uint16(KronosVM *vm) {
   return (high << 8) | low;
 }
 
-static int16_t read_int16(KronosVM *vm) {
-  uint16_t high = read_byte(vm);
-  // Check for error after first read_byte
+static inline uint8_t read_byte(KronosVM *vm) {
+  if (vm->bytecode->verified) {
+    return *vm->ip++;
+  }
+  return read_byte_checked(vm);
+}
+
+static inline uint16_t read_uint16(KronosVM *vm) {
+  if (vm->bytecode->verified) {
+    uint16_t value = (uint16_t)(vm->ip[0] << 8 | vm->ip[1]);
+    vm->ip += 2;
+    return value;
+  }
+  return read_uint16_checked(vm);
+}
+
+static inline int16_t read_int16(KronosVM *vm) {
+  // Sign extend from 16-bit to int16_t
+  return (int16_t)read_uint16(vm);
+}
+
+// Read 32-bit value (big-endian, checked)
+static uint32_t read_uint32_checked(KronosVM *vm) {
+  uint32_t high = read_uint16_checked(vm);
   if (vm->last_error_message) {
-    return 0; // Return 0 on error (caller should check error state)
+    return 0;
   }
-  uint16_t low = read_byte(vm);
-  // Check for error after second read_byte
+  uint32_t low = read_uint16_checked(vm);
   if (vm->last_error_message) {
-    return 0; // Return 0 on error (caller should check error state)
+    return 0;
   }
-  uint16_t unsigned_val = (high << 8) | low;
-  // Sign extend from 16-bit to int16_t
-  return (int16_t)unsigned_val;
+  return (high << 16) | low;
+}
+
+static inline uint32_t read_uint32(KronosVM *vm) {
+  if (vm->bytecode->verified) {
+    uint32_t value = (uint32_t)vm->ip[0] << 24 | (uint32_t)vm->ip[1] << 16 |
+                     (uint32_t)vm->ip[2] << 8 | vm->ip[3];
+    vm->ip += 4;
+    return value;
+  }
+  return read_uint32_checked(vm);
+}
+
+// Constant index, global slot or jump offset operand: 32-bit in an
+// instruction prefixed with OP_WIDE, else 16-bit
+static inline uint32_t read_operand(KronosVM *vm, bool wide) {
+  return wide ? read_uint32(vm) : read_uint16(vm);
+}
+
+// Signed jump offset operand
+static inline int32_t read_offset(KronosVM *vm, bool wide) {
+  return wide ? (int32_t)read_uint32(vm) : read_int16(vm);
+}
+
+// Marker of an absent optional constant operand
+static inline uint32_t no_constant(bool wide) {
+  return wide ? NO_CONSTANT_WIDE : NO_CONSTANT_NARROW;
 }
 
 // Read constant from pool
-static KronosValue *read_constant(KronosVM *vm) {
-  uint16_t idx = read_uint16(vm);
-  // Check for error from read_uint16 (which calls read_byte twice)
+static KronosValue *read_constant_checked(KronosVM *vm, bool wide) {
+  uint32_t idx = wide ? read_uint32_checked(vm) : read_uint16_checked(vm);
+  // Check for error from the operand read
   if (vm->last_error_message) {
     return NULL; // Error already set by read_byte
   }
@@ -1713,6 +2023,13 @@ static KronosValue *read_constant(KronosVM *vm) {
   return vm->bytecode->constants[idx];
 }
 
+static inline KronosValue *read_constant(KronosVM *vm, bool wide) {
+  if (vm->bytecode->verified) {
+    return vm->bytecode->constants[read_operand(vm, wide)];
+  }
+  return read_constant_checked(vm, wide);
+}
+
 // Opcode handler function type
 // Returns 0 on success, negative error code on failure
 typedef int (*OpcodeHandler)(KronosVM *vm);
@@ -1726,6 +2043,13 @@ typedef int (*BuiltinHandler)(KronosVM *vm, uint8_t arg_count);
 static int handle_op_load_const(KronosVM *vm);
 static int handle_op_load_var(KronosVM *vm);
 static int handle_op_store_var(KronosVM *vm);
+static int handle_op_load_local(KronosVM *vm);
+static int handle_op_store_local(KronosVM *vm);
+static int handle_op_load_global(KronosVM *vm);
+static int handle_op_store_global(KronosVM *vm);
+static int handle_op_inc_local_const(KronosVM *vm);
+static int handle_op_inc_var_const(KronosVM *vm);
+static int handle_op_inc_global_const(KronosVM *vm);
 static int handle_op_print(KronosVM *vm);
 static int handle_op_add(KronosVM *vm);
 static int handle_op_sub(KronosVM *vm);
@@ -1744,6 +2068,19 @@ static int handle_op_or(KronosVM *vm);
 static int handle_op_not(KronosVM *vm);
 static int handle_op_jump(KronosVM *vm);
 static int handle_op_jump_if_false(KronosVM *vm);
+static int handle_op_cmp_jump_if_false(KronosVM *vm);
+static int handle_op_add_num(KronosVM *vm);
+static int handle_op_sub_num(KronosVM *vm);
+static int handle_op_mul_num(KronosVM *vm);
+static int handle_op_gt_num(KronosVM *vm);
+static int handle_op_lt_num(KronosVM *vm);
+static int handle_op_gte_num(KronosVM *vm);
+static int handle_op_lte_num(KronosVM *vm);
+static int handle_op_cmp_jump_if_false_num(KronosVM *vm);
+static int handle_op_index_list(KronosVM *vm);
+static int handle_op_concat_str(KronosVM *vm);
+static int handle_op_for_range_prep(KronosVM *vm);
+static int handle_op_for_range_next(KronosVM *vm);
 static int handle_op_define_func(KronosVM *vm);
 static int handle_op_call_func(KronosVM *vm);
 static int handle_op_return_val(KronosVM *vm);
@@ -1763,10 +2100,11 @@ static int handle_op_finally(KronosVM *vm);
 static int handle_op_throw(KronosVM *vm);
 static int handle_op_list_len(KronosVM *vm);
 static int handle_op_list_slice(KronosVM *vm);
-static int handle_op_list_iter(KronosVM *vm);
-static int handle_op_list_next(KronosVM *vm);
+static int handle_op_iter_prep(KronosVM *vm);
+static int handle_op_iter_next(KronosVM *vm);
+static int handle_op_iter_close(KronosVM *vm);
 static int handle_op_import(KronosVM *vm);
-static int handle_op_halt(KronosVM *vm);
+static int handle_op_wide(KronosVM *vm);
 
 // Forward declarations for built-in function handlers
 static int builtin_read_file(KronosVM *vm, uint8_t arg_count);
@@ -1812,45 +2150,47 @@ static int builtin_regex_findall(KronosVM *vm, uint8_t arg_count);
 // Helper function to convert a value to a string representation
 // Returns a newly allocated string that the caller must free
 static char *value_to_string_repr(const KronosValue *val) {
-  if (val->type == VAL_STRING) {
+  if (value_type(val) == VAL_STRING) {
     char *str = malloc(val->as.string.length + 1);
     if (!str)
       return NULL;
     memcpy(str, val->as.string.data, val->as.string.length);
     str[val->as.string.length] = '\0';
     return str;
-  } else if (val->type == VAL_NUMBER) {
+  } else if (value_is_number(val)) {
     char *str_buf = malloc(NUMBER_STRING_BUFFER_SIZE);
     if (!str_buf)
       return NULL;
     double intpart;
-    double frac = modf(val->as.number, &intpart);
+    double frac = modf(value_as_number(val), &intpart);
     size_t len;
     // Use scientific notation for large numbers to prevent buffer overflow
     // (buffer is NUMBER_STRING_BUFFER_SIZE bytes)
 
-    if (frac == 0.0 && fabs(val->as.number) < 1.0e15) {
+    if (frac == 0.0 && fabs(value_as_number(val)) < 1.0e15) {
 
       len = (size_t)snprintf(str_buf, NUMBER_STRING_BUFFER_SIZE, "%.0f",
-                             val->as.number);
+                             value_as_number(val));
     } else {
       len = (size_t)snprintf(str_buf, NUMBER_STRING_BUFFER_SIZE, "%g",
-                             val->as.number);
+                             value_as_number(val));
     }
     // Reallocate to exact size
     char *result = realloc(str_buf, len + 1);
     return result ? result : str_buf;
-  } else if (val->type == VAL_BOOL) {
+  } else if (value_type(val) == VAL_BOOL) {
     return strdup(val->as.boolean ? "true" : "false");
-  } else if (val->type == VAL_NIL) {
+  } else if (value_type(val) == VAL_NIL) {
     return strdup("null");
   }
   return strdup(""); // Unknown type
 }
 
-// Opcode handler implementations
-static int handle_op_load_const(KronosVM *vm) {
-  KronosValue *constant = read_constant(vm);
+// Opcode handler implementations. Opcodes with constant, global slot or jump
+// operands have an exec_* body taking the operand width, shared by their
+// handler (16-bit) and handle_op_wide() (32-bit).
+static VM_ALWAYS_INLINE int exec_load_const(KronosVM *vm, bool wide) {
+  KronosValue *constant = read_constant(vm, wide);
   if (!constant) {
     return vm_propagate_error(vm, KRONOS_ERR_INTERNAL);
   }
@@ -1858,16 +2198,150 @@ static int handle_op_load_const(KronosVM *vm) {
   return 0;
 }
 
-static int handle_op_load_var(KronosVM *vm) {
-  KronosValue *name_val = read_constant(vm);
-  if (!name_val) {
-    return vm_propagate_error(vm, KRONOS_ERR_INTERNAL);
+static int handle_op_load_const(KronosVM *vm) {
+  return exec_load_const(vm, false);
+}
+
+/**
+ * @brief Whether the current call frame declares a local with this name
+ *
+ * Such names must keep resolving by name (frame first), so their LOAD_VAR
+ * sites are never specialized to a global slot.
+ */
+static bool frame_declares_name(const CallFrame *frame, const char *name) {
+  if (!frame || !frame->function) {
+    return false;
+  }
+  for (size_t i = 0; i < frame->slot_count; i++) {
+    if (strcmp(local_slot_name(frame->function, i), name) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Remember that @p slot of the owning VM is the global named by
+ * constant @p name_index
+ *
+ * @return false on allocation failure
+ */
+static bool record_global_name(Bytecode *bytecode, size_t slot,
+                               uint32_t name_index) {
+  if (slot >= bytecode->global_name_capacity) {
+    size_t capacity =
+        bytecode->global_name_capacity ? bytecode->global_name_capacity : 8;
+    while (capacity <= slot) {
+      capacity *= 2;
+    }
+    uint32_t *names =
+        realloc(bytecode->global_names, capacity * sizeof(uint32_t));
+    if (!names) {
+      return false;
+    }
+    bytecode->global_names = names;
+    bytecode->global_name_capacity = capacity;
+  }
+  bytecode->global_names[slot] = name_index;
+  return true;
+}
+
+/**
+ * @brief Specialize a named global access to its slot index
+ *
+ * Overwrites the opcode at @p site and its name operand (2 bytes, or 4 in a
+ * wide instruction) with @p opcode and the global's slot index, so later
+ * executions of the site skip the name lookup. Bytecode is claimed by the
+ * first VM that rewrites it; sites are left untouched for other VMs or
+ * indices that do not fit the operand. The name constant is kept in
+ * Bytecode.global_names so other VMs can still resolve the site by name.
+ */
+static void rewrite_global_site(KronosVM *vm, uint8_t *site, uint8_t opcode,
+                                size_t slot, bool wide) {
+  Bytecode *bytecode = vm->bytecode;
+  if (slot > (wide ? UINT32_MAX : UINT16_MAX) ||
+      (bytecode->global_owner && bytecode->global_owner != vm->id)) {
+    return;
   }
-  if (name_val->type != VAL_STRING) {
+  uint32_t name_index =
+      wide ? ((uint32_t)site[1] << 24) | ((uint32_t)site[2] << 16) |
+                 ((uint32_t)site[3] << 8) | site[4]
+           : ((uint32_t)site[1] << 8) | site[2];
+  if (!record_global_name(bytecode, slot, name_index)) {
+    return; // Stay on the named path
+  }
+  bytecode->global_owner = vm->id;
+  *site++ = opcode;
+  if (wide) {
+    *site++ = (uint8_t)(slot >> 24);
+    *site++ = (uint8_t)((slot >> 16) & 0xFF);
+  }
+  site[0] = (uint8_t)((slot >> 8) & 0xFF);
+  site[1] = (uint8_t)(slot & 0xFF);
+}
+
+/**
+ * @brief Read and validate the slot operand of a global slot instruction
+ *
+ * Slot operands are indices into the globals of the VM that rewrote the
+ * code. Any other VM gets the global's name constant in *@p name_out and
+ * resolves the access by name, like the instruction the site was rewritten
+ * from.
+ *
+ * @return Slot index; or SIZE_MAX with *@p name_out set, or with an error set
+ */
+static size_t read_global_slot(KronosVM *vm, bool wide,
+                               KronosValue **name_out) {
+  *name_out = NULL;
+  uint32_t slot = read_operand(vm, wide);
+  if (vm->last_error_message) {
+    return SIZE_MAX;
+  }
+  const Bytecode *bytecode = vm->bytecode;
+  if (bytecode->global_owner != vm->id) {
+    if (slot >= bytecode->global_name_capacity ||
+        bytecode->global_names[slot] >= bytecode->const_count) {
+      vm_set_errorf(vm, KRONOS_ERR_INTERNAL,
+                    "Global slot %u has no recorded name", slot);
+      return SIZE_MAX;
+    }
+    *name_out = bytecode->constants[bytecode->global_names[slot]];
+    return SIZE_MAX;
+  }
+  if (slot >= vm->global_count) {
+    vm_set_errorf(vm, KRONOS_ERR_INTERNAL, "Global slot out of range: %u",
+                  slot);
+    return SIZE_MAX;
+  }
+  return slot;
+}
+
+/**
+ * @brief Load the variable named by @p name_val (OP_LOAD_VAR semantics)
+ *
+ * Rewrites @p site to OP_LOAD_GLOBAL when it names a global (NULL: never).
+ */
+static int load_named_variable(KronosVM *vm, uint8_t *site,
+                               KronosValue *name_val, bool wide) {
+  if (value_type(name_val) != VAL_STRING) {
     return vm_error(vm, KRONOS_ERR_INTERNAL,
                     "Variable name constant is not a string");
   }
-  KronosValue *value = vm_get_variable(vm, name_val->as.string.data);
+  const char *name = name_val->as.string.data;
+
+  // Globals are rewritten to OP_LOAD_GLOBAL on first use
+  if (!frame_declares_name(vm->current_frame, name)) {
+    size_t slot = global_find(vm, name);
+    if (slot != SIZE_MAX) {
+      if (site) {
+        rewrite_global_site(vm, site, OP_LOAD_GLOBAL, slot, wide);
+      }
+      PUSH_OR_RETURN_WITH_CLEANUP(vm, vm->globals[slot].value, (void)0);
+      return 0;
+    }
+  }
+
+  KronosValue *value = vm_get_variable(vm, name);
   if (!value) {
     return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
   }
@@ -1875,12 +2349,28 @@ static int handle_op_load_var(KronosVM *vm) {
   return 0;
 }
 
-static int handle_op_store_var(KronosVM *vm) {
-  KronosValue *name_val = read_constant(vm);
+static VM_ALWAYS_INLINE int exec_load_var(KronosVM *vm, bool wide) {
+  uint8_t *site = vm->ip - 1;
+  KronosValue *name_val = read_constant(vm, wide);
   if (!name_val) {
     return vm_propagate_error(vm, KRONOS_ERR_INTERNAL);
   }
-  if (name_val->type != VAL_STRING) {
+  return load_named_variable(vm, site, name_val, wide);
+}
+
+static int handle_op_load_var(KronosVM *vm) {
+  return exec_load_var(vm, false);
+}
+
+/**
+ * @brief Store to the global named by @p name_val (OP_STORE_VAR semantics)
+ *
+ * Reads the declaration operands that follow the name. Rewrites @p site to
+ * OP_STORE_GLOBAL once the global exists (NULL: never).
+ */
+static int store_named_variable(KronosVM *vm, uint8_t *site,
+                                KronosValue *name_val, bool wide) {
+  if (value_type(name_val) != VAL_STRING) {
     return vm_error(vm, KRONOS_ERR_INTERNAL,
                     "Variable name constant is not a string");
   }
@@ -1895,12 +2385,12 @@ static int handle_op_store_var(KronosVM *vm) {
   uint8_t has_type = read_byte(vm);
   const char *type_name = NULL;
   if (has_type) {
-    KronosValue *type_val = read_constant(vm);
+    KronosValue *type_val = read_constant(vm, wide);
     if (!type_val) {
       value_release(value);
       return vm_propagate_error(vm, KRONOS_ERR_INTERNAL);
     }
-    if (type_val->type != VAL_STRING) {
+    if (value_type(type_val) != VAL_STRING) {
       value_release(value);
       return vm_error(vm, KRONOS_ERR_INTERNAL,
                       "Type name constant is not a string");
@@ -1908,100 +2398,524 @@ static int handle_op_store_var(KronosVM *vm) {
     type_name = type_val->as.string.data;
   }
 
-  // If in function, set as local variable; otherwise, set as global
-  int store_status;
-  if (vm->current_frame) {
-    store_status = vm_set_local(vm, vm->current_frame, name_val->as.string.data,
-                                value, is_mutable, type_name);
-  } else {
-    store_status = vm_set_global(vm, name_val->as.string.data, value,
-                                 is_mutable, type_name);
+  // Function locals are compiled to OP_STORE_LOCAL, so named stores always
+  // target globals
+  int store_status = vm_set_global(vm, name_val->as.string.data, value,
+                                   is_mutable, type_name);
+
+  value_release(value); // Release our reference
+  if (store_status != 0) {
+    return store_status;
+  }
+
+  // The global now exists; later executions of this site store by slot.
+  // Mutability/type operands stay in place and are skipped by the handler.
+  size_t slot = site ? global_find(vm, name_val->as.string.data) : SIZE_MAX;
+  if (slot != SIZE_MAX) {
+    rewrite_global_site(vm, site, OP_STORE_GLOBAL, slot, wide);
+  }
+  return 0;
+}
+
+static VM_ALWAYS_INLINE int exec_store_var(KronosVM *vm, bool wide) {
+  uint8_t *site = vm->ip - 1;
+  KronosValue *name_val = read_constant(vm, wide);
+  if (!name_val) {
+    return vm_propagate_error(vm, KRONOS_ERR_INTERNAL);
+  }
+  return store_named_variable(vm, site, name_val, wide);
+}
+
+static int handle_op_store_var(KronosVM *vm) {
+  return exec_store_var(vm, false);
+}
+
+static VM_ALWAYS_INLINE int exec_load_global(KronosVM *vm, bool wide) {
+  KronosValue *name_val;
+  size_t slot = read_global_slot(vm, wide, &name_val);
+  if (slot == SIZE_MAX) {
+    return name_val ? load_named_variable(vm, NULL, name_val, wide)
+                    : vm_propagate_error(vm, KRONOS_ERR_INTERNAL);
+  }
+  PUSH_OR_RETURN_WITH_CLEANUP(vm, vm->globals[slot].value, (void)0);
+  return 0;
+}
+
+static int handle_op_load_global(KronosVM *vm) {
+  return exec_load_global(vm, false);
+}
+
+static VM_ALWAYS_INLINE int exec_store_global(KronosVM *vm, bool wide) {
+  KronosValue *name_val;
+  size_t slot = read_global_slot(vm, wide, &name_val);
+  if (slot == SIZE_MAX) {
+    return name_val ? store_named_variable(vm, NULL, name_val, wide)
+                    : vm_propagate_error(vm, KRONOS_ERR_INTERNAL);
+  }
+
+  // Skip the declaration operands kept from OP_STORE_VAR; the global's
+  // mutability and type were fixed when it was first stored
+  (void)read_byte(vm);
+  uint8_t has_type = read_byte(vm);
+  if (has_type) {
+    (void)read_operand(vm, wide);
+  }
+  if (vm->last_error_message) {
+    return vm_propagate_error(vm, KRONOS_ERR_INTERNAL);
+  }
+
+  KronosValue *value;
+  POP_OR_RETURN(vm, value);
+
+  int store_status = global_assign(vm, slot, value);
+  value_release(value); // Release our reference
+  return store_status;
+}
+
+static int handle_op_store_global(KronosVM *vm) {
+  return exec_store_global(vm, false);
+}
+
+/**
+ * @brief Current value of local @p slot with OP_LOAD_LOCAL semantics
+ *
+ * @return Borrowed value, or NULL with an error set
+ */
+static KronosValue *load_local_slot(KronosVM *vm, uint8_t slot) {
+  CallFrame *frame = vm->current_frame;
+  if (!frame || slot >= frame->slot_count) {
+    vm_set_errorf(vm, KRONOS_ERR_INTERNAL,
+                  "Local slot %u used outside its function", slot);
+    return NULL;
+  }
+  KronosValue *value = frame->slots[slot];
+  if (!value) {
+    // Not assigned yet in this call: the name still refers to a global
+    const char *name = local_slot_name(frame->function, slot);
+    value = vm_get_global(vm, name);
+    if (!value) {
+      vm_set_errorf(vm, KRONOS_ERR_NOT_FOUND, "Undefined variable '%s'",
+                    name);
+    }
+  }
+  return value;
+}
+
+static int handle_op_load_local(KronosVM *vm) {
+  uint8_t slot = read_byte(vm);
+  if (vm->last_error_message) {
+    return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
+  }
+  KronosValue *value = load_local_slot(vm, slot);
+  if (!value) {
+    return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
+  }
+  PUSH_OR_RETURN_WITH_CLEANUP(vm, value, (void)0);
+  return 0;
+}
+
+static int handle_op_store_local(KronosVM *vm) {
+  uint8_t slot = read_byte(vm);
+  if (vm->last_error_message) {
+    return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
+  }
+  if (!vm->current_frame) {
+    return vm_errorf(vm, KRONOS_ERR_INTERNAL,
+                     "Local slot %u used outside its function", slot);
+  }
+  KronosValue *value;
+  POP_OR_RETURN(vm, value);
+
+  int store_status = vm_set_local(vm, vm->current_frame, slot, value);
+  value_release(value); // Release our reference
+  return store_status;
+}
+
+static int handle_op_print(KronosVM *vm) {
+  KronosValue *value;
+  POP_OR_RETURN(vm, value);
+  value_fprint(stdout, value);
+  printf("\n");
+  value_release(value);
+  return 0;
+}
+
+/*
+ * Type quickening
+ *
+ * A generic arithmetic or ordered comparison instruction that executes on
+ * two numbers overwrites its own opcode byte with the number-only form
+ * (e.g. OP_ADD -> OP_ADD_NUM); OP_ADD on two strings becomes OP_CONCAT_STR
+ * and OP_LIST_GET on a list becomes OP_INDEX_LIST. The compiler also emits
+ * these forms directly where it can prove the operand types. The quickened
+ * handler checks its operands
+ * with one cheap guard; on a miss it writes the generic opcode back and
+ * runs the generic handler, so results and errors never change. Only the
+ * opcode byte is rewritten (same length and operands), which keeps the
+ * bytecode valid for every VM; function bodies are already per-function
+ * copies made by OP_DEFINE_FUNC.
+ */
+static inline void quicken_site(KronosVM *vm, uint8_t *site, uint8_t opcode) {
+  *site = opcode;
+  vm->quickened++;
+}
+
+static inline void dequicken_site(KronosVM *vm, uint8_t *site,
+                                  uint8_t opcode) {
+  *site = opcode;
+  vm->dequickened++;
+}
+
+// Number-only opcode for a generic arithmetic/comparison opcode (0 if none)
+static inline uint8_t quickened_opcode(uint8_t op) {
+  switch (op) {
+  case OP_ADD:
+    return OP_ADD_NUM;
+  case OP_SUB:
+    return OP_SUB_NUM;
+  case OP_MUL:
+    return OP_MUL_NUM;
+  case OP_GT:
+    return OP_GT_NUM;
+  case OP_LT:
+    return OP_LT_NUM;
+  case OP_GTE:
+    return OP_GTE_NUM;
+  case OP_LTE:
+    return OP_LTE_NUM;
+  default:
+    return 0;
+  }
+}
+
+/**
+ * @brief Quicken the executing 1-byte instruction for the types of its two
+ * operands (called by the generic handlers before they pop)
+ */
+static inline void maybe_quicken(KronosVM *vm, uint8_t op) {
+  KronosValue **top = vm->stack_top;
+  if (top - vm->stack < 2) {
+    return;
+  }
+  ValueType a = value_type(top[-2]);
+  ValueType b = value_type(top[-1]);
+  uint8_t quick = 0;
+  if (a == VAL_NUMBER && b == VAL_NUMBER) {
+    quick = quickened_opcode(op);
+  } else if (op == OP_ADD && a == VAL_STRING && b == VAL_STRING) {
+    quick = OP_CONCAT_STR;
+  } else if (op == OP_LIST_GET && a == VAL_LIST && b == VAL_NUMBER) {
+    quick = OP_INDEX_LIST;
+  }
+  // (The site is already quick when a typed handler falls back to report
+  // an error)
+  if (quick && vm->ip[-1] != quick) {
+    quicken_site(vm, vm->ip - 1, quick);
+  }
+}
+
+/**
+ * @brief Body of the quickened number-only binary opcodes
+ *
+ * Replaces the two number operands with the result of generic opcode
+ * @p op; on a guard miss restores @p op at the site and runs @p generic.
+ */
+static inline int run_quickened_binop(KronosVM *vm, uint8_t op,
+                                      OpcodeHandler generic) {
+  KronosValue **top = vm->stack_top;
+  if (VM_UNLIKELY(top - vm->stack < 2 || !value_is_number(top[-2]) ||
+                  !value_is_number(top[-1]))) {
+    dequicken_site(vm, vm->ip - 1, op);
+    return generic(vm);
+  }
+
+  double x = value_as_number(top[-2]);
+  double y = value_as_number(top[-1]);
+  KronosValue *result;
+  switch (op) {
+  case OP_ADD:
+    result = value_new_number(x + y);
+    break;
+  case OP_SUB:
+    result = value_new_number(x - y);
+    break;
+  case OP_MUL:
+    result = value_new_number(x * y);
+    break;
+  case OP_GT:
+    result = value_new_bool(x > y);
+    break;
+  case OP_LT:
+    result = value_new_bool(x < y);
+    break;
+  case OP_GTE:
+    result = value_new_bool(x >= y);
+    break;
+  default:
+    result = value_new_bool(x <= y);
+    break;
+  }
+  if (!result) {
+    return vm_error(vm, KRONOS_ERR_INTERNAL, "Failed to allocate result");
+  }
+
+  // The stack's references to the operands are dropped and the result's
+  // initial reference is handed to the stack
+  value_release(top[-2]);
+  value_release(top[-1]);
+  top[-2] = result;
+  vm->stack_top = top - 1;
+  return 0;
+}
+
+/**
+ * @brief Compute a + b with OP_ADD semantics
+ *
+ * Numbers add; any other combination concatenates the string forms of the
+ * operands, left first. Shared by OP_ADD, OP_CONCAT_STR and the increment
+ * superinstructions.
+ *
+ * @return New reference to the result, or NULL with an error set
+ */
+static KronosValue *add_values(KronosVM *vm, const KronosValue *a,
+                               const KronosValue *b) {
+  if (value_is_number(a) && value_is_number(b)) {
+    // Numeric addition
+    return value_new_number(value_as_number(a) + value_as_number(b));
+  }
+  if (value_type(a) == VAL_STRING && value_type(b) == VAL_STRING) {
+    // Two strings are joined straight into the result's buffer
+    KronosValue *result =
+        value_new_string_concat(a->as.string.data, a->as.string.length,
+                                b->as.string.data, b->as.string.length);
+    if (!result) {
+      vm_set_error(vm, KRONOS_ERR_INTERNAL, "Failed to create string value");
+    }
+    return result;
+  }
+
+  // String concatenation (handles string+string, number+string,
+  // string+number) Order matters: left operand first, then right operand
+  char *str_a = value_to_string_repr(a);
+  char *str_b = value_to_string_repr(b);
+
+  if (!str_a || !str_b) {
+    free(str_a);
+    free(str_b);
+    vm_set_error(vm, KRONOS_ERR_INTERNAL,
+                 "Failed to allocate memory for string conversion");
+    return NULL;
+  }
+
+  size_t len_a = strlen(str_a);
+  size_t len_b = strlen(str_b);
+  size_t total_len = len_a + len_b;
+
+  char *concat = malloc(total_len + 1);
+  if (!concat) {
+    free(str_a);
+    free(str_b);
+    vm_set_error(vm, KRONOS_ERR_INTERNAL,
+                 "Failed to allocate memory for string concatenation");
+    return NULL;
+  }
+
+  // Concatenate in order: left operand first, then right operand
+  memcpy(concat, str_a, len_a);
+  memcpy(concat + len_a, str_b, len_b);
+  concat[total_len] = '\0';
+
+  KronosValue *result = value_new_string(concat, total_len);
+  free(concat);
+  free(str_a);
+  free(str_b);
+
+  if (!result) {
+    vm_set_error(vm, KRONOS_ERR_INTERNAL, "Failed to create string value");
+  }
+  return result;
+}
+
+static int handle_op_add(KronosVM *vm) {
+  maybe_quicken(vm, OP_ADD);
+  KronosValue *b;
+  POP_OR_RETURN(vm, b);
+  KronosValue *a;
+  POP_OR_RETURN_WITH_CLEANUP(vm, a, value_release(b));
+
+  KronosValue *result = add_values(vm, a, b);
+  value_release(a);
+  value_release(b);
+  if (!result) {
+    return vm_propagate_error(vm, KRONOS_ERR_INTERNAL);
+  }
+  PUSH_OR_RETURN_WITH_CLEANUP(vm, result, value_release(result));
+  value_release(result); // Push retains it
+  return 0;
+}
+
+static int handle_op_add_num(KronosVM *vm) {
+  return run_quickened_binop(vm, OP_ADD, handle_op_add);
+}
+
+static int handle_op_concat_str(KronosVM *vm) {
+  KronosValue **top = vm->stack_top;
+  if (VM_UNLIKELY(top - vm->stack < 2 || value_type(top[-2]) != VAL_STRING ||
+                  value_type(top[-1]) != VAL_STRING)) {
+    dequicken_site(vm, vm->ip - 1, OP_ADD);
+    return handle_op_add(vm);
+  }
+
+  KronosValue *result = add_values(vm, top[-2], top[-1]);
+  if (!result) {
+    return vm_propagate_error(vm, KRONOS_ERR_INTERNAL);
+  }
+  value_release(top[-2]);
+  value_release(top[-1]);
+  top[-2] = result;
+  vm->stack_top = top - 1;
+  return 0;
+}
+
+static VM_ALWAYS_INLINE int exec_inc_local_const(KronosVM *vm, bool wide) {
+  uint8_t slot = read_byte(vm);
+  KronosValue *step = read_constant(vm, wide);
+  if (!step) {
+    return vm_propagate_error(vm, KRONOS_ERR_INTERNAL);
+  }
+  KronosValue *current = load_local_slot(vm, slot);
+  if (!current) {
+    return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
+  }
+  KronosValue *result = add_values(vm, current, step);
+  if (!result) {
+    return vm_propagate_error(vm, KRONOS_ERR_INTERNAL);
+  }
+  int store_status = vm_set_local(vm, vm->current_frame, slot, result);
+  value_release(result);
+  return store_status;
+}
+
+static int handle_op_inc_local_const(KronosVM *vm) {
+  return exec_inc_local_const(vm, false);
+}
+
+/**
+ * @brief Skip the STORE_VAR declaration operands of an increment instruction
+ *
+ * @return Type name constant (NULL if untyped or on error); *@p is_mutable
+ * receives the mutability flag
+ */
+static const char *read_store_declaration(KronosVM *vm, bool wide,
+                                          bool *is_mutable) {
+  *is_mutable = read_byte(vm) == 1;
+  uint8_t has_type = read_byte(vm);
+  if (!has_type) {
+    return NULL;
+  }
+  KronosValue *type_val = read_constant(vm, wide);
+  if (type_val && value_type(type_val) != VAL_STRING) {
+    vm_set_error(vm, KRONOS_ERR_INTERNAL,
+                 "Type name constant is not a string");
+    return NULL;
+  }
+  return type_val ? type_val->as.string.data : NULL;
+}
+
+/**
+ * @brief Add the step constant to the global named by @p name_val
+ * (OP_INC_VAR_CONST semantics)
+ *
+ * Reads the operands that follow the name. Rewrites @p site to
+ * OP_INC_GLOBAL_CONST once the global exists (NULL: never).
+ */
+static int inc_named_variable(KronosVM *vm, uint8_t *site,
+                              KronosValue *name_val, bool wide) {
+  KronosValue *step = read_constant(vm, wide);
+  if (!step) {
+    return vm_propagate_error(vm, KRONOS_ERR_INTERNAL);
+  }
+  if (value_type(name_val) != VAL_STRING) {
+    return vm_error(vm, KRONOS_ERR_INTERNAL,
+                    "Variable name constant is not a string");
+  }
+  const char *name = name_val->as.string.data;
+  bool is_mutable;
+  const char *type_name = read_store_declaration(vm, wide, &is_mutable);
+  if (vm->last_error_message) {
+    return vm_propagate_error(vm, KRONOS_ERR_INTERNAL);
+  }
+
+  // Same lookup and store as LOAD_VAR/STORE_VAR; named increments are only
+  // emitted outside functions, where both target globals
+  KronosValue *current = vm_get_variable(vm, name);
+  if (!current) {
+    return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
+  }
+  KronosValue *result = add_values(vm, current, step);
+  if (!result) {
+    return vm_propagate_error(vm, KRONOS_ERR_INTERNAL);
   }
-
-  value_release(value); // Release our reference
+  int store_status = vm_set_global(vm, name, result, is_mutable, type_name);
+  value_release(result);
   if (store_status != 0) {
     return store_status;
   }
-  return 0;
-}
 
-static int handle_op_print(KronosVM *vm) {
-  KronosValue *value;
-  POP_OR_RETURN(vm, value);
-  value_fprint(stdout, value);
-  printf("\n");
-  value_release(value);
+  size_t slot = site ? global_find(vm, name) : SIZE_MAX;
+  if (slot != SIZE_MAX) {
+    rewrite_global_site(vm, site, OP_INC_GLOBAL_CONST, slot, wide);
+  }
   return 0;
 }
 
-static int handle_op_add(KronosVM *vm) {
-  KronosValue *b;
-  POP_OR_RETURN(vm, b);
-  KronosValue *a;
-  POP_OR_RETURN_WITH_CLEANUP(vm, a, value_release(b));
-
-  if (a->type == VAL_NUMBER && b->type == VAL_NUMBER) {
-    // Numeric addition
-    KronosValue *result = value_new_number(a->as.number + b->as.number);
-    PUSH_OR_RETURN_WITH_CLEANUP(vm, result, value_release(result);
-                                value_release(a); value_release(b););
-    value_release(result); // Push retains it
-  } else {
-    // String concatenation (handles string+string, number+string,
-    // string+number) Order matters: left operand first, then right operand
-    char *str_a = value_to_string_repr(a);
-    char *str_b = value_to_string_repr(b);
-
-    if (!str_a || !str_b) {
-      free(str_a);
-      free(str_b);
-      value_release(a);
-      value_release(b);
-      return vm_error(vm, KRONOS_ERR_INTERNAL,
-                      "Failed to allocate memory for string conversion");
-    }
-
-    size_t len_a = strlen(str_a);
-    size_t len_b = strlen(str_b);
-    size_t total_len = len_a + len_b;
-
-    char *concat = malloc(total_len + 1);
-    if (!concat) {
-      free(str_a);
-      free(str_b);
-      value_release(a);
-      value_release(b);
-      return vm_error(vm, KRONOS_ERR_INTERNAL,
-                      "Failed to allocate memory for string concatenation");
-    }
-
-    // Concatenate in order: left operand first, then right operand
-    memcpy(concat, str_a, len_a);
-    memcpy(concat + len_a, str_b, len_b);
-    concat[total_len] = '\0';
+static VM_ALWAYS_INLINE int exec_inc_var_const(KronosVM *vm, bool wide) {
+  uint8_t *site = vm->ip - 1;
+  KronosValue *name_val = read_constant(vm, wide);
+  if (!name_val) {
+    return vm_propagate_error(vm, KRONOS_ERR_INTERNAL);
+  }
+  return inc_named_variable(vm, site, name_val, wide);
+}
 
-    KronosValue *result = value_new_string(concat, total_len);
-    free(concat);
-    free(str_a);
-    free(str_b);
+static int handle_op_inc_var_const(KronosVM *vm) {
+  return exec_inc_var_const(vm, false);
+}
 
-    if (!result) {
-      value_release(a);
-      value_release(b);
-      return vm_error(vm, KRONOS_ERR_INTERNAL, "Failed to create string value");
-    }
+static VM_ALWAYS_INLINE int exec_inc_global_const(KronosVM *vm, bool wide) {
+  KronosValue *name_val;
+  size_t slot = read_global_slot(vm, wide, &name_val);
+  if (slot == SIZE_MAX) {
+    return name_val ? inc_named_variable(vm, NULL, name_val, wide)
+                    : vm_propagate_error(vm, KRONOS_ERR_INTERNAL);
+  }
+  KronosValue *step = read_constant(vm, wide);
+  if (!step) {
+    return vm_propagate_error(vm, KRONOS_ERR_INTERNAL);
+  }
+  // Declaration operands are kept from OP_INC_VAR_CONST and skipped, as in
+  // OP_STORE_GLOBAL
+  bool is_mutable;
+  (void)read_store_declaration(vm, wide, &is_mutable);
+  if (vm->last_error_message) {
+    return vm_propagate_error(vm, KRONOS_ERR_INTERNAL);
+  }
 
-    PUSH_OR_RETURN_WITH_CLEANUP(vm, result, value_release(result);
-                                value_release(a); value_release(b););
-    value_release(result);
+  KronosValue *result = add_values(vm, vm->globals[slot].value, step);
+  if (!result) {
+    return vm_propagate_error(vm, KRONOS_ERR_INTERNAL);
   }
+  int store_status = global_assign(vm, slot, result);
+  value_release(result);
+  return store_status;
+}
 
-  value_release(a);
-  value_release(b);
-  return 0;
+static int handle_op_inc_global_const(KronosVM *vm) {
+  return exec_inc_global_const(vm, false);
 }
 
 static int handle_op_sub(KronosVM *vm) {
+  maybe_quicken(vm, OP_SUB);
   KronosValue *b;
 
   POP_OR_RETURN(vm, b);
@@ -2009,8 +2923,9 @@ static int handle_op_sub(KronosVM *vm) {
 
   POP_OR_RETURN_WITH_CLEANUP(vm, a, value_release(b));
 
-  if (a->type == VAL_NUMBER && b->type == VAL_NUMBER) {
-    KronosValue *result = value_new_number(a->as.number - b->as.number);
+  if (value_is_number(a) && value_is_number(b)) {
+    KronosValue *result =
+        value_new_number(value_as_number(a) - value_as_number(b));
     PUSH_OR_RETURN_WITH_CLEANUP(vm, result, value_release(result);
                                 value_release(a); value_release(b););
     value_release(result);
@@ -2027,7 +2942,12 @@ static int handle_op_sub(KronosVM *vm) {
   return 0;
 }
 
+static int handle_op_sub_num(KronosVM *vm) {
+  return run_quickened_binop(vm, OP_SUB, handle_op_sub);
+}
+
 static int handle_op_mul(KronosVM *vm) {
+  maybe_quicken(vm, OP_MUL);
   KronosValue *b;
 
   POP_OR_RETURN(vm, b);
@@ -2035,8 +2955,9 @@ static int handle_op_mul(KronosVM *vm) {
 
   POP_OR_RETURN_WITH_CLEANUP(vm, a, value_release(b));
 
-  if (a->type == VAL_NUMBER && b->type == VAL_NUMBER) {
-    KronosValue *result = value_new_number(a->as.number * b->as.number);
+  if (value_is_number(a) && value_is_number(b)) {
+    KronosValue *result =
+        value_new_number(value_as_number(a) * value_as_number(b));
     PUSH_OR_RETURN_WITH_CLEANUP(vm, result, value_release(result);
                                 value_release(a); value_release(b););
     value_release(result);
@@ -2053,6 +2974,10 @@ static int handle_op_mul(KronosVM *vm) {
   return 0;
 }
 
+static int handle_op_mul_num(KronosVM *vm) {
+  return run_quickened_binop(vm, OP_MUL, handle_op_mul);
+}
+
 static int handle_op_div(KronosVM *vm) {
   KronosValue *b;
 
@@ -2061,14 +2986,15 @@ static int handle_op_div(KronosVM *vm) {
 
   POP_OR_RETURN_WITH_CLEANUP(vm, a, value_release(b));
 
-  if (a->type == VAL_NUMBER && b->type == VAL_NUMBER) {
-    if (b->as.number == 0) {
+  if (value_is_number(a) && value_is_number(b)) {
+    if (value_as_number(b) == 0) {
       int err = vm_error(vm, KRONOS_ERR_RUNTIME, "Cannot divide by zero");
       value_release(a);
       value_release(b);
       return err;
     }
-    KronosValue *result = value_new_number(a->as.number / b->as.number);
+    KronosValue *result =
+        value_new_number(value_as_number(a) / value_as_number(b));
     PUSH_OR_RETURN_WITH_CLEANUP(vm, result, value_release(result);
                                 value_release(a); value_release(b););
     value_release(result);
@@ -2093,15 +3019,16 @@ static int handle_op_mod(KronosVM *vm) {
 
   POP_OR_RETURN_WITH_CLEANUP(vm, a, value_release(b));
 
-  if (a->type == VAL_NUMBER && b->type == VAL_NUMBER) {
-    if (b->as.number == 0) {
+  if (value_is_number(a) && value_is_number(b)) {
+    if (value_as_number(b) == 0) {
       int err = vm_error(vm, KRONOS_ERR_RUNTIME, "Cannot modulo by zero");
       value_release(a);
       value_release(b);
       return err;
     }
     // Use fmod for floating-point modulo
-    KronosValue *result = value_new_number(fmod(a->as.number, b->as.number));
+    KronosValue *result =
+        value_new_number(fmod(value_as_number(a), value_as_number(b)));
     PUSH_OR_RETURN_WITH_CLEANUP(vm, result, value_release(result);
                                 value_release(a); value_release(b););
     value_release(result);
@@ -2123,8 +3050,8 @@ static int handle_op_neg(KronosVM *vm) {
 
   POP_OR_RETURN(vm, val);
 
-  if (val->type == VAL_NUMBER) {
-    KronosValue *result = value_new_number(-val->as.number);
+  if (value_is_number(val)) {
+    KronosValue *result = value_new_number(-value_as_number(val));
     PUSH_OR_RETURN_WITH_CLEANUP(vm, result, value_release(result);
                                 value_release(val););
     value_release(result);
@@ -2139,68 +3066,56 @@ static int handle_op_neg(KronosVM *vm) {
   return 0;
 }
 
-static int handle_op_eq(KronosVM *vm) {
-  KronosValue *b;
-
-  POP_OR_RETURN(vm, b);
-  KronosValue *a;
-
-  POP_OR_RETURN_WITH_CLEANUP(vm, a, value_release(b));
-  bool result = value_equals(a, b);
-  KronosValue *res = value_new_bool(result);
-  PUSH_OR_RETURN_WITH_CLEANUP(vm, res, value_release(res); value_release(a);
-                              value_release(b););
-  value_release(res);
-  value_release(a);
-  value_release(b);
-  return 0;
-}
-
-static int handle_op_neq(KronosVM *vm) {
-  KronosValue *b;
-
-  POP_OR_RETURN(vm, b);
-  KronosValue *a;
-
-  POP_OR_RETURN_WITH_CLEANUP(vm, a, value_release(b));
-  bool result = !value_equals(a, b);
-  KronosValue *res = value_new_bool(result);
-  PUSH_OR_RETURN_WITH_CLEANUP(vm, res, value_release(res); value_release(a);
-                              value_release(b););
-  value_release(res);
-  value_release(a);
-  value_release(b);
-  return 0;
-}
-
-static int handle_op_gt(KronosVM *vm) {
-  KronosValue *b;
-
-  POP_OR_RETURN(vm, b);
-  KronosValue *a;
-
-  POP_OR_RETURN_WITH_CLEANUP(vm, a, value_release(b));
-
-  if (a->type == VAL_NUMBER && b->type == VAL_NUMBER) {
-    bool result = a->as.number > b->as.number;
-    KronosValue *res = value_new_bool(result);
-    PUSH_OR_RETURN_WITH_CLEANUP(vm, res, value_release(res); value_release(a);
-                                value_release(b););
-    value_release(res);
-  } else {
-    int err = vm_error(vm, KRONOS_ERR_RUNTIME,
-                       "Cannot perform '>' - both values must be numbers");
-    value_release(a);
-    value_release(b);
-    return err;
+/**
+ * @brief Evaluate comparison opcode @p op (OP_EQ..OP_LTE) on two operands
+ *
+ * Shared by the comparison opcodes and OP_CMP_JUMP_IF_FALSE so the fused
+ * form has identical semantics and errors.
+ *
+ * @return 0 with *@p result set, or an error code
+ */
+static int compare_values(KronosVM *vm, uint8_t op, KronosValue *a,
+                          KronosValue *b, bool *result) {
+  if (op == OP_EQ || op == OP_NEQ) {
+    *result = value_equals(a, b) == (op == OP_EQ);
+    return 0;
   }
 
-  value_release(a);
-  value_release(b);
+  const char *symbol = op == OP_GT    ? ">"
+                       : op == OP_LT  ? "<"
+                       : op == OP_GTE ? ">="
+                                      : "<=";
+  if (!value_is_number(a) || !value_is_number(b)) {
+    return vm_errorf(vm, KRONOS_ERR_RUNTIME,
+                     "Cannot perform '%s' - both values must be numbers",
+                     symbol);
+  }
+  double x = value_as_number(a);
+  double y = value_as_number(b);
+  switch (op) {
+  case OP_GT:
+    *result = x > y;
+    break;
+  case OP_LT:
+    *result = x < y;
+    break;
+  case OP_GTE:
+    *result = x >= y;
+    break;
+  default:
+    *result = x <= y;
+    break;
+  }
   return 0;
 }
 
-static int handle_op_lt(KronosVM *vm) {
+/**
+ * @brief Pop two operands, compare them with @p op and push the result
+ */
+static int handle_comparison(KronosVM *vm, uint8_t op) {
+  if (op != OP_EQ && op != OP_NEQ) {
+    maybe_quicken(vm, op);
+  }
   KronosValue *b;
 
   POP_OR_RETURN(vm, b);
@@ -2208,77 +3123,51 @@ static int handle_op_lt(KronosVM *vm) {
 
   POP_OR_RETURN_WITH_CLEANUP(vm, a, value_release(b));
 
-  if (a->type == VAL_NUMBER && b->type == VAL_NUMBER) {
-    bool result = a->as.number < b->as.number;
-    KronosValue *res = value_new_bool(result);
-    PUSH_OR_RETURN_WITH_CLEANUP(vm, res, value_release(res); value_release(a);
-                                value_release(b););
-    value_release(res);
-  } else {
-    int err = vm_error(vm, KRONOS_ERR_RUNTIME,
-                       "Cannot perform '<' - both values must be numbers");
-    value_release(a);
-    value_release(b);
-    return err;
-  }
-
+  bool result;
+  int status = compare_values(vm, op, a, b, &result);
   value_release(a);
   value_release(b);
+  if (status != 0) {
+    return status;
+  }
+  KronosValue *res = value_new_bool(result);
+  PUSH_OR_RETURN_WITH_CLEANUP(vm, res, value_release(res));
+  value_release(res);
   return 0;
 }
 
-static int handle_op_gte(KronosVM *vm) {
-  KronosValue *b;
+static int handle_op_eq(KronosVM *vm) { return handle_comparison(vm, OP_EQ); }
 
-  POP_OR_RETURN(vm, b);
-  KronosValue *a;
+static int handle_op_neq(KronosVM *vm) {
+  return handle_comparison(vm, OP_NEQ);
+}
 
-  POP_OR_RETURN_WITH_CLEANUP(vm, a, value_release(b));
+static int handle_op_gt(KronosVM *vm) { return handle_comparison(vm, OP_GT); }
 
-  if (a->type == VAL_NUMBER && b->type == VAL_NUMBER) {
-    bool result = a->as.number >= b->as.number;
-    KronosValue *res = value_new_bool(result);
-    PUSH_OR_RETURN_WITH_CLEANUP(vm, res, value_release(res); value_release(a);
-                                value_release(b););
-    value_release(res);
-  } else {
-    int err = vm_error(vm, KRONOS_ERR_RUNTIME,
-                       "Cannot perform '>=' - both values must be numbers");
-    value_release(a);
-    value_release(b);
-    return err;
-  }
+static int handle_op_lt(KronosVM *vm) { return handle_comparison(vm, OP_LT); }
 
-  value_release(a);
-  value_release(b);
-  return 0;
+static int handle_op_gte(KronosVM *vm) {
+  return handle_comparison(vm, OP_GTE);
 }
 
 static int handle_op_lte(KronosVM *vm) {
-  KronosValue *b;
+  return handle_comparison(vm, OP_LTE);
+}
 
-  POP_OR_RETURN(vm, b);
-  KronosValue *a;
+static int handle_op_gt_num(KronosVM *vm) {
+  return run_quickened_binop(vm, OP_GT, handle_op_gt);
+}
 
-  POP_OR_RETURN_WITH_CLEANUP(vm, a, value_release(b));
+static int handle_op_lt_num(KronosVM *vm) {
+  return run_quickened_binop(vm, OP_LT, handle_op_lt);
+}
 
-  if (a->type == VAL_NUMBER && b->type == VAL_NUMBER) {
-    bool result = a->as.number <= b->as.number;
-    KronosValue *res = value_new_bool(result);
-    PUSH_OR_RETURN_WITH_CLEANUP(vm, res, value_release(res); value_release(a);
-                                value_release(b););
-    value_release(res);
-  } else {
-    int err = vm_error(vm, KRONOS_ERR_RUNTIME,
-                       "Cannot perform '<=' - both values must be numbers");
-    value_release(a);
-    value_release(b);
-    return err;
-  }
+static int handle_op_gte_num(KronosVM *vm) {
+  return run_quickened_binop(vm, OP_GTE, handle_op_gte);
+}
 
-  value_release(a);
-  value_release(b);
-  return 0;
+static int handle_op_lte_num(KronosVM *vm) {
+  return run_quickened_binop(vm, OP_LTE, handle_op_lte);
 }
 
 static int handle_op_and(KronosVM *vm) {
@@ -2338,9 +3227,9 @@ static int handle_op_not(KronosVM *vm) {
   return 0;
 }
 
-static int handle_op_jump(KronosVM *vm) {
-  int16_t offset = read_int16(vm);
-  // Check for error from read_int16
+static VM_ALWAYS_INLINE int exec_jump(KronosVM *vm, bool wide) {
+  int32_t offset = read_offset(vm, wide);
+  // Check for error from the offset read
   if (vm->last_error_message) {
     return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
   }
@@ -2357,9 +3246,11 @@ static int handle_op_jump(KronosVM *vm) {
   return 0;
 }
 
-static int handle_op_jump_if_false(KronosVM *vm) {
-  uint16_t offset = read_uint16(vm);
-  // Check for error from read_uint16
+static int handle_op_jump(KronosVM *vm) { return exec_jump(vm, false); }
+
+static VM_ALWAYS_INLINE int exec_jump_if_false(KronosVM *vm, bool wide) {
+  uint32_t offset = read_operand(vm, wide);
+  // Check for error from the offset read
   if (vm->last_error_message) {
     return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
   }
@@ -2391,6 +3282,108 @@ static int handle_op_jump_if_false(KronosVM *vm) {
   return 0;
 }
 
+static int handle_op_jump_if_false(KronosVM *vm) {
+  return exec_jump_if_false(vm, false);
+}
+
+static VM_ALWAYS_INLINE int exec_cmp_jump_if_false(KronosVM *vm, bool wide) {
+  uint8_t *site = vm->ip - 1;
+  uint8_t op = read_byte(vm);
+  uint32_t offset = read_operand(vm, wide);
+  if (vm->last_error_message) {
+    return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
+  }
+  if (op < OP_EQ || op > OP_LTE) {
+    return vm_errorf(vm, KRONOS_ERR_INTERNAL, "Invalid comparison opcode: %u",
+                     op);
+  }
+  if (op != OP_EQ && op != OP_NEQ && vm->stack_top - vm->stack >= 2 &&
+      value_is_number(vm->stack_top[-2]) &&
+      value_is_number(vm->stack_top[-1])) {
+    quicken_site(vm, site, OP_CMP_JUMP_IF_FALSE_NUM);
+  }
+  KronosValue *b;
+  POP_OR_RETURN(vm, b);
+  KronosValue *a;
+  POP_OR_RETURN_WITH_CLEANUP(vm, a, value_release(b));
+
+  bool result;
+  int status = compare_values(vm, op, a, b, &result);
+  value_release(a);
+  value_release(b);
+  if (status != 0) {
+    return status;
+  }
+  if (!result) {
+    uint8_t *new_ip = vm->ip + offset;
+    // Bounds check: ensure jump target is within valid bytecode range
+    if (new_ip >= vm->bytecode->code + vm->bytecode->count) {
+      return vm_errorf(
+          vm, KRONOS_ERR_RUNTIME,
+          "Jump target out of bounds (offset: %u, bytecode size: %zu)", offset,
+          vm->bytecode->count);
+    }
+    vm->ip = new_ip;
+  }
+  return 0;
+}
+
+static int handle_op_cmp_jump_if_false(KronosVM *vm) {
+  return exec_cmp_jump_if_false(vm, false);
+}
+
+static VM_ALWAYS_INLINE int exec_cmp_jump_if_false_num(KronosVM *vm,
+                                                       bool wide) {
+  KronosValue **top = vm->stack_top;
+  if (VM_UNLIKELY(top - vm->stack < 2 || !value_is_number(top[-2]) ||
+                  !value_is_number(top[-1]))) {
+    dequicken_site(vm, vm->ip - 1, OP_CMP_JUMP_IF_FALSE);
+    return exec_cmp_jump_if_false(vm, wide);
+  }
+  uint8_t op = read_byte(vm);
+  uint32_t offset = read_operand(vm, wide);
+  if (vm->last_error_message) {
+    return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
+  }
+
+  double x = value_as_number(top[-2]);
+  double y = value_as_number(top[-1]);
+  bool result;
+  switch (op) {
+  case OP_GT:
+    result = x > y;
+    break;
+  case OP_LT:
+    result = x < y;
+    break;
+  case OP_GTE:
+    result = x >= y;
+    break;
+  default:
+    result = x <= y;
+    break;
+  }
+  value_release(top[-2]);
+  value_release(top[-1]);
+  vm->stack_top = top - 2;
+  if (!result) {
+    uint8_t *new_ip = vm->ip + offset;
+    // Bounds check: ensure jump target is within valid bytecode range
+    if (new_ip >= vm->bytecode->code + vm->bytecode->count) {
+      return vm_errorf(
+          vm, KRONOS_ERR_RUNTIME,
+          "Jump target out of bounds (offset: %u, bytecode size: %zu)", offset,
+          vm->bytecode->count);
+    }
+    vm->ip = new_ip;
+  }
+  return 0;
+}
+
+static int handle_op_cmp_jump_if_false_num(KronosVM *vm) {
+  return exec_cmp_jump_if_false_num(vm, false);
+}
+
 static int handle_op_pop(KronosVM *vm) {
   KronosValue *value;
 
@@ -2419,18 +3412,13 @@ static int handle_op_list_new(KronosVM *vm) {
   return 0;
 }
 
-static int handle_op_halt(KronosVM *vm) {
-  (void)vm; // Unused parameter
-  return 0;
-}
-
 // Built-in function implementations
 static int builtin_read_file(KronosVM *vm, uint8_t arg_count) {
   if (arg_count != 1)
     return vm_errorf(vm, KRONOS_ERR_RUNTIME, "Expected 1 argument");
   KronosValue *path_val;
   POP_OR_RETURN(vm, path_val);
-  if (path_val->type != VAL_STRING) {
+  if (value_type(path_val) != VAL_STRING) {
     value_release(path_val);
     return vm_errorf(vm, KRONOS_ERR_RUNTIME, "Path must be a string");
   }
@@ -2492,8 +3480,9 @@ static int builtin_add(KronosVM *vm, uint8_t arg_count) {
   KronosValue *a;
 
   POP_OR_RETURN_WITH_CLEANUP(vm, a, value_release(b));
-  if (a->type == VAL_NUMBER && b->type == VAL_NUMBER) {
-    KronosValue *result = value_new_number(a->as.number + b->as.number);
+  if (value_is_number(a) && value_is_number(b)) {
+    KronosValue *result =
+        value_new_number(value_as_number(a) + value_as_number(b));
     PUSH_OR_RETURN_WITH_CLEANUP(vm, result, value_release(result);
                                 value_release(a); value_release(b););
     value_release(result);
@@ -2521,8 +3510,9 @@ static int builtin_subtract(KronosVM *vm, uint8_t arg_count) {
   KronosValue *a;
 
   POP_OR_RETURN_WITH_CLEANUP(vm, a, value_release(b));
-  if (a->type == VAL_NUMBER && b->type == VAL_NUMBER) {
-    KronosValue *result = value_new_number(a->as.number - b->as.number);
+  if (value_is_number(a) && value_is_number(b)) {
+    KronosValue *result =
+        value_new_number(value_as_number(a) - value_as_number(b));
     PUSH_OR_RETURN_WITH_CLEANUP(vm, result, value_release(result);
                                 value_release(a); value_release(b););
     value_release(result);
@@ -2551,8 +3541,9 @@ static int builtin_multiply(KronosVM *vm, uint8_t arg_count) {
   KronosValue *a;
 
   POP_OR_RETURN_WITH_CLEANUP(vm, a, value_release(b));
-  if (a->type == VAL_NUMBER && b->type == VAL_NUMBER) {
-    KronosValue *result = value_new_number(a->as.number * b->as.number);
+  if (value_is_number(a) && value_is_number(b)) {
+    KronosValue *result =
+        value_new_number(value_as_number(a) * value_as_number(b));
     PUSH_OR_RETURN_WITH_CLEANUP(vm, result, value_release(result);
                                 value_release(a); value_release(b););
     value_release(result);
@@ -2581,13 +3572,14 @@ static int builtin_divide(KronosVM *vm, uint8_t arg_count) {
   KronosValue *a;
 
   POP_OR_RETURN_WITH_CLEANUP(vm, a, value_release(b));
-  if (a->type == VAL_NUMBER && b->type == VAL_NUMBER) {
-    if (b->as.number == 0.0) {
+  if (value_is_number(a) && value_is_number(b)) {
+    if (value_as_number(b) == 0.0) {
       value_release(a);
       value_release(b);
       return vm_error(vm, KRONOS_ERR_RUNTIME, "Division by zero");
     }
-    KronosValue *result = value_new_number(a->as.number / b->as.number);
+    KronosValue *result =
+        value_new_number(value_as_number(a) / value_as_number(b));
     PUSH_OR_RETURN_WITH_CLEANUP(vm, result, value_release(result);
                                 value_release(a); value_release(b););
     value_release(result);
@@ -2612,17 +3604,17 @@ static int builtin_len(KronosVM *vm, uint8_t arg_count) {
   KronosValue *arg;
 
   POP_OR_RETURN(vm, arg);
-  if (arg->type == VAL_LIST) {
+  if (value_type(arg) == VAL_LIST) {
     KronosValue *result = value_new_number((double)arg->as.list.count);
     PUSH_OR_RETURN_WITH_CLEANUP(vm, result, value_release(result);
                                 value_release(arg););
     value_release(result);
-  } else if (arg->type == VAL_STRING) {
+  } else if (value_type(arg) == VAL_STRING) {
     KronosValue *result = value_new_number((double)arg->as.string.length);
     PUSH_OR_RETURN_WITH_CLEANUP(vm, result, value_release(result);
                                 value_release(arg););
     value_release(result);
-  } else if (arg->type == VAL_RANGE) {
+  } else if (value_type(arg) == VAL_RANGE) {
     // Calculate range length: number of values in range
     double start = arg->as.range.start;
     double end = arg->as.range.end;
@@ -2666,7 +3658,7 @@ static int builtin_uppercase(KronosVM *vm, uint8_t arg_count) {
   KronosValue *arg;
 
   POP_OR_RETURN(vm, arg);
-  if (arg->type != VAL_STRING) {
+  if (value_type(arg) != VAL_STRING) {
     int err = vm_errorf(vm, KRONOS_ERR_RUNTIME,
                         "Function 'uppercase' requires a string argument");
     value_release(arg);
@@ -2705,7 +3697,7 @@ static int builtin_lowercase(KronosVM *vm, uint8_t arg_count) {
   KronosValue *arg;
 
   POP_OR_RETURN(vm, arg);
-  if (arg->type != VAL_STRING) {
+  if (value_type(arg) != VAL_STRING) {
     int err = vm_errorf(vm, KRONOS_ERR_RUNTIME,
                         "Function 'lowercase' requires a string argument");
     value_release(arg);
@@ -2743,7 +3735,7 @@ static int builtin_trim(KronosVM *vm, uint8_t arg_count) {
   KronosValue *arg;
 
   POP_OR_RETURN(vm, arg);
-  if (arg->type != VAL_STRING) {
+  if (value_type(arg) != VAL_STRING) {
     int err = vm_errorf(vm, KRONOS_ERR_RUNTIME,
                         "Function 'trim' requires a string argument");
     value_release(arg);
@@ -2796,7 +3788,7 @@ static int builtin_split(KronosVM *vm, uint8_t arg_count) {
   KronosValue *str;
 
   POP_OR_RETURN_WITH_CLEANUP(vm, str, value_release(delim));
-  if (str->type != VAL_STRING || delim->type != VAL_STRING) {
+  if (value_type(str) != VAL_STRING || value_type(delim) != VAL_STRING) {
     int err = vm_errorf(vm, KRONOS_ERR_RUNTIME,
                         "Function 'split' requires two string arguments");
     value_release(str);
@@ -2827,7 +3819,9 @@ static int builtin_split(KronosVM *vm, uint8_t arg_count) {
       if (result->as.list.count >= result->as.list.capacity) {
         size_t new_cap = result->as.list.capacity * 2;
         KronosValue **new_items =
-            realloc(result->as.list.items, sizeof(KronosValue *) * new_cap);
+            gc_realloc(result->as.list.items,
+                       result->as.list.capacity * sizeof(KronosValue *),
+                       sizeof(KronosValue *) * new_cap);
         if (!new_items) {
           value_release(char_str);
           value_release(result);
@@ -2887,7 +3881,9 @@ static int builtin_split(KronosVM *vm, uint8_t arg_count) {
         if (result->as.list.count >= result->as.list.capacity) {
           size_t new_cap = result->as.list.capacity * 2;
           KronosValue **new_items =
-              realloc(result->as.list.items, sizeof(KronosValue *) * new_cap);
+              gc_realloc(result->as.list.items,
+                         result->as.list.capacity * sizeof(KronosValue *),
+                         sizeof(KronosValue *) * new_cap);
           if (!new_items) {
             value_release(substr_val);
             value_release(result);
@@ -2927,7 +3923,9 @@ static int builtin_split(KronosVM *vm, uint8_t arg_count) {
         if (result->as.list.count >= result->as.list.capacity) {
           size_t new_cap = result->as.list.capacity * 2;
           KronosValue **new_items =
-              realloc(result->as.list.items, sizeof(KronosValue *) * new_cap);
+              gc_realloc(result->as.list.items,
+                         result->as.list.capacity * sizeof(KronosValue *),
+                         sizeof(KronosValue *) * new_cap);
           if (!new_items) {
             value_release(substr_val);
             value_release(result);
@@ -2965,7 +3963,7 @@ static int builtin_join(KronosVM *vm, uint8_t arg_count) {
   KronosValue *list;
 
   POP_OR_RETURN_WITH_CLEANUP(vm, list, value_release(delim));
-  if (list->type != VAL_LIST || delim->type != VAL_STRING) {
+  if (value_type(list) != VAL_LIST || value_type(delim) != VAL_STRING) {
     int err =
         vm_errorf(vm, KRONOS_ERR_RUNTIME,
                   "Function 'join' requires a list and a string delimiter");
@@ -2978,7 +3976,7 @@ static int builtin_join(KronosVM *vm, uint8_t arg_count) {
   size_t total_len = 0;
   for (size_t i = 0; i < list->as.list.count; i++) {
     KronosValue *item = list->as.list.items[i];
-    if (item->type != VAL_STRING) {
+    if (value_type(item) != VAL_STRING) {
       value_release(list);
       value_release(delim);
       return vm_error(vm, KRONOS_ERR_RUNTIME,
@@ -3038,12 +4036,12 @@ static int builtin_to_string(KronosVM *vm, uint8_t arg_count) {
   char *str_buf = NULL;
   size_t str_len = 0;
 
-  if (arg->type == VAL_STRING) {
+  if (value_type(arg) == VAL_STRING) {
     // Already a string, just return it
     PUSH_OR_RETURN_WITH_CLEANUP(vm, arg, value_release(arg););
     value_release(arg); // Release the pop reference (push already retained)
     return 0;
-  } else if (arg->type == VAL_NUMBER) {
+  } else if (value_is_number(arg)) {
     // Convert number to string
     str_buf = malloc(NUMBER_STRING_BUFFER_SIZE);
     if (!str_buf) {
@@ -3053,16 +4051,16 @@ static int builtin_to_string(KronosVM *vm, uint8_t arg_count) {
 
     // Check if it's a whole number
     double intpart;
-    double frac = modf(arg->as.number, &intpart);
+    double frac = modf(value_as_number(arg), &intpart);
 
-    if (frac == 0.0 && fabs(arg->as.number) < 1.0e15) {
+    if (frac == 0.0 && fabs(value_as_number(arg)) < 1.0e15) {
       str_len = (size_t)snprintf(str_buf, NUMBER_STRING_BUFFER_SIZE, "%.0f",
-                                 arg->as.number);
+                                 value_as_number(arg));
     } else {
       str_len = (size_t)snprintf(str_buf, NUMBER_STRING_BUFFER_SIZE, "%g",
-                                 arg->as.number);
+                                 value_as_number(arg));
     }
-  } else if (arg->type == VAL_BOOL) {
+  } else if (value_type(arg) == VAL_BOOL) {
     if (arg->as.boolean) {
       str_buf = strdup("true");
       if (!str_buf) {
@@ -3078,7 +4076,7 @@ static int builtin_to_string(KronosVM *vm, uint8_t arg_count) {
       }
       str_len = 5;
     }
-  } else if (arg->type == VAL_NIL) {
+  } else if (value_type(arg) == VAL_NIL) {
     str_buf = strdup("null");
     if (!str_buf) {
       value_release(arg);
@@ -3115,7 +4113,7 @@ static int builtin_contains(KronosVM *vm, uint8_t arg_count) {
   KronosValue *str;
 
   POP_OR_RETURN_WITH_CLEANUP(vm, str, value_release(substring));
-  if (str->type != VAL_STRING || substring->type != VAL_STRING) {
+  if (value_type(str) != VAL_STRING || value_type(substring) != VAL_STRING) {
     int err = vm_errorf(vm, KRONOS_ERR_RUNTIME,
                         "Function 'contains' requires two string arguments");
     value_release(str);
@@ -3146,7 +4144,7 @@ static int builtin_starts_with(KronosVM *vm, uint8_t arg_count) {
   KronosValue *str;
 
   POP_OR_RETURN_WITH_CLEANUP(vm, str, value_release(prefix));
-  if (str->type != VAL_STRING || prefix->type != VAL_STRING) {
+  if (value_type(str) != VAL_STRING || value_type(prefix) != VAL_STRING) {
     int err = vm_errorf(vm, KRONOS_ERR_RUNTIME,
                         "Function 'starts_with' requires two string arguments");
     value_release(str);
@@ -3180,7 +4178,7 @@ static int builtin_ends_with(KronosVM *vm, uint8_t arg_count) {
   KronosValue *str;
 
   POP_OR_RETURN_WITH_CLEANUP(vm, str, value_release(suffix));
-  if (str->type != VAL_STRING || suffix->type != VAL_STRING) {
+  if (value_type(str) != VAL_STRING || value_type(suffix) != VAL_STRING) {
     int err = vm_errorf(vm, KRONOS_ERR_RUNTIME,
                         "Function 'ends_with' requires two string arguments");
     value_release(str);
@@ -3218,8 +4216,8 @@ static int builtin_replace(KronosVM *vm, uint8_t arg_count) {
   KronosValue *str;
   POP_OR_RETURN_WITH_CLEANUP(vm, str, value_release(old_str);
                              value_release(new_str));
-  if (str->type != VAL_STRING || old_str->type != VAL_STRING ||
-      new_str->type != VAL_STRING) {
+  if (value_type(str) != VAL_STRING || value_type(old_str) != VAL_STRING ||
+      value_type(new_str) != VAL_STRING) {
     int err = vm_errorf(vm, KRONOS_ERR_RUNTIME,
                         "Function 'replace' requires three string arguments");
     value_release(str);
@@ -3230,7 +4228,6 @@ static int builtin_replace(KronosVM *vm, uint8_t arg_count) {
 
   // Handle empty old string (return original string)
   if (old_str->as.string.length == 0) {
-    value_retain(str);
     PUSH_OR_RETURN_WITH_CLEANUP(vm, str, value_release(str);
                                 value_release(old_str);
                                 value_release(new_str););
@@ -3335,19 +4332,19 @@ static int builtin_sqrt(KronosVM *vm, uint8_t arg_count) {
   KronosValue *arg;
 
   POP_OR_RETURN(vm, arg);
-  if (arg->type != VAL_NUMBER) {
+  if (!value_is_number(arg)) {
     int err = vm_errorf(vm, KRONOS_ERR_RUNTIME,
                         "Function 'sqrt' requires a number argument");
     value_release(arg);
     return err;
   }
-  if (arg->as.number < 0) {
+  if (value_as_number(arg) < 0) {
     int err = vm_errorf(vm, KRONOS_ERR_RUNTIME,
                         "Function 'sqrt' requires a non-negative number");
     value_release(arg);
     return err;
   }
-  KronosValue *result = value_new_number(sqrt(arg->as.number));
+  KronosValue *result = value_new_number(sqrt(value_as_number(arg)));
   PUSH_OR_RETURN_WITH_CLEANUP(vm, result, value_release(result);
                               value_release(arg););
   value_release(result);
@@ -3366,7 +4363,7 @@ static int builtin_power(KronosVM *vm, uint8_t arg_count) {
   KronosValue *base;
 
   POP_OR_RETURN_WITH_CLEANUP(vm, base, value_release(exponent));
-  if (base->type != VAL_NUMBER || exponent->type != VAL_NUMBER) {
+  if (!value_is_number(base) || !value_is_number(exponent)) {
     int err = vm_errorf(vm, KRONOS_ERR_RUNTIME,
                         "Function 'power' requires two number arguments");
     value_release(base);
@@ -3374,7 +4371,7 @@ static int builtin_power(KronosVM *vm, uint8_t arg_count) {
     return err;
   }
   KronosValue *result =
-      value_new_number(pow(base->as.number, exponent->as.number));
+      value_new_number(pow(value_as_number(base), value_as_number(exponent)));
   PUSH_OR_RETURN_WITH_CLEANUP(vm, result, value_release(result);
                               value_release(base); value_release(exponent););
   value_release(result);
@@ -3391,13 +4388,13 @@ static int builtin_abs(KronosVM *vm, uint8_t arg_count) {
   KronosValue *arg;
 
   POP_OR_RETURN(vm, arg);
-  if (arg->type != VAL_NUMBER) {
+  if (!value_is_number(arg)) {
     int err = vm_errorf(vm, KRONOS_ERR_RUNTIME,
                         "Function 'abs' requires a number argument");
     value_release(arg);
     return err;
   }
-  KronosValue *result = value_new_number(fabs(arg->as.number));
+  KronosValue *result = value_new_number(fabs(value_as_number(arg)));
   PUSH_OR_RETURN_WITH_CLEANUP(vm, result, value_release(result);
                               value_release(arg););
   value_release(result);
@@ -3413,13 +4410,13 @@ static int builtin_round(KronosVM *vm, uint8_t arg_count) {
   KronosValue *arg;
 
   POP_OR_RETURN(vm, arg);
-  if (arg->type != VAL_NUMBER) {
+  if (!value_is_number(arg)) {
     int err = vm_errorf(vm, KRONOS_ERR_RUNTIME,
                         "Function 'round' requires a number argument");
     value_release(arg);
     return err;
   }
-  KronosValue *result = value_new_number(round(arg->as.number));
+  KronosValue *result = value_new_number(round(value_as_number(arg)));
   PUSH_OR_RETURN_WITH_CLEANUP(vm, result, value_release(result);
                               value_release(arg););
   value_release(result);
@@ -3435,13 +4432,13 @@ static int builtin_floor(KronosVM *vm, uint8_t arg_count) {
   KronosValue *arg;
 
   POP_OR_RETURN(vm, arg);
-  if (arg->type != VAL_NUMBER) {
+  if (!value_is_number(arg)) {
     int err = vm_errorf(vm, KRONOS_ERR_RUNTIME,
                         "Function 'floor' requires a number argument");
     value_release(arg);
     return err;
   }
-  KronosValue *result = value_new_number(floor(arg->as.number));
+  KronosValue *result = value_new_number(floor(value_as_number(arg)));
   PUSH_OR_RETURN_WITH_CLEANUP(vm, result, value_release(result);
                               value_release(arg););
   value_release(result);
@@ -3457,13 +4454,13 @@ static int builtin_ceil(KronosVM *vm, uint8_t arg_count) {
   KronosValue *arg;
 
   POP_OR_RETURN(vm, arg);
-  if (arg->type != VAL_NUMBER) {
+  if (!value_is_number(arg)) {
     int err = vm_errorf(vm, KRONOS_ERR_RUNTIME,
                         "Function 'ceil' requires a number argument");
     value_release(arg);
     return err;
   }
-  KronosValue *result = value_new_number(ceil(arg->as.number));
+  KronosValue *result = value_new_number(ceil(value_as_number(arg)));
   PUSH_OR_RETURN_WITH_CLEANUP(vm, result, value_release(result);
                               value_release(arg););
   value_release(result);
@@ -3510,7 +4507,7 @@ static int builtin_min(KronosVM *vm, uint8_t arg_count) {
 
   // Validate all are numbers
   for (size_t i = 0; i < arg_count; i++) {
-    if (args[i]->type != VAL_NUMBER) {
+    if (!value_is_number(args[i])) {
       int err =
           vm_errorf(vm, KRONOS_ERR_RUNTIME,
                     "Function 'min' requires all arguments to be numbers");
@@ -3523,10 +4520,10 @@ static int builtin_min(KronosVM *vm, uint8_t arg_count) {
   }
 
   // Find minimum
-  double min_val = args[0]->as.number;
+  double min_val = value_as_number(args[0]);
   for (size_t i = 1; i < arg_count; i++) {
-    if (args[i]->as.number < min_val) {
-      min_val = args[i]->as.number;
+    if (value_as_number(args[i]) < min_val) {
+      min_val = value_as_number(args[i]);
     }
   }
 
@@ -3568,7 +4565,7 @@ static int builtin_max(KronosVM *vm, uint8_t arg_count) {
 
   // Validate all are numbers
   for (size_t i = 0; i < arg_count; i++) {
-    if (args[i]->type != VAL_NUMBER) {
+    if (!value_is_number(args[i])) {
       int err =
           vm_errorf(vm, KRONOS_ERR_RUNTIME,
                     "Function 'max' requires all arguments to be numbers");
@@ -3581,10 +4578,10 @@ static int builtin_max(KronosVM *vm, uint8_t arg_count) {
   }
 
   // Find maximum
-  double max_val = args[0]->as.number;
+  double max_val = value_as_number(args[0]);
   for (size_t i = 1; i < arg_count; i++) {
-    if (args[i]->as.number > max_val) {
-      max_val = args[i]->as.number;
+    if (value_as_number(args[i]) > max_val) {
+      max_val = value_as_number(args[i]);
     }
   }
 
@@ -3610,12 +4607,12 @@ static int builtin_to_number(KronosVM *vm, uint8_t arg_count) {
 
   POP_OR_RETURN(vm, arg);
 
-  if (arg->type == VAL_NUMBER) {
+  if (value_is_number(arg)) {
     // Already a number, just return it
     PUSH_OR_RETURN_WITH_CLEANUP(vm, arg, value_release(arg););
     value_release(arg); // Release the pop reference (push already retained)
     return 0;
-  } else if (arg->type == VAL_STRING) {
+  } else if (value_type(arg) == VAL_STRING) {
     // Try to parse string as number
     char *endptr;
     double num = strtod(arg->as.string.data, &endptr);
@@ -3652,15 +4649,15 @@ static int builtin_to_bool(KronosVM *vm, uint8_t arg_count) {
   POP_OR_RETURN(vm, arg);
 
   bool bool_val = false;
-  if (arg->type == VAL_BOOL) {
+  if (value_type(arg) == VAL_BOOL) {
     bool_val = arg->as.boolean;
-  } else if (arg->type == VAL_NUMBER) {
-    bool_val = (arg->as.number != 0.0);
-  } else if (arg->type == VAL_STRING) {
+  } else if (value_is_number(arg)) {
+    bool_val = (value_as_number(arg) != 0.0);
+  } else if (value_type(arg) == VAL_STRING) {
     bool_val = (arg->as.string.length > 0);
-  } else if (arg->type == VAL_LIST) {
+  } else if (value_type(arg) == VAL_LIST) {
     bool_val = (arg->as.list.count > 0);
-  } else if (arg->type == VAL_NIL) {
+  } else if (value_type(arg) == VAL_NIL) {
     bool_val = false;
   } else {
     bool_val = true; // Other types are truthy
@@ -3682,7 +4679,7 @@ static int builtin_reverse(KronosVM *vm, uint8_t arg_count) {
   KronosValue *arg;
 
   POP_OR_RETURN(vm, arg);
-  if (arg->type != VAL_LIST) {
+  if (value_type(arg) != VAL_LIST) {
     int err = vm_errorf(vm, KRONOS_ERR_RUNTIME,
                         "Function 'reverse' requires a list argument");
     value_release(arg);
@@ -3701,7 +4698,9 @@ static int builtin_reverse(KronosVM *vm, uint8_t arg_count) {
     if (result->as.list.count >= result->as.list.capacity) {
       size_t new_cap = result->as.list.capacity * 2;
       KronosValue **new_items =
-          realloc(result->as.list.items, sizeof(KronosValue *) * new_cap);
+          gc_realloc(result->as.list.items,
+                     result->as.list.capacity * sizeof(KronosValue *),
+                     sizeof(KronosValue *) * new_cap);
       if (!new_items) {
         value_release(arg->as.list.items[i]);
         value_release(result);
@@ -3728,7 +4727,7 @@ static int builtin_sort(KronosVM *vm, uint8_t arg_count) {
   KronosValue *arg;
 
   POP_OR_RETURN(vm, arg);
-  if (arg->type != VAL_LIST) {
+  if (value_type(arg) != VAL_LIST) {
     int err = vm_errorf(vm, KRONOS_ERR_RUNTIME,
                         "Function 'sort' requires a list argument");
     value_release(arg);
@@ -3747,7 +4746,9 @@ static int builtin_sort(KronosVM *vm, uint8_t arg_count) {
     if (result->as.list.count >= result->as.list.capacity) {
       size_t new_cap = result->as.list.capacity * 2;
       KronosValue **new_items =
-          realloc(result->as.list.items, sizeof(KronosValue *) * new_cap);
+          gc_realloc(result->as.list.items,
+                     result->as.list.capacity * sizeof(KronosValue *),
+                     sizeof(KronosValue *) * new_cap);
       if (!new_items) {
         value_release(arg->as.list.items[i]);
         value_release(result);
@@ -3762,7 +4763,7 @@ static int builtin_sort(KronosVM *vm, uint8_t arg_count) {
   // Sort the new list in-place using qsort (O(n log n) average)
   // First, validate all elements are the same type
   if (result->as.list.count > 0) {
-    ValueType first_type = result->as.list.items[0]->type;
+    ValueType first_type = value_type(result->as.list.items[0]);
     if (first_type != VAL_NUMBER && first_type != VAL_STRING) {
       int err = vm_errorf(vm, KRONOS_ERR_RUNTIME,
                           "Function 'sort' requires list items to be "
@@ -3774,7 +4775,7 @@ static int builtin_sort(KronosVM *vm, uint8_t arg_count) {
 
     // Check all elements are the same type
     for (size_t i = 1; i < result->as.list.count; i++) {
-      if (result->as.list.items[i]->type != first_type) {
+      if (value_type(result->as.list.items[i]) != first_type) {
         int err = vm_errorf(vm, KRONOS_ERR_RUNTIME,
                             "Function 'sort' requires list items to be "
                             "all numbers or all strings");
@@ -3809,7 +4810,8 @@ static int builtin_write_file(KronosVM *vm, uint8_t arg_count) {
   KronosValue *path_arg;
 
   POP_OR_RETURN_WITH_CLEANUP(vm, path_arg, value_release(content_arg));
-  if (path_arg->type != VAL_STRING || content_arg->type != VAL_STRING) {
+  if (value_type(path_arg) != VAL_STRING ||
+      value_type(content_arg) != VAL_STRING) {
     int err = vm_errorf(vm, KRONOS_ERR_RUNTIME,
                         "Function 'write_file' requires two string arguments");
     value_release(path_arg);
@@ -3860,7 +4862,7 @@ static int builtin_read_lines(KronosVM *vm, uint8_t arg_count) {
   KronosValue *path_arg;
 
   POP_OR_RETURN(vm, path_arg);
-  if (path_arg->type != VAL_STRING) {
+  if (value_type(path_arg) != VAL_STRING) {
     int err = vm_errorf(vm, KRONOS_ERR_RUNTIME,
                         "Function 'read_lines' requires a string argument");
     value_release(path_arg);
@@ -3907,7 +4909,9 @@ static int builtin_read_lines(KronosVM *vm, uint8_t arg_count) {
     if (result->as.list.count >= result->as.list.capacity) {
       size_t new_cap = result->as.list.capacity * 2;
       KronosValue **new_items =
-          realloc(result->as.list.items, sizeof(KronosValue *) * new_cap);
+          gc_realloc(result->as.list.items,
+                     result->as.list.capacity * sizeof(KronosValue *),
+                     sizeof(KronosValue *) * new_cap);
       if (!new_items) {
         value_release(line_val);
         free(line);
@@ -3943,7 +4947,7 @@ static int builtin_file_exists(KronosVM *vm, uint8_t arg_count) {
   KronosValue *path_arg;
 
   POP_OR_RETURN(vm, path_arg);
-  if (path_arg->type != VAL_STRING) {
+  if (value_type(path_arg) != VAL_STRING) {
     int err = vm_errorf(vm, KRONOS_ERR_RUNTIME,
                         "Function 'file_exists' requires a string argument");
     value_release(path_arg);
@@ -3969,7 +4973,7 @@ static int builtin_list_files(KronosVM *vm, uint8_t arg_count) {
   KronosValue *path_arg;
 
   POP_OR_RETURN(vm, path_arg);
-  if (path_arg->type != VAL_STRING) {
+  if (value_type(path_arg) != VAL_STRING) {
     int err = vm_errorf(vm, KRONOS_ERR_RUNTIME,
                         "Function 'list_files' requires a string argument");
     value_release(path_arg);
@@ -4012,7 +5016,9 @@ static int builtin_list_files(KronosVM *vm, uint8_t arg_count) {
       size_t old_cap = result->as.list.capacity;
       size_t new_cap = old_cap * 2;
       KronosValue **new_items =
-          realloc(result->as.list.items, sizeof(KronosValue *) * new_cap);
+          gc_realloc(result->as.list.items,
+                     result->as.list.capacity * sizeof(KronosValue *),
+                     sizeof(KronosValue *) * new_cap);
       if (!new_items) {
         value_release(name_val);
         closedir(dir);
@@ -4052,7 +5058,8 @@ static int builtin_join_path(KronosVM *vm, uint8_t arg_count) {
   KronosValue *path1_arg;
 
   POP_OR_RETURN_WITH_CLEANUP(vm, path1_arg, value_release(path2_arg));
-  if (path1_arg->type != VAL_STRING || path2_arg->type != VAL_STRING) {
+  if (value_type(path1_arg) != VAL_STRING ||
+      value_type(path2_arg) != VAL_STRING) {
     int err = vm_errorf(vm, KRONOS_ERR_RUNTIME,
                         "Function 'join_path' requires two string arguments");
     value_release(path1_arg);
@@ -4111,7 +5118,7 @@ static int builtin_dirname(KronosVM *vm, uint8_t arg_count) {
   KronosValue *path_arg;
 
   POP_OR_RETURN(vm, path_arg);
-  if (path_arg->type != VAL_STRING) {
+  if (value_type(path_arg) != VAL_STRING) {
     int err = vm_errorf(vm, KRONOS_ERR_RUNTIME,
                         "Function 'dirname' requires a string argument");
     value_release(path_arg);
@@ -4174,7 +5181,7 @@ static int builtin_basename(KronosVM *vm, uint8_t arg_count) {
   KronosValue *path_arg;
 
   POP_OR_RETURN(vm, path_arg);
-  if (path_arg->type != VAL_STRING) {
+  if (value_type(path_arg) != VAL_STRING) {
     int err = vm_errorf(vm, KRONOS_ERR_RUNTIME,
                         "Function 'basename' requires a string argument");
     value_release(path_arg);
@@ -4195,7 +5202,6 @@ static int builtin_basename(KronosVM *vm, uint8_t arg_count) {
 
   // If no separator found, return entire path
   if (last_sep == path_len) {
-    value_retain(path_arg);
     PUSH_OR_RETURN_WITH_CLEANUP(vm, path_arg, value_release(path_arg););
     value_release(path_arg);
     return 0;
@@ -4226,7 +5232,8 @@ static int builtin_regex_match(KronosVM *vm, uint8_t arg_count) {
   KronosValue *string_arg;
 
   POP_OR_RETURN_WITH_CLEANUP(vm, string_arg, value_release(pattern_arg));
-  if (pattern_arg->type != VAL_STRING || string_arg->type != VAL_STRING) {
+  if (value_type(pattern_arg) != VAL_STRING ||
+      value_type(string_arg) != VAL_STRING) {
     int err = vm_errorf(vm, KRONOS_ERR_RUNTIME,
                         "Function 'regex.match' requires string arguments");
     value_release(pattern_arg);
@@ -4274,7 +5281,8 @@ static int builtin_regex_search(KronosVM *vm, uint8_t arg_count) {
   KronosValue *string_arg;
 
   POP_OR_RETURN_WITH_CLEANUP(vm, string_arg, value_release(pattern_arg));
-  if (pattern_arg->type != VAL_STRING || string_arg->type != VAL_STRING) {
+  if (value_type(pattern_arg) != VAL_STRING ||
+      value_type(string_arg) != VAL_STRING) {
     int err = vm_errorf(vm, KRONOS_ERR_RUNTIME,
                         "Function 'regex.search' requires string arguments");
     value_release(pattern_arg);
@@ -4338,7 +5346,8 @@ static int builtin_regex_findall(KronosVM *vm, uint8_t arg_count) {
   KronosValue *string_arg;
 
   POP_OR_RETURN_WITH_CLEANUP(vm, string_arg, value_release(pattern_arg));
-  if (pattern_arg->type != VAL_STRING || string_arg->type != VAL_STRING) {
+  if (value_type(pattern_arg) != VAL_STRING ||
+      value_type(string_arg) != VAL_STRING) {
     int err = vm_errorf(vm, KRONOS_ERR_RUNTIME,
                         "Function 'regex.findall' requires string arguments");
     value_release(pattern_arg);
@@ -4400,7 +5409,9 @@ static int builtin_regex_findall(KronosVM *vm, uint8_t arg_count) {
     if (result->as.list.count >= result->as.list.capacity) {
       size_t new_cap = result->as.list.capacity * 2;
       KronosValue **new_items =
-          realloc(result->as.list.items, sizeof(KronosValue *) * new_cap);
+          gc_realloc(result->as.list.items,
+                     result->as.list.capacity * sizeof(KronosValue *),
+                     sizeof(KronosValue *) * new_cap);
       if (!new_items) {
         value_release(match_val);
         regfree(&regex);
@@ -4494,26 +5505,218 @@ static const BuiltinEntry builtin_table[] = {
 static const size_t builtin_table_size =
     sizeof(builtin_table) / sizeof(builtin_table[0]);
 
-// Look up built-in function by name using binary search
-static BuiltinHandler find_builtin(const char *name) {
-  BuiltinEntry key = {name, NULL};
-  BuiltinEntry *result =
-      (BuiltinEntry *)bsearch(&key, builtin_table, builtin_table_size,
-                              sizeof(BuiltinEntry), builtin_compare);
-  return result ? result->handler : NULL;
+// Look up built-in function by name using binary search
+static BuiltinHandler find_builtin(const char *name) {
+  BuiltinEntry key = {name, NULL};
+  BuiltinEntry *result =
+      (BuiltinEntry *)bsearch(&key, builtin_table, builtin_table_size,
+                              sizeof(BuiltinEntry), builtin_compare);
+  return result ? result->handler : NULL;
+}
+
+static bool is_builtin_name(const char *name) {
+  return find_builtin(name) != NULL;
+}
+
+/**
+ * @brief Push a call frame for a user-defined function and enter its body
+ *
+ * The arguments are the top @p arg_count values of the caller's stack; they
+ * are moved (not copied or retained) into the callee's first slots, so a
+ * call only allocates when it is the first to reach its depth (or needs
+ * more slots than earlier calls there). @p arg_count must already match
+ * the function's parameter count.
+ *
+ * A tail call (OP_TAIL_CALL) made from a function reuses the caller's frame
+ * instead: the caller's locals are released and the frame is rebound to
+ * @p func with the caller's return address, so a chain of tail calls runs
+ * in one frame. Outside a function there is no frame to reuse and the call
+ * is made normally.
+ */
+static int call_user_function(KronosVM *vm, Function *func, uint8_t arg_count,
+                              bool tail) {
+  bool reuse_frame = tail && vm->call_stack_size > 0;
+  if (!func->bytecode.code) {
+    return vm_error(vm, KRONOS_ERR_INTERNAL,
+                    "Function bytecode is NULL (internal error)");
+  }
+  size_t stack_size = (size_t)(vm->stack_top - vm->stack);
+  if (stack_size < arg_count) {
+    return vm_errorf(
+        vm, KRONOS_ERR_RUNTIME,
+        "Stack underflow: function '%s' expects %d argument%s, but "
+        "only %zu value%s on stack",
+        func->name, arg_count, arg_count == 1 ? "" : "s", stack_size,
+        stack_size == 1 ? "" : "s");
+  }
+
+  CallFrame *frame;
+  if (reuse_frame) {
+    frame = &vm->call_stack[vm->call_stack_size - 1];
+    cleanup_call_frame_locals(frame);
+  } else {
+    int status = reserve_call_frame(vm, vm);
+    if (status != 0) {
+      return status;
+    }
+    frame = &vm->call_stack[vm->call_stack_size];
+  }
+  if (!init_call_frame_locals(frame, func)) {
+    return vm_error(vm, KRONOS_ERR_INTERNAL,
+                    "Failed to allocate function locals");
+  }
+  if (!reuse_frame) {
+    vm->call_stack_size++;
+    frame->return_ip = vm->ip;
+    frame->return_bytecode = vm->bytecode;
+  }
+  frame->function = func;
+
+  // The caller's argument window becomes the parameter slots; the frame
+  // takes over the stack's references
+  vm->stack_top -= arg_count;
+  KronosValue **args = vm->stack_top;
+  if (reuse_frame) {
+    // Nothing else of the finished call stays on the stack (compiled code
+    // leaves none; anything else is dropped)
+    vm->stack_top = frame->frame_start;
+    for (KronosValue **value = vm->stack_top; value < args; value++) {
+      value_release(*value);
+    }
+  }
+  for (size_t i = 0; i < arg_count; i++) {
+    frame->slots[i] = args[i];
+  }
+  frame->frame_start = vm->stack_top;
+  vm->current_frame = frame;
+
+  // Switch to function bytecode
+  vm->bytecode = &func->bytecode;
+  vm->ip = func->bytecode.code;
+
+  return 0;
 }
 
-static int handle_op_call_func(KronosVM *vm) {
-  KronosValue *name_val = read_constant(vm);
+/**
+ * @brief Pop call arguments and run a function defined in a loaded module
+ */
+static int call_module_target(KronosVM *vm, Module *mod, Function *mod_func,
+                              uint8_t arg_count) {
+  // Pop arguments from current VM
+  KronosValue **args = NULL;
+  if (arg_count > 0) {
+    args = malloc(sizeof(KronosValue *) * arg_count);
+    if (!args) {
+      return vm_error(vm, KRONOS_ERR_INTERNAL,
+                      "Failed to allocate argument buffer");
+    }
+
+    for (int i = arg_count - 1; i >= 0; i--) {
+      args[i] = pop(vm);
+      if (!args[i]) {
+        for (int j = i + 1; j < arg_count; j++) {
+          value_release(args[j]);
+        }
+        free(args);
+        return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
+      }
+    }
+  }
+
+  // Call the module function using helper
+  int result = call_module_function(vm, mod, mod_func, args, arg_count);
+  free(args);
+
+  if (result < 0) {
+    return result;
+  }
+
+  return 0; // Function call completed
+}
+
+// Resolved OP_CALL_FUNC target remembered per call site
+typedef enum {
+  CALL_TARGET_BUILTIN,
+  CALL_TARGET_FUNCTION,
+  CALL_TARGET_MODULE,
+} CallTargetKind;
+
+typedef struct CallSiteCache {
+  uint64_t epoch;          // KronosVM.call_epoch at fill time (0 = empty)
+  const KronosValue *name; // Callee name constant the entry was resolved for
+  union {
+    BuiltinHandler builtin;
+    Function *function; // User or module function
+  } target;
+  Module *module; // Owning module for CALL_TARGET_MODULE
+  uint8_t kind;
+  uint8_t arg_count;
+} CallSiteCache;
+
+// OP_CALL_FUNC is at least 4 bytes long, so two call sites in the same code are at
+// least 4 bytes apart and offset / 4 gives each its own entry
+#define CALL_SITE_STRIDE 4
+
+/**
+ * @brief Find the inline cache entry for the call site at @p offset
+ *
+ * Allocates the side table on first use; returns NULL if that fails (the
+ * call then simply resolves by name).
+ */
+static CallSiteCache *call_site_cache(Bytecode *bytecode, size_t offset) {
+  if (!bytecode->call_cache) {
+    bytecode->call_cache = calloc(bytecode->count / CALL_SITE_STRIDE + 1,
+                                  sizeof(CallSiteCache));
+    if (!bytecode->call_cache) {
+      return NULL;
+    }
+  }
+  return &bytecode->call_cache[offset / CALL_SITE_STRIDE];
+}
+
+/**
+ * @brief Resolve and call the function named by a call instruction
+ *
+ * Shared by OP_CALL_FUNC and OP_TAIL_CALL. Only a user function of this VM
+ * is tail called; built-ins and module functions run to completion and push
+ * their result, which the OP_RETURN_VAL that follows every OP_TAIL_CALL
+ * returns.
+ *
+ * @param wide The instruction is prefixed with OP_WIDE
+ */
+static int call_function_at_site(KronosVM *vm, bool tail, bool wide) {
+  // Dispatch already consumed the opcode byte
+  Bytecode *bytecode = vm->bytecode;
+  size_t site = (size_t)(vm->ip - 1 - bytecode->code);
+
+  KronosValue *name_val = read_constant(vm, wide);
   if (!name_val) {
     return vm_propagate_error(vm, KRONOS_ERR_INTERNAL);
   }
-  if (name_val->type != VAL_STRING) {
+  if (value_type(name_val) != VAL_STRING) {
     return vm_error(vm, KRONOS_ERR_INTERNAL,
                     "Function name constant is not a string");
   }
   uint8_t arg_count = read_byte(vm);
 
+  // Monomorphic fast path: same VM, no function defined since the entry was
+  // filled, same callee name and argument count
+  CallSiteCache *cache = call_site_cache(bytecode, site);
+  if (cache && cache->epoch == vm->call_epoch && cache->name == name_val &&
+      cache->arg_count == arg_count) {
+    vm->call_cache_hits++;
+    switch ((CallTargetKind)cache->kind) {
+    case CALL_TARGET_BUILTIN:
+      return cache->target.builtin(vm, arg_count);
+    case CALL_TARGET_FUNCTION:
+      return call_user_function(vm, cache->target.function, arg_count, tail);
+    case CALL_TARGET_MODULE:
+      return call_module_target(vm, cache->module, cache->target.function,
+                                arg_count);
+    }
+  }
+  vm->call_cache_misses++;
+
   // Check for built-in functions first
   const char *func_name = name_val->as.string.data;
 
@@ -4568,40 +5771,17 @@ static int handle_op_call_func(KronosVM *vm) {
           free(module_name);
           return err;
         }
-
-        // Pop arguments from current VM
-        KronosValue **args = NULL;
-        if (arg_count > 0) {
-          args = malloc(sizeof(KronosValue *) * arg_count);
-          if (!args) {
-            free(module_name);
-            return vm_error(vm, KRONOS_ERR_INTERNAL,
-                            "Failed to allocate argument buffer");
-          }
-
-          for (int i = arg_count - 1; i >= 0; i--) {
-            args[i] = pop(vm);
-            if (!args[i]) {
-              for (int j = i + 1; j < arg_count; j++) {
-                value_release(args[j]);
-              }
-              free(args);
-              free(module_name);
-              return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
-            }
-          }
-        }
-
-        // Call the module function using helper
-        int result = call_module_function(vm, mod, mod_func, args, arg_count);
-        free(args);
         free(module_name);
 
-        if (result < 0) {
-          return result;
+        if (cache) {
+          *cache = (CallSiteCache){.epoch = vm->call_epoch,
+                                   .name = name_val,
+                                   .target.function = mod_func,
+                                   .module = mod,
+                                   .kind = CALL_TARGET_MODULE,
+                                   .arg_count = arg_count};
         }
-
-        return 0; // Function call completed
+        return call_module_target(vm, mod, mod_func, arg_count);
       } else {
         int err = vm_errorf(vm, KRONOS_ERR_NOT_FOUND, "Unknown module '%s'",
                             module_name);
@@ -4614,6 +5794,13 @@ static int handle_op_call_func(KronosVM *vm) {
   // Try to find built-in function using dispatch table
   BuiltinHandler builtin = find_builtin(func_name);
   if (builtin) {
+    if (cache) {
+      *cache = (CallSiteCache){.epoch = vm->call_epoch,
+                               .name = name_val,
+                               .target.builtin = builtin,
+                               .kind = CALL_TARGET_BUILTIN,
+                               .arg_count = arg_count};
+    }
     return builtin(vm, arg_count);
   }
 
@@ -4631,156 +5818,22 @@ static int handle_op_call_func(KronosVM *vm) {
                      func->param_count == 1 ? "" : "s", arg_count);
   }
 
-  // Check call stack size
-  if (vm->call_stack_size >= CALL_STACK_MAX) {
-    return vm_error(vm, KRONOS_ERR_RUNTIME, "Maximum call depth exceeded");
-  }
-
-  // Create new call frame
-  CallFrame *frame = &vm->call_stack[vm->call_stack_size++];
-  frame->function = func;
-  frame->return_ip = vm->ip;
-  frame->return_bytecode = vm->bytecode;
-  frame->frame_start = vm->stack_top;
-  frame->local_count = 0;
-  // Initialize local variable hash table to all NULL
-  for (size_t i = 0; i < LOCALS_MAX; i++) {
-    frame->local_hash[i] = NULL;
-  }
-
-  // Validate stack has enough arguments before popping
-  // Check both stack size and that stack_top is valid
-  if (vm->stack_top < vm->stack) {
-    vm->call_stack_size--;
-    if (vm->call_stack_size > 0) {
-      vm->current_frame = &vm->call_stack[vm->call_stack_size - 1];
-    } else {
-      vm->current_frame = NULL;
-    }
-    return vm_errorf(vm, KRONOS_ERR_RUNTIME,
-                     "Stack pointer corruption: stack_top (%p) < stack (%p)",
-                     (void *)vm->stack_top, (void *)vm->stack);
-  }
-
-  size_t stack_size = vm->stack_top - vm->stack;
-
-  if (stack_size < arg_count) {
-    vm->call_stack_size--;
-    if (vm->call_stack_size > 0) {
-      vm->current_frame = &vm->call_stack[vm->call_stack_size - 1];
-    } else {
-      vm->current_frame = NULL;
-    }
-    return vm_errorf(
-        vm, KRONOS_ERR_RUNTIME,
-        "Stack underflow: function '%s' expects %d argument%s, but "
-        "only %zu value%s on stack",
-        func_name, arg_count, arg_count == 1 ? "" : "s", stack_size,
-        stack_size == 1 ? "" : "s");
-  }
-
-  // Pop arguments and bind to parameters (in reverse order)
-  KronosValue **args =
-      arg_count > 0 ? malloc(sizeof(KronosValue *) * arg_count) : NULL;
-  if (arg_count > 0 && !args) {
-    // Allocation failure: restore VM state and abort call setup
-    // Decrement call stack size to undo the increment above
-    vm->call_stack_size--;
-    if (vm->call_stack_size > 0) {
-      vm->current_frame = &vm->call_stack[vm->call_stack_size - 1];
-    } else {
-      vm->current_frame = NULL;
-    }
-    return vm_error(vm, KRONOS_ERR_INTERNAL,
-                    "Failed to allocate argument buffer");
-  }
-  for (int i = arg_count - 1; i >= 0; i--) {
-    // Double-check stack before each pop
-    if (vm->stack_top <= vm->stack) {
-      // Free already-popped arguments
-      for (size_t j = i + 1; j < arg_count; j++) {
-        value_release(args[j]);
-      }
-      free(args);
-      vm->call_stack_size--;
-      if (vm->call_stack_size > 0) {
-        vm->current_frame = &vm->call_stack[vm->call_stack_size - 1];
-      } else {
-        vm->current_frame = NULL;
-      }
-      return vm_errorf(vm, KRONOS_ERR_RUNTIME,
-                       "Stack underflow during pop: function '%s', "
-                       "expected %d args, popped %d, stack_size=%zu",
-                       func_name, arg_count, (int)(arg_count - i - 1),
-                       (size_t)(vm->stack_top - vm->stack));
-    }
-    args[i] = pop(vm);
-    if (!args[i]) {
-      // Free already-popped arguments
-      for (size_t j = i + 1; j < arg_count; j++) {
-        value_release(args[j]);
-      }
-      free(args);
-      vm->call_stack_size--;
-      if (vm->call_stack_size > 0) {
-        vm->current_frame = &vm->call_stack[vm->call_stack_size - 1];
-      } else {
-        vm->current_frame = NULL;
-      }
-      return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
-    }
-  }
-
-  // Set current frame before setting locals
-  vm->current_frame = frame;
-
-  // Set parameters as local variables in the new frame
-  // Parameters are mutable by default
-  for (size_t i = 0; i < arg_count; i++) {
-    int arg_status =
-        vm_set_local(vm, frame, func->params[i], args[i], true, NULL);
-    value_release(args[i]);
-    if (arg_status != 0) {
-      for (size_t j = i + 1; j < arg_count; j++) {
-        value_release(args[j]);
-      }
-      free(args);
-
-      for (size_t j = 0; j < frame->local_count; j++) {
-        free(frame->locals[j].name);
-        value_release(frame->locals[j].value);
-        free(frame->locals[j].type_name);
-      }
-      frame->local_count = 0;
-
-      vm->call_stack_size--;
-      if (vm->call_stack_size > 0) {
-        vm->current_frame = &vm->call_stack[vm->call_stack_size - 1];
-      } else {
-        vm->current_frame = NULL;
-      }
-      return arg_status;
-    }
-  }
-  free(args);
-
-  // Validate function bytecode before switching to it
-  if (!func->bytecode.code) {
-    vm->call_stack_size--;
-    if (vm->call_stack_size > 0) {
-      vm->current_frame = &vm->call_stack[vm->call_stack_size - 1];
-    } else {
-      vm->current_frame = NULL;
-    }
-    return vm_error(vm, KRONOS_ERR_INTERNAL,
-                    "Function bytecode is NULL (internal error)");
+  if (cache) {
+    *cache = (CallSiteCache){.epoch = vm->call_epoch,
+                             .name = name_val,
+                             .target.function = func,
+                             .kind = CALL_TARGET_FUNCTION,
+                             .arg_count = arg_count};
   }
+  return call_user_function(vm, func, arg_count, tail);
+}
 
-  // Switch to function bytecode
-  vm->bytecode = &func->bytecode;
-  vm->ip = func->bytecode.code;
+static int handle_op_call_func(KronosVM *vm) {
+  return call_function_at_site(vm, false, false);
+}
 
-  return 0;
+static int handle_op_tail_call(KronosVM *vm) {
+  return call_function_at_site(vm, true, false);
 }
 
 static int handle_op_range_new(KronosVM *vm) {
@@ -4797,8 +5850,8 @@ static int handle_op_range_new(KronosVM *vm) {
                              value_release(end_val));
 
   // All must be numbers
-  if (start_val->type != VAL_NUMBER || end_val->type != VAL_NUMBER ||
-      step_val->type != VAL_NUMBER) {
+  if (!value_is_number(start_val) || !value_is_number(end_val) ||
+      !value_is_number(step_val)) {
     value_release(start_val);
     value_release(end_val);
     value_release(step_val);
@@ -4806,8 +5859,9 @@ static int handle_op_range_new(KronosVM *vm) {
                     "Range start, end, and step must be numbers");
   }
 
-  KronosValue *range = value_new_range(start_val->as.number, end_val->as.number,
-                                       step_val->as.number);
+  KronosValue *range =
+      value_new_range(value_as_number(start_val), value_as_number(end_val),
+                      value_as_number(step_val));
   if (!range) {
     value_release(start_val);
     value_release(end_val);
@@ -4833,7 +5887,7 @@ static int handle_op_list_append(KronosVM *vm) {
 
   POP_OR_RETURN_WITH_CLEANUP(vm, list, value_release(value));
 
-  if (list->type != VAL_LIST) {
+  if (value_type(list) != VAL_LIST) {
     value_release(value);
     value_release(list);
     return vm_error(vm, KRONOS_ERR_RUNTIME, "Expected list for append");
@@ -4844,7 +5898,9 @@ static int handle_op_list_append(KronosVM *vm) {
     size_t new_capacity =
         list->as.list.capacity == 0 ? 4 : list->as.list.capacity * 2;
     KronosValue **new_items =
-        realloc(list->as.list.items, sizeof(KronosValue *) * new_capacity);
+        gc_realloc(list->as.list.items,
+                   list->as.list.capacity * sizeof(KronosValue *),
+                   sizeof(KronosValue *) * new_capacity);
     if (!new_items) {
       value_release(value);
       value_release(list);
@@ -4899,7 +5955,7 @@ static int handle_op_map_set(KronosVM *vm) {
   KronosValue *map;
   POP_OR_RETURN_WITH_CLEANUP(vm, map, value_release(key); value_release(value));
 
-  if (map->type != VAL_MAP) {
+  if (value_type(map) != VAL_MAP) {
     value_release(key);
     value_release(value);
     value_release(map);
@@ -4921,6 +5977,7 @@ static int handle_op_map_set(KronosVM *vm) {
 }
 
 static int handle_op_list_get(KronosVM *vm) {
+  maybe_quicken(vm, OP_LIST_GET);
   KronosValue *index_val;
 
   POP_OR_RETURN(vm, index_val);
@@ -4929,7 +5986,7 @@ static int handle_op_list_get(KronosVM *vm) {
   POP_OR_RETURN_WITH_CLEANUP(vm, container, value_release(index_val));
 
   // Handle maps first (they accept any key type)
-  if (container->type == VAL_MAP) {
+  if (value_type(container) == VAL_MAP) {
     KronosValue *value = map_get(container, index_val);
     if (!value) {
       value_release(index_val);
@@ -4947,16 +6004,16 @@ static int handle_op_list_get(KronosVM *vm) {
   }
 
   // For lists, strings, and ranges, index must be a number
-  if (index_val->type != VAL_NUMBER) {
+  if (!value_is_number(index_val)) {
     value_release(index_val);
     value_release(container);
     return vm_error(vm, KRONOS_ERR_RUNTIME, "Index must be a number");
   }
 
   // Handle negative indices
-  int64_t idx = (int64_t)index_val->as.number;
+  int64_t idx = (int64_t)value_as_number(index_val);
 
-  if (container->type == VAL_LIST) {
+  if (value_type(container) == VAL_LIST) {
     if (idx < 0) {
       idx = (int64_t)container->as.list.count + idx;
     }
@@ -4973,7 +6030,7 @@ static int handle_op_list_get(KronosVM *vm) {
                                 value_release(index_val);
                                 value_release(container););
     value_release(item);
-  } else if (container->type == VAL_RANGE) {
+  } else if (value_type(container) == VAL_RANGE) {
     // Calculate value at index: start + (index * step)
     double start = container->as.range.start;
     double step = container->as.range.step;
@@ -5023,7 +6080,7 @@ static int handle_op_list_get(KronosVM *vm) {
                                 value_release(index_val);
                                 value_release(container););
     value_release(result);
-  } else if (container->type == VAL_STRING) {
+  } else if (value_type(container) == VAL_STRING) {
     // String indexing
     if (idx < 0) {
       idx = (int64_t)container->as.string.length + idx;
@@ -5062,6 +6119,34 @@ static int handle_op_list_get(KronosVM *vm) {
   return 0;
 }
 
+static int handle_op_index_list(KronosVM *vm) {
+  KronosValue **top = vm->stack_top;
+  if (VM_UNLIKELY(top - vm->stack < 2 || value_type(top[-2]) != VAL_LIST ||
+                  !value_is_number(top[-1]))) {
+    dequicken_site(vm, vm->ip - 1, OP_LIST_GET);
+    return handle_op_list_get(vm);
+  }
+
+  KronosValue *list = top[-2];
+  int64_t idx = (int64_t)value_as_number(top[-1]);
+  if (idx < 0) {
+    idx = (int64_t)list->as.list.count + idx;
+  }
+  if (VM_UNLIKELY(idx < 0 || (size_t)idx >= list->as.list.count)) {
+    // Still a list access: the generic handler reports the error
+    return handle_op_list_get(vm);
+  }
+
+  // Retain the item before the list can be freed
+  KronosValue *item = list->as.list.items[(size_t)idx];
+  value_retain(item);
+  value_release(top[-1]);
+  value_release(list);
+  top[-2] = item;
+  vm->stack_top = top - 1;
+  return 0;
+}
+
 static int handle_op_list_set(KronosVM *vm) {
   // Stack: [list, index, value]
   KronosValue *value;
@@ -5074,7 +6159,7 @@ static int handle_op_list_set(KronosVM *vm) {
   POP_OR_RETURN_WITH_CLEANUP(vm, list, value_release(index_val);
                              value_release(value));
 
-  if (list->type != VAL_LIST) {
+  if (value_type(list) != VAL_LIST) {
     value_release(index_val);
     value_release(value);
     value_release(list);
@@ -5082,7 +6167,7 @@ static int handle_op_list_set(KronosVM *vm) {
                     "Expected list for index assignment");
   }
 
-  if (index_val->type != VAL_NUMBER) {
+  if (!value_is_number(index_val)) {
     value_release(index_val);
     value_release(value);
     value_release(list);
@@ -5090,7 +6175,7 @@ static int handle_op_list_set(KronosVM *vm) {
   }
 
   // Handle negative indices
-  int64_t idx = (int64_t)index_val->as.number;
+  int64_t idx = (int64_t)value_as_number(index_val);
   if (idx < 0) {
     idx = (int64_t)list->as.list.count + idx;
   }
@@ -5125,7 +6210,7 @@ static int handle_op_delete(KronosVM *vm) {
 
   POP_OR_RETURN_WITH_CLEANUP(vm, map, value_release(key));
 
-  if (map->type != VAL_MAP) {
+  if (value_type(map) != VAL_MAP) {
     value_release(key);
     value_release(map);
     return vm_error(vm, KRONOS_ERR_RUNTIME,
@@ -5150,17 +6235,17 @@ static int handle_op_list_len(KronosVM *vm) {
 
   POP_OR_RETURN(vm, container);
 
-  if (container->type == VAL_LIST) {
+  if (value_type(container) == VAL_LIST) {
     KronosValue *len = value_new_number((double)container->as.list.count);
     PUSH_OR_RETURN_WITH_CLEANUP(vm, len, value_release(len);
                                 value_release(container););
     value_release(len);
-  } else if (container->type == VAL_STRING) {
+  } else if (value_type(container) == VAL_STRING) {
     KronosValue *len = value_new_number((double)container->as.string.length);
     PUSH_OR_RETURN_WITH_CLEANUP(vm, len, value_release(len);
                                 value_release(container););
     value_release(len);
-  } else if (container->type == VAL_RANGE) {
+  } else if (value_type(container) == VAL_RANGE) {
     // Calculate range length: number of values in range
     double start = container->as.range.start;
     double end = container->as.range.end;
@@ -5205,17 +6290,17 @@ static int handle_op_list_slice(KronosVM *vm) {
   POP_OR_RETURN_WITH_CLEANUP(vm, container, value_release(start_val);
                              value_release(end_val));
 
-  if (start_val->type != VAL_NUMBER || end_val->type != VAL_NUMBER) {
+  if (!value_is_number(start_val) || !value_is_number(end_val)) {
     value_release(container);
     value_release(start_val);
     value_release(end_val);
     return vm_error(vm, KRONOS_ERR_RUNTIME, "Slice indices must be numbers");
   }
 
-  int64_t start = (int64_t)start_val->as.number;
-  int64_t end = (int64_t)end_val->as.number;
+  int64_t start = (int64_t)value_as_number(start_val);
+  int64_t end = (int64_t)value_as_number(end_val);
 
-  if (container->type == VAL_LIST) {
+  if (value_type(container) == VAL_LIST) {
     size_t len = container->as.list.count;
 
     // Handle negative indices
@@ -5263,7 +6348,7 @@ static int handle_op_list_slice(KronosVM *vm) {
         vm, slice, value_release(slice); value_release(container);
         value_release(start_val); value_release(end_val););
     value_release(slice);
-  } else if (container->type == VAL_STRING) {
+  } else if (value_type(container) == VAL_STRING) {
     size_t len = container->as.string.length;
 
     // Handle negative indices
@@ -5318,7 +6403,7 @@ static int handle_op_list_slice(KronosVM *vm) {
         vm, slice, value_release(slice); value_release(container);
         value_release(start_val); value_release(end_val););
     value_release(slice);
-  } else if (container->type == VAL_RANGE) {
+  } else if (value_type(container) == VAL_RANGE) {
     // Range slicing: create a new range with adjusted start/end
     double orig_start = container->as.range.start;
     double orig_end = container->as.range.end;
@@ -5329,7 +6414,7 @@ static int handle_op_list_slice(KronosVM *vm) {
     double new_end = orig_start + (end * step);
 
     // For negative end, use original end
-    if (end_val->as.number == -1.0) {
+    if (value_as_number(end_val) == -1.0) {
       new_end = orig_end;
     }
 
@@ -5380,237 +6465,263 @@ static int handle_op_list_slice(KronosVM *vm) {
   return 0;
 }
 
-static int handle_op_list_iter(KronosVM *vm) {
-  KronosValue *iterable;
+/**
+ * @brief Iterator slot of the for-in loop at @p depth
+ *
+ * Like range loops, function code keeps its iterators in the current frame
+ * and top-level code in the VM. @p live receives the matching live mask.
+ */
+static inline IteratorState *iterator_state(KronosVM *vm, uint8_t depth,
+                                            uint32_t **live) {
+  if (depth >= ITER_LOOP_DEPTH_MAX) {
+    vm_errorf(vm, KRONOS_ERR_INTERNAL, "Iterator depth %u out of range",
+              depth);
+    return NULL;
+  }
+  CallFrame *frame = vm->current_frame;
+  if (!frame) {
+    *live = &vm->live_iterators;
+    return &vm->iterators[depth];
+  }
+  if (VM_UNLIKELY(!frame->iterators)) {
+    frame->iterators = calloc(ITER_LOOP_DEPTH_MAX, sizeof(IteratorState));
+    if (!frame->iterators) {
+      vm_error(vm, KRONOS_ERR_INTERNAL, "Failed to allocate loop state");
+      return NULL;
+    }
+  }
+  *live = &frame->live_iterators;
+  return &frame->iterators[depth];
+}
 
-  POP_OR_RETURN(vm, iterable);
+/**
+ * @brief Byte length of the UTF-8 sequence starting with @p lead
+ *
+ * Continuation or invalid lead bytes count as one byte, so malformed text
+ * still advances.
+ */
+static inline size_t utf8_sequence_length(unsigned char lead) {
+  if (lead < 0xC0) {
+    return 1;
+  }
+  if (lead < 0xE0) {
+    return 2;
+  }
+  if (lead < 0xF0) {
+    return 3;
+  }
+  return lead < 0xF8 ? 4 : 1;
+}
 
-  if (iterable->type == VAL_LIST) {
-    // Create iterator (just push the list and current index)
-    // Push list back to stack, then push index 0
-    PUSH_OR_RETURN_WITH_CLEANUP(vm, iterable, value_release(iterable););
-    KronosValue *index = value_new_number(0);
-    PUSH_OR_RETURN_WITH_CLEANUP(vm, index, value_release(index);
-                                value_release(iterable););
-    value_release(index);
-    value_release(iterable); // Release our pop reference
-  } else if (iterable->type == VAL_RANGE) {
-    // For ranges, push the range and current value (start)
-    PUSH_OR_RETURN_WITH_CLEANUP(vm, iterable, value_release(iterable););
-    KronosValue *current = value_new_number(iterable->as.range.start);
-    PUSH_OR_RETURN_WITH_CLEANUP(vm, current, value_release(current);
-                                value_release(iterable););
-    value_release(current);
-    value_release(iterable); // Release our pop reference
-  } else {
-    value_release(iterable);
-    return vm_error(vm, KRONOS_ERR_RUNTIME,
-                    "Expected list or range for iteration");
+/**
+ * @brief Push the next item of an iterator and advance it
+ *
+ * Lists yield their items (re-reading the count, so appends made by the body
+ * are visited), ranges their values with the end exclusive, strings one
+ * UTF-8 character at a time and maps their keys, or key then value when
+ * iterating pairs. Nothing is allocated for lists, maps and ranges.
+ *
+ * @return 1 if an item was pushed, 0 if the iterator is exhausted, -1 on
+ * error
+ */
+static int iterator_push_next(KronosVM *vm, IteratorState *it) {
+  KronosValue *container = it->container;
+  switch (value_type(container)) {
+  case VAL_LIST:
+    if (it->cursor >= container->as.list.count) {
+      return 0;
+    }
+    return push(vm, container->as.list.items[it->cursor++]) == 0 ? 1 : -1;
+  case VAL_RANGE: {
+    double step = container->as.range.step;
+    bool has_more = step > 0   ? it->range_next < container->as.range.end
+                    : step < 0 ? it->range_next > container->as.range.end
+                               : it->cursor == 0; // Zero step: start only
+    if (!has_more) {
+      return 0;
+    }
+    KronosValue *value = value_new_number(it->range_next);
+    it->range_next += step;
+    it->cursor++;
+    int status = push(vm, value);
+    value_release(value);
+    return status == 0 ? 1 : -1;
+  }
+  case VAL_STRING: {
+    size_t length = container->as.string.length;
+    if (it->cursor >= length) {
+      return 0;
+    }
+    const char *data = container->as.string.data + it->cursor;
+    size_t char_len = utf8_sequence_length((unsigned char)data[0]);
+    if (char_len > length - it->cursor) {
+      char_len = length - it->cursor;
+    }
+    it->cursor += char_len;
+    KronosValue *character = value_new_string(data, char_len);
+    if (!character) {
+      vm_error(vm, KRONOS_ERR_INTERNAL, "Failed to allocate string character");
+      return -1;
+    }
+    int status = push(vm, character);
+    value_release(character);
+    return status == 0 ? 1 : -1;
+  }
+  case VAL_MAP:
+    // Re-read the table each step: the body may grow or rehash the map
+    while (it->cursor < container->as.map.capacity) {
+      size_t i = it->cursor++;
+      if (!container->as.map.entries[i].key ||
+          container->as.map.entries[i].is_tombstone) {
+        continue;
+      }
+      KronosValue *value = container->as.map.entries[i].value;
+      if (push(vm, container->as.map.entries[i].key) != 0 ||
+          (it->pairs && push(vm, value) != 0)) {
+        return -1;
+      }
+      return 1;
+    }
+    return 0;
+  default:
+    vm_error(vm, KRONOS_ERR_INTERNAL, "Invalid iterator container");
+    return -1;
   }
-  return 0;
 }
 
-static int handle_op_list_next(KronosVM *vm) {
-  // Stack: [iterable, state] (iterable on bottom, state on top)
-  // For lists: state is index (number)
-  // For ranges: state is current value (number)
-  // Verify stack has at least 2 items before popping
-  size_t stack_depth = (size_t)(vm->stack_top - vm->stack);
-  if (stack_depth < 2) {
-    return vm_errorf(
-        vm, KRONOS_ERR_RUNTIME,
-        "Stack underflow in iteration: expected 2 items, got %zu. "
-        "This usually means iterator variables were not loaded correctly.",
-        stack_depth);
+static VM_ALWAYS_INLINE int exec_iter_prep(KronosVM *vm, bool wide) {
+  uint8_t depth = read_byte(vm);
+  bool pairs = read_byte(vm) != 0;
+  uint32_t exit_offset = read_operand(vm, wide);
+  if (vm->last_error_message) {
+    return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
+  }
+  uint32_t *live;
+  IteratorState *it = iterator_state(vm, depth, &live);
+  if (!it) {
+    return vm_propagate_error(vm, KRONOS_ERR_INTERNAL);
   }
-  KronosValue *state_val;
 
-  POP_OR_RETURN(vm, state_val);
   KronosValue *iterable;
+  POP_OR_RETURN(vm, iterable);
+  if (value_type(iterable) != VAL_LIST && value_type(iterable) != VAL_RANGE &&
+      value_type(iterable) != VAL_STRING && value_type(iterable) != VAL_MAP) {
+    value_release(iterable);
+    return vm_error(vm, KRONOS_ERR_RUNTIME,
+                    "Expected list, range, string or map for iteration");
+  }
+  if (pairs && value_type(iterable) != VAL_MAP) {
+    value_release(iterable);
+    return vm_error(vm, KRONOS_ERR_RUNTIME,
+                    "Only maps can be iterated with two loop variables");
+  }
 
-  POP_OR_RETURN_WITH_CLEANUP(vm, iterable, value_release(state_val));
+  // A loop left by an exception may still hold this slot
+  uint32_t bit = UINT32_C(1) << depth;
+  if (*live & bit) {
+    value_release(it->container);
+  }
+  // The slot takes over the popped reference
+  *it = (IteratorState){.container = iterable,
+                        .cursor = 0,
+                        .range_next = value_type(iterable) == VAL_RANGE
+                                          ? iterable->as.range.start
+                                          : 0,
+                        .pairs = pairs};
+  *live |= bit;
 
-  if (iterable->type == VAL_LIST) {
-    if (state_val->type != VAL_NUMBER) {
-      value_release(state_val);
-      value_release(iterable);
-      return vm_error(vm, KRONOS_ERR_RUNTIME, "Invalid iterator state");
+  int status = iterator_push_next(vm, it);
+  if (status < 0) {
+    return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
+  }
+  if (status == 0) {
+    // Empty: skip the body, straight to OP_ITER_CLOSE
+    uint8_t *new_ip = vm->ip + exit_offset;
+    if (new_ip >= vm->bytecode->code + vm->bytecode->count) {
+      return vm_errorf(
+          vm, KRONOS_ERR_RUNTIME,
+          "Jump target out of bounds (offset: %u, bytecode size: %zu)",
+          exit_offset, vm->bytecode->count);
     }
+    vm->ip = new_ip;
+  }
+  return 0;
+}
 
-    size_t idx = (size_t)state_val->as.number;
-    bool has_more = idx < iterable->as.list.count;
-
-    if (has_more) {
-      // Push in order: [list, index+1, item, has_more]
-      // This way, after popping has_more, item is on top for OP_STORE_VAR
-      // After storing item, we have [list, index+1] for next iteration
-
-      // Push list first (bottom of stack)
-      value_retain(iterable);
-      PUSH_OR_RETURN_WITH_CLEANUP(vm, iterable, value_release(iterable);
-                                  value_release(state_val););
-      value_release(iterable);
+static int handle_op_iter_prep(KronosVM *vm) {
+  return exec_iter_prep(vm, false);
+}
 
-      // Update and push index
-      KronosValue *next_index = value_new_number((double)(idx + 1));
-      PUSH_OR_RETURN_WITH_CLEANUP(vm, next_index, value_release(next_index);
-                                  value_release(state_val););
-      value_release(next_index);
+static VM_ALWAYS_INLINE int exec_iter_next(KronosVM *vm, bool wide) {
+  uint8_t depth = read_byte(vm);
+  int32_t back_offset = read_offset(vm, wide);
+  if (vm->last_error_message) {
+    return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
+  }
+  uint32_t *live;
+  IteratorState *it = iterator_state(vm, depth, &live);
+  if (!it) {
+    return vm_propagate_error(vm, KRONOS_ERR_INTERNAL);
+  }
+  if (!(*live & (UINT32_C(1) << depth))) {
+    return vm_error(vm, KRONOS_ERR_INTERNAL, "Iterator used before start");
+  }
 
-      // Push current item
-      KronosValue *item = iterable->as.list.items[idx];
-      value_retain(item);
-      PUSH_OR_RETURN_WITH_CLEANUP(vm, item, value_release(item);
-                                  value_release(state_val););
-      value_release(item);
-
-      // Push has_more flag
-      KronosValue *has_more_val = value_new_bool(true);
-      PUSH_OR_RETURN_WITH_CLEANUP(vm, has_more_val, value_release(has_more_val);
-                                  value_release(state_val););
-      value_release(has_more_val);
-
-      // Release our popped references (values are now on stack)
-      value_release(state_val);
-      value_release(iterable);
-    } else {
-      // No more items - push list and index back for cleanup, then has_more =
-      // false Stack should be: [list, index, has_more=false] for cleanup code
-      // Push list first (bottom of stack)
-      value_retain(iterable);
-      PUSH_OR_RETURN_WITH_CLEANUP(vm, iterable, value_release(iterable);
-                                  value_release(state_val););
-      value_release(iterable);
-
-      // Push index back
-      value_retain(state_val);
-      PUSH_OR_RETURN_WITH_CLEANUP(vm, state_val, value_release(state_val););
-      value_release(state_val);
-
-      // Push has_more = false
-      KronosValue *has_more_val = value_new_bool(false);
-      PUSH_OR_RETURN_WITH_CLEANUP(vm, has_more_val,
-                                  value_release(has_more_val););
-      value_release(has_more_val);
-
-      // Release our popped references (values are now on stack)
-      // Note: we retained before pushing and released after, so the only
-      // remaining refs are the pop refs which we release here
-      value_release(state_val);
-      value_release(iterable);
-    }
-  } else if (iterable->type == VAL_RANGE) {
-    if (state_val->type != VAL_NUMBER) {
-      value_release(state_val);
-      value_release(iterable);
-      return vm_error(vm, KRONOS_ERR_RUNTIME, "Invalid iterator state");
-    }
-
-    double current = state_val->as.number;
-    double start = iterable->as.range.start;
-    double end = iterable->as.range.end;
-    double step = iterable->as.range.step;
-
-    // Check if we've reached the end
-    bool has_more = false;
-    if (step > 0) {
-      has_more = (current < end) || (current == start && start < end);
-    } else if (step < 0) {
-      has_more = (current > end) || (current == start && start > end);
-    } else {
-      // step == 0: only one value (start)
-      has_more = (current == start);
-    }
-
-    if (has_more) {
-      // Push in order: [range, next_value, current_value, has_more]
-      // Push range back - push will retain it
-      PUSH_OR_RETURN_WITH_CLEANUP(vm, iterable, value_release(state_val););
-
-      // Calculate and push next value
-      double next = current + step;
-      KronosValue *next_val = value_new_number(next);
-      PUSH_OR_RETURN_WITH_CLEANUP(vm, next_val, value_release(next_val);
-                                  value_release(iterable);
-                                  value_release(state_val););
-      value_release(next_val);
-
-      // Push current value (the item)
-      KronosValue *current_val = value_new_number(current);
-      PUSH_OR_RETURN_WITH_CLEANUP(vm, current_val, value_release(current_val);
-                                  value_release(iterable);
-                                  value_release(state_val););
-      value_release(current_val);
-
-      // Push has_more flag
-      KronosValue *has_more_val = value_new_bool(true);
-      PUSH_OR_RETURN_WITH_CLEANUP(vm, has_more_val, value_release(has_more_val);
-                                  value_release(iterable);
-                                  value_release(state_val););
-      value_release(has_more_val);
-
-      // Release our popped references (range is now on stack)
-      value_release(state_val);
-      value_release(iterable);
-    } else {
-      // No more items - push range and state back for cleanup, then has_more =
-      // false Stack should be: [range, state, has_more=false] for cleanup code
-      // Push range first (bottom of stack)
-      value_retain(iterable);
-      PUSH_OR_RETURN_WITH_CLEANUP(vm, iterable, value_release(iterable);
-                                  value_release(state_val););
-      value_release(iterable);
-
-      // Push state back
-      value_retain(state_val);
-      PUSH_OR_RETURN_WITH_CLEANUP(vm, state_val, value_release(state_val););
-      value_release(state_val);
-
-      // Push has_more = false
-      KronosValue *has_more_val = value_new_bool(false);
-      PUSH_OR_RETURN_WITH_CLEANUP(vm, has_more_val,
-                                  value_release(has_more_val););
-      value_release(has_more_val);
-
-      // Release our popped references (values are now on stack)
-      value_release(state_val);
-      value_release(iterable);
+  int status = iterator_push_next(vm, it);
+  if (status < 0) {
+    return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
+  }
+  if (status > 0) {
+    uint8_t *new_ip = vm->ip + back_offset;
+    if (new_ip < vm->bytecode->code ||
+        new_ip >= vm->bytecode->code + vm->bytecode->count) {
+      return vm_errorf(
+          vm, KRONOS_ERR_RUNTIME,
+          "Jump target out of bounds (offset: %d, bytecode size: %zu)",
+          back_offset, vm->bytecode->count);
     }
-  } else {
-    value_release(state_val);
-    value_release(iterable);
-    return vm_error(vm, KRONOS_ERR_RUNTIME, "Invalid iterable type");
+    vm->ip = new_ip;
   }
-
   return 0;
 }
 
-static int handle_op_try_enter(KronosVM *vm) {
-  // Save the IP before reading the offset bytes
-  // vm->ip currently points to the first offset byte (try_start_pos)
-  uint8_t *try_start_pos = vm->ip;
+static int handle_op_iter_next(KronosVM *vm) {
+  return exec_iter_next(vm, false);
+}
 
-  // Read exception handler offset
-  uint8_t high = read_byte(vm);
+static int handle_op_iter_close(KronosVM *vm) {
+  uint8_t depth = read_byte(vm);
   if (vm->last_error_message) {
     return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
   }
-  uint8_t low = read_byte(vm);
+  uint32_t *live;
+  IteratorState *it = iterator_state(vm, depth, &live);
+  if (!it) {
+    return vm_propagate_error(vm, KRONOS_ERR_INTERNAL);
+  }
+  uint32_t bit = UINT32_C(1) << depth;
+  if (*live & bit) {
+    value_release(it->container);
+    it->container = NULL;
+    *live &= ~bit;
+  }
+  return 0;
+}
+
+static VM_ALWAYS_INLINE int exec_try_enter(KronosVM *vm, bool wide) {
+  // Read exception handler offset
+  uint32_t handler_offset = read_operand(vm, wide);
   if (vm->last_error_message) {
     return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
   }
-  uint16_t handler_offset = (uint16_t)(high << 8 | low);
 
   if (vm->exception_handler_count >= EXCEPTION_HANDLERS_MAX) {
     return vm_error(vm, KRONOS_ERR_RUNTIME, "Too many nested try blocks");
   }
 
-  // Validate handler offset is within bytecode bounds
-  // The compiler calculates: handler_offset = exception_handler_pos -
-  // (try_start_pos + 2) So exception_handler_pos = try_start_pos + 2 +
-  // handler_offset try_start_pos points to the first offset byte (after
-  // OP_TRY_ENTER)
-  uint8_t *handler_ip = try_start_pos + 2 + handler_offset;
+  // Validate handler offset is within bytecode bounds; like every jump
+  // offset it is relative to the end of the operand
+  uint8_t *handler_ip = vm->ip + handler_offset;
   if (handler_ip < vm->bytecode->code ||
       handler_ip >= vm->bytecode->code + vm->bytecode->count) {
     return vm_errorf(vm, KRONOS_ERR_RUNTIME,
@@ -5633,17 +6744,16 @@ static int handle_op_try_enter(KronosVM *vm) {
   return 0;
 }
 
-static int handle_op_try_exit(KronosVM *vm) {
+static int handle_op_try_enter(KronosVM *vm) {
+  return exec_try_enter(vm, false);
+}
+
+static VM_ALWAYS_INLINE int exec_try_exit(KronosVM *vm, bool wide) {
   // Normal completion of try block - read finally jump offset
-  uint8_t high = read_byte(vm);
-  if (vm->last_error_message) {
-    return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
-  }
-  uint8_t low = read_byte(vm);
+  uint32_t finally_offset = read_operand(vm, wide);
   if (vm->last_error_message) {
     return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
   }
-  uint16_t finally_offset = (uint16_t)(high << 8 | low);
 
   if (vm->exception_handler_count == 0) {
     return vm_error(vm, KRONOS_ERR_INTERNAL,
@@ -5661,8 +6771,12 @@ static int handle_op_try_exit(KronosVM *vm) {
   return 0;
 }
 
-static int handle_op_catch(KronosVM *vm) {
-  // Read error type constant (0xFFFF means catch all)
+static int handle_op_try_exit(KronosVM *vm) {
+  return exec_try_exit(vm, false);
+}
+
+static VM_ALWAYS_INLINE int exec_catch(KronosVM *vm, bool wide) {
+  // Read error type constant (absent means catch all)
   // Save the current error state - we're handling an exception, so errors from
   // OP_THROW are expected and shouldn't prevent reading operands
   bool had_error = (vm->last_error_code != KRONOS_OK);
@@ -5675,16 +6789,16 @@ static int handle_op_catch(KronosVM *vm) {
   // Temporarily clear error to allow reading operands
   vm_clear_error(vm);
 
-  uint16_t error_type_idx = read_uint16(vm);
-  // Check for error from read_uint16 (shouldn't happen now)
+  uint32_t error_type_idx = read_operand(vm, wide);
+  // Check for error from the operand read (shouldn't happen now)
   if (vm->last_error_message) {
     free(saved_error_msg);
     free(saved_error_type);
     return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
   }
-  // Read catch variable name constant (0xFFFF means no variable)
-  uint16_t catch_var_idx = read_uint16(vm);
-  // Check for error from read_uint16 (shouldn't happen now)
+  // Read catch variable name constant (absent means no variable)
+  uint32_t catch_var_idx = read_operand(vm, wide);
+  // Check for error from the operand read (shouldn't happen now)
   if (vm->last_error_message) {
     free(saved_error_msg);
     free(saved_error_type);
@@ -5723,12 +6837,12 @@ static int handle_op_catch(KronosVM *vm) {
 
     // Check if this catch block matches
     bool matches = false;
-    if (error_type_idx == 0xFFFF) {
+    if (error_type_idx == no_constant(wide)) {
       // Catch all
       matches = true;
     } else if (error_type_idx < vm->bytecode->const_count) {
       KronosValue *type_val = vm->bytecode->constants[error_type_idx];
-      if (type_val && type_val->type == VAL_STRING) {
+      if (type_val && value_type(type_val) == VAL_STRING) {
         if (strcmp(type_val->as.string.data, current_error_type) == 0) {
           matches = true;
         }
@@ -5763,6 +6877,8 @@ static int handle_op_catch(KronosVM *vm) {
   return 0;
 }
 
+static int handle_op_catch(KronosVM *vm) { return exec_catch(vm, false); }
+
 static int handle_op_finally(KronosVM *vm) {
   if (vm->exception_handler_count == 0) {
     return vm_error(vm, KRONOS_ERR_INTERNAL,
@@ -5777,10 +6893,10 @@ static int handle_op_finally(KronosVM *vm) {
   return 0;
 }
 
-static int handle_op_throw(KronosVM *vm) {
-  // Read error type constant (0xFFFF means generic Error)
-  uint16_t error_type_idx = read_uint16(vm);
-  // Check for error from read_uint16
+static VM_ALWAYS_INLINE int exec_throw(KronosVM *vm, bool wide) {
+  // Read error type constant (absent means generic Error)
+  uint32_t error_type_idx = read_operand(vm, wide);
+  // Check for error from the operand read
   if (vm->last_error_message) {
     return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
   }
@@ -5792,15 +6908,16 @@ static int handle_op_throw(KronosVM *vm) {
 
   // Get error message as string
   const char *message = "Unknown error";
-  if (message_val->type == VAL_STRING) {
+  if (value_type(message_val) == VAL_STRING) {
     message = message_val->as.string.data;
   }
 
   // Get error type name
   const char *type_name = "Error";
-  if (error_type_idx != 0xFFFF && error_type_idx < vm->bytecode->const_count) {
+  if (error_type_idx != no_constant(wide) &&
+      error_type_idx < vm->bytecode->const_count) {
     KronosValue *type_val = vm->bytecode->constants[error_type_idx];
-    if (type_val && type_val->type == VAL_STRING) {
+    if (type_val && value_type(type_val) == VAL_STRING) {
       type_name = type_val->as.string.data;
     }
   }
@@ -5813,16 +6930,18 @@ static int handle_op_throw(KronosVM *vm) {
   return 0;
 }
 
-static int handle_op_import(KronosVM *vm) {
+static int handle_op_throw(KronosVM *vm) { return exec_throw(vm, false); }
+
+static VM_ALWAYS_INLINE int exec_import(KronosVM *vm, bool wide) {
   // Read constant indices for module name and file path (in order of
   // emission)
-  uint16_t module_name_idx = read_uint16(vm);
-  // Check for error from read_uint16
+  uint32_t module_name_idx = read_operand(vm, wide);
+  // Check for error from the operand read
   if (vm->last_error_message) {
     return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
   }
-  uint16_t file_path_idx = read_uint16(vm);
-  // Check for error from read_uint16
+  uint32_t file_path_idx = read_operand(vm, wide);
+  // Check for error from the operand read
   if (vm->last_error_message) {
     return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
   }
@@ -5847,18 +6966,18 @@ static int handle_op_import(KronosVM *vm) {
                      module_name_idx, file_path_idx);
   }
 
-  if (module_name_val->type != VAL_STRING) {
+  if (value_type(module_name_val) != VAL_STRING) {
     return vm_errorf(vm, KRONOS_ERR_INTERNAL,
                      "Module name must be a string, got type %d",
-                     module_name_val->type);
+                     value_type(module_name_val));
   }
 
   const char *module_name = module_name_val->as.string.data;
   const char *file_path = NULL;
 
   // If file_path is not null, it's a file-based import
-  if (file_path_val->type != VAL_NIL) {
-    if (file_path_val->type != VAL_STRING) {
+  if (value_type(file_path_val) != VAL_NIL) {
+    if (value_type(file_path_val) != VAL_STRING) {
       return vm_error(vm, KRONOS_ERR_INTERNAL,
                       "File path must be a string or null");
     }
@@ -5887,7 +7006,168 @@ static int handle_op_import(KronosVM *vm) {
   return 0;
 }
 
-static int handle_op_define_func(KronosVM *vm) {
+static int handle_op_import(KronosVM *vm) { return exec_import(vm, false); }
+
+/**
+ * @brief Grow a range loop state array to hold the loop at @p depth
+ *
+ * Doubles the capacity (at least RANGE_LOOPS_INITIAL_CAPACITY), so a loop
+ * nest costs one allocation per frame in the common case. PREP initializes
+ * a slot before it is read, so new entries are left uninitialized.
+ *
+ * @return false if out of memory (error set)
+ */
+static bool grow_range_loops(KronosVM *vm, RangeLoopState **loops,
+                             size_t *capacity, uint8_t depth) {
+  size_t new_capacity = *capacity ? *capacity * 2 : RANGE_LOOPS_INITIAL_CAPACITY;
+  if (new_capacity <= depth) {
+    new_capacity = (size_t)depth + 1;
+  }
+  if (new_capacity > RANGE_LOOP_DEPTH_MAX) {
+    new_capacity = RANGE_LOOP_DEPTH_MAX;
+  }
+  RangeLoopState *grown = realloc(*loops, new_capacity * sizeof(RangeLoopState));
+  if (!grown) {
+    vm_error(vm, KRONOS_ERR_INTERNAL, "Failed to allocate loop state");
+    return false;
+  }
+  *loops = grown;
+  *capacity = new_capacity;
+  return true;
+}
+
+/**
+ * @brief Unboxed state slot of the range loop at @p depth
+ *
+ * Function code keeps its loops in the current frame, so recursion and
+ * exceptions unwinding through a loop need no cleanup; top-level code uses
+ * the VM's own array. Both grow with the nesting depth of the loops run.
+ */
+static inline RangeLoopState *range_loop_state(KronosVM *vm, uint8_t depth) {
+  CallFrame *frame = vm->current_frame;
+  RangeLoopState **loops = frame ? &frame->range_loops : &vm->range_loops;
+  size_t *capacity =
+      frame ? &frame->range_loop_capacity : &vm->range_loop_capacity;
+  if (VM_UNLIKELY(depth >= *capacity) &&
+      !grow_range_loops(vm, loops, capacity, depth)) {
+    return NULL;
+  }
+  return &(*loops)[depth];
+}
+
+/**
+ * @brief Whether a range loop with @p state runs another iteration
+ *
+ * Non-negative steps count up to end inclusive, negative steps count down.
+ */
+static inline bool range_loop_continues(const RangeLoopState *state) {
+  return state->step < 0 ? state->counter >= state->end
+                         : state->counter <= state->end;
+}
+
+/**
+ * @brief Push the counter of a range loop as the loop variable's value
+ */
+static inline int push_range_counter(KronosVM *vm,
+                                     const RangeLoopState *state) {
+  KronosValue *value = value_new_number(state->counter);
+  PUSH_OR_RETURN_WITH_CLEANUP(vm, value, value_release(value));
+  value_release(value);
+  return 0;
+}
+
+static VM_ALWAYS_INLINE int exec_for_range_prep(KronosVM *vm, bool wide) {
+  uint8_t depth = read_byte(vm);
+  uint32_t exit_offset = read_operand(vm, wide);
+  if (vm->last_error_message) {
+    return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
+  }
+  RangeLoopState *state = range_loop_state(vm, depth);
+  if (!state) {
+    return vm_propagate_error(vm, KRONOS_ERR_INTERNAL);
+  }
+
+  // Start, end and step are evaluated once, before the first iteration
+  KronosValue *step;
+  POP_OR_RETURN(vm, step);
+  KronosValue *end;
+  POP_OR_RETURN_WITH_CLEANUP(vm, end, value_release(step));
+  KronosValue *start;
+  POP_OR_RETURN_WITH_CLEANUP(vm, start, value_release(end);
+                             value_release(step));
+  bool numeric = value_is_number(start) && value_is_number(end) &&
+                 value_is_number(step);
+  if (numeric) {
+    state->counter = value_as_number(start);
+    state->end = value_as_number(end);
+    state->step = value_as_number(step);
+  }
+  value_release(start);
+  value_release(end);
+  value_release(step);
+  if (!numeric) {
+    return vm_error(vm, KRONOS_ERR_RUNTIME,
+                    "Range loop start, end and step must be numbers");
+  }
+
+  // The counter is pushed on both paths: the loop body stores it into the
+  // loop variable, and so does the exit path of an empty loop
+  if (push_range_counter(vm, state) != 0) {
+    return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
+  }
+  if (!range_loop_continues(state)) {
+    uint8_t *new_ip = vm->ip + exit_offset;
+    if (new_ip >= vm->bytecode->code + vm->bytecode->count) {
+      return vm_errorf(
+          vm, KRONOS_ERR_RUNTIME,
+          "Jump target out of bounds (offset: %u, bytecode size: %zu)",
+          exit_offset, vm->bytecode->count);
+    }
+    vm->ip = new_ip;
+  }
+  return 0;
+}
+
+static int handle_op_for_range_prep(KronosVM *vm) {
+  return exec_for_range_prep(vm, false);
+}
+
+static VM_ALWAYS_INLINE int exec_for_range_next(KronosVM *vm, bool wide) {
+  uint8_t depth = read_byte(vm);
+  int32_t back_offset = read_offset(vm, wide);
+  if (vm->last_error_message) {
+    return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
+  }
+  RangeLoopState *state = range_loop_state(vm, depth);
+  if (!state) {
+    return vm_propagate_error(vm, KRONOS_ERR_INTERNAL);
+  }
+
+  // Increment, compare and branch in one dispatch; the final (past-the-end)
+  // counter falls through to the exit store so the variable keeps it
+  state->counter += state->step;
+  if (push_range_counter(vm, state) != 0) {
+    return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
+  }
+  if (range_loop_continues(state)) {
+    uint8_t *new_ip = vm->ip + back_offset;
+    if (new_ip < vm->bytecode->code ||
+        new_ip >= vm->bytecode->code + vm->bytecode->count) {
+      return vm_errorf(
+          vm, KRONOS_ERR_RUNTIME,
+          "Jump target out of bounds (offset: %d, bytecode size: %zu)",
+          back_offset, vm->bytecode->count);
+    }
+    vm->ip = new_ip;
+  }
+  return 0;
+}
+
+static int handle_op_for_range_next(KronosVM *vm) {
+  return exec_for_range_next(vm, false);
+}
+
+static VM_ALWAYS_INLINE int exec_define_func(KronosVM *vm, bool wide) {
   // Validate bytecode is available
   if (!vm->bytecode || !vm->bytecode->code) {
     return vm_error(vm, KRONOS_ERR_INTERNAL,
@@ -5895,18 +7175,18 @@ static int handle_op_define_func(KronosVM *vm) {
   }
 
   // Read function name
-  KronosValue *name_val = read_constant(vm);
+  KronosValue *name_val = read_constant(vm, wide);
   if (!name_val) {
     return vm_propagate_error(vm, KRONOS_ERR_INTERNAL);
   }
-  if (name_val->type != VAL_STRING) {
+  if (value_type(name_val) != VAL_STRING) {
     return vm_error(vm, KRONOS_ERR_INTERNAL,
                     "Function name constant is not a string");
   }
   uint8_t param_count = read_byte(vm);
 
-  // Create function
-  Function *func = malloc(sizeof(Function));
+  // Create function (zeroed so function_free() is safe on partial setup)
+  Function *func = calloc(1, sizeof(Function));
   if (!func) {
     return vm_error(vm, KRONOS_ERR_INTERNAL,
                     "Failed to allocate function structure");
@@ -5934,12 +7214,12 @@ static int handle_op_define_func(KronosVM *vm) {
   int param_error = 0;
   size_t filled_params = 0;
   for (size_t i = 0; i < param_count; i++) {
-    KronosValue *param_val = read_constant(vm);
+    KronosValue *param_val = read_constant(vm, wide);
     if (!param_val) {
       param_error = vm_propagate_error(vm, KRONOS_ERR_INTERNAL);
       break;
     }
-    if (param_val->type != VAL_STRING) {
+    if (value_type(param_val) != VAL_STRING) {
       param_error = vm_error(vm, KRONOS_ERR_INTERNAL,
                              "Parameter name constant is not a string");
       break;
@@ -5980,16 +7260,77 @@ static int handle_op_define_func(KronosVM *vm) {
     return param_error;
   }
 
-  // Consume function body start position (2 bytes) - part of bytecode
-  // format but not used at runtime; we just need to advance the instruction
-  // pointer Format:
-  // [OP_DEFINE_FUNC][name_idx:2][param_count:1][params:2*N][body_start:2][OP_JUMP][skip_offset:2]
-  read_byte(vm); // body_start high byte
+  // Read the local slot descriptor table. Parameters occupy the first slots
+  // (mutable, untyped); the table describes the remaining locals:
+  // [local_count:2] then per local [name_idx][is_mutable:1][type_idx]
+  // where an absent type_idx means no type annotation
+  uint16_t local_count = read_uint16(vm);
   if (vm->last_error_message) {
-    // Cleanup already done above
+    function_free(func);
     return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
   }
-  read_byte(vm); // body_start low byte
+  size_t slot_count = (size_t)param_count + local_count;
+  if (slot_count > LOCALS_MAX) {
+    function_free(func);
+    return vm_errorf(vm, KRONOS_ERR_RUNTIME,
+                     "Maximum number of local variables exceeded (%d allowed)",
+                     LOCALS_MAX);
+  }
+  if (slot_count > 0) {
+    func->slots = calloc(slot_count, sizeof(LocalSlot));
+    if (!func->slots) {
+      function_free(func);
+      return vm_error(vm, KRONOS_ERR_INTERNAL,
+                      "Failed to allocate local slot table");
+    }
+    func->slot_count = slot_count;
+  }
+  for (size_t i = 0; i < param_count; i++) {
+    func->slots[i].name = strdup(func->params[i]);
+    func->slots[i].is_mutable = true;
+    if (!func->slots[i].name) {
+      function_free(func);
+      return vm_error(vm, KRONOS_ERR_INTERNAL, "Failed to copy local name");
+    }
+  }
+  for (size_t i = param_count; i < slot_count; i++) {
+    KronosValue *slot_name = read_constant(vm, wide);
+    if (!slot_name) {
+      function_free(func);
+      return vm_propagate_error(vm, KRONOS_ERR_INTERNAL);
+    }
+    uint8_t is_mutable_byte = read_byte(vm);
+    uint32_t type_idx = read_operand(vm, wide);
+    bool typed = type_idx != no_constant(wide);
+    if (vm->last_error_message) {
+      function_free(func);
+      return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
+    }
+    if (value_type(slot_name) != VAL_STRING ||
+        (typed && (type_idx >= vm->bytecode->const_count ||
+          value_type(vm->bytecode->constants[type_idx]) != VAL_STRING))) {
+      function_free(func);
+      return vm_error(vm, KRONOS_ERR_INTERNAL,
+                      "Invalid local slot descriptor in function definition");
+    }
+    func->slots[i].is_mutable = (is_mutable_byte == 1);
+    func->slots[i].name = strdup(slot_name->as.string.data);
+    if (typed) {
+      func->slots[i].type_name =
+          strdup(vm->bytecode->constants[type_idx]->as.string.data);
+    }
+    if (!func->slots[i].name || (typed && !func->slots[i].type_name)) {
+      function_free(func);
+      return vm_error(vm, KRONOS_ERR_INTERNAL, "Failed to copy local name");
+    }
+  }
+
+  // Consume function body start position - part of bytecode format but not
+  // used at runtime; we just need to advance the instruction pointer.
+  // Format (index and offset operands are 4 bytes after OP_WIDE, else 2):
+  // [OP_DEFINE_FUNC][name_idx][param_count:1][params * N][locals...]
+  // [body_start][OP_JUMP][skip_offset]
+  read_operand(vm, wide); // body_start
   if (vm->last_error_message) {
     // Cleanup already done above
     return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
@@ -6002,15 +7343,9 @@ static int handle_op_define_func(KronosVM *vm) {
     return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
   }
 
-  // Read jump offset to skip function body (2 bytes: high byte, low byte)
-  // The compiler calculates offset as: func_end - (skip_body_pos + 2)
-  // where skip_body_pos is the position of OP_JUMP instruction.
-  // After reading OP_JUMP (1 byte) and offset (2 bytes), vm->ip points to
-  // skip_body_pos + 3, which is the start of the function body.
-  // The offset tells us: from position (skip_body_pos + 2), skip forward by
-  // offset bytes to reach func_end. So: func_end = (skip_body_pos + 2) + offset
-  // In VM terms: func_end = (vm->ip - 1) + offset
-  uint16_t skip_offset = read_uint16(vm);
+  // Read jump offset to skip function body. Like every jump offset it is
+  // relative to the end of its operand, which is where the body starts.
+  uint32_t skip_offset = read_operand(vm, wide);
   if (vm->last_error_message) {
     // Cleanup already done above
     return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
@@ -6031,22 +7366,9 @@ static int handle_op_define_func(KronosVM *vm) {
                      vm->bytecode->count);
   }
 
-  // Calculate body end: offset is relative to position 2 bytes before current
-  // ip (the position after the OP_JUMP byte and before the offset bytes).
-  // The compiler calculates offset as: func_end - (skip_body_pos + 2)
-  // where skip_body_pos is the position of OP_JUMP.
-  // After reading OP_JUMP (1 byte) and offset (2 bytes), vm->ip points to
-  // skip_body_pos + 3, which is the start of the function body.
-  // The offset tells us: from position (skip_body_pos + 2), skip forward by
-  // offset bytes to reach func_end. So: func_end = (skip_body_pos + 2) + offset
-  // In VM terms: func_end = (vm->ip - 1) + offset
-  //
-  // IMPORTANT: func_end points to the position AFTER the last byte of the
-  // function body (after OP_RETURN_VAL), so body_end_ptr should also point
-  // after the function body. The calculation (ip - 1) + offset gives us
-  // func_end, but func_end points TO OP_RETURN_VAL, not after it. We need to
-  // add 1 to skip past the OP_RETURN_VAL instruction.
-  uint8_t *body_end_ptr = vm->ip - 1 + skip_offset + 1;
+  // Calculate body end: the skip lands just past the last byte of the
+  // function body (after its OP_RETURN_VAL)
+  uint8_t *body_end_ptr = vm->ip + skip_offset;
 
   // Validate that body_end_ptr is within valid bytecode bounds
   if (body_end_ptr < vm->bytecode->code ||
@@ -6145,6 +7467,9 @@ static int handle_op_define_func(KronosVM *vm) {
     }
   }
 
+  // The body was verified as part of the enclosing bytecode
+  func->bytecode.verified = vm->bytecode->verified;
+
   // Store function
   int define_status = vm_define_function(vm, func);
   if (define_status != 0) {
@@ -6157,6 +7482,10 @@ static int handle_op_define_func(KronosVM *vm) {
   return 0;
 }
 
+static int handle_op_define_func(KronosVM *vm) {
+  return exec_define_func(vm, false);
+}
+
 static int handle_op_return_val(KronosVM *vm) {
   // Pop return value from stack
   KronosValue *return_value;
@@ -6187,11 +7516,7 @@ static int handle_op_return_val(KronosVM *vm) {
 
     // Clean up local variables (only for regular function calls, not module
     // calls)
-    for (size_t i = 0; i < frame->local_count; i++) {
-      free(frame->locals[i].name);
-      value_release(frame->locals[i].value);
-      free(frame->locals[i].type_name);
-    }
+    cleanup_call_frame_locals(frame);
 
     vm->ip = frame->return_ip;
     vm->bytecode = frame->return_bytecode;
@@ -6204,11 +7529,9 @@ static int handle_op_return_val(KronosVM *vm) {
       vm->current_frame = NULL;
     }
 
-    // Push return value onto stack
-    // push() retains the value (increments refcount), so we release our
-    // local reference after pushing
-    PUSH_OR_RETURN_WITH_CLEANUP(vm, return_value, value_release(return_value););
-    value_release(return_value); // Release our reference, stack now owns it
+    // Hand our reference back to the stack slot it was popped from (always
+    // free, since nothing was pushed in between)
+    *vm->stack_top++ = return_value;
   } else {
     // Top-level return (shouldn't happen in normal code)
     // push() retains the value (increments refcount), so we release our
@@ -6220,9 +7543,245 @@ static int handle_op_return_val(KronosVM *vm) {
   return 0;
 }
 
+// Opcode sequence profiler (build with -DKRONOS_OPCODE_PROFILE=1, see
+// scripts/profile_opcodes.sh). Counts every executed pair and triple of
+// opcodes in dispatch order; at exit the non-zero counts are appended to the
+// file named by $KRONOS_OPCODE_PROFILE_OUT (stderr if unset) as
+// "pair A B count" / "triple A B C count" lines. Process-wide and not
+// thread-safe: it is a development tool for choosing superinstructions.
+#ifndef KRONOS_OPCODE_PROFILE
+#define KRONOS_OPCODE_PROFILE 0
+#endif
+
+#if KRONOS_OPCODE_PROFILE
+static uint64_t profile_pairs[OPCODE_COUNT][OPCODE_COUNT];
+static uint64_t profile_triples[OPCODE_COUNT][OPCODE_COUNT][OPCODE_COUNT];
+static int profile_prev1 = -1; // Previous opcode (-1 at start)
+static int profile_prev2 = -1; // Opcode before that
+static bool profile_registered = false;
+
+static void vm_profile_dump(void) {
+  const char *path = getenv("KRONOS_OPCODE_PROFILE_OUT");
+  FILE *out = path ? fopen(path, "a") : stderr;
+  if (!out) {
+    return;
+  }
+  for (size_t a = 0; a < OPCODE_COUNT; a++) {
+    for (size_t b = 0; b < OPCODE_COUNT; b++) {
+      if (profile_pairs[a][b]) {
+        fprintf(out, "pair %s %s %llu\n", opcode_name((uint8_t)a),
+                opcode_name((uint8_t)b),
+                (unsigned long long)profile_pairs[a][b]);
+      }
+      for (size_t c = 0; c < OPCODE_COUNT; c++) {
+        if (profile_triples[a][b][c]) {
+          fprintf(out, "triple %s %s %s %llu\n", opcode_name((uint8_t)a),
+                  opcode_name((uint8_t)b), opcode_name((uint8_t)c),
+                  (unsigned long long)profile_triples[a][b][c]);
+        }
+      }
+    }
+  }
+  if (out != stderr) {
+    fclose(out);
+  }
+}
+
+static void vm_profile_opcode(uint8_t op) {
+  if (op >= OPCODE_COUNT) {
+    return;
+  }
+  if (!profile_registered) {
+    profile_registered = true;
+    atexit(vm_profile_dump);
+  }
+  if (profile_prev1 >= 0) {
+    profile_pairs[profile_prev1][op]++;
+    if (profile_prev2 >= 0) {
+      profile_triples[profile_prev2][profile_prev1][op]++;
+    }
+  }
+  profile_prev2 = profile_prev1;
+  profile_prev1 = op;
+}
+#define VM_PROFILE_OPCODE(op) vm_profile_opcode(op)
+#else
+#define VM_PROFILE_OPCODE(op) ((void)0)
+#endif
+
 // Execute bytecode
+// Fetch the next opcode; only out-of-bounds reads take the checked path,
+// which sets an error and yields OP_HALT (verified code can still run off
+// its end, so the fetch keeps its bounds check)
+#define VM_FETCH_OPCODE(vm)                                                    \
+  ((size_t)((vm)->ip - (vm)->bytecode->code) < (vm)->bytecode->count           \
+       ? *(vm)->ip++                                                           \
+       : read_byte_checked(vm))
+
+// Opcodes with a wide form, and the body each runs with 32-bit operands
+#define VM_WIDE_OPCODES(X)                                                     \
+  X(OP_LOAD_CONST, exec_load_const)                                            \
+  X(OP_LOAD_VAR, exec_load_var)                                                \
+  X(OP_STORE_VAR, exec_store_var)                                              \
+  X(OP_LOAD_GLOBAL, exec_load_global)                                          \
+  X(OP_STORE_GLOBAL, exec_store_global)                                        \
+  X(OP_JUMP, exec_jump)                                                        \
+  X(OP_JUMP_IF_FALSE, exec_jump_if_false)                                      \
+  X(OP_DEFINE_FUNC, exec_define_func)                                          \
+  X(OP_ITER_PREP, exec_iter_prep)                                              \
+  X(OP_ITER_NEXT, exec_iter_next)                                              \
+  X(OP_TRY_ENTER, exec_try_enter)                                              \
+  X(OP_TRY_EXIT, exec_try_exit)                                                \
+  X(OP_CATCH, exec_catch)                                                      \
+  X(OP_THROW, exec_throw)                                                      \
+  X(OP_IMPORT, exec_import)                                                    \
+  X(OP_FOR_RANGE_PREP, exec_for_range_prep)                                    \
+  X(OP_FOR_RANGE_NEXT, exec_for_range_next)                                    \
+  X(OP_CMP_JUMP_IF_FALSE, exec_cmp_jump_if_false)                              \
+  X(OP_INC_LOCAL_CONST, exec_inc_local_const)                                  \
+  X(OP_INC_VAR_CONST, exec_inc_var_const)                                      \
+  X(OP_INC_GLOBAL_CONST, exec_inc_global_const)                                \
+  X(OP_CMP_JUMP_IF_FALSE_NUM, exec_cmp_jump_if_false_num)
+
 /**
- * @brief Execute bytecode on the virtual machine
+ * @brief OP_WIDE: run the following instruction with 32-bit operands
+ *
+ * Kept out of line so the wide bodies do not bloat the dispatch loop; only
+ * units too large for 16-bit operands ever reach it.
+ */
+static VM_NOINLINE int handle_op_wide(KronosVM *vm) {
+  // Fetched like any opcode: an exception being handled leaves its error
+  // set when the dispatch reaches a (wide) OP_CATCH
+  if ((size_t)(vm->ip - vm->bytecode->code) >= vm->bytecode->count) {
+    return vm_error(vm, KRONOS_ERR_RUNTIME, "Truncated OP_WIDE instruction");
+  }
+  uint8_t opcode = *vm->ip++;
+  switch (opcode) {
+#define VM_WIDE_CASE(op, exec)                                                 \
+  case op:                                                                     \
+    return exec(vm, true);
+    VM_WIDE_OPCODES(VM_WIDE_CASE)
+#undef VM_WIDE_CASE
+  case OP_CALL_FUNC:
+    return call_function_at_site(vm, false, true);
+  case OP_TAIL_CALL:
+    return call_function_at_site(vm, true, true);
+  default:
+    return vm_errorf(vm, KRONOS_ERR_INTERNAL,
+                     "Invalid OP_WIDE operand opcode: %s",
+                     opcode_name(opcode));
+  }
+}
+
+// Opcodes whose handlers need no special treatment from the dispatch loop
+// (OP_RETURN_VAL and OP_HALT are dispatched explicitly in vm_execute)
+#define VM_GENERIC_OPCODES(X)                                                  \
+  X(OP_LOAD_CONST, handle_op_load_const)                                       \
+  X(OP_LOAD_VAR, handle_op_load_var)                                           \
+  X(OP_STORE_VAR, handle_op_store_var)                                         \
+  X(OP_LOAD_LOCAL, handle_op_load_local)                                       \
+  X(OP_STORE_LOCAL, handle_op_store_local)                                     \
+  X(OP_LOAD_GLOBAL, handle_op_load_global)                                     \
+  X(OP_STORE_GLOBAL, handle_op_store_global)                                   \
+  X(OP_PRINT, handle_op_print)                                                 \
+  X(OP_ADD, handle_op_add)                                                     \
+  X(OP_SUB, handle_op_sub)                                                     \
+  X(OP_MUL, handle_op_mul)                                                     \
+  X(OP_DIV, handle_op_div)                                                     \
+  X(OP_MOD, handle_op_mod)                                                     \
+  X(OP_NEG, handle_op_neg)                                                     \
+  X(OP_EQ, handle_op_eq)                                                       \
+  X(OP_NEQ, handle_op_neq)                                                     \
+  X(OP_GT, handle_op_gt)                                                       \
+  X(OP_LT, handle_op_lt)                                                       \
+  X(OP_GTE, handle_op_gte)                                                     \
+  X(OP_LTE, handle_op_lte)                                                     \
+  X(OP_AND, handle_op_and)                                                     \
+  X(OP_OR, handle_op_or)                                                       \
+  X(OP_NOT, handle_op_not)                                                     \
+  X(OP_JUMP, handle_op_jump)                                                   \
+  X(OP_JUMP_IF_FALSE, handle_op_jump_if_false)                                 \
+  X(OP_DEFINE_FUNC, handle_op_define_func)                                     \
+  X(OP_CALL_FUNC, handle_op_call_func)                                         \
+  X(OP_TAIL_CALL, handle_op_tail_call)                                         \
+  X(OP_POP, handle_op_pop)                                                     \
+  X(OP_LIST_NEW, handle_op_list_new)                                           \
+  X(OP_LIST_GET, handle_op_list_get)                                           \
+  X(OP_LIST_SET, handle_op_list_set)                                           \
+  X(OP_LIST_APPEND, handle_op_list_append)                                     \
+  X(OP_LIST_LEN, handle_op_list_len)                                           \
+  X(OP_LIST_SLICE, handle_op_list_slice)                                       \
+  X(OP_ITER_PREP, handle_op_iter_prep)                                         \
+  X(OP_ITER_NEXT, handle_op_iter_next)                                         \
+  X(OP_ITER_CLOSE, handle_op_iter_close)                                       \
+  X(OP_RANGE_NEW, handle_op_range_new)                                         \
+  X(OP_MAP_NEW, handle_op_map_new)                                             \
+  X(OP_MAP_SET, handle_op_map_set)                                             \
+  X(OP_DELETE, handle_op_delete)                                               \
+  X(OP_TRY_ENTER, handle_op_try_enter)                                         \
+  X(OP_TRY_EXIT, handle_op_try_exit)                                           \
+  X(OP_CATCH, handle_op_catch)                                                 \
+  X(OP_FINALLY, handle_op_finally)                                             \
+  X(OP_THROW, handle_op_throw)                                                 \
+  X(OP_IMPORT, handle_op_import)                                               \
+  X(OP_FOR_RANGE_PREP, handle_op_for_range_prep)                               \
+  X(OP_FOR_RANGE_NEXT, handle_op_for_range_next)                               \
+  X(OP_CMP_JUMP_IF_FALSE, handle_op_cmp_jump_if_false)                         \
+  X(OP_INC_LOCAL_CONST, handle_op_inc_local_const)                             \
+  X(OP_INC_VAR_CONST, handle_op_inc_var_const)                                 \
+  X(OP_INC_GLOBAL_CONST, handle_op_inc_global_const)                           \
+  X(OP_ADD_NUM, handle_op_add_num)                                             \
+  X(OP_SUB_NUM, handle_op_sub_num)                                             \
+  X(OP_MUL_NUM, handle_op_mul_num)                                             \
+  X(OP_GT_NUM, handle_op_gt_num)                                               \
+  X(OP_LT_NUM, handle_op_lt_num)                                               \
+  X(OP_GTE_NUM, handle_op_gte_num)                                             \
+  X(OP_LTE_NUM, handle_op_lte_num)                                             \
+  X(OP_CMP_JUMP_IF_FALSE_NUM, handle_op_cmp_jump_if_false_num)               \
+  X(OP_INDEX_LIST, handle_op_index_list)                                       \
+  X(OP_CONCAT_STR, handle_op_concat_str)                                       \
+  X(OP_WIDE, handle_op_wide)
+
+/**
+ * @brief Whether the OP_RETURN_VAL just executed ended a module function call
+ *
+ * Module functions run in a nested vm_execute() whose frame has no return
+ * address; returning from it must leave that execution loop.
+ */
+static inline bool vm_module_call_returned(const KronosVM *vm) {
+  if (vm->call_stack_size == 0) {
+    return false;
+  }
+  const CallFrame *frame = &vm->call_stack[vm->call_stack_size - 1];
+  return frame->return_ip == NULL && frame->return_bytecode == NULL;
+}
+
+/**
+ * @brief Slow path taken when an opcode handler reports failure
+ *
+ * A non-zero @p result is returned as-is (such errors are not catchable). A
+ * handler that returned 0 but left an error set (OP_THROW) is routed to the
+ * innermost exception handler, unless an exception is already being handled.
+ *
+ * @param vm VM instance
+ * @param result Handler return value
+ * @param handling_exception In/out flag: an exception handler was entered
+ * @return 0 to resume execution at vm->ip, negative error code to stop
+ */
+static int vm_dispatch_failed(KronosVM *vm, int result,
+                              bool *handling_exception) {
+  if (result != 0) {
+    return result;
+  }
+  if (!*handling_exception && handle_exception_if_any(vm)) {
+    *handling_exception = true;
+    return 0;
+  }
+  return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
+}
+
+/**
+ * @brief Run bytecode in place on the virtual machine
  *
  * Main execution loop. Reads instructions from bytecode and executes them
  * using a stack-based model. Handles all instruction types including:
@@ -6233,11 +7792,19 @@ static int handle_op_return_val(KronosVM *vm) {
  * - Function calls and returns
  * - Built-in function invocations
  *
+ * Uses threaded (computed-goto) dispatch when KRONOS_COMPUTED_GOTO is set and
+ * the portable handler-table loop otherwise; both share the same slow path
+ * for handler failures and exceptions.
+ *
+ * Rewrites @p bytecode while it runs (global slots, quickened opcodes, call
+ * cache), so it must be VM-owned: function bytecode or vm->run_code.
+ *
  * @param vm VM instance to execute on
- * @param bytecode Compiled bytecode to execute
+ * @param bytecode VM-owned bytecode to execute
  * @return 0 on success, negative error code on failure
  */
-int vm_execute(KronosVM *vm, Bytecode *bytecode) {
+VM_THREADED_DISPATCH
+static int vm_run(KronosVM *vm, Bytecode *bytecode) {
   if (!vm) {
     return -(int)KRONOS_ERR_INVALID_ARGUMENT;
   }
@@ -6270,152 +7837,164 @@ int vm_execute(KronosVM *vm, Bytecode *bytecode) {
   // Note: current_frame should be set by the caller for function execution
   // For top-level code, current_frame is NULL
 
-  // Dispatch table mapping opcodes to handler functions
-  // Note: OP_BREAK, OP_CONTINUE, OP_MAP_GET, and OP_RETHROW are reserved but
-  // never emitted They will be NULL in the table and handled by the error check
-  // below
-  static const OpcodeHandler dispatch_table[] = {
-      [OP_LOAD_CONST] = handle_op_load_const,
-      [OP_LOAD_VAR] = handle_op_load_var,
-      [OP_STORE_VAR] = handle_op_store_var,
-      [OP_PRINT] = handle_op_print,
-      [OP_ADD] = handle_op_add,
-      [OP_SUB] = handle_op_sub,
-      [OP_MUL] = handle_op_mul,
-      [OP_DIV] = handle_op_div,
-      [OP_MOD] = handle_op_mod,
-      [OP_NEG] = handle_op_neg,
-      [OP_EQ] = handle_op_eq,
-      [OP_NEQ] = handle_op_neq,
-      [OP_GT] = handle_op_gt,
-      [OP_LT] = handle_op_lt,
-      [OP_GTE] = handle_op_gte,
-      [OP_LTE] = handle_op_lte,
-      [OP_AND] = handle_op_and,
-      [OP_OR] = handle_op_or,
-      [OP_NOT] = handle_op_not,
-      [OP_JUMP] = handle_op_jump,
-      [OP_JUMP_IF_FALSE] = handle_op_jump_if_false,
-      [OP_BREAK] = NULL,    // Reserved, never emitted
-      [OP_CONTINUE] = NULL, // Reserved, never emitted
-      [OP_DEFINE_FUNC] = handle_op_define_func,
-      [OP_CALL_FUNC] = handle_op_call_func,
-      [OP_RETURN_VAL] = handle_op_return_val,
-      [OP_POP] = handle_op_pop,
-      [OP_LIST_NEW] = handle_op_list_new,
-      [OP_LIST_GET] = handle_op_list_get,
-      [OP_LIST_SET] = handle_op_list_set,
-      [OP_LIST_APPEND] = handle_op_list_append,
-      [OP_LIST_LEN] = handle_op_list_len,
-      [OP_LIST_SLICE] = handle_op_list_slice,
-      [OP_LIST_ITER] = handle_op_list_iter,
-      [OP_LIST_NEXT] = handle_op_list_next,
-      [OP_RANGE_NEW] = handle_op_range_new,
-      [OP_MAP_NEW] = handle_op_map_new,
-      [OP_MAP_SET] = handle_op_map_set,
-      [OP_MAP_GET] = NULL, // Reserved, never emitted (uses OP_LIST_GET)
-      [OP_DELETE] = handle_op_delete,
-      [OP_TRY_ENTER] = handle_op_try_enter,
-      [OP_TRY_EXIT] = handle_op_try_exit,
-      [OP_CATCH] = handle_op_catch,
-      [OP_FINALLY] = handle_op_finally,
-      [OP_THROW] = handle_op_throw,
-      [OP_RETHROW] = NULL, // Reserved, never emitted
-      [OP_IMPORT] = handle_op_import,
-      [OP_HALT] = handle_op_halt,
-  };
-
   bool handling_exception = false;
 
-  while (1) {
-    // Check for exceptions before executing next instruction
-    // Only check if we're not already handling an exception (to avoid infinite
-    // loop)
-    if (vm->last_error_code != KRONOS_OK && !handling_exception) {
-      if (handle_exception_if_any(vm)) {
-        // We're now handling the exception - set flag to allow OP_CATCH to run
-        handling_exception = true;
-        continue; // Jump to handler, next iteration will execute OP_CATCH
-      } else {
-        // No handler - propagate the error and stop execution
-        return vm_propagate_error(vm, vm->last_error_code);
-      }
-    }
-    // Reset handling_exception after we've executed an instruction
-    // This allows OP_CATCH to check for errors and match them
-    if (handling_exception) {
-      // We're in exception handling mode - don't reset yet, let OP_CATCH handle
-      // it Reset will happen after OP_CATCH clears the error
-    } else {
-      // Normal execution - reset flag (redundant but safe)
-      handling_exception = false;
+  // An error left over from before this run is handled (or propagated)
+  // before the first instruction, exactly as if an instruction had raised it
+  if (vm->last_error_code != KRONOS_OK) {
+    if (!handle_exception_if_any(vm)) {
+      return vm_propagate_error(vm, vm->last_error_code);
     }
+    handling_exception = true;
+  }
+
+  // Handlers report failure by returning non-zero or by leaving an error set
+  // (OP_THROW); everything else stays on the fast path. OP_HALT is handled
+  // inline: read_byte() returns it with an error set on out-of-bounds reads.
+  // OP_BREAK, OP_CONTINUE, OP_MAP_GET and OP_RETHROW are reserved and never
+  // emitted, so they dispatch to the unknown-instruction error.
+  uint8_t instruction;
+  int result;
+
+#if KRONOS_COMPUTED_GOTO
+  // Threaded dispatch: every opcode body ends by jumping directly to the
+  // next opcode's label. Each handler has a single direct call site here,
+  // so the compiler inlines them into this function.
+#define VM_LABEL_ENTRY(op, handler) [op] = &&label_##op,
+  static const void *const dispatch_labels[OPCODE_COUNT] = {
+      VM_GENERIC_OPCODES(VM_LABEL_ENTRY)
+      [OP_RETURN_VAL] = &&label_OP_RETURN_VAL,
+      [OP_BREAK] = &&label_unknown,
+      [OP_CONTINUE] = &&label_unknown,
+      [OP_MAP_GET] = &&label_unknown,
+      [OP_RETHROW] = &&label_unknown,
+      [OP_HALT] = &&label_OP_HALT,
+  };
+#undef VM_LABEL_ENTRY
+
+#define VM_DISPATCH()                                                          \
+  do {                                                                         \
+    instruction = VM_FETCH_OPCODE(vm);                                         \
+    VM_PROFILE_OPCODE(instruction);                                            \
+    if (VM_UNLIKELY(instruction > OP_HALT)) {                                  \
+      goto label_unknown;                                                      \
+    }                                                                          \
+    goto *dispatch_labels[instruction];                                        \
+  } while (0)
 
-    uint8_t instruction = read_byte(vm);
+#define VM_LABEL_BODY(op, handler)                                             \
+  label_##op : result = handler(vm);                                           \
+  if (VM_UNLIKELY(result != 0 || vm->last_error_message)) {                    \
+    goto slow_path;                                                            \
+  }                                                                            \
+  VM_DISPATCH();
 
-    // Check for error state after read_byte (it may return OP_HALT on error)
-    // If read_byte() encountered an error, it sets vm->last_error_message
-    // However, if we're handling an exception (handling_exception is true),
-    // the error from OP_THROW is expected and we should continue to execute
-    // OP_CATCH
-    if (vm->last_error_message && !handling_exception) {
-      return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
+  VM_DISPATCH();
+
+  VM_GENERIC_OPCODES(VM_LABEL_BODY)
+
+label_OP_RETURN_VAL:
+  result = handle_op_return_val(vm);
+  if (result == 0 && vm_module_call_returned(vm)) {
+    return 0;
+  }
+  if (VM_UNLIKELY(result != 0 || vm->last_error_message)) {
+    goto slow_path;
+  }
+  VM_DISPATCH();
+
+label_OP_HALT:
+  if (vm->last_error_message) {
+    return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
+  }
+  return 0;
+
+slow_path:
+  result = vm_dispatch_failed(vm, result, &handling_exception);
+  if (result != 0) {
+    return result;
+  }
+  VM_DISPATCH();
+
+label_unknown:
+  return vm_errorf(vm, KRONOS_ERR_INTERNAL,
+                   "Unknown bytecode instruction: %d (this is a compiler bug)",
+                   instruction);
+
+#undef VM_LABEL_BODY
+#undef VM_DISPATCH
+#else
+  // Portable dispatch through a table of handler pointers
+#define VM_TABLE_ENTRY(op, handler) [op] = handler,
+  static const OpcodeHandler dispatch_table[OPCODE_COUNT] = {
+      VM_GENERIC_OPCODES(VM_TABLE_ENTRY)
+      [OP_RETURN_VAL] = handle_op_return_val,
+  };
+#undef VM_TABLE_ENTRY
+
+  while (1) {
+    instruction = VM_FETCH_OPCODE(vm);
+    VM_PROFILE_OPCODE(instruction);
+    if (instruction == OP_HALT) {
+      if (vm->last_error_message) {
+        return vm_propagate_error(vm, KRONOS_ERR_RUNTIME);
+      }
+      return 0;
     }
-    // If handling_exception is true, vm->last_error_message is from OP_THROW
-    // and we should continue to execute OP_CATCH to handle it
 
-    // Dispatch to handler function using dispatch table
-    // The dispatch table uses designated initializers, so its size is
-    // determined by the highest index (OP_HALT = 44). Check bounds and NULL
-    // handlers.
     if (instruction > OP_HALT || dispatch_table[instruction] == NULL) {
-      // Unknown or unhandled opcode
       return vm_errorf(
           vm, KRONOS_ERR_INTERNAL,
           "Unknown bytecode instruction: %d (this is a compiler bug)",
           instruction);
     }
 
-    int result = dispatch_table[instruction](vm);
-    if (result != 0) {
-      return result;
-    }
-
-    // Check if we just executed OP_RETURN_VAL for a module function call
-    // If so, break out of the loop to avoid reading past the function bytecode
-    if (instruction == OP_RETURN_VAL && vm->call_stack_size > 0) {
-      CallFrame *frame = &vm->call_stack[vm->call_stack_size - 1];
-      if (frame->return_ip == NULL && frame->return_bytecode == NULL) {
-        // Module function returned - exit the loop
-        break;
-      }
+    result = dispatch_table[instruction](vm);
+    if (instruction == OP_RETURN_VAL && result == 0 &&
+        vm_module_call_returned(vm)) {
+      return 0;
     }
-
-    // Check if handler set an error but returned 0 (e.g., OP_THROW)
-    // If an exception handler exists, handle it immediately. Otherwise,
-    // propagate the error.
-    if (vm->last_error_message) {
-      // Check if there's an exception handler that can catch this error
-      if (vm->exception_handler_count > 0 && !handling_exception) {
-        // Exception handler exists - jump to the catch handler immediately
-        if (handle_exception_if_any(vm)) {
-          // We've jumped to the handler - set flag so exception check at loop
-          // start doesn't jump again, but allow OP_CATCH to execute
-          handling_exception = true;
-          continue; // Go to loop start, but exception check will be skipped
-        }
+    if (VM_UNLIKELY(result != 0 || vm->last_error_message)) {
+      result = vm_dispatch_failed(vm, result, &handling_exception);
+      if (result != 0) {
+        return result;
       }
-      // No exception handler or already handling - propagate the error and stop
-      // execution
-      return vm_propagate_error(vm, vm->last_error_code);
     }
+  }
+#endif
+}
 
-    // OP_HALT returns 0 to indicate successful halt - exit the loop
-    // Use break to exit the while loop, then return 0 at the end
-    if (instruction == OP_HALT) {
-      break;
-    }
+/**
+ * @brief Execute bytecode on the virtual machine
+ *
+ * Copies the caller's code into vm->run_code and runs the copy, so the
+ * caller's bytecode is never rewritten. The previous copy is kept until
+ * now because frames and handlers of the last run may still point into it.
+ *
+ * @param vm VM instance to execute on
+ * @param bytecode Compiled bytecode to execute (not modified)
+ * @return 0 on success, negative error code on failure
+ */
+int vm_execute(KronosVM *vm, Bytecode *bytecode) {
+  if (!vm || !bytecode || !bytecode->code || bytecode->count == 0) {
+    // Nothing to copy; vm_run reports invalid arguments
+    return vm_run(vm, bytecode);
   }
 
-  return 0;
+  uint8_t *code = malloc(bytecode->count);
+  if (!code) {
+    return vm_error(vm, KRONOS_ERR_INTERNAL,
+                    "vm_execute: failed to copy bytecode");
+  }
+  memcpy(code, bytecode->code, bytecode->count);
+
+  free_run_code(vm);
+  vm->run_code.code = code;
+  vm->run_code.count = bytecode->count;
+  vm->run_code.capacity = bytecode->count;
+  vm->run_code.constants = bytecode->constants;
+  vm->run_code.const_count = bytecode->const_count;
+  vm->run_code.const_capacity = bytecode->const_count;
+  vm->run_code.verified = bytecode->verified;
+  return vm_run(vm, &vm->run_code);
 }
@@ -7,22 +7,40 @@
 #include <stdbool.h>
 #include <stddef.h>
 
-#define STACK_MAX 1024
-#define GLOBALS_MAX 256
+#define STACK_INITIAL_CAPACITY 256
+#define GLOBALS_INITIAL_CAPACITY 64
 #define FUNCTIONS_MAX 128
-#define CALL_STACK_MAX 256
-#define LOCALS_MAX 64
+#define CALL_STACK_INITIAL_CAPACITY 16
+// Range loop state slots allocated by a frame's first range loop (grown with
+// deeper nesting up to RANGE_LOOP_DEPTH_MAX)
+#define RANGE_LOOPS_INITIAL_CAPACITY 8
+// Default limit on nested calls (see vm_set_max_call_depth()); the call
+// stack and the value stack grow on demand up to it
+#define CALL_DEPTH_DEFAULT 10000
+// Maximum nesting of calls into functions of other modules. Each one runs
+// the module's VM recursively on the C stack, so it is capped separately
+#define MODULE_CALL_DEPTH_MAX 256
+#define LOCALS_MAX LOCAL_SLOTS_MAX
 #define MODULES_MAX 64
 #define EXCEPTION_HANDLERS_MAX 64
 // Maximum import depth to prevent C stack exhaustion from recursive module loading
 // This is more conservative than MODULES_MAX to account for C stack usage
 #define IMPORT_DEPTH_MAX 32
 
+// Local slot descriptor (one per parameter/local, indexed by slot number)
+typedef struct {
+  char *name;      // Variable name (error messages and global fallback)
+  bool is_mutable; // Whether the local can be reassigned
+  char *type_name; // NULL if no type restriction
+} LocalSlot;
+
 // Function definition
 typedef struct {
   char *name;
   char **params;
   size_t param_count;
+  LocalSlot *slots;  // Slot descriptors; parameters occupy [0, param_count)
+  size_t slot_count; // Number of slot descriptors
   Bytecode bytecode; // Full bytecode structure
 } Function;
 
@@ -37,6 +55,22 @@ typedef struct {
   bool is_loaded; // Whether module has been loaded
 } Module;
 
+// Unboxed state of one active numeric range loop (OP_FOR_RANGE_PREP/NEXT)
+typedef struct {
+  double counter;
+  double end;
+  double step;
+} RangeLoopState;
+
+// Native iterator of one active for-in loop (OP_ITER_PREP/NEXT/CLOSE)
+typedef struct {
+  KronosValue *container; // Iterated list, range, string or map (retained)
+  size_t cursor;          // Next list index, map entry or string byte; for
+                          // ranges the number of values produced so far
+  double range_next;      // Next value of a range
+  bool pairs;             // Yield key and value (maps only)
+} IteratorState;
+
 // Call frame for function calls
 typedef struct {
   Function *function;
@@ -44,45 +78,68 @@ typedef struct {
   Bytecode *return_bytecode; // Which bytecode to return to
   KronosValue **frame_start; // Start of this frame's stack
 
-  // Local variables (includes parameters)
-  struct LocalVar {
-    char *name;
-    KronosValue *value;
-    bool is_mutable;
-    char *type_name; // NULL if no type restriction
-  } locals[LOCALS_MAX];
-  size_t local_count;
-
-  // Local variable hash table for O(1) lookup
-  // Stores pointers to local variable entries, NULL if empty slot
-  // Collisions handled by linear probing
-  struct LocalVar *local_hash[LOCALS_MAX];
+  // Local variable values indexed by slot (includes parameters). Names,
+  // mutability and types live in function->slots; a NULL entry means the
+  // local has not been assigned yet in this call. Sized by the function's
+  // slot count and kept by the call stack entry for later calls.
+  KronosValue **slots;
+  size_t slot_count;    // Number of slots in use for this call
+  size_t slot_capacity; // Allocated length of slots
+
+  // Range loops of this call, indexed by loop nesting depth (grown on
+  // demand by the loops that run, up to RANGE_LOOP_DEPTH_MAX entries)
+  RangeLoopState *range_loops;
+  size_t range_loop_capacity;
+
+  // For-in iterators of this call, indexed by loop nesting depth
+  // (ITER_LOOP_DEPTH_MAX entries, allocated by the first for-in loop); bit d
+  // of live_iterators is set while iterators[d] holds a container
+  IteratorState *iterators;
+  uint32_t live_iterators;
 } CallFrame;
 
 // Virtual machine state
 typedef struct KronosVM {
-  // Value stack
-  KronosValue *stack[STACK_MAX];
+  // Value stack, grown on demand (growing moves it and rebases stack_top
+  // and every frame's frame_start)
+  KronosValue **stack;
   KronosValue **stack_top;
+  size_t stack_capacity;
 
-  // Call stack
-  CallFrame call_stack[CALL_STACK_MAX];
+  // Call stack, grown on demand up to max_call_depth frames (growing moves
+  // it and rebases current_frame)
+  CallFrame *call_stack;
   size_t call_stack_size;
+  size_t call_stack_capacity;
+  size_t max_call_depth;
   CallFrame *current_frame;
 
-  // Global variables
+  // Calls into other modules' VMs in progress (root VM only)
+  size_t module_call_depth;
+
+  // Range loops and for-in iterators of top-level code (functions use their
+  // frame's arrays); range loop state grows like a frame's
+  RangeLoopState *range_loops;
+  size_t range_loop_capacity;
+  IteratorState iterators[ITER_LOOP_DEPTH_MAX];
+  uint32_t live_iterators;
+
+  // Global variables (growable slot vector). A global keeps its index for
+  // the lifetime of the VM; OP_LOAD_GLOBAL/OP_STORE_GLOBAL address it directly
   struct GlobalVar {
     char *name;
     KronosValue *value;
     bool is_mutable;
     char *type_name; // NULL if no type restriction
-  } globals[GLOBALS_MAX];
+  } *globals;
   size_t global_count;
+  size_t global_capacity;
 
-  // Global variable hash table for O(1) lookup
-  // Stores pointers to global variable entries, NULL if empty slot
-  // Collisions handled by linear probing
-  struct GlobalVar *global_hash[GLOBALS_MAX];
+  // Global name index for O(1) lookup by name
+  // Stores slot index + 1 (0 means empty); capacity is a power of two and is
+  // kept at most half full. Collisions handled by linear probing
+  size_t *global_hash;
+  size_t global_hash_capacity;
 
   // Functions
   Function *functions[FUNCTIONS_MAX];
@@ -93,6 +150,24 @@ typedef struct KronosVM {
   // Collisions are handled by linear probing (next available slot)
   Function *function_hash[FUNCTIONS_MAX];
 
+  // Process-unique identity, drawn from the same counter as call epochs.
+  // Unlike the VM's address it is never reused, so it marks the Bytecode
+  // whose global sites this VM has rewritten to its slot indices
+  uint64_t id;
+
+  // OP_CALL_FUNC inline caches (per call site, stored on the Bytecode) are
+  // valid only while their epoch equals call_epoch. Epochs come from a
+  // process-wide counter, so an entry filled by another VM never matches;
+  // vm_define_function() and vm_invalidate_call_caches() draw a new one
+  uint64_t call_epoch;
+  uint64_t call_cache_hits;
+  uint64_t call_cache_misses;
+
+  // Type quickening: generic arithmetic/comparison sites rewritten to their
+  // number-only form, and quickened sites restored after a non-number operand
+  uint64_t quickened;
+  uint64_t dequickened;
+
   // Modules (file-based modules)
   Module *modules[MODULES_MAX];
   size_t module_count;
@@ -108,6 +183,12 @@ typedef struct KronosVM {
   // module)
   KronosVM *root_vm_ref; // NULL for root VM, non-NULL for module VMs
 
+  // Private copy of the code last passed to vm_execute(). Execution
+  // rewrites code in place (global slots, quickened opcodes) and attaches
+  // call caches, so top-level code runs on this copy, which shares the
+  // caller's constant pool. Freed by the next vm_execute() or vm_free()
+  Bytecode run_code;
+
   // Instruction pointer
   uint8_t *ip;
 
@@ -176,7 +257,8 @@ void vm_clear_stack(KronosVM *vm);
  * @brief Execute compiled bytecode in the VM.
  *
  * Runs the bytecode instruction-by-instruction until completion or error.
- * The bytecode remains owned by the caller and is not modified.
+ * The bytecode remains owned by the caller and is not modified: the VM runs
+ * a private copy of the code (see KronosVM.run_code).
  *
  * @param vm VM instance to execute on (must not be NULL).
  * @param bytecode Compiled bytecode to execute (must not be NULL, caller
@@ -225,38 +307,49 @@ int vm_set_global(KronosVM *vm, const char *name, KronosValue *value,
 KronosValue *vm_get_global(KronosVM *vm, const char *name);
 
 /**
- * @brief Set or update a local variable in a call frame.
+ * @brief Remove every global variable from the VM.
  *
- * Similar to vm_set_global but operates on function-local variables.
- * Checks mutability and type constraints if the variable already exists.
+ * Releases names, values and type annotations and empties the name index.
+ * Bytecode that was already specialized to this VM's global slots
+ * (OP_LOAD_GLOBAL/OP_STORE_GLOBAL) must not be executed afterwards.
+ *
+ * @param vm VM instance (may be NULL, in which case this is a no-op).
+ * @note Thread-safety: VM is NOT thread-safe. Caller must synchronize access.
+ */
+void vm_clear_globals(KronosVM *vm);
+
+/**
+ * @brief Set or update a local variable slot in a call frame.
+ *
+ * Similar to vm_set_global but addresses function locals by the slot index
+ * the compiler resolved. The first assignment initializes the slot;
+ * reassignments check the mutability and type constraints from the
+ * function's slot descriptor.
  *
  * @param vm VM instance for error reporting (must not be NULL).
  * @param frame Call frame (must not be NULL).
- * @param name Variable name (copied internally via strdup, caller retains
- * ownership).
+ * @param slot Slot index (must be < frame->slot_count).
  * @param value Value to store. On success the frame retains the value
  * (increments refcount); on failure, ownership stays with the caller.
- * @param is_mutable true for mutable (let), false for immutable (set).
- * @param type_name Type constraint or NULL (copied internally via strdup if
- * non-NULL; ownership stays with caller on failure).
  * @return 0 on success, negative KronosErrorCode on failure.
  * @note Thread-safety: VM is NOT thread-safe. Caller must synchronize access.
  */
-int vm_set_local(KronosVM *vm, CallFrame *frame, const char *name,
-                 KronosValue *value, bool is_mutable, const char *type_name);
+int vm_set_local(KronosVM *vm, CallFrame *frame, size_t slot,
+                 KronosValue *value);
 
 /**
- * @brief Get a local variable from a call frame.
+ * @brief Get a local variable slot from a call frame.
  *
  * @param frame Call frame (must not be NULL).
- * @param name Variable name to look up (must not be NULL).
- * @return Pointer to the value if found, NULL if not found.
+ * @param slot Slot index to read.
+ * @return Pointer to the value if the slot is assigned, NULL if it is out of
+ * range or not assigned yet.
  * @note Returned value is NOT owned by caller (do not free). It remains in the
  * frame.
  * @note To use the value beyond the current scope, call value_retain().
  * @note Thread-safety: VM is NOT thread-safe. Caller must synchronize access.
  */
-KronosValue *vm_get_local(CallFrame *frame, const char *name);
+KronosValue *vm_get_local(CallFrame *frame, size_t slot);
 
 /**
  * @brief Get a variable by name, checking local scope first, then global.
@@ -288,6 +381,85 @@ KronosValue *vm_get_variable(KronosVM *vm, const char *name);
  */
 int vm_define_function(KronosVM *vm, Function *func);
 
+/**
+ * @brief Set the maximum depth of nested function calls.
+ *
+ * Deeper calls fail with "Maximum call depth exceeded". Frames and the
+ * value stack are allocated as calls get deeper, so a high limit costs
+ * nothing until it is used. Tail calls reuse their frame and do not count.
+ * Module VMs loaded by @p vm (now or later) use the same limit.
+ *
+ * @param vm VM instance (must not be NULL).
+ * @param depth Maximum number of active frames (at least 1; the default is
+ * CALL_DEPTH_DEFAULT).
+ * @return 0 on success, negative error code if @p depth is 0 or less than
+ * the number of frames currently active.
+ * @note Thread-safety: VM is NOT thread-safe. Caller must synchronize access.
+ */
+int vm_set_max_call_depth(KronosVM *vm, size_t depth);
+
+/**
+ * @brief Invalidate every OP_CALL_FUNC inline cache filled by this VM.
+ *
+ * Called automatically by vm_define_function(). Call it after removing or
+ * replacing functions by other means (e.g. resetting the function table).
+ *
+ * @param vm VM instance (may be NULL, in which case this is a no-op).
+ * @note Thread-safety: VM is NOT thread-safe. Caller must synchronize access.
+ */
+void vm_invalidate_call_caches(KronosVM *vm);
+
+/**
+ * @brief Call-site cache statistics
+ */
+typedef struct {
+  uint64_t hits;   /**< Calls dispatched from a valid call-site cache entry */
+  uint64_t misses; /**< Calls that resolved the target by name */
+  size_t hit_rate; /**< Percentage of calls that hit (hits/total * 100) */
+} VMCallCacheStats;
+
+/**
+ * @brief Get OP_CALL_FUNC inline cache statistics for this VM.
+ *
+ * Counts cover every call executed by @p vm since it was created (module VMs
+ * keep their own counters).
+ *
+ * @param vm VM instance (must not be NULL).
+ * @param stats Pointer to VMCallCacheStats structure to fill (must not be
+ * NULL).
+ * @note Thread-safety: VM is NOT thread-safe. Caller must synchronize access.
+ */
+void vm_call_cache_stats(const KronosVM *vm, VMCallCacheStats *stats);
+
+/**
+ * @brief Type quickening statistics
+ */
+typedef struct {
+  uint64_t quickened;   /**< Sites rewritten to a typed opcode */
+  uint64_t dequickened; /**< Typed sites (rewritten or compiled in) whose
+                           operand guard failed, sending them back to the
+                           generic opcode */
+  size_t stable_rate;   /**< Percentage of quickenings never undone
+                           ((quickened - dequickened)/quickened * 100) */
+} VMQuickenStats;
+
+/**
+ * @brief Get type quickening statistics for this VM.
+ *
+ * Arithmetic (OP_ADD/SUB/MUL) and ordered comparison sites rewrite
+ * themselves to a number-only opcode after executing on two numbers (string
+ * concatenation and list indexing have typed forms too); the typed opcode
+ * rewrites itself back when its operand guard fails. Sites the compiler
+ * emitted typed are not counted as quickened. A low stable rate means the
+ * program's arithmetic is polymorphic.
+ *
+ * @param vm VM instance (must not be NULL).
+ * @param stats Pointer to VMQuickenStats structure to fill (must not be
+ * NULL).
+ * @note Thread-safety: VM is NOT thread-safe. Caller must synchronize access.
+ */
+void vm_quicken_stats(const KronosVM *vm, VMQuickenStats *stats);
+
 /**
  * @brief Get a function by name from the VM.
  *
@@ -0,0 +1,57 @@
+#include "../../src/frontend/arena.h"
+#include "../framework/test_framework.h"
+#include <stdint.h>
+#include <string.h>
+
+TEST(arena_alloc_aligned_and_counted) {
+  Arena *arena = arena_new();
+  ASSERT_PTR_NOT_NULL(arena);
+  ASSERT_INT_EQ(arena_bytes_used(arena), 0);
+
+  char *name = arena_strndup(arena, "counter_value", 7);
+  ASSERT_STR_EQ(name, "counter");
+
+  // Blocks after packed character data are still aligned for any type
+  double *numbers = arena_calloc(arena, 4, sizeof(double));
+  ASSERT_PTR_NOT_NULL(numbers);
+  ASSERT_INT_EQ((uintptr_t)numbers % _Alignof(max_align_t), 0);
+  ASSERT_DOUBLE_EQ(numbers[3], 0.0);
+  ASSERT_TRUE(arena_bytes_used(arena) >= 8 + 4 * sizeof(double));
+
+  // A request larger than a chunk gets a chunk of its own
+  size_t big = 1024 * 1024;
+  unsigned char *block = arena_alloc(arena, big);
+  ASSERT_PTR_NOT_NULL(block);
+  memset(block, 0xAB, big);
+  ASSERT_STR_EQ(name, "counter");
+
+  arena_free(arena);
+}
+
+TEST(arena_realloc_extends_latest_block) {
+  Arena *arena = arena_new();
+  ASSERT_PTR_NOT_NULL(arena);
+
+  int *items = arena_alloc(arena, 4 * sizeof(int));
+  for (int i = 0; i < 4; i++) {
+    items[i] = i;
+  }
+
+  // The latest allocation grows in place
+  int *grown = arena_realloc(arena, items, 4 * sizeof(int), 8 * sizeof(int));
+  ASSERT_TRUE(grown == items);
+
+  // Once something else is allocated, growing copies
+  char *other = arena_strndup(arena, "x", 1);
+  ASSERT_PTR_NOT_NULL(other);
+  int *moved = arena_realloc(arena, grown, 8 * sizeof(int), 64 * sizeof(int));
+  ASSERT_PTR_NOT_NULL(moved);
+  ASSERT_TRUE(moved != grown);
+  for (int i = 0; i < 4; i++) {
+    ASSERT_INT_EQ(moved[i], i);
+  }
+  ASSERT_STR_EQ(other, "x");
+
+  arena_free(arena);
+  arena_free(NULL);
+}
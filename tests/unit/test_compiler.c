@@ -1,8 +1,11 @@
 #include "../../src/compiler/compiler.h"
+#include "../../src/compiler/inline.h"
+#include "../../src/compiler/ir.h"
 #include "../../src/frontend/parser.h"
 #include "../../src/frontend/tokenizer.h"
 #include "../framework/test_framework.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 static AST *parse_string(const char *source) {
@@ -87,8 +90,11 @@ TEST(compile_if_statement) {
   AST *ast = parse_string("if true:\n    print 1");
   ASSERT_PTR_NOT_NULL(ast);
 
+  // Unoptimized, so the constant condition is still tested at run time
   const char *err = NULL;
+  compiler_set_optimization_level(0);
   Bytecode *bytecode = compile(ast, &err);
+  compiler_set_optimization_level(1);
   ASSERT_PTR_NULL(err);
   ASSERT_PTR_NOT_NULL(bytecode);
 
@@ -129,6 +135,303 @@ TEST(compile_function_definition) {
   ast_free(ast);
 }
 
+TEST(compile_function_locals_use_slots) {
+  AST *ast = parse_string("set g to 1\nfunction f with x:\n    let y to x plus "
+                          "g\n    return y\nprint g");
+  ASSERT_PTR_NOT_NULL(ast);
+
+  const char *err = NULL;
+  Bytecode *bytecode = compile(ast, &err);
+  ASSERT_PTR_NULL(err);
+  ASSERT_PTR_NOT_NULL(bytecode);
+
+  // Parameters and assigned names become slots; the global g stays by name
+  int load_locals = 0;
+  int store_locals = 0;
+  for (size_t i = 0; i + 1 < bytecode->count; i++) {
+    if (bytecode->code[i] == OP_LOAD_LOCAL && bytecode->code[i + 1] <= 1) {
+      load_locals++;
+    } else if (bytecode->code[i] == OP_STORE_LOCAL &&
+               bytecode->code[i + 1] == 1) {
+      store_locals++;
+    }
+  }
+  ASSERT_TRUE(load_locals >= 2);
+  ASSERT_TRUE(store_locals >= 1);
+
+  bytecode_free(bytecode);
+  ast_free(ast);
+}
+
+TEST(compile_output_is_verified) {
+  AST *ast = parse_string(
+      "function f with n:\n    let total to 0\n    for i in range 1 to n:\n"
+      "        let total to total plus i\n    return total\n"
+      "try:\n    raise ValueError \"bad\"\ncatch e:\n    print e\n"
+      "finally:\n    print \"done\"\n"
+      "while false:\n    print 1\nprint call f with 3");
+  ASSERT_PTR_NOT_NULL(ast);
+
+  const char *err = NULL;
+  Bytecode *bytecode = compile(ast, &err);
+  ASSERT_PTR_NULL(err);
+  ASSERT_PTR_NOT_NULL(bytecode);
+  ASSERT_TRUE(bytecode->verified);
+
+  const char *verify_err = "unset";
+  ASSERT_TRUE(bytecode_verify(bytecode, &verify_err));
+  ASSERT_PTR_NULL(verify_err);
+
+  bytecode_free(bytecode);
+  ast_free(ast);
+}
+
+TEST(compile_range_loop_uses_fused_opcodes) {
+  AST *ast = parse_string("for i in range 1 to 10 by 2:\n"
+                          "    for j in range i to 1 by -1:\n"
+                          "        print j\nprint i");
+  ASSERT_PTR_NOT_NULL(ast);
+
+  const char *err = NULL;
+  Bytecode *bytecode = compile(ast, &err);
+  ASSERT_PTR_NULL(err);
+  ASSERT_PTR_NOT_NULL(bytecode);
+  ASSERT_TRUE(bytecode->verified);
+
+  // One PREP/NEXT pair per loop, each at its own nesting depth, and no
+  // generic compare or add left in the loop control
+  int preps = 0;
+  int nexts = 0;
+  bool has_compare = false;
+  for (size_t i = 0; i < bytecode->count; i++) {
+    uint8_t op = bytecode->code[i];
+    if (op == OP_FOR_RANGE_PREP) {
+      ASSERT_INT_EQ(bytecode->code[i + 1], preps);
+      preps++;
+      i += 3;
+    } else if (op == OP_FOR_RANGE_NEXT) {
+      // Inner loop closes first
+      ASSERT_INT_EQ(bytecode->code[i + 1], 1 - nexts);
+      nexts++;
+      i += 3;
+    } else if (op == OP_LTE || op == OP_GTE || op == OP_ADD) {
+      has_compare = true;
+    }
+  }
+  ASSERT_INT_EQ(preps, 2);
+  ASSERT_INT_EQ(nexts, 2);
+  ASSERT_FALSE(has_compare);
+
+  bytecode_free(bytecode);
+  ast_free(ast);
+}
+
+TEST(compile_fuses_compare_branch_and_increment) {
+  AST *ast = parse_string("let i to 0\n"
+                          "while i is less than 3:\n"
+                          "    let i to i plus 1\n");
+  ASSERT_PTR_NOT_NULL(ast);
+
+  const char *err = NULL;
+  Bytecode *bytecode = compile(ast, &err);
+  ASSERT_PTR_NULL(err);
+  ASSERT_PTR_NOT_NULL(bytecode);
+  ASSERT_TRUE(bytecode->verified);
+
+  // The loop test is CMP_JUMP_IF_FALSE LT [exit offset] and the body is
+  // INC_VAR_CONST i 1 (then the STORE_VAR operands), then JUMP back
+  const uint8_t *code = bytecode->code;
+  size_t cmp = 0;
+  size_t inc = 0;
+  for (size_t i = 0; i + 3 < bytecode->count; i++) {
+    if (!cmp && code[i] == OP_CMP_JUMP_IF_FALSE && code[i + 1] == OP_LT) {
+      cmp = i;
+    }
+    if (cmp && !inc && i > cmp && code[i] == OP_INC_VAR_CONST) {
+      inc = i;
+    }
+  }
+  ASSERT_TRUE(cmp > 0);
+  ASSERT_TRUE(inc > cmp);
+  const KronosValue *name = bytecode->constants[code[inc + 1] << 8 |
+                                                code[inc + 2]];
+  const KronosValue *step = bytecode->constants[code[inc + 3] << 8 |
+                                                code[inc + 4]];
+  ASSERT_STR_EQ(name->as.string.data, "i");
+  ASSERT_DOUBLE_EQ(value_as_number(step), 1.0);
+
+  // The exit jump lands just past the back jump, which returns to the test
+  size_t exit = cmp + 4 + (size_t)(int16_t)(code[cmp + 2] << 8 |
+                                            code[cmp + 3]);
+  ASSERT_TRUE(exit <= bytecode->count && exit >= 3);
+  ASSERT_INT_EQ(code[exit - 3], OP_JUMP);
+  int16_t back = (int16_t)(code[exit - 2] << 8 | code[exit - 1]);
+  ASSERT_TRUE(back < 0);
+  ASSERT_TRUE((size_t)((int64_t)exit + back) < cmp);
+
+  bytecode_free(bytecode);
+  ast_free(ast);
+
+  ast = parse_string("function f with n:\n"
+                     "    let n to n plus 2\n"
+                     "    return n\n");
+  ASSERT_PTR_NOT_NULL(ast);
+  bytecode = compile(ast, &err);
+  ASSERT_PTR_NULL(err);
+  ASSERT_PTR_NOT_NULL(bytecode);
+
+  bool has_inc_local = false;
+  for (size_t i = 0; i + 3 < bytecode->count; i++) {
+    if (bytecode->code[i] == OP_INC_LOCAL_CONST &&
+        bytecode->code[i + 1] == 0) {
+      has_inc_local = true;
+    }
+  }
+  ASSERT_TRUE(has_inc_local);
+
+  bytecode_free(bytecode);
+  ast_free(ast);
+}
+
+static bool bytecode_has_opcode(const Bytecode *bytecode, uint8_t opcode) {
+  for (size_t i = 0; i < bytecode->count; i++) {
+    if (bytecode->code[i] == opcode) {
+      return true;
+    }
+  }
+  return false;
+}
+
+TEST(compile_specializes_provable_types) {
+  AST *ast = parse_string("for i in range 1 to 10:\n"
+                          "    print i times 2 plus 1\n"
+                          "    if i is greater than 5:\n"
+                          "        print (\"big\" at 0) plus \"!\"\n"
+                          "    print (list 1, 2) at 0\n");
+  ASSERT_PTR_NOT_NULL(ast);
+
+  const char *err = NULL;
+  Bytecode *bytecode = compile(ast, &err);
+  ASSERT_PTR_NULL(err);
+  ASSERT_PTR_NOT_NULL(bytecode);
+  ASSERT_TRUE(bytecode->verified);
+  ASSERT_TRUE(bytecode_has_opcode(bytecode, OP_MUL_NUM));
+  ASSERT_TRUE(bytecode_has_opcode(bytecode, OP_ADD_NUM));
+  ASSERT_TRUE(bytecode_has_opcode(bytecode, OP_CMP_JUMP_IF_FALSE_NUM));
+  ASSERT_TRUE(bytecode_has_opcode(bytecode, OP_CONCAT_STR));
+  ASSERT_TRUE(bytecode_has_opcode(bytecode, OP_INDEX_LIST));
+
+  bytecode_free(bytecode);
+  ast_free(ast);
+
+  // A rebound counter and an unknown variable stay generic
+  ast = parse_string("for i in range 1 to 10:\n"
+                     "    print i plus 1\n"
+                     "    let i to \"x\"\n"
+                     "print y plus 1\n");
+  ASSERT_PTR_NOT_NULL(ast);
+  bytecode = compile(ast, &err);
+  ASSERT_PTR_NULL(err);
+  ASSERT_PTR_NOT_NULL(bytecode);
+  ASSERT_TRUE(bytecode_has_opcode(bytecode, OP_ADD));
+  ASSERT_FALSE(bytecode_has_opcode(bytecode, OP_ADD_NUM));
+
+  bytecode_free(bytecode);
+  ast_free(ast);
+}
+
+TEST(compile_for_in_uses_frame_iterators) {
+  AST *ast = parse_string("function f with m:\n"
+                          "    for k, v in m:\n"
+                          "        for ch in k:\n"
+                          "            print ch\n"
+                          "    return k\n"
+                          "for x in list 1, 2:\n    print x");
+  ASSERT_PTR_NOT_NULL(ast);
+
+  const char *err = NULL;
+  Bytecode *bytecode = compile(ast, &err);
+  ASSERT_PTR_NULL(err);
+  ASSERT_PTR_NOT_NULL(bytecode);
+  ASSERT_TRUE(bytecode->verified);
+
+  // Three loops, each with its own PREP/NEXT/CLOSE; the nested one gets the
+  // next depth, and only the key/value loop iterates pairs
+  int preps = 0;
+  int closes = 0;
+  int pair_loops = 0;
+  int max_depth = 0;
+  for (size_t i = 0; i + 1 < bytecode->count; i++) {
+    if (bytecode->code[i] == OP_ITER_PREP) {
+      preps++;
+      pair_loops += bytecode->code[i + 2];
+      if (bytecode->code[i + 1] > max_depth) {
+        max_depth = bytecode->code[i + 1];
+      }
+      i += 4;
+    } else if (bytecode->code[i] == OP_ITER_CLOSE) {
+      closes++;
+      i += 1;
+    }
+  }
+  ASSERT_INT_EQ(preps, 3);
+  ASSERT_INT_EQ(closes, 3);
+  ASSERT_INT_EQ(pair_loops, 1);
+  ASSERT_INT_EQ(max_depth, 1);
+
+  bytecode_free(bytecode);
+  ast_free(ast);
+}
+
+TEST(verify_rejects_malformed_bytecode) {
+  AST *ast = parse_string("let x to 1\nwhile x is less than 3:\n"
+                          "    let x to x plus 1\nprint x");
+  ASSERT_PTR_NOT_NULL(ast);
+
+  const char *err = NULL;
+  Bytecode *bytecode = compile(ast, &err);
+  ASSERT_PTR_NOT_NULL(bytecode);
+  ASSERT_TRUE(bytecode->verified);
+
+  // Backward loop jump retargeted one byte later lands mid-instruction
+  size_t jump_pos = 0;
+  for (size_t i = 0; i + 2 < bytecode->count; i++) {
+    if (bytecode->code[i] == OP_JUMP) {
+      jump_pos = i;
+    }
+  }
+  ASSERT_TRUE(bytecode->code[jump_pos] == OP_JUMP);
+  uint8_t saved = bytecode->code[jump_pos + 2];
+  bytecode->code[jump_pos + 2] = (uint8_t)(saved + 1);
+  const char *verify_err = NULL;
+  ASSERT_FALSE(bytecode_verify(bytecode, &verify_err));
+  ASSERT_PTR_NOT_NULL(verify_err);
+  ASSERT_FALSE(bytecode->verified);
+  bytecode->code[jump_pos + 2] = saved;
+  ASSERT_TRUE(bytecode_verify(bytecode, NULL));
+
+  // Constant index past the pool
+  ASSERT_INT_EQ(bytecode->code[0], OP_LOAD_CONST);
+  bytecode->code[1] = 0xFF;
+  ASSERT_FALSE(bytecode_verify(bytecode, &verify_err));
+  bytecode->code[1] = 0;
+
+  // Truncated operand at the end of the code
+  size_t count = bytecode->count;
+  bytecode->code[count - 1] = OP_LOAD_CONST;
+  ASSERT_FALSE(bytecode_verify(bytecode, &verify_err));
+  bytecode->code[count - 1] = OP_HALT;
+
+  // Reserved opcode
+  bytecode->code[count - 1] = OP_RETHROW;
+  ASSERT_FALSE(bytecode_verify(bytecode, &verify_err));
+  bytecode->code[count - 1] = OP_HALT;
+  ASSERT_TRUE(bytecode_verify(bytecode, NULL));
+
+  bytecode_free(bytecode);
+  ast_free(ast);
+}
+
 TEST(compile_list_literal) {
   AST *ast = parse_string("set mylist to list 1, 2, 3");
   ASSERT_PTR_NOT_NULL(ast);
@@ -225,3 +528,470 @@ TEST(compile_loop_large_offset_continue) {
   }
   ast_free(ast);
 }
+
+static size_t compiled_size(const char *source, int level) {
+  compiler_set_optimization_level(level);
+  AST *ast = parse_string(source);
+  const char *err = NULL;
+  Bytecode *bytecode = ast ? compile(ast, &err) : NULL;
+  compiler_set_optimization_level(1);
+  size_t size = bytecode ? bytecode->count : 0;
+  bytecode_free(bytecode);
+  ast_free(ast);
+  return size;
+}
+
+TEST(compile_optimizes_constants_and_dead_code) {
+  // Folded to LOAD_CONST 14, PRINT, HALT
+  ASSERT_INT_EQ(compiled_size("print 2 plus 3 times 4", 1), 5);
+  ASSERT_TRUE(compiled_size("print 2 plus 3 times 4", 0) > 5);
+  // Division by zero and -0 are left to the VM
+  ASSERT_TRUE(compiled_size("print 1 divided by 0", 1) > 5);
+  ASSERT_TRUE(compiled_size("print 0 times -1", 1) > 5);
+
+  // Constant branches and unreachable statements emit nothing
+  size_t plain = compiled_size("print 2", 1);
+  ASSERT_INT_EQ(compiled_size("if 1 is greater than 2:\n    print 1\n"
+                              "print 2",
+                              1),
+                plain);
+  ASSERT_INT_EQ(compiled_size("while false:\n    print 1\nprint 2", 1), plain);
+  ASSERT_INT_EQ(compiled_size("function f:\n    return 1\n", 1),
+                compiled_size("function f:\n    return 1\n"
+                              "    print 2\n",
+                              1));
+
+  // Dead code is still checked
+  AST *ast = parse_string("if false:\n    break\n");
+  ASSERT_PTR_NOT_NULL(ast);
+  const char *err = NULL;
+  Bytecode *bytecode = compile(ast, &err);
+  ASSERT_PTR_NULL(bytecode);
+  ASSERT_PTR_NOT_NULL(err);
+  ASSERT_TRUE(strstr(err, "break statement outside of loop") != NULL);
+  ast_free(ast);
+}
+
+TEST(compile_folds_constant_if) {
+  // At -O1 `if true:` keeps its block and drops the test: the same code as
+  // the block alone (LOAD_CONST 1, PRINT, HALT)
+  AST *ast = parse_string("if true:\n    print 1");
+  ASSERT_PTR_NOT_NULL(ast);
+  const char *err = NULL;
+  Bytecode *bytecode = compile(ast, &err);
+  ASSERT_PTR_NULL(err);
+  ASSERT_PTR_NOT_NULL(bytecode);
+  ASSERT_FALSE(bytecode_has_opcode(bytecode, OP_JUMP_IF_FALSE));
+  ASSERT_INT_EQ((int)bytecode->count, 5);
+  ASSERT_INT_EQ(bytecode->code[0], OP_LOAD_CONST);
+  ASSERT_INT_EQ(bytecode->code[3], OP_PRINT);
+  ASSERT_INT_EQ(bytecode->code[4], OP_HALT);
+  ASSERT_INT_EQ(value_type(bytecode->constants[0]), VAL_NUMBER);
+  ASSERT_DOUBLE_EQ(value_as_number(bytecode->constants[0]), 1.0);
+  bytecode_free(bytecode);
+  ast_free(ast);
+}
+
+TEST(compile_threads_jumps_to_jumps) {
+  // The if block's skip jump lands on the loop's back edge and is threaded
+  // straight to the loop head
+  AST *ast = parse_string("let i to 0\n"
+                          "while i is less than 3:\n"
+                          "    if i is equal 1:\n"
+                          "        print 1\n"
+                          "    else:\n"
+                          "        print 2\n");
+  ASSERT_PTR_NOT_NULL(ast);
+
+  const char *err = NULL;
+  Bytecode *bytecode = compile(ast, &err);
+  ASSERT_PTR_NULL(err);
+  ASSERT_PTR_NOT_NULL(bytecode);
+  ASSERT_TRUE(bytecode->verified);
+
+  size_t skip = 0;
+  for (size_t i = 0; i + 3 < bytecode->count; i++) {
+    if (bytecode->code[i] == OP_PRINT && bytecode->code[i + 1] == OP_JUMP) {
+      skip = i + 1;
+      break;
+    }
+  }
+  ASSERT_TRUE(skip > 0);
+  int16_t offset =
+      (int16_t)((bytecode->code[skip + 1] << 8) | bytecode->code[skip + 2]);
+  size_t target = (size_t)((int64_t)skip + 3 + offset);
+  ASSERT_TRUE(target < skip);
+  ASSERT_TRUE(bytecode->code[target] != OP_JUMP);
+
+  bytecode_free(bytecode);
+  ast_free(ast);
+}
+
+TEST(ir_optimizes_function_bodies) {
+  AST *ast = parse_string("function f with n, k:\n"
+                          "    let a to n\n"
+                          "    let b to a\n"
+                          "    let unused to 1\n"
+                          "    let s to k times 3\n"
+                          "    let t to 0\n"
+                          "    for i in range 1 to n:\n"
+                          "        let t to t plus (s times s minus 1)\n"
+                          "    let t to t plus (b times k minus 1)\n"
+                          "    return t plus (b times k minus 1)\n");
+  ASSERT_PTR_NOT_NULL(ast);
+  ASSERT_INT_EQ(ast->count, 1);
+
+  IRLocal locals[] = {{"n", true}, {"k", true}, {"a", true},
+                      {"b", true}, {"unused", true}, {"s", true},
+                      {"t", true}, {"i", true}};
+  size_t local_count = sizeof(locals) / sizeof(locals[0]);
+  IRPlan *plan =
+      ir_optimize_function(ast->statements[0], locals, local_count, 8);
+  ASSERT_PTR_NOT_NULL(plan);
+  const IRStats *stats = ir_plan_stats(plan);
+  // Reads of b load a, and a's read of n loads n
+  ASSERT_INT_EQ(stats->copies, 3);
+  // `b to a` is no longer read, `unused to 1` never was
+  ASSERT_INT_EQ(stats->dropped, 2);
+  ASSERT_INT_EQ(stats->reused, 1);
+  // s is a number, so `s times s minus 1` cannot fail and leaves the loop
+  ASSERT_INT_EQ(stats->hoisted, 1);
+  ASSERT_INT_EQ(ir_plan_temp_count(plan), 2);
+  ASSERT_PTR_NOT_NULL(ir_plan_lookup(plan, ast->statements[0]->as.function
+                                               .block[5]));
+  ir_plan_free(plan);
+
+  // Only the reused value is limited by the temps left
+  plan = ir_optimize_function(ast->statements[0], locals, local_count, 1);
+  ASSERT_PTR_NOT_NULL(plan);
+  ASSERT_INT_EQ(ir_plan_temp_count(plan), 1);
+  ir_plan_free(plan);
+  ast_free(ast);
+}
+
+TEST(ir_keeps_observable_behavior) {
+  // A local read before its first assignment falls back to the global, so
+  // it is neither a copy nor a number; an immutable store can fail, so it
+  // stays; try blocks are not modelled at all
+  AST *ast = parse_string("function f with n:\n"
+                          "    let x to g\n"
+                          "    let g to n\n"
+                          "    set c to x\n"
+                          "    while n is greater than x:\n"
+                          "        let n to n minus (x times 2)\n"
+                          "    return n plus g\n"
+                          "function h:\n"
+                          "    try:\n"
+                          "        let y to 1\n"
+                          "    catch error:\n"
+                          "        let y to 2\n"
+                          "    return y\n");
+  ASSERT_PTR_NOT_NULL(ast);
+  ASSERT_INT_EQ(ast->count, 2);
+
+  IRLocal locals[] = {{"n", true}, {"x", true}, {"g", true}, {"c", false}};
+  // Nothing to change: no plan
+  ASSERT_PTR_NULL(ir_optimize_function(ast->statements[0], locals, 4, 8));
+
+  IRLocal try_locals[] = {{"y", true}, {"error", true}};
+  ASSERT_PTR_NULL(ir_build_function(ast->statements[1], try_locals, 2));
+  ast_free(ast);
+}
+
+// Function f(n) whose body multiplies t by n @p lines times
+static AST *parse_repeated_body(size_t lines) {
+  const char *head = "function f with n:\n    let t to 0\n";
+  const char *line = "    let t to t times n\n";
+  char *source = malloc(strlen(head) + lines * strlen(line) + 1);
+  if (!source) {
+    return NULL;
+  }
+  strcpy(source, head);
+  char *end = source + strlen(head);
+  for (size_t i = 0; i < lines; i++) {
+    memcpy(end, line, strlen(line));
+    end += strlen(line);
+  }
+  *end = '\0';
+  AST *ast = parse_string(source);
+  free(source);
+  return ast;
+}
+
+TEST(ir_skips_very_large_bodies) {
+  IRLocal locals[] = {{"n", true}, {"t", true}};
+  AST *ast = parse_repeated_body(100);
+  ASSERT_PTR_NOT_NULL(ast);
+  IRFunction *fn = ir_build_function(ast->statements[0], locals, 2);
+  ASSERT_PTR_NOT_NULL(fn);
+  ir_function_free(fn);
+  ast_free(ast);
+
+  // About 40k SSA values: over the IR's size limit, so the body compiles
+  // without it instead of spending compile time on the passes
+  ast = parse_repeated_body(10000);
+  ASSERT_PTR_NOT_NULL(ast);
+  ASSERT_PTR_NULL(ir_build_function(ast->statements[0], locals, 2));
+  ast_free(ast);
+}
+
+static bool test_is_builtin(const char *name) {
+  return strcmp(name, "len") == 0;
+}
+
+TEST(inline_table_finds_leaf_functions) {
+  AST *ast = parse_string("function square with x:\n"
+                          "    return x times x\n"
+                          "function scaled with x:\n"
+                          "    let y to x times k\n"
+                          "    print y\n"
+                          "    return y plus 1\n"
+                          "function twice with x:\n"
+                          "    return x\n"
+                          "function len with x:\n"
+                          "    return 0\n"
+                          "function caller with x:\n"
+                          "    return call square with x\n"
+                          "function early with x:\n"
+                          "    let y to y plus x\n"
+                          "    return y\n"
+                          "if true:\n"
+                          "    function twice with x:\n"
+                          "        return x\n");
+  ASSERT_PTR_NOT_NULL(ast);
+
+  // Without a built-in table nothing can be proven
+  ASSERT_PTR_NULL(inline_table_build(ast, NULL));
+
+  InlineTable *table = inline_table_build(ast, test_is_builtin);
+  ASSERT_PTR_NOT_NULL(table);
+  InlineCandidate *square = inline_table_find(table, "square");
+  ASSERT_PTR_NOT_NULL(square);
+  ASSERT_INT_EQ(square->local_count, 1);
+  ASSERT_INT_EQ(square->global_count, 0);
+  ASSERT_STR_EQ(inline_hidden_name(square, "x"), "(square.x)");
+
+  InlineCandidate *scaled = inline_table_find(table, "scaled");
+  ASSERT_PTR_NOT_NULL(scaled);
+  ASSERT_INT_EQ(scaled->local_count, 2);
+  ASSERT_INT_EQ(scaled->global_count, 1);
+  ASSERT_STR_EQ(scaled->globals[0], "k");
+  ASSERT_PTR_NULL(inline_hidden_name(scaled, "k"));
+
+  // Defined twice, shadowed by a built-in, not a leaf, reads a global
+  // before assigning the local of the same name
+  ASSERT_PTR_NULL(inline_table_find(table, "twice"));
+  ASSERT_PTR_NULL(inline_table_find(table, "len"));
+  ASSERT_PTR_NULL(inline_table_find(table, "caller"));
+  ASSERT_PTR_NULL(inline_table_find(table, "early"));
+
+  inline_table_free(table);
+  ast_free(ast);
+}
+
+static Bytecode *compile_source(const char *source) {
+  AST *ast = parse_string(source);
+  const char *err = NULL;
+  Bytecode *bytecode = ast ? compile(ast, &err) : NULL;
+  ast_free(ast);
+  return bytecode;
+}
+
+static bool compiled_has_opcode(const char *source, uint8_t opcode) {
+  Bytecode *bytecode = compile_source(source);
+  bool found = bytecode && bytecode_has_opcode(bytecode, opcode);
+  bytecode_free(bytecode);
+  return found;
+}
+
+TEST(compile_inlines_small_functions) {
+  // Inlined, `x times x` multiplies the loop counter, a number; compiled
+  // as a call, x is unknown and the multiply stays generic
+  const char *source = "function square with x:\n"
+                       "    return x times x\n"
+                       "function total with n:\n"
+                       "    let t to 0\n"
+                       "    for i in range 1 to n:\n"
+                       "        let t to t plus call square with i\n"
+                       "    return t\n";
+  compiler_set_builtin_lookup(test_is_builtin);
+  ASSERT_TRUE(compiled_has_opcode(source, OP_MUL_NUM));
+
+  compiler_set_inlining(false);
+  ASSERT_FALSE(compiled_has_opcode(source, OP_MUL_NUM));
+  compiler_set_inlining(true);
+
+  compiler_set_optimization_level(0);
+  ASSERT_FALSE(compiled_has_opcode(source, OP_MUL_NUM));
+  compiler_set_optimization_level(1);
+
+  // A built-in of the same name wins over the function
+  ASSERT_FALSE(compiled_has_opcode("function len with x:\n"
+                                   "    return x times x\n"
+                                   "function total with n:\n"
+                                   "    let t to 0\n"
+                                   "    for i in range 1 to n:\n"
+                                   "        let t to t plus call len with i\n"
+                                   "    return t\n",
+                                   OP_MUL_NUM));
+
+  // Top-level calls stay calls
+  ASSERT_FALSE(compiled_has_opcode("function square with x:\n"
+                                   "    return x times x\n"
+                                   "for i in range 1 to 10:\n"
+                                   "    print call square with i\n",
+                                   OP_MUL_NUM));
+  compiler_set_builtin_lookup(NULL);
+}
+
+static int warning_count = 0;
+
+static void count_warning(const char *message) {
+  (void)message;
+  warning_count++;
+}
+
+TEST(compile_inlined_body_warns_once) {
+  // The definition of f reports the division by zero; its copy inlined
+  // into g does not report it again
+  compiler_set_builtin_lookup(test_is_builtin);
+  compiler_set_warning_callback(count_warning);
+  warning_count = 0;
+  ASSERT_TRUE(compiled_has_opcode("function f with x:\n"
+                                  "    return x divided by 0\n"
+                                  "function g with y:\n"
+                                  "    return call f with y\n",
+                                  OP_DIV));
+  compiler_set_warning_callback(NULL);
+  compiler_set_builtin_lookup(NULL);
+  ASSERT_INT_EQ(warning_count, 1);
+}
+
+TEST(compile_emits_tail_calls) {
+  // Only `return call` in a function body, outside try statements
+  ASSERT_TRUE(compiled_has_opcode("function f with n:\n"
+                                  "    return call f with n\n",
+                                  OP_TAIL_CALL));
+  ASSERT_FALSE(compiled_has_opcode("function f with n:\n"
+                                   "    return 1 plus call f with n\n",
+                                   OP_TAIL_CALL));
+  ASSERT_FALSE(compiled_has_opcode("function f with n:\n"
+                                   "    try:\n"
+                                   "        return call f with n\n"
+                                   "    catch error:\n"
+                                   "        return 0\n",
+                                   OP_TAIL_CALL));
+  ASSERT_FALSE(compiled_has_opcode("print call len with \"ab\"\n",
+                                   OP_TAIL_CALL));
+}
+
+TEST(compile_widens_large_units) {
+  // A loop body past 32 KB needs 32-bit jump offsets
+  const char *line = "    let y to x plus 1\n";
+  size_t lines = 4000;
+  char *source = malloc(strlen(line) * lines + 64);
+  ASSERT_PTR_NOT_NULL(source);
+  char *p = source;
+  p += sprintf(p, "let x to 0\nwhile x is less than 3:\n");
+  for (size_t i = 0; i < lines; i++) {
+    p += sprintf(p, "%s", line);
+  }
+  sprintf(p, "    let x to x plus 1\n");
+
+  AST *ast = parse_string(source);
+  free(source);
+  ASSERT_PTR_NOT_NULL(ast);
+  const char *err = NULL;
+  Bytecode *bytecode = compile(ast, &err);
+  ASSERT_PTR_NULL(err);
+  ASSERT_PTR_NOT_NULL(bytecode);
+  ASSERT_TRUE(bytecode->count > 32768);
+  ASSERT_TRUE(bytecode_has_opcode(bytecode, OP_WIDE));
+  ASSERT_TRUE(bytecode->verified);
+  bytecode_free(bytecode);
+  ast_free(ast);
+
+  // Small units keep 16-bit operands
+  ASSERT_FALSE(compiled_has_opcode("let x to 0\nwhile x is less than 3:\n"
+                                   "    let x to x plus 1\n",
+                                   OP_WIDE));
+}
+
+TEST(verify_checks_wide_operands) {
+  // [WIDE LOAD_CONST 65536][WIDE STORE_VAR 65537 mutable untyped][HALT]
+  const uint8_t code[] = {OP_WIDE, OP_LOAD_CONST, 0, 1, 0, 0,
+                          OP_WIDE, OP_STORE_VAR, 0, 1, 0, 1, 1, 0,
+                          OP_HALT};
+  Bytecode *bytecode = calloc(1, sizeof(Bytecode));
+  ASSERT_PTR_NOT_NULL(bytecode);
+  bytecode->code = malloc(sizeof(code));
+  bytecode->constants = calloc(65538, sizeof(KronosValue *));
+  ASSERT_PTR_NOT_NULL(bytecode->code);
+  ASSERT_PTR_NOT_NULL(bytecode->constants);
+  memcpy(bytecode->code, code, sizeof(code));
+  bytecode->count = bytecode->capacity = sizeof(code);
+  bytecode->const_count = bytecode->const_capacity = 65538;
+  for (size_t i = 0; i < 65536; i++) {
+    bytecode->constants[i] = value_new_nil();
+  }
+  bytecode->constants[65536] = value_new_number(7);
+  bytecode->constants[65537] = value_new_string("w", 1);
+
+  const char *verify_err = NULL;
+  ASSERT_TRUE(bytecode_verify(bytecode, &verify_err));
+  ASSERT_PTR_NULL(verify_err);
+
+  // Wide index past the pool
+  bytecode->code[3] = 2;
+  ASSERT_FALSE(bytecode_verify(bytecode, &verify_err));
+  bytecode->code[3] = 1;
+
+  // OP_WIDE before an opcode without wide operands
+  bytecode->code[1] = OP_ADD;
+  ASSERT_FALSE(bytecode_verify(bytecode, &verify_err));
+  ASSERT_PTR_NOT_NULL(verify_err);
+  bytecode->code[1] = OP_LOAD_CONST;
+
+  // OP_WIDE with no instruction after it
+  bytecode->code[sizeof(code) - 1] = OP_WIDE;
+  ASSERT_FALSE(bytecode_verify(bytecode, &verify_err));
+  bytecode->code[sizeof(code) - 1] = OP_HALT;
+  ASSERT_TRUE(bytecode_verify(bytecode, NULL));
+
+  bytecode_free(bytecode);
+}
+
+TEST(compile_deduplicates_constants) {
+  // Equal literals share a slot; numbers compare exactly, not within the
+  // runtime's equality epsilon
+  Bytecode *bytecode = compile_source(
+      "print \"a\"\nprint 0.0000000001\nprint \"a\"\n"
+      "print 0.0000000002\nprint 0.0000000001\nprint 1\nprint \"1\"\n");
+  ASSERT_PTR_NOT_NULL(bytecode);
+  ASSERT_INT_EQ((int)bytecode->const_count, 5);
+  bytecode_free(bytecode);
+
+  // Constants of a discarded dead block leave the pool and its index
+  bytecode = compile_source("print \"a\"\nif false:\n    print \"b\"\n"
+                            "    print \"c\"\nprint \"c\"\nprint \"a\"\n");
+  ASSERT_PTR_NOT_NULL(bytecode);
+  ASSERT_INT_EQ((int)bytecode->const_count, 2);
+  ASSERT_STR_EQ(bytecode->constants[1]->as.string.data, "c");
+  bytecode_free(bytecode);
+
+  // 100k distinct literals: indices past 16 bits go wide
+  size_t lines = 100000;
+  char *source = malloc(lines * 32);
+  ASSERT_PTR_NOT_NULL(source);
+  char *p = source;
+  for (size_t i = 0; i < lines; i++) {
+    p += sprintf(p, i % 2 ? "let n to %zu\n" : "let s to \"row %zu\"\n", i);
+  }
+  bytecode = compile_source(source);
+  free(source);
+  ASSERT_PTR_NOT_NULL(bytecode);
+  ASSERT_INT_EQ((int)bytecode->const_count, (int)lines + 2);
+  ASSERT_TRUE(bytecode_has_opcode(bytecode, OP_WIDE));
+  ASSERT_TRUE(bytecode->verified);
+  bytecode_free(bytecode);
+}
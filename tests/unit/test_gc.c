@@ -1,6 +1,7 @@
 #include "../../src/core/gc.h"
 #include "../../src/core/runtime.h"
 #include "../framework/test_framework.h"
+#include <pthread.h>
 
 TEST(gc_init_cleanup) {
   // Should not crash
@@ -11,20 +12,34 @@ TEST(gc_init_cleanup) {
 TEST(gc_track_untrack) {
   gc_init();
 
-  KronosValue *val = value_new_number(42);
+  // Heap objects are tracked by their factory
+  KronosValue *val = value_new_string("hello", 5);
   ASSERT_PTR_NOT_NULL(val);
 
-  // Track the value
-  gc_track(val);
-
   // Get object count
   size_t count = gc_get_object_count();
   ASSERT_TRUE(count >= 1);
 
   // Untrack
   gc_untrack(val);
+  ASSERT_INT_EQ(gc_get_object_count(), count - 1);
+
+  // Tracking is idempotent, and one untrack balances it
+  gc_track(val);
+  gc_track(val);
+  ASSERT_INT_EQ(gc_get_object_count(), count);
+  gc_untrack(val);
+  gc_untrack(val);
+  ASSERT_INT_EQ(gc_get_object_count(), count - 1);
+
+  // The static nil cell has no header and is never tracked
+  KronosValue *nil = value_new_nil();
+  gc_track(nil);
+  ASSERT_INT_EQ(gc_get_object_count(), count - 1);
+  gc_untrack(nil);
 
-  // Release the value
+  // Release the values
+  value_release(nil);
   value_release(val);
 
   gc_cleanup();
@@ -55,13 +70,14 @@ TEST(gc_get_object_count) {
 
   size_t initial_count = gc_get_object_count();
 
-  KronosValue *val = value_new_number(42);
-  gc_track(val);
+  KronosValue *val = value_new_list(4);
+  gc_track(val); // Already tracked by value_new_list: no-op
 
   size_t after_track = gc_get_object_count();
-  ASSERT_TRUE(after_track > initial_count);
+  ASSERT_INT_EQ(after_track, initial_count + 1);
 
   gc_untrack(val);
+  ASSERT_INT_EQ(gc_get_object_count(), initial_count);
   value_release(val);
 
   gc_cleanup();
@@ -109,8 +125,7 @@ TEST(gc_cleanup_nested_list) {
     ASSERT_TRUE(false); // Test setup error
   }
 
-  // Retain child since parent will hold a reference
-  value_retain(child);
+  // Hand the child's only reference to the parent, so cleanup frees both
 
   // Add child to parent's items array
   parent->as.list.items[parent->as.list.count] = child;
@@ -124,3 +139,105 @@ TEST(gc_cleanup_nested_list) {
 
   // If we get here without crashing, the fix worked
 }
+
+static void *allocate_on_thread(void *arg) {
+  KronosValue **out = arg;
+  *out = value_new_string("thread", 6);
+  return NULL;
+}
+
+TEST(gc_stats_sum_thread_heaps) {
+  gc_init();
+
+  GCStats before;
+  gc_stats(&before);
+
+  // Untracking subtracts exactly what tracking charged, even after the list
+  // has grown
+  KronosValue *list = value_new_list(4);
+  ASSERT_PTR_NOT_NULL(list);
+  KronosValue **items = gc_realloc(list->as.list.items,
+                                  4 * sizeof(KronosValue *),
+                                  64 * sizeof(KronosValue *));
+  ASSERT_PTR_NOT_NULL(items);
+  list->as.list.items = items;
+  list->as.list.capacity = 64;
+  value_release(list);
+  ASSERT_INT_EQ(gc_get_allocated_bytes(), before.allocated_bytes);
+
+  // An object created on another thread is charged to that thread's heap,
+  // and moves to the orphan heap when the thread exits
+  KronosValue *orphan = NULL;
+  pthread_t thread;
+  ASSERT_INT_EQ(pthread_create(&thread, NULL, allocate_on_thread, &orphan), 0);
+  ASSERT_INT_EQ(pthread_join(thread, NULL), 0);
+  ASSERT_PTR_NOT_NULL(orphan);
+
+  GCStats after;
+  gc_stats(&after);
+  ASSERT_INT_EQ(after.object_count, before.object_count + 1);
+  ASSERT_TRUE(after.allocated_bytes > before.allocated_bytes);
+  ASSERT_TRUE(after.heap_count >= 2);
+
+  // Releasing it here uncharges the orphan heap that tracked it, not the
+  // heap of the releasing thread
+  value_release(orphan);
+  gc_stats(&after);
+  ASSERT_INT_EQ(after.object_count, before.object_count);
+  ASSERT_INT_EQ(after.allocated_bytes, before.allocated_bytes);
+
+  // Cleanup frees what is left on the other thread's behalf
+  ASSERT_INT_EQ(pthread_create(&thread, NULL, allocate_on_thread, &orphan), 0);
+  ASSERT_INT_EQ(pthread_join(thread, NULL), 0);
+  ASSERT_PTR_NOT_NULL(orphan);
+  gc_cleanup();
+  ASSERT_INT_EQ(gc_get_object_count(), 0);
+  ASSERT_INT_EQ(gc_get_allocated_bytes(), 0);
+}
+
+// Leak-check builds allocate every block with malloc (see gc_alloc()), so
+// there are no slabs to recycle through
+#if !KRONOS_GC_LEAK_CHECK
+TEST(gc_slab_recycles_blocks) {
+  gc_init();
+
+  GCStats before;
+  gc_stats(&before);
+  ASSERT_INT_EQ(before.slab_classes[2].block_size, 64);
+
+  // A freed block is handed out again for any size in its class
+  void *block = gc_alloc(40);
+  ASSERT_PTR_NOT_NULL(block);
+  GCStats during;
+  gc_stats(&during);
+  ASSERT_INT_EQ(during.slab_classes[2].blocks_in_use,
+                before.slab_classes[2].blocks_in_use + 1);
+  ASSERT_TRUE(during.slab_reserved_bytes > 0);
+  gc_free(block, 40);
+  void *again = gc_alloc(64);
+  ASSERT_TRUE(again == block);
+
+  // Resizing within a class keeps the block; across classes it copies
+  ASSERT_TRUE(gc_realloc(again, 64, 49) == again);
+  memcpy(again, "slab", 5);
+  char *grown = gc_realloc(again, 49, 200);
+  ASSERT_PTR_NOT_NULL(grown);
+  ASSERT_STR_EQ(grown, "slab");
+  gc_free(grown, 200);
+
+  // Large blocks bypass the slabs
+  void *large = gc_alloc(4096);
+  ASSERT_PTR_NOT_NULL(large);
+  gc_free(large, 4096);
+
+  GCStats after;
+  gc_stats(&after);
+  for (size_t i = 0; i < GC_SLAB_CLASS_COUNT; i++) {
+    ASSERT_INT_EQ(after.slab_classes[i].blocks_in_use,
+                  before.slab_classes[i].blocks_in_use);
+  }
+  ASSERT_TRUE(after.slab_classes[2].blocks_free > 0);
+
+  gc_cleanup();
+}
+#endif
@@ -300,6 +300,25 @@ TEST(parse_for_loop) {
   token_array_free(tokens);
 }
 
+TEST(parse_for_key_value_loop) {
+  TokenizeError *tok_err = NULL;
+  TokenArray *tokens =
+      tokenize("for key, value in scores:\n    print key", &tok_err);
+  ASSERT_PTR_NULL(tok_err);
+  ASSERT_PTR_NOT_NULL(tokens);
+
+  AST *ast = parse(tokens, NULL);
+  ASSERT_PTR_NOT_NULL(ast);
+  ASSERT_INT_EQ(ast->count, 1);
+  ASSERT_INT_EQ(ast->statements[0]->type, AST_FOR);
+  ASSERT_STR_EQ(ast->statements[0]->as.for_stmt.var, "key");
+  ASSERT_STR_EQ(ast->statements[0]->as.for_stmt.value_var, "value");
+  ASSERT_FALSE(ast->statements[0]->as.for_stmt.is_range);
+
+  ast_free(ast);
+  token_array_free(tokens);
+}
+
 TEST(parse_while_loop) {
   TokenizeError *tok_err = NULL;
   TokenArray *tokens = tokenize("while true:\n    print 1", &tok_err);
@@ -440,3 +459,47 @@ TEST(parse_fstring) {
   ast_free(ast);
   token_array_free(tokens);
 }
+
+TEST(parse_ast_outlives_tokens) {
+  TokenArray *tokens =
+      tokenize("function greet with name:\n"
+               "    print f\"Hello {name plus 1}\"\n"
+               "call greet with \"Ada\"\n",
+               NULL);
+  ASSERT_PTR_NOT_NULL(tokens);
+
+  AST *ast = parse(tokens, NULL);
+  ASSERT_PTR_NOT_NULL(ast);
+  ASSERT_PTR_NOT_NULL(ast->arena);
+
+  // The AST copies every name into its own arena, so it stays valid after
+  // the tokens are gone
+  token_array_free(tokens);
+  ASSERT_INT_EQ(ast->count, 2);
+  ASTNode *function = ast->statements[0];
+  ASSERT_STR_EQ(function->as.function.name, "greet");
+  ASSERT_STR_EQ(function->as.function.params[0], "name");
+  ASTNode *fstring = function->as.function.block[0]->as.print.value;
+  ASSERT_INT_EQ(fstring->type, AST_FSTRING);
+  ASSERT_INT_EQ(fstring->as.fstring.part_count, 2);
+  ASSERT_STR_EQ(fstring->as.fstring.parts[0]->as.string.value, "Hello ");
+  ASSERT_INT_EQ(fstring->as.fstring.parts[1]->type, AST_BINOP);
+  ASSERT_STR_EQ(ast->statements[1]->as.call.args[0]->as.string.value, "Ada");
+
+  ast_free(ast);
+}
+
+TEST(parse_expression_only_nodes_are_heap_allocated) {
+  TokenArray *tokens = tokenize("list 1, f\"{2 plus 3}\"", NULL);
+  ASSERT_PTR_NOT_NULL(tokens);
+
+  // Outside parse() there is no arena: the node is freed on its own
+  ASTNode *expr = parse_expression_only(tokens, NULL);
+  token_array_free(tokens);
+  ASSERT_PTR_NOT_NULL(expr);
+  ASSERT_INT_EQ(expr->type, AST_LIST);
+  ASSERT_INT_EQ(expr->as.list.element_count, 2);
+  ASSERT_INT_EQ(expr->as.list.elements[1]->type, AST_FSTRING);
+
+  ast_node_free(expr);
+}
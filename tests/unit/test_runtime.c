@@ -1,20 +1,90 @@
+#include "../../src/core/gc.h"
 #include "../../src/core/runtime.h"
 #include "../framework/test_framework.h"
+#include <float.h>
+#include <math.h>
+#include <string.h>
 
 TEST(value_new_number) {
   KronosValue *val = value_new_number(42.5);
   ASSERT_PTR_NOT_NULL(val);
-  ASSERT_INT_EQ(val->type, VAL_NUMBER);
-  ASSERT_DOUBLE_EQ(val->as.number, 42.5);
-  ASSERT_INT_EQ(val->refcount, 1);
+  ASSERT_TRUE(value_is_number(val));
+  ASSERT_INT_EQ(value_type(val), VAL_NUMBER);
+  ASSERT_DOUBLE_EQ(value_as_number(val), 42.5);
 
   value_release(val);
 }
 
+#if KRONOS_IMMEDIATE_NUMBERS
+TEST(numbers_are_immediate) {
+  gc_init();
+  size_t tracked_before = gc_get_object_count();
+  size_t bytes_before = gc_get_allocated_bytes();
+
+  // Creating, retaining and releasing numbers touches no memory
+  KronosValue *num = value_new_number(1.5);
+  value_retain(num);
+  value_release(num);
+  value_release(num);
+  ASSERT_INT_EQ(gc_get_object_count(), tracked_before);
+  ASSERT_INT_EQ(gc_get_allocated_bytes(), bytes_before);
+
+  // Equal numbers are the same word; the encoding round-trips every double
+  ASSERT_TRUE(value_new_number(7) == value_new_number(7.0));
+  ASSERT_TRUE(value_new_number(-0.0) != value_new_number(0));
+  const double samples[] = {0.0,     -0.0,     1.0,     -1.0,     0.1,
+                            1e308,   -1e308,   5e-324,  -5e-324,  INFINITY,
+                            -INFINITY, DBL_MAX, -DBL_MAX};
+  for (size_t i = 0; i < sizeof(samples) / sizeof(samples[0]); i++) {
+    KronosValue *val = value_new_number(samples[i]);
+    ASSERT_TRUE(value_is_number(val));
+    ASSERT_TRUE(memcmp(&(double){value_as_number(val)}, &samples[i],
+                       sizeof(double)) == 0);
+  }
+
+  // Every NaN, whatever its sign and payload, is one canonical word
+  KronosValue *nan = value_new_number(NAN);
+  ASSERT_TRUE(value_is_number(nan));
+  ASSERT_TRUE(isnan(value_as_number(nan)));
+  ASSERT_TRUE(value_new_number(-NAN) == nan);
+
+  // Cells never look like numbers
+  KronosValue *str = value_new_string("x", 1);
+  ASSERT_FALSE(value_is_number(str));
+  ASSERT_FALSE(value_is_number(value_new_bool(true)));
+  ASSERT_FALSE(value_is_number(value_new_nil()));
+  ASSERT_INT_EQ(value_type(str), VAL_STRING);
+
+  // Numbers in list slots and map entries are released without a cell
+  KronosValue *list = value_new_list(0);
+  KronosValue *map = value_new_map(0);
+  ASSERT_INT_EQ(map_set(map, value_new_number(2), value_new_number(2.5)), 0);
+  ASSERT_DOUBLE_EQ(value_as_number(map_get(map, value_new_number(2))), 2.5);
+  list->as.list.items[list->as.list.count++] = value_new_number(3);
+  list->as.list.items[list->as.list.count++] = map;
+  value_release(list);
+  value_release(str);
+  ASSERT_INT_EQ(gc_get_object_count(), tracked_before);
+  gc_cleanup();
+}
+#endif
+
+TEST(immortal_values_skip_refcounting) {
+  // Retain/release never write to an immortal cell, even inside containers
+  KronosValue *yes = value_new_bool(true);
+  KronosValue *map = value_new_map(4);
+  ASSERT_INT_EQ(map_set(map, value_new_nil(), yes), 0);
+  value_retain(yes);
+  value_release(map);
+  value_release(yes);
+  ASSERT_TRUE(yes->refcount == KRONOS_REFCOUNT_IMMORTAL);
+  ASSERT_TRUE(value_new_nil()->refcount == KRONOS_REFCOUNT_IMMORTAL);
+}
+
 TEST(value_new_string) {
   KronosValue *val = value_new_string("hello", 5);
   ASSERT_PTR_NOT_NULL(val);
-  ASSERT_INT_EQ(val->type, VAL_STRING);
+  ASSERT_INT_EQ(value_type(val), VAL_STRING);
   ASSERT_STR_EQ(val->as.string.data, "hello");
   ASSERT_INT_EQ(val->as.string.length, 5);
   ASSERT_INT_EQ(val->refcount, 1);
@@ -22,18 +92,53 @@ TEST(value_new_string) {
   value_release(val);
 }
 
+TEST(value_new_string_inline_and_separate) {
+  // 15 bytes: inline behind the value; 16 bytes: separate buffer
+  KronosValue *short_str = value_new_string("fifteen chars!!", 15);
+  KronosValue *long_str = value_new_string("sixteen chars!!!", 16);
+  ASSERT_TRUE(value_string_is_inline(short_str));
+  ASSERT_FALSE(value_string_is_inline(long_str));
+  ASSERT_STR_EQ(short_str->as.string.data, "fifteen chars!!");
+  ASSERT_STR_EQ(long_str->as.string.data, "sixteen chars!!!");
+
+  // Both representations compare, hash and concatenate alike
+  KronosValue *joined = value_new_string_concat("fifteen chars!!", 15, "!", 1);
+  KronosValue *split = value_new_string_concat("sixteen", 7, " chars!!!", 9);
+  ASSERT_FALSE(value_string_is_inline(joined));
+  ASSERT_TRUE(value_equals(split, long_str));
+  ASSERT_INT_EQ(split->as.string.hash, long_str->as.string.hash);
+
+  KronosValue *map = value_new_map(0);
+  ASSERT_INT_EQ(map_set(map, short_str, long_str), 0);
+  ASSERT_INT_EQ(map_set(map, long_str, short_str), 0);
+  KronosValue *short_key = value_new_string("fifteen chars!!", 15);
+  ASSERT_TRUE(map_get(map, short_key) == long_str);
+  ASSERT_TRUE(map_get(map, split) == short_str);
+
+  value_release(map);
+  value_release(short_key);
+  value_release(split);
+  value_release(joined);
+  value_release(long_str);
+  value_release(short_str);
+}
+
 TEST(value_new_bool) {
   KronosValue *val_true = value_new_bool(true);
   ASSERT_PTR_NOT_NULL(val_true);
-  ASSERT_INT_EQ(val_true->type, VAL_BOOL);
+  ASSERT_INT_EQ(value_type(val_true), VAL_BOOL);
   ASSERT_TRUE(val_true->as.boolean);
-  ASSERT_INT_EQ(val_true->refcount, 1);
+  ASSERT_TRUE(val_true->refcount == KRONOS_REFCOUNT_IMMORTAL);
 
   KronosValue *val_false = value_new_bool(false);
   ASSERT_PTR_NOT_NULL(val_false);
-  ASSERT_INT_EQ(val_false->type, VAL_BOOL);
+  ASSERT_INT_EQ(value_type(val_false), VAL_BOOL);
   ASSERT_FALSE(val_false->as.boolean);
-  ASSERT_INT_EQ(val_false->refcount, 1);
+  ASSERT_TRUE(val_false->refcount == KRONOS_REFCOUNT_IMMORTAL);
+
+  // Every boolean is one of two shared singletons
+  ASSERT_TRUE(value_new_bool(true) == val_true);
+  ASSERT_TRUE(value_new_bool(false) == val_false);
 
   value_release(val_true);
   value_release(val_false);
@@ -42,14 +147,15 @@ TEST(value_new_bool) {
 TEST(value_new_nil) {
   KronosValue *val = value_new_nil();
   ASSERT_PTR_NOT_NULL(val);
-  ASSERT_INT_EQ(val->type, VAL_NIL);
-  ASSERT_INT_EQ(val->refcount, 1);
+  ASSERT_INT_EQ(value_type(val), VAL_NIL);
+  ASSERT_TRUE(val->refcount == KRONOS_REFCOUNT_IMMORTAL);
+  ASSERT_TRUE(value_new_nil() == val);
 
   value_release(val);
 }
 
 TEST(value_retain_release) {
-  KronosValue *val = value_new_number(10);
+  KronosValue *val = value_new_string("ten", 3);
   ASSERT_INT_EQ(val->refcount, 1);
 
   value_retain(val);
@@ -203,7 +309,7 @@ TEST(value_is_type) {
 TEST(value_new_list) {
   KronosValue *list = value_new_list(0);
   ASSERT_PTR_NOT_NULL(list);
-  ASSERT_INT_EQ(list->type, VAL_LIST);
+  ASSERT_INT_EQ(value_type(list), VAL_LIST);
   ASSERT_INT_EQ(list->as.list.count, 0);
   ASSERT_INT_EQ(list->refcount, 1);
 
@@ -213,7 +319,7 @@ TEST(value_new_list) {
 TEST(value_new_list_with_capacity) {
   KronosValue *list = value_new_list(10);
   ASSERT_PTR_NOT_NULL(list);
-  ASSERT_INT_EQ(list->type, VAL_LIST);
+  ASSERT_INT_EQ(value_type(list), VAL_LIST);
   ASSERT_INT_EQ(list->as.list.count, 0);
   ASSERT_TRUE(list->as.list.capacity >= 10);
   ASSERT_INT_EQ(list->refcount, 1);
@@ -257,7 +363,7 @@ TEST(value_fprint) {
 TEST(string_intern) {
   KronosValue *val1 = string_intern("test", 4);
   ASSERT_PTR_NOT_NULL(val1);
-  ASSERT_INT_EQ(val1->type, VAL_STRING);
+  ASSERT_INT_EQ(value_type(val1), VAL_STRING);
 
   // Second call with same string should return same value (interning)
   KronosValue *val2 = string_intern("test", 4);
@@ -273,7 +379,7 @@ TEST(value_new_function) {
   uint8_t bytecode[] = {1, 2, 3};
   KronosValue *func = value_new_function(bytecode, 3, 2);
   ASSERT_PTR_NOT_NULL(func);
-  ASSERT_INT_EQ(func->type, VAL_FUNCTION);
+  ASSERT_INT_EQ(value_type(func), VAL_FUNCTION);
   ASSERT_INT_EQ(func->as.function.arity, 2);
   ASSERT_INT_EQ(func->as.function.length, 3);
 
@@ -289,7 +395,7 @@ TEST(value_new_function_null_bytecode) {
 TEST(value_new_range) {
   KronosValue *r1 = value_new_range(1.0, 10.0, 1.0);
   ASSERT_PTR_NOT_NULL(r1);
-  ASSERT_INT_EQ(r1->type, VAL_RANGE);
+  ASSERT_INT_EQ(value_type(r1), VAL_RANGE);
   ASSERT_DOUBLE_EQ(r1->as.range.start, 1.0);
   ASSERT_DOUBLE_EQ(r1->as.range.end, 10.0);
   ASSERT_DOUBLE_EQ(r1->as.range.step, 1.0);
@@ -301,7 +407,7 @@ TEST(value_new_range) {
 TEST(value_new_range_with_step) {
   KronosValue *r = value_new_range(0.0, 20.0, 5.0);
   ASSERT_PTR_NOT_NULL(r);
-  ASSERT_INT_EQ(r->type, VAL_RANGE);
+  ASSERT_INT_EQ(value_type(r), VAL_RANGE);
   ASSERT_DOUBLE_EQ(r->as.range.start, 0.0);
   ASSERT_DOUBLE_EQ(r->as.range.end, 20.0);
   ASSERT_DOUBLE_EQ(r->as.range.step, 5.0);
@@ -313,7 +419,7 @@ TEST(value_new_range_default_step) {
   // Step of 0.0 should default to 1.0
   KronosValue *r = value_new_range(1.0, 10.0, 0.0);
   ASSERT_PTR_NOT_NULL(r);
-  ASSERT_INT_EQ(r->type, VAL_RANGE);
+  ASSERT_INT_EQ(value_type(r), VAL_RANGE);
   ASSERT_DOUBLE_EQ(r->as.range.step, 1.0);
 
   value_release(r);
@@ -322,7 +428,7 @@ TEST(value_new_range_default_step) {
 TEST(value_new_range_negative_step) {
   KronosValue *r = value_new_range(10.0, 1.0, -1.0);
   ASSERT_PTR_NOT_NULL(r);
-  ASSERT_INT_EQ(r->type, VAL_RANGE);
+  ASSERT_INT_EQ(value_type(r), VAL_RANGE);
   ASSERT_DOUBLE_EQ(r->as.range.start, 10.0);
   ASSERT_DOUBLE_EQ(r->as.range.end, 1.0);
   ASSERT_DOUBLE_EQ(r->as.range.step, -1.0);
@@ -420,7 +526,7 @@ TEST(value_fprint_range) {
 TEST(value_new_map) {
   KronosValue *map = value_new_map(0);
   ASSERT_PTR_NOT_NULL(map);
-  ASSERT_INT_EQ(map->type, VAL_MAP);
+  ASSERT_INT_EQ(value_type(map), VAL_MAP);
   ASSERT_INT_EQ(map->as.map.count, 0);
   ASSERT_TRUE(map->as.map.capacity > 0);
   ASSERT_INT_EQ(map->refcount, 1);
@@ -470,7 +576,7 @@ TEST(map_set_overwrite) {
 
   KronosValue *retrieved = map_get(map, key);
   ASSERT_PTR_NOT_NULL(retrieved);
-  ASSERT_DOUBLE_EQ(retrieved->as.number, 31.0);
+  ASSERT_DOUBLE_EQ(value_as_number(retrieved), 31.0);
 
   value_release(map);
   value_release(key);
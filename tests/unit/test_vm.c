@@ -109,7 +109,7 @@ TEST(vm_set_global_mutable_reassign) {
 
   KronosValue *retrieved = vm_get_global(vm, "x");
   ASSERT_PTR_NOT_NULL(retrieved);
-  ASSERT_DOUBLE_EQ(retrieved->as.number, 100.0);
+  ASSERT_DOUBLE_EQ(value_as_number(retrieved), 100.0);
 
   value_release(val1);
   value_release(val2);
@@ -128,8 +128,8 @@ TEST(vm_execute_assignment) {
 
   KronosValue *x = vm_get_global(vm, "x");
   ASSERT_PTR_NOT_NULL(x);
-  ASSERT_INT_EQ(x->type, VAL_NUMBER);
-  ASSERT_DOUBLE_EQ(x->as.number, 42.0);
+  ASSERT_INT_EQ(value_type(x), VAL_NUMBER);
+  ASSERT_DOUBLE_EQ(value_as_number(x), 42.0);
 
   bytecode_free(bytecode);
   vm_free(vm);
@@ -147,8 +147,8 @@ TEST(vm_execute_arithmetic) {
 
   KronosValue *result_val = vm_get_global(vm, "result");
   ASSERT_PTR_NOT_NULL(result_val);
-  ASSERT_INT_EQ(result_val->type, VAL_NUMBER);
-  ASSERT_DOUBLE_EQ(result_val->as.number, 30.0);
+  ASSERT_INT_EQ(value_type(result_val), VAL_NUMBER);
+  ASSERT_DOUBLE_EQ(value_as_number(result_val), 30.0);
 
   bytecode_free(bytecode);
   vm_free(vm);
@@ -166,7 +166,7 @@ TEST(vm_execute_comparison) {
 
   KronosValue *result_val = vm_get_global(vm, "result");
   ASSERT_PTR_NOT_NULL(result_val);
-  ASSERT_INT_EQ(result_val->type, VAL_BOOL);
+  ASSERT_INT_EQ(value_type(result_val), VAL_BOOL);
   ASSERT_TRUE(result_val->as.boolean);
 
   bytecode_free(bytecode);
@@ -187,8 +187,8 @@ TEST(vm_execute_function) {
 
   KronosValue *result_val = vm_get_global(vm, "result");
   ASSERT_PTR_NOT_NULL(result_val);
-  ASSERT_INT_EQ(result_val->type, VAL_NUMBER);
-  ASSERT_DOUBLE_EQ(result_val->as.number, 30.0);
+  ASSERT_INT_EQ(value_type(result_val), VAL_NUMBER);
+  ASSERT_DOUBLE_EQ(value_as_number(result_val), 30.0);
 
   bytecode_free(bytecode);
   vm_free(vm);
@@ -216,7 +216,7 @@ TEST(vm_execute_all_arithmetic) {
     if (result_code == 0) {
       KronosValue *result = vm_get_global(vm, "result");
       ASSERT_PTR_NOT_NULL(result);
-      ASSERT_DOUBLE_EQ(result->as.number, 7.0);
+      ASSERT_DOUBLE_EQ(value_as_number(result), 7.0);
     }
     bytecode_free(bytecode);
   }
@@ -289,8 +289,8 @@ TEST(vm_execute_list_operations) {
 
   KronosValue *item = vm_get_global(vm, "item");
   ASSERT_PTR_NOT_NULL(item);
-  ASSERT_INT_EQ(item->type, VAL_NUMBER);
-  ASSERT_DOUBLE_EQ(item->as.number, 20.0);
+  ASSERT_INT_EQ(value_type(item), VAL_NUMBER);
+  ASSERT_DOUBLE_EQ(value_as_number(item), 20.0);
 
   bytecode_free(bytecode);
   vm_free(vm);
@@ -315,7 +315,7 @@ TEST(vm_get_variable_local_scope) {
   // Global x should still be 100 (local x in function doesn't affect it)
   KronosValue *global_x = vm_get_global(vm, "x");
   ASSERT_PTR_NOT_NULL(global_x);
-  ASSERT_DOUBLE_EQ(global_x->as.number, 100.0);
+  ASSERT_DOUBLE_EQ(value_as_number(global_x), 100.0);
 
   bytecode_free(bytecode);
   vm_free(vm);
@@ -438,6 +438,439 @@ TEST(vm_set_local_get_local) {
   vm_free(vm);
 }
 
+TEST(vm_local_slot_constraints) {
+  KronosVM *vm = vm_new();
+  ASSERT_PTR_NOT_NULL(vm);
+
+  // Immutable local reassignment is rejected with the local error message
+  Bytecode *bytecode = compile_string(
+      "function test:\n    set k to 1\n    set k to 2\ncall test");
+  ASSERT_PTR_NOT_NULL(bytecode);
+  ASSERT_NE(vm_execute(vm, bytecode), 0);
+  ASSERT_PTR_NOT_NULL(vm->last_error_message);
+  ASSERT_TRUE(strstr(vm->last_error_message, "immutable local variable 'k'") !=
+              NULL);
+
+  bytecode_free(bytecode);
+  vm_free(vm);
+}
+
+TEST(vm_local_slot_falls_back_to_global) {
+  KronosVM *vm = vm_new();
+  ASSERT_PTR_NOT_NULL(vm);
+
+  // x is read before the function assigns its own local x
+  Bytecode *bytecode =
+      compile_string("set x to 5\nfunction test:\n    set before to x\n    "
+                     "let x to 9\n    return before plus x\nset result to "
+                     "call test");
+  ASSERT_PTR_NOT_NULL(bytecode);
+  ASSERT_INT_EQ(vm_execute(vm, bytecode), 0);
+
+  KronosValue *result = vm_get_global(vm, "result");
+  ASSERT_PTR_NOT_NULL(result);
+  ASSERT_DOUBLE_EQ(value_as_number(result), 14.0);
+  KronosValue *global_x = vm_get_global(vm, "x");
+  ASSERT_PTR_NOT_NULL(global_x);
+  ASSERT_DOUBLE_EQ(value_as_number(global_x), 5.0);
+
+  bytecode_free(bytecode);
+  vm_free(vm);
+}
+
+TEST(vm_globals_grow_past_initial_capacity) {
+  KronosVM *vm = vm_new();
+  ASSERT_PTR_NOT_NULL(vm);
+
+  char name[32];
+  for (int i = 0; i < 1000; i++) {
+    snprintf(name, sizeof(name), "g%d", i);
+    KronosValue *value = value_new_number(i);
+    ASSERT_INT_EQ(vm_set_global(vm, name, value, true, NULL), 0);
+    value_release(value);
+  }
+
+  // Pi plus every generated global, all still reachable by name
+  ASSERT_INT_EQ((int)vm->global_count, 1001);
+  for (int i = 0; i < 1000; i++) {
+    snprintf(name, sizeof(name), "g%d", i);
+    KronosValue *value = vm_get_global(vm, name);
+    ASSERT_PTR_NOT_NULL(value);
+    ASSERT_DOUBLE_EQ(value_as_number(value), (double)i);
+  }
+  ASSERT_PTR_NOT_NULL(vm_get_global(vm, "Pi"));
+
+  vm_free(vm);
+}
+
+TEST(vm_global_sites_rewritten_to_slots) {
+  KronosVM *vm = vm_new();
+  ASSERT_PTR_NOT_NULL(vm);
+
+  Bytecode *bytecode = compile_string(
+      "let total to 0\nfor i in range 1 to 10:\n    let total to total "
+      "plus i");
+  ASSERT_PTR_NOT_NULL(bytecode);
+  uint8_t *original = malloc(bytecode->count);
+  ASSERT_PTR_NOT_NULL(original);
+  memcpy(original, bytecode->code, bytecode->count);
+  ASSERT_INT_EQ(vm_execute(vm, bytecode), 0);
+
+  KronosValue *total = vm_get_global(vm, "total");
+  ASSERT_PTR_NOT_NULL(total);
+  ASSERT_DOUBLE_EQ(value_as_number(total), 55.0);
+
+  // Executed named accesses were specialized to global slot opcodes in the
+  // VM's private copy; the caller's bytecode is untouched
+  Bytecode *run = vm->bytecode;
+  ASSERT_TRUE(run != bytecode);
+  bool saw_load = false;
+  bool saw_store = false;
+  for (size_t i = 0; i < run->count; i++) {
+    saw_load = saw_load || run->code[i] == OP_LOAD_GLOBAL;
+    saw_store = saw_store || run->code[i] == OP_STORE_GLOBAL;
+  }
+  ASSERT_TRUE(saw_load);
+  ASSERT_TRUE(saw_store);
+  ASSERT_TRUE(run->global_owner == vm->id);
+  ASSERT_INT_EQ(memcmp(original, bytecode->code, bytecode->count), 0);
+  ASSERT_TRUE(bytecode->global_owner == 0);
+  ASSERT_PTR_NULL(bytecode->call_cache);
+  free(original);
+
+  // A VM with a different slot layout (total lands in slot 2, not 1) runs
+  // the same bytecode with its own slots
+  vm_free(vm);
+  vm = vm_new();
+  ASSERT_PTR_NOT_NULL(vm);
+  KronosValue *seed = value_new_number(7);
+  ASSERT_INT_EQ(vm_set_global(vm, "seed", seed, false, NULL), 0);
+  value_release(seed);
+  ASSERT_INT_EQ(vm_execute(vm, bytecode), 0);
+  total = vm_get_global(vm, "total");
+  ASSERT_PTR_NOT_NULL(total);
+  ASSERT_DOUBLE_EQ(value_as_number(total), 55.0);
+  KronosValue *seed_after = vm_get_global(vm, "seed");
+  ASSERT_PTR_NOT_NULL(seed_after);
+  ASSERT_DOUBLE_EQ(value_as_number(seed_after), 7.0);
+
+  bytecode_free(bytecode);
+  vm_free(vm);
+}
+
+/**
+ * Append `for i in range 0 to 10` nested in @p depth single-iteration range
+ * loops, indented by @p indent levels; the body assigns to its variable
+ */
+static void append_nested_range_loop(char *buf, size_t size, size_t depth,
+                                     size_t indent) {
+  for (size_t d = 0; d <= depth + 2; d++) {
+    size_t level = indent + (d <= depth ? d : depth + 1);
+    for (size_t i = 0; i < level; i++) {
+      strncat(buf, "    ", size - strlen(buf) - 1);
+    }
+    char line[64];
+    if (d < depth) {
+      snprintf(line, sizeof(line), "for d%zu in range 1 to 1:\n", d);
+    } else if (d == depth) {
+      snprintf(line, sizeof(line), "for i in range 0 to 10:\n");
+    } else if (d == depth + 1) {
+      snprintf(line, sizeof(line), "let count to count plus 1\n");
+    } else {
+      snprintf(line, sizeof(line), "let i to i plus 4\n");
+    }
+    strncat(buf, line, size - strlen(buf) - 1);
+  }
+}
+
+TEST(vm_range_loops_nest_past_initial_slots) {
+  // Range loops behave the same at any depth: assigning to the variable
+  // does not change the iteration count, at top level and in a function
+  size_t depths[] = {0, RANGE_LOOPS_INITIAL_CAPACITY, 17};
+  for (size_t t = 0; t < sizeof(depths) / sizeof(depths[0]); t++) {
+    char source[8192] = "let count to 0\n";
+    append_nested_range_loop(source, sizeof(source), depths[t], 0);
+    strncat(source, "function f:\n    let count to 0\n",
+            sizeof(source) - strlen(source) - 1);
+    append_nested_range_loop(source, sizeof(source), depths[t], 1);
+    strncat(source, "    return count\nlet inner to call f\n",
+            sizeof(source) - strlen(source) - 1);
+
+    KronosVM *vm = vm_new();
+    ASSERT_PTR_NOT_NULL(vm);
+    Bytecode *bytecode = compile_string(source);
+    ASSERT_PTR_NOT_NULL(bytecode);
+    ASSERT_INT_EQ(vm_execute(vm, bytecode), 0);
+
+    KronosValue *count = vm_get_global(vm, "count");
+    ASSERT_PTR_NOT_NULL(count);
+    ASSERT_DOUBLE_EQ(value_as_number(count), 11.0);
+    KronosValue *inner = vm_get_global(vm, "inner");
+    ASSERT_PTR_NOT_NULL(inner);
+    ASSERT_DOUBLE_EQ(value_as_number(inner), 11.0);
+
+    bytecode_free(bytecode);
+    vm_free(vm);
+  }
+}
+
+TEST(vm_call_moves_arguments_into_slots) {
+  KronosVM *vm = vm_new();
+  ASSERT_PTR_NOT_NULL(vm);
+
+  Bytecode *bytecode = compile_string(
+      "set items to list 1, 2, 3\nfunction first with xs, n:\n"
+      "    set copy to xs\n    return n\n"
+      "let total to 0\nfor i in range 1 to 5:\n"
+      "    let total to total plus call first with items, i");
+  ASSERT_PTR_NOT_NULL(bytecode);
+  ASSERT_INT_EQ(vm_execute(vm, bytecode), 0);
+
+  KronosValue *total = vm_get_global(vm, "total");
+  ASSERT_PTR_NOT_NULL(total);
+  ASSERT_DOUBLE_EQ(value_as_number(total), 15.0);
+
+  // Returns released the parameter and local slots: only the global holds
+  // the list, and the stack is back to empty
+  KronosValue *items = vm_get_global(vm, "items");
+  ASSERT_PTR_NOT_NULL(items);
+  ASSERT_INT_EQ((int)items->refcount, 1);
+  ASSERT_TRUE(vm->stack_top == vm->stack);
+  ASSERT_INT_EQ((int)vm->call_stack_size, 0);
+
+  bytecode_free(bytecode);
+  vm_free(vm);
+}
+
+TEST(vm_tail_calls_reuse_frame) {
+  KronosVM *vm = vm_new();
+  ASSERT_PTR_NOT_NULL(vm);
+
+  // Far deeper than the call stack: every level replaces the last
+  Bytecode *bytecode = compile_string(
+      "set items to list 1, 2\nfunction walk with xs, n:\n"
+      "    if n is equal 0:\n        return n\n    set copy to xs\n"
+      "    return call walk with xs, n minus 1\n"
+      "let depth to call walk with items, 1000");
+  ASSERT_PTR_NOT_NULL(bytecode);
+  ASSERT_INT_EQ(vm_execute(vm, bytecode), 0);
+
+  KronosValue *depth = vm_get_global(vm, "depth");
+  ASSERT_PTR_NOT_NULL(depth);
+  ASSERT_DOUBLE_EQ(value_as_number(depth), 0.0);
+
+  // Each reused frame released the previous call's slots
+  KronosValue *items = vm_get_global(vm, "items");
+  ASSERT_PTR_NOT_NULL(items);
+  ASSERT_INT_EQ((int)items->refcount, 1);
+  ASSERT_TRUE(vm->stack_top == vm->stack);
+  ASSERT_INT_EQ((int)vm->call_stack_size, 0);
+
+  bytecode_free(bytecode);
+  vm_free(vm);
+}
+
+TEST(vm_call_depth_limit) {
+  KronosVM *vm = vm_new();
+  ASSERT_PTR_NOT_NULL(vm);
+  // Stacks start small and grow with the calls
+  ASSERT_INT_EQ((int)vm->call_stack_capacity, 0);
+  ASSERT_INT_EQ((int)vm->max_call_depth, CALL_DEPTH_DEFAULT);
+
+  Bytecode *bytecode = compile_string(
+      "function depth with n:\n    if n is equal 0:\n        return 0\n"
+      "    return 1 plus call depth with n minus 1\n"
+      "let d to call depth with 3000");
+  ASSERT_PTR_NOT_NULL(bytecode);
+  ASSERT_INT_EQ(vm_execute(vm, bytecode), 0);
+  KronosValue *d = vm_get_global(vm, "d");
+  ASSERT_PTR_NOT_NULL(d);
+  ASSERT_DOUBLE_EQ(value_as_number(d), 3000.0);
+  ASSERT_TRUE(vm->call_stack_capacity > 3000);
+  ASSERT_TRUE(vm->stack_top == vm->stack);
+  ASSERT_INT_EQ((int)vm->call_stack_size, 0);
+  bytecode_free(bytecode);
+
+  // Below the limit the same recursion fails
+  ASSERT_TRUE(vm_set_max_call_depth(vm, 0) < 0);
+  vm_clear_error(vm);
+  ASSERT_INT_EQ(vm_set_max_call_depth(vm, 100), 0);
+  bytecode = compile_string("let e to call depth with 100");
+  ASSERT_PTR_NOT_NULL(bytecode);
+  ASSERT_TRUE(vm_execute(vm, bytecode) < 0);
+  ASSERT_PTR_NOT_NULL(vm->last_error_message);
+  ASSERT_STR_EQ(vm->last_error_message, "Maximum call depth exceeded");
+
+  bytecode_free(bytecode);
+  vm_free(vm);
+}
+
+TEST(vm_call_sites_cached) {
+  KronosVM *vm = vm_new();
+  ASSERT_PTR_NOT_NULL(vm);
+
+  Bytecode *bytecode = compile_string(
+      "function square with x:\n    return x times x\n"
+      "function area with s:\n    let n to call len with s\n"
+      "    return n times call len with s\nlet total to 0\n"
+      "for i in range 1 to 10:\n    let total to total plus call square "
+      "with i\n    let total to total plus call len with \"ab\"");
+  ASSERT_PTR_NOT_NULL(bytecode);
+  ASSERT_INT_EQ(vm_execute(vm, bytecode), 0);
+
+  KronosValue *total = vm_get_global(vm, "total");
+  ASSERT_PTR_NOT_NULL(total);
+  ASSERT_DOUBLE_EQ(value_as_number(total), 405.0);
+
+  // Two call sites: one miss each, every later iteration hits
+  VMCallCacheStats stats;
+  vm_call_cache_stats(vm, &stats);
+  ASSERT_TRUE(stats.misses == 2);
+  ASSERT_TRUE(stats.hits == 18);
+  ASSERT_INT_EQ((int)stats.hit_rate, 90);
+
+  // Top-level code runs on a fresh copy each time, so its sites miss once
+  // per run; entries in function bodies survive across runs until
+  // invalidated
+  Bytecode *again = compile_string("let total to call area with \"abc\"");
+  ASSERT_PTR_NOT_NULL(again);
+  ASSERT_INT_EQ(vm_execute(vm, again), 0);
+  ASSERT_INT_EQ(vm_execute(vm, again), 0);
+  ASSERT_DOUBLE_EQ(value_as_number(vm_get_global(vm, "total")), 9.0);
+  vm_call_cache_stats(vm, &stats);
+  ASSERT_TRUE(stats.misses == 6);
+  ASSERT_TRUE(stats.hits == 20);
+  vm_invalidate_call_caches(vm);
+  ASSERT_INT_EQ(vm_execute(vm, again), 0);
+  vm_call_cache_stats(vm, &stats);
+  ASSERT_TRUE(stats.misses == 9);
+
+  bytecode_free(again);
+  bytecode_free(bytecode);
+  vm_free(vm);
+}
+
+TEST(vm_quickens_number_arithmetic) {
+  KronosVM *vm = vm_new();
+  ASSERT_PTR_NOT_NULL(vm);
+
+  Bytecode *bytecode = compile_string(
+      "function combine with a, b:\n    return a plus b\n"
+      "let x to call combine with 1, 2\nlet y to call combine with 3, 4\n"
+      "let s to call combine with \"a\", 1\nlet z to call combine with 5, 6");
+  ASSERT_PTR_NOT_NULL(bytecode);
+  ASSERT_INT_EQ(vm_execute(vm, bytecode), 0);
+
+  ASSERT_DOUBLE_EQ(value_as_number(vm_get_global(vm, "x")), 3.0);
+  ASSERT_DOUBLE_EQ(value_as_number(vm_get_global(vm, "y")), 7.0);
+  KronosValue *s = vm_get_global(vm, "s");
+  ASSERT_TRUE(value_type(s) == VAL_STRING);
+  ASSERT_STR_EQ(s->as.string.data, "a1");
+  ASSERT_DOUBLE_EQ(value_as_number(vm_get_global(vm, "z")), 11.0);
+
+  // Quickened on the first call, restored by the string call, quickened
+  // again by the last one
+  VMQuickenStats stats;
+  vm_quicken_stats(vm, &stats);
+  ASSERT_TRUE(stats.quickened == 2);
+  ASSERT_TRUE(stats.dequickened == 1);
+  ASSERT_INT_EQ((int)stats.stable_rate, 50);
+
+  bytecode_free(bytecode);
+  vm_free(vm);
+}
+
+// Bytecode whose last constants sit past 16-bit indices: 65536 is the
+// number 7, 65537 the string "w" and 65538 the string "boom"
+static Bytecode *wide_bytecode(const uint8_t *code, size_t count) {
+  Bytecode *bytecode = calloc(1, sizeof(Bytecode));
+  if (!bytecode) {
+    return NULL;
+  }
+  bytecode->code = malloc(count);
+  bytecode->constants = calloc(65539, sizeof(KronosValue *));
+  if (!bytecode->code || !bytecode->constants) {
+    bytecode_free(bytecode);
+    return NULL;
+  }
+  memcpy(bytecode->code, code, count);
+  bytecode->count = bytecode->capacity = count;
+  bytecode->const_count = bytecode->const_capacity = 65539;
+  for (size_t i = 0; i < 65536; i++) {
+    bytecode->constants[i] = value_new_nil();
+  }
+  bytecode->constants[65536] = value_new_number(7);
+  bytecode->constants[65537] = value_new_string("w", 1);
+  bytecode->constants[65538] = value_new_string("boom", 4);
+  bytecode_verify(bytecode, NULL);
+  return bytecode;
+}
+
+TEST(vm_executes_wide_operands) {
+  KronosVM *vm = vm_new();
+  ASSERT_PTR_NOT_NULL(vm);
+
+  // A function body past 32 KB: its loop, handler and skip jumps are 32-bit
+  const char *line = "        let t to t plus i\n";
+  size_t lines = 6000;
+  char *source = malloc(strlen(line) * lines + 256);
+  ASSERT_PTR_NOT_NULL(source);
+  char *p = source + sprintf(source, "function big with n:\n"
+                                     "    let t to 0\n"
+                                     "    try:\n"
+                                     "        raise \"wide\"\n"
+                                     "    catch error:\n"
+                                     "        let t to 0\n"
+                                     "    for i in range 1 to n:\n");
+  for (size_t i = 0; i < lines; i++) {
+    p += sprintf(p, "%s", line);
+  }
+  sprintf(p, "    return t\nlet total to call big with 3");
+  Bytecode *bytecode = compile_string(source);
+  free(source);
+  ASSERT_PTR_NOT_NULL(bytecode);
+  ASSERT_TRUE(bytecode->verified);
+  ASSERT_INT_EQ(vm_execute(vm, bytecode), 0);
+  ASSERT_DOUBLE_EQ(value_as_number(vm_get_global(vm, "total")), 36000.0);
+  bytecode_free(bytecode);
+
+  // Constant indices past 16 bits; the store is rewritten to its global
+  // slot form in the VM's copy
+  const uint8_t store[] = {OP_WIDE, OP_LOAD_CONST, 0, 1, 0, 0,
+                           OP_WIDE, OP_STORE_VAR, 0, 1, 0, 1, 1, 0,
+                           OP_HALT};
+  bytecode = wide_bytecode(store, sizeof(store));
+  ASSERT_PTR_NOT_NULL(bytecode);
+  ASSERT_TRUE(bytecode->verified);
+  ASSERT_INT_EQ(vm_execute(vm, bytecode), 0);
+  ASSERT_TRUE(vm->bytecode->code[7] == OP_STORE_GLOBAL);
+  ASSERT_TRUE(bytecode->code[7] == OP_STORE_VAR);
+  ASSERT_INT_EQ(vm_execute(vm, bytecode), 0);
+  ASSERT_DOUBLE_EQ(value_as_number(vm_get_global(vm, "w")), 7.0);
+  bytecode_free(bytecode);
+
+  // A wide OP_CATCH is reached with the raised error still set
+  const uint8_t handler[] = {
+      OP_WIDE, OP_TRY_ENTER, 0, 0, 0, 15,
+      OP_WIDE, OP_LOAD_CONST, 0, 1, 0, 2,
+      OP_THROW, 0xFF, 0xFF,
+      OP_WIDE, OP_TRY_EXIT, 0, 0, 0, 0,
+      OP_WIDE, OP_CATCH, 0xFF, 0xFF, 0xFF, 0xFF, 0, 1, 0, 1,
+      OP_WIDE, OP_STORE_VAR, 0, 1, 0, 1, 1, 0,
+      OP_HALT};
+  bytecode = wide_bytecode(handler, sizeof(handler));
+  ASSERT_PTR_NOT_NULL(bytecode);
+  ASSERT_TRUE(bytecode->verified);
+  ASSERT_INT_EQ(vm_execute(vm, bytecode), 0);
+  KronosValue *w = vm_get_global(vm, "w");
+  ASSERT_TRUE(value_type(w) == VAL_STRING);
+  ASSERT_STR_EQ(w->as.string.data, "boom");
+  ASSERT_TRUE(vm->stack_top == vm->stack);
+
+  bytecode_free(bytecode);
+  vm_free(vm);
+}
+
 TEST(vm_define_function_direct) {
   KronosVM *vm = vm_new();
   ASSERT_PTR_NOT_NULL(vm);
@@ -450,6 +883,8 @@ TEST(vm_define_function_direct) {
   func->param_count = 1;
   func->params = malloc(sizeof(char *));
   func->params[0] = strdup("x");
+  func->slots = NULL;
+  func->slot_count = 0;
 
   // Create minimal bytecode (properly initialized)
   func->bytecode.code = NULL;
@@ -458,6 +893,11 @@ TEST(vm_define_function_direct) {
   func->bytecode.constants = NULL;
   func->bytecode.const_count = 0;
   func->bytecode.const_capacity = 0;
+  func->bytecode.global_owner = 0;
+  func->bytecode.global_names = NULL;
+  func->bytecode.global_name_capacity = 0;
+  func->bytecode.verified = false;
+  func->bytecode.call_cache = NULL;
 
   // Define the function
   int result = vm_define_function(vm, func);
@@ -491,8 +931,8 @@ TEST(vm_set_global_type_checking) {
   // Verify original value is unchanged
   KronosValue *x = vm_get_global(vm, "x");
   ASSERT_PTR_NOT_NULL(x);
-  ASSERT_INT_EQ(x->type, VAL_NUMBER);
-  ASSERT_DOUBLE_EQ(x->as.number, 42.0);
+  ASSERT_INT_EQ(value_type(x), VAL_NUMBER);
+  ASSERT_DOUBLE_EQ(value_as_number(x), 42.0);
 
   vm_free(vm);
 }
@@ -289,17 +289,7 @@ void kronos_wasm_reset(void) {
     vm_clear_error(g_wasm_vm);
 
     // Clear global variables
-    for (size_t i = 0; i < g_wasm_vm->global_count; i++) {
-      if (g_wasm_vm->globals[i].name) {
-        free(g_wasm_vm->globals[i].name);
-        g_wasm_vm->globals[i].name = NULL;
-      }
-      if (g_wasm_vm->globals[i].value) {
-        value_release(g_wasm_vm->globals[i].value);
-        g_wasm_vm->globals[i].value = NULL;
-      }
-    }
-    g_wasm_vm->global_count = 0;
+    vm_clear_globals(g_wasm_vm);
 
     // Clear user-defined functions
     for (size_t i = 0; i < g_wasm_vm->function_count; i++) {
@@ -314,6 +304,7 @@ void kronos_wasm_reset(void) {
     for (size_t i = 0; i < FUNCTIONS_MAX; i++) {
       g_wasm_vm->function_hash[i] = NULL;
     }
+    vm_invalidate_call_caches(g_wasm_vm);
 
     // Clear output buffer
     g_output_buffer[0] = '\0';